@@ -128,6 +128,21 @@ typedef struct EbSvtAv1DecConfiguration {
  *
  * Default is 0. */
     EbBool is_16bit_pipeline;
+
+    /* Return output pictures without copy: svt_av1_dec_get_picture() sets the
+     * planes and strides of the EbSvtIOFormat to the decoder's own buffers
+     * and stores a handle in wrapper_ptr. The picture stays valid until the
+     * handle is released with svt_av1_dec_release_picture(). At most 4
+     * pictures can be held at once.
+     *
+     * Default is 0. */
+    EbBool zero_copy_output;
+    /* Only parse the tile data: the blocks are neither reconstructed nor
+     * filtered and the output pictures are not valid. Measures the entropy
+     * decoding throughput. Ignored with more than one thread.
+     *
+     * Default is 0. */
+    EbBool parse_only;
 } EbSvtAv1DecConfiguration;
 
 /* STEP 1: Call the library to construct a Component Handle.
@@ -183,12 +198,24 @@ EB_API EbErrorType svt_av1_dec_frame(EbComponentType *svt_dec_component, const u
      *
      *  Returns EB_ErrorNone if the picture has been returned successfully.
      *  Returns EB_DecNoOutputPicture if the next output picture has not
-     *  been generated yet. Calling a decoding function is needed to generate more pictures. */
+     *  been generated yet. Calling a decoding function is needed to generate more pictures.
+     *  With zero_copy_output, returns EB_ErrorInsufficientResources when the
+     *  application holds the maximum number of pictures. */
 EB_API EbErrorType svt_av1_dec_get_picture(EbComponentType *   svt_dec_component,
                                            EbBufferHeaderType *p_buffer,
                                            EbAV1StreamInfo *   stream_info,
                                            EbAV1FrameInfo *    frame_info);
 
+/* Release a picture returned with zero_copy_output. The planes of the
+     * EbSvtIOFormat are reset to NULL. May be called from any thread, all
+     * pictures have to be released before svt_av1_dec_deinit().
+     *
+     * Parameter:
+     * @ *svt_dec_component     Decoder handle.
+     * @ *p_buffer              Header filled by svt_av1_dec_get_picture(). */
+EB_API EbErrorType svt_av1_dec_release_picture(EbComponentType *   svt_dec_component,
+                                               EbBufferHeaderType *p_buffer);
+
 /* STEP 6: Deinitialize decoder library.
      *
      * Parameter:
@@ -35,8 +35,10 @@ extern "C" {
     0x00000002 // signals that the packet contains a show existing frame at the end
 #define EB_BUFFERFLAG_HAS_TD 0x00000004 // signals that the packet contains a TD
 #define EB_BUFFERFLAG_IS_ALT_REF 0x00000008 // signals that the packet contains an ALT_REF frame
+#define EB_BUFFERFLAG_FRAGMENT \
+    0x00000010 // signals that more fragments of the temporal unit follow in the next packets
 #define EB_BUFFERFLAG_ERROR_MASK \
-    0xFFFFFFF0 // mask for signalling error assuming top flags fit in 4 bits. To be changed, if more flags are added.
+    0xFFFFFFE0 // mask for signalling error assuming top flags fit in 5 bits. To be changed, if more flags are added.
 
 /************************************************
  * Prediction Structure Config Entry
@@ -70,6 +72,29 @@ typedef enum {
     // 2. call this when you got EB_BUFFERFLAG_EOS
     SVT_AV1_STREAM_INFO_FIRST_PASS_STATS_OUT = SVT_AV1_STREAM_INFO_START,
 
+    // The output is SvtAv1InputLayout*
+    // The layout of the input planes sent in zero copy mode
+    // (EbSvtAv1EncConfiguration.zero_copy_input), available after svt_av1_enc_init
+    SVT_AV1_STREAM_INFO_INPUT_LAYOUT,
+
+    // The output is SvtAv1PipelineStats*
+    // The counters of every pipeline stage since svt_av1_enc_init, requires
+    // EbSvtAv1EncConfiguration.enable_pipeline_stats
+    SVT_AV1_STREAM_INFO_PIPELINE_STATS,
+
+    // The output is SvtAv1FixedBuf*
+    // The last objects of every pipeline stage as Chrome trace event JSON
+    // (chrome://tracing, Perfetto), requires enable_pipeline_stats. The
+    // slices of a picture carry its number and are linked by a flow. A trace
+    // thread is a consumer of the stage, a fiber or a pool context with a
+    // thread pool. The buffer is owned by the encoder and valid until the
+    // next call or svt_av1_enc_deinit
+    SVT_AV1_STREAM_INFO_PIPELINE_TRACE,
+
+    // The output is SvtAv1MemoryUsage*
+    // The footprint and peak use of the picture pools since svt_av1_enc_init
+    SVT_AV1_STREAM_INFO_MEMORY_USAGE,
+
     SVT_AV1_STREAM_INFO_END,
 } SVT_AV1_STREAM_INFO_ID;
 
@@ -82,6 +107,83 @@ typedef struct SvtAv1FixedBuf {
     uint64_t sz; /**< Length of the buffer, in chars */
 } SvtAv1FixedBuf; /**< alias for struct aom_fixed_buf */
 
+/*!\brief Layout of the input planes in zero copy mode
+ *
+ * The planes include the padding the encoder writes around the picture. The
+ * picture starts at (origin_x, origin_y) of the luma plane and at
+ * (origin_x, origin_y) scaled by the chroma subsampling of the chroma planes.
+ */
+typedef struct SvtAv1InputLayout {
+    uint32_t luma_stride; /**< y_stride of the luma plane, in bytes */
+    uint32_t chroma_stride; /**< cb_stride and cr_stride of the chroma planes, in bytes */
+    uint32_t luma_size; /**< Size of the luma plane, in bytes */
+    uint32_t chroma_size; /**< Size of each chroma plane, in bytes */
+    uint32_t origin_x; /**< Luma columns left of the picture */
+    uint32_t origin_y; /**< Luma rows above the picture */
+    uint32_t alignment; /**< Alignment of the plane addresses, in bytes */
+} SvtAv1InputLayout;
+
+#define SVT_AV1_MAX_PIPELINE_STAGES 32
+#define SVT_AV1_MAX_STAGE_THREADS 64
+
+/*!\brief Counters of one pipeline stage
+ *
+ * A stage consumes the objects posted to one queue of the encoder pipeline.
+ * The queue time of an object runs from its post to its dequeue by a stage
+ * thread, the busy time of a thread from a dequeue to the next request for
+ * an object, in microseconds.
+ */
+typedef struct SvtAv1StageStats {
+    const char *name; /**< Name of the stage, e.g. "enc_dec" */
+    uint64_t    object_count; /**< Objects dequeued */
+    uint64_t    queue_time_total; /**< Sum of the queue times */
+    uint64_t    queue_time_max; /**< Longest queue time */
+    uint32_t    queue_depth; /**< Objects waiting in the queue */
+    uint32_t    queue_depth_max; /**< Most objects waiting in the queue */
+    uint32_t    thread_count; /**< Threads of the stage, or pool workers */
+    uint64_t    busy_time[SVT_AV1_MAX_STAGE_THREADS]; /**< Busy time per thread */
+} SvtAv1StageStats;
+
+/*!\brief Counters of the encoder pipeline, stages in pipeline order */
+typedef struct SvtAv1PipelineStats {
+    uint64_t         elapsed_time; /**< Microseconds since svt_av1_enc_init */
+    uint32_t         stage_count;
+    SvtAv1StageStats stages[SVT_AV1_MAX_PIPELINE_STAGES];
+    uint64_t         tf_picture_count; /**< Temporally filtered pictures */
+    uint64_t         tf_latency_total; /**< Sum of the filtering times, post to last segment */
+    uint64_t         tf_latency_max; /**< Longest filtering time of a picture */
+    uint64_t         tf_wait_time; /**< Time picture decision waited for the filtering */
+} SvtAv1PipelineStats;
+
+#define SVT_AV1_MAX_MEMORY_POOLS 16
+
+/*!\brief Memory of one picture pool
+ *
+ * The footprint of an object is what its construction allocates. The planes
+ * of the pictures are only committed by the system when first written, so
+ * the objects the pipeline never takes out of a pool cost little resident
+ * memory; peak_in_use * object_bytes bounds the committed bytes of a pool.
+ * With enable_numa_alloc the planes are committed when allocated instead, to
+ * place them on their node, and every object counts as resident.
+ */
+typedef struct SvtAv1PoolMemory {
+    const char *name; /**< Name of the pool, e.g. "reference" */
+    uint32_t    object_count; /**< Objects of the pool */
+    uint32_t    peak_in_use; /**< Most objects taken from the pool at once */
+    uint64_t    object_bytes; /**< Bytes allocated for one object */
+} SvtAv1PoolMemory;
+
+/*!\brief Memory of the encoder, pools in creation order */
+typedef struct SvtAv1MemoryUsage {
+    uint64_t         init_bytes; /**< Bytes allocated by svt_av1_enc_init, pools included */
+    uint64_t         budget_bytes; /**< EbSvtAv1EncConfiguration.memory_budget in bytes, 0 if off */
+    uint32_t         pool_count;
+    SvtAv1PoolMemory pools[SVT_AV1_MAX_MEMORY_POOLS];
+} SvtAv1MemoryUsage;
+
+/*!\brief Worker pool shared by encoder instances, opaque to the application */
+typedef struct EbSvtAv1ThreadPool EbSvtAv1ThreadPool;
+
 // Will contain the EbEncApi which will live in the EncHandle class
 // Only modifiable during config-time.
 typedef struct EbSvtAv1EncConfiguration {
@@ -488,6 +590,31 @@ typedef struct EbSvtAv1EncConfiguration {
      *
      * Default depends on rate control mode.*/
     uint32_t look_ahead_distance;
+    /* Low-latency real-time mode for conferencing, bounds the number of
+     * pictures between svt_av1_enc_send_picture() and their packet, the send
+     * call blocking once the bound is reached. The pictures are coded in a flat
+     * low-delay P structure without look ahead, TPL, temporal filtering nor
+     * scene change detection, and every packet is output as soon as it is
+     * coded, the end of sequence coming with an empty packet after the last
+     * one. The latency of each packet in ms is reported in n_tick_count.
+     *
+     * Only single pass CQP is supported: VBR and CVBR rely on the look ahead
+     * and are rejected, as are recon output and a manual prediction structure.
+     *
+     * 0 = off, N = at most N pictures in flight
+     * Default is 0. */
+    uint32_t max_frames_in_flight;
+
+    /* Tile group output, only available when max_frames_in_flight is set.
+     * A picture with several tiles is sent as a frame header OBU followed by
+     * one tile group OBU per tile, and each tile group is output in its own
+     * packet as soon as its tile is entropy coded. All the packets of the
+     * temporal unit but the last one are flagged with EB_BUFFERFLAG_FRAGMENT,
+     * the first one holding the temporal delimiter and the headers; the last
+     * one carries the end of sequence and the latency of the picture.
+     *
+     * Default is 0. */
+    EbBool tile_group_output;
 
     /* Enable TPL in look ahead, only works when look_ahead_distance>0
      * 0 = disable TPL in look ahead
@@ -647,8 +774,98 @@ typedef struct EbSvtAv1EncConfiguration {
      * Default is -1. */
     int32_t target_socket;
 
+    /* Run the EncDec, deblocking, CDEF and restoration stages as tasks of a
+     * single work-stealing worker pool instead of dedicated per-stage threads,
+     * so idle workers pick up whichever of these stages is behind. The other
+     * stages run on the same workers, as fibers that give their worker back
+     * while they wait for input, so the encoder starts no thread besides the
+     * workers.
+     *
+     * Default is 0. */
+    EbBool enable_thread_pool;
+
+    /* Worker pool of svt_av1_enc_create_thread_pool to run the stages of
+     * enable_thread_pool on, shared with the other encoder instances attached
+     * to it, instead of a pool of the encoder. The encoder then starts no
+     * thread: the threads of the process stay the workers of the pool,
+     * whatever the number of encoders. The instances of the stages that are
+     * not pool tasks are sized for the pool workers divided by
+     * active_channel_count unless logical_processors is set.
+     *
+     * Default is NULL. */
+    EbSvtAv1ThreadPool *thread_pool;
+
+    /* Priority of the tasks of the encoder in its worker pool; the workers
+     * run the tasks of a lower priority only when no higher priority task
+     * is waiting.
+     *
+     * 0 = low, 1 = normal, 2 = high
+     * Default is 1. */
+    uint32_t thread_pool_priority;
+
+    /* Share of the workers of the pool the encoder gets while the encoders
+     * of its priority are all busy, relative to their weights: an encoder
+     * of weight 200 runs about twice as long as one of weight 100.
+     *
+     * Min value is 1.
+     * Max value is 10000.
+     * Default is 100. */
+    uint32_t thread_pool_weight;
+
+    /* Place memory on the NUMA nodes that use it. The threads of the parallel
+     * stages are spread over the nodes the encoder runs on and their contexts
+     * are allocated on the node of the owning thread; picture buffer pools are
+     * interleaved over these nodes, or kept on the node of TargetSocket when it
+     * is set. Has no effect on systems with a single node.
+     *
+     * Default is 0. */
+    EbBool enable_numa_alloc;
+
+    /* Memory budget of the encoder in MB. The pools of pictures kept in flight
+     * (input, parent and child picture control sets, motion estimation,
+     * references and PA references) are constructed at the minimum count that
+     * sustains the prediction structure, then grown towards the default count
+     * of the core count while the bytes allocated by svt_av1_enc_init stay
+     * within the budget. The budget is soft: the minimum counts are always
+     * constructed, and the thread contexts allocated after the pools are not
+     * budgeted.
+     *
+     * 0 = pools sized from the core count only
+     * Default is 0. */
+    uint32_t memory_budget;
+
+    /* Encode the input pictures in the buffers sent to svt_av1_enc_send_picture
+     * instead of copying them into buffers of the encoder. The luma, cb and cr
+     * pointers of the EbSvtIOFormat must point to planes laid out as reported
+     * for SVT_AV1_STREAM_INFO_INPUT_LAYOUT. The encoder writes the padding and
+     * may overwrite the picture, so the planes belong to the encoder until they
+     * are handed back through input_release_callback.
+     *
+     * Only 8-bit input is supported: svt_av1_enc_set_parameter returns
+     * EB_ErrorBadParameter when encoder_bit_depth is above 8, and
+     * svt_av1_enc_send_picture returns EB_ErrorBadParameter for a buffer with
+     * 2-bit planes (luma_ext, cb_ext or cr_ext) or with planes that do not
+     * follow the input layout. High bit depth input has to be copied.
+     *
+     * Default is 0. */
+    EbBool zero_copy_input;
+
+    /* Called with the p_app_private of a buffer sent in zero copy mode once the
+     * encoder no longer uses its planes. It runs on an encoder thread and must
+     * not call the encoder API. The buffers still held when the encoder stops
+     * are handed back by svt_av1_enc_deinit_handle, on the calling thread.
+     * Required when zero_copy_input is set. */
+    void (*input_release_callback)(void *p_app_private);
+
     // Debug tools
 
+    /* Record the queue time, queue depth and per thread busy time of every
+     * pipeline stage, read through SVT_AV1_STREAM_INFO_PIPELINE_STATS and
+     * SVT_AV1_STREAM_INFO_PIPELINE_TRACE.
+     *
+     * Default is 0. */
+    EbBool enable_pipeline_stats;
+
     /* Output reconstructed yuv used for debug purposes. The value is set through
      * ReconFile token (-o) and using the feature will affect the speed of encoder.
      *
@@ -722,6 +939,22 @@ typedef struct EbSvtAv1EncConfiguration {
     int32_t manual_pred_struct_entry_num;
 } EbSvtAv1EncConfiguration;
 
+/* OPTIONAL: Create a worker pool to share between encoder instances through
+     * EbSvtAv1EncConfiguration.thread_pool.
+     *
+     * Parameter:
+     * @ **p_pool       Created pool.
+     * @ worker_count   Number of worker threads, 0 for one per logical processor. */
+EB_API EbErrorType svt_av1_enc_create_thread_pool(EbSvtAv1ThreadPool **p_pool,
+                                                  uint32_t             worker_count);
+
+/* OPTIONAL: Destroy a worker pool once every encoder instance using it is
+     * deconstructed.
+     *
+     * Parameter:
+     * @ *pool          Pool of svt_av1_enc_create_thread_pool. */
+EB_API EbErrorType svt_av1_enc_destroy_thread_pool(EbSvtAv1ThreadPool *pool);
+
 /* STEP 1: Call the library to construct a Component Handle.
      *
      * Parameter:
@@ -781,6 +1014,21 @@ EB_API EbErrorType svt_av1_enc_eos_nal(EbComponentType *    svt_enc_component,
 EB_API EbErrorType svt_av1_enc_send_picture(EbComponentType *   svt_enc_component,
                                             EbBufferHeaderType *p_buffer);
 
+/* OPTIONAL: Change the rate of a running encoder.
+     * The target_bit_rate, vbv_bufsize, qp, max_qp_allowed and min_qp_allowed
+     * of config_ptr apply from the next picture sent, which is coded as a key
+     * frame, and rate control restarts there with the new rate; the threads
+     * and buffers of the encoder are kept. The source_width, source_height
+     * and rate_control_mode must be the running ones, or EB_ErrorBadParameter
+     * is returned. Not available in the two pass modes. Call it from the
+     * thread sending the pictures.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *config_ptr         Configuration holding the new rate. */
+EB_API EbErrorType svt_av1_enc_reconfigure(EbComponentType *         svt_enc_component,
+                                           EbSvtAv1EncConfiguration *config_ptr);
+
 /* STEP 5: Receive packet.
      * Parameter:
     * @ *svt_enc_component  Encoder handler.
@@ -796,6 +1044,23 @@ EB_API EbErrorType svt_av1_enc_get_packet(EbComponentType *    svt_enc_component
      * @ **p_buffer          Header pointer that contains the output packet to be released. */
 EB_API void svt_av1_enc_release_out_buffer(EbBufferHeaderType **p_buffer);
 
+/* OPTIONAL: Add an application buffer to the output buffer pool.
+     * A packet goes to the smallest free pool buffer that holds it, and
+     * svt_av1_enc_release_out_buffer returns that buffer to the pool. A frame
+     * that is a temporal unit on its own is written straight into the pool
+     * buffer; the frames of a temporal unit with hidden frames are written
+     * to encoder memory first and copied into it. Packets that fit in no
+     * free buffer use encoder memory as before.
+     * The encoder never frees pool buffers, they can be freed after
+     * svt_av1_enc_deinit.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *buffer             Application buffer.
+     * @ size                Size of the buffer in bytes. */
+EB_API EbErrorType svt_av1_enc_add_output_buffer(EbComponentType *svt_enc_component,
+                                                 uint8_t *buffer, uint32_t size);
+
 /* OPTIONAL: Fill buffer with reconstructed picture.
      *
      * Parameter:
@@ -126,6 +126,14 @@ static void show_progress(int in_frame, uint64_t dx_time) {
             (double)in_frame * 1000000.0 / (double)dx_time);
 }
 
+static void show_parse_throughput(uint64_t dx_bytes, uint64_t dx_time) {
+    fprintf(stderr,
+            "%" PRIu64 " bytes parsed in %" PRIu64 " us (%.2f Mbit/s)\n",
+            dx_bytes,
+            dx_time,
+            (double)dx_bytes * 8.0 / (double)dx_time);
+}
+
 /***************************************
  * Decoder App Main
  ***************************************/
@@ -160,6 +168,7 @@ int32_t main(int32_t argc, char *argv[]) {
 
     struct EbDecTimer timer;
     uint64_t          dx_time     = 0;
+    uint64_t          dx_bytes    = 0;
     int               fps_frm     = 0;
     int               fps_summary = 0;
 
@@ -204,9 +213,12 @@ int32_t main(int32_t argc, char *argv[]) {
         int size = (config_ptr->max_bit_depth == EB_EIGHT_BIT) ? sizeof(uint8_t) : sizeof(uint16_t);
         size     = size * w * h;
         assert(recon_buffer->p_buffer != NULL);
-        ((EbSvtIOFormat *)recon_buffer->p_buffer)->luma = (uint8_t *)malloc(size);
-        ((EbSvtIOFormat *)recon_buffer->p_buffer)->cb   = (uint8_t *)malloc(size >> 2);
-        ((EbSvtIOFormat *)recon_buffer->p_buffer)->cr   = (uint8_t *)malloc(size >> 2);
+        /* The decoder returns its own planes with zero copy output */
+        if (config_ptr->zero_copy_output)
+            size = 0;
+        ((EbSvtIOFormat *)recon_buffer->p_buffer)->luma = size ? (uint8_t *)malloc(size) : NULL;
+        ((EbSvtIOFormat *)recon_buffer->p_buffer)->cb   = size ? (uint8_t *)malloc(size >> 2) : NULL;
+        ((EbSvtIOFormat *)recon_buffer->p_buffer)->cr   = size ? (uint8_t *)malloc(size >> 2) : NULL;
 
         if (!init_pic_buffer((EbSvtIOFormat *)recon_buffer->p_buffer, &cli, config_ptr)) {
             fprintf(stderr, "Decoding \n");
@@ -234,6 +246,7 @@ int32_t main(int32_t argc, char *argv[]) {
 
                     dec_timer_mark(&timer);
                     dx_time += dec_timer_elapsed(&timer);
+                    dx_bytes += bytes_in_buffer;
 
                     in_frame++;
 
@@ -242,10 +255,13 @@ int32_t main(int32_t argc, char *argv[]) {
                         if (fps_frm)
                             show_progress(in_frame, dx_time);
 
-                        if (enable_md5)
+                        /* The pictures are not reconstructed when only parsing */
+                        if (enable_md5 && !config_ptr->parse_only)
                             write_md5(recon_buffer, &md5_ctx);
-                        if (cli.out_file != NULL)
+                        if (cli.out_file != NULL && !config_ptr->parse_only)
                             write_frame(recon_buffer, &cli);
+                        if (config_ptr->zero_copy_output)
+                            svt_av1_dec_release_picture(p_handle, recon_buffer);
                     }
                 } else
                     break;
@@ -255,6 +271,8 @@ int32_t main(int32_t argc, char *argv[]) {
                 show_progress(in_frame, dx_time);
                 fprintf(stderr, "\n");
             }
+            if (config_ptr->parse_only && dx_time > 0)
+                show_parse_throughput(dx_bytes, dx_time);
 
             if (enable_md5) {
                 md5_final(md5_digest, &md5_ctx);
@@ -65,6 +65,12 @@ static void set_num_pframes(const char *value, EbSvtAv1DecConfiguration *cfg) {
         cfg->num_p_frames = 1;
     }
 };
+static void set_zero_copy_output(const char *value, EbSvtAv1DecConfiguration *cfg) {
+    cfg->zero_copy_output = (EbBool)!!strtoul(value, NULL, 0);
+};
+static void set_parse_only(const char *value, EbSvtAv1DecConfiguration *cfg) {
+    cfg->parse_only = (EbBool)!!strtoul(value, NULL, 0);
+};
 
 /**********************************
   * Config Entry Array
@@ -81,6 +87,8 @@ ConfigEntry config_entry[] = {
     {COLOUR_SPACE_TOKEN, "InputColourSpace", 1, set_colour_space},
     {THREADS_TOKEN, "ThreadCount", 1, set_num_thread},
     {FRAME_PLL_TOKEN, "PllFrameCount", 1, set_num_pframes},
+    {ZERO_COPY_TOKEN, "ZeroCopyOutput", 0, set_zero_copy_output},
+    {PARSE_ONLY_TOKEN, "ParseOnly", 0, set_parse_only},
     // Termination
     {NULL, NULL, 0, NULL}};
 
@@ -103,6 +111,8 @@ static void show_help() {
     H0(" -fps-summary              Show fps summary");
     H0(" -skip-film-grain          Disable Film Grain");
     H0(" -16bit-pipeline           Enable 16b pipeline. [1 - enable, 0 - disable]");
+    H0(" -zero-copy                Write the decoder's output pictures without copy");
+    H0(" -parse-only               Only parse the stream and show its Mbit/s, with 1 thread");
 
     exit(1);
 }
@@ -51,6 +51,8 @@
 #define FPS_SUMMARY_TOKEN "-fps-summary"
 #define FILM_GRAIN_TOKEN "-skip-film-grain"
 #define ANNEX_B_TOKEN "-annex-b"
+#define ZERO_COPY_TOKEN "-zero-copy"
+#define PARSE_ONLY_TOKEN "-parse-only"
 #define MAX_NUM_TOKENS 200
 
 /**********************************
@@ -17,6 +17,7 @@
 #include "EbAppConfig.h"
 #include "EbAppContext.h"
 #include "EbAppInputy4m.h"
+#include "EbAppInputReader.h"
 #ifdef _WIN32
 #include <windows.h>
 #include <io.h>
@@ -51,11 +52,14 @@
 #define INPUT_STAT_FILE_TOKEN "-input-stat-file"
 #define OUTPUT_STAT_FILE_TOKEN "-output-stat-file"
 #define STAT_FILE_TOKEN "-stat-file"
+#define PIPELINE_TRACE_TOKEN "--pipeline-trace"
 #define INPUT_PREDSTRUCT_FILE_TOKEN "-pred-struct-file"
 #define WIDTH_TOKEN "-w"
 #define HEIGHT_TOKEN "-h"
 #define NUMBER_OF_PICTURES_TOKEN "-n"
 #define BUFFERED_INPUT_TOKEN "-nb"
+#define MMAP_INPUT_TOKEN "--mmap-input"
+#define INPUT_PREFETCH_TOKEN "--input-prefetch"
 #define NO_PROGRESS_TOKEN "--no-progress" // tbd if it should be removed
 #define PROGRESS_TOKEN "--progress"
 #define BASE_LAYER_SWITCH_MODE_TOKEN "-base-layer-switch-mode" // no Eval
@@ -150,6 +154,8 @@
 #define RECODE_LOOP_TOKEN "-recode-loop"
 #define ADAPTIVE_QP_ENABLE_TOKEN "-adaptive-quantization"
 #define LOOK_AHEAD_DIST_TOKEN "-lad"
+#define MAX_FRAMES_IN_FLIGHT_TOKEN "-max-frames-in-flight"
+#define TILE_GROUP_OUTPUT_TOKEN "-tile-group-output"
 #define ENABLE_TPL_LA_TOKEN "-enable-tpl-la"
 #define SUPER_BLOCK_SIZE_TOKEN "-sb-size"
 #define TILE_ROW_TOKEN "-tile-rows"
@@ -167,6 +173,12 @@
 #define THREAD_MGMNT "-lp"
 #define UNPIN_TOKEN "-unpin"
 #define TARGET_SOCKET "-ss"
+#define THREAD_POOL_TOKEN "-thread-pool"
+#define SHARED_THREAD_POOL_TOKEN "-shared-thread-pool"
+#define THREAD_POOL_PRIORITY_TOKEN "-thread-pool-priority"
+#define THREAD_POOL_WEIGHT_TOKEN "-thread-pool-weight"
+#define NUMA_ALLOC_TOKEN "-numa-alloc"
+#define MEMORY_BUDGET_TOKEN "-mem-budget"
 #define UNRESTRICTED_MOTION_VECTOR "-umv"
 #define CONFIG_FILE_COMMENT_CHAR '#'
 #define CONFIG_FILE_NEWLINE_CHAR '\n'
@@ -355,6 +367,13 @@ static void set_cfg_stat_file(const char *value, EbConfig *cfg) {
     }
     FOPEN(cfg->stat_file, value, "wb");
 };
+static void set_cfg_pipeline_trace(const char *value, EbConfig *cfg) {
+    if (cfg->pipeline_trace_file) {
+        fclose(cfg->pipeline_trace_file);
+    }
+    FOPEN(cfg->pipeline_trace_file, value, "wb");
+    cfg->config.enable_pipeline_stats = EB_TRUE;
+};
 static void set_stat_report(const char *value, EbConfig *cfg) {
     cfg->config.stat_report = (uint8_t)strtoul(value, NULL, 0);
 };
@@ -370,6 +389,12 @@ static void set_cfg_frames_to_be_encoded(const char *value, EbConfig *cfg) {
 static void set_buffered_input(const char *value, EbConfig *cfg) {
     cfg->buffered_input = strtol(value, NULL, 0);
 };
+static void set_mmap_input(const char *value, EbConfig *cfg) {
+    cfg->mmap_input = (EbBool)strtol(value, NULL, 0);
+};
+static void set_input_prefetch(const char *value, EbConfig *cfg) {
+    cfg->input_prefetch = strtoul(value, NULL, 0);
+};
 static void set_no_progress(const char *value, EbConfig *cfg) {
     switch (value ? *value : '1') {
     case '0': cfg->progress = 1; break; // equal to --progress 1
@@ -594,6 +619,12 @@ static void set_scene_change_detection(const char *value, EbConfig *cfg) {
 static void set_look_ahead_distance(const char *value, EbConfig *cfg) {
     cfg->config.look_ahead_distance = strtoul(value, NULL, 0);
 };
+static void set_max_frames_in_flight(const char *value, EbConfig *cfg) {
+    cfg->config.max_frames_in_flight = strtoul(value, NULL, 0);
+};
+static void set_tile_group_output(const char *value, EbConfig *cfg) {
+    cfg->config.tile_group_output = (EbBool)strtoul(value, NULL, 0);
+};
 static void set_enable_tpl_la(const char *value, EbConfig *cfg) {
     cfg->config.enable_tpl_la = (uint8_t)strtoul(value, NULL, 0);
 };
@@ -767,6 +798,24 @@ static void set_unpin_execution(const char *value, EbConfig *cfg) {
 };
 static void set_target_socket(const char *value, EbConfig *cfg) {
     cfg->config.target_socket = (int32_t)strtol(value, NULL, 0);
+}
+static void set_thread_pool(const char *value, EbConfig *cfg) {
+    cfg->config.enable_thread_pool = (EbBool)strtoul(value, NULL, 0);
+};
+static void set_shared_thread_pool(const char *value, EbConfig *cfg) {
+    cfg->shared_thread_pool = (EbBool)strtoul(value, NULL, 0);
+};
+static void set_thread_pool_priority(const char *value, EbConfig *cfg) {
+    cfg->config.thread_pool_priority = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_thread_pool_weight(const char *value, EbConfig *cfg) {
+    cfg->config.thread_pool_weight = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_numa_alloc(const char *value, EbConfig *cfg) {
+    cfg->config.enable_numa_alloc = (EbBool)strtoul(value, NULL, 0);
+};
+static void set_memory_budget(const char *value, EbConfig *cfg) {
+    cfg->config.memory_budget = (uint32_t)strtoul(value, NULL, 0);
 };
 static void set_unrestricted_motion_vector(const char *value, EbConfig *cfg) {
     cfg->config.unrestricted_motion_vector = (EbBool)strtol(value, NULL, 0);
@@ -804,6 +853,10 @@ ConfigEntry config_entry_options[] = {
     {SINGLE_INPUT, OUTPUT_RECON_LONG_TOKEN, "Recon filename", set_cfg_recon_file},
 
     {SINGLE_INPUT, STAT_FILE_TOKEN, "Stat filename", set_cfg_stat_file},
+    {SINGLE_INPUT,
+     PIPELINE_TRACE_TOKEN,
+     "Write the timing of the pipeline stages to a Chrome trace file and print a summary",
+     set_cfg_pipeline_trace},
     {SINGLE_INPUT, NULL, NULL, NULL}};
 
 ConfigEntry config_entry_global_options[] = {
@@ -824,6 +877,14 @@ ConfigEntry config_entry_global_options[] = {
      set_cfg_frames_to_be_encoded},
 
     {SINGLE_INPUT, BUFFERED_INPUT_TOKEN, "Buffer n input frames", set_buffered_input},
+    {SINGLE_INPUT,
+     MMAP_INPUT_TOKEN,
+     "Map the input file in memory instead of reading it, [0-1]",
+     set_mmap_input},
+    {SINGLE_INPUT,
+     INPUT_PREFETCH_TOKEN,
+     "Read up to n input frames ahead in a separate thread, [0-64]",
+     set_input_prefetch},
     {SINGLE_INPUT,
      PROGRESS_TOKEN,
      "Change verbosity of the output (0: no progress is printed, 1: default, 2: aomenc style "
@@ -898,6 +959,37 @@ ConfigEntry config_entry_global_options[] = {
      "Specify  which socket the encoder runs on"
      "--unpin is overwritten to 0 when --ss is set to 0 or 1",
      set_target_socket},
+    {SINGLE_INPUT,
+     THREAD_POOL_TOKEN,
+     "Run the encoder stages on one work-stealing worker pool instead of dedicated per-stage "
+     "threads (0: OFF[default], 1: ON)",
+     set_thread_pool},
+    {SINGLE_INPUT,
+     SHARED_THREAD_POOL_TOKEN,
+     "Run the stages of every channel on one worker pool, with one worker per logical "
+     "processor or -lp of the first channel, the only threads of the encoders (0: OFF[default], "
+     "1: ON)",
+     set_shared_thread_pool},
+    {SINGLE_INPUT,
+     THREAD_POOL_PRIORITY_TOKEN,
+     "Priority of the tasks of the channel in its worker pool (0: low, 1: normal[default], "
+     "2: high)",
+     set_thread_pool_priority},
+    {SINGLE_INPUT,
+     THREAD_POOL_WEIGHT_TOKEN,
+     "Share of the pool workers of the channel relative to the busy channels of its priority, "
+     "[1-10000], default is 100",
+     set_thread_pool_weight},
+    {SINGLE_INPUT,
+     NUMA_ALLOC_TOKEN,
+     "Allocate thread contexts on the NUMA node of their thread and spread picture buffers "
+     "over the nodes in use (0: OFF[default], 1: ON)",
+     set_numa_alloc},
+    {SINGLE_INPUT,
+     MEMORY_BUDGET_TOKEN,
+     "Memory budget in MB the picture pools are grown within, prints the memory of the pools "
+     "at the end (0: OFF[default])",
+     set_memory_budget},
     // Termination
     {SINGLE_INPUT, NULL, NULL, NULL}};
 
@@ -1034,6 +1126,16 @@ ConfigEntry config_entry_specific[] = {
      "Multi reference frame levels( 0: OFF, 1: FULL, 2: Level1 .. 9: Level8,  -1: DEFAULT)",
      set_mrp_level},
     {SINGLE_INPUT, LOOK_AHEAD_DIST_TOKEN, "Set look ahead distance", set_look_ahead_distance},
+    {SINGLE_INPUT,
+     MAX_FRAMES_IN_FLIGHT_TOKEN,
+     "Low-latency real-time mode, at most N pictures between input and packet, flat low-delay "
+     "structure without look ahead (0: OFF[default], N: ON)",
+     set_max_frames_in_flight},
+    {SINGLE_INPUT,
+     TILE_GROUP_OUTPUT_TOKEN,
+     "Output each tile group of a picture in its own packet as soon as it is coded, needs "
+     "--max-frames-in-flight (0: OFF[default], 1: ON)",
+     set_tile_group_output},
     {SINGLE_INPUT,
      ENABLE_TPL_LA_TOKEN,
      "RDO based on frame temporal dependency (0: off, 1: backward source based)",
@@ -1258,6 +1360,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, OUTPUT_RECON_TOKEN, "ReconFile", set_cfg_recon_file},
     {SINGLE_INPUT, QP_FILE_TOKEN, "QpFile", set_cfg_qp_file},
     {SINGLE_INPUT, STAT_FILE_TOKEN, "StatFile", set_cfg_stat_file},
+    {SINGLE_INPUT, PIPELINE_TRACE_TOKEN, "PipelineTraceFile", set_cfg_pipeline_trace},
 
     // two pass
     {SINGLE_INPUT, PASS_TOKEN, "Pass", set_pass},
@@ -1270,6 +1373,8 @@ ConfigEntry config_entry[] = {
     // Prediction Structure
     {SINGLE_INPUT, NUMBER_OF_PICTURES_TOKEN, "FrameToBeEncoded", set_cfg_frames_to_be_encoded},
     {SINGLE_INPUT, BUFFERED_INPUT_TOKEN, "BufferedInput", set_buffered_input},
+    {SINGLE_INPUT, MMAP_INPUT_TOKEN, "MmapInput", set_mmap_input},
+    {SINGLE_INPUT, INPUT_PREFETCH_TOKEN, "InputPrefetch", set_input_prefetch},
     {SINGLE_INPUT, PROGRESS_TOKEN, "Progress", set_progress},
     {SINGLE_INPUT, NO_PROGRESS_TOKEN, "NoProgress", set_no_progress},
     {SINGLE_INPUT, ENCMODE_TOKEN, "EncoderMode", set_enc_mode},
@@ -1309,6 +1414,8 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, STAT_REPORT_TOKEN, "StatReport", set_stat_report},
     {SINGLE_INPUT, RATE_CONTROL_ENABLE_TOKEN, "RateControlMode", set_rate_control_mode},
     {SINGLE_INPUT, LOOK_AHEAD_DIST_TOKEN, "LookAheadDistance", set_look_ahead_distance},
+    {SINGLE_INPUT, MAX_FRAMES_IN_FLIGHT_TOKEN, "MaxFramesInFlight", set_max_frames_in_flight},
+    {SINGLE_INPUT, TILE_GROUP_OUTPUT_TOKEN, "TileGroupOutput", set_tile_group_output},
     {SINGLE_INPUT, ENABLE_TPL_LA_TOKEN, "EnableTplLA", set_enable_tpl_la},
     {SINGLE_INPUT, TARGET_BIT_RATE_TOKEN, "TargetBitRate", set_target_bit_rate},
     {SINGLE_INPUT, MAX_QP_TOKEN, "MaxQpAllowed", set_max_qp_allowed},
@@ -1416,6 +1523,12 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, THREAD_MGMNT, "LogicalProcessors", set_logical_processors},
     {SINGLE_INPUT, UNPIN_TOKEN, "UnpinExecution", set_unpin_execution},
     {SINGLE_INPUT, TARGET_SOCKET, "TargetSocket", set_target_socket},
+    {SINGLE_INPUT, THREAD_POOL_TOKEN, "ThreadPool", set_thread_pool},
+    {SINGLE_INPUT, SHARED_THREAD_POOL_TOKEN, "SharedThreadPool", set_shared_thread_pool},
+    {SINGLE_INPUT, THREAD_POOL_PRIORITY_TOKEN, "ThreadPoolPriority", set_thread_pool_priority},
+    {SINGLE_INPUT, THREAD_POOL_WEIGHT_TOKEN, "ThreadPoolWeight", set_thread_pool_weight},
+    {SINGLE_INPUT, NUMA_ALLOC_TOKEN, "NumaAlloc", set_numa_alloc},
+    {SINGLE_INPUT, MEMORY_BUDGET_TOKEN, "MemoryBudget", set_memory_budget},
     // Optional Features
     {SINGLE_INPUT,
      UNRESTRICTED_MOTION_VECTOR,
@@ -1558,6 +1671,7 @@ void svt_config_dtor(EbConfig *config_ptr) {
         config_ptr->config_file = (FILE *)NULL;
     }
 
+    app_input_reader_close(config_ptr);
     if (config_ptr->input_file) {
         if (!config_ptr->input_file_is_fifo)
             fclose(config_ptr->input_file);
@@ -1598,7 +1712,13 @@ void svt_config_dtor(EbConfig *config_ptr) {
         fclose(config_ptr->stat_file);
         config_ptr->stat_file = (FILE *)NULL;
     }
+
+    if (config_ptr->pipeline_trace_file) {
+        fclose(config_ptr->pipeline_trace_file);
+        config_ptr->pipeline_trace_file = (FILE *)NULL;
+    }
     free((void *)config_ptr->stats);
+    free(config_ptr->fragment_buffer);
     free(config_ptr);
     return;
 }
@@ -1973,6 +2093,22 @@ static EbErrorType verify_settings(EbConfig *config, uint32_t channel_number) {
         return_error = EB_ErrorBadParameter;
     }
 
+    if ((config->mmap_input || config->input_prefetch) && config->buffered_input != -1) {
+        fprintf(config->error_log_file,
+                "Error instance %u: MmapInput and InputPrefetch cannot be used with "
+                "BufferedInput\n",
+                channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->input_prefetch > MAX_INPUT_PREFETCH) {
+        fprintf(config->error_log_file,
+                "Error instance %u: Invalid InputPrefetch. InputPrefetch must be [0 - %d]\n",
+                channel_number + 1,
+                MAX_INPUT_PREFETCH);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->config.use_qp_file == EB_TRUE && config->qp_file == NULL) {
         fprintf(config->error_log_file,
                 "Error instance %u: Could not find QP file, UseQpFile is set to 1\n",
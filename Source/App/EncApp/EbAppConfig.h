@@ -173,6 +173,7 @@ typedef struct EbConfig {
     FILE * recon_file;
     FILE * error_log_file;
     FILE * stat_file;
+    FILE * pipeline_trace_file;
     FILE * buffer_file;
     FILE * qp_file;
     /* two pass */
@@ -201,6 +202,11 @@ typedef struct EbConfig {
     int32_t   frames_encoded;
     int32_t   buffered_input;
     uint8_t **sequence_buffer;
+    EbBool    mmap_input;
+    uint32_t  input_prefetch;
+    // run the channels on one worker pool, read from the first channel
+    EbBool    shared_thread_pool;
+    struct EbAppInputReader *input_reader;
 
     uint32_t injector_frame_rate;
     uint32_t injector;
@@ -219,6 +225,10 @@ typedef struct EbConfig {
 
     uint64_t byte_count_since_ivf;
     uint64_t ivf_count;
+    // fragments of the temporal unit being received, written in one ivf frame
+    uint8_t *fragment_buffer;
+    uint32_t fragment_size;
+    uint32_t fragment_alloc;
     /****************************************
      * On-the-fly Testing
      ****************************************/
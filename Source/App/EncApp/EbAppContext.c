@@ -18,6 +18,7 @@
 
 #include "EbAppContext.h"
 #include "EbAppConfig.h"
+#include "EbAppInputReader.h"
 
 #define IS_16_BIT(bit_depth) (bit_depth == 10 ? 1 : 0)
 
@@ -168,8 +169,8 @@ EbErrorType allocate_input_buffers(EbConfig *config, EbAppContext *callback_data
                   EB_N_PTR,
                   EB_ErrorInsufficientResources);
 
-    // Allocate frame buffer for the p_buffer
-    if (config->buffered_input == -1)
+    // Allocate frame buffer for the p_buffer, the input reader supplies its own frames
+    if (config->buffered_input == -1 && !config->input_reader)
         allocate_frame_buffer(config, callback_data->input_buffer_pool->p_buffer);
 
     // Assign the variables
@@ -288,7 +289,10 @@ EbErrorType init_encoder(EbConfig *config, EbAppContext *callback_data, uint32_t
 
     ///********************** APPLICATION INIT [START] ******************///
 
-    // STEP 6: Allocate input buffers carrying the yuv frames in
+    // STEP 6: Open the input reader and allocate input buffers carrying the yuv frames in
+    return_error = app_input_reader_open(config);
+    if (return_error != EB_ErrorNone)
+        return return_error;
     return_error = allocate_input_buffers(config, callback_data);
 
     if (return_error != EB_ErrorNone)
@@ -0,0 +1,428 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/***************************************
+ * Includes
+ ***************************************/
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "EbAppInputReader.h"
+#include "EbAppInputy4m.h"
+
+#define YUV4MPEG2_IND_SIZE 9
+#define Y4M_FRAME_HEADER_MAX 4096
+#define PREFETCH_PAGE_SIZE 4096
+
+typedef struct InputFrame {
+    uint8_t *      buffer; // storage of the frames read with fread
+    const uint8_t *data;
+    uint64_t       size; // bytes available, less than a frame at the end of a pipe
+} InputFrame;
+
+struct EbAppInputReader {
+    FILE *   input_file;
+    FILE *   error_log_file;
+    EbBool   y4m_input;
+    EbBool   is_pipe;
+    uint64_t frame_size;
+    // Bytes of the first frame consumed by the YUV4MPEG2 probe of a pipe
+    uint8_t  prefix[YUV4MPEG2_IND_SIZE];
+    uint32_t prefix_size;
+
+    // Mapping of a regular file, NULL when the frames are read
+    const uint8_t *map;
+    uint64_t       map_size;
+    uint64_t       data_start; // first byte after the y4m stream header
+    uint64_t       map_offset;
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+
+    // Ring of frames ready for the encoder, one slot without prefetch
+    InputFrame ring[MAX_INPUT_PREFETCH + 1];
+    uint32_t   ring_size;
+    uint32_t   read_index;
+    uint32_t   write_index;
+    uint32_t   ready_count; // includes the frame held by the encoder
+    EbBool     frame_held;
+    EbBool     end_of_input;
+    EbBool     stop;
+    // Page touches of the prefetch thread, kept so they are not optimized out
+    volatile uint32_t touch_sum;
+
+    EbBool prefetch_thread_active;
+#ifdef _WIN32
+    HANDLE             prefetch_thread;
+    CRITICAL_SECTION   lock;
+    CONDITION_VARIABLE cond;
+#else
+    pthread_t       prefetch_thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+#endif
+};
+
+#ifdef _WIN32
+#define READER_LOCK(r) EnterCriticalSection(&(r)->lock)
+#define READER_UNLOCK(r) LeaveCriticalSection(&(r)->lock)
+#define READER_WAIT(r) SleepConditionVariableCS(&(r)->cond, &(r)->lock, INFINITE)
+#define READER_SIGNAL(r) WakeAllConditionVariable(&(r)->cond)
+#else
+#define READER_LOCK(r) pthread_mutex_lock(&(r)->lock)
+#define READER_UNLOCK(r) pthread_mutex_unlock(&(r)->lock)
+#define READER_WAIT(r) pthread_cond_wait(&(r)->cond, &(r)->lock)
+#define READER_SIGNAL(r) pthread_cond_broadcast(&(r)->cond)
+#endif
+
+/* Size of a frame in the input file, planes are stored back to back */
+static uint64_t get_input_frame_size(EbConfig *config) {
+    const EbColorFormat color_format = (EbColorFormat)config->config.encoder_color_format;
+    uint64_t            read_size = (uint64_t)config->input_padded_width * config->input_padded_height;
+
+    read_size += 2 * (read_size >> (3 - color_format));
+    if (config->config.encoder_bit_depth == 10 && config->config.compressed_ten_bit_format == 1)
+        read_size += read_size / 4;
+    else if (config->config.encoder_bit_depth > 8)
+        read_size *= 2;
+    return read_size;
+}
+
+/* Maps the whole input file, returns EB_FALSE when it is not possible */
+static EbBool map_input_file(EbAppInputReader *reader) {
+#ifdef _WIN32
+    HANDLE        file_handle = (HANDLE)_get_osfhandle(_fileno(reader->input_file));
+    LARGE_INTEGER file_size;
+    if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &file_size) ||
+        file_size.QuadPart == 0)
+        return EB_FALSE;
+    reader->mapping = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!reader->mapping)
+        return EB_FALSE;
+    reader->map = (const uint8_t *)MapViewOfFile(reader->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!reader->map) {
+        CloseHandle(reader->mapping);
+        reader->mapping = NULL;
+        return EB_FALSE;
+    }
+    reader->map_size   = (uint64_t)file_size.QuadPart;
+    reader->data_start = (uint64_t)_ftelli64(reader->input_file);
+#else
+    struct stat statbuf;
+    const int   fd = fileno(reader->input_file);
+    if (fstat(fd, &statbuf) || !S_ISREG(statbuf.st_mode) || statbuf.st_size == 0)
+        return EB_FALSE;
+    void *map = mmap(NULL, (size_t)statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+        return EB_FALSE;
+    madvise(map, (size_t)statbuf.st_size, MADV_SEQUENTIAL);
+    reader->map        = (const uint8_t *)map;
+    reader->map_size   = (uint64_t)statbuf.st_size;
+    reader->data_start = (uint64_t)ftello(reader->input_file);
+#endif
+    reader->map_offset = reader->data_start;
+    return EB_TRUE;
+}
+
+static void unmap_input_file(EbAppInputReader *reader) {
+    if (!reader->map)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(reader->map);
+    CloseHandle(reader->mapping);
+#else
+    munmap((void *)reader->map, (size_t)reader->map_size);
+#endif
+    reader->map = NULL;
+}
+
+/* Returns the offset past the "FRAME" line starting at offset */
+static uint64_t skip_mapped_y4m_delimiter(EbAppInputReader *reader, uint64_t offset) {
+    const uint64_t end = offset + Y4M_FRAME_HEADER_MAX < reader->map_size
+        ? offset + Y4M_FRAME_HEADER_MAX
+        : reader->map_size;
+    if (end - offset < sizeof("FRAME") - 1 ||
+        memcmp(reader->map + offset, "FRAME", sizeof("FRAME") - 1)) {
+        if (offset < reader->map_size)
+            fprintf(reader->error_log_file,
+                    "Failed to read proper y4m frame delimeter. Read broken.\n");
+        return offset;
+    }
+    for (uint64_t i = offset; i < end; i++)
+        if (reader->map[i] == '\n')
+            return i + 1;
+    return end;
+}
+
+/* Next frame of the mapping, looping over the file as the fread path does */
+static void map_next_frame(EbAppInputReader *reader, InputFrame *frame) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        uint64_t offset = reader->map_offset;
+        if (reader->y4m_input)
+            offset = skip_mapped_y4m_delimiter(reader, offset);
+        if (offset + reader->frame_size <= reader->map_size) {
+            reader->map_offset = offset + reader->frame_size;
+            frame->data        = reader->map + offset;
+            frame->size        = reader->frame_size;
+            return;
+        }
+        reader->map_offset = reader->data_start;
+    }
+    // The file is shorter than one frame
+    frame->data = NULL;
+    frame->size = 0;
+}
+
+static void read_next_frame(EbAppInputReader *reader, InputFrame *frame) {
+    uint64_t filled = 0;
+
+    if (reader->y4m_input)
+        read_y4m_frame_delimiter(reader->input_file, reader->error_log_file);
+    if (reader->prefix_size) {
+        memcpy(frame->buffer, reader->prefix, reader->prefix_size);
+        filled              = reader->prefix_size;
+        reader->prefix_size = 0;
+    }
+    filled += fread(frame->buffer + filled, 1, (size_t)(reader->frame_size - filled),
+                    reader->input_file);
+    if (filled != reader->frame_size && !reader->is_pipe) {
+        // If we reached the end of file, loop over again
+        fseek(reader->input_file, 0, SEEK_SET);
+        if (reader->y4m_input) {
+            read_and_skip_y4m_header(reader->input_file);
+            read_y4m_frame_delimiter(reader->input_file, reader->error_log_file);
+        }
+        filled = fread(frame->buffer, 1, (size_t)reader->frame_size, reader->input_file);
+    }
+    frame->data = frame->buffer;
+    frame->size = filled;
+}
+
+static void produce_frame(EbAppInputReader *reader, InputFrame *frame) {
+    if (reader->map) {
+        map_next_frame(reader, frame);
+        if (reader->prefetch_thread_active && frame->data) {
+            // Fault the pages in here rather than in the encoding loop
+            uint32_t sum = 0;
+            for (uint64_t i = 0; i < frame->size; i += PREFETCH_PAGE_SIZE) sum += frame->data[i];
+            reader->touch_sum += sum;
+        }
+    } else
+        read_next_frame(reader, frame);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI prefetch_kernel(LPVOID input_ptr) {
+#else
+static void *prefetch_kernel(void *input_ptr) {
+#endif
+    EbAppInputReader *reader = (EbAppInputReader *)input_ptr;
+
+    for (;;) {
+        InputFrame *frame;
+        READER_LOCK(reader);
+        while (!reader->stop && reader->ready_count == reader->ring_size) READER_WAIT(reader);
+        if (reader->stop) {
+            READER_UNLOCK(reader);
+            break;
+        }
+        frame = &reader->ring[reader->write_index];
+        READER_UNLOCK(reader);
+
+        produce_frame(reader, frame);
+
+        READER_LOCK(reader);
+        reader->write_index = (reader->write_index + 1) % reader->ring_size;
+        reader->ready_count++;
+        if (frame->size != reader->frame_size)
+            reader->end_of_input = EB_TRUE;
+        READER_SIGNAL(reader);
+        READER_UNLOCK(reader);
+        if (frame->size != reader->frame_size)
+            break;
+    }
+    return 0;
+}
+
+/* Next frame for the encoder, NULL at the end of the input. The previous
+   frame goes back to the ring, the encoder copied it when it was sent. */
+static InputFrame *take_frame(EbAppInputReader *reader) {
+    InputFrame *frame = NULL;
+
+    if (!reader->prefetch_thread_active) {
+        produce_frame(reader, &reader->ring[0]);
+        return &reader->ring[0];
+    }
+    READER_LOCK(reader);
+    if (reader->frame_held) {
+        reader->read_index = (reader->read_index + 1) % reader->ring_size;
+        reader->ready_count--;
+        reader->frame_held = EB_FALSE;
+        READER_SIGNAL(reader);
+    }
+    while (!reader->ready_count && !reader->end_of_input) READER_WAIT(reader);
+    if (reader->ready_count) {
+        frame              = &reader->ring[reader->read_index];
+        reader->frame_held = EB_TRUE;
+    }
+    READER_UNLOCK(reader);
+    return frame;
+}
+
+EbErrorType app_input_reader_open(EbConfig *config) {
+    EbAppInputReader *reader;
+
+    config->input_reader = NULL;
+    if (!config->mmap_input && !config->input_prefetch)
+        return EB_ErrorNone;
+
+    reader = (EbAppInputReader *)calloc(1, sizeof(*reader));
+    if (!reader)
+        return EB_ErrorInsufficientResources;
+    reader->input_file     = config->input_file;
+    reader->error_log_file = config->error_log_file;
+    reader->y4m_input      = config->y4m_input;
+    reader->is_pipe        = config->input_file == stdin || config->input_file_is_fifo;
+    reader->frame_size     = get_input_frame_size(config);
+    if (reader->is_pipe && !reader->y4m_input) {
+        /* 9 bytes were already buffered during the the YUV4MPEG2 header probe */
+        memcpy(reader->prefix, config->y4m_buf, YUV4MPEG2_IND_SIZE);
+        reader->prefix_size = YUV4MPEG2_IND_SIZE;
+    }
+
+    if (config->mmap_input && (reader->is_pipe || !map_input_file(reader)))
+        fprintf(stderr, "Warning: the input cannot be mapped, it is read instead\n");
+    if (!reader->map && !config->input_prefetch) {
+        // Nothing to gain over the default reads
+        free(reader);
+        return EB_ErrorNone;
+    }
+
+    reader->ring_size = config->input_prefetch ? config->input_prefetch + 1 : 1;
+    if (!reader->map) {
+        for (uint32_t i = 0; i < reader->ring_size; i++) {
+            reader->ring[i].buffer = (uint8_t *)malloc((size_t)reader->frame_size);
+            if (!reader->ring[i].buffer) {
+                config->input_reader = reader;
+                app_input_reader_close(config);
+                return EB_ErrorInsufficientResources;
+            }
+        }
+    }
+    config->input_reader = reader;
+
+    if (config->input_prefetch) {
+#ifdef _WIN32
+        InitializeCriticalSection(&reader->lock);
+        InitializeConditionVariable(&reader->cond);
+        reader->prefetch_thread = CreateThread(NULL, 0, prefetch_kernel, reader, 0, NULL);
+        reader->prefetch_thread_active = reader->prefetch_thread != NULL;
+#else
+        pthread_mutex_init(&reader->lock, NULL);
+        pthread_cond_init(&reader->cond, NULL);
+        reader->prefetch_thread_active = !pthread_create(
+            &reader->prefetch_thread, NULL, prefetch_kernel, reader);
+#endif
+        if (!reader->prefetch_thread_active) {
+            app_input_reader_close(config);
+            return EB_ErrorInsufficientResources;
+        }
+    }
+    return EB_ErrorNone;
+}
+
+void app_input_reader_close(EbConfig *config) {
+    EbAppInputReader *reader = config->input_reader;
+    if (!reader)
+        return;
+
+    if (config->input_prefetch) {
+        if (reader->prefetch_thread_active) {
+            READER_LOCK(reader);
+            reader->stop = EB_TRUE;
+            READER_SIGNAL(reader);
+            READER_UNLOCK(reader);
+#ifdef _WIN32
+            WaitForSingleObject(reader->prefetch_thread, INFINITE);
+            CloseHandle(reader->prefetch_thread);
+#else
+            pthread_join(reader->prefetch_thread, NULL);
+#endif
+        }
+#ifdef _WIN32
+        DeleteCriticalSection(&reader->lock);
+#else
+        pthread_mutex_destroy(&reader->lock);
+        pthread_cond_destroy(&reader->cond);
+#endif
+    }
+    unmap_input_file(reader);
+    for (uint32_t i = 0; i < reader->ring_size; i++) free(reader->ring[i].buffer);
+    free(reader);
+    config->input_reader = NULL;
+}
+
+void app_input_reader_read(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *header_ptr) {
+    EbAppInputReader *reader    = config->input_reader;
+    EbSvtIOFormat *   input_ptr = (EbSvtIOFormat *)header_ptr->p_buffer;
+    InputFrame *      frame     = take_frame(reader);
+
+    const uint32_t input_padded_width  = config->input_padded_width;
+    const uint32_t input_padded_height = config->input_padded_height;
+    const uint8_t  color_format        = config->config.encoder_color_format;
+    const uint8_t  subsampling_x       = (color_format == EB_YUV444 ? 1 : 2) - 1;
+
+    input_ptr->y_stride  = input_padded_width;
+    input_ptr->cr_stride = input_padded_width >> subsampling_x;
+    input_ptr->cb_stride = input_padded_width >> subsampling_x;
+
+    if (!frame || frame->size != reader->frame_size) {
+        //for a fifo, we only know this when we reach eof
+        config->frames_to_be_encoded = config->frames_encoded;
+        header_ptr->n_filled_len     = 0;
+        return;
+    }
+
+    uint8_t *data = (uint8_t *)frame->data;
+    if (is_16bit && config->config.compressed_ten_bit_format == 1) {
+        const size_t luma_8bit_size   = input_padded_width * input_padded_height;
+        const size_t chroma_8bit_size = luma_8bit_size >> (3 - color_format);
+        const size_t luma_2bit_size   = luma_8bit_size / 4; //4-2bit pixels into 1 byte
+        const size_t chroma_2bit_size = luma_2bit_size >> (3 - color_format);
+
+        input_ptr->luma     = data;
+        input_ptr->cb       = data + luma_8bit_size;
+        input_ptr->cr       = data + luma_8bit_size + chroma_8bit_size;
+        input_ptr->luma_ext = data + luma_8bit_size + 2 * chroma_8bit_size;
+        input_ptr->cb_ext   = input_ptr->luma_ext + luma_2bit_size;
+        input_ptr->cr_ext   = input_ptr->cb_ext + chroma_2bit_size;
+    } else {
+        const size_t luma_size   = (input_padded_width * input_padded_height) << is_16bit;
+        const size_t chroma_size = luma_size >> (3 - color_format);
+
+        input_ptr->luma = data;
+        input_ptr->cb   = data + luma_size;
+        input_ptr->cr   = data + luma_size + chroma_size;
+    }
+    header_ptr->n_filled_len = (uint32_t)frame->size;
+}
@@ -0,0 +1,41 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbAppInputReader_h
+#define EbAppInputReader_h
+
+#include "EbSvtAv1Enc.h"
+#include "EbAppConfig.h"
+
+/* Maximum number of frames read ahead by the prefetch thread */
+#define MAX_INPUT_PREFETCH 64
+
+/***************************************
+ * Input reader
+ *   Replaces the per plane fread of the main loop when --mmap-input or
+ *   --input-prefetch is set. Regular files are mapped and the input
+ *   pictures point into the mapping; other inputs are read whole frame at
+ *   a time. With prefetch, a thread maps in or reads the next frames into
+ *   a bounded ring while the encoder consumes the current one.
+ ***************************************/
+typedef struct EbAppInputReader EbAppInputReader;
+
+/* Creates config->input_reader, leaves it NULL when the options are not set */
+extern EbErrorType app_input_reader_open(EbConfig *config);
+
+extern void app_input_reader_close(EbConfig *config);
+
+/* Points the planes of the input picture to the next frame. n_filled_len is
+ * 0 at the end of a pipe. */
+extern void app_input_reader_read(EbConfig *config, uint8_t is_16bit,
+                                  EbBufferHeaderType *header_ptr);
+
+#endif // EbAppInputReader_h
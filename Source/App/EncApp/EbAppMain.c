@@ -83,6 +83,8 @@ typedef struct EncContext {
 
     EncodePass pass;
     int32_t    total_frames;
+    // worker pool of every channel when SharedThreadPool is set
+    EbSvtAv1ThreadPool* thread_pool;
 } EncContext;
 
 static EbErrorType enc_context_ctor(EncApp* enc_app, EncContext* enc_context, int32_t argc,
@@ -123,6 +125,15 @@ static EbErrorType enc_context_ctor(EncApp* enc_app, EncContext* enc_context, in
     if (enc_context->channels[0].config->config.target_socket != -1)
         assign_app_thread_group(enc_context->channels[0].config->config.target_socket);
 
+    if (enc_context->channels[0].config->shared_thread_pool) {
+        return_error = svt_av1_enc_create_thread_pool(
+            &enc_context->thread_pool, enc_context->channels[0].config->config.logical_processors);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+        for (uint32_t inst_cnt = 0; inst_cnt < num_channels; ++inst_cnt)
+            enc_context->channels[inst_cnt].config->config.thread_pool = enc_context->thread_pool;
+    }
+
     // Init the Encoder
     for (uint32_t inst_cnt = 0; inst_cnt < num_channels; ++inst_cnt) {
         EncChannel* c = enc_context->channels + inst_cnt;
@@ -153,6 +164,9 @@ static void enc_context_dctor(EncContext* enc_context) {
         EncChannel* c = enc_context->channels + inst_cnt;
         enc_channel_dctor(c, inst_cnt);
     }
+    // after every channel, their tasks run on it until they are deconstructed
+    if (enc_context->thread_pool)
+        svt_av1_enc_destroy_thread_pool(enc_context->thread_pool);
 
     for (uint32_t warning_id = 0; warning_id < MAX_NUM_TOKENS; warning_id++)
         free(enc_context->warning[warning_id]);
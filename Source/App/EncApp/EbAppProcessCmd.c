@@ -21,6 +21,7 @@
 #include "EbAppConfig.h"
 #include "EbSvtAv1ErrorCodes.h"
 #include "EbAppInputy4m.h"
+#include "EbAppInputReader.h"
 #include "EbTime.h"
 /***************************************
  * Macros
@@ -634,7 +635,88 @@ void log_error_output(FILE *error_log_file, uint32_t error_code) {
     return;
 }
 
+/* Prints the per stage summary and writes the Chrome trace of the pipeline */
+static void write_pipeline_stats(EbConfig *config, EbComponentType *component_handle) {
+    SvtAv1PipelineStats *stats = (SvtAv1PipelineStats *)malloc(sizeof(*stats));
+    SvtAv1FixedBuf       trace;
+
+    if (stats &&
+        svt_av1_enc_get_stream_info(
+            component_handle, SVT_AV1_STREAM_INFO_PIPELINE_STATS, stats) == EB_ErrorNone) {
+        fprintf(stderr,
+                "\n%-28s %8s %12s %12s %9s %7s\n",
+                "Stage",
+                "Objects",
+                "AvgQueue(ms)",
+                "MaxQueue(ms)",
+                "MaxDepth",
+                "Busy(%)");
+        for (uint32_t i = 0; i < stats->stage_count; i++) {
+            const SvtAv1StageStats *stage = &stats->stages[i];
+            uint64_t                busy  = 0;
+            for (uint32_t t = 0; t < stage->thread_count && t < SVT_AV1_MAX_STAGE_THREADS; t++)
+                busy += stage->busy_time[t];
+            fprintf(stderr,
+                    "%-28s %8llu %12.3f %12.3f %9u %7.1f\n",
+                    stage->name,
+                    (unsigned long long)stage->object_count,
+                    stage->object_count
+                        ? (double)stage->queue_time_total / stage->object_count / 1000
+                        : 0.0,
+                    (double)stage->queue_time_max / 1000,
+                    stage->queue_depth_max,
+                    stats->elapsed_time
+                        ? 100.0 * busy / ((double)stats->elapsed_time * stage->thread_count)
+                        : 0.0);
+        }
+        if (stats->tf_picture_count)
+            fprintf(stderr,
+                    "Temporal filtering: %llu pictures, AvgLatency(ms) %.3f, MaxLatency(ms) "
+                    "%.3f, Wait(ms) %.3f\n",
+                    (unsigned long long)stats->tf_picture_count,
+                    (double)stats->tf_latency_total / stats->tf_picture_count / 1000,
+                    (double)stats->tf_latency_max / 1000,
+                    (double)stats->tf_wait_time / 1000);
+    }
+    free(stats);
+    if (svt_av1_enc_get_stream_info(
+            component_handle, SVT_AV1_STREAM_INFO_PIPELINE_TRACE, &trace) == EB_ErrorNone)
+        fwrite(trace.buf, 1, (size_t)trace.sz, config->pipeline_trace_file);
+}
+
+/* Prints the size and peak use of the picture pools */
+static void write_memory_usage(EbComponentType *component_handle) {
+    SvtAv1MemoryUsage usage;
+
+    if (svt_av1_enc_get_stream_info(
+            component_handle, SVT_AV1_STREAM_INFO_MEMORY_USAGE, &usage) != EB_ErrorNone)
+        return;
+    fprintf(stderr,
+            "\nMemory: %.1f MB allocated at init, budget %.1f MB\n%-16s %8s %8s %12s %12s\n",
+            (double)usage.init_bytes / (1 << 20),
+            (double)usage.budget_bytes / (1 << 20),
+            "Pool",
+            "Objects",
+            "PeakUse",
+            "Object(KB)",
+            "PeakUse(MB)");
+    for (uint32_t i = 0; i < usage.pool_count; i++) {
+        const SvtAv1PoolMemory *pool = &usage.pools[i];
+        fprintf(stderr,
+                "%-16s %8u %8u %12.1f %12.1f\n",
+                pool->name,
+                pool->object_count,
+                pool->peak_in_use,
+                (double)pool->object_bytes / 1024,
+                (double)pool->object_bytes * pool->peak_in_use / (1 << 20));
+    }
+}
+
 void read_input_frames(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *header_ptr) {
+    if (config->input_reader) {
+        app_input_reader_read(config, is_16bit, header_ptr);
+        return;
+    }
     const uint32_t input_padded_width  = config->input_padded_width;
     const uint32_t input_padded_height = config->input_padded_height;
     FILE *         input_file          = config->input_file;
@@ -1122,6 +1204,23 @@ void process_output_statistics_buffer(EbBufferHeaderType *header_ptr, EbConfig *
     return;
 }
 
+/* Tile group output: appends a fragment of the temporal unit being received */
+static EbBool append_fragment(EbConfig *config, const EbBufferHeaderType *header_ptr) {
+    const uint32_t size = config->fragment_size + header_ptr->n_filled_len;
+    if (size > config->fragment_alloc) {
+        uint8_t *buffer = (uint8_t *)realloc(config->fragment_buffer, size);
+        if (!buffer)
+            return EB_FALSE;
+        config->fragment_buffer = buffer;
+        config->fragment_alloc  = size;
+    }
+    memcpy(config->fragment_buffer + config->fragment_size,
+           header_ptr->p_buffer,
+           header_ptr->n_filled_len);
+    config->fragment_size = size;
+    return EB_TRUE;
+}
+
 void process_output_stream_buffer(EncChannel *channel, EncApp *enc_app, int32_t *frame_count) {
     EbConfig *           config        = channel->config;
     EbAppContext *       app_call_back = channel->app_callback;
@@ -1158,12 +1257,28 @@ void process_output_stream_buffer(EncChannel *channel, EncApp *enc_app, int32_t
             return;
         } else if (stream_status != EB_NoErrorEmptyQueue) {
             uint32_t flags = header_ptr->flags;
+            if (flags & EB_BUFFERFLAG_FRAGMENT) {
+                // kept until the last packet of the temporal unit
+                if (!append_fragment(config, header_ptr)) {
+                    svt_av1_enc_release_out_buffer(&header_ptr);
+                    channel->exit_cond_output = APP_ExitConditionError;
+                    return;
+                }
+                config->performance_context.byte_count += header_ptr->n_filled_len;
+                svt_av1_enc_release_out_buffer(&header_ptr);
+                continue;
+            }
+            // the low-latency mode may end the stream with an empty packet
+            uint8_t has_frame = header_ptr->n_filled_len != 0;
             is_alt_ref     = (flags & EB_BUFFERFLAG_IS_ALT_REF);
-            if (!(flags & EB_BUFFERFLAG_IS_ALT_REF))
-                ++(config->performance_context.frame_count);
-            *total_latency += (uint64_t)header_ptr->n_tick_count;
-            *max_latency = (header_ptr->n_tick_count > *max_latency) ? header_ptr->n_tick_count
-                                                                     : *max_latency;
+            if (has_frame) {
+                if (!(flags & EB_BUFFERFLAG_IS_ALT_REF))
+                    ++(config->performance_context.frame_count);
+                *total_latency += (uint64_t)header_ptr->n_tick_count;
+                *max_latency = (header_ptr->n_tick_count > *max_latency)
+                    ? header_ptr->n_tick_count
+                    : *max_latency;
+            }
 
             app_svt_av1_get_time(&finish_s_time, &finish_u_time);
 
@@ -1184,18 +1299,21 @@ void process_output_stream_buffer(EncChannel *channel, EncApp *enc_app, int32_t
                     finish_u_time);
 
             // Write Stream Data to file
-            if (stream_file) {
+            if (stream_file && has_frame) {
                 if (config->performance_context.frame_count == 1 &&
                     !(flags & EB_BUFFERFLAG_IS_ALT_REF)) {
                     write_ivf_stream_header(config);
                 }
-                write_ivf_frame_header(config, header_ptr->n_filled_len);
+                write_ivf_frame_header(config, config->fragment_size + header_ptr->n_filled_len);
+                if (config->fragment_size)
+                    fwrite(config->fragment_buffer, 1, config->fragment_size, stream_file);
                 fwrite(header_ptr->p_buffer, 1, header_ptr->n_filled_len, stream_file);
             }
 
             config->performance_context.byte_count += header_ptr->n_filled_len;
+            config->fragment_size = 0;
 
-            if (config->config.stat_report && !(flags & EB_BUFFERFLAG_IS_ALT_REF))
+            if (config->config.stat_report && has_frame && !(flags & EB_BUFFERFLAG_IS_ALT_REF))
                 process_output_statistics_buffer(header_ptr, config);
 
             // Update Output Port Activity State
@@ -1229,6 +1347,10 @@ void process_output_stream_buffer(EncChannel *channel, EncApp *enc_app, int32_t
                         }
                     }
                 }
+                if (config->pipeline_trace_file)
+                    write_pipeline_stats(config, component_handle);
+                if (config->config.memory_budget)
+                    write_memory_usage(component_handle);
             }
 
             ++*frame_count;
@@ -0,0 +1,67 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#include <immintrin.h>
+#include "common_dsp_rtcd.h"
+#include "EbBitstreamUnit.h"
+
+// The 16 entries of a CDF are processed in 16 bit lanes. The CDF is loaded
+// and stored in 32 bit pairs up to the entry nsyms - 1, which is either in
+// the CDF or its counter, so no other memory is touched.
+static INLINE __m256i cdf_pairs_mask(int32_t nsyms) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32((nsyms + 1) >> 1),
+                              _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+int32_t svt_od_ec_search_cdf_avx2(const uint16_t *icdf, int32_t nsyms, uint32_t c, uint32_t r) {
+    const __m256i mask = cdf_pairs_mask(nsyms);
+    const __m256i cdf  = _mm256_maskload_epi32((const int *)icdf, mask);
+    const __m256i prob = _mm256_srli_epi16(cdf, EC_PROB_SHIFT);
+    // (r >> 8) * prob >> 1 is the high half of (prob << 7) * (r & 0xff00); a
+    // prob of 512 (icdf 32768) does not fit 16 bits and gives r & 0xff00
+    const __m256i rng   = _mm256_set1_epi16((int16_t)(r & 0xff00));
+    const __m256i top   = _mm256_cmpeq_epi16(prob, _mm256_set1_epi16(1 << (15 - EC_PROB_SHIFT)));
+    __m256i       v     = _mm256_mulhi_epu16(_mm256_slli_epi16(prob, 7), rng);
+    v                   = _mm256_blendv_epi8(v, rng, top);
+    const __m256i min_p = _mm256_sub_epi16(
+        _mm256_set1_epi16((int16_t)(EC_MIN_PROB * (nsyms - 1))),
+        _mm256_setr_epi16(0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60));
+    v = _mm256_add_epi16(v, min_p);
+
+    // the bounds above c are the first ones, there are as many as the symbol
+    const __m256i c16 = _mm256_set1_epi16((int16_t)c);
+    const __m256i ge  = _mm256_cmpeq_epi16(_mm256_max_epu16(c16, v), c16);
+    const uint32_t lt = ~(uint32_t)_mm256_movemask_epi8(ge) &
+        (uint32_t)((1ull << (2 * (nsyms - 1))) - 1);
+    return get_msb(lt + 1) >> 1;
+}
+
+void svt_av1_update_cdf_avx2(uint16_t *cdf, int32_t val, int32_t nsymbs) {
+    static const int32_t nsymbs2speed[17] = {0, 0, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+    assert(nsymbs < 17);
+    const int32_t rate = 3 + (cdf[nsymbs] > 15) + (cdf[nsymbs] > 31) + nsymbs2speed[nsymbs];
+    const __m128i shift = _mm_cvtsi32_si128(rate);
+    const __m256i lane  = _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m256i mask  = cdf_pairs_mask(nsymbs);
+    const __m256i in    = _mm256_maskload_epi32((const int *)cdf, mask);
+
+    // the entries below val move up to 32768, the others down to 0
+    const __m256i below = _mm256_cmpgt_epi16(_mm256_set1_epi16((int16_t)val), lane);
+    const __m256i up    = _mm256_add_epi16(
+        in, _mm256_srl_epi16(_mm256_sub_epi16(_mm256_set1_epi16((int16_t)AOM_ICDF(0)), in), shift));
+    const __m256i down = _mm256_sub_epi16(in, _mm256_srl_epi16(in, shift));
+    __m256i       out  = _mm256_blendv_epi8(down, up, below);
+    // the last entry and the counter keep their value
+    out = _mm256_blendv_epi8(
+        out, in, _mm256_cmpgt_epi16(lane, _mm256_set1_epi16((int16_t)(nsymbs - 2))));
+    _mm256_maskstore_epi32((int *)cdf, mask, out);
+    cdf[nsymbs] += (cdf[nsymbs] < 32);
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+ */
+
+#include <immintrin.h>
+#include "common_dsp_rtcd.h"
+#include "EbDefinitions.h"
+
+// 8 samples are processed per iteration in 32 bit lanes, the scaling
+// function is a table lookup, the remaining columns are left to the C code.
+
+// Interpolated lookup of the 256 entries scaling function, as scale_lut()
+static INLINE __m256i scale_lut_avx2(const int32_t *scaling_lut, const __m256i index,
+                                     const int32_t bit_depth) {
+    if (bit_depth == 8)
+        return _mm256_i32gather_epi32(scaling_lut, index, 4);
+
+    const __m128i shift = _mm_cvtsi32_si128(bit_depth - 8);
+    const __m256i x     = _mm256_srl_epi32(index, shift);
+    // the last entry has no right neighbour, its slope is 0
+    const __m256i x1    = _mm256_min_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(1)),
+                                        _mm256_set1_epi32(255));
+    const __m256i frac  = _mm256_and_si256(index, _mm256_set1_epi32((1 << (bit_depth - 8)) - 1));
+    const __m256i s0    = _mm256_i32gather_epi32(scaling_lut, x, 4);
+    const __m256i s1    = _mm256_i32gather_epi32(scaling_lut, x1, 4);
+    const __m256i delta = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(s1, s0), frac),
+                                           _mm256_set1_epi32(1 << (bit_depth - 9)));
+    return _mm256_add_epi32(s0, _mm256_sra_epi32(delta, shift));
+}
+
+// clamp(sample + ((scale * grain + rounding) >> scaling_shift), min, max)
+static INLINE __m256i add_noise_avx2(const __m256i sample, const __m256i scale,
+                                     const int32_t *grain, const __m256i rounding,
+                                     const __m128i scaling_shift, const __m256i min_value,
+                                     const __m256i max_value) {
+    const __m256i g     = _mm256_loadu_si256((const __m256i *)grain);
+    const __m256i noise = _mm256_sra_epi32(
+        _mm256_add_epi32(_mm256_mullo_epi32(scale, g), rounding), scaling_shift);
+    return _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(sample, noise), min_value),
+                            max_value);
+}
+
+static INLINE void store_8bit(uint8_t *dst, const __m256i v) {
+    const __m128i v16 = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(v16, v16));
+}
+
+static INLINE void store_16bit(uint16_t *dst, const __m256i v) {
+    _mm_storeu_si128((__m128i *)dst,
+                     _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+// Scaling function input of 8 chroma samples, from the chroma and the
+// co-located luma samples
+static INLINE __m256i chroma_scaling_index_avx2(const __m256i average_luma, const __m256i chroma,
+                                                const FgnPlaneParams *plane,
+                                                const __m256i max_index) {
+    const __m256i merged = _mm256_add_epi32(
+        _mm256_srai_epi32(
+            _mm256_add_epi32(_mm256_mullo_epi32(average_luma, _mm256_set1_epi32(plane->luma_mult)),
+                             _mm256_mullo_epi32(chroma, _mm256_set1_epi32(plane->mult))),
+            6),
+        _mm256_set1_epi32(plane->offset));
+    return _mm256_min_epi32(_mm256_max_epi32(merged, _mm256_setzero_si256()), max_index);
+}
+
+void svt_av1_add_noise_luma_avx2(uint8_t *luma, int32_t luma_stride, const int32_t *grain,
+                                 int32_t grain_stride, int32_t width, int32_t height,
+                                 const FgnPlaneParams *plane) {
+    const int32_t width8        = width & ~7;
+    const __m256i rounding      = _mm256_set1_epi32(1 << (plane->scaling_shift - 1));
+    const __m128i scaling_shift = _mm_cvtsi32_si128(plane->scaling_shift);
+    const __m256i min_value     = _mm256_set1_epi32(plane->min_value);
+    const __m256i max_value     = _mm256_set1_epi32(plane->max_value);
+
+    for (int32_t i = 0; i < height; i++) {
+        uint8_t *      row       = luma + i * luma_stride;
+        const int32_t *grain_row = grain + i * grain_stride;
+        for (int32_t j = 0; j < width8; j += 8) {
+            const __m256i l = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(row + j)));
+            const __m256i s = _mm256_i32gather_epi32(plane->scaling_lut, l, 4);
+            store_8bit(row + j,
+                       add_noise_avx2(
+                           l, s, grain_row + j, rounding, scaling_shift, min_value, max_value));
+        }
+    }
+    if (width8 < width)
+        svt_av1_add_noise_luma_c(
+            luma + width8, luma_stride, grain + width8, grain_stride, width - width8, height, plane);
+}
+
+void svt_av1_add_noise_luma_hbd_avx2(uint16_t *luma, int32_t luma_stride, const int32_t *grain,
+                                     int32_t grain_stride, int32_t width, int32_t height,
+                                     const FgnPlaneParams *plane) {
+    const int32_t width8        = width & ~7;
+    const __m256i rounding      = _mm256_set1_epi32(1 << (plane->scaling_shift - 1));
+    const __m128i scaling_shift = _mm_cvtsi32_si128(plane->scaling_shift);
+    const __m256i min_value     = _mm256_set1_epi32(plane->min_value);
+    const __m256i max_value     = _mm256_set1_epi32(plane->max_value);
+
+    for (int32_t i = 0; i < height; i++) {
+        uint16_t *     row       = luma + i * luma_stride;
+        const int32_t *grain_row = grain + i * grain_stride;
+        for (int32_t j = 0; j < width8; j += 8) {
+            const __m256i l = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(row + j)));
+            const __m256i s = scale_lut_avx2(plane->scaling_lut, l, plane->bit_depth);
+            store_16bit(row + j,
+                        add_noise_avx2(
+                            l, s, grain_row + j, rounding, scaling_shift, min_value, max_value));
+        }
+    }
+    if (width8 < width)
+        svt_av1_add_noise_luma_hbd_c(
+            luma + width8, luma_stride, grain + width8, grain_stride, width - width8, height, plane);
+}
+
+void svt_av1_add_noise_chroma_avx2(uint8_t *chroma, int32_t chroma_stride, const uint8_t *luma,
+                                   int32_t luma_stride, const int32_t *grain, int32_t grain_stride,
+                                   int32_t width, int32_t height, const FgnPlaneParams *plane) {
+    const int32_t width8        = width & ~7;
+    const __m256i rounding      = _mm256_set1_epi32(1 << (plane->scaling_shift - 1));
+    const __m128i scaling_shift = _mm_cvtsi32_si128(plane->scaling_shift);
+    const __m256i min_value     = _mm256_set1_epi32(plane->min_value);
+    const __m256i max_value     = _mm256_set1_epi32(plane->max_value);
+    const __m256i max_index     = _mm256_set1_epi32((256 << (plane->bit_depth - 8)) - 1);
+
+    for (int32_t i = 0; i < height; i++) {
+        uint8_t *      row       = chroma + i * chroma_stride;
+        const uint8_t *luma_row  = luma + (i << plane->subsamp_y) * luma_stride;
+        const int32_t *grain_row = grain + i * grain_stride;
+        for (int32_t j = 0; j < width8; j += 8) {
+            __m256i average_luma;
+            if (plane->subsamp_x) {
+                // (l[2j] + l[2j + 1] + 1) >> 1
+                const __m128i pairs = _mm_maddubs_epi16(
+                    _mm_loadu_si128((const __m128i *)(luma_row + (j << 1))), _mm_set1_epi8(1));
+                average_luma = _mm256_cvtepu16_epi32(
+                    _mm_srli_epi16(_mm_add_epi16(pairs, _mm_set1_epi16(1)), 1));
+            } else
+                average_luma =
+                    _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(luma_row + j)));
+            const __m256i c =
+                _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(row + j)));
+            const __m256i s = _mm256_i32gather_epi32(
+                plane->scaling_lut,
+                chroma_scaling_index_avx2(average_luma, c, plane, max_index),
+                4);
+            store_8bit(row + j,
+                       add_noise_avx2(
+                           c, s, grain_row + j, rounding, scaling_shift, min_value, max_value));
+        }
+    }
+    if (width8 < width)
+        svt_av1_add_noise_chroma_c(chroma + width8,
+                                   chroma_stride,
+                                   luma + (width8 << plane->subsamp_x),
+                                   luma_stride,
+                                   grain + width8,
+                                   grain_stride,
+                                   width - width8,
+                                   height,
+                                   plane);
+}
+
+void svt_av1_add_noise_chroma_hbd_avx2(uint16_t *chroma, int32_t chroma_stride,
+                                       const uint16_t *luma, int32_t luma_stride,
+                                       const int32_t *grain, int32_t grain_stride, int32_t width,
+                                       int32_t height, const FgnPlaneParams *plane) {
+    const int32_t width8        = width & ~7;
+    const __m256i rounding      = _mm256_set1_epi32(1 << (plane->scaling_shift - 1));
+    const __m128i scaling_shift = _mm_cvtsi32_si128(plane->scaling_shift);
+    const __m256i min_value     = _mm256_set1_epi32(plane->min_value);
+    const __m256i max_value     = _mm256_set1_epi32(plane->max_value);
+    const __m256i max_index     = _mm256_set1_epi32((256 << (plane->bit_depth - 8)) - 1);
+
+    for (int32_t i = 0; i < height; i++) {
+        uint16_t *      row       = chroma + i * chroma_stride;
+        const uint16_t *luma_row  = luma + (i << plane->subsamp_y) * luma_stride;
+        const int32_t * grain_row = grain + i * grain_stride;
+        for (int32_t j = 0; j < width8; j += 8) {
+            __m256i average_luma;
+            if (plane->subsamp_x) {
+                // (l[2j] + l[2j + 1] + 1) >> 1
+                const __m256i pairs = _mm256_madd_epi16(
+                    _mm256_loadu_si256((const __m256i *)(luma_row + (j << 1))),
+                    _mm256_set1_epi16(1));
+                average_luma =
+                    _mm256_srli_epi32(_mm256_add_epi32(pairs, _mm256_set1_epi32(1)), 1);
+            } else
+                average_luma =
+                    _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(luma_row + j)));
+            const __m256i c =
+                _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(row + j)));
+            const __m256i s =
+                scale_lut_avx2(plane->scaling_lut,
+                               chroma_scaling_index_avx2(average_luma, c, plane, max_index),
+                               plane->bit_depth);
+            store_16bit(row + j,
+                        add_noise_avx2(
+                            c, s, grain_row + j, rounding, scaling_shift, min_value, max_value));
+        }
+    }
+    if (width8 < width)
+        svt_av1_add_noise_chroma_hbd_c(chroma + width8,
+                                       chroma_stride,
+                                       luma + (width8 << plane->subsamp_x),
+                                       luma_stride,
+                                       grain + width8,
+                                       grain_stride,
+                                       width - width8,
+                                       height,
+                                       plane);
+}
@@ -0,0 +1,71 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#include <immintrin.h>
+#include "common_dsp_rtcd.h"
+#include "EbInvTransforms.h"
+#include "EbBitstreamUnit.h"
+
+// 8 levels are dequantized per iteration in 32 bit lanes. The low 24 bits of
+// the 32 bit product are the ones of the 64 bit product of the C code. AVX2
+// has no scatter, the non-zero coefficients are stored one by one.
+void svt_av1_dequant_scatter_avx2(const int32_t *level, int32_t n_coeffs, const int16_t *scan,
+                                  const int16_t *dequant, const QmVal *iqmatrix, int32_t shift,
+                                  int32_t bit_depth, int32_t *qcoeffs) {
+    const __m256i max_value = _mm256_set1_epi32((1 << (7 + bit_depth)) - 1);
+    const __m256i min_value = _mm256_set1_epi32(-(1 << (7 + bit_depth)));
+    const __m256i mask_24   = _mm256_set1_epi32(0xffffff);
+    const __m256i zero      = _mm256_setzero_si256();
+    const __m256i lane      = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m128i shift_cnt = _mm_cvtsi32_si128(shift);
+    __m256i       dqv       = _mm256_setr_epi32(
+        dequant[0], dequant[1], dequant[1], dequant[1], dequant[1], dequant[1], dequant[1], dequant[1]);
+    DECLARE_ALIGNED(32, int32_t, q_coeff[8]);
+
+    for (int32_t i = 0; i < n_coeffs; i += 8) {
+        // the tail is masked, the levels of the next block follow in the buffer
+        const __m256i in_range = _mm256_cmpgt_epi32(_mm256_set1_epi32(n_coeffs - i), lane);
+        const __m256i lev      = _mm256_maskload_epi32(level + i, in_range);
+        const __m256i zero_lev = _mm256_cmpeq_epi32(lev, zero);
+        uint32_t      nz       = ~(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(zero_lev)) &
+            (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(in_range));
+        if (nz) {
+            __m256i       dq  = dqv;
+            if (iqmatrix != NULL) {
+                // a byte gather would read past the last matrix
+                const int16_t *s  = scan + i;
+                const __m256i  iq = _mm256_setr_epi32(iqmatrix[s[0]],
+                                                     iqmatrix[s[1]],
+                                                     iqmatrix[s[2]],
+                                                     iqmatrix[s[3]],
+                                                     iqmatrix[s[4]],
+                                                     iqmatrix[s[5]],
+                                                     iqmatrix[s[6]],
+                                                     iqmatrix[s[7]]);
+                dq = _mm256_mullo_epi32(iq, dq);
+                dq = _mm256_srai_epi32(
+                    _mm256_add_epi32(dq, _mm256_set1_epi32(1 << (AOM_QM_BITS - 1))), AOM_QM_BITS);
+            }
+            __m256i q = _mm256_and_si256(_mm256_mullo_epi32(_mm256_abs_epi32(lev), dq), mask_24);
+            q         = _mm256_srl_epi32(q, shift_cnt);
+            q         = _mm256_sign_epi32(q, lev);
+            q         = _mm256_max_epi32(_mm256_min_epi32(q, max_value), min_value);
+            _mm256_store_si256((__m256i *)q_coeff, q);
+
+            while (nz) {
+                const int32_t k = get_msb(nz & (0 - nz));
+                qcoeffs[scan[i + k]] = q_coeff[k];
+                nz &= nz - 1;
+            }
+        }
+        dqv = _mm256_set1_epi32(dequant[1]);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#include <string.h>
+
+#include "EbArena.h"
+
+#define ARENA_ROUND(size) (((size) + ALVALUE - 1) & ~((size_t)ALVALUE - 1))
+// the overflow block header is padded so that the data after it stays aligned
+#define ARENA_BLOCK_HEADER ARENA_ROUND(sizeof(EbArenaBlock))
+
+static EbErrorType arena_heap_alloc(uint8_t **buffer, size_t size) {
+    EB_MALLOC_ALIGNED(*buffer, size);
+    return EB_ErrorNone;
+}
+
+static void arena_free_overflow(EbArena *arena_ptr) {
+    while (arena_ptr->overflow) {
+        EbArenaBlock *next = arena_ptr->overflow->next;
+        EB_FREE_ALIGNED(arena_ptr->overflow);
+        arena_ptr->overflow = next;
+    }
+}
+
+static void arena_dctor(EbPtr p) {
+    EbArena *obj = (EbArena *)p;
+    arena_free_overflow(obj);
+    EB_FREE_ALIGNED(obj->buffer);
+}
+
+EbErrorType svt_arena_ctor(EbArena *arena_ptr, size_t size) {
+    arena_ptr->dctor = arena_dctor;
+    if (size) {
+        arena_ptr->size = ARENA_ROUND(size);
+        EB_MALLOC_ALIGNED(arena_ptr->buffer, arena_ptr->size);
+    }
+    return EB_ErrorNone;
+}
+
+void *svt_arena_alloc(EbArena *arena_ptr, size_t size) {
+    size = ARENA_ROUND(size);
+    arena_ptr->peak += size;
+    if (arena_ptr->used + size <= arena_ptr->size) {
+        void *p = arena_ptr->buffer + arena_ptr->used;
+        arena_ptr->used += size;
+        return p;
+    }
+
+    uint8_t *block;
+    if (arena_heap_alloc(&block, ARENA_BLOCK_HEADER + size) != EB_ErrorNone)
+        return NULL;
+    ((EbArenaBlock *)block)->next = arena_ptr->overflow;
+    arena_ptr->overflow           = (EbArenaBlock *)block;
+    return block + ARENA_BLOCK_HEADER;
+}
+
+void svt_arena_reset(EbArena *arena_ptr) {
+    if (arena_ptr->overflow) {
+        arena_free_overflow(arena_ptr);
+        // grow to the high-water mark; on failure the arena keeps working
+        // out of overflow blocks
+        EB_FREE_ALIGNED(arena_ptr->buffer);
+        arena_ptr->size = 0;
+        if (arena_heap_alloc(&arena_ptr->buffer, arena_ptr->peak) == EB_ErrorNone)
+            arena_ptr->size = arena_ptr->peak;
+        else
+            arena_ptr->buffer = NULL;
+    }
+    arena_ptr->used = 0;
+    arena_ptr->peak = 0;
+}
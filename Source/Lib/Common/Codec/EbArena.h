@@ -0,0 +1,68 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbArena_h
+#define EbArena_h
+
+#include "EbDefinitions.h"
+#include "EbObject.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+     * Arena
+     *   Bump allocator for the transient buffers of one thread. The
+     *   buffers of a task are carved out of a single block and all freed
+     *   at once by svt_arena_reset() at the start of the next task.
+     *   When the block runs out, the allocations go to overflow blocks of
+     *   the heap, and the next reset grows the block to the high-water
+     *   mark, so that once every task size has been seen an arena does
+     *   not touch the heap anymore. An arena is not thread safe.
+     *********************************************************************/
+typedef struct EbArenaBlock {
+    struct EbArenaBlock *next;
+} EbArenaBlock;
+
+typedef struct EbArena {
+    EbDctor       dctor;
+    uint8_t *     buffer;
+    size_t        size; // bytes of buffer
+    size_t        used; // bytes of buffer handed out since the last reset
+    size_t        peak; // bytes handed out since the last reset, overflow included
+    EbArenaBlock *overflow; // heap blocks of the allocations that missed buffer
+} EbArena;
+
+/*********************************************************************
+     * svt_arena_ctor
+     *   Creates an arena whose block holds size bytes, 0 to let the first
+     *   reset size it.
+     *********************************************************************/
+extern EbErrorType svt_arena_ctor(EbArena *arena_ptr, size_t size);
+
+/*********************************************************************
+     * svt_arena_alloc
+     *   Returns size bytes aligned on ALVALUE, valid until the next reset,
+     *   NULL when the heap is out of memory.
+     *********************************************************************/
+extern void *svt_arena_alloc(EbArena *arena_ptr, size_t size);
+
+/*********************************************************************
+     * svt_arena_reset
+     *   Frees every allocation of the arena at once.
+     *********************************************************************/
+extern void svt_arena_reset(EbArena *arena_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbArena_h
@@ -16,6 +16,7 @@
 #include "EbDefinitions.h"
 #include "EbUtility.h"
 #include "EbLog.h"
+#include "common_dsp_rtcd.h"
 
 #if OD_MEASURE_EC_OVERHEAD
 #include <stdio.h>
@@ -108,8 +109,19 @@ month=Jul,
 URL="http://researchcommons.waikato.ac.nz/Bitstream/handle/10289/78/content.pdf"
 }*/
 
+/*Adds the carry out of the bytes written from low to the ones before them.
+buf: The output buffer.
+offs: The offset of the last byte before the carry.*/
+static void od_ec_enc_propagate_carry(uint8_t *buf, uint32_t offs) {
+    unsigned sum;
+    do {
+        sum         = buf[offs] + 1;
+        buf[offs--] = (uint8_t)sum;
+    } while (sum >> 8);
+}
+
 /*Takes updated low and range values, renormalizes them so that
-32768 <= rng < 65536 (flushing bytes from low to the pre-carry buffer if
+32768 <= rng < 65536 (flushing bytes from low to the output buffer if
 necessary), and stores them back in the encoder context.
 low: The new value of low.
 rng: The new value of the range.*/
@@ -121,44 +133,44 @@ static void od_ec_enc_normalize(OdEcEnc *enc, OdEcWindow low, unsigned rng) {
     assert(rng <= 65535U);
     d = 16 - OD_ILOG_NZ(rng);
     s = c + d;
-    /*TODO: Right now we flush every time we have at least one byte available.
-    Instead we should use an OdEcWindow and flush right before we're about to
-    shift bits off the end of the window.
-    For a 32-bit window this is about the same amount of work, but for a 64-bit
-    window it should be a fair win.*/
-    if (s >= 0) {
-        uint16_t *buf;
-        uint32_t  storage;
-        uint32_t  offs;
-        unsigned  m;
-        buf     = enc->precarry_buf;
-        storage = enc->precarry_storage;
+    /*Bytes are flushed once low has 40 bits of them, which leaves room in the
+    64 bit window for the carry and the at most 15 bits of the next symbol.*/
+    if (s >= 40) {
+        uint8_t *  buf;
+        uint32_t   storage;
+        uint32_t   offs;
+        OdEcWindow out;
+        int32_t    nbytes;
+        int32_t    i;
+        buf     = enc->buf;
+        storage = enc->storage;
         offs    = enc->offs;
-        if (offs + 2 > storage) {
-            storage = 2 * storage + 2;
-            buf     = realloc(enc->precarry_buf, sizeof(*buf) * storage);
+        /*cnt is 9 bits behind the bytes ready, so it counts one byte less.*/
+        nbytes = (s >> 3) + 1;
+        if (offs + nbytes > storage) {
+            storage = 2 * storage + nbytes;
+            buf     = realloc(enc->buf, sizeof(*buf) * storage);
             if (!buf) {
                 enc->error = -1;
                 enc->offs  = 0;
                 return;
             }
-            enc->precarry_buf     = buf;
-            enc->precarry_storage = storage;
+            enc->buf     = buf;
+            enc->storage = storage;
         }
-        c += 16;
-        m = (1 << c) - 1;
-        if (s >= 8) {
-            assert(offs < storage);
-            buf[offs++] = (uint16_t)(low >> c);
-            low &= m;
-            c -= 8;
-            m >>= 8;
+        c += 24 - (nbytes << 3);
+        out = low >> c;
+        low &= ((OdEcWindow)1 << c) - 1;
+        for (i = nbytes - 1; i >= 0; i--) {
+            buf[offs + i] = (uint8_t)out;
+            out >>= 8;
+        }
+        if (out) {
+            assert(offs > 0);
+            od_ec_enc_propagate_carry(buf, offs - 1);
         }
-        assert(offs < storage);
-        buf[offs++] = (uint16_t)(low >> c);
-        s           = c + d - 24;
-        low &= m;
-        enc->offs = offs;
+        enc->offs = offs + nbytes;
+        s         = c + d - 24;
     }
     enc->low = low << d;
     enc->rng = (int16_t)(rng << d);
@@ -175,12 +187,6 @@ void svt_od_ec_enc_init(OdEcEnc *enc, uint32_t size) {
         enc->storage = 0;
         enc->error   = -1;
     }
-    enc->precarry_buf     = (uint16_t *)malloc(sizeof(*enc->precarry_buf) * size);
-    enc->precarry_storage = size;
-    if (size > 0 && enc->precarry_buf == NULL) {
-        enc->precarry_storage = 0;
-        enc->error            = -1;
-    }
 }
 
 /*Reinitializes the encoder.*/
@@ -200,7 +206,6 @@ void svt_od_ec_enc_reset(OdEcEnc *enc) {
 
 /*Frees the buffers used by the encoder.*/
 void svt_od_ec_enc_clear(OdEcEnc *enc) {
-    free(enc->precarry_buf);
     free(enc->buf);
 }
 
@@ -284,7 +289,6 @@ void svt_od_ec_encode_cdf_q15(OdEcEnc *enc, int32_t s, const uint16_t *icdf, int
 uint8_t *svt_od_ec_enc_done(OdEcEnc *enc, uint32_t *nbytes) {
     uint8_t *  out;
     uint32_t   storage;
-    uint16_t * buf;
     uint32_t   offs;
     OdEcWindow m;
     OdEcWindow e;
@@ -311,37 +315,12 @@ uint8_t *svt_od_ec_enc_done(OdEcEnc *enc, uint32_t *nbytes) {
     e = ((l + m) & ~m) | (m + 1);
     s += c;
     offs = enc->offs;
-    buf  = enc->precarry_buf;
-    if (s > 0) {
-        unsigned n;
-        storage = enc->precarry_storage;
-        if (offs + ((s + 7) >> 3) > storage) {
-            storage = storage * 2 + ((s + 7) >> 3);
-            buf     = realloc(enc->precarry_buf, sizeof(*buf) * storage);
-            if (!buf) {
-                enc->error = -1;
-                return NULL;
-            }
-            enc->precarry_buf     = buf;
-            enc->precarry_storage = storage;
-        }
-        n = (1 << (c + 16)) - 1;
-        do {
-            assert(offs < storage);
-            buf[offs++] = (uint16_t)(e >> (c + 16));
-            e &= n;
-            s -= 8;
-            c -= 8;
-            n >>= 8;
-        } while (s > 0);
-    }
     /*Make sure there's enough room for the entropy-coded bits.*/
     out     = enc->buf;
     storage = enc->storage;
-    c       = OD_MAXI((s + 7) >> 3, 0);
-    if (offs + c > storage) {
-        storage = offs + c;
-        out     = realloc(enc->buf, sizeof(*buf) * storage);
+    if (offs + OD_MAXI((s + 7) >> 3, 0) > storage) {
+        storage = offs + OD_MAXI((s + 7) >> 3, 0);
+        out     = realloc(enc->buf, sizeof(*out) * storage);
         if (!out) {
             enc->error = -1;
             return NULL;
@@ -349,23 +328,27 @@ uint8_t *svt_od_ec_enc_done(OdEcEnc *enc, uint32_t *nbytes) {
         enc->buf     = out;
         enc->storage = storage;
     }
-    *nbytes = offs;
-    /*Perform carry propagation.*/
-    assert(offs <= storage);
-    out = out + storage - offs;
-    c   = 0;
-    while (offs > 0) {
-        offs--;
-        c         = buf[offs] + c;
-        out[offs] = (uint8_t)c;
-        c >>= 8;
+    if (s > 0) {
+        OdEcWindow n;
+        n = ((OdEcWindow)1 << (c + 16)) - 1;
+        do {
+            const unsigned val = (unsigned)(e >> (c + 16));
+            assert(offs < storage);
+            out[offs] = (uint8_t)val;
+            if (val & 0x100) {
+                assert(offs > 0);
+                od_ec_enc_propagate_carry(out, offs - 1);
+            }
+            offs++;
+            e &= n;
+            s -= 8;
+            c -= 8;
+            n >>= 8;
+        } while (s > 0);
     }
-    /*Note: Unless there's an allocation error, if you keep encoding into the
-    current buffer and call this function again later, everything will work
-    just fine (you won't get a new packet out, but you will get a single
-    buffer with the new data appended to the old).
-    However, this function is O(N) where N is the amount of data coded so far,
-    so calling it more than once for a given packet is a bad idea.*/
+    *nbytes = offs;
+    /*Note: the carry of the final bits may change the bytes already written,
+    so no more symbols can be encoded after this call.*/
     return out;
 }
 
@@ -383,6 +366,27 @@ int32_t svt_od_ec_enc_tell(const OdEcEnc *enc) {
     bit, which we reserve for terminating the stream.*/
     return (enc->cnt + 10) + enc->offs * 8;
 }
+
+/*Finds the symbol coded by the top 16 bits c of the decoder window in an
+   inverse CDF of nsyms symbols, for a range of r.
+  The bounds of the symbols decrease with their index, so the symbol is the
+   number of bounds above c, which needs no early exit.
+  Return: The decoded symbol.*/
+int32_t svt_od_ec_search_cdf_c(const uint16_t *icdf, int32_t nsyms, uint32_t c, uint32_t r) {
+    const int32_t n   = nsyms - 1;
+    int32_t       ret = 0;
+    for (int32_t i = 0; i < n; i++) {
+        const uint32_t v = ((r >> 8) * (uint32_t)(icdf[i] >> EC_PROB_SHIFT) >>
+                            (7 - EC_PROB_SHIFT - CDF_SHIFT)) +
+            EC_MIN_PROB * (n - i);
+        ret += c < v;
+    }
+    return ret;
+}
+
+void svt_av1_update_cdf_c(uint16_t *cdf, int32_t val, int32_t nsymbs) {
+    update_cdf(cdf, val, nsymbs);
+}
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
@@ -51,6 +51,7 @@ extern EbErrorType output_bitstream_reset(OutputBitstreamUnit *bitstream_ptr);
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
 #include "EbCabacContextModel.h"
+#include "common_dsp_rtcd.h"
 /********************************************************************************************************************************/
 // bitops.h
 // These versions of get_msb() are only valid when n != 0 because all
@@ -159,9 +160,9 @@ The 0* term provides compile-time type checking */
 #define EC_PROB_SHIFT 6
 #define EC_MIN_PROB 4 // must be <= (1<<EC_PROB_SHIFT)/16
 
-/*OPT: OdEcWindow must be at least 32 bits, but if you have fast arithmetic
-on a larger type, you can speed up the decoder by using it here.*/
-typedef uint32_t OdEcWindow;
+/*The encoder keeps 40 bits of low before flushing them, 6 or 7 bytes at a
+time instead of 1 or 2, so its window is 64 bits.*/
+typedef uint64_t OdEcWindow;
 
 #define OD_EC_WINDOW_SIZE ((int32_t)sizeof(OdEcWindow) * CHAR_BIT)
 
@@ -180,17 +181,11 @@ typedef struct OdEcEnc OdEcEnc;
 /*The entropy encoder context.*/
 struct OdEcEnc {
     /*Buffered output.
-        This contains only the raw bits until the final call to svt_od_ec_enc_done(),
-        where all the arithmetic-coded data gets prepended to it.*/
+        The bytes flushed from low are written here directly, a carry out of
+        low is propagated back into the bytes already written.*/
     uint8_t *buf;
     /*The size of the buffer.*/
     uint32_t storage;
-    /*The offset at which the last byte containing raw bits was written.*/
-
-    /*A buffer for output bytes with their associated carry flags.*/
-    uint16_t *precarry_buf;
-    /*The size of the pre-carry buffer.*/
-    uint32_t precarry_storage;
     /*The offset at which the next entropy-coded byte will be written.*/
     uint32_t offs;
     /*The low end of the current range.*/
@@ -224,6 +219,10 @@ OD_WARN_UNUSED_RESULT uint8_t *svt_od_ec_enc_done(OdEcEnc *enc, uint32_t *nbytes
 
 OD_WARN_UNUSED_RESULT int32_t svt_od_ec_enc_tell(const OdEcEnc *enc) OD_ARG_NONNULL(1);
 
+/*Symbols of alphabets larger than this are adapted by the svt_av1_update_cdf
+kernel, the smaller ones are faster inline than through a call.*/
+#define OD_EC_ENC_INLINE_NSYMS 4
+
 /********************************************************************************************************************************/
 //daalaboolwriter.h
 struct DaalaWriter {
@@ -286,8 +285,12 @@ static INLINE void aom_write_cdf(AomWriter *w, int32_t symb, const AomCdfProb *c
 
 static INLINE void aom_write_symbol(AomWriter *w, int32_t symb, AomCdfProb *cdf, int32_t nsymbs) {
     aom_write_cdf(w, symb, cdf, nsymbs);
-    if (w->allow_update_cdf)
-        update_cdf(cdf, symb, nsymbs);
+    if (w->allow_update_cdf) {
+        if (nsymbs > OD_EC_ENC_INLINE_NSYMS)
+            svt_av1_update_cdf(cdf, symb, nsymbs);
+        else
+            update_cdf(cdf, symb, nsymbs);
+    }
 }
 
 /********************************************************************************************************************************/
@@ -391,6 +391,21 @@ typedef struct ConvolveParams {
     int32_t      use_dist_wtd_comp_avg;
 } ConvolveParams;
 
+// Film grain noise scaling of one plane, see svt_av1_add_noise_luma()
+typedef struct FgnPlaneParams {
+    const int32_t *scaling_lut; // 256 entries, interpolated above 8 bits
+    int32_t        scaling_shift;
+    int32_t        min_value;
+    int32_t        max_value;
+    int32_t        bit_depth;
+    // chroma only: the scaling function input mixes the co-located luma
+    int32_t mult;
+    int32_t luma_mult;
+    int32_t offset;
+    int32_t subsamp_x;
+    int32_t subsamp_y;
+} FgnPlaneParams;
+
 // texture component type
 typedef enum ATTRIBUTE_PACKED {
     COMPONENT_LUMA      = 0, // luma
@@ -3562,3 +3562,29 @@ void invert_quant(int16_t *quant, int16_t *shift, int32_t d) {
     *quant = (int16_t)(m - (1 << 16));
     *shift = 1 << (16 - l);
 }
+
+/* Dequantizes the n_coeffs levels of a transform block, read in scan order,
+   and scatters the non-zero coefficients at their position in qcoeffs.
+   dequant holds the DC and AC quantizers and iqmatrix, if not NULL, the
+   inverse quantization matrix of the block. */
+void svt_av1_dequant_scatter_c(const int32_t *level, int32_t n_coeffs, const int16_t *scan,
+                               const int16_t *dequant, const QmVal *iqmatrix, int32_t shift,
+                               int32_t bit_depth, int32_t *qcoeffs) {
+    const int32_t max_value = (1 << (7 + bit_depth)) - 1;
+    const int32_t min_value = -(1 << (7 + bit_depth));
+
+    for (int32_t i = 0; i < n_coeffs; i++) {
+        const int32_t lev = level[i];
+        if (lev == 0)
+            continue;
+        const int32_t pos = scan[i];
+        int32_t       dqv = dequant[i != 0];
+        if (iqmatrix != NULL)
+            dqv = ((iqmatrix[pos] * dqv) + (1 << (AOM_QM_BITS - 1))) >> AOM_QM_BITS;
+        TranLow q_coeff = (TranLow)((int64_t)abs(lev) * dqv & 0xffffff);
+        q_coeff         = q_coeff >> shift;
+        if (lev < 0)
+            q_coeff = -q_coeff;
+        qcoeffs[pos] = clamp(q_coeff, min_value, max_value);
+    }
+}
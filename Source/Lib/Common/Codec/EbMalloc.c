@@ -10,6 +10,7 @@
 */
 #include <stdint.h>
 #include <limits.h>
+#include <string.h>
 
 #include "EbMalloc.h"
 #include "EbThreads.h"
@@ -20,6 +21,40 @@ void svt_print_alloc_fail(const char* file, int line) {
     SVT_FATAL("allocate memory failed, at %s, L%d\n", file, line);
 }
 
+#ifdef _WIN32
+#define EB_THREAD_LOCAL __declspec(thread)
+#else
+#define EB_THREAD_LOCAL __thread
+#endif
+
+static EB_THREAD_LOCAL size_t g_thread_alloc_bytes;
+static EB_THREAD_LOCAL EbBool g_thread_eager_commit;
+
+size_t svt_thread_alloc_bytes(void) { return g_thread_alloc_bytes; }
+
+void svt_add_thread_alloc_bytes(size_t size) { g_thread_alloc_bytes += size; }
+
+void svt_set_thread_eager_commit(EbBool eager) { g_thread_eager_commit = eager; }
+
+void* svt_calloc_aligned_lazy(size_t size) {
+    // calloc gets fresh zero pages from the system for large blocks instead
+    // of clearing them, the raw pointer is kept right before the aligned one
+    uint8_t* raw = (uint8_t*)calloc(1, size + ALVALUE + sizeof(void*));
+    uint8_t* p;
+    if (!raw)
+        return NULL;
+    p = (uint8_t*)(((uintptr_t)raw + sizeof(void*) + ALVALUE - 1) & ~(uintptr_t)(ALVALUE - 1));
+    ((void**)p)[-1] = raw;
+    if (g_thread_eager_commit)
+        memset(p, 0, size);
+    return p;
+}
+
+void svt_free_aligned_lazy(void* p) {
+    if (p)
+        free(((void**)p)[-1]);
+}
+
 #ifdef DEBUG_MEMORY_USAGE
 
 static EbHandle g_malloc_mutex;
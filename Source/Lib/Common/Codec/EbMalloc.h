@@ -22,6 +22,21 @@
 
 void svt_print_alloc_fail(const char* file, int line);
 
+/* Bytes allocated by the calling thread through the macros of this file, frees
+ * not deducted. The difference of two reads gives the footprint of what was
+ * constructed in between. */
+size_t svt_thread_alloc_bytes(void);
+void   svt_add_thread_alloc_bytes(size_t size);
+
+/* Zeroed ALVALUE aligned block whose pages are only committed when first
+ * touched, for the large planes of which only a part may ever be used.
+ * While eager commit is set on the calling thread the pages are touched at
+ * once instead, so they are placed by the memory policy in effect for the
+ * allocation rather than by whichever thread writes them first. */
+void* svt_calloc_aligned_lazy(size_t size);
+void  svt_free_aligned_lazy(void* p);
+void  svt_set_thread_eager_commit(EbBool eager);
+
 #ifdef DEBUG_MEMORY_USAGE
 void svt_print_memory_usage(void);
 void svt_increase_component_count(void);
@@ -56,8 +71,10 @@ void svt_remove_mem_entry(void* ptr, EbPtrType type);
     do {                                              \
         if (!p)                                       \
             svt_print_alloc_fail(__FILE__, __LINE__); \
-        else                                          \
+        else {                                        \
+            svt_add_thread_alloc_bytes(size);         \
             EB_ADD_MEM_ENTRY(p, type, size);          \
+        }                                             \
     } while (0)
 
 #define EB_CHECK_MEM(p)                           \
@@ -194,4 +211,17 @@ void svt_remove_mem_entry(void* ptr, EbPtrType type);
 
 #define EB_FREE_ALIGNED_ARRAY(pa) EB_FREE_ALIGNED(pa)
 
+#define EB_CALLOC_ALIGNED_LAZY_ARRAY(pa, count)                 \
+    do {                                                        \
+        pa = svt_calloc_aligned_lazy(sizeof(*(pa)) * (count));  \
+        EB_ADD_MEM(pa, sizeof(*(pa)) * (count), EB_A_PTR);      \
+    } while (0)
+
+#define EB_FREE_ALIGNED_LAZY_ARRAY(pa)     \
+    do {                                   \
+        EB_REMOVE_MEM_ENTRY(pa, EB_A_PTR); \
+        svt_free_aligned_lazy(pa);         \
+        pa = NULL;                         \
+    } while (0)
+
 #endif //EbMalloc_h
@@ -0,0 +1,242 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#if defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbNuma.h"
+
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+
+// Memory policy modes of set_mempolicy(2), see <numaif.h>
+#define EB_MPOL_DEFAULT 0
+#define EB_MPOL_PREFERRED 1
+#define EB_MPOL_INTERLEAVE 3
+
+/*********************************************************************
+ * svt_numa_read_list
+ *   Reads a sysfs list file such as "0-3,8-11" into set.
+ *********************************************************************/
+static EbBool svt_numa_read_list(const char *path, cpu_set_t *set) {
+    char  line[4096];
+    FILE *fin = fopen(path, "r");
+
+    CPU_ZERO(set);
+    if (!fin)
+        return EB_FALSE;
+    if (!fgets(line, sizeof(line), fin)) {
+        fclose(fin);
+        return EB_FALSE;
+    }
+    fclose(fin);
+
+    const char *str = line;
+    while (*str >= '0' && *str <= '9') {
+        char *end;
+        long  first = strtol(str, &end, 10);
+        long  last  = first;
+        if (*end == '-')
+            last = strtol(end + 1, &end, 10);
+        for (long i = first; i <= last && i < CPU_SETSIZE; i++) CPU_SET(i, set);
+        str = *end == ',' ? end + 1 : end;
+    }
+    return EB_TRUE;
+}
+
+static EbBool svt_numa_node_cpus(uint32_t node, cpu_set_t *set) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+    return svt_numa_read_list(path, set) && CPU_COUNT(set);
+}
+
+// Online nodes; the node topology does not change while the process runs
+static const cpu_set_t *svt_numa_online_nodes(void) {
+    static cpu_set_t online;
+    static EbBool    online_read = EB_FALSE;
+
+    if (!online_read) {
+        if (!svt_numa_read_list("/sys/devices/system/node/online", &online)) {
+            CPU_ZERO(&online);
+            CPU_SET(0, &online);
+        }
+        online_read = EB_TRUE;
+    }
+    return &online;
+}
+
+uint32_t svt_numa_node_count(void) {
+    static int32_t node_count = -1;
+
+    if (node_count < 0) {
+        const cpu_set_t *online = svt_numa_online_nodes();
+        int32_t          count  = 1;
+        for (int32_t i = 0; i < EB_NUMA_MAX_NODES; i++)
+            if (CPU_ISSET(i, online))
+                count = i + 1;
+        node_count = count;
+    }
+    return (uint32_t)node_count;
+}
+
+EbBool svt_numa_node_online(uint32_t node) {
+    return node < EB_NUMA_MAX_NODES && CPU_ISSET(node, svt_numa_online_nodes());
+}
+
+uint32_t svt_numa_node_of_cpu(uint32_t cpu_index) {
+    const uint32_t node_count = svt_numa_node_count();
+    cpu_set_t      set;
+
+    if (node_count <= 1)
+        return 0;
+    for (uint32_t node = 0; node < node_count; node++)
+        if (svt_numa_node_online(node) && svt_numa_node_cpus(node, &set) &&
+            CPU_ISSET(cpu_index, &set))
+            return node;
+    return 0;
+}
+
+void svt_numa_bind_thread(EbHandle thread_handle, uint32_t node, const void *affinity_ptr) {
+    cpu_set_t node_set;
+
+    if (!thread_handle || svt_numa_node_count() <= 1 || !svt_numa_node_cpus(node, &node_set))
+        return;
+    if (affinity_ptr) {
+        cpu_set_t both;
+        CPU_AND(&both, &node_set, (const cpu_set_t *)affinity_ptr);
+        if (CPU_COUNT(&both))
+            node_set = both;
+    }
+    pthread_setaffinity_np(*((pthread_t *)thread_handle), sizeof(cpu_set_t), &node_set);
+}
+
+static void svt_numa_set_policy(int mode, const unsigned long *mask_ptr) {
+    // maxnode counts one past the last bit of the mask
+    syscall(SYS_set_mempolicy, mode, mask_ptr, mask_ptr ? EB_NUMA_MAX_NODES + 1 : 0);
+}
+
+void svt_numa_prefer_node(uint32_t node) {
+    unsigned long mask[EB_NUMA_MASK_WORDS] = {0};
+
+    if (svt_numa_node_count() <= 1 || node >= EB_NUMA_MAX_NODES)
+        return;
+    mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    svt_numa_set_policy(EB_MPOL_PREFERRED, mask);
+}
+
+void svt_numa_interleave(const uint32_t *node_array, uint32_t node_count) {
+    unsigned long mask[EB_NUMA_MASK_WORDS] = {0};
+    uint32_t      mask_count               = 0;
+
+    if (svt_numa_node_count() <= 1)
+        return;
+    for (uint32_t i = 0; i < node_count; i++) {
+        const uint32_t node = node_array[i];
+        if (!svt_numa_node_online(node))
+            continue;
+        mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        mask_count++;
+    }
+    if (mask_count)
+        svt_numa_set_policy(EB_MPOL_INTERLEAVE, mask);
+}
+
+void svt_numa_save_policy(EbNumaPolicy *policy_ptr) {
+    int mode = EB_MPOL_DEFAULT;
+
+    memset(policy_ptr, 0, sizeof(*policy_ptr));
+    if (svt_numa_node_count() <= 1)
+        return;
+    policy_ptr->valid = syscall(SYS_get_mempolicy,
+                                &mode,
+                                policy_ptr->mask,
+                                (unsigned long)EB_NUMA_MAX_NODES,
+                                NULL,
+                                0UL) == 0;
+    policy_ptr->mode = mode;
+}
+
+void svt_numa_restore_policy(const EbNumaPolicy *policy_ptr) {
+    if (svt_numa_node_count() <= 1)
+        return;
+    if (policy_ptr->valid)
+        svt_numa_set_policy(policy_ptr->mode, policy_ptr->mask);
+    else
+        svt_numa_set_policy(EB_MPOL_DEFAULT, NULL);
+}
+
+void svt_numa_get_stats(EbNumaStats *stats_ptr) {
+    const uint32_t node_count = svt_numa_node_count();
+
+    stats_ptr->local_pages  = 0;
+    stats_ptr->remote_pages = 0;
+    for (uint32_t node = 0; node < node_count; node++) {
+        char  line[128];
+        FILE *fin;
+        if (!svt_numa_node_online(node))
+            continue;
+        snprintf(line, sizeof(line), "/sys/devices/system/node/node%u/numastat", node);
+        fin = fopen(line, "r");
+        if (!fin)
+            continue;
+        while (fgets(line, sizeof(line), fin)) {
+            if (strncmp(line, "local_node ", 11) == 0)
+                stats_ptr->local_pages += strtoull(line + 11, NULL, 10);
+            else if (strncmp(line, "other_node ", 11) == 0)
+                stats_ptr->remote_pages += strtoull(line + 11, NULL, 10);
+        }
+        fclose(fin);
+    }
+}
+
+#else
+
+uint32_t svt_numa_node_count(void) { return 1; }
+
+uint32_t svt_numa_node_of_cpu(uint32_t cpu_index) {
+    UNUSED(cpu_index);
+    return 0;
+}
+
+void svt_numa_bind_thread(EbHandle thread_handle, uint32_t node, const void *affinity_ptr) {
+    UNUSED(thread_handle);
+    UNUSED(node);
+    UNUSED(affinity_ptr);
+}
+
+void svt_numa_prefer_node(uint32_t node) { UNUSED(node); }
+
+EbBool svt_numa_node_online(uint32_t node) { return node == 0; }
+
+void svt_numa_interleave(const uint32_t *node_array, uint32_t node_count) {
+    UNUSED(node_array);
+    UNUSED(node_count);
+}
+
+void svt_numa_save_policy(EbNumaPolicy *policy_ptr) { memset(policy_ptr, 0, sizeof(*policy_ptr)); }
+
+void svt_numa_restore_policy(const EbNumaPolicy *policy_ptr) { UNUSED(policy_ptr); }
+
+void svt_numa_get_stats(EbNumaStats *stats_ptr) {
+    stats_ptr->local_pages  = 0;
+    stats_ptr->remote_pages = 0;
+}
+
+#endif
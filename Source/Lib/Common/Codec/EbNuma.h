@@ -0,0 +1,91 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbNuma_h
+#define EbNuma_h
+
+#include "EbDefinitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EB_NUMA_MAX_NODES 64
+#define EB_NUMA_MASK_WORDS (EB_NUMA_MAX_NODES / (8 * sizeof(unsigned long)))
+
+/*********************************************************************
+     * NUMA Statistics
+     *   Page allocation counters summed over every node, as reported by
+     *   the kernel in /sys/devices/system/node/node<N>/numastat. They are
+     *   system wide, so only the difference between two snapshots taken
+     *   around an encode is meaningful.
+     *********************************************************************/
+typedef struct EbNumaStats {
+    uint64_t local_pages; // pages allocated on the node of the allocating cpu
+    uint64_t remote_pages; // pages allocated on another node
+} EbNumaStats;
+
+/*********************************************************************
+     * svt_numa_node_count
+     *   One past the highest online NUMA node; 1 when the platform does
+     *   not expose them, in which case every other call below is a no-op.
+     *   Nodes below it can be offline, see svt_numa_node_online().
+     *********************************************************************/
+extern uint32_t svt_numa_node_count(void);
+extern EbBool   svt_numa_node_online(uint32_t node);
+
+/*********************************************************************
+     * svt_numa_node_of_cpu
+     *   Node owning the logical processor cpu_index, 0 when unknown.
+     *********************************************************************/
+extern uint32_t svt_numa_node_of_cpu(uint32_t cpu_index);
+
+/*********************************************************************
+     * svt_numa_bind_thread
+     *   Restricts thread_handle to the cpus of node. When affinity_ptr
+     *   (a cpu_set_t on Linux) is not NULL and shares cpus with the node,
+     *   the thread is restricted to that intersection instead.
+     *********************************************************************/
+extern void svt_numa_bind_thread(EbHandle thread_handle, uint32_t node, const void *affinity_ptr);
+
+/*********************************************************************
+     * NUMA Policy
+     *   A memory policy saved by svt_numa_save_policy(). valid is false
+     *   when the kernel did not report it.
+     *********************************************************************/
+typedef struct EbNumaPolicy {
+    EbBool        valid;
+    int32_t       mode; // MPOL_* mode and flags of get_mempolicy(2)
+    unsigned long mask[EB_NUMA_MASK_WORDS];
+} EbNumaPolicy;
+
+/*********************************************************************
+     * Memory policy of the calling thread
+     *   The policy decides on which node the pages first touched by the
+     *   calling thread are placed; pages touched earlier do not move.
+     *   svt_numa_prefer_node() places them on node while it has free
+     *   memory and svt_numa_interleave() spreads them round-robin over
+     *   the online nodes of node_array. Callers changing the policy of a thread they do not
+     *   own save it first with svt_numa_save_policy() and hand it back
+     *   with svt_numa_restore_policy(), which falls back to first-touch
+     *   placement when the policy could not be saved.
+     *********************************************************************/
+extern void svt_numa_prefer_node(uint32_t node);
+extern void svt_numa_interleave(const uint32_t *node_array, uint32_t node_count);
+extern void svt_numa_save_policy(EbNumaPolicy *policy_ptr);
+extern void svt_numa_restore_policy(const EbNumaPolicy *policy_ptr);
+
+extern void svt_numa_get_stats(EbNumaStats *stats_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbNuma_h
@@ -17,16 +17,16 @@
 static void svt_picture_buffer_desc_dctor(EbPtr p) {
     EbPictureBufferDesc *obj = (EbPictureBufferDesc *)p;
     if (obj->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG) {
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_y);
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_bit_inc_y);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_y);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_bit_inc_y);
     }
     if (obj->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG) {
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_cb);
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_bit_inc_cb);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_cb);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_bit_inc_cb);
     }
     if (obj->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG) {
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_cr);
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_bit_inc_cr);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_cr);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_bit_inc_cr);
     }
 }
 
@@ -91,32 +91,32 @@ EbErrorType svt_picture_buffer_desc_ctor(EbPictureBufferDesc *pictureBufferDescP
 
     // Allocate the Picture Buffers (luma & chroma)
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG) {
-        EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_y,
-                                pictureBufferDescPtr->luma_size * bytes_per_pixel);
+        EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_y,
+                                     pictureBufferDescPtr->luma_size * bytes_per_pixel);
         pictureBufferDescPtr->buffer_bit_inc_y = 0;
         if (picture_buffer_desc_init_data_ptr->split_mode == EB_TRUE) {
-            EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_bit_inc_y,
-                                    pictureBufferDescPtr->luma_size * bytes_per_pixel);
+            EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_bit_inc_y,
+                                         pictureBufferDescPtr->luma_size * bytes_per_pixel);
         }
     }
 
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG) {
-        EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_cb,
-                                pictureBufferDescPtr->chroma_size * bytes_per_pixel);
+        EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_cb,
+                                     pictureBufferDescPtr->chroma_size * bytes_per_pixel);
         pictureBufferDescPtr->buffer_bit_inc_cb = 0;
         if (picture_buffer_desc_init_data_ptr->split_mode == EB_TRUE) {
-            EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_bit_inc_cb,
-                                    pictureBufferDescPtr->chroma_size * bytes_per_pixel);
+            EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_bit_inc_cb,
+                                         pictureBufferDescPtr->chroma_size * bytes_per_pixel);
         }
     }
 
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cr_FLAG) {
-        EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_cr,
-                                pictureBufferDescPtr->chroma_size * bytes_per_pixel);
+        EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_cr,
+                                     pictureBufferDescPtr->chroma_size * bytes_per_pixel);
         pictureBufferDescPtr->buffer_bit_inc_cr = 0;
         if (picture_buffer_desc_init_data_ptr->split_mode == EB_TRUE) {
-            EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_bit_inc_cr,
-                                    pictureBufferDescPtr->chroma_size * bytes_per_pixel);
+            EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_bit_inc_cr,
+                                         pictureBufferDescPtr->chroma_size * bytes_per_pixel);
         }
     }
 
@@ -126,11 +126,11 @@ EbErrorType svt_picture_buffer_desc_ctor(EbPictureBufferDesc *pictureBufferDescP
 static void svt_recon_picture_buffer_desc_dctor(EbPtr p) {
     EbPictureBufferDesc *obj = (EbPictureBufferDesc *)p;
     if (obj->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG)
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_y);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_y);
     if (obj->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG)
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_cb);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_cb);
     if (obj->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG)
-        EB_FREE_ALIGNED_ARRAY(obj->buffer_cr);
+        EB_FREE_ALIGNED_LAZY_ARRAY(obj->buffer_cr);
 }
 /*****************************************
  * svt_recon_picture_buffer_desc_ctor
@@ -178,16 +178,16 @@ EbErrorType svt_recon_picture_buffer_desc_ctor(EbPictureBufferDesc *pictureBuffe
 
     // Allocate the Picture Buffers (luma & chroma)
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG) {
-        EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_y,
-                                pictureBufferDescPtr->luma_size * bytes_per_pixel);
+        EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_y,
+                                     pictureBufferDescPtr->luma_size * bytes_per_pixel);
     }
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG) {
-        EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_cb,
-                                pictureBufferDescPtr->chroma_size * bytes_per_pixel);
+        EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_cb,
+                                     pictureBufferDescPtr->chroma_size * bytes_per_pixel);
     }
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cr_FLAG) {
-        EB_CALLOC_ALIGNED_ARRAY(pictureBufferDescPtr->buffer_cr,
-                                pictureBufferDescPtr->chroma_size * bytes_per_pixel);
+        EB_CALLOC_ALIGNED_LAZY_ARRAY(pictureBufferDescPtr->buffer_cr,
+                                     pictureBufferDescPtr->chroma_size * bytes_per_pixel);
     }
     return EB_ErrorNone;
 }
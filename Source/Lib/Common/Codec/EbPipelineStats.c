@@ -0,0 +1,255 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(__USE_POSIX199309)
+#define __USE_POSIX199309
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+#include "EbPipelineStats.h"
+#include "EbThreads.h"
+
+// Upper bounds of the formatted trace records
+#define TRACE_HEADER_SIZE 64
+#define TRACE_THREAD_SIZE 160
+#define TRACE_EVENT_SIZE 512
+#define TRACE_FLOW_SIZE 80
+
+// Trace thread ids of stage i start at (i + 1) * TRACE_STAGE_TID_STRIDE, one per
+// stage thread index, i.e. per consumer fifo, fiber or pool context
+#define TRACE_STAGE_TID_STRIDE 1000
+
+uint64_t svt_pipeline_stats_time(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER        counter;
+    if (!frequency.QuadPart)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart * 1000000 +
+                      counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+#else
+    struct timespec curr_time;
+    clock_gettime(CLOCK_MONOTONIC, &curr_time);
+    return (uint64_t)curr_time.tv_sec * 1000000 + (uint64_t)curr_time.tv_nsec / 1000;
+#endif
+}
+
+static void svt_stage_stats_dctor(EbPtr p) {
+    EbStageStats *obj = (EbStageStats *)p;
+    EB_FREE_ARRAY(obj->busy_start_time);
+    EB_FREE_ARRAY(obj->busy_post_time);
+    EB_FREE_ARRAY(obj->busy_picture_number);
+    EB_FREE_ARRAY(obj->busy_queue_depth);
+    EB_FREE_ARRAY(obj->busy_time);
+    EB_FREE_ARRAY(obj->event_array);
+    EB_DESTROY_MUTEX(obj->lockout_mutex);
+}
+
+static EbErrorType svt_stage_stats_ctor(EbStageStats *stage_ptr, const char *name,
+                                        uint64_t origin_time, uint32_t thread_count,
+                                        EbStagePictureFn picture_fn) {
+    stage_ptr->dctor        = svt_stage_stats_dctor;
+    stage_ptr->name         = name;
+    stage_ptr->origin_time  = origin_time;
+    stage_ptr->thread_count = thread_count;
+    stage_ptr->picture_fn   = picture_fn;
+    EB_CALLOC_ARRAY(stage_ptr->busy_start_time, thread_count);
+    EB_CALLOC_ARRAY(stage_ptr->busy_post_time, thread_count);
+    EB_CALLOC_ARRAY(stage_ptr->busy_picture_number, thread_count);
+    EB_CALLOC_ARRAY(stage_ptr->busy_queue_depth, thread_count);
+    EB_CALLOC_ARRAY(stage_ptr->busy_time, thread_count);
+    EB_MALLOC_ARRAY(stage_ptr->event_array, EB_STAGE_TRACE_EVENT_COUNT);
+    EB_CREATE_MUTEX(stage_ptr->lockout_mutex);
+    return EB_ErrorNone;
+}
+
+static void svt_pipeline_stats_dctor(EbPtr p) {
+    EbPipelineStats *obj = (EbPipelineStats *)p;
+    EB_DELETE_PTR_ARRAY(obj->stage_array, obj->stage_count);
+    EB_FREE(obj->trace_buffer);
+}
+
+EbErrorType svt_pipeline_stats_ctor(EbPipelineStats *stats_ptr, uint32_t stage_capacity) {
+    stats_ptr->dctor          = svt_pipeline_stats_dctor;
+    // Start one microsecond back so that no event starts at 0, the idle mark
+    stats_ptr->origin_time    = svt_pipeline_stats_time() - 1;
+    stats_ptr->stage_capacity = stage_capacity;
+    EB_ALLOC_PTR_ARRAY(stats_ptr->stage_array, stage_capacity);
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_pipeline_stats_add_stage(EbPipelineStats *stats_ptr, const char *name,
+                                         uint32_t thread_count, EbStagePictureFn picture_fn,
+                                         EbStageStats **stage_dbl_ptr) {
+    if (stats_ptr->stage_count == stats_ptr->stage_capacity || !thread_count)
+        return EB_ErrorBadParameter;
+    EB_NEW(stats_ptr->stage_array[stats_ptr->stage_count],
+           svt_stage_stats_ctor,
+           name,
+           stats_ptr->origin_time,
+           thread_count,
+           picture_fn);
+    *stage_dbl_ptr = stats_ptr->stage_array[stats_ptr->stage_count++];
+    return EB_ErrorNone;
+}
+
+uint64_t svt_stage_stats_post(EbStageStats *stage_ptr) {
+    const int32_t depth = svt_atomic_fetch_add_i32(&stage_ptr->queue_depth, 1) + 1;
+    int32_t       depth_max;
+
+    do
+        depth_max = svt_atomic_load_i32(&stage_ptr->queue_depth_max);
+    while (depth > depth_max &&
+           !svt_atomic_cas_i32(&stage_ptr->queue_depth_max, depth_max, depth));
+    return svt_pipeline_stats_time() - stage_ptr->origin_time;
+}
+
+void svt_stage_stats_begin(EbStageStats *stage_ptr, uint32_t thread_index, uint64_t post_time,
+                           EbPtr object_ptr) {
+    const uint64_t now        = svt_pipeline_stats_time() - stage_ptr->origin_time;
+    const uint64_t queue_time = now > post_time ? now - post_time : 0;
+    const int32_t  depth      = svt_atomic_fetch_add_i32(&stage_ptr->queue_depth, -1) - 1;
+
+    if (thread_index >= stage_ptr->thread_count)
+        return;
+    stage_ptr->busy_start_time[thread_index]  = now;
+    stage_ptr->busy_post_time[thread_index]   = post_time;
+    stage_ptr->busy_queue_depth[thread_index] = depth > 0 ? (uint32_t)depth : 0;
+    // The object may be reused once the stage releases it, read it now
+    stage_ptr->busy_picture_number[thread_index] = stage_ptr->picture_fn
+        ? stage_ptr->picture_fn(object_ptr)
+        : EB_STAGE_TRACE_NO_PICTURE;
+
+    svt_block_on_mutex(stage_ptr->lockout_mutex);
+    stage_ptr->object_count++;
+    stage_ptr->queue_time_total += queue_time;
+    if (queue_time > stage_ptr->queue_time_max)
+        stage_ptr->queue_time_max = queue_time;
+    svt_release_mutex(stage_ptr->lockout_mutex);
+}
+
+void svt_stage_stats_end(EbStageStats *stage_ptr, uint32_t thread_index) {
+    uint64_t           now;
+    EbStageTraceEvent *event_ptr;
+
+    // Nothing in progress on this thread
+    if (thread_index >= stage_ptr->thread_count || !stage_ptr->busy_start_time[thread_index])
+        return;
+    now = svt_pipeline_stats_time() - stage_ptr->origin_time;
+
+    svt_block_on_mutex(stage_ptr->lockout_mutex);
+    stage_ptr->busy_time[thread_index] += now - stage_ptr->busy_start_time[thread_index];
+    event_ptr = &stage_ptr->event_array[stage_ptr->event_count++ % EB_STAGE_TRACE_EVENT_COUNT];
+    event_ptr->post_time      = stage_ptr->busy_post_time[thread_index];
+    event_ptr->start_time     = stage_ptr->busy_start_time[thread_index];
+    event_ptr->end_time       = now;
+    event_ptr->picture_number = stage_ptr->busy_picture_number[thread_index];
+    event_ptr->thread_index   = thread_index;
+    event_ptr->queue_depth    = stage_ptr->busy_queue_depth[thread_index];
+    svt_release_mutex(stage_ptr->lockout_mutex);
+
+    stage_ptr->busy_start_time[thread_index] = 0;
+}
+
+EbErrorType svt_pipeline_stats_write_trace(EbPipelineStats *stats_ptr) {
+    size_t size = TRACE_HEADER_SIZE;
+    size_t pos  = 0;
+    char   separator;
+
+    for (uint32_t stage_index = 0; stage_index < stats_ptr->stage_count; stage_index++) {
+        const EbStageStats *stage_ptr = stats_ptr->stage_array[stage_index];
+        size += stage_ptr->thread_count * TRACE_THREAD_SIZE;
+        size += (stage_ptr->event_count < EB_STAGE_TRACE_EVENT_COUNT
+                     ? (size_t)stage_ptr->event_count
+                     : EB_STAGE_TRACE_EVENT_COUNT) *
+            TRACE_EVENT_SIZE;
+    }
+    EB_FREE(stats_ptr->trace_buffer);
+    stats_ptr->trace_size = 0;
+    EB_MALLOC(stats_ptr->trace_buffer, size);
+
+    char *trace = stats_ptr->trace_buffer;
+    pos += snprintf(trace + pos, size - pos, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    separator = '\n';
+    for (uint32_t stage_index = 0; stage_index < stats_ptr->stage_count; stage_index++) {
+        EbStageStats * stage_ptr = stats_ptr->stage_array[stage_index];
+        const uint32_t tid_base  = (stage_index + 1) * TRACE_STAGE_TID_STRIDE;
+
+        for (uint32_t thread_index = 0; thread_index < stage_ptr->thread_count; thread_index++) {
+            pos += snprintf(trace + pos,
+                            size - pos,
+                            "%c{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                            "\"args\":{\"name\":\"%s %u\"}}",
+                            separator,
+                            tid_base + thread_index,
+                            stage_ptr->name,
+                            thread_index);
+            separator = ',';
+        }
+
+        svt_block_on_mutex(stage_ptr->lockout_mutex);
+        const uint64_t first = stage_ptr->event_count > EB_STAGE_TRACE_EVENT_COUNT
+            ? stage_ptr->event_count - EB_STAGE_TRACE_EVENT_COUNT
+            : 0;
+        for (uint64_t event_index = first; event_index < stage_ptr->event_count; event_index++) {
+            // Events recorded since the buffer was sized are left out
+            if (pos + TRACE_EVENT_SIZE + TRACE_HEADER_SIZE > size)
+                break;
+            const EbStageTraceEvent *event_ptr =
+                &stage_ptr->event_array[event_index % EB_STAGE_TRACE_EVENT_COUNT];
+            // The flow bound to the slices of a picture links them in time
+            // order, from one stage thread to the next
+            char flow[TRACE_FLOW_SIZE]    = "";
+            char picture[TRACE_FLOW_SIZE] = "";
+            if (event_ptr->picture_number != EB_STAGE_TRACE_NO_PICTURE) {
+                snprintf(flow,
+                         sizeof(flow),
+                         "\"bind_id\":\"0x%llx\",\"flow_in\":true,\"flow_out\":true,",
+                         (unsigned long long)event_ptr->picture_number);
+                snprintf(picture,
+                         sizeof(picture),
+                         "\"picture\":%llu,",
+                         (unsigned long long)event_ptr->picture_number);
+            }
+            pos += snprintf(trace + pos,
+                            size - pos,
+                            ",\n{\"name\":\"%s\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,"
+                            "\"tid\":%u,\"ts\":%llu,\"dur\":%llu,%s\"args\":{%s\"stage\":%u,"
+                            "\"queued\":%llu,\"queue_time\":%llu}}"
+                            ",\n{\"name\":\"%s queue\",\"ph\":\"C\",\"pid\":1,\"ts\":%llu,"
+                            "\"args\":{\"depth\":%u}}",
+                            stage_ptr->name,
+                            tid_base + event_ptr->thread_index,
+                            (unsigned long long)event_ptr->start_time,
+                            (unsigned long long)(event_ptr->end_time - event_ptr->start_time),
+                            flow,
+                            picture,
+                            stage_index,
+                            (unsigned long long)event_ptr->post_time,
+                            (unsigned long long)(event_ptr->start_time > event_ptr->post_time
+                                                     ? event_ptr->start_time - event_ptr->post_time
+                                                     : 0),
+                            stage_ptr->name,
+                            (unsigned long long)event_ptr->start_time,
+                            event_ptr->queue_depth);
+        }
+        svt_release_mutex(stage_ptr->lockout_mutex);
+        separator = ',';
+    }
+    pos += snprintf(trace + pos, size - pos, "\n]}\n");
+    stats_ptr->trace_size = pos;
+    return EB_ErrorNone;
+}
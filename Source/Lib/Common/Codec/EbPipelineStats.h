@@ -0,0 +1,131 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbPipelineStats_h
+#define EbPipelineStats_h
+
+#include "EbDefinitions.h"
+#include "EbObject.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most recent objects of each stage kept for the trace
+#define EB_STAGE_TRACE_EVENT_COUNT 4096
+// Picture number of the objects of a stage without EbStagePictureFn
+#define EB_STAGE_TRACE_NO_PICTURE (~(uint64_t)0)
+
+/* Picture number of the object processed by a stage, object_ptr being the
+ * object_ptr of the EbObjectWrapper dequeued by the stage thread */
+typedef uint64_t (*EbStagePictureFn)(EbPtr object_ptr);
+
+/*********************************************************************
+ * StageTraceEvent
+ *   One object processed by a stage thread, times in microseconds
+ *   from the creation of the pipeline stats.
+ *********************************************************************/
+typedef struct EbStageTraceEvent {
+    uint64_t post_time; // queued by the producer
+    uint64_t start_time; // dequeued by the stage thread
+    uint64_t end_time; // the thread came back for the next object
+    uint64_t picture_number;
+    uint32_t thread_index;
+    uint32_t queue_depth; // objects left in the queue at dequeue
+} EbStageTraceEvent;
+
+/*********************************************************************
+ * StageStats
+ *   Counters of one pipeline stage, i.e. of the consumers of one
+ *   SystemResource full queue. Each thread index is only updated by
+ *   the thread that owns the matching consumer fifo or pool worker.
+ *   With fibers or pool tasks a thread index is a consumer context
+ *   of the stage rather than an OS thread.
+ *********************************************************************/
+typedef struct EbStageStats {
+    EbDctor          dctor;
+    const char *     name;
+    uint64_t         origin_time;
+    uint32_t         thread_count;
+    EbStagePictureFn picture_fn;
+
+    // Per thread, the object being processed and the accumulated busy time
+    uint64_t *busy_start_time;
+    uint64_t *busy_post_time;
+    uint64_t *busy_picture_number;
+    uint32_t *busy_queue_depth;
+    uint64_t *busy_time;
+
+    volatile int32_t queue_depth;
+    volatile int32_t queue_depth_max;
+
+    // lockout_mutex protects the totals and the event ring
+    EbHandle           lockout_mutex;
+    uint64_t           object_count;
+    uint64_t           queue_time_total;
+    uint64_t           queue_time_max;
+    EbStageTraceEvent *event_array;
+    uint64_t           event_count;
+} EbStageStats;
+
+/*********************************************************************
+ * PipelineStats
+ *   Stage stats of an encoder, in pipeline order.
+ *********************************************************************/
+typedef struct EbPipelineStats {
+    EbDctor        dctor;
+    uint64_t       origin_time;
+    uint32_t       stage_count;
+    EbStageStats **stage_array;
+    uint32_t       stage_capacity;
+    char *         trace_buffer;
+    size_t         trace_size;
+} EbPipelineStats;
+
+/* Monotonic time in microseconds */
+extern uint64_t svt_pipeline_stats_time(void);
+
+extern EbErrorType svt_pipeline_stats_ctor(EbPipelineStats *stats_ptr, uint32_t stage_capacity);
+
+/* Adds a stage served by thread_count threads, in pipeline order. picture_fn
+ * may be NULL when the objects of the stage are not tied to one picture. */
+extern EbErrorType svt_pipeline_stats_add_stage(EbPipelineStats *stats_ptr, const char *name,
+                                                uint32_t thread_count, EbStagePictureFn picture_fn,
+                                                EbStageStats **stage_dbl_ptr);
+
+/*********************************************************************
+ * svt_stage_stats_post
+ *   Called by the producer when an object enters the stage queue,
+ *   returns the post time to be kept with the object.
+ *********************************************************************/
+extern uint64_t svt_stage_stats_post(EbStageStats *stage_ptr);
+
+/*********************************************************************
+ * svt_stage_stats_begin / svt_stage_stats_end
+ *   Called by stage thread thread_index when it dequeues object_ptr
+ *   posted at post_time, and when it is done with it.
+ *********************************************************************/
+extern void svt_stage_stats_begin(EbStageStats *stage_ptr, uint32_t thread_index,
+                                  uint64_t post_time, EbPtr object_ptr);
+extern void svt_stage_stats_end(EbStageStats *stage_ptr, uint32_t thread_index);
+
+/*********************************************************************
+ * svt_pipeline_stats_write_trace
+ *   Formats the events kept for every stage as Chrome trace event
+ *   JSON into trace_buffer, replacing the previous trace. The events
+ *   of a picture are bound by a flow keyed on its picture number.
+ *********************************************************************/
+extern EbErrorType svt_pipeline_stats_write_trace(EbPipelineStats *stats_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbPipelineStats_h
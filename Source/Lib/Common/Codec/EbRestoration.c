@@ -1543,6 +1543,39 @@ void av1_foreach_rest_unit_in_frame_seg(Av1Common *cm, int32_t plane, RestTileSt
                                   segment_index);
 }
 
+// Luma rows [*y0, *y1) of the frame that the restoration search of a segment
+// row reads: its units in each plane, with the filter border around them
+void svt_av1_rest_segment_row_extent(Av1Common *cm, uint8_t rest_segments_row_count,
+                                     uint32_t y_seg_idx, int32_t *y0, int32_t *y1) {
+    *y0 = cm->frm_size.frame_height;
+    *y1 = 0;
+    for (int32_t plane = AOM_PLANE_Y; plane <= AOM_PLANE_V; ++plane) {
+        const int32_t          is_uv     = plane > 0;
+        const int32_t          ss_y      = is_uv && cm->subsampling_y;
+        const RestorationInfo *rsi       = &cm->rst_info[plane];
+        const int32_t          unit_size = rsi->restoration_unit_size;
+        const int32_t          voffset   = RESTORATION_UNIT_OFFSET >> ss_y;
+        const Av1PixelRect     tile_rect = whole_frame_rect(
+            &cm->frm_size, cm->subsampling_x, cm->subsampling_y, is_uv);
+        const uint32_t y_unit_start_idx = SEGMENT_START_IDX(
+            y_seg_idx, rsi->vert_units_per_tile, rest_segments_row_count);
+        const uint32_t y_unit_end_idx = SEGMENT_END_IDX(
+            y_seg_idx, rsi->vert_units_per_tile, rest_segments_row_count);
+
+        // Same limits as foreach_rest_unit_in_tile_seg()
+        const int32_t v_start = AOMMAX(tile_rect.top,
+                                       tile_rect.top + (int32_t)y_unit_start_idx * unit_size -
+                                           voffset - RESTORATION_BORDER);
+        const int32_t v_end   = (int32_t)y_unit_end_idx == rsi->vert_units_per_tile
+              ? tile_rect.bottom
+              : AOMMIN(tile_rect.bottom,
+                       tile_rect.top + (int32_t)y_unit_end_idx * unit_size - voffset +
+                           RESTORATION_BORDER);
+        *y0 = AOMMIN(*y0, v_start << ss_y);
+        *y1 = AOMMIN(AOMMAX(*y1, v_end << ss_y), cm->frm_size.frame_height);
+    }
+}
+
 int32_t svt_av1_loop_restoration_corners_in_sb(Av1Common *cm, SeqHeader *seq_header_p,
                                                int32_t plane, int32_t mi_row, int32_t mi_col,
                                                BlockSize bsize, int32_t *rcol0, int32_t *rcol1,
@@ -1865,6 +1898,54 @@ void svt_av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *frame,
     }
 }
 
+// Saves the CDEF lines of the top (frame_top) or of the bottom of the frame
+// only, the top ones are final once CDEF is done with the first 64 rows
+void svt_av1_loop_restoration_save_cdef_boundary_lines(const Yv12BufferConfig *frame,
+                                                       Av1Common *cm, int32_t frame_top) {
+    const int32_t num_planes = 3; // av1_num_planes(cm);
+    const int32_t use_highbd = cm->use_highbitdepth;
+
+    for (int32_t p = 0; p < num_planes; ++p) {
+        const int32_t                is_uv         = p > 0;
+        const int32_t                ss_y          = is_uv && cm->subsampling_y;
+        const int32_t                stripe_height = RESTORATION_PROC_UNIT_SIZE >> ss_y;
+        const int32_t                stripe_off    = RESTORATION_UNIT_OFFSET >> ss_y;
+        int32_t                      crop_width    = frame->crop_widths[is_uv];
+        uint8_t *                    src_buf       = REAL_PTR(use_highbd, frame->buffers[p]);
+        int32_t                      src_stride    = frame->strides[is_uv];
+        RestorationStripeBoundaries *boundaries    = &cm->rst_info[p].boundaries;
+        const Av1PixelRect           tile_rect     = whole_frame_rect(
+            &cm->frm_size, cm->subsampling_x, cm->subsampling_y, is_uv);
+
+        if (frame_top) {
+            save_cdef_boundary_lines(src_buf,
+                                     src_stride,
+                                     crop_width,
+                                     cm,
+                                     p,
+                                     tile_rect.top,
+                                     0,
+                                     use_highbd,
+                                     1,
+                                     boundaries);
+        } else {
+            // The last stripe, as in save_tile_row_boundary_lines()
+            const int32_t frame_stripe = (tile_rect.bottom - tile_rect.top + stripe_off - 1) /
+                stripe_height;
+            save_cdef_boundary_lines(src_buf,
+                                     src_stride,
+                                     crop_width,
+                                     cm,
+                                     p,
+                                     tile_rect.bottom - 1,
+                                     frame_stripe,
+                                     use_highbd,
+                                     0,
+                                     boundaries);
+        }
+    }
+}
+
 // Assumes cm->rst_info[p].restoration_unit_size is already initialized
 
 EbErrorType svt_av1_alloc_restoration_buffers(Av1Common *cm) {
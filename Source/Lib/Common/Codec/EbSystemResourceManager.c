@@ -16,6 +16,209 @@
 #include "EbDefinitions.h"
 #include "EbThreads.h"
 
+/**************************************
+ * svt_fifo_stats_end / svt_fifo_stats_begin
+ *   Close the timing of the object the consumer of full_fifo_ptr was
+ *   working on, and open it for the object it just dequeued.
+ **************************************/
+static INLINE void svt_fifo_stats_end(const EbFifo *full_fifo_ptr) {
+    if (full_fifo_ptr->queue_ptr->stage_stats)
+        svt_stage_stats_end(full_fifo_ptr->queue_ptr->stage_stats, full_fifo_ptr->process_index);
+}
+
+static INLINE void svt_fifo_stats_begin(const EbFifo *         full_fifo_ptr,
+                                        const EbObjectWrapper *object_ptr) {
+    if (object_ptr && full_fifo_ptr->queue_ptr->stage_stats)
+        svt_stage_stats_begin(full_fifo_ptr->queue_ptr->stage_stats,
+                              full_fifo_ptr->process_index,
+                              object_ptr->post_time,
+                              object_ptr->object_ptr);
+}
+
+#if EN_LOCKFREE_FIFO
+// Number of busy polls of the ready count, then of polls yielding the cpu, before a
+// waiting thread parks on the semaphore
+#define FIFO_SPIN_COUNT 256
+#define FIFO_YIELD_COUNT 16
+
+/**************************************
+ * svt_fifo_ctor
+ **************************************/
+static EbErrorType svt_fifo_ctor(EbFifo *fifoPtr, EbMuxingQueue *queue_ptr) {
+    // Copy the Muxing Queue ptr this Fifo belongs to
+    fifoPtr->queue_ptr = queue_ptr;
+
+    return EB_ErrorNone;
+}
+
+static EbErrorType svt_fifo_shutdown(EbFifo *fifo_ptr) {
+    // Consumers are woken up by svt_shutdown_process once every fifo is flagged
+    fifo_ptr->quit_signal = EB_TRUE;
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_lockfree_queue_signal
+ *   Adds a token to ready_count and wakes up a parked waiter if the
+ *   count was negative.
+ **************************************/
+static void svt_lockfree_queue_signal(EbMuxingQueue *queue_ptr) {
+    if (svt_atomic_fetch_add_i32(&queue_ptr->ready_count, 1) < 0)
+        svt_post_semaphore(queue_ptr->park_semaphore);
+}
+
+/**************************************
+ * svt_lockfree_queue_push
+ *   Publishes wrapper_ptr in the ring of queue_ptr, then signals one
+ *   waiter. The ring is sized for every object of the SystemResource
+ *   so a free cell is always found.
+ **************************************/
+static void svt_lockfree_queue_push(EbMuxingQueue *queue_ptr, EbObjectWrapper *wrapper_ptr) {
+    EbRingCell *cell;
+    uint32_t    pos = svt_atomic_load_u32(&queue_ptr->enqueue_pos);
+
+    for (;;) {
+        cell                = &queue_ptr->cell_array[pos & queue_ptr->cell_mask];
+        const int32_t delta = (int32_t)(svt_atomic_load_u32(&cell->sequence) - pos);
+        if (delta == 0 && svt_atomic_cas_u32(&queue_ptr->enqueue_pos, pos, pos + 1))
+            break;
+        if (delta < 0)
+            svt_cpu_relax();
+        pos = svt_atomic_load_u32(&queue_ptr->enqueue_pos);
+    }
+    cell->wrapper_ptr = wrapper_ptr;
+    svt_atomic_store_u32(&cell->sequence, pos + 1);
+
+    svt_lockfree_queue_signal(queue_ptr);
+}
+
+/**************************************
+ * svt_lockfree_queue_pop
+ *   Dequeues the oldest published wrapper. The caller must own a
+ *   token of ready_count, so the ring holds at least one object;
+ *   a producer that claimed an older cell may still be publishing it.
+ **************************************/
+static EbObjectWrapper *svt_lockfree_queue_pop(EbMuxingQueue *queue_ptr) {
+    EbRingCell *cell;
+    uint32_t    pos = svt_atomic_load_u32(&queue_ptr->dequeue_pos);
+
+    for (;;) {
+        cell                = &queue_ptr->cell_array[pos & queue_ptr->cell_mask];
+        const int32_t delta = (int32_t)(svt_atomic_load_u32(&cell->sequence) - (pos + 1));
+        if (delta == 0 && svt_atomic_cas_u32(&queue_ptr->dequeue_pos, pos, pos + 1))
+            break;
+        // the producer of this cell was preempted before publishing it
+        if (delta < 0)
+            svt_yield_thread();
+        pos = svt_atomic_load_u32(&queue_ptr->dequeue_pos);
+    }
+    EbObjectWrapper *wrapper_ptr = cell->wrapper_ptr;
+    svt_atomic_store_u32(&cell->sequence, pos + queue_ptr->cell_mask + 1);
+
+    return wrapper_ptr;
+}
+
+/**************************************
+ * svt_lockfree_queue_try_wait
+ *   Takes a token of ready_count without blocking.
+ **************************************/
+static EbBool svt_lockfree_queue_try_wait(EbMuxingQueue *queue_ptr) {
+    int32_t count = svt_atomic_load_i32(&queue_ptr->ready_count);
+
+    while (count > 0) {
+        if (svt_atomic_cas_i32(&queue_ptr->ready_count, count, count - 1))
+            return EB_TRUE;
+        count = svt_atomic_load_i32(&queue_ptr->ready_count);
+    }
+    return EB_FALSE;
+}
+
+/**************************************
+ * svt_muxing_queue_has_object
+ *   Whether an object is published and not claimed yet.
+ **************************************/
+static EbBool svt_muxing_queue_has_object(EbMuxingQueue *queue_ptr) {
+    return svt_atomic_load_i32(&queue_ptr->ready_count) > 0;
+}
+
+/**************************************
+ * svt_lockfree_queue_wait
+ *   Spins for a while on ready_count, yields to let a producer
+ *   sharing the core run, then parks the calling thread on the queue
+ *   semaphore until a producer posts it. A fiber parks at once, its
+ *   worker has other tasks to run.
+ **************************************/
+static void svt_lockfree_queue_wait(EbMuxingQueue *queue_ptr) {
+    const uint32_t spin_count  = svt_in_fiber() ? 0 : FIFO_SPIN_COUNT;
+    const uint32_t yield_count = svt_in_fiber() ? 0 : FIFO_YIELD_COUNT;
+
+    for (uint32_t spin = 0; spin < spin_count; ++spin) {
+        if (svt_lockfree_queue_try_wait(queue_ptr))
+            return;
+        svt_cpu_relax();
+    }
+    for (uint32_t spin = 0; spin < yield_count; ++spin) {
+        if (svt_lockfree_queue_try_wait(queue_ptr))
+            return;
+        svt_yield_thread();
+    }
+    if (svt_atomic_fetch_add_i32(&queue_ptr->ready_count, -1) <= 0)
+        svt_block_on_semaphore(queue_ptr->park_semaphore);
+}
+
+void svt_muxing_queue_dctor(EbPtr p) {
+    EbMuxingQueue *obj = (EbMuxingQueue *)p;
+    EB_DELETE_PTR_ARRAY(obj->process_fifo_ptr_array, obj->process_total_count);
+    EB_FREE_ARRAY(obj->cell_array);
+    EB_DESTROY_SEMAPHORE(obj->park_semaphore);
+    EB_DESTROY_MUTEX(obj->lockout_mutex);
+}
+
+/**************************************
+ * svt_muxing_queue_ctor
+ **************************************/
+static EbErrorType svt_muxing_queue_ctor(EbMuxingQueue *queue_ptr, uint32_t object_total_count,
+                                         uint32_t process_total_count) {
+    uint32_t cell_count = 2;
+    uint32_t process_index;
+
+    queue_ptr->dctor               = svt_muxing_queue_dctor;
+    queue_ptr->process_total_count = process_total_count;
+
+    // Lockout Mutex, protects the EbObjectWrapper live_count and release_enable
+    EB_CREATE_MUTEX(queue_ptr->lockout_mutex);
+
+    // Parking Semaphore, posted once per parked waiter and once per consumer at shutdown
+    EB_CREATE_SEMAPHORE(queue_ptr->park_semaphore, 0, object_total_count + process_total_count);
+
+    // Construct the ring, a power of two able to hold every object
+    while (cell_count < object_total_count) cell_count <<= 1;
+    EB_MALLOC_ARRAY(queue_ptr->cell_array, cell_count);
+    for (uint32_t cell_index = 0; cell_index < cell_count; ++cell_index) {
+        queue_ptr->cell_array[cell_index].sequence    = cell_index;
+        queue_ptr->cell_array[cell_index].wrapper_ptr = NULL;
+    }
+    queue_ptr->cell_mask = cell_count - 1;
+
+    // Construct the Process Fifos
+    EB_ALLOC_PTR_ARRAY(queue_ptr->process_fifo_ptr_array, queue_ptr->process_total_count);
+
+    for (process_index = 0; process_index < queue_ptr->process_total_count; ++process_index) {
+        EB_NEW(queue_ptr->process_fifo_ptr_array[process_index], svt_fifo_ctor, queue_ptr);
+        queue_ptr->process_fifo_ptr_array[process_index]->process_index = process_index;
+    }
+
+    return EB_ErrorNone;
+}
+
+static EbErrorType svt_muxing_queue_object_push_back(EbMuxingQueue *  queue_ptr,
+                                                     EbObjectWrapper *object_ptr) {
+    svt_lockfree_queue_push(queue_ptr, object_ptr);
+
+    return EB_ErrorNone;
+}
+#else
 static void svt_fifo_dctor(EbPtr p) {
     EbFifo *obj = (EbFifo *)p;
     EB_DESTROY_SEMAPHORE(obj->counting_semaphore);
@@ -223,6 +426,7 @@ static EbErrorType svt_muxing_queue_ctor(EbMuxingQueue *queue_ptr, uint32_t obje
                (EbObjectWrapper *)NULL,
                (EbObjectWrapper *)NULL,
                queue_ptr);
+        queue_ptr->process_fifo_ptr_array[process_index]->process_index = process_index;
     }
 
     return return_error;
@@ -288,6 +492,62 @@ static EbErrorType svt_muxing_queue_object_push_front(EbMuxingQueue *  queue_ptr
 
     return return_error;
 }
+#endif
+
+// Counts an object taken from the empty queue of its resource
+static void svt_system_resource_take(EbSystemResource *resource_ptr) {
+    const int32_t in_use = svt_atomic_fetch_add_i32(&resource_ptr->in_use_count, 1) + 1;
+    int32_t       peak   = svt_atomic_load_i32(&resource_ptr->peak_in_use_count);
+    while (in_use > peak &&
+           !svt_atomic_cas_i32(&resource_ptr->peak_in_use_count, peak, in_use))
+        peak = svt_atomic_load_i32(&resource_ptr->peak_in_use_count);
+}
+
+/*********************************************************************
+ * svt_object_list_push, svt_object_list_pop
+ *   Oldest first list of full objects linked by next_ptr, for the
+ *   pool tasks waiting on a resource. Full objects that pool tasks
+ *   consume are in no fifo, so their next_ptr is free.
+ *********************************************************************/
+static void svt_object_list_push(EbObjectWrapper **head_dbl_ptr, EbObjectWrapper **tail_dbl_ptr,
+                                 EbObjectWrapper *object_ptr) {
+    object_ptr->next_ptr = NULL;
+    if (*tail_dbl_ptr)
+        (*tail_dbl_ptr)->next_ptr = object_ptr;
+    else
+        *head_dbl_ptr = object_ptr;
+    *tail_dbl_ptr = object_ptr;
+}
+
+static EbObjectWrapper *svt_object_list_pop(EbObjectWrapper **head_dbl_ptr,
+                                            EbObjectWrapper **tail_dbl_ptr) {
+    EbObjectWrapper *object_ptr = *head_dbl_ptr;
+    if (object_ptr) {
+        *head_dbl_ptr = object_ptr->next_ptr;
+        if (!*head_dbl_ptr)
+            *tail_dbl_ptr = NULL;
+        object_ptr->next_ptr = NULL;
+    }
+    return object_ptr;
+}
+
+static EbErrorType svt_system_resource_queue_task(EbObjectWrapper *object_ptr);
+static EbErrorType svt_system_resource_resubmit(EbObjectWrapper *object_ptr);
+
+/*********************************************************************
+ * svt_muxing_queue_wake_parked
+ *   Resubmits the oldest pool task parked on queue_ptr, called after
+ *   an object is pushed back to it.
+ *********************************************************************/
+static void svt_muxing_queue_wake_parked(EbMuxingQueue *queue_ptr) {
+    EbObjectWrapper *object_ptr;
+
+    svt_block_on_mutex(queue_ptr->lockout_mutex);
+    object_ptr = svt_object_list_pop(&queue_ptr->parked_head_ptr, &queue_ptr->parked_tail_ptr);
+    svt_release_mutex(queue_ptr->lockout_mutex);
+    if (object_ptr)
+        svt_system_resource_resubmit(object_ptr);
+}
 
 static EbFifo *svt_muxing_queue_get_fifo(EbMuxingQueue *queue_ptr, uint32_t index) {
     assert(queue_ptr->process_fifo_ptr_array && (queue_ptr->process_total_count > index));
@@ -407,6 +667,8 @@ static EbErrorType svt_object_wrapper_ctor(EbObjectWrapper *wrapper, EbSystemRes
 
 static void svt_system_resource_dctor(EbPtr p) {
     EbSystemResource *obj = (EbSystemResource *)p;
+    EB_DESTROY_MUTEX(obj->context_mutex);
+    EB_FREE_ARRAY(obj->free_context_array);
     EB_DELETE(obj->full_queue);
     EB_DELETE(obj->empty_queue);
     EB_DELETE_PTR_ARRAY(obj->wrapper_ptr_pool, obj->object_total_count);
@@ -442,23 +704,45 @@ EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr, uint32_t ob
                                      uint32_t  consumer_process_total_count,
                                      EbCreator object_creator, EbPtr object_init_data_ptr,
                                      EbDctor object_destroyer) {
+    return svt_system_resource_budget_ctor(resource_ptr,
+                                           object_total_count,
+                                           object_total_count,
+                                           SIZE_MAX,
+                                           producer_process_total_count,
+                                           consumer_process_total_count,
+                                           object_creator,
+                                           object_init_data_ptr,
+                                           object_destroyer);
+}
+
+EbErrorType svt_system_resource_budget_ctor(EbSystemResource *resource_ptr, uint32_t min_count,
+                                            uint32_t max_count, size_t byte_limit,
+                                            uint32_t  producer_process_total_count,
+                                            uint32_t  consumer_process_total_count,
+                                            EbCreator object_creator, EbPtr object_init_data_ptr,
+                                            EbDctor object_destroyer) {
     uint32_t    wrapper_index;
     EbErrorType return_error = EB_ErrorNone;
     resource_ptr->dctor      = svt_system_resource_dctor;
 
-    resource_ptr->object_total_count = object_total_count;
-
     // Allocate array for wrapper pointers
-    EB_ALLOC_PTR_ARRAY(resource_ptr->wrapper_ptr_pool, resource_ptr->object_total_count);
-
-    // Initialize each wrapper
-    for (wrapper_index = 0; wrapper_index < resource_ptr->object_total_count; ++wrapper_index) {
+    EB_ALLOC_PTR_ARRAY(resource_ptr->wrapper_ptr_pool, max_count);
+
+    // Initialize each wrapper, the dctor deletes the object_total_count first ones
+    for (wrapper_index = 0; wrapper_index < max_count; ++wrapper_index) {
+        if (wrapper_index >= min_count &&
+            resource_ptr->object_bytes * (wrapper_index + 1) > byte_limit)
+            break;
+        const size_t alloc_bytes = svt_thread_alloc_bytes();
+        resource_ptr->object_total_count = wrapper_index + 1;
         EB_NEW(resource_ptr->wrapper_ptr_pool[wrapper_index],
                svt_object_wrapper_ctor,
                resource_ptr,
                object_creator,
                object_init_data_ptr,
                object_destroyer);
+        if (wrapper_index == 0)
+            resource_ptr->object_bytes = svt_thread_alloc_bytes() - alloc_bytes;
     }
 
     // Initialize the Empty Queue
@@ -495,6 +779,177 @@ EbFifo *svt_system_resource_get_consumer_fifo(const EbSystemResource *resource_p
     return svt_muxing_queue_get_fifo(resource_ptr->full_queue, index);
 }
 
+EbErrorType svt_system_resource_attach_thread_pool(EbSystemResource *resource_ptr,
+                                                   EbThreadPool *pool_ptr, EbPoolTaskFn task_fn,
+                                                   EbPtr *context_array) {
+    if (!pool_ptr || !task_fn || !context_array || !resource_ptr->full_queue)
+        return EB_ErrorBadParameter;
+    // The contexts belong to the channel, the pool only lends its workers
+    const uint32_t context_count = resource_ptr->full_queue->process_total_count;
+    EB_MALLOC_ARRAY(resource_ptr->free_context_array, context_count);
+    for (uint32_t i = 0; i < context_count; i++)
+        resource_ptr->free_context_array[i] = context_count - 1 - i;
+    resource_ptr->free_context_count = context_count;
+    EB_CREATE_MUTEX(resource_ptr->context_mutex);
+    resource_ptr->pool_task_fn       = task_fn;
+    resource_ptr->pool_context_array = context_array;
+    resource_ptr->thread_pool        = pool_ptr;
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_system_resource_attach_pool_client(EbSystemResource *resource_ptr,
+                                                   EbPoolClient *client_ptr, EbPoolTaskFn task_fn,
+                                                   EbPtr *context_array) {
+    if (!client_ptr)
+        return EB_ErrorBadParameter;
+    EbErrorType return_error = svt_system_resource_attach_thread_pool(
+        resource_ptr, client_ptr->pool_ptr, task_fn, context_array);
+    if (return_error == EB_ErrorNone)
+        resource_ptr->pool_client = client_ptr;
+    return return_error;
+}
+
+EbErrorType svt_system_resource_set_release_callback(EbSystemResource *resource_ptr,
+                                                     EbObjectReleaseFn release_fn,
+                                                     EbPtr             context_ptr) {
+    if (!release_fn)
+        return EB_ErrorBadParameter;
+    resource_ptr->release_context_ptr = context_ptr;
+    resource_ptr->release_fn          = release_fn;
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_system_resource_attach_stats(EbSystemResource *resource_ptr,
+                                             EbPipelineStats *pipeline_ptr,
+                                             const char *     stage_name,
+                                             EbStagePictureFn picture_fn) {
+    EbStageStats *stage_ptr;
+
+    if (!resource_ptr->full_queue)
+        return EB_ErrorBadParameter;
+    EbErrorType return_error = svt_pipeline_stats_add_stage(
+        pipeline_ptr,
+        stage_name,
+        resource_ptr->full_queue->process_total_count,
+        picture_fn,
+        &stage_ptr);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    resource_ptr->full_queue->stage_stats = stage_ptr;
+    return EB_ErrorNone;
+}
+
+#if EN_LOCKFREE_FIFO
+EbErrorType svt_shutdown_process(const EbSystemResource *resource_ptr) {
+    unsigned int i;
+    //not fully constructed
+    if (!resource_ptr || !resource_ptr->full_queue)
+        return EB_ErrorNone;
+
+    //flag every consumer before waking any of them, the fifos share one ring
+    for (i = 0; i < resource_ptr->full_queue->process_total_count; i++)
+        svt_fifo_shutdown(svt_system_resource_get_consumer_fifo(resource_ptr, i));
+    for (i = 0; i < resource_ptr->full_queue->process_total_count; i++)
+        svt_lockfree_queue_signal(resource_ptr->full_queue);
+    return EB_ErrorNone;
+}
+
+static EbErrorType svt_full_queue_post(EbObjectWrapper *object_ptr) {
+    svt_lockfree_queue_push(object_ptr->system_resource_ptr->full_queue, object_ptr);
+
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_release_object(EbObjectWrapper *object_ptr) {
+    EbMuxingQueue *empty_queue = object_ptr->system_resource_ptr->empty_queue;
+    EbBool         released    = EB_FALSE;
+
+    svt_block_on_mutex(empty_queue->lockout_mutex);
+
+    // Decrement live_count
+    object_ptr->live_count = (object_ptr->live_count == 0) ? object_ptr->live_count
+                                                           : object_ptr->live_count - 1;
+
+    if ((object_ptr->release_enable == EB_TRUE) && (object_ptr->live_count == 0)) {
+        // Set live_count to EB_ObjectWrapperReleasedValue
+        object_ptr->live_count = EB_ObjectWrapperReleasedValue;
+        released               = EB_TRUE;
+    }
+
+    svt_release_mutex(empty_queue->lockout_mutex);
+
+    // Only the thread that dropped the last reference queues the object
+    if (released) {
+        svt_atomic_fetch_add_i32(&object_ptr->system_resource_ptr->in_use_count, -1);
+        if (object_ptr->system_resource_ptr->release_fn)
+            object_ptr->system_resource_ptr->release_fn(
+                object_ptr->system_resource_ptr->release_context_ptr, object_ptr);
+        svt_lockfree_queue_push(empty_queue, object_ptr);
+        svt_muxing_queue_wake_parked(empty_queue);
+    }
+
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
+    svt_lockfree_queue_wait(empty_fifo_ptr->queue_ptr);
+
+    *wrapper_dbl_ptr = svt_lockfree_queue_pop(empty_fifo_ptr->queue_ptr);
+    svt_system_resource_take((*wrapper_dbl_ptr)->system_resource_ptr);
+
+    // The wrapper is owned by the caller from now on
+    (*wrapper_dbl_ptr)->live_count     = 0;
+    (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_get_empty_object_non_blocking(EbFifo *          empty_fifo_ptr,
+                                              EbObjectWrapper **wrapper_dbl_ptr) {
+    if (!svt_lockfree_queue_try_wait(empty_fifo_ptr->queue_ptr)) {
+        *wrapper_dbl_ptr = (EbObjectWrapper *)NULL;
+        return EB_ErrorNone;
+    }
+    *wrapper_dbl_ptr = svt_lockfree_queue_pop(empty_fifo_ptr->queue_ptr);
+    svt_system_resource_take((*wrapper_dbl_ptr)->system_resource_ptr);
+
+    (*wrapper_dbl_ptr)->live_count     = 0;
+    (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_get_full_object(EbFifo *full_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
+    svt_fifo_stats_end(full_fifo_ptr);
+
+    svt_lockfree_queue_wait(full_fifo_ptr->queue_ptr);
+
+    if (full_fifo_ptr->quit_signal) {
+        *wrapper_dbl_ptr = NULL;
+        return EB_NoErrorFifoShutdown;
+    }
+    *wrapper_dbl_ptr = svt_lockfree_queue_pop(full_fifo_ptr->queue_ptr);
+
+    svt_fifo_stats_begin(full_fifo_ptr, *wrapper_dbl_ptr);
+
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_get_full_object_non_blocking(EbFifo *          full_fifo_ptr,
+                                             EbObjectWrapper **wrapper_dbl_ptr) {
+    svt_fifo_stats_end(full_fifo_ptr);
+
+    //if the fifo is shutting down, we will not give any buffer to caller
+    if (!full_fifo_ptr->quit_signal && svt_lockfree_queue_try_wait(full_fifo_ptr->queue_ptr))
+        *wrapper_dbl_ptr = svt_lockfree_queue_pop(full_fifo_ptr->queue_ptr);
+    else
+        *wrapper_dbl_ptr = (EbObjectWrapper *)NULL;
+
+    svt_fifo_stats_begin(full_fifo_ptr, *wrapper_dbl_ptr);
+
+    return EB_ErrorNone;
+}
+#else
 EbErrorType svt_shutdown_process(const EbSystemResource *resource_ptr) {
     //not fully constructed
     if (!resource_ptr || !resource_ptr->full_queue)
@@ -539,7 +994,7 @@ static EbErrorType svt_release_process(EbFifo *process_fifo_ptr) {
  *   wrapper_ptr
  *      pointer to EbObjectWrapper to be posted.
  *********************************************************************/
-EbErrorType svt_post_full_object(EbObjectWrapper *object_ptr) {
+static EbErrorType svt_full_queue_post(EbObjectWrapper *object_ptr) {
     EbErrorType return_error = EB_ErrorNone;
 
     svt_block_on_mutex(object_ptr->system_resource_ptr->full_queue->lockout_mutex);
@@ -562,9 +1017,11 @@ EbErrorType svt_post_full_object(EbObjectWrapper *object_ptr) {
  *      pointer to EbObjectWrapper to be released.
  *********************************************************************/
 EbErrorType svt_release_object(EbObjectWrapper *object_ptr) {
-    EbErrorType return_error = EB_ErrorNone;
+    EbErrorType       return_error = EB_ErrorNone;
+    EbSystemResource *resource_ptr = object_ptr->system_resource_ptr;
+    EbBool            released     = EB_FALSE;
 
-    svt_block_on_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+    svt_block_on_mutex(resource_ptr->empty_queue->lockout_mutex);
 
     // Decrement live_count
     object_ptr->live_count = (object_ptr->live_count == 0) ? object_ptr->live_count
@@ -573,12 +1030,23 @@ EbErrorType svt_release_object(EbObjectWrapper *object_ptr) {
     if ((object_ptr->release_enable == EB_TRUE) && (object_ptr->live_count == 0)) {
         // Set live_count to EB_ObjectWrapperReleasedValue
         object_ptr->live_count = EB_ObjectWrapperReleasedValue;
-
-        svt_muxing_queue_object_push_front(object_ptr->system_resource_ptr->empty_queue,
-                                           object_ptr);
+        svt_atomic_fetch_add_i32(&resource_ptr->in_use_count, -1);
+
+        if (resource_ptr->release_fn) {
+            // The callback may reach back into the resource, run it unlocked;
+            // the released value keeps every other thread off the object
+            svt_release_mutex(resource_ptr->empty_queue->lockout_mutex);
+            resource_ptr->release_fn(resource_ptr->release_context_ptr, object_ptr);
+            svt_block_on_mutex(resource_ptr->empty_queue->lockout_mutex);
+        }
+        svt_muxing_queue_object_push_front(resource_ptr->empty_queue, object_ptr);
+        released = EB_TRUE;
     }
 
-    svt_release_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+    svt_release_mutex(resource_ptr->empty_queue->lockout_mutex);
+
+    if (released)
+        svt_muxing_queue_wake_parked(resource_ptr->empty_queue);
 
     return return_error;
 }
@@ -612,6 +1080,7 @@ EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapp
 
     // Get the empty object
     svt_fifo_pop_front(empty_fifo_ptr, wrapper_dbl_ptr);
+    svt_system_resource_take((*wrapper_dbl_ptr)->system_resource_ptr);
 
     // Reset the wrapper's live_count
     (*wrapper_dbl_ptr)->live_count = 0;
@@ -625,6 +1094,47 @@ EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapp
     return return_error;
 }
 
+/*********************************************************************
+ * svt_muxing_queue_has_object
+ *   Whether svt_get_empty_object_non_blocking would get an object.
+ *   Must be called with the lockout_mutex of queue_ptr held.
+ *********************************************************************/
+static EbBool svt_muxing_queue_has_object(EbMuxingQueue *queue_ptr) {
+    return !svt_circular_buffer_empty_check(queue_ptr->object_queue) &&
+        svt_circular_buffer_empty_check(queue_ptr->process_queue);
+}
+
+EbErrorType svt_get_empty_object_non_blocking(EbFifo *          empty_fifo_ptr,
+                                              EbObjectWrapper **wrapper_dbl_ptr) {
+    EbMuxingQueue *queue_ptr = empty_fifo_ptr->queue_ptr;
+    EbBool         available;
+
+    // Only queue the request when the object is assigned to it at once,
+    // a request left in the process queue would hold the next release
+    svt_block_on_mutex(queue_ptr->lockout_mutex);
+    available = svt_muxing_queue_has_object(queue_ptr);
+    if (available) {
+        svt_circular_buffer_push_front(queue_ptr->process_queue, empty_fifo_ptr);
+        svt_muxing_queue_assignation(queue_ptr);
+    }
+    svt_release_mutex(queue_ptr->lockout_mutex);
+
+    if (!available) {
+        *wrapper_dbl_ptr = (EbObjectWrapper *)NULL;
+        return EB_ErrorNone;
+    }
+    // The assignation posted the fifo semaphore, this does not block
+    svt_block_on_semaphore(empty_fifo_ptr->counting_semaphore);
+    svt_block_on_mutex(empty_fifo_ptr->lockout_mutex);
+    svt_fifo_pop_front(empty_fifo_ptr, wrapper_dbl_ptr);
+    svt_system_resource_take((*wrapper_dbl_ptr)->system_resource_ptr);
+    (*wrapper_dbl_ptr)->live_count     = 0;
+    (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+    svt_release_mutex(empty_fifo_ptr->lockout_mutex);
+
+    return EB_ErrorNone;
+}
+
 /*********************************************************************
  * EbSystemResourceGetFullObject
  *   Dequeues an full EbObjectWrapper from the SystemResource. This
@@ -643,6 +1153,8 @@ EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapp
 EbErrorType svt_get_full_object(EbFifo *full_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
     EbErrorType return_error = EB_ErrorNone;
 
+    svt_fifo_stats_end(full_fifo_ptr);
+
     // Queue the Fifo requesting the full fifo
     svt_release_process(full_fifo_ptr);
 
@@ -662,6 +1174,8 @@ EbErrorType svt_get_full_object(EbFifo *full_fifo_ptr, EbObjectWrapper **wrapper
     // Release Mutex
     svt_release_mutex(full_fifo_ptr->lockout_mutex);
 
+    svt_fifo_stats_begin(full_fifo_ptr, *wrapper_dbl_ptr);
+
     return return_error;
 }
 
@@ -680,6 +1194,9 @@ EbErrorType svt_get_full_object_non_blocking(EbFifo *          full_fifo_ptr,
                                              EbObjectWrapper **wrapper_dbl_ptr) {
     EbErrorType return_error = EB_ErrorNone;
     EbBool      fifo_empty;
+
+    svt_fifo_stats_end(full_fifo_ptr);
+
     // Queue the Fifo requesting the full fifo
     svt_release_process(full_fifo_ptr);
 
@@ -702,3 +1219,120 @@ EbErrorType svt_get_full_object_non_blocking(EbFifo *          full_fifo_ptr,
 
     return return_error;
 }
+#endif
+
+/*********************************************************************
+ * svt_system_resource_pool_task
+ *   Runs the consumer stage of the resource of an object on a free
+ *   consumer context, or queues the object in the context_wait list
+ *   of the resource when none is free.
+ *********************************************************************/
+static void svt_system_resource_pool_task(void *context_ptr, void *data_ptr) {
+    EbObjectWrapper * object_ptr   = (EbObjectWrapper *)data_ptr;
+    EbSystemResource *resource_ptr = object_ptr->system_resource_ptr;
+    EbStageStats *    stage_ptr    = resource_ptr->full_queue->stage_stats;
+    uint32_t          context_index;
+
+    (void)context_ptr;
+    svt_block_on_mutex(resource_ptr->context_mutex);
+    const EbBool context_free = resource_ptr->free_context_count > 0;
+    if (context_free)
+        context_index = resource_ptr->free_context_array[--resource_ptr->free_context_count];
+    else
+        svt_object_list_push(&resource_ptr->context_wait_head_ptr,
+                             &resource_ptr->context_wait_tail_ptr,
+                             object_ptr);
+    svt_release_mutex(resource_ptr->context_mutex);
+    if (!context_free)
+        return;
+
+    // The object may be reused as soon as the stage releases it
+    if (stage_ptr)
+        svt_stage_stats_begin(
+            stage_ptr, context_index, object_ptr->post_time, object_ptr->object_ptr);
+    resource_ptr->pool_task_fn(resource_ptr->pool_context_array[context_index], object_ptr);
+    if (stage_ptr)
+        svt_stage_stats_end(stage_ptr, context_index);
+
+    svt_block_on_mutex(resource_ptr->context_mutex);
+    resource_ptr->free_context_array[resource_ptr->free_context_count++] = context_index;
+    object_ptr = svt_object_list_pop(&resource_ptr->context_wait_head_ptr,
+                                     &resource_ptr->context_wait_tail_ptr);
+    svt_release_mutex(resource_ptr->context_mutex);
+    if (object_ptr)
+        svt_system_resource_queue_task(object_ptr);
+}
+
+/*********************************************************************
+ * svt_system_resource_queue_task
+ *   Submits a full object of a resource attached to a thread pool.
+ *********************************************************************/
+static EbErrorType svt_system_resource_queue_task(EbObjectWrapper *object_ptr) {
+    const EbSystemResource *resource_ptr = object_ptr->system_resource_ptr;
+
+    if (resource_ptr->pool_client)
+        return svt_pool_client_submit(
+            resource_ptr->pool_client, svt_system_resource_pool_task, NULL, object_ptr);
+    return svt_thread_pool_submit(
+        resource_ptr->thread_pool, svt_system_resource_pool_task, NULL, object_ptr);
+}
+
+/*********************************************************************
+ * svt_system_resource_resubmit
+ *   Submits the full object of a parked pool task again, its queue
+ *   time starts over.
+ *********************************************************************/
+static EbErrorType svt_system_resource_resubmit(EbObjectWrapper *object_ptr) {
+    const EbSystemResource *resource_ptr = object_ptr->system_resource_ptr;
+
+    if (resource_ptr->full_queue->stage_stats)
+        object_ptr->post_time = svt_stage_stats_post(resource_ptr->full_queue->stage_stats);
+    return svt_system_resource_queue_task(object_ptr);
+}
+
+/*********************************************************************
+ * svt_post_full_object
+ *   Queues a full EbObjectWrapper to the consumer fifos of its
+ *   SystemResource, or submits it as a task when the resource is
+ *   attached to a thread pool.
+ *********************************************************************/
+EbErrorType svt_post_full_object(EbObjectWrapper *object_ptr) {
+    const EbSystemResource *resource_ptr = object_ptr->system_resource_ptr;
+
+    if (resource_ptr->full_queue && resource_ptr->full_queue->stage_stats)
+        object_ptr->post_time = svt_stage_stats_post(resource_ptr->full_queue->stage_stats);
+    if (resource_ptr->thread_pool)
+        return svt_system_resource_queue_task(object_ptr);
+    return svt_full_queue_post(object_ptr);
+}
+
+EbBool svt_get_output_object(EbFifo *empty_fifo_ptr, EbObjectWrapper *input_wrapper_ptr,
+                             EbObjectWrapper **wrapper_dbl_ptr) {
+    if (!input_wrapper_ptr->system_resource_ptr->thread_pool) {
+        svt_get_empty_object(empty_fifo_ptr, wrapper_dbl_ptr);
+        return EB_TRUE;
+    }
+    svt_get_empty_object_non_blocking(empty_fifo_ptr, wrapper_dbl_ptr);
+    if (*wrapper_dbl_ptr)
+        return EB_TRUE;
+    input_wrapper_ptr->blocked_queue_ptr = empty_fifo_ptr->queue_ptr;
+    return EB_FALSE;
+}
+
+EbErrorType svt_park_full_object(EbObjectWrapper *object_ptr) {
+    EbMuxingQueue *queue_ptr = object_ptr->blocked_queue_ptr;
+    EbBool         parked;
+
+    // Once parked the object belongs to the thread that wakes it
+    object_ptr->blocked_queue_ptr = NULL;
+    // An object released since the failed get found no parked task to
+    // wake, so the task runs again at once instead
+    svt_block_on_mutex(queue_ptr->lockout_mutex);
+    parked = !svt_muxing_queue_has_object(queue_ptr);
+    if (parked)
+        svt_object_list_push(&queue_ptr->parked_head_ptr, &queue_ptr->parked_tail_ptr, object_ptr);
+    svt_release_mutex(queue_ptr->lockout_mutex);
+    if (!parked)
+        return svt_system_resource_resubmit(object_ptr);
+    return EB_ErrorNone;
+}
@@ -14,6 +14,8 @@
 #define EbSystemResource_h
 
 #include "EbObject.h"
+#include "EbThreadPool.h"
+#include "EbPipelineStats.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -52,8 +54,19 @@ typedef struct EbObjectWrapper {
     // next_ptr - a pointer to a different EbObjectWrapper.  Used
     //   only in the implemenation of a single-linked Fifo.
     struct EbObjectWrapper *next_ptr;
+
+    // post_time - time the object was posted to the full queue, only
+    //   set when the consumer stage has stage_stats.
+    uint64_t post_time;
+
+    // blocked_queue_ptr - the empty queue in which the pool task
+    //   consuming this object found no object, set by
+    //   svt_get_output_object for svt_park_full_object.
+    struct EbMuxingQueue *blocked_queue_ptr;
 } EbObjectWrapper;
 
+typedef void (*EbObjectReleaseFn)(EbPtr context_ptr, EbObjectWrapper *wrapper_ptr);
+
 /*********************************************************************
      * Fifo
      *   Defines a static (i.e. no dynamic memory allocation) single
@@ -64,6 +77,7 @@ typedef struct EbObjectWrapper {
      *********************************************************************/
 typedef struct EbFifo {
     EbDctor dctor;
+#if !EN_LOCKFREE_FIFO
     // counting_semaphore - used for OS thread-blocking & dynamically
     //   counting the number of EbObjectWrappers currently in the
     //   EbFifo.
@@ -78,6 +92,7 @@ typedef struct EbFifo {
 
     // last_ptr - pointer to the tail of the Fifo
     EbObjectWrapper *last_ptr;
+#endif
 
     // quit_signal - a flag that main thread sets to break out from kernels
     EbBool quit_signal;
@@ -85,6 +100,9 @@ typedef struct EbFifo {
     // queue_ptr - pointer to MuxingQueue that the EbFifo is
     //   associated with.
     struct EbMuxingQueue *queue_ptr;
+
+    // process_index - index of the EbFifo in its MuxingQueue
+    uint32_t process_index;
 } EbFifo;
 
 /*********************************************************************
@@ -99,16 +117,59 @@ typedef struct EbCircularBuffer {
     uint32_t current_count;
 } EbCircularBuffer;
 
+#if EN_LOCKFREE_FIFO
+/*********************************************************************
+     * RingCell
+     *   One slot of the bounded lock-free ring. sequence tells producers
+     *   and consumers whether the slot is free or holds a published
+     *   EbObjectWrapper for the current lap of the ring.
+     *********************************************************************/
+typedef struct EbRingCell {
+    volatile uint32_t sequence;
+    EbObjectWrapper * wrapper_ptr;
+} EbRingCell;
+
+#define EB_CACHE_LINE_SIZE 64
+#endif
+
 /*********************************************************************
      * MuxingQueue
+     *   With EN_LOCKFREE_FIFO the process fifos of a queue share a
+     *   bounded multi-producer/multi-consumer ring. ready_count counts
+     *   the published objects, waiters spin on it and only park on
+     *   park_semaphore when it stays empty.
      *********************************************************************/
 typedef struct EbMuxingQueue {
     EbDctor           dctor;
     EbHandle          lockout_mutex;
+#if EN_LOCKFREE_FIFO
+    EbRingCell *cell_array;
+    uint32_t    cell_mask;
+    EbHandle    park_semaphore;
+    uint8_t     pad0[EB_CACHE_LINE_SIZE];
+    volatile uint32_t enqueue_pos;
+    uint8_t           pad1[EB_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    volatile uint32_t dequeue_pos;
+    uint8_t           pad2[EB_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    volatile int32_t  ready_count;
+    uint8_t           pad3[EB_CACHE_LINE_SIZE - sizeof(int32_t)];
+#else
     EbCircularBuffer *object_queue;
     EbCircularBuffer *process_queue;
+#endif
     uint32_t          process_total_count;
     EbFifo **         process_fifo_ptr_array;
+
+    // parked_head_ptr - full objects of the pool tasks waiting for an
+    //   object of this queue, oldest first, linked by next_ptr and
+    //   guarded by lockout_mutex. Every object pushed back resubmits
+    //   the oldest one.
+    EbObjectWrapper *parked_head_ptr;
+    EbObjectWrapper *parked_tail_ptr;
+
+    // stage_stats - when set, the timing of the objects going through
+    //   the queue is recorded, per process fifo.
+    EbStageStats *stage_stats;
 } EbMuxingQueue;
 
 /*********************************************************************
@@ -135,6 +196,40 @@ typedef struct EbSystemResource {
 
     // The full FIFO contains a queue of completed buffers
     EbMuxingQueue *full_queue;
+
+    // thread_pool - when set, posted full objects are executed as
+    //   pool_task_fn tasks instead of being queued for consumer threads,
+    //   submitted through pool_client when the resource has one.
+    EbThreadPool *thread_pool;
+    EbPoolClient *pool_client;
+    EbPoolTaskFn  pool_task_fn;
+    EbPtr *       pool_context_array;
+
+    // free_context_array - stack of the indices of the pool_context_array
+    //   entries no task is running on, free_context_count entries deep.
+    //   The objects posted while every context is in use wait in the
+    //   context_wait list, oldest first, linked by next_ptr; a task
+    //   returning its context resubmits the oldest one. Both are guarded
+    //   by context_mutex.
+    uint32_t *        free_context_array;
+    uint32_t          free_context_count;
+    EbObjectWrapper * context_wait_head_ptr;
+    EbObjectWrapper * context_wait_tail_ptr;
+    EbHandle          context_mutex;
+
+    // release_fn - when set, called with release_context_ptr for every
+    //   object returning to the empty queue, before it can be reused.
+    EbObjectReleaseFn release_fn;
+    EbPtr             release_context_ptr;
+
+    // object_bytes - bytes allocated by the construction of the first
+    //   object, the footprint of every object of the resource.
+    size_t object_bytes;
+
+    // in_use_count - objects taken from the empty queue and not released
+    //   yet, peak_in_use_count its maximum since the construction.
+    volatile int32_t in_use_count;
+    volatile int32_t peak_in_use_count;
 } EbSystemResource;
 
 /*********************************************************************
@@ -218,6 +313,19 @@ extern EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr,
                                             EbCreator object_ctor, EbPtr object_init_data_ptr,
                                             EbDctor object_destroyer);
 
+/*********************************************************************
+     * svt_system_resource_budget_ctor
+     *   Constructs an EbSystemResource of min_count to max_count objects.
+     *   The objects past min_count are only constructed while the
+     *   footprint of the resource stays within byte_limit, the footprint
+     *   of an object being measured on the first one. object_total_count
+     *   holds the resulting count.
+     *********************************************************************/
+extern EbErrorType svt_system_resource_budget_ctor(
+    EbSystemResource *resource_ptr, uint32_t min_count, uint32_t max_count, size_t byte_limit,
+    uint32_t producer_process_total_count, uint32_t consumer_process_total_count,
+    EbCreator object_ctor, EbPtr object_init_data_ptr, EbDctor object_destroyer);
+
 /*********************************************************************
      * svt_system_resource_get_producer_fifo
      *   get producer fifo
@@ -242,6 +350,60 @@ EbFifo *svt_system_resource_get_producer_fifo(const EbSystemResource *resource_p
      */
 EbFifo *svt_system_resource_get_consumer_fifo(const EbSystemResource *resource_ptr, uint32_t index);
 
+/*********************************************************************
+     * svt_system_resource_attach_thread_pool
+     *   Routes every object posted to the full queue of the resource to
+     *   pool_ptr. The consumer stage then runs as task_fn on whichever
+     *   worker picks the object up, with a context_array entry no other
+     *   task is using, and owns the release of the object as a consumer
+     *   thread would. An object finding every context in use waits on
+     *   the resource until a task returns its context.
+     *   Must be called before the first object is posted.
+     *
+     *   context_array
+     *     the consumer contexts, one per consumer fifo of the resource,
+     *     whatever the worker count of the pool
+     *********************************************************************/
+extern EbErrorType svt_system_resource_attach_thread_pool(EbSystemResource *resource_ptr,
+                                                          EbThreadPool *    pool_ptr,
+                                                          EbPoolTaskFn      task_fn,
+                                                          EbPtr *           context_array);
+
+/*********************************************************************
+     * svt_system_resource_attach_pool_client
+     *   svt_system_resource_attach_thread_pool to the pool of client_ptr,
+     *   the tasks are submitted at the priority of the client and count
+     *   as its pending tasks.
+     *********************************************************************/
+extern EbErrorType svt_system_resource_attach_pool_client(EbSystemResource *resource_ptr,
+                                                          EbPoolClient *    client_ptr,
+                                                          EbPoolTaskFn      task_fn,
+                                                          EbPtr *           context_array);
+
+/*********************************************************************
+     * svt_system_resource_set_release_callback
+     *   Installs release_fn, called by the thread dropping the last
+     *   reference to an object of the resource, before the object is
+     *   queued as empty. It lets objects that borrow memory hand it back
+     *   to its owner. Must be called before the first object is taken.
+     *********************************************************************/
+extern EbErrorType svt_system_resource_set_release_callback(EbSystemResource *resource_ptr,
+                                                            EbObjectReleaseFn release_fn,
+                                                            EbPtr             context_ptr);
+
+/*********************************************************************
+     * svt_system_resource_attach_stats
+     *   Creates the stage_name stats of the consumers of the resource in
+     *   pipeline_ptr. The consumer fifos, or the consumer contexts when
+     *   the resource is attached to a thread pool, are the stage threads.
+     *   picture_fn, when set, gives the picture number of an object for
+     *   the trace. Must be called before the first object is posted.
+     *********************************************************************/
+extern EbErrorType svt_system_resource_attach_stats(EbSystemResource *resource_ptr,
+                                                    EbPipelineStats * pipeline_ptr,
+                                                    const char *      stage_name,
+                                                    EbStagePictureFn  picture_fn);
+
 /*********************************************************************
      * EbSystemResourceGetEmptyObject
      *   Dequeues an empty EbObjectWrapper from the SystemResource.  The
@@ -260,6 +422,37 @@ EbFifo *svt_system_resource_get_consumer_fifo(const EbSystemResource *resource_p
      *********************************************************************/
 extern EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr);
 
+/*********************************************************************
+     * svt_get_empty_object_non_blocking
+     *   svt_get_empty_object that returns a NULL wrapper instead of
+     *   blocking when no empty object can be handed out at once.
+     *********************************************************************/
+extern EbErrorType svt_get_empty_object_non_blocking(EbFifo *          empty_fifo_ptr,
+                                                     EbObjectWrapper **wrapper_dbl_ptr);
+
+/*********************************************************************
+     * svt_get_output_object
+     *   Gets an empty object of empty_fifo_ptr for the stage consuming
+     *   input_wrapper_ptr. A consumer thread blocks as with
+     *   svt_get_empty_object. A stage running as thread pool tasks must
+     *   not hold a worker, so when the fifo has no empty object it gets
+     *   EB_FALSE: the task then records how far it got in the input
+     *   object, hands it to svt_park_full_object and returns.
+     *********************************************************************/
+extern EbBool svt_get_output_object(EbFifo *empty_fifo_ptr, EbObjectWrapper *input_wrapper_ptr,
+                                    EbObjectWrapper **wrapper_dbl_ptr);
+
+/*********************************************************************
+     * svt_park_full_object
+     *   Parks the input object of a pool task on the empty queue that
+     *   svt_get_output_object found empty. The object is resubmitted
+     *   when an object is released to that queue, or at once if one
+     *   was released in the meantime, and the task then runs again from
+     *   the start and resumes from the state it recorded in the object.
+     *   No worker runs the task while it is parked.
+     *********************************************************************/
+extern EbErrorType svt_park_full_object(EbObjectWrapper *object_ptr);
+
 /*********************************************************************
      * EbSystemResourcePostObject
      *   Queues a full EbObjectWrapper to the SystemResource. This
@@ -0,0 +1,551 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#include <stdlib.h>
+
+#include "EbThreadPool.h"
+#include "EbThreads.h"
+#include "EbTime.h"
+
+#ifdef _WIN32
+#define EB_THREAD_LOCAL __declspec(thread)
+#else
+#define EB_THREAD_LOCAL __thread
+#endif
+
+// Worker running on the calling thread, NULL for threads outside any pool
+static EB_THREAD_LOCAL EbPoolWorker *current_worker_ptr = NULL;
+
+static EbPoolTaskArray *svt_pool_task_array_alloc(uint32_t capacity) {
+    EbPoolTaskArray *array_ptr =
+        (EbPoolTaskArray *)malloc(sizeof(EbPoolTaskArray) + (capacity - 1) * sizeof(EbPoolTask));
+    if (array_ptr) {
+        array_ptr->retired_ptr = NULL;
+        array_ptr->mask        = capacity - 1;
+    }
+    return array_ptr;
+}
+
+static EbErrorType svt_pool_deque_ctor(EbPoolDeque *deque_ptr, uint32_t capacity) {
+    uint32_t length = 16;
+
+    while (length < capacity) length <<= 1;
+    deque_ptr->top       = 0;
+    deque_ptr->bottom    = 0;
+    deque_ptr->array_ptr = svt_pool_task_array_alloc(length);
+    return deque_ptr->array_ptr ? EB_ErrorNone : EB_ErrorInsufficientResources;
+}
+
+static void svt_pool_deque_dctor(EbPoolDeque *deque_ptr) {
+    EbPoolTaskArray *array_ptr = deque_ptr->array_ptr;
+
+    while (array_ptr) {
+        EbPoolTaskArray *retired_ptr = array_ptr->retired_ptr;
+        free(array_ptr);
+        array_ptr = retired_ptr;
+    }
+    deque_ptr->array_ptr = NULL;
+}
+
+/*********************************************************************
+ * svt_pool_deque_push
+ *   Owner only. Publishes the task at the bottom, in a ring twice as
+ *   long when the current one is full.
+ *********************************************************************/
+static EbBool svt_pool_deque_push(EbPoolDeque *deque_ptr, const EbPoolTask *task_ptr) {
+    const int64_t    bottom = svt_atomic_load_i64(&deque_ptr->bottom);
+    const int64_t    top    = svt_atomic_load_i64(&deque_ptr->top);
+    EbPoolTaskArray *array_ptr =
+        (EbPoolTaskArray *)svt_atomic_load_ptr((void *volatile *)&deque_ptr->array_ptr);
+
+    if (bottom - top > (int64_t)array_ptr->mask) {
+        EbPoolTaskArray *grown_ptr = svt_pool_task_array_alloc(2 * (array_ptr->mask + 1));
+        if (!grown_ptr)
+            return EB_FALSE;
+        for (int64_t i = top; i < bottom; i++)
+            grown_ptr->task_array[i & grown_ptr->mask] = array_ptr->task_array[i & array_ptr->mask];
+        grown_ptr->retired_ptr = array_ptr;
+        svt_atomic_store_ptr((void *volatile *)&deque_ptr->array_ptr, grown_ptr);
+        array_ptr = grown_ptr;
+    }
+    array_ptr->task_array[bottom & array_ptr->mask] = *task_ptr;
+    svt_atomic_store_i64(&deque_ptr->bottom, bottom + 1);
+    return EB_TRUE;
+}
+
+/*********************************************************************
+ * svt_pool_deque_pop
+ *   Owner only. Takes the newest task; the last one is raced for with
+ *   the thieves through top.
+ *********************************************************************/
+static EbBool svt_pool_deque_pop(EbPoolDeque *deque_ptr, EbPoolTask *task_ptr) {
+    const int64_t    bottom = svt_atomic_load_i64(&deque_ptr->bottom) - 1;
+    EbPoolTaskArray *array_ptr =
+        (EbPoolTaskArray *)svt_atomic_load_ptr((void *volatile *)&deque_ptr->array_ptr);
+    EbBool taken = EB_TRUE;
+
+    svt_atomic_store_i64(&deque_ptr->bottom, bottom);
+    const int64_t top = svt_atomic_load_i64(&deque_ptr->top);
+    if (top > bottom) {
+        svt_atomic_store_i64(&deque_ptr->bottom, bottom + 1);
+        return EB_FALSE;
+    }
+    *task_ptr = array_ptr->task_array[bottom & array_ptr->mask];
+    if (top == bottom) {
+        taken = svt_atomic_cas_i64(&deque_ptr->top, top, top + 1);
+        svt_atomic_store_i64(&deque_ptr->bottom, bottom + 1);
+    }
+    return taken;
+}
+
+/*********************************************************************
+ * svt_pool_deque_steal
+ *   Any worker. Takes the oldest task; fails when the deque is empty or
+ *   another worker took that task first.
+ *********************************************************************/
+static EbBool svt_pool_deque_steal(EbPoolDeque *deque_ptr, EbPoolTask *task_ptr) {
+    const int64_t top    = svt_atomic_load_i64(&deque_ptr->top);
+    const int64_t bottom = svt_atomic_load_i64(&deque_ptr->bottom);
+
+    if (top >= bottom)
+        return EB_FALSE;
+    EbPoolTaskArray *array_ptr =
+        (EbPoolTaskArray *)svt_atomic_load_ptr((void *volatile *)&deque_ptr->array_ptr);
+    // The copy is only used when the claim of top succeeds, i.e. when the
+    // owner could not have reused its cell
+    *task_ptr = array_ptr->task_array[top & array_ptr->mask];
+    return svt_atomic_cas_i64(&deque_ptr->top, top, top + 1);
+}
+
+static void svt_pool_queue_push_nodes(EbPoolQueue *queue_ptr, EbPoolTaskNode *first_ptr,
+                                      EbPoolTaskNode *last_ptr) {
+    EbPoolTaskNode *head_ptr;
+
+    do {
+        head_ptr           = (EbPoolTaskNode *)svt_atomic_load_ptr(
+            (void *volatile *)&queue_ptr->inject_head_ptr);
+        last_ptr->next_ptr = head_ptr;
+    } while (!svt_atomic_cas_ptr(
+        (void *volatile *)&queue_ptr->inject_head_ptr, head_ptr, first_ptr));
+}
+
+/*********************************************************************
+ * svt_pool_queue_drain
+ *   Empties the inject list of the queue, takes its oldest task and
+ *   moves the others to the deque of the worker.
+ *********************************************************************/
+static EbBool svt_pool_queue_drain(EbPoolQueue *queue_ptr, uint32_t worker_index,
+                                   EbPoolTask *task_ptr) {
+    EbPoolTaskNode *node_ptr = (EbPoolTaskNode *)svt_atomic_exchange_ptr(
+        (void *volatile *)&queue_ptr->inject_head_ptr, NULL);
+    EbPoolTaskNode *oldest_ptr = NULL;
+
+    if (!node_ptr)
+        return EB_FALSE;
+    // The list is newest first
+    while (node_ptr) {
+        EbPoolTaskNode *next_ptr = node_ptr->next_ptr;
+        node_ptr->next_ptr       = oldest_ptr;
+        oldest_ptr               = node_ptr;
+        node_ptr                 = next_ptr;
+    }
+    *task_ptr = oldest_ptr->task;
+    node_ptr  = oldest_ptr->next_ptr;
+    free(oldest_ptr);
+    while (node_ptr) {
+        if (!svt_pool_deque_push(&queue_ptr->deque_array[worker_index], &node_ptr->task)) {
+            // Out of memory, the other workers take them from the list
+            EbPoolTaskNode *last_ptr = node_ptr;
+            while (last_ptr->next_ptr) last_ptr = last_ptr->next_ptr;
+            svt_pool_queue_push_nodes(queue_ptr, node_ptr, last_ptr);
+            break;
+        }
+        EbPoolTaskNode *next_ptr = node_ptr->next_ptr;
+        free(node_ptr);
+        node_ptr = next_ptr;
+    }
+    return EB_TRUE;
+}
+
+static EbBool svt_pool_queue_reserve(EbPoolQueue *queue_ptr) {
+    int32_t count = svt_atomic_load_i32(&queue_ptr->queued_count);
+
+    while (count > 0) {
+        if (svt_atomic_cas_i32(&queue_ptr->queued_count, count, count - 1))
+            return EB_TRUE;
+        count = svt_atomic_load_i32(&queue_ptr->queued_count);
+    }
+    return EB_FALSE;
+}
+
+/*********************************************************************
+ * svt_thread_pool_reserve
+ *   Claims one queued task of the highest priority that has any, from
+ *   the queue of that priority with the least vruntime, and returns
+ *   that queue. Every semaphore wake-up follows a push, so such a task
+ *   exists; a scan misses it only when other workers claimed the tasks
+ *   it saw first, and each miss means one of them made progress, so it
+ *   rescans right away.
+ *********************************************************************/
+static EbPoolQueue *svt_thread_pool_reserve(EbThreadPool *pool_ptr, EbPoolWorker *worker_ptr) {
+    for (;;) {
+        for (int32_t priority = POOL_PRIORITY_COUNT - 1; priority >= 0; priority--) {
+            if (svt_atomic_load_i32(&pool_ptr->queued_count[priority]) <= 0)
+                continue;
+            const uint32_t queue_count = svt_atomic_load_u32(&pool_ptr->queue_count);
+            EbPoolQueue *  best_ptr    = NULL;
+            int64_t        best_vruntime = 0;
+            uint32_t       best_index    = 0;
+            // Ties go to the queue after the last one the worker picked
+            for (uint32_t i = 0; i < queue_count; i++) {
+                const uint32_t index     = (worker_ptr->next_queue + i) % queue_count;
+                EbPoolQueue *  queue_ptr = pool_ptr->queue_array[index];
+                if (queue_ptr->priority != (uint32_t)priority ||
+                    svt_atomic_load_i32(&queue_ptr->queued_count) <= 0)
+                    continue;
+                const int64_t vruntime = svt_atomic_load_i64(&queue_ptr->vruntime);
+                if (!best_ptr || vruntime < best_vruntime) {
+                    best_ptr      = queue_ptr;
+                    best_vruntime = vruntime;
+                    best_index    = index;
+                }
+            }
+            if (!best_ptr)
+                continue;
+            if (!svt_pool_queue_reserve(best_ptr))
+                break;
+            svt_atomic_fetch_add_i32(&pool_ptr->queued_count[priority], -1);
+            worker_ptr->next_queue = best_index + 1;
+            int64_t min_vruntime = svt_atomic_load_i64(&pool_ptr->min_vruntime);
+            while (min_vruntime < best_vruntime &&
+                   !svt_atomic_cas_i64(&pool_ptr->min_vruntime, min_vruntime, best_vruntime))
+                min_vruntime = svt_atomic_load_i64(&pool_ptr->min_vruntime);
+            return best_ptr;
+        }
+    }
+}
+
+/*********************************************************************
+ * svt_pool_queue_charge
+ *   Adds the run time of a task of the queue, scaled by its weight, to
+ *   its vruntime.
+ *********************************************************************/
+static void svt_pool_queue_charge(EbPoolQueue *queue_ptr, uint64_t start_seconds,
+                                  uint64_t start_useconds) {
+    uint64_t finish_seconds, finish_useconds;
+
+    svt_av1_get_time(&finish_seconds, &finish_useconds);
+    // One more us per task keeps coarse clocks charging something
+    const int64_t run_time = (int64_t)((finish_seconds - start_seconds) * 1000000 +
+                                       finish_useconds - start_useconds) +
+        1;
+    const int64_t charge = run_time * POOL_WEIGHT_DEFAULT / queue_ptr->weight;
+    int64_t       vruntime = svt_atomic_load_i64(&queue_ptr->vruntime);
+    while (!svt_atomic_cas_i64(&queue_ptr->vruntime, vruntime, vruntime + charge))
+        vruntime = svt_atomic_load_i64(&queue_ptr->vruntime);
+}
+
+/*********************************************************************
+ * svt_thread_pool_take
+ *   Finds the task reserved in queue_ptr: the newest of the own deque,
+ *   the oldest of the inject list, or the oldest of a victim deque.
+ *   A task being published or raced for by its owner is missed for a
+ *   moment, so the sources are scanned until the task turns up.
+ *********************************************************************/
+static void svt_thread_pool_take(EbThreadPool *pool_ptr, EbPoolQueue *queue_ptr,
+                                 uint32_t worker_index, EbPoolTask *task_ptr) {
+    for (;;) {
+        if (svt_pool_deque_pop(&queue_ptr->deque_array[worker_index], task_ptr))
+            return;
+        if (svt_pool_queue_drain(queue_ptr, worker_index, task_ptr))
+            return;
+        for (uint32_t i = 1; i < pool_ptr->worker_count; i++) {
+            EbPoolDeque *victim_ptr =
+                &queue_ptr->deque_array[(worker_index + i) % pool_ptr->worker_count];
+            if (svt_pool_deque_steal(victim_ptr, task_ptr))
+                return;
+        }
+    }
+}
+
+/*********************************************************************
+ * svt_pool_client_complete
+ *   Accounts for a returned task of the client and wakes its destructor
+ *   when that was the last pending one.
+ *********************************************************************/
+static void svt_pool_client_complete(EbPoolClient *client_ptr) {
+    EbBool wake;
+
+    if (svt_atomic_fetch_add_i32(&client_ptr->pending_count, -1) != 1)
+        return;
+    svt_block_on_mutex(client_ptr->idle_mutex);
+    wake = client_ptr->waiting && !svt_atomic_load_i32(&client_ptr->pending_count);
+    if (wake)
+        client_ptr->waiting = EB_FALSE;
+    svt_release_mutex(client_ptr->idle_mutex);
+    if (wake)
+        svt_post_semaphore(client_ptr->idle_semaphore);
+}
+
+static void *svt_thread_pool_kernel(void *input_ptr) {
+    EbPoolWorker *worker_ptr = (EbPoolWorker *)input_ptr;
+    EbThreadPool *pool_ptr   = worker_ptr->pool_ptr;
+    EbPoolTask    task;
+
+    current_worker_ptr = worker_ptr;
+    for (;;) {
+        svt_block_on_semaphore(pool_ptr->task_semaphore);
+        if (svt_atomic_load_u32(&pool_ptr->quit_signal))
+            break;
+        EbPoolQueue *queue_ptr = svt_thread_pool_reserve(pool_ptr, worker_ptr);
+        svt_thread_pool_take(pool_ptr, queue_ptr, worker_ptr->index, &task);
+        uint64_t start_seconds, start_useconds;
+        svt_av1_get_time(&start_seconds, &start_useconds);
+        task.task_fn(task.context_array ? task.context_array[worker_ptr->index] : NULL,
+                     task.data_ptr);
+        // Before the completion, a detached queue may be handed out again
+        svt_pool_queue_charge(queue_ptr, start_seconds, start_useconds);
+        if (task.client_ptr)
+            svt_pool_client_complete(task.client_ptr);
+    }
+    return NULL;
+}
+
+static void svt_pool_queue_dctor(EbThreadPool *pool_ptr, EbPoolQueue *queue_ptr) {
+    EbPoolTaskNode *node_ptr = queue_ptr->inject_head_ptr;
+
+    while (node_ptr) {
+        EbPoolTaskNode *next_ptr = node_ptr->next_ptr;
+        free(node_ptr);
+        node_ptr = next_ptr;
+    }
+    if (queue_ptr->deque_array) {
+        for (uint32_t i = 0; i < pool_ptr->worker_count; i++)
+            svt_pool_deque_dctor(&queue_ptr->deque_array[i]);
+        EB_FREE_ARRAY(queue_ptr->deque_array);
+    }
+    EB_FREE(queue_ptr);
+}
+
+/*********************************************************************
+ * svt_thread_pool_attach_queue
+ *   Hands out a detached queue of the pool, or a new one, to a client
+ *   of priority. Must be called with the client mutex held.
+ *********************************************************************/
+static EbErrorType svt_thread_pool_attach_queue(EbThreadPool *pool_ptr, uint32_t priority,
+                                                uint32_t weight, uint32_t task_capacity,
+                                                EbPoolQueue **queue_dbl_ptr) {
+    EbPoolQueue *queue_ptr;
+
+    for (uint32_t i = 0; i < pool_ptr->queue_count; i++) {
+        queue_ptr = pool_ptr->queue_array[i];
+        if (!queue_ptr->attached) {
+            queue_ptr->priority = priority;
+            queue_ptr->weight   = weight;
+            svt_atomic_store_i64(&queue_ptr->vruntime,
+                                 svt_atomic_load_i64(&pool_ptr->min_vruntime));
+            svt_atomic_store_u32(&queue_ptr->attached, 1);
+            *queue_dbl_ptr = queue_ptr;
+            return EB_ErrorNone;
+        }
+    }
+    if (pool_ptr->queue_count == POOL_MAX_QUEUES)
+        return EB_ErrorInsufficientResources;
+    // Left by a creation that failed
+    if (pool_ptr->queue_array[pool_ptr->queue_count])
+        svt_pool_queue_dctor(pool_ptr, pool_ptr->queue_array[pool_ptr->queue_count]);
+
+    EB_CALLOC(queue_ptr, 1, sizeof(EbPoolQueue));
+    pool_ptr->queue_array[pool_ptr->queue_count] = queue_ptr;
+    EB_CALLOC_ARRAY(queue_ptr->deque_array, pool_ptr->worker_count);
+    // The tasks of a client spread over the workers, the deques grow when
+    // they do not
+    const uint32_t capacity = task_capacity / pool_ptr->worker_count;
+    for (uint32_t i = 0; i < pool_ptr->worker_count; i++) {
+        EbErrorType return_error = svt_pool_deque_ctor(&queue_ptr->deque_array[i], capacity);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
+    queue_ptr->priority = priority;
+    queue_ptr->weight   = weight;
+    queue_ptr->vruntime = svt_atomic_load_i64(&pool_ptr->min_vruntime);
+    queue_ptr->attached = 1;
+    // Published once complete, the workers scan the queues lock-free
+    svt_atomic_store_u32(&pool_ptr->queue_count, pool_ptr->queue_count + 1);
+    *queue_dbl_ptr = queue_ptr;
+    return EB_ErrorNone;
+}
+
+static void svt_thread_pool_dctor(EbPtr p) {
+    EbThreadPool *obj = (EbThreadPool *)p;
+
+    if (obj->worker_array) {
+        svt_atomic_store_u32(&obj->quit_signal, 1);
+        for (uint32_t i = 0; i < obj->worker_count; i++)
+            if (obj->worker_array[i].thread_handle)
+                svt_post_semaphore(obj->task_semaphore);
+        for (uint32_t i = 0; i < obj->worker_count; i++)
+            EB_DESTROY_THREAD(obj->worker_array[i].thread_handle);
+    }
+    // A queue whose creation failed is not counted but still stored
+    for (uint32_t i = 0; i < POOL_MAX_QUEUES && obj->queue_array[i]; i++)
+        svt_pool_queue_dctor(obj, obj->queue_array[i]);
+    EB_FREE_ARRAY(obj->worker_array);
+    EB_DESTROY_MUTEX(obj->client_mutex);
+    EB_DESTROY_SEMAPHORE(obj->task_semaphore);
+}
+
+EbErrorType svt_thread_pool_ctor(EbThreadPool *pool_ptr, uint32_t worker_count,
+                                 uint32_t task_capacity) {
+    EbPoolQueue *queue_ptr;
+
+    pool_ptr->dctor        = svt_thread_pool_dctor;
+    pool_ptr->worker_count = worker_count ? worker_count : 1;
+
+    EB_CREATE_SEMAPHORE(pool_ptr->task_semaphore, 0, ~0u >> 1);
+    EB_CREATE_MUTEX(pool_ptr->client_mutex);
+    EB_CALLOC_ARRAY(pool_ptr->worker_array, pool_ptr->worker_count);
+    for (uint32_t i = 0; i < pool_ptr->worker_count; i++) {
+        EbPoolWorker *worker_ptr = &pool_ptr->worker_array[i];
+        worker_ptr->pool_ptr     = pool_ptr;
+        worker_ptr->index        = i;
+    }
+    // Queue 0, of the tasks of svt_thread_pool_submit
+    EbErrorType return_error = svt_thread_pool_attach_queue(
+        pool_ptr, POOL_PRIORITY_NORMAL, POOL_WEIGHT_DEFAULT, task_capacity, &queue_ptr);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    // Start the workers once every deque exists, they steal from each other
+    for (uint32_t i = 0; i < pool_ptr->worker_count; i++) {
+        EbPoolWorker *worker_ptr = &pool_ptr->worker_array[i];
+        worker_ptr->thread_handle = svt_create_thread(svt_thread_pool_kernel, worker_ptr);
+        EB_ADD_MEM(worker_ptr->thread_handle, 1, EB_THREAD);
+    }
+    return EB_ErrorNone;
+}
+
+/*********************************************************************
+ * svt_thread_pool_push
+ *   Queues the task on the deque of the calling worker of this pool,
+ *   or on the inject list of the queue from any other thread, then
+ *   wakes a worker.
+ *********************************************************************/
+static EbErrorType svt_thread_pool_push(EbThreadPool *pool_ptr, EbPoolQueue *queue_ptr,
+                                        const EbPoolTask *task_ptr) {
+    EbPoolWorker *worker_ptr = current_worker_ptr;
+
+    if (!worker_ptr || worker_ptr->pool_ptr != pool_ptr ||
+        !svt_pool_deque_push(&queue_ptr->deque_array[worker_ptr->index], task_ptr)) {
+        EbPoolTaskNode *node_ptr = (EbPoolTaskNode *)malloc(sizeof(EbPoolTaskNode));
+        if (!node_ptr)
+            return EB_ErrorInsufficientResources;
+        node_ptr->task = *task_ptr;
+        svt_pool_queue_push_nodes(queue_ptr, node_ptr, node_ptr);
+    }
+    if (!svt_atomic_fetch_add_i32(&queue_ptr->queued_count, 1)) {
+        // An idle queue does not get to spend the time it did not use
+        const int64_t min_vruntime = svt_atomic_load_i64(&pool_ptr->min_vruntime);
+        int64_t       vruntime     = svt_atomic_load_i64(&queue_ptr->vruntime);
+        while (vruntime < min_vruntime &&
+               !svt_atomic_cas_i64(&queue_ptr->vruntime, vruntime, min_vruntime))
+            vruntime = svt_atomic_load_i64(&queue_ptr->vruntime);
+    }
+    svt_atomic_fetch_add_i32(&pool_ptr->queued_count[queue_ptr->priority], 1);
+    svt_post_semaphore(pool_ptr->task_semaphore);
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_thread_pool_submit(EbThreadPool *pool_ptr, EbPoolTaskFn task_fn,
+                                   EbPtr *context_array, void *data_ptr) {
+    EbPoolTask task;
+
+    task.task_fn       = task_fn;
+    task.context_array = context_array;
+    task.data_ptr      = data_ptr;
+    task.client_ptr    = NULL;
+    return svt_thread_pool_push(pool_ptr, pool_ptr->queue_array[0], &task);
+}
+
+static void svt_pool_client_dctor(EbPtr p) {
+    EbPoolClient *obj      = (EbPoolClient *)p;
+    EbThreadPool *pool_ptr = obj->pool_ptr;
+
+    if (pool_ptr) {
+        // The queued and running tasks still use the contexts of the client
+        svt_block_on_mutex(obj->idle_mutex);
+        EbBool waiting = svt_atomic_load_i32(&obj->pending_count) ? EB_TRUE : EB_FALSE;
+        obj->waiting   = waiting;
+        svt_release_mutex(obj->idle_mutex);
+        if (waiting)
+            svt_block_on_semaphore(obj->idle_semaphore);
+        // Its queue is empty now, the next client reuses it
+        svt_block_on_mutex(pool_ptr->client_mutex);
+        svt_atomic_store_u32(&obj->queue_ptr->attached, 0);
+        pool_ptr->client_count--;
+        svt_release_mutex(pool_ptr->client_mutex);
+    }
+    EB_DESTROY_SEMAPHORE(obj->idle_semaphore);
+    EB_DESTROY_MUTEX(obj->idle_mutex);
+}
+
+EbErrorType svt_pool_client_ctor(EbPoolClient *client_ptr, EbThreadPool *pool_ptr,
+                                 uint32_t priority, uint32_t weight, uint32_t task_capacity) {
+    EbErrorType return_error;
+
+    client_ptr->dctor = svt_pool_client_dctor;
+    if (!pool_ptr || priority >= POOL_PRIORITY_COUNT || !weight || weight > POOL_WEIGHT_MAX)
+        return EB_ErrorBadParameter;
+    EB_CREATE_MUTEX(client_ptr->idle_mutex);
+    EB_CREATE_SEMAPHORE(client_ptr->idle_semaphore, 0, 1);
+
+    svt_block_on_mutex(pool_ptr->client_mutex);
+    return_error = svt_thread_pool_attach_queue(
+        pool_ptr, priority, weight, task_capacity, &client_ptr->queue_ptr);
+    if (return_error == EB_ErrorNone)
+        pool_ptr->client_count++;
+    svt_release_mutex(pool_ptr->client_mutex);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+
+    client_ptr->pool_ptr = pool_ptr;
+    client_ptr->priority = priority;
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_pool_client_submit(EbPoolClient *client_ptr, EbPoolTaskFn task_fn,
+                                   EbPtr *context_array, void *data_ptr) {
+    EbPoolTask task;
+
+    task.task_fn       = task_fn;
+    task.context_array = context_array;
+    task.data_ptr      = data_ptr;
+    task.client_ptr    = client_ptr;
+    svt_atomic_fetch_add_i32(&client_ptr->pending_count, 1);
+    EbErrorType return_error =
+        svt_thread_pool_push(client_ptr->pool_ptr, client_ptr->queue_ptr, &task);
+    if (return_error != EB_ErrorNone)
+        svt_atomic_fetch_add_i32(&client_ptr->pending_count, -1);
+    return return_error;
+}
+
+static void svt_pool_fiber_task(void *context_ptr, void *data_ptr) {
+    (void)context_ptr;
+    svt_resume_fiber((EbHandle)data_ptr);
+}
+
+static void svt_pool_fiber_wake(void *wake_context, EbHandle fiber_handle) {
+    svt_pool_client_submit((EbPoolClient *)wake_context, svt_pool_fiber_task, NULL, fiber_handle);
+}
+
+EbHandle svt_pool_client_create_fiber(EbPoolClient *client_ptr, void *fiber_function(void *),
+                                      void *fiber_context) {
+    return svt_create_fiber(fiber_function, fiber_context, svt_pool_fiber_wake, client_ptr);
+}
@@ -0,0 +1,240 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbThreadPool_h
+#define EbThreadPool_h
+
+#include "EbDefinitions.h"
+#include "EbObject.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+     * EbPoolTaskFn
+     *   Entry point of a pool task. context_ptr is the entry of the
+     *   submitted context array owned by the executing worker, or NULL
+     *   when the task was submitted without a context array. The tasks
+     *   of a system resource are submitted that way: they take a free
+     *   consumer context of the channel instead, see
+     *   svt_system_resource_attach_thread_pool.
+     *********************************************************************/
+typedef void (*EbPoolTaskFn)(void *context_ptr, void *data_ptr);
+
+/*********************************************************************
+     * Pool Priorities and Weights
+     *   A worker runs a task of a lower priority only when no client of
+     *   the pool has a task of a higher one queued. Among the clients of
+     *   a priority, it picks the one that ran the least time per unit of
+     *   weight, so busy clients share the workers in proportion to their
+     *   weights.
+     *********************************************************************/
+#define POOL_PRIORITY_LOW 0
+#define POOL_PRIORITY_NORMAL 1
+#define POOL_PRIORITY_HIGH 2
+#define POOL_PRIORITY_COUNT 3
+#define POOL_WEIGHT_DEFAULT 100
+#define POOL_WEIGHT_MAX 10000
+
+// Clients attached to a pool at once, svt_thread_pool_submit included
+#define POOL_MAX_QUEUES 256
+
+typedef struct EbPoolTask {
+    EbPoolTaskFn          task_fn;
+    EbPtr *               context_array;
+    void *                data_ptr;
+    struct EbPoolClient * client_ptr; // NULL for svt_thread_pool_submit tasks
+} EbPoolTask;
+
+/*********************************************************************
+     * Task Array
+     *   Ring of a deque, a power of two tasks long. A full ring is
+     *   replaced by one twice as long; the replaced rings stay readable
+     *   by the thieves that loaded them until the deque is destroyed.
+     *********************************************************************/
+typedef struct EbPoolTaskArray {
+    struct EbPoolTaskArray *retired_ptr; // ring this one replaced
+    uint32_t                mask;
+    EbPoolTask              task_array[1];
+} EbPoolTaskArray;
+
+/*********************************************************************
+     * Pool Deque
+     *   Lock-free work-stealing deque (Chase and Lev). Only its worker
+     *   pushes and pops at the bottom, newest first, which drains a
+     *   freshly produced downstream task while its input is still in
+     *   cache; any worker steals at the top, oldest first.
+     *********************************************************************/
+typedef struct EbPoolDeque {
+    volatile int64_t          top;
+    volatile int64_t          bottom;
+    EbPoolTaskArray *volatile array_ptr;
+} EbPoolDeque;
+
+/*********************************************************************
+     * Pool Task Node
+     *   Task submitted by a thread outside the pool, pushed on the
+     *   inject list of its queue until a worker moves it to its deque.
+     *********************************************************************/
+typedef struct EbPoolTaskNode {
+    EbPoolTask              task;
+    struct EbPoolTaskNode * next_ptr;
+} EbPoolTaskNode;
+
+/*********************************************************************
+     * Pool Queue
+     *   The tasks of one client: one deque per worker plus the inject
+     *   list of the submissions from outside the pool. Queues belong to
+     *   the pool and are recycled, never freed, while workers may scan
+     *   them; a detached client leaves its queue empty.
+     *   queued_count counts the published tasks that no worker has
+     *   claimed yet.
+     *********************************************************************/
+typedef struct EbPoolQueue {
+    EbPoolDeque *             deque_array;
+    EbPoolTaskNode *volatile  inject_head_ptr;
+    volatile int32_t          queued_count;
+    uint32_t                  priority;
+    uint32_t                  weight;
+    // run time of the tasks of the queue in us, scaled by
+    // POOL_WEIGHT_DEFAULT / weight
+    volatile int64_t          vruntime;
+    volatile uint32_t         attached;
+} EbPoolQueue;
+
+/*********************************************************************
+     * Pool Worker
+     *   One OS thread of the pool, its deque of every queue has the
+     *   index of the worker.
+     *********************************************************************/
+typedef struct EbPoolWorker {
+    struct EbThreadPool *pool_ptr;
+    uint32_t             index;
+    EbHandle             thread_handle;
+    uint32_t             next_queue; // where the scan of a priority starts
+} EbPoolWorker;
+
+/*********************************************************************
+     * Thread Pool
+     *   Work-stealing pool shared by the pipeline stages that are
+     *   attached to it, possibly of several encoder instances.
+     *   task_semaphore counts the submitted tasks that no worker has
+     *   claimed yet; a worker blocks on it while the pool is idle, and
+     *   after every wake-up it claims one queued task of the highest
+     *   priority that has any.
+     *   Queue 0 holds the tasks of svt_thread_pool_submit.
+     *   min_vruntime follows the vruntime of the queues the workers pick;
+     *   a queue getting tasks again after running dry starts from it
+     *   instead of the credit it built up while idle.
+     *********************************************************************/
+typedef struct EbThreadPool {
+    EbDctor           dctor;
+    uint32_t          worker_count;
+    EbPoolWorker *    worker_array;
+    EbHandle          task_semaphore;
+    EbHandle          client_mutex; // guards the attachment of the queues
+    uint32_t          deque_capacity; // initial ring length of a deque
+    uint32_t          client_count;
+    EbPoolQueue *     queue_array[POOL_MAX_QUEUES];
+    volatile uint32_t queue_count; // queues created so far
+    // tasks queued at every priority, not claimed yet
+    volatile int32_t  queued_count[POOL_PRIORITY_COUNT];
+    volatile int64_t  min_vruntime;
+    volatile uint32_t quit_signal;
+} EbThreadPool;
+
+/*********************************************************************
+     * Pool Client
+     *   The tasks of one user of the pool, e.g. one encoder instance,
+     *   queued apart from the tasks of the other clients. Its destructor
+     *   blocks on idle_semaphore until its pending tasks complete so the
+     *   contexts they use can be freed next.
+     *********************************************************************/
+typedef struct EbPoolClient {
+    EbDctor          dctor;
+    EbThreadPool *   pool_ptr;
+    EbPoolQueue *    queue_ptr;
+    uint32_t         priority;
+    volatile int32_t pending_count; // submitted tasks that did not return yet
+    EbHandle         idle_mutex; // guards waiting against the last completion
+    EbHandle         idle_semaphore; // posted when pending_count drops to 0
+    EbBool           waiting; // the destructor blocks on idle_semaphore
+} EbPoolClient;
+
+/*********************************************************************
+     * svt_thread_pool_ctor
+     *   Creates worker_count workers. task_capacity is the number of
+     *   pending tasks (e.g. the total object count of the attached system
+     *   resources) the deques are first sized for; they grow on demand,
+     *   so a submission never has to wait for space.
+     *********************************************************************/
+extern EbErrorType svt_thread_pool_ctor(EbThreadPool *pool_ptr, uint32_t worker_count,
+                                        uint32_t task_capacity);
+
+/*********************************************************************
+     * svt_thread_pool_submit
+     *   Queues task_fn(context_array[worker], data_ptr) at the normal
+     *   priority and default weight, task_fn(NULL, data_ptr) when
+     *   context_array is NULL.
+     *   Submissions from a worker of this pool go to that worker's own
+     *   deque; those of any other thread to the inject list of the queue.
+     *********************************************************************/
+extern EbErrorType svt_thread_pool_submit(EbThreadPool *pool_ptr, EbPoolTaskFn task_fn,
+                                          EbPtr *context_array, void *data_ptr);
+
+/*********************************************************************
+     * svt_pool_client_ctor
+     *   Attaches a client of the given POOL_PRIORITY_* and weight, in
+     *   [1, POOL_WEIGHT_MAX], to pool_ptr, with deques first sized for
+     *   task_capacity pending tasks. Fails with
+     *   EB_ErrorInsufficientResources when POOL_MAX_QUEUES clients are
+     *   attached.
+     *********************************************************************/
+extern EbErrorType svt_pool_client_ctor(EbPoolClient *client_ptr, EbThreadPool *pool_ptr,
+                                        uint32_t priority, uint32_t weight,
+                                        uint32_t task_capacity);
+
+/*********************************************************************
+     * svt_pool_client_submit
+     *   svt_thread_pool_submit at the priority and weight of the client.
+     *********************************************************************/
+extern EbErrorType svt_pool_client_submit(EbPoolClient *client_ptr, EbPoolTaskFn task_fn,
+                                          EbPtr *context_array, void *data_ptr);
+
+/*********************************************************************
+     * svt_pool_client_create_fiber
+     *   Runs fiber_function(fiber_context), e.g. a stage kernel looping
+     *   over its input fifo, as tasks of the client: a fiber submitted at
+     *   creation, which gives its worker back whenever it blocks on a
+     *   semaphore or mutex and is submitted again by the post that
+     *   releases it. Destroy it with EB_DESTROY_FIBER before the client.
+     *********************************************************************/
+extern EbHandle svt_pool_client_create_fiber(EbPoolClient *client_ptr,
+                                             void *fiber_function(void *), void *fiber_context);
+
+#define EB_CREATE_POOL_FIBER(pointer, client_ptr, fiber_function, fiber_context)           \
+    do {                                                                                   \
+        pointer = svt_pool_client_create_fiber(client_ptr, fiber_function, fiber_context); \
+        EB_ADD_MEM(pointer, 1, EB_THREAD);                                                 \
+    } while (0)
+
+#define EB_CREATE_POOL_FIBER_ARRAY(pa, count, client_ptr, fiber_function, fiber_contexts) \
+    do {                                                                                  \
+        EB_ALLOC_PTR_ARRAY(pa, count);                                                    \
+        for (uint32_t i = 0; i < count; i++)                                              \
+            EB_CREATE_POOL_FIBER(pa[i], client_ptr, fiber_function, fiber_contexts[i]);   \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbThreadPool_h
@@ -15,6 +15,12 @@
 // and mutexs.  The goal is to eliminiate platform #define
 // in the code.
 
+// ucontext is an XSI interface on macOS
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 700
+#define _DARWIN_C_SOURCE
+#endif
+
 #if defined(__has_feature)
 #if __has_feature(thread_sanitizer)
 #define EB_THREAD_SANITIZER_ENABLED
@@ -38,11 +44,26 @@
 #include <fcntl.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <sys/mman.h>
+#include <ucontext.h>
 #include <unistd.h>
 #endif // _WIN32
 #ifdef __APPLE__
 #include <dispatch/dispatch.h>
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+#ifndef _WIN32
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifdef MAP_NORESERVE
+#define FIBER_MAP_FLAGS MAP_NORESERVE
+#else
+#define FIBER_MAP_FLAGS 0
 #endif
+#endif
+// Stack of a fiber when the default stack of a thread is smaller
+#define FIBER_MIN_STACK_SIZE (1024 * 1024)
 #if PRINTF_TIME
 #include <time.h>
 #ifdef _WIN32
@@ -183,52 +204,192 @@ EbErrorType svt_destroy_thread(EbHandle thread_handle) {
     return error_return;
 }
 
+/****************************************
+ * svt_yield_thread
+ ****************************************/
+void svt_yield_thread(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+/***************************************
+ * Semaphores and Mutexes
+ *   count holds the free tokens, or minus the number of waiters when
+ *   negative, so an uncontended post or block is one atomic add. A
+ *   waiter parks under lock: a fiber in the fiber list, switching back
+ *   to the thread that resumed it, a thread on thread_semaphore. A post
+ *   that finds waiters wakes the oldest fiber, else a thread; a waiter
+ *   that did not park yet takes its token from pending.
+ *   A mutex is a semaphore of one token, which lets a fiber block on
+ *   it the same way.
+ ***************************************/
+typedef struct EbSemaphore {
+    volatile int32_t count;
+    uint32_t         pending; // tokens of the waiters that did not park yet
+    uint32_t         thread_count; // threads parked on thread_semaphore
+    struct EbFiber * fiber_head_ptr;
+    struct EbFiber * fiber_tail_ptr;
+#if defined(_WIN32)
+    CRITICAL_SECTION lock;
+    HANDLE           thread_semaphore;
+#elif defined(__APPLE__)
+    pthread_mutex_t      lock;
+    dispatch_semaphore_t thread_semaphore;
+#else
+    pthread_mutex_t lock;
+    sem_t           thread_semaphore;
+#endif
+} EbSemaphore;
+
+/***************************************
+ * Fibers
+ ***************************************/
+typedef struct EbFiber {
+#ifdef _WIN32
+    LPVOID fiber_handle;
+    LPVOID return_handle; // fiber of the thread that resumed it
+#else
+    ucontext_t context;
+    ucontext_t return_context; // of the thread that resumed it
+    uint8_t *  stack_ptr; // guard page first
+    size_t     stack_size;
+#endif
+    void *(*fiber_function)(void *);
+    void *          fiber_context;
+    EbFiberWakeFn   wake_fn;
+    void *          wake_context;
+    EbSemaphore *   handoff_ptr; // whose lock the resumer releases after the switch
+    EbBool          finished;
+    EbHandle        done_semaphore; // posted once fiber_function returned
+    struct EbFiber *next_ptr; // in the fiber list of a semaphore
+} EbFiber;
+
+#ifdef _WIN32
+#define EB_THREAD_LOCAL __declspec(thread)
+#else
+#define EB_THREAD_LOCAL __thread
+#endif
+
+// Fiber running on the calling thread. A fiber may resume on another
+// thread, so it reads this only before it first switches out.
+static EB_THREAD_LOCAL EbFiber *current_fiber_ptr = NULL;
+#ifdef _WIN32
+static EB_THREAD_LOCAL LPVOID thread_fiber_handle = NULL;
+#endif
+
+static void svt_semaphore_lock(EbSemaphore *sem_ptr) {
+#ifdef _WIN32
+    EnterCriticalSection(&sem_ptr->lock);
+#else
+    pthread_mutex_lock(&sem_ptr->lock);
+#endif
+}
+
+static void svt_semaphore_unlock(EbSemaphore *sem_ptr) {
+#ifdef _WIN32
+    LeaveCriticalSection(&sem_ptr->lock);
+#else
+    pthread_mutex_unlock(&sem_ptr->lock);
+#endif
+}
+
+/***************************************
+ * svt_fiber_switch_out
+ *   Switches from the running fiber back to the thread that resumed
+ *   it, which releases the lock of handoff_ptr once the fiber is off
+ *   its stack.
+ ***************************************/
+static void svt_fiber_switch_out(EbFiber *fiber_ptr, EbSemaphore *handoff_ptr) {
+    fiber_ptr->handoff_ptr = handoff_ptr;
+#ifdef _WIN32
+    SwitchToFiber(fiber_ptr->return_handle);
+#else
+    swapcontext(&fiber_ptr->context, &fiber_ptr->return_context);
+#endif
+}
+
 /***************************************
  * svt_create_semaphore
  ***************************************/
 EbHandle svt_create_semaphore(uint32_t initial_count, uint32_t max_count) {
-    EbHandle semaphore_handle;
+    EbSemaphore *sem_ptr;
 
-#if defined(_WIN32)
-    semaphore_handle = (EbHandle)CreateSemaphore(NULL, // default security attributes
-                                                 initial_count, // initial semaphore count
-                                                 max_count, // maximum semaphore count
-                                                 NULL); // semaphore is not named
-#elif defined(__APPLE__)
     UNUSED(max_count);
-    semaphore_handle = (EbHandle)dispatch_semaphore_create(initial_count);
+    sem_ptr = (EbSemaphore *)calloc(1, sizeof(EbSemaphore));
+    if (sem_ptr == NULL)
+        return NULL;
+    sem_ptr->count = (int32_t)initial_count;
+#if defined(_WIN32)
+    InitializeCriticalSection(&sem_ptr->lock);
+    sem_ptr->thread_semaphore = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+    if (sem_ptr->thread_semaphore == NULL) {
+        DeleteCriticalSection(&sem_ptr->lock);
+        free(sem_ptr);
+        return NULL;
+    }
 #else
-    UNUSED(max_count);
-
-    semaphore_handle = (sem_t *)malloc(sizeof(sem_t));
-    if (semaphore_handle != NULL)
-        sem_init((sem_t *)semaphore_handle, // semaphore handle
-                 0, // shared semaphore (not local)
-                 initial_count); // initial count
+    if (pthread_mutex_init(&sem_ptr->lock, NULL)) {
+        free(sem_ptr);
+        return NULL;
+    }
+#if defined(__APPLE__)
+    sem_ptr->thread_semaphore = dispatch_semaphore_create(0);
+    if (sem_ptr->thread_semaphore == NULL) {
+#else
+    if (sem_init(&sem_ptr->thread_semaphore, 0, 0)) {
+#endif
+        pthread_mutex_destroy(&sem_ptr->lock);
+        free(sem_ptr);
+        return NULL;
+    }
 #endif
 
-    return semaphore_handle;
+    return sem_ptr;
 }
 
 /***************************************
  * svt_post_semaphore
  ***************************************/
 EbErrorType svt_post_semaphore(EbHandle semaphore_handle) {
-    EbErrorType return_error;
-
-#ifdef _WIN32
-    return_error = !ReleaseSemaphore(semaphore_handle, // semaphore handle
-                                     1, // amount to increment the semaphore
-                                     NULL) // pointer to previous count (optional)
-        ? EB_ErrorSemaphoreUnresponsive
-        : EB_ErrorNone;
+    EbSemaphore *sem_ptr   = (EbSemaphore *)semaphore_handle;
+    EbFiber *    fiber_ptr = NULL;
+    EbBool       wake_thread = EB_FALSE;
+    EbErrorType  return_error = EB_ErrorNone;
+
+    if (svt_atomic_fetch_add_i32(&sem_ptr->count, 1) >= 0)
+        return EB_ErrorNone;
+    // A waiter took a token that was not there, it is parked or about to
+    svt_semaphore_lock(sem_ptr);
+    if (sem_ptr->fiber_head_ptr) {
+        fiber_ptr               = sem_ptr->fiber_head_ptr;
+        sem_ptr->fiber_head_ptr = fiber_ptr->next_ptr;
+        if (!sem_ptr->fiber_head_ptr)
+            sem_ptr->fiber_tail_ptr = NULL;
+    } else if (sem_ptr->thread_count) {
+        sem_ptr->thread_count--;
+        wake_thread = EB_TRUE;
+    } else
+        sem_ptr->pending++;
+    svt_semaphore_unlock(sem_ptr);
+    // The semaphore may be gone once a fiber waiter runs, a thread
+    // waiter wakes only once thread_semaphore is posted
+    if (fiber_ptr)
+        fiber_ptr->wake_fn(fiber_ptr->wake_context, fiber_ptr);
+    else if (wake_thread) {
+#if defined(_WIN32)
+        return_error = !ReleaseSemaphore(sem_ptr->thread_semaphore, 1, NULL)
+            ? EB_ErrorSemaphoreUnresponsive
+            : EB_ErrorNone;
 #elif defined(__APPLE__)
-    dispatch_semaphore_signal((dispatch_semaphore_t)semaphore_handle);
-    return_error = EB_ErrorNone;
+        dispatch_semaphore_signal(sem_ptr->thread_semaphore);
 #else
-    return_error = sem_post((sem_t *)semaphore_handle) ? EB_ErrorSemaphoreUnresponsive
-                                                       : EB_ErrorNone;
+        return_error = sem_post(&sem_ptr->thread_semaphore) ? EB_ErrorSemaphoreUnresponsive
+                                                            : EB_ErrorNone;
 #endif
+    }
 
     return return_error;
 }
@@ -237,20 +398,44 @@ EbErrorType svt_post_semaphore(EbHandle semaphore_handle) {
  * svt_block_on_semaphore
  ***************************************/
 EbErrorType svt_block_on_semaphore(EbHandle semaphore_handle) {
-    EbErrorType return_error;
-
-#ifdef _WIN32
-    return_error = WaitForSingleObject((HANDLE)semaphore_handle, INFINITE)
+    EbSemaphore *sem_ptr   = (EbSemaphore *)semaphore_handle;
+    EbFiber *    fiber_ptr = current_fiber_ptr;
+    EbErrorType  return_error;
+
+    if (svt_atomic_fetch_add_i32(&sem_ptr->count, -1) > 0)
+        return EB_ErrorNone;
+    svt_semaphore_lock(sem_ptr);
+    if (sem_ptr->pending) {
+        sem_ptr->pending--;
+        svt_semaphore_unlock(sem_ptr);
+        return EB_ErrorNone;
+    }
+    if (fiber_ptr) {
+        // The post that pops the fiber hands it its token
+        fiber_ptr->next_ptr = NULL;
+        if (sem_ptr->fiber_tail_ptr)
+            sem_ptr->fiber_tail_ptr->next_ptr = fiber_ptr;
+        else
+            sem_ptr->fiber_head_ptr = fiber_ptr;
+        sem_ptr->fiber_tail_ptr = fiber_ptr;
+        svt_fiber_switch_out(fiber_ptr, sem_ptr);
+        return EB_ErrorNone;
+    }
+    sem_ptr->thread_count++;
+    svt_semaphore_unlock(sem_ptr);
+#if defined(_WIN32)
+    return_error = WaitForSingleObject(sem_ptr->thread_semaphore, INFINITE)
         ? EB_ErrorSemaphoreUnresponsive
         : EB_ErrorNone;
 #elif defined(__APPLE__)
-    return_error = dispatch_semaphore_wait((dispatch_semaphore_t)semaphore_handle,
-                                           DISPATCH_TIME_FOREVER)
+    return_error = dispatch_semaphore_wait(sem_ptr->thread_semaphore, DISPATCH_TIME_FOREVER)
         ? EB_ErrorSemaphoreUnresponsive
         : EB_ErrorNone;
 #else
     int ret;
-    do { ret = sem_wait((sem_t *)semaphore_handle); } while (ret == -1 && errno == EINTR);
+    do {
+        ret = sem_wait(&sem_ptr->thread_semaphore);
+    } while (ret == -1 && errno == EINTR);
     return_error = ret ? EB_ErrorSemaphoreUnresponsive : EB_ErrorNone;
 #endif
 
@@ -261,95 +446,199 @@ EbErrorType svt_block_on_semaphore(EbHandle semaphore_handle) {
  * svt_destroy_semaphore
  ***************************************/
 EbErrorType svt_destroy_semaphore(EbHandle semaphore_handle) {
-    EbErrorType return_error;
+    EbSemaphore *sem_ptr = (EbSemaphore *)semaphore_handle;
+    EbErrorType  return_error;
 
-#ifdef _WIN32
-    return_error = !CloseHandle((HANDLE)semaphore_handle) ? EB_ErrorDestroySemaphoreFailed
-                                                          : EB_ErrorNone;
+#if defined(_WIN32)
+    DeleteCriticalSection(&sem_ptr->lock);
+    return_error = !CloseHandle(sem_ptr->thread_semaphore) ? EB_ErrorDestroySemaphoreFailed
+                                                           : EB_ErrorNone;
 #elif defined(__APPLE__)
-    dispatch_release((dispatch_semaphore_t)semaphore_handle);
-    return_error = EB_ErrorNone;
+    dispatch_release(sem_ptr->thread_semaphore);
+    return_error = pthread_mutex_destroy(&sem_ptr->lock) ? EB_ErrorDestroySemaphoreFailed
+                                                         : EB_ErrorNone;
 #else
-    return_error = sem_destroy((sem_t *)semaphore_handle) ? EB_ErrorDestroySemaphoreFailed
-                                                          : EB_ErrorNone;
-    free(semaphore_handle);
+    return_error = sem_destroy(&sem_ptr->thread_semaphore) || pthread_mutex_destroy(&sem_ptr->lock)
+        ? EB_ErrorDestroySemaphoreFailed
+        : EB_ErrorNone;
 #endif
+    free(sem_ptr);
 
     return return_error;
 }
 /***************************************
  * svt_create_mutex
  ***************************************/
-EbHandle svt_create_mutex(void) {
-    EbHandle mutex_handle;
+EbHandle svt_create_mutex(void) { return svt_create_semaphore(1, 1); }
 
-#ifdef _WIN32
-    mutex_handle = (EbHandle)CreateMutex(NULL, // default security attributes
-                                         FALSE, // FALSE := not initially owned
-                                         NULL); // mutex is not named
+/***************************************
+ * svt_release_mutex
+ ***************************************/
+EbErrorType svt_release_mutex(EbHandle mutex_handle) {
+    return svt_post_semaphore(mutex_handle) ? EB_ErrorMutexUnresponsive : EB_ErrorNone;
+}
 
-#else
+/***************************************
+ * svt_block_on_mutex
+ ***************************************/
+EbErrorType svt_block_on_mutex(EbHandle mutex_handle) {
+    return svt_block_on_semaphore(mutex_handle) ? EB_ErrorMutexUnresponsive : EB_ErrorNone;
+}
 
-    mutex_handle = (EbHandle)malloc(sizeof(pthread_mutex_t));
+/***************************************
+ * svt_destroy_mutex
+ ***************************************/
+EbErrorType svt_destroy_mutex(EbHandle mutex_handle) {
+    return svt_destroy_semaphore(mutex_handle) ? EB_ErrorDestroyMutexFailed : EB_ErrorNone;
+}
 
-    if (mutex_handle != NULL) {
-        pthread_mutex_init((pthread_mutex_t *)mutex_handle,
-                           NULL); // default attributes
-    }
+/***************************************
+ * svt_fiber_entry
+ ***************************************/
+#ifdef _WIN32
+static VOID CALLBACK svt_fiber_entry(LPVOID parameter) {
+    EbFiber *fiber_ptr = (EbFiber *)parameter;
+#else
+static void svt_fiber_entry(void) {
+    EbFiber *fiber_ptr = current_fiber_ptr;
 #endif
+    fiber_ptr->fiber_function(fiber_ptr->fiber_context);
+    fiber_ptr->finished = EB_TRUE;
+    // Never returns, the resumer sees finished
+    svt_fiber_switch_out(fiber_ptr, NULL);
+}
+
+#ifndef _WIN32
+// Only the signal mask is kept from the context, makecontext replaces the
+// stack and entry
+static int svt_fiber_get_context(ucontext_t *context) { return getcontext(context); }
 
-    return mutex_handle;
+/***************************************
+ * svt_fiber_make_context
+ *   Maps the stack a thread would get, committed as it is touched,
+ *   below a guard page, and points the context of the fiber at
+ *   svt_fiber_entry on it.
+ ***************************************/
+static int svt_fiber_make_context(EbFiber *fiber_ptr) {
+    const size_t   page_size  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t         stack_size = 0;
+    pthread_attr_t attr;
+
+    if (!pthread_attr_init(&attr)) {
+        pthread_attr_getstacksize(&attr, &stack_size);
+        pthread_attr_destroy(&attr);
+    }
+    if (stack_size < FIBER_MIN_STACK_SIZE)
+        stack_size = FIBER_MIN_STACK_SIZE;
+    stack_size           = (stack_size + page_size - 1) / page_size * page_size + page_size;
+    fiber_ptr->stack_ptr = (uint8_t *)mmap(NULL,
+                                           stack_size,
+                                           PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS | FIBER_MAP_FLAGS,
+                                           -1,
+                                           0);
+    if (fiber_ptr->stack_ptr == MAP_FAILED)
+        return -1;
+    fiber_ptr->stack_size = stack_size;
+    if (mprotect(fiber_ptr->stack_ptr, page_size, PROT_NONE) ||
+        svt_fiber_get_context(&fiber_ptr->context)) {
+        munmap(fiber_ptr->stack_ptr, stack_size);
+        return -1;
+    }
+    fiber_ptr->context.uc_stack.ss_sp   = fiber_ptr->stack_ptr + page_size;
+    fiber_ptr->context.uc_stack.ss_size = stack_size - page_size;
+    fiber_ptr->context.uc_link          = NULL;
+    makecontext(&fiber_ptr->context, svt_fiber_entry, 0);
+    return 0;
 }
+#endif
 
 /***************************************
- * svt_release_mutex
+ * svt_create_fiber
  ***************************************/
-EbErrorType svt_release_mutex(EbHandle mutex_handle) {
-    EbErrorType return_error;
+EbHandle svt_create_fiber(void *fiber_function(void *), void *fiber_context,
+                          EbFiberWakeFn wake_fn, void *wake_context) {
+    EbFiber *fiber_ptr = (EbFiber *)calloc(1, sizeof(EbFiber));
 
+    if (fiber_ptr == NULL)
+        return NULL;
+    fiber_ptr->fiber_function = fiber_function;
+    fiber_ptr->fiber_context  = fiber_context;
+    fiber_ptr->wake_fn        = wake_fn;
+    fiber_ptr->wake_context   = wake_context;
+    fiber_ptr->done_semaphore = svt_create_semaphore(0, 1);
+    if (fiber_ptr->done_semaphore == NULL) {
+        free(fiber_ptr);
+        return NULL;
+    }
 #ifdef _WIN32
-    return_error = !ReleaseMutex((HANDLE)mutex_handle) ? EB_ErrorMutexUnresponsive : EB_ErrorNone;
+    // The default stack size of the threads of the process
+    fiber_ptr->fiber_handle = CreateFiber(0, svt_fiber_entry, fiber_ptr);
+    if (fiber_ptr->fiber_handle == NULL) {
+        svt_destroy_semaphore(fiber_ptr->done_semaphore);
+        free(fiber_ptr);
+        return NULL;
+    }
 #else
-    return_error = pthread_mutex_unlock((pthread_mutex_t *)mutex_handle) ? EB_ErrorMutexUnresponsive
-                                                                         : EB_ErrorNone;
+    if (svt_fiber_make_context(fiber_ptr)) {
+        svt_destroy_semaphore(fiber_ptr->done_semaphore);
+        free(fiber_ptr);
+        return NULL;
+    }
 #endif
+    wake_fn(wake_context, fiber_ptr);
 
-    return return_error;
+    return fiber_ptr;
 }
 
 /***************************************
- * svt_block_on_mutex
+ * svt_resume_fiber
  ***************************************/
-EbErrorType svt_block_on_mutex(EbHandle mutex_handle) {
-    EbErrorType return_error;
+void svt_resume_fiber(EbHandle fiber_handle) {
+    EbFiber *fiber_ptr = (EbFiber *)fiber_handle;
 
+    current_fiber_ptr = fiber_ptr;
 #ifdef _WIN32
-    return_error = WaitForSingleObject((HANDLE)mutex_handle, INFINITE) ? EB_ErrorMutexUnresponsive
-                                                                       : EB_ErrorNone;
+    if (thread_fiber_handle == NULL)
+        thread_fiber_handle = IsThreadAFiber() ? GetCurrentFiber() : ConvertThreadToFiber(NULL);
+    fiber_ptr->return_handle = thread_fiber_handle;
+    SwitchToFiber(fiber_ptr->fiber_handle);
 #else
-    return_error = pthread_mutex_lock((pthread_mutex_t *)mutex_handle) ? EB_ErrorMutexUnresponsive
-                                                                       : EB_ErrorNone;
+    swapcontext(&fiber_ptr->return_context, &fiber_ptr->context);
 #endif
-
-    return return_error;
+    current_fiber_ptr = NULL;
+    // Off the stack of the fiber now; once the lock is released or done
+    // posted, it may run again or be destroyed
+    if (fiber_ptr->finished) {
+        svt_post_semaphore(fiber_ptr->done_semaphore);
+    } else {
+        EbSemaphore *handoff_ptr = fiber_ptr->handoff_ptr;
+        fiber_ptr->handoff_ptr   = NULL;
+        svt_semaphore_unlock(handoff_ptr);
+    }
 }
 
 /***************************************
- * svt_destroy_mutex
+ * svt_in_fiber
  ***************************************/
-EbErrorType svt_destroy_mutex(EbHandle mutex_handle) {
-    EbErrorType return_error;
+EbBool svt_in_fiber(void) { return current_fiber_ptr ? EB_TRUE : EB_FALSE; }
+
+/***************************************
+ * svt_destroy_fiber
+ ***************************************/
+EbErrorType svt_destroy_fiber(EbHandle fiber_handle) {
+    EbFiber *fiber_ptr = (EbFiber *)fiber_handle;
 
+    svt_block_on_semaphore(fiber_ptr->done_semaphore);
 #ifdef _WIN32
-    return_error = CloseHandle((HANDLE)mutex_handle) ? EB_ErrorDestroyMutexFailed : EB_ErrorNone;
+    DeleteFiber(fiber_ptr->fiber_handle);
 #else
-    return_error = pthread_mutex_destroy((pthread_mutex_t *)mutex_handle)
-        ? EB_ErrorDestroyMutexFailed
-        : EB_ErrorNone;
-    free(mutex_handle);
+    munmap(fiber_ptr->stack_ptr, fiber_ptr->stack_size);
 #endif
+    svt_destroy_semaphore(fiber_ptr->done_semaphore);
+    free(fiber_ptr);
 
-    return return_error;
+    return EB_ErrorNone;
 }
 /*
     set an atomic variable to an input value
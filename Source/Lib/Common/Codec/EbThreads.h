@@ -36,6 +36,29 @@ extern EbErrorType svt_stop_thread(EbHandle thread_handle);
 
 extern EbErrorType svt_destroy_thread(EbHandle thread_handle);
 
+extern void svt_yield_thread(void);
+
+/**************************************
+     * Fibers
+     *   A fiber runs fiber_function(fiber_context) on a stack of its
+     *   own, on the threads that resume it. Blocked on a semaphore or
+     *   mutex, it switches back to the thread that resumed it instead
+     *   of blocking that thread; the post that releases it, and its
+     *   creation, call wake_fn(wake_context, fiber) which must get
+     *   svt_resume_fiber(fiber) called once, on any thread.
+     *   svt_destroy_fiber waits for fiber_function to return.
+     **************************************/
+typedef void (*EbFiberWakeFn)(void *wake_context, EbHandle fiber_handle);
+
+extern EbHandle svt_create_fiber(void *fiber_function(void *), void *fiber_context,
+                                 EbFiberWakeFn wake_fn, void *wake_context);
+
+extern void svt_resume_fiber(EbHandle fiber_handle);
+
+extern EbBool svt_in_fiber(void);
+
+extern EbErrorType svt_destroy_fiber(EbHandle fiber_handle);
+
 /**************************************
      * Semaphores
      **************************************/
@@ -120,8 +143,148 @@ extern uint64_t *        total_lib_memory; // library Memory malloc'd
         }                                                                  \
     } while (0)
 
+#define EB_DESTROY_FIBER(pointer)                    \
+    do {                                             \
+        if (pointer) {                               \
+            svt_destroy_fiber(pointer);              \
+            EB_REMOVE_MEM_ENTRY(pointer, EB_THREAD); \
+            pointer = NULL;                          \
+        }                                            \
+    } while (0);
+
+#define EB_DESTROY_FIBER_ARRAY(pa, count)                                 \
+    do {                                                                  \
+        if (pa) {                                                         \
+            for (uint32_t i = 0; i < count; i++) EB_DESTROY_FIBER(pa[i]); \
+            EB_FREE_PTR_ARRAY(pa, count);                                 \
+        }                                                                 \
+    } while (0)
+
 void atomic_set_u32(AtomicVarU32 *var, uint32_t in);
 
+/**************************************
+     * Lock-free atomics
+     *   Sequentially consistent primitives used by the lock-free
+     *   system resource manager queues and thread pool deques.
+     **************************************/
+#ifdef _WIN32
+static INLINE uint32_t svt_atomic_load_u32(volatile uint32_t *var) {
+    return (uint32_t)InterlockedCompareExchange((volatile LONG *)var, 0, 0);
+}
+static INLINE void svt_atomic_store_u32(volatile uint32_t *var, uint32_t in) {
+    InterlockedExchange((volatile LONG *)var, (LONG)in);
+}
+static INLINE EbBool svt_atomic_cas_u32(volatile uint32_t *var, uint32_t expected,
+                                        uint32_t desired) {
+    return (uint32_t)InterlockedCompareExchange(
+               (volatile LONG *)var, (LONG)desired, (LONG)expected) == expected
+        ? EB_TRUE
+        : EB_FALSE;
+}
+static INLINE int32_t svt_atomic_load_i32(volatile int32_t *var) {
+    return (int32_t)InterlockedCompareExchange((volatile LONG *)var, 0, 0);
+}
+static INLINE EbBool svt_atomic_cas_i32(volatile int32_t *var, int32_t expected,
+                                        int32_t desired) {
+    return (int32_t)InterlockedCompareExchange((volatile LONG *)var, desired, expected) ==
+            expected
+        ? EB_TRUE
+        : EB_FALSE;
+}
+static INLINE int32_t svt_atomic_fetch_add_i32(volatile int32_t *var, int32_t in) {
+    return (int32_t)InterlockedExchangeAdd((volatile LONG *)var, (LONG)in);
+}
+static INLINE int64_t svt_atomic_load_i64(volatile int64_t *var) {
+    return (int64_t)InterlockedCompareExchange64((volatile LONG64 *)var, 0, 0);
+}
+static INLINE void svt_atomic_store_i64(volatile int64_t *var, int64_t in) {
+    InterlockedExchange64((volatile LONG64 *)var, (LONG64)in);
+}
+static INLINE EbBool svt_atomic_cas_i64(volatile int64_t *var, int64_t expected,
+                                        int64_t desired) {
+    return (int64_t)InterlockedCompareExchange64((volatile LONG64 *)var, desired, expected) ==
+            expected
+        ? EB_TRUE
+        : EB_FALSE;
+}
+static INLINE void *svt_atomic_load_ptr(void *volatile *var) {
+    return InterlockedCompareExchangePointer(var, NULL, NULL);
+}
+static INLINE void svt_atomic_store_ptr(void *volatile *var, void *in) {
+    InterlockedExchangePointer(var, in);
+}
+static INLINE EbBool svt_atomic_cas_ptr(void *volatile *var, void *expected, void *desired) {
+    return InterlockedCompareExchangePointer(var, desired, expected) == expected ? EB_TRUE
+                                                                                : EB_FALSE;
+}
+static INLINE void *svt_atomic_exchange_ptr(void *volatile *var, void *in) {
+    return InterlockedExchangePointer(var, in);
+}
+#define svt_cpu_relax() YieldProcessor()
+#else
+static INLINE uint32_t svt_atomic_load_u32(volatile uint32_t *var) {
+    return __atomic_load_n(var, __ATOMIC_SEQ_CST);
+}
+static INLINE void svt_atomic_store_u32(volatile uint32_t *var, uint32_t in) {
+    __atomic_store_n(var, in, __ATOMIC_SEQ_CST);
+}
+static INLINE EbBool svt_atomic_cas_u32(volatile uint32_t *var, uint32_t expected,
+                                        uint32_t desired) {
+    return __atomic_compare_exchange_n(
+               var, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+        ? EB_TRUE
+        : EB_FALSE;
+}
+static INLINE int32_t svt_atomic_load_i32(volatile int32_t *var) {
+    return __atomic_load_n(var, __ATOMIC_SEQ_CST);
+}
+static INLINE EbBool svt_atomic_cas_i32(volatile int32_t *var, int32_t expected,
+                                        int32_t desired) {
+    return __atomic_compare_exchange_n(
+               var, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+        ? EB_TRUE
+        : EB_FALSE;
+}
+static INLINE int32_t svt_atomic_fetch_add_i32(volatile int32_t *var, int32_t in) {
+    return __atomic_fetch_add(var, in, __ATOMIC_SEQ_CST);
+}
+static INLINE int64_t svt_atomic_load_i64(volatile int64_t *var) {
+    return __atomic_load_n(var, __ATOMIC_SEQ_CST);
+}
+static INLINE void svt_atomic_store_i64(volatile int64_t *var, int64_t in) {
+    __atomic_store_n(var, in, __ATOMIC_SEQ_CST);
+}
+static INLINE EbBool svt_atomic_cas_i64(volatile int64_t *var, int64_t expected,
+                                        int64_t desired) {
+    return __atomic_compare_exchange_n(
+               var, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+        ? EB_TRUE
+        : EB_FALSE;
+}
+static INLINE void *svt_atomic_load_ptr(void *volatile *var) {
+    return __atomic_load_n(var, __ATOMIC_SEQ_CST);
+}
+static INLINE void svt_atomic_store_ptr(void *volatile *var, void *in) {
+    __atomic_store_n(var, in, __ATOMIC_SEQ_CST);
+}
+static INLINE EbBool svt_atomic_cas_ptr(void *volatile *var, void *expected, void *desired) {
+    return __atomic_compare_exchange_n(
+               var, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+        ? EB_TRUE
+        : EB_FALSE;
+}
+static INLINE void *svt_atomic_exchange_ptr(void *volatile *var, void *in) {
+    return __atomic_exchange_n(var, in, __ATOMIC_SEQ_CST);
+}
+#if defined(__i386__) || defined(__x86_64__)
+#define svt_cpu_relax() __builtin_ia32_pause()
+#else
+#define svt_cpu_relax() \
+    do {                \
+    } while (0)
+#endif
+#endif
+
 #if FIX_DDL
 /*
  Condition variable
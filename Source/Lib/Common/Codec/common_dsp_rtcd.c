@@ -519,6 +519,13 @@ void setup_common_rtcd_internal(CPU_FLAGS flags) {
     SET_AVX2(svt_copy_rect8_8bit_to_16bit, svt_copy_rect8_8bit_to_16bit_c, svt_copy_rect8_8bit_to_16bit_avx2);
     SET_AVX2(svt_av1_highbd_warp_affine, svt_av1_highbd_warp_affine_c, svt_av1_highbd_warp_affine_avx2);
     SET_AVX2(svt_av1_warp_affine, svt_av1_warp_affine_c, svt_av1_warp_affine_avx2);
+    SET_AVX2(svt_av1_add_noise_luma, svt_av1_add_noise_luma_c, svt_av1_add_noise_luma_avx2);
+    SET_AVX2(svt_av1_add_noise_luma_hbd, svt_av1_add_noise_luma_hbd_c, svt_av1_add_noise_luma_hbd_avx2);
+    SET_AVX2(svt_av1_add_noise_chroma, svt_av1_add_noise_chroma_c, svt_av1_add_noise_chroma_avx2);
+    SET_AVX2(svt_av1_add_noise_chroma_hbd, svt_av1_add_noise_chroma_hbd_c, svt_av1_add_noise_chroma_hbd_avx2);
+    SET_AVX2(svt_av1_dequant_scatter, svt_av1_dequant_scatter_c, svt_av1_dequant_scatter_avx2);
+    SET_AVX2(svt_od_ec_search_cdf, svt_od_ec_search_cdf_c, svt_od_ec_search_cdf_avx2);
+    SET_AVX2(svt_av1_update_cdf, svt_av1_update_cdf_c, svt_av1_update_cdf_avx2);
 
     SET_SSE2(svt_aom_highbd_lpf_horizontal_4, svt_aom_highbd_lpf_horizontal_4_c, svt_aom_highbd_lpf_horizontal_4_sse2);
     SET_SSE2(svt_aom_highbd_lpf_horizontal_6, svt_aom_highbd_lpf_horizontal_6_c, svt_aom_highbd_lpf_horizontal_6_sse2);
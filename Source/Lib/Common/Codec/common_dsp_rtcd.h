@@ -1039,6 +1039,20 @@ extern "C" {
     RTCD_EXTERN void(*svt_av1_highbd_warp_affine)(const int32_t *mat, const uint16_t *ref, int width, int height, int stride, uint16_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, int bd, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
     void svt_av1_warp_affine_c(const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
     RTCD_EXTERN void(*svt_av1_warp_affine)(const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
+    void svt_av1_add_noise_luma_c(uint8_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    RTCD_EXTERN void(*svt_av1_add_noise_luma)(uint8_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_add_noise_luma_hbd_c(uint16_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    RTCD_EXTERN void(*svt_av1_add_noise_luma_hbd)(uint16_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_add_noise_chroma_c(uint8_t *chroma, int32_t chroma_stride, const uint8_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    RTCD_EXTERN void(*svt_av1_add_noise_chroma)(uint8_t *chroma, int32_t chroma_stride, const uint8_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_add_noise_chroma_hbd_c(uint16_t *chroma, int32_t chroma_stride, const uint16_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    RTCD_EXTERN void(*svt_av1_add_noise_chroma_hbd)(uint16_t *chroma, int32_t chroma_stride, const uint16_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_dequant_scatter_c(const int32_t *level, int32_t n_coeffs, const int16_t *scan, const int16_t *dequant, const QmVal *iqmatrix, int32_t shift, int32_t bit_depth, int32_t *qcoeffs);
+    RTCD_EXTERN void(*svt_av1_dequant_scatter)(const int32_t *level, int32_t n_coeffs, const int16_t *scan, const int16_t *dequant, const QmVal *iqmatrix, int32_t shift, int32_t bit_depth, int32_t *qcoeffs);
+    int32_t svt_od_ec_search_cdf_c(const uint16_t *icdf, int32_t nsyms, uint32_t c, uint32_t r);
+    RTCD_EXTERN int32_t(*svt_od_ec_search_cdf)(const uint16_t *icdf, int32_t nsyms, uint32_t c, uint32_t r);
+    void svt_av1_update_cdf_c(uint16_t *cdf, int32_t val, int32_t nsymbs);
+    RTCD_EXTERN void(*svt_av1_update_cdf)(uint16_t *cdf, int32_t val, int32_t nsymbs);
     void svt_aom_highbd_lpf_horizontal_14_c(uint16_t *s, int32_t pitch, const uint8_t *blimit, const uint8_t *limit, const uint8_t *thresh, int32_t bd);
     RTCD_EXTERN void(*svt_aom_highbd_lpf_horizontal_14)(uint16_t *s, int32_t pitch, const uint8_t *blimit, const uint8_t *limit, const uint8_t *thresh, int32_t bd);
     void svt_aom_highbd_lpf_horizontal_4_c(uint16_t *s, int32_t pitch, const uint8_t *blimit, const uint8_t *limit, const uint8_t *thresh, int32_t bd);
@@ -2169,6 +2183,14 @@ extern "C" {
 
     void svt_av1_warp_affine_avx2(const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
 
+    void svt_av1_add_noise_luma_avx2(uint8_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_add_noise_luma_hbd_avx2(uint16_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_add_noise_chroma_avx2(uint8_t *chroma, int32_t chroma_stride, const uint8_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_add_noise_chroma_hbd_avx2(uint16_t *chroma, int32_t chroma_stride, const uint16_t *luma, int32_t luma_stride, const int32_t *grain, int32_t grain_stride, int32_t width, int32_t height, const FgnPlaneParams *plane);
+    void svt_av1_dequant_scatter_avx2(const int32_t *level, int32_t n_coeffs, const int16_t *scan, const int16_t *dequant, const QmVal *iqmatrix, int32_t shift, int32_t bit_depth, int32_t *qcoeffs);
+    int32_t svt_od_ec_search_cdf_avx2(const uint16_t *icdf, int32_t nsyms, uint32_t c, uint32_t r);
+    void svt_av1_update_cdf_avx2(uint16_t *cdf, int32_t val, int32_t nsymbs);
+
     void svt_aom_highbd_lpf_horizontal_14_sse2(uint16_t *s, int32_t pitch, const uint8_t *blimit, const uint8_t *limit, const uint8_t *thresh, int32_t bd);
 
     void svt_aom_highbd_lpf_horizontal_4_sse2(uint16_t *s, int32_t pitch, const uint8_t *blimit, const uint8_t *limit, const uint8_t *thresh, int32_t bd);
@@ -185,28 +185,12 @@ static const int32_t gaussian_sequence[2048] = {
 
 static const int32_t gauss_bits = 11;
 
-static int32_t luma_subblock_size_y = 32;
-static int32_t luma_subblock_size_x = 32;
-
-static int32_t chroma_subblock_size_y = 16;
-static int32_t chroma_subblock_size_x = 16;
-
 static const int32_t min_luma_legal_range = 16;
 static const int32_t max_luma_legal_range = 235;
 
 static const int32_t min_chroma_legal_range = 16;
 static const int32_t max_chroma_legal_range = 240;
 
-static int32_t scaling_lut_y[256];
-static int32_t scaling_lut_cb[256];
-static int32_t scaling_lut_cr[256];
-
-static int32_t grain_center;
-static int32_t grain_min;
-static int32_t grain_max;
-
-static uint16_t random_register = 0; // random number generator register
-
 //----------------------------------------------------------------------
 // todo: aomlib memory functions (to be replaced by Eb functions)
 /*
@@ -270,18 +254,8 @@ void svt_aom_free(void *memblk) {
 */
 //--------------------------------------------------------------------
 
-static void init_arrays(AomFilmGrain *params, int32_t luma_stride, int32_t chroma_stride,
-                        int32_t ***pred_pos_luma_p, int32_t ***pred_pos_chroma_p,
-                        int32_t **luma_grain_block, int32_t **cb_grain_block,
-                        int32_t **cr_grain_block, int32_t **y_line_buf, int32_t **cb_line_buf,
-                        int32_t **cr_line_buf, int32_t **y_col_buf, int32_t **cb_col_buf,
-                        int32_t **cr_col_buf, int32_t luma_grain_samples,
-                        int32_t chroma_grain_samples, int32_t chroma_subsamp_y,
-                        int32_t chroma_subsamp_x) {
-    memset(scaling_lut_y, 0, sizeof(*scaling_lut_y) * 256);
-    memset(scaling_lut_cb, 0, sizeof(*scaling_lut_cb) * 256);
-    memset(scaling_lut_cr, 0, sizeof(*scaling_lut_cr) * 256);
-
+static void init_pred_pos(AomFilmGrain *params, int32_t ***pred_pos_luma_p,
+                          int32_t ***pred_pos_chroma_p) {
     int32_t num_pos_luma   = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
     int32_t num_pos_chroma = num_pos_luma;
     if (params->num_y_points > 0)
@@ -339,91 +313,53 @@ static void init_arrays(AomFilmGrain *params, int32_t luma_stride, int32_t chrom
 
     *pred_pos_luma_p   = pred_pos_luma;
     *pred_pos_chroma_p = pred_pos_chroma;
-
-    *y_line_buf  = (int32_t *)malloc(sizeof(**y_line_buf) * luma_stride * 2);
-    *cb_line_buf = (int32_t *)malloc(sizeof(**cb_line_buf) * chroma_stride *
-                                     (2 >> chroma_subsamp_y));
-    *cr_line_buf = (int32_t *)malloc(sizeof(**cr_line_buf) * chroma_stride *
-                                     (2 >> chroma_subsamp_y));
-
-    *y_col_buf  = (int32_t *)malloc(sizeof(**y_col_buf) * (luma_subblock_size_y + 2) * 2);
-    *cb_col_buf = (int32_t *)malloc(sizeof(**cb_col_buf) *
-                                    (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                                    (2 >> chroma_subsamp_x));
-    *cr_col_buf = (int32_t *)malloc(sizeof(**cr_col_buf) *
-                                    (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                                    (2 >> chroma_subsamp_x));
-
-    *luma_grain_block = (int32_t *)malloc(sizeof(**luma_grain_block) * luma_grain_samples);
-    *cb_grain_block   = (int32_t *)malloc(sizeof(**cb_grain_block) * chroma_grain_samples);
-    *cr_grain_block   = (int32_t *)malloc(sizeof(**cr_grain_block) * chroma_grain_samples);
 }
 
-static void dealloc_arrays(AomFilmGrain *params, int32_t ***pred_pos_luma,
-                           int32_t ***pred_pos_chroma, int32_t **luma_grain_block,
-                           int32_t **cb_grain_block, int32_t **cr_grain_block, int32_t **y_line_buf,
-                           int32_t **cb_line_buf, int32_t **cr_line_buf, int32_t **y_col_buf,
-                           int32_t **cb_col_buf, int32_t **cr_col_buf) {
+static void dealloc_pred_pos(AomFilmGrain *params, int32_t **pred_pos_luma,
+                             int32_t **pred_pos_chroma) {
     int32_t num_pos_luma   = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
     int32_t num_pos_chroma = num_pos_luma;
     if (params->num_y_points > 0)
         ++num_pos_chroma;
 
-    for (int32_t row = 0; row < num_pos_luma; row++) free((*pred_pos_luma)[row]);
-    free(*pred_pos_luma);
-
-    for (int32_t row = 0; row < num_pos_chroma; row++) free((*pred_pos_chroma)[row]);
-    free((*pred_pos_chroma));
-
-    free(*y_line_buf);
-
-    free(*cb_line_buf);
-
-    free(*cr_line_buf);
-
-    free(*y_col_buf);
-
-    free(*cb_col_buf);
+    for (int32_t row = 0; row < num_pos_luma; row++) free(pred_pos_luma[row]);
+    free(pred_pos_luma);
 
-    free(*cr_col_buf);
-
-    free(*luma_grain_block);
-
-    free(*cb_grain_block);
-
-    free(*cr_grain_block);
+    for (int32_t row = 0; row < num_pos_chroma; row++) free(pred_pos_chroma[row]);
+    free(pred_pos_chroma);
 }
 
 // get a number between 0 and 2^bits - 1
-static INLINE int32_t get_random_number(int32_t bits) {
+static INLINE int32_t get_random_number(uint16_t *random_register, int32_t bits) {
     uint16_t bit;
-    bit = ((random_register >> 0) ^ (random_register >> 1) ^ (random_register >> 3) ^
-           (random_register >> 12)) &
+    bit = ((*random_register >> 0) ^ (*random_register >> 1) ^ (*random_register >> 3) ^
+           (*random_register >> 12)) &
         1;
-    random_register = (random_register >> 1) | (bit << 15);
-    return (random_register >> (16 - bits)) & ((1 << bits) - 1);
+    *random_register = (*random_register >> 1) | (bit << 15);
+    return (*random_register >> (16 - bits)) & ((1 << bits) - 1);
 }
 
-static void init_random_generator(int32_t luma_line, uint16_t seed) {
+static void init_random_generator(uint16_t *random_register, int32_t luma_line, uint16_t seed) {
     // same for the picture
 
     uint16_t msb = (seed >> 8) & 255;
     uint16_t lsb = seed & 255;
 
-    random_register = (msb << 8) + lsb;
+    *random_register = (msb << 8) + lsb;
 
     //  changes for each row
     int32_t luma_num = luma_line >> 5;
 
-    random_register ^= ((luma_num * 37 + 178) & 255) << 8;
-    random_register ^= ((luma_num * 173 + 105) & 255);
+    *random_register ^= ((luma_num * 37 + 178) & 255) << 8;
+    *random_register ^= ((luma_num * 173 + 105) & 255);
 }
 
-static void generate_luma_grain_block(AomFilmGrain *params, int32_t **pred_pos_luma,
-                                      int32_t *luma_grain_block, int32_t luma_block_size_y,
-                                      int32_t luma_block_size_x, int32_t luma_grain_stride,
-                                      int32_t left_pad, int32_t top_pad, int32_t right_pad,
-                                      int32_t bottom_pad) {
+static void generate_luma_grain_block(FilmGrainCtxt *ctx, uint16_t *random_register,
+                                      int32_t **pred_pos_luma, int32_t *luma_grain_block,
+                                      int32_t luma_block_size_y, int32_t luma_block_size_x,
+                                      int32_t luma_grain_stride, int32_t left_pad, int32_t top_pad,
+                                      int32_t right_pad, int32_t bottom_pad) {
+    AomFilmGrain *params = &ctx->params;
     if (params->num_y_points == 0)
         return;
 
@@ -436,7 +372,7 @@ static void generate_luma_grain_block(AomFilmGrain *params, int32_t **pred_pos_l
     for (int32_t i = 0; i < luma_block_size_y; i++)
         for (int32_t j = 0; j < luma_block_size_x; j++)
             luma_grain_block[i * luma_grain_stride + j] =
-                (gaussian_sequence[get_random_number(gauss_bits)] +
+                (gaussian_sequence[get_random_number(random_register, gauss_bits)] +
                  ((1 << gauss_sec_shift) >> 1)) >>
                 gauss_sec_shift;
 
@@ -452,20 +388,22 @@ static void generate_luma_grain_block(AomFilmGrain *params, int32_t **pred_pos_l
             luma_grain_block[i * luma_grain_stride + j] = clamp(
                 luma_grain_block[i * luma_grain_stride + j] +
                     ((wsum + rounding_offset) >> params->ar_coeff_shift),
-                grain_min,
-                grain_max);
+                ctx->grain_min,
+                ctx->grain_max);
         }
 }
 
 static void generate_chroma_grain_blocks(
-    AomFilmGrain *params,
+    FilmGrainCtxt *ctx,
     //                                  int32_t** pred_pos_luma,
     int32_t **pred_pos_chroma, int32_t *luma_grain_block, int32_t *cb_grain_block,
     int32_t *cr_grain_block, int32_t luma_grain_stride, int32_t chroma_block_size_y,
     int32_t chroma_block_size_x, int32_t chroma_grain_stride, int32_t left_pad, int32_t top_pad,
     int32_t right_pad, int32_t bottom_pad, int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
-    int32_t bit_depth       = params->bit_depth;
-    int32_t gauss_sec_shift = 12 - bit_depth + params->grain_scale_shift;
+    AomFilmGrain *params = &ctx->params;
+    uint16_t      random_register;
+    int32_t       bit_depth       = params->bit_depth;
+    int32_t       gauss_sec_shift = 12 - bit_depth + params->grain_scale_shift;
 
     int32_t num_pos_chroma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
     if (params->num_y_points > 0)
@@ -475,24 +413,24 @@ static void generate_chroma_grain_blocks(
     int chroma_grain_block_size = chroma_block_size_y * chroma_grain_stride;
 
     if (params->num_cb_points || params->chroma_scaling_from_luma) {
-        init_random_generator(7 << 5, params->random_seed);
+        init_random_generator(&random_register, 7 << 5, params->random_seed);
 
         for (int32_t i = 0; i < chroma_block_size_y; i++)
             for (int32_t j = 0; j < chroma_block_size_x; j++)
                 cb_grain_block[i * chroma_grain_stride + j] =
-                    (gaussian_sequence[get_random_number(gauss_bits)] +
+                    (gaussian_sequence[get_random_number(&random_register, gauss_bits)] +
                      ((1 << gauss_sec_shift) >> 1)) >>
                     gauss_sec_shift;
     } else {
         memset(cb_grain_block, 0, sizeof(*cb_grain_block) * chroma_grain_block_size);
     }
     if (params->num_cr_points || params->chroma_scaling_from_luma) {
-        init_random_generator(11 << 5, params->random_seed);
+        init_random_generator(&random_register, 11 << 5, params->random_seed);
 
         for (int32_t i = 0; i < chroma_block_size_y; i++)
             for (int32_t j = 0; j < chroma_block_size_x; j++)
                 cr_grain_block[i * chroma_grain_stride + j] =
-                    (gaussian_sequence[get_random_number(gauss_bits)] +
+                    (gaussian_sequence[get_random_number(&random_register, gauss_bits)] +
                      ((1 << gauss_sec_shift) >> 1)) >>
                     gauss_sec_shift;
     } else {
@@ -538,14 +476,14 @@ static void generate_chroma_grain_blocks(
                 cb_grain_block[i * chroma_grain_stride + j] = clamp(
                     cb_grain_block[i * chroma_grain_stride + j] +
                         ((wsum_cb + rounding_offset) >> params->ar_coeff_shift),
-                    grain_min,
-                    grain_max);
+                    ctx->grain_min,
+                    ctx->grain_max);
             if (params->num_cr_points || params->chroma_scaling_from_luma)
                 cr_grain_block[i * chroma_grain_stride + j] = clamp(
                     cr_grain_block[i * chroma_grain_stride + j] +
                         ((wsum_cr + rounding_offset) >> params->ar_coeff_shift),
-                    grain_min,
-                    grain_max);
+                    ctx->grain_min,
+                    ctx->grain_max);
         }
 }
 
@@ -574,7 +512,7 @@ static void init_scaling_function(int32_t scaling_points[][2], int32_t num_point
 
 // function that extracts samples from a lut (and interpolates intemediate
 // frames for 10- and 12-bit video)
-static int32_t scale_lut(int32_t *scaling_lut, int32_t index, int32_t bit_depth) {
+static int32_t scale_lut(const int32_t *scaling_lut, int32_t index, int32_t bit_depth) {
     int32_t x = index >> (bit_depth - 8);
 
     if (!(bit_depth - 8) || x == 255)
@@ -586,51 +524,53 @@ static int32_t scale_lut(int32_t *scaling_lut, int32_t index, int32_t bit_depth)
              (bit_depth - 8));
 }
 
-static void add_noise_to_block(AomFilmGrain *params, uint8_t *luma, uint8_t *cb, uint8_t *cr,
-                               int32_t luma_stride, int32_t chroma_stride, int32_t *luma_grain,
-                               int32_t *cb_grain, int32_t *cr_grain, int32_t luma_grain_stride,
-                               int32_t chroma_grain_stride, int32_t half_luma_height,
-                               int32_t half_luma_width, int32_t bit_depth, int32_t chroma_subsamp_y,
-                               int32_t chroma_subsamp_x) {
-    int32_t cb_mult      = params->cb_mult - 128; // fixed scale
-    int32_t cb_luma_mult = params->cb_luma_mult - 128; // fixed scale
-    int32_t cb_offset    = params->cb_offset - 256;
-
-    int32_t cr_mult      = params->cr_mult - 128; // fixed scale
-    int32_t cr_luma_mult = params->cr_luma_mult - 128; // fixed scale
-    int32_t cr_offset    = params->cr_offset - 256;
-
-    int32_t rounding_offset = (1 << (params->scaling_shift - 1));
-
-    int32_t apply_y  = params->num_y_points > 0 ? 1 : 0;
-    int32_t apply_cb = (params->num_cb_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
-    int32_t apply_cr = (params->num_cr_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
-
-    if (params->chroma_scaling_from_luma) {
-        cb_mult      = 0; // fixed scale
-        cb_luma_mult = 64; // fixed scale
-        cb_offset    = 0;
-
-        cr_mult      = 0; // fixed scale
-        cr_luma_mult = 64; // fixed scale
-        cr_offset    = 0;
+void svt_av1_add_noise_luma_c(uint8_t *luma, int32_t luma_stride, const int32_t *grain,
+                              int32_t grain_stride, int32_t width, int32_t height,
+                              const FgnPlaneParams *plane) {
+    const int32_t rounding_offset = (1 << (plane->scaling_shift - 1));
+
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
+            luma[i * luma_stride + j] = clamp(
+                luma[i * luma_stride + j] +
+                    ((scale_lut(plane->scaling_lut, luma[i * luma_stride + j], 8) *
+                          grain[i * grain_stride + j] +
+                      rounding_offset) >>
+                     plane->scaling_shift),
+                plane->min_value,
+                plane->max_value);
+        }
     }
+}
 
-    int32_t min_luma, max_luma, min_chroma, max_chroma;
-
-    if (params->clip_to_restricted_range) {
-        min_luma = min_luma_legal_range;
-        max_luma = max_luma_legal_range;
-
-        min_chroma = min_chroma_legal_range;
-        max_chroma = max_chroma_legal_range;
-    } else {
-        min_luma = min_chroma = 0;
-        max_luma = max_chroma = 255;
+void svt_av1_add_noise_luma_hbd_c(uint16_t *luma, int32_t luma_stride, const int32_t *grain,
+                                  int32_t grain_stride, int32_t width, int32_t height,
+                                  const FgnPlaneParams *plane) {
+    const int32_t rounding_offset = (1 << (plane->scaling_shift - 1));
+
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
+            luma[i * luma_stride + j] = clamp(
+                luma[i * luma_stride + j] +
+                    ((scale_lut(plane->scaling_lut, luma[i * luma_stride + j], plane->bit_depth) *
+                          grain[i * grain_stride + j] +
+                      rounding_offset) >>
+                     plane->scaling_shift),
+                plane->min_value,
+                plane->max_value);
+        }
     }
+}
 
-    for (int32_t i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-        for (int32_t j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
+void svt_av1_add_noise_chroma_c(uint8_t *chroma, int32_t chroma_stride, const uint8_t *luma,
+                                int32_t luma_stride, const int32_t *grain, int32_t grain_stride,
+                                int32_t width, int32_t height, const FgnPlaneParams *plane) {
+    const int32_t rounding_offset  = (1 << (plane->scaling_shift - 1));
+    const int32_t chroma_subsamp_x = plane->subsamp_x;
+    const int32_t chroma_subsamp_y = plane->subsamp_y;
+
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
             int32_t average_luma = 0;
             if (chroma_subsamp_x) {
                 average_luma =
@@ -640,107 +580,34 @@ static void add_noise_to_block(AomFilmGrain *params, uint8_t *luma, uint8_t *cb,
                     1;
             } else
                 average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-            if (apply_cb) {
-                cb[i * chroma_stride + j] = clamp(
-                    cb[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cb,
-                                    clamp(((average_luma * cb_luma_mult +
-                                            cb_mult * cb[i * chroma_stride + j]) >>
-                                           6) +
-                                              cb_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    8) *
-                              cb_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
-
-            if (apply_cr) {
-                cr[i * chroma_stride + j] = clamp(
-                    cr[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cr,
-                                    clamp(((average_luma * cr_luma_mult +
-                                            cr_mult * cr[i * chroma_stride + j]) >>
-                                           6) +
-                                              cr_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    8) *
-                              cr_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
-        }
-    }
-
-    if (apply_y) {
-        for (int32_t i = 0; i < (half_luma_height << 1); i++) {
-            for (int32_t j = 0; j < (half_luma_width << 1); j++) {
-                luma[i * luma_stride + j] = clamp(
-                    luma[i * luma_stride + j] +
-                        ((scale_lut(scaling_lut_y, luma[i * luma_stride + j], 8) *
-                              luma_grain[i * luma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_luma,
-                    max_luma);
-            }
+            chroma[i * chroma_stride + j] = clamp(
+                chroma[i * chroma_stride + j] +
+                    ((scale_lut(plane->scaling_lut,
+                                clamp(((average_luma * plane->luma_mult +
+                                        plane->mult * chroma[i * chroma_stride + j]) >>
+                                       6) +
+                                          plane->offset,
+                                      0,
+                                      (256 << (plane->bit_depth - 8)) - 1),
+                                8) *
+                          grain[i * grain_stride + j] +
+                      rounding_offset) >>
+                     plane->scaling_shift),
+                plane->min_value,
+                plane->max_value);
         }
     }
 }
 
-static void add_noise_to_block_hbd(AomFilmGrain *params, uint16_t *luma, uint16_t *cb, uint16_t *cr,
-                                   int32_t luma_stride, int32_t chroma_stride, int32_t *luma_grain,
-                                   int32_t *cb_grain, int32_t *cr_grain, int32_t luma_grain_stride,
-                                   int32_t chroma_grain_stride, int32_t half_luma_height,
-                                   int32_t half_luma_width, int32_t bit_depth,
-                                   int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
-    int32_t cb_mult      = params->cb_mult - 128; // fixed scale
-    int32_t cb_luma_mult = params->cb_luma_mult - 128; // fixed scale
-    // offset value depends on the bit depth
-    int32_t cb_offset = (params->cb_offset << (bit_depth - 8)) - (1 << bit_depth);
-
-    int32_t cr_mult      = params->cr_mult - 128; // fixed scale
-    int32_t cr_luma_mult = params->cr_luma_mult - 128; // fixed scale
-    // offset value depends on the bit depth
-    int32_t cr_offset = (params->cr_offset << (bit_depth - 8)) - (1 << bit_depth);
-
-    int32_t rounding_offset = (1 << (params->scaling_shift - 1));
-
-    int32_t apply_y  = params->num_y_points > 0 ? 1 : 0;
-    int32_t apply_cb = params->num_cb_points > 0 ? 1 : 0;
-    int32_t apply_cr = params->num_cr_points > 0 ? 1 : 0;
-
-    if (params->chroma_scaling_from_luma) {
-        cb_mult      = 0; // fixed scale
-        cb_luma_mult = 64; // fixed scale
-        cb_offset    = 0;
-
-        cr_mult      = 0; // fixed scale
-        cr_luma_mult = 64; // fixed scale
-        cr_offset    = 0;
-    }
+void svt_av1_add_noise_chroma_hbd_c(uint16_t *chroma, int32_t chroma_stride, const uint16_t *luma,
+                                    int32_t luma_stride, const int32_t *grain, int32_t grain_stride,
+                                    int32_t width, int32_t height, const FgnPlaneParams *plane) {
+    const int32_t rounding_offset  = (1 << (plane->scaling_shift - 1));
+    const int32_t chroma_subsamp_x = plane->subsamp_x;
+    const int32_t chroma_subsamp_y = plane->subsamp_y;
 
-    int32_t min_luma, max_luma, min_chroma, max_chroma;
-
-    if (params->clip_to_restricted_range) {
-        min_luma = min_luma_legal_range << (bit_depth - 8);
-        max_luma = max_luma_legal_range << (bit_depth - 8);
-
-        min_chroma = min_chroma_legal_range << (bit_depth - 8);
-        max_chroma = max_chroma_legal_range << (bit_depth - 8);
-    } else {
-        min_luma = min_chroma = 0;
-        max_luma = max_chroma = (256 << (bit_depth - 8)) - 1;
-    }
-
-    for (int32_t i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-        for (int32_t j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
             int32_t average_luma = 0;
             if (chroma_subsamp_x) {
                 average_luma =
@@ -750,56 +617,95 @@ static void add_noise_to_block_hbd(AomFilmGrain *params, uint16_t *luma, uint16_
                     1;
             } else
                 average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-            if (apply_cb) {
-                cb[i * chroma_stride + j] = clamp(
-                    cb[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cb,
-                                    clamp(((average_luma * cb_luma_mult +
-                                            cb_mult * cb[i * chroma_stride + j]) >>
-                                           6) +
-                                              cb_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    bit_depth) *
-                              cb_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
-            if (apply_cr) {
-                cr[i * chroma_stride + j] = clamp(
-                    cr[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cr,
-                                    clamp(((average_luma * cr_luma_mult +
-                                            cr_mult * cr[i * chroma_stride + j]) >>
-                                           6) +
-                                              cr_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    bit_depth) *
-                              cr_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
+            chroma[i * chroma_stride + j] = clamp(
+                chroma[i * chroma_stride + j] +
+                    ((scale_lut(plane->scaling_lut,
+                                clamp(((average_luma * plane->luma_mult +
+                                        plane->mult * chroma[i * chroma_stride + j]) >>
+                                       6) +
+                                          plane->offset,
+                                      0,
+                                      (256 << (plane->bit_depth - 8)) - 1),
+                                plane->bit_depth) *
+                          grain[i * grain_stride + j] +
+                      rounding_offset) >>
+                     plane->scaling_shift),
+                plane->min_value,
+                plane->max_value);
         }
     }
+}
 
-    if (apply_y) {
-        for (int32_t i = 0; i < (half_luma_height << 1); i++) {
-            for (int32_t j = 0; j < (half_luma_width << 1); j++) {
-                luma[i * luma_stride + j] = clamp(
-                    luma[i * luma_stride + j] +
-                        ((scale_lut(scaling_lut_y, luma[i * luma_stride + j], bit_depth) *
-                              luma_grain[i * luma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_luma,
-                    max_luma);
-            }
-        }
+// luma_offset and chroma_offset are in samples, the chroma noise is added
+// first as its scaling function reads the luma before noise
+static void add_noise_to_block(const FilmGrainCtxt *ctx, int32_t luma_offset,
+                               int32_t chroma_offset, int32_t *luma_grain, int32_t *cb_grain,
+                               int32_t *cr_grain, int32_t luma_grain_stride,
+                               int32_t chroma_grain_stride, int32_t half_luma_height,
+                               int32_t half_luma_width) {
+    const int32_t chroma_height = half_luma_height << (1 - ctx->chroma_subsamp_y);
+    const int32_t chroma_width  = half_luma_width << (1 - ctx->chroma_subsamp_x);
+
+    if (ctx->use_high_bit_depth) {
+        uint16_t *luma = (uint16_t *)ctx->luma + luma_offset;
+        if (ctx->apply_cb)
+            svt_av1_add_noise_chroma_hbd((uint16_t *)ctx->cb + chroma_offset,
+                                         ctx->chroma_stride,
+                                         luma,
+                                         ctx->luma_stride,
+                                         cb_grain,
+                                         chroma_grain_stride,
+                                         chroma_width,
+                                         chroma_height,
+                                         &ctx->plane_cb);
+        if (ctx->apply_cr)
+            svt_av1_add_noise_chroma_hbd((uint16_t *)ctx->cr + chroma_offset,
+                                         ctx->chroma_stride,
+                                         luma,
+                                         ctx->luma_stride,
+                                         cr_grain,
+                                         chroma_grain_stride,
+                                         chroma_width,
+                                         chroma_height,
+                                         &ctx->plane_cr);
+        if (ctx->apply_y)
+            svt_av1_add_noise_luma_hbd(luma,
+                                       ctx->luma_stride,
+                                       luma_grain,
+                                       luma_grain_stride,
+                                       half_luma_width << 1,
+                                       half_luma_height << 1,
+                                       &ctx->plane_y);
+    } else {
+        uint8_t *luma = ctx->luma + luma_offset;
+        if (ctx->apply_cb)
+            svt_av1_add_noise_chroma(ctx->cb + chroma_offset,
+                                     ctx->chroma_stride,
+                                     luma,
+                                     ctx->luma_stride,
+                                     cb_grain,
+                                     chroma_grain_stride,
+                                     chroma_width,
+                                     chroma_height,
+                                     &ctx->plane_cb);
+        if (ctx->apply_cr)
+            svt_av1_add_noise_chroma(ctx->cr + chroma_offset,
+                                     ctx->chroma_stride,
+                                     luma,
+                                     ctx->luma_stride,
+                                     cr_grain,
+                                     chroma_grain_stride,
+                                     chroma_width,
+                                     chroma_height,
+                                     &ctx->plane_cr);
+        if (ctx->apply_y)
+            svt_av1_add_noise_luma(luma,
+                                   ctx->luma_stride,
+                                   luma_grain,
+                                   luma_grain_stride,
+                                   half_luma_width << 1,
+                                   half_luma_height << 1,
+                                   &ctx->plane_y);
     }
 }
 
@@ -897,7 +803,8 @@ static void copy_area(int32_t *src, int32_t src_stride, int32_t *dst, int32_t ds
 
 static void ver_boundary_overlap(int32_t *left_block, int32_t left_stride, int32_t *right_block,
                                  int32_t right_stride, int32_t *dst_block, int32_t dst_stride,
-                                 int32_t width, int32_t height) {
+                                 int32_t width, int32_t height, int32_t grain_min,
+                                 int32_t grain_max) {
     if (width == 1) {
         while (height) {
             *dst_block = clamp(
@@ -925,7 +832,8 @@ static void ver_boundary_overlap(int32_t *left_block, int32_t left_stride, int32
 
 static void hor_boundary_overlap(int32_t *top_block, int32_t top_stride, int32_t *bottom_block,
                                  int32_t bottom_stride, int32_t *dst_block, int32_t dst_stride,
-                                 int32_t width, int32_t height) {
+                                 int32_t width, int32_t height, int32_t grain_min,
+                                 int32_t grain_max) {
     if (height == 1) {
         while (width) {
             *dst_block = clamp(
@@ -953,16 +861,9 @@ static void hor_boundary_overlap(int32_t *top_block, int32_t top_stride, int32_t
     }
 }
 
-void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb, uint8_t *cr,
-                                int32_t height, int32_t width, int32_t luma_stride,
-                                int32_t chroma_stride, int32_t use_high_bit_depth,
-                                int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
-    int32_t **pred_pos_luma;
-    int32_t **pred_pos_chroma;
-    int32_t * luma_grain_block;
-    int32_t * cb_grain_block;
-    int32_t * cr_grain_block;
-
+/* Overlap buffers carried from a stripe to the next one (line) and from a
+   block to the next one in the stripe (column) */
+typedef struct FgnOverlapBufs {
     int32_t *y_line_buf;
     int32_t *cb_line_buf;
     int32_t *cr_line_buf;
@@ -970,8 +871,383 @@ void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb
     int32_t *y_col_buf;
     int32_t *cb_col_buf;
     int32_t *cr_col_buf;
+} FgnOverlapBufs;
+
+static void free_overlap_bufs(FgnOverlapBufs *bufs) {
+    free(bufs->y_line_buf);
+    free(bufs->cb_line_buf);
+    free(bufs->cr_line_buf);
+    free(bufs->y_col_buf);
+    free(bufs->cb_col_buf);
+    free(bufs->cr_col_buf);
+}
+
+static EbErrorType alloc_overlap_bufs(const FilmGrainCtxt *ctx, FgnOverlapBufs *bufs) {
+    const int32_t chroma_subsamp_y       = ctx->chroma_subsamp_y;
+    const int32_t chroma_subsamp_x       = ctx->chroma_subsamp_x;
+    const int32_t luma_subblock_size_y   = FGN_STRIPE_HEIGHT;
+    const int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+
+    bufs->y_line_buf  = (int32_t *)malloc(sizeof(*bufs->y_line_buf) * ctx->luma_stride * 2);
+    bufs->cb_line_buf = (int32_t *)malloc(sizeof(*bufs->cb_line_buf) * ctx->chroma_stride *
+                                          (2 >> chroma_subsamp_y));
+    bufs->cr_line_buf = (int32_t *)malloc(sizeof(*bufs->cr_line_buf) * ctx->chroma_stride *
+                                          (2 >> chroma_subsamp_y));
+
+    bufs->y_col_buf  = (int32_t *)malloc(sizeof(*bufs->y_col_buf) * (luma_subblock_size_y + 2) *
+                                        2);
+    bufs->cb_col_buf = (int32_t *)malloc(sizeof(*bufs->cb_col_buf) *
+                                         (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
+                                         (2 >> chroma_subsamp_x));
+    bufs->cr_col_buf = (int32_t *)malloc(sizeof(*bufs->cr_col_buf) *
+                                         (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
+                                         (2 >> chroma_subsamp_x));
+
+    if (!bufs->y_line_buf || !bufs->cb_line_buf || !bufs->cr_line_buf || !bufs->y_col_buf ||
+        !bufs->cb_col_buf || !bufs->cr_col_buf) {
+        free_overlap_bufs(bufs);
+        return EB_ErrorInsufficientResources;
+    }
+    return EB_ErrorNone;
+}
+
+/* Adds the grain to the FGN_STRIPE_HEIGHT luma rows starting at row y * 2.
+   Without add_noise only the overlap buffers are updated, as needed to
+   start with the next stripe. */
+static void add_noise_to_stripe(const FilmGrainCtxt *ctx, FgnOverlapBufs *bufs, int32_t y,
+                                int32_t add_noise) {
+    const AomFilmGrain *params = &ctx->params;
+
+    int32_t *luma_grain_block = ctx->luma_grain_block;
+    int32_t *cb_grain_block   = ctx->cb_grain_block;
+    int32_t *cr_grain_block   = ctx->cr_grain_block;
+
+    int32_t *y_line_buf  = bufs->y_line_buf;
+    int32_t *cb_line_buf = bufs->cb_line_buf;
+    int32_t *cr_line_buf = bufs->cr_line_buf;
+
+    int32_t *y_col_buf  = bufs->y_col_buf;
+    int32_t *cb_col_buf = bufs->cb_col_buf;
+    int32_t *cr_col_buf = bufs->cr_col_buf;
+
+    const int32_t height              = ctx->height;
+    const int32_t width               = ctx->width;
+    const int32_t luma_stride         = ctx->luma_stride;
+    const int32_t chroma_stride       = ctx->chroma_stride;
+    const int32_t chroma_subsamp_y    = ctx->chroma_subsamp_y;
+    const int32_t chroma_subsamp_x    = ctx->chroma_subsamp_x;
+    const int32_t luma_grain_stride   = ctx->luma_grain_stride;
+    const int32_t chroma_grain_stride = ctx->chroma_grain_stride;
+    const int32_t grain_min           = ctx->grain_min;
+    const int32_t grain_max           = ctx->grain_max;
+
+    int32_t left_pad   = 3;
+    int32_t top_pad    = 3;
+    int32_t ar_padding = 3; // maximum lag used for stabilization of AR coefficients
+
+    const int32_t luma_subblock_size_y   = FGN_STRIPE_HEIGHT;
+    const int32_t luma_subblock_size_x   = FGN_STRIPE_HEIGHT;
+    const int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+    const int32_t chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+
+    int32_t  overlap = params->overlap_flag;
+    uint16_t random_register;
+
+    init_random_generator(&random_register, y * 2, params->random_seed);
+
+    for (int32_t x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
+        int32_t offset_y = get_random_number(&random_register, 8);
+        int32_t offset_x = (offset_y >> 4) & 15;
+        offset_y &= 15;
+
+        int32_t luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
+        int32_t luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
+
+        int32_t chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
+            offset_y * (2 >> chroma_subsamp_y);
+        int32_t chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
+            offset_x * (2 >> chroma_subsamp_x);
+
+        if (overlap && x) {
+            ver_boundary_overlap(y_col_buf,
+                                 2,
+                                 luma_grain_block + luma_offset_y * luma_grain_stride +
+                                     luma_offset_x,
+                                 luma_grain_stride,
+                                 y_col_buf,
+                                 2,
+                                 2,
+                                 AOMMIN(luma_subblock_size_y + 2, height - (y << 1)),
+                                 grain_min,
+                                 grain_max);
+
+            ver_boundary_overlap(
+                cb_col_buf,
+                2 >> chroma_subsamp_x,
+                cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
+                chroma_grain_stride,
+                cb_col_buf,
+                2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y),
+                grain_min,
+                grain_max);
+
+            ver_boundary_overlap(
+                cr_col_buf,
+                2 >> chroma_subsamp_x,
+                cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
+                chroma_grain_stride,
+                cr_col_buf,
+                2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y),
+                grain_min,
+                grain_max);
+
+            int32_t i = y ? 1 : 0;
+
+            if (add_noise)
+                add_noise_to_block(
+                    ctx,
+                    ((y + i) << 1) * luma_stride + (x << 1),
+                    ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
+                        (x << (1 - chroma_subsamp_x)),
+                    y_col_buf + i * 4,
+                    cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+                    cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+                    2,
+                    (2 - chroma_subsamp_x),
+                    AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
+                    1);
+        }
+
+        // The line buffer is rewritten below for the next stripe, the
+        // horizontal overlap only matters to the noise of this one
+        if (overlap && y && add_noise) {
+            if (x) {
+                ASSERT(y_col_buf != NULL);
+                hor_boundary_overlap(y_line_buf + (x << 1),
+                                     luma_stride,
+                                     y_col_buf,
+                                     2,
+                                     y_line_buf + (x << 1),
+                                     luma_stride,
+                                     2,
+                                     2,
+                                     grain_min,
+                                     grain_max);
+
+                hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     cb_col_buf,
+                                     2 >> chroma_subsamp_x,
+                                     cb_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     2 >> chroma_subsamp_x,
+                                     2 >> chroma_subsamp_y,
+                                     grain_min,
+                                     grain_max);
+
+                hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     cr_col_buf,
+                                     2 >> chroma_subsamp_x,
+                                     cr_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     2 >> chroma_subsamp_x,
+                                     2 >> chroma_subsamp_y,
+                                     grain_min,
+                                     grain_max);
+            }
 
-    random_register = params->random_seed;
+            hor_boundary_overlap(y_line_buf + ((x ? x + 1 : 0) << 1),
+                                 luma_stride,
+                                 luma_grain_block + luma_offset_y * luma_grain_stride +
+                                     luma_offset_x + (x ? 2 : 0),
+                                 luma_grain_stride,
+                                 y_line_buf + ((x ? x + 1 : 0) << 1),
+                                 luma_stride,
+                                 AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
+                                        width - ((x ? x + 1 : 0) << 1)),
+                                 2,
+                                 grain_min,
+                                 grain_max);
+
+            hor_boundary_overlap(
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                    ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_grain_stride,
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                       (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+                2 >> chroma_subsamp_y,
+                grain_min,
+                grain_max);
+
+            hor_boundary_overlap(
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                    ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_grain_stride,
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                       (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+                2 >> chroma_subsamp_y,
+                grain_min,
+                grain_max);
+
+            add_noise_to_block(ctx,
+                               (y << 1) * luma_stride + (x << 1),
+                               (y << (1 - chroma_subsamp_y)) * chroma_stride +
+                                   (x << ((1 - chroma_subsamp_x))),
+                               y_line_buf + (x << 1),
+                               cb_line_buf + (x << (1 - chroma_subsamp_x)),
+                               cr_line_buf + (x << (1 - chroma_subsamp_x)),
+                               luma_stride,
+                               chroma_stride,
+                               1,
+                               AOMMIN(luma_subblock_size_x >> 1, width / 2 - x));
+        }
+
+        int32_t i = overlap && y ? 1 : 0;
+        int32_t j = overlap && x ? 1 : 0;
+
+        if (add_noise)
+            add_noise_to_block(
+                ctx,
+                ((y + i) << 1) * luma_stride + ((x + j) << 1),
+                ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
+                    ((x + j) << (1 - chroma_subsamp_x)),
+                luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
+                    luma_offset_x + (j << 1),
+                cb_grain_block +
+                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
+                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+                cr_grain_block +
+                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
+                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+                luma_grain_stride,
+                chroma_grain_stride,
+                AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
+                AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j);
+
+        if (overlap) {
+            if (x) {
+                // Copy overlapped column bufer to line buffer
+                copy_area(y_col_buf + (luma_subblock_size_y << 1),
+                          2,
+                          y_line_buf + (x << 1),
+                          luma_stride,
+                          2,
+                          2);
+
+                copy_area(cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+                          2 >> chroma_subsamp_x,
+                          cb_line_buf + (x << (1 - chroma_subsamp_x)),
+                          chroma_stride,
+                          2 >> chroma_subsamp_x,
+                          2 >> chroma_subsamp_y);
+
+                copy_area(cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+                          2 >> chroma_subsamp_x,
+                          cr_line_buf + (x << (1 - chroma_subsamp_x)),
+                          chroma_stride,
+                          2 >> chroma_subsamp_x,
+                          2 >> chroma_subsamp_y);
+            }
+
+            // Copy grain to the line buffer for overlap with a bottom block
+            copy_area(luma_grain_block +
+                          (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
+                          luma_offset_x + ((x ? 2 : 0)),
+                      luma_grain_stride,
+                      y_line_buf + ((x ? x + 1 : 0) << 1),
+                      luma_stride,
+                      AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0),
+                      2);
+
+            copy_area(cb_grain_block +
+                          (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
+                          chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                      chroma_grain_stride,
+                      cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                      chroma_stride,
+                      AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
+                          (x ? 2 >> chroma_subsamp_x : 0),
+                      2 >> chroma_subsamp_y);
+
+            copy_area(cr_grain_block +
+                          (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
+                          chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                      chroma_grain_stride,
+                      cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                      chroma_stride,
+                      AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
+                          (x ? 2 >> chroma_subsamp_x : 0),
+                      2 >> chroma_subsamp_y);
+
+            // Copy grain to the column buffer for overlap with the next block to
+            // the right
+
+            copy_area(luma_grain_block + luma_offset_y * luma_grain_stride + luma_offset_x +
+                          luma_subblock_size_x,
+                      luma_grain_stride,
+                      y_col_buf,
+                      2,
+                      2,
+                      AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+
+            copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                          chroma_subblock_size_x,
+                      chroma_grain_stride,
+                      cb_col_buf,
+                      2 >> chroma_subsamp_x,
+                      2 >> chroma_subsamp_x,
+                      AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                             (height - (y << 1)) >> chroma_subsamp_y));
+
+            copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                          chroma_subblock_size_x,
+                      chroma_grain_stride,
+                      cr_col_buf,
+                      2 >> chroma_subsamp_x,
+                      2 >> chroma_subsamp_x,
+                      AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                             (height - (y << 1)) >> chroma_subsamp_y));
+        }
+    }
+}
+
+EbErrorType svt_av1_film_grain_init(FilmGrainCtxt *ctx, const AomFilmGrain *grain_params,
+                                    uint8_t *luma, uint8_t *cb, uint8_t *cr, int32_t height,
+                                    int32_t width, int32_t luma_stride, int32_t chroma_stride,
+                                    int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
+                                    int32_t chroma_subsamp_x) {
+    AomFilmGrain *params = &ctx->params;
+    int32_t **    pred_pos_luma;
+    int32_t **    pred_pos_chroma;
+    uint16_t      random_register = grain_params->random_seed;
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->params             = *grain_params;
+    ctx->luma               = luma;
+    ctx->cb                 = cb;
+    ctx->cr                 = cr;
+    ctx->height             = height;
+    ctx->width              = width;
+    ctx->luma_stride        = luma_stride;
+    ctx->chroma_stride      = chroma_stride;
+    ctx->use_high_bit_depth = use_high_bit_depth;
+    ctx->chroma_subsamp_y   = chroma_subsamp_y;
+    ctx->chroma_subsamp_x   = chroma_subsamp_x;
 
     int32_t left_pad   = 3;
     int32_t right_pad  = 3; // padding to offset for AR coefficients
@@ -980,11 +1256,10 @@ void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb
 
     int32_t ar_padding = 3; // maximum lag used for stabilization of AR coefficients
 
-    luma_subblock_size_y = 32;
-    luma_subblock_size_x = 32;
-
-    chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
-    chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+    const int32_t luma_subblock_size_y   = FGN_STRIPE_HEIGHT;
+    const int32_t luma_subblock_size_x   = FGN_STRIPE_HEIGHT;
+    const int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+    const int32_t chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
 
     // Initial padding is only needed for generation of
     // film grain templates (to stabilize the AR process)
@@ -1000,56 +1275,50 @@ void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb
     int32_t chroma_block_size_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
         chroma_subblock_size_x * 2 + (2 >> chroma_subsamp_x) * ar_padding + right_pad;
 
-    int32_t luma_grain_stride   = luma_block_size_x;
-    int32_t chroma_grain_stride = chroma_block_size_x;
+    ctx->luma_grain_stride   = luma_block_size_x;
+    ctx->chroma_grain_stride = chroma_block_size_x;
 
-    int32_t overlap   = params->overlap_flag;
     int32_t bit_depth = params->bit_depth;
 
-    grain_center = 128 << (bit_depth - 8);
-    grain_min    = 0 - grain_center;
-    grain_max    = (256 << (bit_depth - 8)) - 1 - grain_center;
+    int32_t grain_center = 128 << (bit_depth - 8);
+    ctx->grain_min       = 0 - grain_center;
+    ctx->grain_max       = (256 << (bit_depth - 8)) - 1 - grain_center;
+
+    ctx->luma_grain_block = (int32_t *)malloc(sizeof(*ctx->luma_grain_block) * luma_block_size_y *
+                                              luma_block_size_x);
+    ctx->cb_grain_block   = (int32_t *)malloc(sizeof(*ctx->cb_grain_block) * chroma_block_size_y *
+                                            chroma_block_size_x);
+    ctx->cr_grain_block   = (int32_t *)malloc(sizeof(*ctx->cr_grain_block) * chroma_block_size_y *
+                                            chroma_block_size_x);
+    if (!ctx->luma_grain_block || !ctx->cb_grain_block || !ctx->cr_grain_block) {
+        svt_av1_film_grain_free(ctx);
+        return EB_ErrorInsufficientResources;
+    }
 
-    init_arrays(params,
-                luma_stride,
-                chroma_stride,
-                &pred_pos_luma,
-                &pred_pos_chroma,
-                &luma_grain_block,
-                &cb_grain_block,
-                &cr_grain_block,
-                &y_line_buf,
-                &cb_line_buf,
-                &cr_line_buf,
-                &y_col_buf,
-                &cb_col_buf,
-                &cr_col_buf,
-                luma_block_size_y * luma_block_size_x,
-                chroma_block_size_y * chroma_block_size_x,
-                chroma_subsamp_y,
-                chroma_subsamp_x);
-
-    generate_luma_grain_block(params,
+    init_pred_pos(params, &pred_pos_luma, &pred_pos_chroma);
+
+    generate_luma_grain_block(ctx,
+                              &random_register,
                               pred_pos_luma,
-                              luma_grain_block,
+                              ctx->luma_grain_block,
                               luma_block_size_y,
                               luma_block_size_x,
-                              luma_grain_stride,
+                              ctx->luma_grain_stride,
                               left_pad,
                               top_pad,
                               right_pad,
                               bottom_pad);
 
-    generate_chroma_grain_blocks(params,
+    generate_chroma_grain_blocks(ctx,
                                  //                               pred_pos_luma,
                                  pred_pos_chroma,
-                                 luma_grain_block,
-                                 cb_grain_block,
-                                 cr_grain_block,
-                                 luma_grain_stride,
+                                 ctx->luma_grain_block,
+                                 ctx->cb_grain_block,
+                                 ctx->cr_grain_block,
+                                 ctx->luma_grain_stride,
                                  chroma_block_size_y,
                                  chroma_block_size_x,
-                                 chroma_grain_stride,
+                                 ctx->chroma_grain_stride,
                                  left_pad,
                                  top_pad,
                                  right_pad,
@@ -1057,371 +1326,148 @@ void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb
                                  chroma_subsamp_y,
                                  chroma_subsamp_x);
 
-    init_scaling_function(params->scaling_points_y, params->num_y_points, scaling_lut_y);
+    dealloc_pred_pos(params, pred_pos_luma, pred_pos_chroma);
+
+    init_scaling_function(params->scaling_points_y, params->num_y_points, ctx->scaling_lut_y);
 
     if (params->chroma_scaling_from_luma) {
-        svt_memcpy(scaling_lut_cb, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
-        svt_memcpy(scaling_lut_cr, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
+        svt_memcpy(ctx->scaling_lut_cb, ctx->scaling_lut_y, sizeof(*ctx->scaling_lut_y) * 256);
+        svt_memcpy(ctx->scaling_lut_cr, ctx->scaling_lut_y, sizeof(*ctx->scaling_lut_y) * 256);
     } else {
-        init_scaling_function(params->scaling_points_cb, params->num_cb_points, scaling_lut_cb);
-        init_scaling_function(params->scaling_points_cr, params->num_cr_points, scaling_lut_cr);
+        init_scaling_function(
+            params->scaling_points_cb, params->num_cb_points, ctx->scaling_lut_cb);
+        init_scaling_function(
+            params->scaling_points_cr, params->num_cr_points, ctx->scaling_lut_cr);
     }
-    for (int32_t y = 0; y < height / 2; y += (luma_subblock_size_y >> 1)) {
-        init_random_generator(y * 2, params->random_seed);
-
-        for (int32_t x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
-            int32_t offset_y = get_random_number(8);
-            int32_t offset_x = (offset_y >> 4) & 15;
-            offset_y &= 15;
 
-            int32_t luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
-            int32_t luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
-
-            int32_t chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
-                offset_y * (2 >> chroma_subsamp_y);
-            int32_t chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
-                offset_x * (2 >> chroma_subsamp_x);
-
-            if (overlap && x) {
-                ver_boundary_overlap(
-                    y_col_buf,
-                    2,
-                    luma_grain_block + luma_offset_y * luma_grain_stride + luma_offset_x,
-                    luma_grain_stride,
-                    y_col_buf,
-                    2,
-                    2,
-                    AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-                ver_boundary_overlap(
-                    cb_col_buf,
-                    2 >> chroma_subsamp_x,
-                    cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
-                    chroma_grain_stride,
-                    cb_col_buf,
-                    2 >> chroma_subsamp_x,
-                    2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                           (height - (y << 1)) >> chroma_subsamp_y));
-
-                ver_boundary_overlap(
-                    cr_col_buf,
-                    2 >> chroma_subsamp_x,
-                    cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
-                    chroma_grain_stride,
-                    cr_col_buf,
-                    2 >> chroma_subsamp_x,
-                    2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                           (height - (y << 1)) >> chroma_subsamp_y));
-
-                int32_t i = y ? 1 : 0;
-
-                if (use_high_bit_depth) {
-                    add_noise_to_block_hbd(
-                        params,
-                        (uint16_t *)luma + ((y + i) << 1) * luma_stride + (x << 1),
-                        (uint16_t *)cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        (uint16_t *)cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        luma_stride,
-                        chroma_stride,
-                        y_col_buf + i * 4,
-                        cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        2,
-                        (2 - chroma_subsamp_x),
-                        AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                        1,
-                        bit_depth,
-                        chroma_subsamp_y,
-                        chroma_subsamp_x);
-                } else {
-                    add_noise_to_block(
-                        params,
-                        luma + ((y + i) << 1) * luma_stride + (x << 1),
-                        cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        luma_stride,
-                        chroma_stride,
-                        y_col_buf + i * 4,
-                        cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        2,
-                        (2 - chroma_subsamp_x),
-                        AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                        1,
-                        bit_depth,
-                        chroma_subsamp_y,
-                        chroma_subsamp_x);
-                }
-            }
-
-            if (overlap && y) {
-                if (x) {
-                    ASSERT(y_col_buf != NULL);
-                    hor_boundary_overlap(y_line_buf + (x << 1),
-                                         luma_stride,
-                                         y_col_buf,
-                                         2,
-                                         y_line_buf + (x << 1),
-                                         luma_stride,
-                                         2,
-                                         2);
-
-                    hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         cb_col_buf,
-                                         2 >> chroma_subsamp_x,
-                                         cb_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         2 >> chroma_subsamp_x,
-                                         2 >> chroma_subsamp_y);
-
-                    hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         cr_col_buf,
-                                         2 >> chroma_subsamp_x,
-                                         cr_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         2 >> chroma_subsamp_x,
-                                         2 >> chroma_subsamp_y);
-                }
-
-                hor_boundary_overlap(y_line_buf + ((x ? x + 1 : 0) << 1),
-                                     luma_stride,
-                                     luma_grain_block + luma_offset_y * luma_grain_stride +
-                                         luma_offset_x + (x ? 2 : 0),
-                                     luma_grain_stride,
-                                     y_line_buf + ((x ? x + 1 : 0) << 1),
-                                     luma_stride,
-                                     AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
-                                            width - ((x ? x + 1 : 0) << 1)),
-                                     2);
-
-                hor_boundary_overlap(
-                    cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                        ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_grain_stride,
-                    cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                           (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-                    2 >> chroma_subsamp_y);
-
-                hor_boundary_overlap(
-                    cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                        ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_grain_stride,
-                    cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                           (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-                    2 >> chroma_subsamp_y);
-
-                if (use_high_bit_depth) {
-                    add_noise_to_block_hbd(
-                        params,
-                        (uint16_t *)luma + (y << 1) * luma_stride + (x << 1),
-                        (uint16_t *)cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << ((1 - chroma_subsamp_x))),
-                        (uint16_t *)cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << ((1 - chroma_subsamp_x))),
-                        luma_stride,
-                        chroma_stride,
-                        y_line_buf + (x << 1),
-                        cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                        cr_line_buf + (x << (1 - chroma_subsamp_x)),
-                        luma_stride,
-                        chroma_stride,
-                        1,
-                        AOMMIN(luma_subblock_size_x >> 1, width / 2 - x),
-                        bit_depth,
-                        chroma_subsamp_y,
-                        chroma_subsamp_x);
-                } else {
-                    add_noise_to_block(params,
-                                       luma + (y << 1) * luma_stride + (x << 1),
-                                       cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                                           (x << ((1 - chroma_subsamp_x))),
-                                       cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                                           (x << ((1 - chroma_subsamp_x))),
-                                       luma_stride,
-                                       chroma_stride,
-                                       y_line_buf + (x << 1),
-                                       cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                                       cr_line_buf + (x << (1 - chroma_subsamp_x)),
-                                       luma_stride,
-                                       chroma_stride,
-                                       1,
-                                       AOMMIN(luma_subblock_size_x >> 1, width / 2 - x),
-                                       bit_depth,
-                                       chroma_subsamp_y,
-                                       chroma_subsamp_x);
-                }
-            }
-
-            int32_t i = overlap && y ? 1 : 0;
-            int32_t j = overlap && x ? 1 : 0;
-
-            if (use_high_bit_depth) {
-                add_noise_to_block_hbd(
-                    params,
-                    (uint16_t *)luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-                    (uint16_t *)cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    (uint16_t *)cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    luma_stride,
-                    chroma_stride,
-                    luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                        luma_offset_x + (j << 1),
-                    cb_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    cr_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    luma_grain_stride,
-                    chroma_grain_stride,
-                    AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                    AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j,
-                    bit_depth,
-                    chroma_subsamp_y,
-                    chroma_subsamp_x);
-            } else {
-                add_noise_to_block(
-                    params,
-                    luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-                    cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    luma_stride,
-                    chroma_stride,
-                    luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                        luma_offset_x + (j << 1),
-                    cb_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    cr_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    luma_grain_stride,
-                    chroma_grain_stride,
-                    AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                    AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j,
-                    bit_depth,
-                    chroma_subsamp_y,
-                    chroma_subsamp_x);
-            }
-
-            if (overlap) {
-                if (x) {
-                    // Copy overlapped column bufer to line buffer
-                    copy_area(y_col_buf + (luma_subblock_size_y << 1),
-                              2,
-                              y_line_buf + (x << 1),
-                              luma_stride,
-                              2,
-                              2);
-
-                    copy_area(cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-                              2 >> chroma_subsamp_x,
-                              cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                              chroma_stride,
-                              2 >> chroma_subsamp_x,
-                              2 >> chroma_subsamp_y);
-
-                    copy_area(cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-                              2 >> chroma_subsamp_x,
-                              cr_line_buf + (x << (1 - chroma_subsamp_x)),
-                              chroma_stride,
-                              2 >> chroma_subsamp_x,
-                              2 >> chroma_subsamp_y);
-                }
-
-                // Copy grain to the line buffer for overlap with a bottom block
-                copy_area(luma_grain_block +
-                              (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
-                              luma_offset_x + ((x ? 2 : 0)),
-                          luma_grain_stride,
-                          y_line_buf + ((x ? x + 1 : 0) << 1),
-                          luma_stride,
-                          AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0),
-                          2);
+    FgnPlaneParams *plane_y  = &ctx->plane_y;
+    FgnPlaneParams *plane_cb = &ctx->plane_cb;
+    FgnPlaneParams *plane_cr = &ctx->plane_cr;
+
+    plane_y->scaling_lut  = ctx->scaling_lut_y;
+    plane_cb->scaling_lut = ctx->scaling_lut_cb;
+    plane_cr->scaling_lut = ctx->scaling_lut_cr;
+
+    plane_y->scaling_shift = plane_cb->scaling_shift = plane_cr->scaling_shift =
+        params->scaling_shift;
+    plane_y->bit_depth = plane_cb->bit_depth = plane_cr->bit_depth = bit_depth;
+
+    plane_cb->mult      = params->cb_mult - 128; // fixed scale
+    plane_cb->luma_mult = params->cb_luma_mult - 128; // fixed scale
+    plane_cr->mult      = params->cr_mult - 128; // fixed scale
+    plane_cr->luma_mult = params->cr_luma_mult - 128; // fixed scale
+
+    ctx->apply_y = params->num_y_points > 0 ? 1 : 0;
+    if (use_high_bit_depth) {
+        // offset value depends on the bit depth
+        plane_cb->offset = (params->cb_offset << (bit_depth - 8)) - (1 << bit_depth);
+        plane_cr->offset = (params->cr_offset << (bit_depth - 8)) - (1 << bit_depth);
+
+        ctx->apply_cb = params->num_cb_points > 0 ? 1 : 0;
+        ctx->apply_cr = params->num_cr_points > 0 ? 1 : 0;
+
+        if (params->clip_to_restricted_range) {
+            plane_y->min_value  = min_luma_legal_range << (bit_depth - 8);
+            plane_y->max_value  = max_luma_legal_range << (bit_depth - 8);
+            plane_cb->min_value = min_chroma_legal_range << (bit_depth - 8);
+            plane_cb->max_value = max_chroma_legal_range << (bit_depth - 8);
+        } else {
+            plane_y->min_value = plane_cb->min_value = 0;
+            plane_y->max_value = plane_cb->max_value = (256 << (bit_depth - 8)) - 1;
+        }
+    } else {
+        plane_cb->offset = params->cb_offset - 256;
+        plane_cr->offset = params->cr_offset - 256;
+
+        ctx->apply_cb = (params->num_cb_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
+        ctx->apply_cr = (params->num_cr_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
+
+        if (params->clip_to_restricted_range) {
+            plane_y->min_value  = min_luma_legal_range;
+            plane_y->max_value  = max_luma_legal_range;
+            plane_cb->min_value = min_chroma_legal_range;
+            plane_cb->max_value = max_chroma_legal_range;
+        } else {
+            plane_y->min_value = plane_cb->min_value = 0;
+            plane_y->max_value = plane_cb->max_value = 255;
+        }
+    }
+    plane_cr->min_value = plane_cb->min_value;
+    plane_cr->max_value = plane_cb->max_value;
 
-                copy_area(cb_grain_block +
-                              (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
-                              chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                          chroma_grain_stride,
-                          cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                          chroma_stride,
-                          AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
-                              (x ? 2 >> chroma_subsamp_x : 0),
-                          2 >> chroma_subsamp_y);
+    if (params->chroma_scaling_from_luma) {
+        plane_cb->mult      = 0; // fixed scale
+        plane_cb->luma_mult = 64; // fixed scale
+        plane_cb->offset    = 0;
 
-                copy_area(cr_grain_block +
-                              (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
-                              chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                          chroma_grain_stride,
-                          cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                          chroma_stride,
-                          AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
-                              (x ? 2 >> chroma_subsamp_x : 0),
-                          2 >> chroma_subsamp_y);
+        plane_cr->mult      = 0; // fixed scale
+        plane_cr->luma_mult = 64; // fixed scale
+        plane_cr->offset    = 0;
+    }
 
-                // Copy grain to the column buffer for overlap with the next block to
-                // the right
+    plane_cb->subsamp_x = plane_cr->subsamp_x = chroma_subsamp_x;
+    plane_cb->subsamp_y = plane_cr->subsamp_y = chroma_subsamp_y;
+    return EB_ErrorNone;
+}
 
-                copy_area(luma_grain_block + luma_offset_y * luma_grain_stride + luma_offset_x +
-                              luma_subblock_size_x,
-                          luma_grain_stride,
-                          y_col_buf,
-                          2,
-                          2,
-                          AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+int32_t svt_av1_film_grain_stripe_count(const FilmGrainCtxt *ctx) {
+    const int32_t half_stripe_height = FGN_STRIPE_HEIGHT >> 1;
+    return (ctx->height / 2 + half_stripe_height - 1) / half_stripe_height;
+}
 
-                copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                              chroma_subblock_size_x,
-                          chroma_grain_stride,
-                          cb_col_buf,
-                          2 >> chroma_subsamp_x,
-                          2 >> chroma_subsamp_x,
-                          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                                 (height - (y << 1)) >> chroma_subsamp_y));
+EbErrorType svt_av1_film_grain_add_noise(const FilmGrainCtxt *ctx, int32_t first_stripe,
+                                         int32_t stripe_count) {
+    const int32_t  half_stripe_height = FGN_STRIPE_HEIGHT >> 1;
+    const int32_t  end_stripe         = AOMMIN(first_stripe + stripe_count,
+                                      svt_av1_film_grain_stripe_count(ctx));
+    FgnOverlapBufs bufs;
+
+    if (first_stripe >= end_stripe)
+        return EB_ErrorNone;
+    if (alloc_overlap_bufs(ctx, &bufs) != EB_ErrorNone)
+        return EB_ErrorInsufficientResources;
+
+    // The line buffer of the first stripe is left by the stripe above, the
+    // random offsets of each stripe only depend on its position
+    if (ctx->params.overlap_flag && first_stripe)
+        add_noise_to_stripe(ctx, &bufs, (first_stripe - 1) * half_stripe_height, 0);
+    for (int32_t stripe = first_stripe; stripe < end_stripe; stripe++)
+        add_noise_to_stripe(ctx, &bufs, stripe * half_stripe_height, 1);
+
+    free_overlap_bufs(&bufs);
+    return EB_ErrorNone;
+}
 
-                copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                              chroma_subblock_size_x,
-                          chroma_grain_stride,
-                          cr_col_buf,
-                          2 >> chroma_subsamp_x,
-                          2 >> chroma_subsamp_x,
-                          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                                 (height - (y << 1)) >> chroma_subsamp_y));
-            }
-        }
-    }
+void svt_av1_film_grain_free(FilmGrainCtxt *ctx) {
+    free(ctx->luma_grain_block);
+    free(ctx->cb_grain_block);
+    free(ctx->cr_grain_block);
+    ctx->luma_grain_block = NULL;
+    ctx->cb_grain_block   = NULL;
+    ctx->cr_grain_block   = NULL;
+}
 
-    dealloc_arrays(params,
-                   &pred_pos_luma,
-                   &pred_pos_chroma,
-                   &luma_grain_block,
-                   &cb_grain_block,
-                   &cr_grain_block,
-                   &y_line_buf,
-                   &cb_line_buf,
-                   &cr_line_buf,
-                   &y_col_buf,
-                   &cb_col_buf,
-                   &cr_col_buf);
+void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb, uint8_t *cr,
+                                int32_t height, int32_t width, int32_t luma_stride,
+                                int32_t chroma_stride, int32_t use_high_bit_depth,
+                                int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+    FilmGrainCtxt ctx;
+
+    if (svt_av1_film_grain_init(&ctx,
+                                params,
+                                luma,
+                                cb,
+                                cr,
+                                height,
+                                width,
+                                luma_stride,
+                                chroma_stride,
+                                use_high_bit_depth,
+                                chroma_subsamp_y,
+                                chroma_subsamp_x) != EB_ErrorNone)
+        return;
+    svt_av1_film_grain_add_noise(&ctx, 0, svt_av1_film_grain_stripe_count(&ctx));
+    svt_av1_film_grain_free(&ctx);
 }
 
 /*
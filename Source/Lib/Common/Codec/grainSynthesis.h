@@ -102,6 +102,70 @@ void svt_av1_add_film_grain_run(AomFilmGrain *grain_params, uint8_t *luma, uint8
                                 int32_t chroma_stride, int32_t use_high_bit_depth,
                                 int32_t chroma_subsamp_y, int32_t chroma_subsamp_x);
 
+/* Luma rows of a grain stripe, the noise of a stripe only depends on the
+   stripe above through the overlap line buffer */
+#define FGN_STRIPE_HEIGHT 32
+
+/*!\brief Film grain synthesis state of a frame
+     *
+     * The grain templates and the scaling functions are generated once by
+     * svt_av1_film_grain_init(), then svt_av1_film_grain_add_noise() adds the
+     * grain to any range of stripes, so that separate ranges can be processed
+     * by separate threads.
+     */
+typedef struct FilmGrainCtxt {
+    AomFilmGrain params;
+
+    uint8_t *luma;
+    uint8_t *cb;
+    uint8_t *cr;
+    int32_t  height;
+    int32_t  width;
+    int32_t  luma_stride;
+    int32_t  chroma_stride;
+    int32_t  use_high_bit_depth;
+    int32_t  chroma_subsamp_y;
+    int32_t  chroma_subsamp_x;
+
+    int32_t *luma_grain_block;
+    int32_t *cb_grain_block;
+    int32_t *cr_grain_block;
+    int32_t  luma_grain_stride;
+    int32_t  chroma_grain_stride;
+    int32_t  grain_min;
+    int32_t  grain_max;
+
+    int32_t        scaling_lut_y[256];
+    int32_t        scaling_lut_cb[256];
+    int32_t        scaling_lut_cr[256];
+    int32_t        apply_y;
+    int32_t        apply_cb;
+    int32_t        apply_cr;
+    FgnPlaneParams plane_y;
+    FgnPlaneParams plane_cb;
+    FgnPlaneParams plane_cr;
+} FilmGrainCtxt;
+
+/*!\brief Generates the grain of a frame, the arguments are the ones of
+     * svt_av1_add_film_grain_run() */
+EbErrorType svt_av1_film_grain_init(FilmGrainCtxt *ctx, const AomFilmGrain *grain_params,
+                                    uint8_t *luma, uint8_t *cb, uint8_t *cr, int32_t height,
+                                    int32_t width, int32_t luma_stride, int32_t chroma_stride,
+                                    int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
+                                    int32_t chroma_subsamp_x);
+
+/*!\brief Number of FGN_STRIPE_HEIGHT luma rows stripes of the frame */
+int32_t svt_av1_film_grain_stripe_count(const FilmGrainCtxt *ctx);
+
+/*!\brief Adds the grain to stripes [first_stripe, first_stripe + stripe_count)
+     *
+     * Can run concurrently on disjoint ranges of the same frame.
+     */
+EbErrorType svt_av1_film_grain_add_noise(const FilmGrainCtxt *ctx, int32_t first_stripe,
+                                         int32_t stripe_count);
+
+void svt_av1_film_grain_free(FilmGrainCtxt *ctx);
+
 /*!\brief Add film grain
      *
      * Add film grain to an image
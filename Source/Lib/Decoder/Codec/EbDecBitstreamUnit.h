@@ -15,6 +15,7 @@
 
 #include "EbCabacContextModel.h"
 #include "EbBitstreamUnit.h"
+#include "common_dsp_rtcd.h"
 //Added this EbBitstreamUnit.h because OdEcWindow is defined in it, but
 //we also defining it, so it leads to warning,  so i commented our defination & added EbBitstreamUnit.h file.
 
@@ -37,12 +38,18 @@ extern "C" {
 #define EC_PROB_SHIFT 6
 #define EC_MIN_PROB 4 // must be <= (1<<EC_PROB_SHIFT)/16
 
-/*OPT: OdEcWindow must be at least 32 bits, but if you have fast arithmetic
-   on a larger type, you can speed up the decoder by using it here.*/
-//typedef uint32_t OdEcWindow;
+/*The decoder window is 64 bits: a refill reads up to 6 bytes, instead of 2,
+   so it is needed 3 times less.*/
+typedef uint64_t OdEcDecWindow;
 
-/*The size in bits of OdEcWindow.*/
-//#define OD_EC_WINDOW_SIZE ((int)sizeof(OdEcWindow) * CHAR_BIT)
+/*The size in bits of OdEcDecWindow.*/
+#define OD_EC_DEC_WINDOW_SIZE ((int)sizeof(OdEcDecWindow) * CHAR_BIT)
+
+/*Symbols of alphabets larger than this are searched and adapted by the
+   svt_od_ec_search_cdf and svt_av1_update_cdf kernels. The smaller ones,
+   which are most of the coefficient symbols, are faster inline than through
+   a call.*/
+#define OD_EC_DEC_INLINE_NSYMS 8
 
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
@@ -74,6 +81,10 @@ static INLINE void dec_update_cdf(AomCdfProb *cdf, int8_t val, int nsymbs) {
     int rate;
     int i, tmp;
 
+    if (nsymbs > OD_EC_DEC_INLINE_NSYMS) {
+        svt_av1_update_cdf(cdf, val, nsymbs);
+        return;
+    }
     static const int nsymbs2speed[17] = {0, 0, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
     assert(nsymbs < 17);
     rate = 3 + (cdf[nsymbs] > 15) + (cdf[nsymbs] > 31) + nsymbs2speed[nsymbs]; // + get_msb(nsymbs);
@@ -114,12 +125,12 @@ typedef struct OdEcDec {
 
     /*The difference between the high end of the current range, (low + rng), and
     the coded value, minus 1.
-    This stores up to OD_EC_WINDOW_SIZE bits of that difference, but the
+    This stores up to OD_EC_DEC_WINDOW_SIZE bits of that difference, but the
     decoder only uses the top 16 bits of the window to decode the next symbol.
     As we shift up during renormalization, if we don't have enough bits left in
     the window to fill the top 16, we'll read in more bits of the coded
     value.*/
-    OdEcWindow dif;
+    OdEcDecWindow dif;
     /*The number of values in the current range.*/
     uint16_t rng;
     /*The number of bits of data in the current value.*/
@@ -136,7 +147,7 @@ static void od_ec_dec_refill(OdEcDec *dec);
   ret: The value to return.
   Return: ret.
           This allows the compiler to jump to this function via a tail-call.*/
-static int od_ec_dec_normalize(OdEcDec *dec, OdEcWindow dif, unsigned rng, int ret) {
+static int od_ec_dec_normalize(OdEcDec *dec, OdEcDecWindow dif, unsigned rng, int ret) {
     int d;
     assert(rng <= 65535U);
     /*The number of leading zeros in the 16-bit binary representation of rng.*/
@@ -155,21 +166,21 @@ static int od_ec_dec_normalize(OdEcDec *dec, OdEcWindow dif, unsigned rng, int r
   f: The probability that the bit is one, scaled by 32768.
   Return: The value decoded (0 or 1).*/
 static int od_ec_decode_bool_q15(OdEcDec *dec, unsigned f) {
-    OdEcWindow dif;
-    OdEcWindow vw;
-    unsigned   r;
-    unsigned   r_new;
-    unsigned   v;
-    int        ret;
+    OdEcDecWindow dif;
+    OdEcDecWindow vw;
+    unsigned      r;
+    unsigned      r_new;
+    unsigned      v;
+    int           ret;
     assert(0 < f);
     assert(f < 32768U);
     dif = dec->dif;
     r   = dec->rng;
-    assert(dif >> (OD_EC_WINDOW_SIZE - 16) < r);
+    assert(dif >> (OD_EC_DEC_WINDOW_SIZE - 16) < r);
     assert(32768U <= r);
     v = ((r >> 8) * (uint32_t)(f >> EC_PROB_SHIFT) >> (7 - EC_PROB_SHIFT));
     v += EC_MIN_PROB;
-    vw    = (OdEcWindow)v << (OD_EC_WINDOW_SIZE - 16);
+    vw    = (OdEcDecWindow)v << (OD_EC_DEC_WINDOW_SIZE - 16);
     ret   = 1;
     r_new = v;
     if (dif >= vw) {
@@ -189,35 +200,46 @@ static int od_ec_decode_bool_q15(OdEcDec *dec, unsigned f) {
   nsyms: The number of symbols in the alphabet.
          This should be at most 16.
   Return: The decoded symbol s.*/
+/*The lower bound, in the range r, of the symbol s of an alphabet of n + 1
+   symbols.*/
+static INLINE unsigned od_ec_dec_bound(unsigned r, unsigned icdf_s, int n, int s) {
+    return ((r >> 8) * (uint32_t)(icdf_s >> EC_PROB_SHIFT) >> (7 - EC_PROB_SHIFT - CDF_SHIFT)) +
+        EC_MIN_PROB * (n - s);
+}
+
 static int od_ec_decode_cdf_q15(OdEcDec *dec, const uint16_t *icdf, int nsyms) {
-    OdEcWindow dif;
-    unsigned   r;
-    unsigned   c;
-    unsigned   u;
-    unsigned   v;
-    int        ret;
-    (void)nsyms;
+    OdEcDecWindow dif;
+    unsigned      r;
+    unsigned      c;
+    unsigned      u;
+    unsigned      v;
+    int           ret;
     dif         = dec->dif;
     r           = dec->rng;
     const int N = nsyms - 1;
 
-    assert(dif >> (OD_EC_WINDOW_SIZE - 16) < r);
+    assert(dif >> (OD_EC_DEC_WINDOW_SIZE - 16) < r);
     assert(icdf[nsyms - 1] == OD_ICDF(CDF_PROB_TOP));
     assert(32768U <= r);
     assert(7 - EC_PROB_SHIFT - CDF_SHIFT >= 0);
-    c   = (unsigned)(dif >> (OD_EC_WINDOW_SIZE - 16));
-    v   = r;
-    ret = -1;
-    do {
-        u = v;
-        v = ((r >> 8) * (uint32_t)(icdf[++ret] >> EC_PROB_SHIFT) >>
-             (7 - EC_PROB_SHIFT - CDF_SHIFT));
-        v += EC_MIN_PROB * (N - ret);
-    } while (c < v);
+    c = (unsigned)(dif >> (OD_EC_DEC_WINDOW_SIZE - 16));
+    if (nsyms > OD_EC_DEC_INLINE_NSYMS) {
+        ret = svt_od_ec_search_cdf(icdf, nsyms, c, r);
+        u   = ret ? od_ec_dec_bound(r, icdf[ret - 1], N, ret - 1) : r;
+        v   = od_ec_dec_bound(r, icdf[ret], N, ret);
+    } else {
+        v   = r;
+        ret = -1;
+        do {
+            u = v;
+            ret++;
+            v = od_ec_dec_bound(r, icdf[ret], N, ret);
+        } while (c < v);
+    }
     assert(v < u);
     assert(u <= r);
     r = u - v;
-    dif -= (OdEcWindow)v << (OD_EC_WINDOW_SIZE - 16);
+    dif -= (OdEcDecWindow)v << (OD_EC_DEC_WINDOW_SIZE - 16);
     return od_ec_dec_normalize(dec, dif, r, ret);
 }
 
@@ -236,7 +258,7 @@ static int od_ec_decode_cdf_q15(OdEcDec *dec, const uint16_t *icdf, int nsyms) {
    call.*/
 static void od_ec_dec_refill(OdEcDec *dec) {
     int                  s;
-    OdEcWindow           dif;
+    OdEcDecWindow        dif;
     int16_t              cnt;
     const unsigned char *bptr;
     const unsigned char *end;
@@ -244,13 +266,13 @@ static void od_ec_dec_refill(OdEcDec *dec) {
     cnt  = dec->cnt;
     bptr = dec->bptr;
     end  = dec->end;
-    s    = OD_EC_WINDOW_SIZE - 9 - (cnt + 15);
+    s    = OD_EC_DEC_WINDOW_SIZE - 9 - (cnt + 15);
     for (; s >= 0 && bptr < end; s -= 8, bptr++) {
         /*Each time a byte is inserted into the window (dif), bptr advances and cnt
        is incremented by 8, so the total number of consumed bits (the return
        value of od_ec_dec_tell) does not change.*/
-        assert(s <= OD_EC_WINDOW_SIZE - 8);
-        dif ^= (OdEcWindow)bptr[0] << s;
+        assert(s <= OD_EC_DEC_WINDOW_SIZE - 8);
+        dif ^= (OdEcDecWindow)bptr[0] << s;
         cnt += 8;
     }
     if (bptr >= end) {
@@ -278,10 +300,10 @@ static void od_ec_dec_refill(OdEcDec *dec) {
   storage: The size in bytes of the input buffer.*/
 static void od_ec_dec_init(OdEcDec *dec, const unsigned char *buf, uint32_t storage) {
     dec->buf       = buf;
-    dec->tell_offs = 10 - (OD_EC_WINDOW_SIZE - 8);
+    dec->tell_offs = 10 - (OD_EC_DEC_WINDOW_SIZE - 8);
     dec->end       = buf + storage;
     dec->bptr      = buf;
-    dec->dif       = ((OdEcWindow)1 << (OD_EC_WINDOW_SIZE - 1)) - 1;
+    dec->dif       = ((OdEcDecWindow)1 << (OD_EC_DEC_WINDOW_SIZE - 1)) - 1;
     dec->rng       = 0x8000;
     dec->cnt       = -15;
     od_ec_dec_refill(dec);
@@ -79,6 +79,7 @@ void        asm_set_convolve_hbd_asm_table(void);
 void        init_intra_predictors_internal(void);
 extern void svt_av1_init_wedge_masks(void);
 void        dec_sync_all_threads(EbDecHandle *dec_handle_ptr);
+void        svt_dec_film_grain_bands(DecMtFrameData *dec_mt_frame_data);
 
 EbErrorType decode_multiple_obu(EbDecHandle *dec_handle_ptr, uint8_t **data, size_t data_size,
                                 uint32_t is_annexb);
@@ -121,6 +122,8 @@ static EbErrorType svt_dec_handle_ctor(EbDecHandle **   decHandleDblPtr,
     dec_handle_ptr->start_thread_process = EB_FALSE;
     memory_map_start_address             = NULL;
     memory_map_end_address               = NULL;
+    dec_handle_ptr->seq_mem_start        = NULL;
+    dec_handle_ptr->seq_mem_end          = NULL;
 
     return return_error;
 }
@@ -143,6 +146,40 @@ static void copy_even(uint8_t *luma, uint32_t wd, uint32_t ht, uint32_t stride,
     }
 }
 /* Copy from recon buffer to out buffer! */
+/* Adds the film grain in bands of stripes, shared with the worker threads
+   which are idle until the next frame */
+static void dec_add_film_grain_mt(EbDecHandle *dec_handle_ptr, FilmGrainCtxt *fg_ctxt) {
+    DecMtFrameData *dec_mt_frame_data =
+        &dec_handle_ptr->main_frame_buf.cur_frame_bufs[0].dec_mt_frame_data;
+    const int32_t thread_cnt   = (int32_t)dec_handle_ptr->dec_config.threads;
+    const int32_t stripe_count = svt_av1_film_grain_stripe_count(fg_ctxt);
+    // Bands after the first one replay the stripe above, two per thread
+    // keep that overhead low while balancing the load
+    const int32_t band_stripes = AOMMAX(1, (stripe_count + 2 * thread_cnt - 1) / (2 * thread_cnt));
+
+    svt_block_on_mutex(dec_mt_frame_data->temp_mutex);
+    dec_mt_frame_data->film_grain_ctxt            = fg_ctxt;
+    dec_mt_frame_data->film_grain_band_stripes    = band_stripes;
+    dec_mt_frame_data->film_grain_band_count      = (stripe_count + band_stripes - 1) / band_stripes;
+    dec_mt_frame_data->film_grain_band_to_process = 0;
+    dec_mt_frame_data->film_grain_bands_done      = 0;
+    dec_mt_frame_data->start_film_grain           = EB_TRUE;
+    svt_release_mutex(dec_mt_frame_data->temp_mutex);
+
+    for (int32_t lib_thrd = 0; lib_thrd < thread_cnt - 1; lib_thrd++)
+        svt_post_semaphore(dec_handle_ptr->thread_ctxt_pa[lib_thrd].thread_semaphore);
+    svt_dec_film_grain_bands(dec_mt_frame_data);
+
+    volatile int32_t *bands_done = &dec_mt_frame_data->film_grain_bands_done;
+    while (*bands_done != dec_mt_frame_data->film_grain_band_count)
+        ;
+
+    svt_block_on_mutex(dec_mt_frame_data->temp_mutex);
+    dec_mt_frame_data->start_film_grain = EB_FALSE;
+    dec_mt_frame_data->film_grain_ctxt  = NULL;
+    svt_release_mutex(dec_mt_frame_data->temp_mutex);
+}
+
 int svt_dec_out_buf(EbDecHandle *dec_handle_ptr, EbBufferHeaderType *p_buffer) {
     EbPictureBufferDesc *recon_picture_buf = dec_handle_ptr->cur_pic_buf[0]->ps_pic_buf;
     EbSvtIOFormat *      out_img           = (EbSvtIOFormat *)p_buffer->p_buffer;
@@ -391,23 +428,100 @@ int svt_dec_out_buf(EbDecHandle *dec_handle_ptr, EbBufferHeaderType *p_buffer) {
             default: assert(0);
             }
             copy_even(luma, wd, ht, out_img->y_stride, use_high_bit_depth);
-            svt_av1_add_film_grain_run(film_grain_ptr,
-                                       luma,
-                                       cb,
-                                       cr,
-                                       even_h, /*(ht & 1 ? ht + 1 : ht),*/
-                                       even_w, /*(wd & 1 ? wd + 1 : ht),*/
-                                       out_img->y_stride,
-                                       out_img->cb_stride,
-                                       use_high_bit_depth,
-                                       sy,
-                                       sx);
+            FilmGrainCtxt fg_ctxt;
+            if (svt_av1_film_grain_init(&fg_ctxt,
+                                        film_grain_ptr,
+                                        luma,
+                                        cb,
+                                        cr,
+                                        even_h, /*(ht & 1 ? ht + 1 : ht),*/
+                                        even_w, /*(wd & 1 ? wd + 1 : ht),*/
+                                        out_img->y_stride,
+                                        out_img->cb_stride,
+                                        use_high_bit_depth,
+                                        sy,
+                                        sx) == EB_ErrorNone) {
+                if (dec_handle_ptr->dec_config.threads > 1 && dec_handle_ptr->thread_ctxt_pa)
+                    dec_add_film_grain_mt(dec_handle_ptr, &fg_ctxt);
+                else
+                    svt_av1_film_grain_add_noise(
+                        &fg_ctxt, 0, svt_av1_film_grain_stripe_count(&fg_ctxt));
+            }
+            svt_av1_film_grain_free(&fg_ctxt);
         }
     }
 
     return 1;
 }
 
+/* Return the output picture without copy: out_img points to the planes of the
+   decoded picture, held through a handle until svt_av1_dec_release_picture.
+   Film grain and the 8-bit output of the 16-bit pipeline cannot be returned
+   in place; they are written to the pooled planes of the handle. */
+static EbErrorType svt_dec_out_pic_ref(EbDecHandle *dec_handle_ptr, EbBufferHeaderType *p_buffer) {
+    EbDecPicBuf *        pic_buf           = dec_handle_ptr->cur_pic_buf[0];
+    EbPictureBufferDesc *recon_picture_buf = pic_buf->ps_pic_buf;
+    EbSvtIOFormat *      out_img           = (EbSvtIOFormat *)p_buffer->p_buffer;
+
+    if (0 == dec_handle_ptr->show_frame)
+        return EB_DecNoOutputPicture;
+
+    EbDecOutPic *out_pic = dec_pic_mgr_get_out_pic(dec_handle_ptr);
+    if (out_pic == NULL)
+        return EB_ErrorInsufficientResources;
+
+    if ((!dec_handle_ptr->dec_config.skip_film_grain && pic_buf->film_grain_params.apply_grain) ||
+        (recon_picture_buf->bit_depth == EB_8BIT && dec_handle_ptr->is_16bit_pipeline)) {
+        EbBufferHeaderType pool_buffer = *p_buffer;
+        /* Reallocate the pooled planes on a bit depth change as well */
+        if (out_pic->img.bit_depth != (EbBitDepth)recon_picture_buf->bit_depth) {
+            out_pic->img.height    = 0;
+            out_pic->img.bit_depth = (EbBitDepth)recon_picture_buf->bit_depth;
+        }
+        pool_buffer.p_buffer = (uint8_t *)&out_pic->img;
+        svt_dec_out_buf(dec_handle_ptr, &pool_buffer);
+        *out_img = out_pic->img;
+    } else {
+        int32_t use_high_bit_depth = recon_picture_buf->bit_depth == EB_8BIT ? 0 : 1;
+        int32_t sx = dec_handle_ptr->seq_header.color_config.subsampling_x;
+        int32_t sy = dec_handle_ptr->seq_header.color_config.subsampling_y;
+
+        svt_atomic_fetch_add_i32(&pic_buf->out_ref_count, 1);
+        out_pic->pic_buf = pic_buf;
+
+        out_img->width     = dec_handle_ptr->frame_header.frame_size.superres_upscaled_width;
+        out_img->height    = dec_handle_ptr->frame_header.frame_size.frame_height;
+        out_img->origin_x  = 0;
+        out_img->origin_y  = 0;
+        out_img->color_fmt = recon_picture_buf->color_format;
+        out_img->bit_depth = (EbBitDepth)recon_picture_buf->bit_depth;
+        out_img->y_stride  = recon_picture_buf->stride_y;
+        out_img->luma      = recon_picture_buf->buffer_y +
+            ((recon_picture_buf->origin_y * recon_picture_buf->stride_y +
+              recon_picture_buf->origin_x)
+             << use_high_bit_depth);
+        if (recon_picture_buf->color_format != EB_YUV400) {
+            out_img->cb_stride = recon_picture_buf->stride_cb;
+            out_img->cr_stride = recon_picture_buf->stride_cr;
+            out_img->cb        = recon_picture_buf->buffer_cb +
+                (((recon_picture_buf->origin_y >> sy) * recon_picture_buf->stride_cb +
+                  (recon_picture_buf->origin_x >> sx))
+                 << use_high_bit_depth);
+            out_img->cr = recon_picture_buf->buffer_cr +
+                (((recon_picture_buf->origin_y >> sy) * recon_picture_buf->stride_cr +
+                  (recon_picture_buf->origin_x >> sx))
+                 << use_high_bit_depth);
+        } else {
+            out_img->cb_stride = INT32_MAX;
+            out_img->cr_stride = INT32_MAX;
+            out_img->cb        = NULL;
+            out_img->cr        = NULL;
+        }
+    }
+    p_buffer->wrapper_ptr = out_pic;
+    return EB_ErrorNone;
+}
+
 /**********************************
 Set Default Library Params
 **********************************/
@@ -424,6 +538,8 @@ EbErrorType svt_svt_dec_set_default_parameter(EbSvtAv1DecConfiguration *config_p
     config_ptr->frames_to_be_decoded      = 0;
     config_ptr->compressed_ten_bit_format = 0;
     config_ptr->eight_bit_output          = 0;
+    config_ptr->zero_copy_output          = EB_FALSE;
+    config_ptr->parse_only                = EB_FALSE;
 
     /* Picture parameters */
     config_ptr->max_picture_width  = 0;
@@ -629,12 +745,30 @@ EB_API EbErrorType svt_av1_dec_get_picture(EbComponentType *   svt_dec_component
         return EB_ErrorBadParameter;
 
     EbDecHandle *dec_handle_ptr = (EbDecHandle *)svt_dec_component->p_component_private;
-    /* Copy from recon pointer and return! TODO: Should remove the svt_memcpy! */
+    if (dec_handle_ptr->dec_config.zero_copy_output)
+        return svt_dec_out_pic_ref(dec_handle_ptr, p_buffer);
+    /* Copy from recon pointer and return! */
     if (0 == svt_dec_out_buf(dec_handle_ptr, p_buffer))
         return_error = EB_DecNoOutputPicture;
     return return_error;
 }
 
+EB_API EbErrorType svt_av1_dec_release_picture(EbComponentType *   svt_dec_component,
+                                               EbBufferHeaderType *p_buffer) {
+    if (svt_dec_component == NULL || p_buffer == NULL || p_buffer->wrapper_ptr == NULL)
+        return EB_ErrorBadParameter;
+
+    EbSvtIOFormat *out_img = (EbSvtIOFormat *)p_buffer->p_buffer;
+    dec_pic_mgr_release_out_pic((EbDecOutPic *)p_buffer->wrapper_ptr);
+    p_buffer->wrapper_ptr = NULL;
+    if (out_img) {
+        out_img->luma = NULL;
+        out_img->cb   = NULL;
+        out_img->cr   = NULL;
+    }
+    return EB_ErrorNone;
+}
+
 EB_API EbErrorType svt_av1_dec_deinit(EbComponentType *svt_dec_component) {
     if (svt_dec_component == NULL)
         return EB_ErrorBadParameter;
@@ -647,6 +781,8 @@ EB_API EbErrorType svt_av1_dec_deinit(EbComponentType *svt_dec_component) {
         dec_sync_all_threads(dec_handle_ptr);
     if (!svt_dec_memory_map)
         return EB_ErrorNone;
+    if (dec_handle_ptr->pv_pic_mgr)
+        dec_pic_mgr_free_out_pics(dec_handle_ptr);
 
     // Loop through the ptr table and free all malloc'd pointers per channel
     EbMemoryMapEntry *memory_entry = svt_dec_memory_map;
@@ -32,16 +32,27 @@ extern "C" {
 /* Maximum number of frames in parallel */
 #define DEC_MAX_NUM_FRM_PRLL 1
 /** Maximum picture buffers needed **/
-#define MAX_PIC_BUFS (REF_FRAMES + 1 + DEC_MAX_NUM_FRM_PRLL)
+/* Output pictures the application can hold with zero copy output */
+#define DEC_MAX_OUT_PICS 4
+#define MAX_PIC_BUFS (REF_FRAMES + 1 + DEC_MAX_NUM_FRM_PRLL + DEC_MAX_OUT_PICS)
+/* SB rows parse can run ahead of the reconstruction in MT, on top of one
+   row per thread being reconstructed */
+#define DEC_PARSE_AHEAD_SB_ROWS 2
 
 /** Picture Structure **/
 typedef struct EbDecPicBuf {
     uint8_t is_free;
 
-    size_t size;
+    /* Luma size ps_pic_buf and mvs are allocated for, 0 before the first
+       allocation */
+    uint16_t alloc_width;
+    uint16_t alloc_height;
 
     /* Number of reference for this frame */
     uint8_t ref_count;
+    /* Number of zero copy output handles to this frame held by the
+       application, released from any thread */
+    volatile int32_t out_ref_count;
 
     uint32_t  order_hint;
     uint32_t  ref_order_hints[INTER_REFS_PER_FRAME];
@@ -138,6 +149,11 @@ typedef struct MainFrameBuf {
     int32_t sb_cols;
     int32_t sb_rows;
 
+    /* SB rows of coefficients held in MT. SB row r is parsed into the
+       buffer row r % coeff_sb_rows once row r - coeff_sb_rows is
+       reconstructed */
+    int32_t coeff_sb_rows;
+
     /* TODO : Should be moved to thread ctxt */
     FrameMiMap frame_mi_map;
 
@@ -163,6 +179,11 @@ typedef struct EbDecHandle {
     /** Flag to signal decoder memory init is done */
     int32_t mem_init_done;
 
+    /* Memory map entries before and after the allocations of dec_mem_init,
+       freed when a new sequence header changes the frame size */
+    EbMemoryMapEntry *seq_mem_start;
+    EbMemoryMapEntry *seq_mem_end;
+
     /** Dec Configuration parameters */
     EbSvtAv1DecConfiguration dec_config;
 
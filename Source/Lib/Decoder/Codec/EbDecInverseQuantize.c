@@ -21,6 +21,7 @@
 #include "EbCoefficients.h"
 #include "EbQMatrices.h"
 #include "EbInvTransforms.h"
+#include "common_dsp_rtcd.h"
 
 // Same wrapper(av1_ac/dc_quant_qtx) available in .c file of encoder
 static INLINE int16_t get_dc_quant(int32_t qindex, int32_t delta, AomBitDepth bit_depth) {
@@ -115,13 +116,6 @@ void update_dequant(DecModCtxt *dec_mod_ctxt, SBInfo *sb_info) {
     }
 }
 
-static INLINE int get_dqv(const int16_t dequant, int coeff_idx, const QmVal *iqmatrix) {
-    int dqv = dequant;
-    if (iqmatrix != NULL)
-        dqv = ((iqmatrix[coeff_idx] * dqv) + (1 << (AOM_QM_BITS - 1))) >> AOM_QM_BITS;
-    return dqv;
-}
-
 int32_t inverse_quantize(DecModCtxt *dec_mod_ctxt, PartitionInfo *part, BlockModeInfo *mode,
                          int32_t *level, int32_t *qcoeffs, TxType tx_type, TxSize tx_size,
                          int plane) {
@@ -130,10 +124,8 @@ int32_t inverse_quantize(DecModCtxt *dec_mod_ctxt, PartitionInfo *part, BlockMod
     FrameHeader *          frame = dec_mod_ctxt->frame_header;
     const ScanOrder *const scan_order =
         &av1_scan_orders[tx_size][tx_type]; //get_scan(tx_size, tx_type);
-    const int16_t *scan      = scan_order->scan;
-    const int32_t  max_value = (1 << (7 + seq->color_config.bit_depth)) - 1;
-    const int32_t  min_value = -(1 << (7 + seq->color_config.bit_depth));
-    int            n_coeffs, i, pos, qmlevel;
+    const int16_t *scan = scan_order->scan;
+    int            n_coeffs, qmlevel;
     int16_t *      dequant;
     const QmVal *  iqmatrix;
     const TxSize   qm_tx_size = av1_get_adjusted_tx_size(tx_size);
@@ -157,31 +149,13 @@ int32_t inverse_quantize(DecModCtxt *dec_mod_ctxt, PartitionInfo *part, BlockMod
 #endif
     level++;
 
-    TranLow q_coeff;
-    int32_t lev;
-    lev = level[0];
-    if (lev) {
-        pos     = scan[0];
-        q_coeff = (TranLow)((int64_t)abs(lev) * get_dqv(dequant[0], pos, iqmatrix) & 0xffffff);
-        q_coeff = q_coeff >> shift;
-
-        if (lev < 0)
-            q_coeff = -q_coeff;
-        qcoeffs[0] = clamp(q_coeff, min_value, max_value);
-    }
-
-    for (i = 1; i < n_coeffs; i++) {
-        lev = level[i];
-        if (lev != 0) {
-            pos     = scan[i];
-            q_coeff = (TranLow)((int64_t)abs(lev) * get_dqv(dequant[1], pos, iqmatrix) & 0xffffff);
-            q_coeff = q_coeff >> shift;
-
-            if (lev < 0)
-                q_coeff = -q_coeff;
-
-            qcoeffs[pos] = clamp(q_coeff, min_value, max_value);
-        }
-    }
+    svt_av1_dequant_scatter(level,
+                            n_coeffs,
+                            scan,
+                            dequant,
+                            iqmatrix,
+                            shift,
+                            seq->color_config.bit_depth,
+                            qcoeffs);
     return n_coeffs;
 }
@@ -164,6 +164,12 @@ static EbErrorType init_main_frame_ctxt(EbDecHandle  *dec_handle_ptr) {
     main_frame_buf->sb_cols = sb_cols;
     main_frame_buf->sb_rows = sb_rows;
 
+    /* MT parses a few SB rows ahead of the reconstruction into a ring of
+       coefficient rows, ST decodes every SB right after parsing it */
+    main_frame_buf->coeff_sb_rows = is_st ? 0 :
+        AOMMIN(sb_rows, (int32_t)dec_handle_ptr->dec_config.threads + DEC_PARSE_AHEAD_SB_ROWS);
+    int32_t num_coeff_sb = sb_cols * main_frame_buf->coeff_sb_rows;
+
     for (i = 0; i < dec_handle_ptr->num_frms_prll; i++) {
         cur_frame_buf = &main_frame_buf->cur_frame_bufs[i];
 
@@ -180,9 +186,8 @@ static EbErrorType init_main_frame_ctxt(EbDecHandle  *dec_handle_ptr) {
         EB_MALLOC_DEC(TransformInfo_t*, cur_frame_buf->trans_info[AOM_PLANE_Y],
             (num_sb * num_mis_in_sb * sizeof(TransformInfo_t)), EB_N_PTR);
 
-        /* Coeff buf (1D compact) allocation for entire frame
-            TODO: Should reduce this to save memory and
-            dynammically allocate if needed */
+        /* Coeff buf (1D compact) allocation for one SB in ST and for
+            coeff_sb_rows SB rows in MT */
             /*TODO : Change to macro */
             /* (16+1) : 1 for Length and 16 for all coeffs in 4x4 */
         if (is_st) {
@@ -192,16 +197,14 @@ static EbErrorType init_main_frame_ctxt(EbDecHandle  *dec_handle_ptr) {
         }
         else {
             EB_MALLOC_DEC(int32_t*, cur_frame_buf->coeff[AOM_PLANE_Y],
-                (num_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1)), EB_N_PTR);
+                (num_coeff_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1)), EB_N_PTR);
         }
 
         /*TODO : Change to macro */
         EB_MALLOC_DEC(TransformInfo_t*, cur_frame_buf->trans_info[AOM_PLANE_U],
             (num_sb * num_mis_in_sb * sizeof(TransformInfo_t) * 2), EB_N_PTR);
 
-        /* Coeff buf (1D compact) allocation for entire frame
-        TODO: Should reduce this to save memory and
-        dynammically allocate if needed */
+        /* Chroma coeff buf (1D compact) allocation, as the luma one */
         /*TODO : Change to macro */
         /* (16+1) : 1 for Length and 16 for all coeffs in 4x4 */
         if (seq_header->color_config.subsampling_x == 1 &&
@@ -216,11 +219,11 @@ static EbErrorType init_main_frame_ctxt(EbDecHandle  *dec_handle_ptr) {
             else {
                 EB_MALLOC_DEC(int32_t*,
                     cur_frame_buf->coeff[AOM_PLANE_U],
-                    (num_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 2),
+                    (num_coeff_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 2),
                     EB_N_PTR);
                 EB_MALLOC_DEC(int32_t*,
                     cur_frame_buf->coeff[AOM_PLANE_V],
-                    (num_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 2),
+                    (num_coeff_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 2),
                     EB_N_PTR);
             }
         }
@@ -236,11 +239,11 @@ static EbErrorType init_main_frame_ctxt(EbDecHandle  *dec_handle_ptr) {
             else {
                 EB_MALLOC_DEC(int32_t*,
                     cur_frame_buf->coeff[AOM_PLANE_U],
-                    (num_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 1),
+                    (num_coeff_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 1),
                     EB_N_PTR);
                 EB_MALLOC_DEC(int32_t*,
                     cur_frame_buf->coeff[AOM_PLANE_V],
-                    (num_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 1),
+                    (num_coeff_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1) >> 1),
                     EB_N_PTR);
             }
         }
@@ -256,11 +259,11 @@ static EbErrorType init_main_frame_ctxt(EbDecHandle  *dec_handle_ptr) {
             else {
                 EB_MALLOC_DEC(int32_t*,
                     cur_frame_buf->coeff[AOM_PLANE_U],
-                    (num_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1)),
+                    (num_coeff_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1)),
                     EB_N_PTR);
                 EB_MALLOC_DEC(int32_t*,
                     cur_frame_buf->coeff[AOM_PLANE_V],
-                    (num_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1)),
+                    (num_coeff_sb * num_mis_in_sb * sizeof(int32_t) * (16 + 1)),
                     EB_N_PTR);
             }
         }
@@ -305,7 +308,7 @@ static EbErrorType init_main_frame_ctxt(EbDecHandle  *dec_handle_ptr) {
     frame_mi_map->sb_cols = sb_cols;
     frame_mi_map->sb_rows = sb_rows;
     frame_mi_map->mi_cols_algnsb = sb_cols * (1 << (sb_size_log2 - MI_SIZE_LOG2));
-    frame_mi_map->mi_rows_algnsb = sb_cols * (1 << (sb_size_log2 - MI_SIZE_LOG2));
+    frame_mi_map->mi_rows_algnsb = sb_rows * (1 << (sb_size_log2 - MI_SIZE_LOG2));
     /* SBInfo pointers for entire frame */
     EB_MALLOC_DEC(SBInfo**, frame_mi_map->pps_sb_info,
         sb_rows * sb_cols * sizeof(SBInfo *), EB_N_PTR);
@@ -498,12 +501,102 @@ static EbErrorType init_lr_ctxt(EbDecHandle  *dec_handle_ptr)
     return return_error;
 }
 
+static void free_mem_entry(EbMemoryMapEntry *memory_entry) {
+    switch (memory_entry->ptr_type) {
+    case EB_N_PTR: free(memory_entry->ptr); break;
+    case EB_A_PTR:
+#ifdef _WIN32
+        _aligned_free(memory_entry->ptr);
+#else
+        free(memory_entry->ptr);
+#endif
+        break;
+    case EB_SEMAPHORE: svt_destroy_semaphore(memory_entry->ptr); break;
+    case EB_THREAD: svt_destroy_thread(memory_entry->ptr); break;
+    case EB_MUTEX: svt_destroy_mutex(memory_entry->ptr); break;
+    default: break;
+    }
+}
+
+void dec_mem_free(EbDecHandle *dec_handle_ptr, void *ptr) {
+    EbMemoryMapEntry *memory_entry = svt_dec_memory_map;
+    EbMemoryMapEntry *next_entry = NULL;
+
+    while (memory_entry != dec_handle_ptr->memory_map_init_address &&
+        memory_entry && memory_entry->ptr != ptr) {
+        next_entry = memory_entry;
+        memory_entry = (EbMemoryMapEntry *)memory_entry->prev_entry;
+    }
+    if (memory_entry == dec_handle_ptr->memory_map_init_address || !memory_entry)
+        return;
+
+    free_mem_entry(memory_entry);
+    /* Entries marking a span are kept, empty */
+    if (memory_entry == memory_map_start_address ||
+        memory_entry == memory_map_end_address ||
+        memory_entry == dec_handle_ptr->seq_mem_start ||
+        memory_entry == dec_handle_ptr->seq_mem_end) {
+        memory_entry->ptr_type = EB_N_PTR;
+        memory_entry->ptr = NULL;
+        return;
+    }
+    if (next_entry)
+        next_entry->prev_entry = memory_entry->prev_entry;
+    else
+        svt_dec_memory_map = (EbMemoryMapEntry *)memory_entry->prev_entry;
+    (*svt_dec_memory_map_index)--;
+    free(memory_entry);
+}
+
+void dec_mem_free_span(EbDecHandle *dec_handle_ptr, EbMemoryMapEntry *start,
+                       EbMemoryMapEntry *end) {
+    EbMemoryMapEntry *memory_entry   = svt_dec_memory_map;
+    EbMemoryMapEntry *previous_entry = NULL;
+    if (start == end)
+        return;
+    /* The span of the sequence and the one of the MT resources are stacked
+       in either order, the entry ending one being the start of the other */
+    if (memory_map_start_address == end)
+        memory_map_start_address = start;
+    if (memory_map_end_address == end)
+        memory_map_end_address = start;
+    if (dec_handle_ptr->seq_mem_start == end)
+        dec_handle_ptr->seq_mem_start = start;
+    if (dec_handle_ptr->seq_mem_end == end)
+        dec_handle_ptr->seq_mem_end = start;
+    if (memory_entry != end) {
+        while ((EbMemoryMapEntry *)memory_entry->prev_entry != end) {
+            memory_entry = (EbMemoryMapEntry *)memory_entry->prev_entry;
+        }
+        previous_entry = memory_entry;
+        memory_entry   = (EbMemoryMapEntry *)memory_entry->prev_entry;
+    }
+    do {
+        free_mem_entry(memory_entry);
+        EbMemoryMapEntry *tmp_memory_entry = memory_entry;
+        memory_entry = (EbMemoryMapEntry *)tmp_memory_entry->prev_entry;
+        free(tmp_memory_entry);
+        (*svt_dec_memory_map_index)--;
+    } while (memory_entry != start && memory_entry);
+    if (previous_entry != NULL)
+        previous_entry->prev_entry = start;
+    else
+        svt_dec_memory_map = start;
+}
+
 EbErrorType dec_mem_init(EbDecHandle  *dec_handle_ptr) {
     EbErrorType return_error = EB_ErrorNone;
 
     if (0 == dec_handle_ptr->seq_header_done)
         return EB_ErrorNone;
 
+    /* Free the buffers sized for the previous sequence header, unless the
+       application still holds pictures of it */
+    if (dec_handle_ptr->seq_mem_end != NULL && dec_pic_mgr_free_pics(dec_handle_ptr))
+        dec_mem_free_span(
+            dec_handle_ptr, dec_handle_ptr->seq_mem_start, dec_handle_ptr->seq_mem_end);
+    dec_handle_ptr->seq_mem_start = svt_dec_memory_map;
+
     /* init module ctxts */
     return_error |= dec_pic_mgr_init(dec_handle_ptr);
 
@@ -527,6 +620,7 @@ EbErrorType dec_mem_init(EbDecHandle  *dec_handle_ptr) {
     }
     dec_handle_ptr->cur_pic_buf[0] = NULL;
 
+    dec_handle_ptr->seq_mem_end = svt_dec_memory_map;
     dec_handle_ptr->mem_init_done = 1;
 
     return return_error;
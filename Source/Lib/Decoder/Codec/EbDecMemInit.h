@@ -98,6 +98,15 @@ EbErrorType dec_eb_recon_picture_buffer_desc_ctor(EbPtr *object_dbl_ptr, EbPtr o
 
 EbErrorType dec_mem_init(EbDecHandle *dec_handle_ptr);
 
+/* Frees one allocation of the memory map and drops its entry */
+void dec_mem_free(EbDecHandle *dec_handle_ptr, void *ptr);
+
+/* Frees the allocations made after the entry start, up to the entry end
+   included; the allocations made after end stay, and the spans that began
+   at end now begin at start */
+void dec_mem_free_span(EbDecHandle *dec_handle_ptr, EbMemoryMapEntry *start,
+                       EbMemoryMapEntry *end);
+
 EbErrorType init_dec_mod_ctxt(EbDecHandle *dec_handle_ptr, void **dec_mod_ctxt);
 
 #ifdef __cplusplus
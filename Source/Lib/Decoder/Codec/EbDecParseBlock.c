@@ -977,6 +977,8 @@ void motion_field_projections_row(EbDecHandle *dec_handle, int sb_row, const EbD
         motion_field_projection_row(dec_handle, LAST2_FRAME, sb_row, num_blk_mv_rows, 2);
 }
 
+void svt_dec_film_grain_bands(DecMtFrameData *dec_mt_frame_data);
+
 void svt_setup_motion_field(EbDecHandle *dec_handle, DecThreadCtxt *thread_ctxt) {
     DecMtFrameData *dec_mt_frame_data =
         &dec_handle->main_frame_buf.cur_frame_bufs[0].dec_mt_frame_data;
@@ -986,9 +988,13 @@ void svt_setup_motion_field(EbDecHandle *dec_handle, DecThreadCtxt *thread_ctxt)
     if (is_mt) {
         volatile EbBool *start_motion_proj = &dec_mt_frame_data->start_motion_proj;
 
-        while (*start_motion_proj != EB_TRUE)
+        while (*start_motion_proj != EB_TRUE) {
             svt_block_on_semaphore(NULL == thread_ctxt ? dec_handle->thread_semaphore
                                                        : thread_ctxt->thread_semaphore);
+            /* Workers help with the film grain of the output picture */
+            if (NULL != thread_ctxt)
+                svt_dec_film_grain_bands(dec_mt_frame_data);
+        }
 
         DecMtMotionProjInfo *motion_proj_info = &dec_mt_frame_data->motion_proj_info;
         do_memset                             = EB_FALSE;
@@ -195,6 +195,10 @@ EbErrorType parse_tile(EbDecHandle *dec_handle_ptr, ParseCtxt *parse_ctx, TilesI
 
         clear_left_context(parse_ctx);
 
+        if (is_mt)
+            dec_wait_coeff_row(
+                dec_handle_ptr, (DecModCtxt *)parse_ctx->dec_mod_ctxt, tile_col, sb_row);
+
         /*TODO: Move CFL to thread ctxt! We need to access DecModCtxt
           from parse_tile function . Add tile level cfl init. */
         if (!is_mt) {
@@ -234,16 +238,17 @@ EbErrorType parse_tile(EbDecHandle *dec_handle_ptr, ParseCtxt *parse_ctx, TilesI
                 sb_info->sb_coeff[AOM_PLANE_U] = frame_buf->coeff[AOM_PLANE_U];
                 sb_info->sb_coeff[AOM_PLANE_V] = frame_buf->coeff[AOM_PLANE_V];
             } else {
+                int32_t coeff_row = sb_row % main_frame_buf->coeff_sb_rows;
                 /*TODO : Change to macro */
                 sb_info->sb_coeff[AOM_PLANE_Y] = frame_buf->coeff[AOM_PLANE_Y] +
-                    (sb_row * num_mis_in_sb * main_frame_buf->sb_cols * (16 + 1)) +
+                    (coeff_row * num_mis_in_sb * main_frame_buf->sb_cols * (16 + 1)) +
                     sb_col * num_mis_in_sb * (16 + 1);
                 /*TODO : Change to macro */
                 sb_info->sb_coeff[AOM_PLANE_U] = frame_buf->coeff[AOM_PLANE_U] +
-                    (sb_row * num_mis_in_sb * main_frame_buf->sb_cols * (16 + 1) >> (sy + sx)) +
+                    (coeff_row * num_mis_in_sb * main_frame_buf->sb_cols * (16 + 1) >> (sy + sx)) +
                     (sb_col * num_mis_in_sb * (16 + 1) >> (sy + sx));
                 sb_info->sb_coeff[AOM_PLANE_V] = frame_buf->coeff[AOM_PLANE_V] +
-                    (sb_row * num_mis_in_sb * main_frame_buf->sb_cols * (16 + 1) >> (sy + sx)) +
+                    (coeff_row * num_mis_in_sb * main_frame_buf->sb_cols * (16 + 1) >> (sy + sx)) +
                     (sb_col * num_mis_in_sb * (16 + 1) >> (sy + sx));
             }
             int cdef_factor           = dec_handle_ptr->seq_header.use_128x128_superblock ? 4 : 1;
@@ -272,7 +277,7 @@ EbErrorType parse_tile(EbDecHandle *dec_handle_ptr, ParseCtxt *parse_ctx, TilesI
             // Bit-stream parsing of the superblock
             parse_super_block(dec_handle_ptr, parse_ctx, mi_row, mi_col, sb_info);
 
-            if (!is_mt) {
+            if (!is_mt && !dec_handle_ptr->dec_config.parse_only) {
                 /* Init DecModCtxt */
                 DecModCtxt *dec_mod_ctxt = (DecModCtxt *)dec_handle_ptr->pv_dec_mod_ctxt;
                 dec_mod_ctxt->cur_coeff[AOM_PLANE_Y] = sb_info->sb_coeff[AOM_PLANE_Y];
@@ -104,6 +104,10 @@ typedef struct ParseCtxt {
     /* TODO: Points to the cur coeff_buf in SB. Should be moved out */
     int32_t *cur_coeff_buf[MAX_MB_PLANE];
 
+    /* DecModCtxt of the thread parsing the tile in MT, used to reconstruct
+       the SB rows holding the coefficient buffer rows it parses into */
+    void *dec_mod_ctxt;
+
     /* Points to the cur luma_trans_info in a block */
     TransformInfo_t *cur_luma_trans_info;
 
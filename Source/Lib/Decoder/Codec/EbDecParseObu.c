@@ -1694,38 +1694,7 @@ static void check_mt_support(EbDecHandle *dec_handle_ptr) {
     }
 
     if (do_realloc) {
-        EbMemoryMapEntry *memory_entry   = svt_dec_memory_map;
-        EbMemoryMapEntry *previous_entry = NULL;
-        if (memory_entry != memory_map_end_address) {
-            while ((EbMemoryMapEntry *)memory_entry->prev_entry != memory_map_end_address) {
-                memory_entry = (EbMemoryMapEntry *)memory_entry->prev_entry;
-            }
-            previous_entry = memory_entry;
-            memory_entry   = (EbMemoryMapEntry *)memory_entry->prev_entry;
-        }
-        do {
-            switch (memory_entry->ptr_type) {
-            case EB_N_PTR: free(memory_entry->ptr); break;
-            case EB_A_PTR:
-#ifdef _WIN32
-                _aligned_free(memory_entry->ptr);
-#else
-                free(memory_entry->ptr);
-#endif
-                break;
-            case EB_SEMAPHORE: svt_destroy_semaphore(memory_entry->ptr); break;
-            case EB_THREAD: svt_destroy_thread(memory_entry->ptr); break;
-            case EB_MUTEX: svt_destroy_mutex(memory_entry->ptr); break;
-            default: break;
-            }
-            EbMemoryMapEntry *tmp_memory_entry = memory_entry;
-            memory_entry                       = (EbMemoryMapEntry *)tmp_memory_entry->prev_entry;
-            free(tmp_memory_entry);
-        } while (memory_entry != memory_map_start_address && memory_entry);
-        if (previous_entry != NULL)
-            previous_entry->prev_entry = memory_map_start_address;
-        else
-            svt_dec_memory_map = memory_map_start_address;
+        dec_mem_free_span(dec_handle_ptr, memory_map_start_address, memory_map_end_address);
         dec_system_resource_init(dec_handle_ptr, &tiles_info);
         set_prev_frame_info(dec_handle_ptr);
         realloc_parse_memory(dec_handle_ptr);
@@ -2273,14 +2242,16 @@ EbErrorType read_tile_group_obu(Bitstrm *bs, EbDecHandle *dec_handle_ptr, TilesI
     uint32_t num_threads = dec_handle_ptr->dec_config.threads;
     int      is_mt       = num_threads != 1;
 
-    /* PPF flags derivation */
-    EbBool no_ibc = !dec_handle_ptr->frame_header.allow_intrabc;
+    /* PPF flags derivation, there is nothing to filter when only parsing */
+    EbBool parse_only = !is_mt && dec_handle_ptr->dec_config.parse_only;
+    EbBool no_ibc     = !dec_handle_ptr->frame_header.allow_intrabc;
+    EbBool do_filter  = no_ibc && !parse_only;
     /* LF */
-    EbBool do_lf_flag = no_ibc &&
+    EbBool do_lf_flag = do_filter &&
         (dec_handle_ptr->frame_header.loop_filter_params.filter_level[0] ||
          dec_handle_ptr->frame_header.loop_filter_params.filter_level[1]);
     /* CDEF */
-    EbBool do_cdef = no_ibc &&
+    EbBool do_cdef = do_filter &&
         (!frame_header->coded_lossless &&
          (frame_header->cdef_params.cdef_bits || frame_header->cdef_params.cdef_y_strength[0] ||
           frame_header->cdef_params.cdef_uv_strength[0]));
@@ -2289,7 +2260,7 @@ EbErrorType read_tile_group_obu(Bitstrm *bs, EbDecHandle *dec_handle_ptr, TilesI
     /* LR */
     //EbBool opt_lr = !do_cdef && !do_upscale;
     LrParams *lr_param = dec_handle_ptr->frame_header.lr_params;
-    EbBool    do_lr    = no_ibc &&
+    EbBool    do_lr    = do_filter &&
         (lr_param[AOM_PLANE_Y].frame_restoration_type != RESTORE_NONE ||
          lr_param[AOM_PLANE_U].frame_restoration_type != RESTORE_NONE ||
          lr_param[AOM_PLANE_V].frame_restoration_type != RESTORE_NONE);
@@ -2459,7 +2430,8 @@ EbErrorType read_tile_group_obu(Bitstrm *bs, EbDecHandle *dec_handle_ptr, TilesI
         dec_handle_ptr->cur_pic_buf[0]->final_frm_ctx = main_parse_ctxt->init_frm_ctx;
 
     if (!is_mt) {
-        pad_pic(dec_handle_ptr);
+        if (!parse_only)
+            pad_pic(dec_handle_ptr);
     }
 
     return status;
@@ -62,17 +62,24 @@ EbErrorType dec_pic_mgr_init(EbDecHandle *dec_handle_ptr) {
 
     EbDecPicMgr *ps_pic_mgr = *pps_pic_mgr;
 
-    for (i = 0; i < MAX_PIC_BUFS; i++) {
+    ps_pic_mgr->max_pic_bufs = dec_handle_ptr->dec_config.zero_copy_output
+        ? MAX_PIC_BUFS
+        : MAX_PIC_BUFS - DEC_MAX_OUT_PICS;
+    for (i = 0; i < ps_pic_mgr->max_pic_bufs; i++) {
         ps_pic_mgr->as_dec_pic[i].ps_pic_buf = NULL;
         ps_pic_mgr->as_dec_pic[i].is_free    = 1;
-        ps_pic_mgr->as_dec_pic[i].size       = 0;
+        ps_pic_mgr->as_dec_pic[i].alloc_width  = 0;
+        ps_pic_mgr->as_dec_pic[i].alloc_height = 0;
         ps_pic_mgr->as_dec_pic[i].ref_count  = 0;
+        ps_pic_mgr->as_dec_pic[i].out_ref_count = 0;
         ps_pic_mgr->as_dec_pic[i].mvs        = NULL;
         EB_MALLOC_DEC(
             uint8_t *, ps_pic_mgr->as_dec_pic[i].segment_maps, size * sizeof(uint8_t), EB_N_PTR);
         memset(ps_pic_mgr->as_dec_pic[i].segment_maps, 0, size);
     }
 
+    memset(ps_pic_mgr->out_pics, 0, sizeof(ps_pic_mgr->out_pics));
+
     ps_pic_mgr->num_pic_bufs = 0;
 
     return return_error;
@@ -88,6 +95,62 @@ static INLINE EbErrorType mvs_8x8_memory_alloc(TemporalMvRef **mvs, FrameHeader
     return EB_ErrorNone;
 }
 
+static void dec_pic_buf_free(EbDecHandle *dec_handle_ptr, EbDecPicBuf *pic_buf) {
+    EbPictureBufferDesc *ps_pic_buf = pic_buf->ps_pic_buf;
+    if (ps_pic_buf) {
+        if (ps_pic_buf->buffer_y)
+            dec_mem_free(dec_handle_ptr, ps_pic_buf->buffer_y);
+        if (ps_pic_buf->buffer_cb)
+            dec_mem_free(dec_handle_ptr, ps_pic_buf->buffer_cb);
+        if (ps_pic_buf->buffer_cr)
+            dec_mem_free(dec_handle_ptr, ps_pic_buf->buffer_cr);
+        dec_mem_free(dec_handle_ptr, ps_pic_buf);
+    }
+    if (pic_buf->mvs)
+        dec_mem_free(dec_handle_ptr, pic_buf->mvs);
+    pic_buf->ps_pic_buf   = NULL;
+    pic_buf->mvs          = NULL;
+    pic_buf->alloc_width  = 0;
+    pic_buf->alloc_height = 0;
+}
+
+/**
+*******************************************************************************
+*
+* @brief
+*  Free the pictures of the sequence
+*
+* @par Description:
+*  Frees the picture buffers and the output planes, before the buffers of a
+*  new sequence header are allocated. Nothing is freed while the application
+*  holds zero copy output pictures.
+*
+* @returns
+*  EB_TRUE when the pictures were freed
+*
+*******************************************************************************
+*/
+EbBool dec_pic_mgr_free_pics(EbDecHandle *dec_handle_ptr) {
+    EbDecPicMgr *ps_pic_mgr = (EbDecPicMgr *)dec_handle_ptr->pv_pic_mgr;
+    int32_t      i;
+
+    for (i = 0; i < DEC_MAX_OUT_PICS; i++) {
+        if (svt_atomic_load_i32(&ps_pic_mgr->out_pics[i].in_use))
+            return EB_FALSE;
+    }
+    dec_pic_mgr_free_out_pics(dec_handle_ptr);
+    for (i = 0; i < ps_pic_mgr->max_pic_bufs; i++)
+        dec_pic_buf_free(dec_handle_ptr, &ps_pic_mgr->as_dec_pic[i]);
+    ps_pic_mgr->num_pic_bufs = 0;
+    return EB_TRUE;
+}
+
+/* A buffer is kept for frames it holds that are at least half its size */
+static INLINE int pic_buf_fits(const EbDecPicBuf *pic_buf, uint16_t width, uint16_t height) {
+    return pic_buf->alloc_width >= width && pic_buf->alloc_height >= height &&
+        (uint32_t)pic_buf->alloc_width * pic_buf->alloc_height <= 2 * (uint32_t)width * height;
+}
+
 /**
 *******************************************************************************
 *
@@ -95,7 +158,9 @@ static INLINE EbErrorType mvs_8x8_memory_alloc(TemporalMvRef **mvs, FrameHeader
 *  Get current Picture buffer
 *
 * @par Description:
-*  Give the free buffer from pool or dynamically allocate if nothing is free
+*  Gives the smallest free buffer of the pool that fits the frame. When none
+*  fits, a free buffer of another size is reallocated to the frame size, or
+*  a new buffer is allocated.
 *
 * @param[in] ps_pic_mgr
 *  Pointer to the Picture manager structure
@@ -114,34 +179,45 @@ EbDecPicBuf *dec_pic_mgr_get_cur_pic(EbDecHandle *dec_handle_ptr) {
     EbColorFormat color_format = seq_header->color_config.mono_chrome
         ? EB_YUV400
         : dec_handle_ptr->dec_config.max_color_format;
-    int32_t       i;
+    int32_t       i, fit_idx = -1, other_idx = -1, empty_idx = -1;
     EbDecPicBuf * pic_buf = NULL;
+    uint16_t      frame_width  = frame_info->frame_size.superres_upscaled_width;
+    uint16_t      frame_height = frame_info->frame_size.frame_height;
     /* TODO: Add lock and unlock for MT */
-    // Find a free buffer.
-    for (i = 0; i < MAX_PIC_BUFS; i++) {
-        if (ps_pic_mgr->as_dec_pic[i].is_free == 1)
-            break;
+    // Find a free buffer, not held by the application either.
+    for (i = 0; i < ps_pic_mgr->max_pic_bufs; i++) {
+        EbDecPicBuf *buf = &ps_pic_mgr->as_dec_pic[i];
+        if (buf->is_free != 1 || svt_atomic_load_i32(&buf->out_ref_count) != 0)
+            continue;
+        if (buf->ps_pic_buf == NULL) {
+            if (empty_idx < 0)
+                empty_idx = i;
+        } else if (pic_buf_fits(buf, frame_width, frame_height)) {
+            if (fit_idx < 0 ||
+                (uint32_t)buf->alloc_width * buf->alloc_height <
+                    (uint32_t)ps_pic_mgr->as_dec_pic[fit_idx].alloc_width *
+                        ps_pic_mgr->as_dec_pic[fit_idx].alloc_height)
+                fit_idx = i;
+        } else if (other_idx < 0)
+            other_idx = i;
     }
 
-    if (i >= MAX_PIC_BUFS)
+    i = fit_idx >= 0 ? fit_idx : other_idx >= 0 ? other_idx : empty_idx;
+    if (i < 0)
         return NULL;
 
-    uint16_t       frame_width  = frame_info->frame_size.frame_width;
-    uint16_t       frame_height = frame_info->frame_size.frame_height;
-    EbColorConfig *cc           = &seq_header->color_config;
-    size_t         y_size  = (frame_width + 2 * DEC_PAD_VALUE) * (frame_height + 2 * DEC_PAD_VALUE);
-    size_t         uv_size = cc->mono_chrome ? 0
-                                             : (((frame_width + 2 * DEC_PAD_VALUE) >> cc->subsampling_x) *
-                                        ((frame_height + 2 * DEC_PAD_VALUE) >> cc->subsampling_y));
-    size_t         frame_size = y_size + uv_size;
+    EbColorConfig *cc = &seq_header->color_config;
+    if (i != fit_idx) {
+        EbPictureBufferDescInitData input_pic_buf_desc_init_data;
 
-    if (ps_pic_mgr->as_dec_pic[i].size < frame_size) {
-        /* allocate the buffer. TODO: Should add free and allocate logic */
+        if (ps_pic_mgr->as_dec_pic[i].ps_pic_buf)
+            dec_pic_buf_free(dec_handle_ptr, &ps_pic_mgr->as_dec_pic[i]);
+        else
+            ps_pic_mgr->num_pic_bufs++;
 
-        EbPictureBufferDescInitData input_pic_buf_desc_init_data;
         // Init Picture Init data
-        input_pic_buf_desc_init_data.max_width  = seq_header->max_frame_width;
-        input_pic_buf_desc_init_data.max_height = seq_header->max_frame_height;
+        input_pic_buf_desc_init_data.max_width  = frame_width;
+        input_pic_buf_desc_init_data.max_height = frame_height;
         input_pic_buf_desc_init_data.bit_depth  = (EbBitDepthEnum)cc->bit_depth;
         assert(IMPLIES(cc->mono_chrome, color_format == EB_YUV400));
         input_pic_buf_desc_init_data.color_format = cc->mono_chrome ? EB_YUV400 : color_format;
@@ -164,16 +240,17 @@ EbDecPicBuf *dec_pic_mgr_get_cur_pic(EbDecHandle *dec_handle_ptr) {
         if (return_error != EB_ErrorNone)
             return NULL;
 
-        ps_pic_mgr->as_dec_pic[i].size = frame_size;
-
         /* Memory for storing MV's at 8x8 lvl*/
         EbErrorType ret_err = mvs_8x8_memory_alloc(&ps_pic_mgr->as_dec_pic[i].mvs, frame_info);
         if (ret_err != EB_ErrorNone)
             return NULL;
 
-        ps_pic_mgr->num_pic_bufs++;
-    } else
-        assert(ps_pic_mgr->as_dec_pic[i].ps_pic_buf != NULL);
+        ps_pic_mgr->as_dec_pic[i].alloc_width  = frame_width;
+        ps_pic_mgr->as_dec_pic[i].alloc_height = frame_height;
+    }
+    /* The frame size of the picture, within the allocated size */
+    ps_pic_mgr->as_dec_pic[i].ps_pic_buf->width  = frame_width;
+    ps_pic_mgr->as_dec_pic[i].ps_pic_buf->height = frame_height;
 
     ps_pic_mgr->as_dec_pic[i].is_free   = 0;
     ps_pic_mgr->as_dec_pic[i].ref_count = 1;
@@ -183,6 +260,69 @@ EbDecPicBuf *dec_pic_mgr_get_cur_pic(EbDecHandle *dec_handle_ptr) {
     return pic_buf;
 }
 
+/**
+*******************************************************************************
+*
+* @brief
+*  Get a zero copy output handle
+*
+* @par Description:
+*  Takes a handle the application does not hold, NULL if it holds them all.
+*  Handles are only taken by the decoding thread.
+*
+*******************************************************************************
+*/
+EbDecOutPic *dec_pic_mgr_get_out_pic(EbDecHandle *dec_handle_ptr) {
+    EbDecPicMgr *ps_pic_mgr = (EbDecPicMgr *)dec_handle_ptr->pv_pic_mgr;
+
+    for (int32_t i = 0; i < DEC_MAX_OUT_PICS; i++) {
+        EbDecOutPic *out_pic = &ps_pic_mgr->out_pics[i];
+        if (svt_atomic_cas_i32(&out_pic->in_use, 0, 1))
+            return out_pic;
+    }
+    return NULL;
+}
+
+/**
+*******************************************************************************
+*
+* @brief
+*  Release a zero copy output handle
+*
+* @par Description:
+*  Drops the reference of the handle to its picture and hands the handle
+*  back. May be called from any thread.
+*
+*******************************************************************************
+*/
+void dec_pic_mgr_release_out_pic(EbDecOutPic *out_pic) {
+    if (out_pic->pic_buf) {
+        svt_atomic_fetch_add_i32(&out_pic->pic_buf->out_ref_count, -1);
+        out_pic->pic_buf = NULL;
+    }
+    svt_atomic_fetch_add_i32(&out_pic->in_use, -1);
+}
+
+/**
+*******************************************************************************
+*
+* @brief
+*  Free the pooled planes of the zero copy output handles
+*
+*******************************************************************************
+*/
+void dec_pic_mgr_free_out_pics(EbDecHandle *dec_handle_ptr) {
+    EbDecPicMgr *ps_pic_mgr = (EbDecPicMgr *)dec_handle_ptr->pv_pic_mgr;
+
+    for (int32_t i = 0; i < DEC_MAX_OUT_PICS; i++) {
+        EbSvtIOFormat *img = &ps_pic_mgr->out_pics[i].img;
+        free(img->luma);
+        free(img->cb);
+        free(img->cr);
+        memset(img, 0, sizeof(*img));
+    }
+}
+
 static INLINE void dec_ref_count_and_rel(EbDecPicBuf *ps_pic_buf) {
     if (ps_pic_buf != NULL) {
         ps_pic_buf->ref_count--;
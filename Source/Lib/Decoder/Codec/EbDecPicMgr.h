@@ -16,14 +16,32 @@
 extern "C" {
 #endif
 
+/** Zero copy output picture handle **/
+typedef struct EbDecOutPic {
+    /* Picture whose planes are returned, NULL when img holds the output */
+    EbDecPicBuf *pic_buf;
+    /* Pooled planes written when the output differs from the decoded
+       picture: film grain, 8-bit output of the 16-bit pipeline */
+    EbSvtIOFormat img;
+    /* Set while the application holds the handle */
+    volatile int32_t in_use;
+} EbDecOutPic;
+
 /** Decoder Picture Manager **/
 typedef struct EbDecPicMgr {
     /* Array of picture buffers */
     EbDecPicBuf as_dec_pic[MAX_PIC_BUFS];
 
+    /* Zero copy output handles */
+    EbDecOutPic out_pics[DEC_MAX_OUT_PICS];
+
     /* number of picture buffers */
     uint8_t num_pic_bufs;
 
+    /* Picture buffers that can be used, the DEC_MAX_OUT_PICS held by the
+       application are only added with zero copy output */
+    uint8_t max_pic_bufs;
+
 } EbDecPicMgr;
 
 typedef struct RefFrameInfo {
@@ -37,6 +55,14 @@ EbErrorType dec_pic_mgr_init(EbDecHandle *dec_handle_ptr);
 
 EbDecPicBuf *dec_pic_mgr_get_cur_pic(EbDecHandle *dec_handle_ptr);
 
+EbDecOutPic *dec_pic_mgr_get_out_pic(EbDecHandle *dec_handle_ptr);
+
+void dec_pic_mgr_release_out_pic(EbDecOutPic *out_pic);
+
+void dec_pic_mgr_free_out_pics(EbDecHandle *dec_handle_ptr);
+
+EbBool dec_pic_mgr_free_pics(EbDecHandle *dec_handle_ptr);
+
 void dec_pic_mgr_update_ref_pic(EbDecHandle *dec_handle_ptr, int32_t frame_decoded,
                                 int32_t refresh_frame_flags);
 
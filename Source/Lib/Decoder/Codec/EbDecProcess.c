@@ -37,6 +37,7 @@
 #include "EbLog.h"
 
 #include "EbUtility.h"
+#include "grainSynthesis.h"
 
 #include <stdlib.h>
 #include <time.h>
@@ -344,16 +345,23 @@ EbErrorType dec_system_resource_init(EbDecHandle *dec_handle_ptr, TilesInfo *til
     lr_sb_row_info->num_sb_rows       = picture_height_in_sb;
     lr_sb_row_info->sb_row_to_process = 0;
 
-    dec_mt_frame_data->temp_mutex = svt_create_mutex();
-
     dec_mt_frame_data->start_motion_proj  = EB_FALSE;
     dec_mt_frame_data->start_parse_frame  = EB_FALSE;
     dec_mt_frame_data->start_decode_frame = EB_FALSE;
     dec_mt_frame_data->start_lf_frame     = EB_FALSE;
     dec_mt_frame_data->start_cdef_frame   = EB_FALSE;
     dec_mt_frame_data->start_lr_frame     = EB_FALSE;
-    dec_mt_frame_data->num_threads_cdefed = 0;
-    dec_mt_frame_data->num_threads_lred   = 0;
+    dec_mt_frame_data->start_film_grain   = EB_FALSE;
+
+    /* On a reallocation for a new frame size the workers may still spin on
+       the end of frame barriers of the previous frame: the counters are reset
+       once every worker is past the motion field barrier of the new frame,
+       and the mutex guarding them is kept */
+    if (EB_FALSE == dec_handle_ptr->start_thread_process) {
+        dec_mt_frame_data->temp_mutex         = svt_create_mutex();
+        dec_mt_frame_data->num_threads_cdefed = 0;
+        dec_mt_frame_data->num_threads_lred   = 0;
+    }
 
     /************************************
     * Thread Handles
@@ -365,9 +373,9 @@ EbErrorType dec_system_resource_init(EbDecHandle *dec_handle_ptr, TilesInfo *til
     /* Use a scratch memory so that the memory allocated within
        init_dec_mod_ctxt reallocated when required */
 
-    DecModCtxt **dec_mod_ctxt_arr;
-    EB_MALLOC_DEC(
-        DecModCtxt **, dec_mod_ctxt_arr, num_lib_threads * sizeof(DecModCtxt *), EB_N_PTR);
+    DecModCtxt **dec_mod_ctxt_arr = (DecModCtxt **)malloc(num_lib_threads * sizeof(DecModCtxt *));
+    if (dec_mod_ctxt_arr == NULL)
+        return EB_ErrorInsufficientResources;
 
     for (uint32_t i = 0; i < num_lib_threads; i++) {
         init_dec_mod_ctxt(dec_handle_ptr, (void **)&dec_mod_ctxt_arr[i]);
@@ -456,7 +464,8 @@ void svt_av1_queue_parse_jobs(EbDecHandle *dec_handle_ptr, TilesInfo *tiles_info
     //dec_handle_ptr->start_thread_process = EB_TRUE;
 }
 
-EbErrorType parse_tile_job(EbDecHandle *dec_handle_ptr, int32_t tile_num) {
+EbErrorType parse_tile_job(EbDecHandle *dec_handle_ptr, int32_t tile_num,
+                           DecModCtxt *dec_mod_ctxt) {
     EbErrorType status = EB_ErrorNone;
 
     TilesInfo *    tiles_info      = &dec_handle_ptr->frame_header.tiles_info;
@@ -468,6 +477,7 @@ EbErrorType parse_tile_job(EbDecHandle *dec_handle_ptr, int32_t tile_num) {
 
     parse_ctxt->parse_above_nbr4x4_ctxt = &main_parse_ctxt->parse_above_nbr4x4_ctxt[tile_num];
     parse_ctxt->parse_left_nbr4x4_ctxt  = &main_parse_ctxt->parse_left_nbr4x4_ctxt[tile_num];
+    parse_ctxt->dec_mod_ctxt            = dec_mod_ctxt;
 
     start_parse_tile(dec_handle_ptr, parse_ctxt, tiles_info, tile_num, 1);
 
@@ -491,6 +501,12 @@ void parse_frame_tiles(EbDecHandle *dec_handle_ptr, DecThreadCtxt *thread_ctxt)
 #if MT_WAIT_PROFILE
     dec_display_timer("SPF", &timer, th_cnt, fp);
 #endif
+    /* Parsing may reconstruct SB rows while it waits for a coefficient row */
+    DecModCtxt *dec_mod_ctxt = (DecModCtxt *)dec_handle_ptr->pv_dec_mod_ctxt;
+    if (thread_ctxt != NULL) {
+        dec_mod_ctxt = thread_ctxt->dec_mod_ctxt;
+        setup_segmentation_dequant(dec_mod_ctxt);
+    }
     while (1) {
 #if MT_WAIT_PROFILE
         dec_timer_start(&timer);
@@ -498,7 +514,7 @@ void parse_frame_tiles(EbDecHandle *dec_handle_ptr, DecThreadCtxt *thread_ctxt)
         int32_t tile_num = get_sb_row_to_process(&dec_mt_frame_data->parse_tile_info);
         if (-1 != tile_num) {
             dec_mt_frame_data->start_decode_frame = EB_TRUE;
-            if (EB_ErrorNone != parse_tile_job(dec_handle_ptr, tile_num)) {
+            if (EB_ErrorNone != parse_tile_job(dec_handle_ptr, tile_num, dec_mod_ctxt)) {
                 SVT_LOG("\nParse Issue for Tile %d", tile_num);
                 break;
             }
@@ -1311,6 +1327,31 @@ void dec_av1_loop_restoration_filter_frame_mt(EbDecHandle *dec_handle, DecThread
         ;
 }
 
+/* Adds the film grain to the bands left of the output picture, run by the
+   main thread and by the worker threads waiting for the next frame */
+void svt_dec_film_grain_bands(DecMtFrameData *dec_mt_frame_data) {
+    while (1) {
+        int32_t band = -1;
+
+        svt_block_on_mutex(dec_mt_frame_data->temp_mutex);
+        if (dec_mt_frame_data->start_film_grain &&
+            dec_mt_frame_data->film_grain_band_to_process <
+                dec_mt_frame_data->film_grain_band_count)
+            band = dec_mt_frame_data->film_grain_band_to_process++;
+        svt_release_mutex(dec_mt_frame_data->temp_mutex);
+        if (band < 0)
+            break;
+
+        svt_av1_film_grain_add_noise(dec_mt_frame_data->film_grain_ctxt,
+                                     band * dec_mt_frame_data->film_grain_band_stripes,
+                                     dec_mt_frame_data->film_grain_band_stripes);
+
+        svt_block_on_mutex(dec_mt_frame_data->temp_mutex);
+        dec_mt_frame_data->film_grain_bands_done++;
+        svt_release_mutex(dec_mt_frame_data->temp_mutex);
+    }
+}
+
 void *dec_all_stage_kernel(void *input_ptr) {
     // Context
     DecThreadCtxt * thread_ctxt    = (DecThreadCtxt *)input_ptr;
@@ -236,6 +236,16 @@ typedef struct DecMTFrameData {
     /* LR SB row level map for rows finished LR */
     uint32_t *lr_row_map;
 
+    /* Film grain of the output picture, added in bands of stripes by the main
+       thread and by the worker threads waiting for the next frame. The band
+       state is guarded by temp_mutex */
+    EbBool                start_film_grain;
+    struct FilmGrainCtxt *film_grain_ctxt;
+    int32_t               film_grain_band_stripes;
+    int32_t               film_grain_band_count;
+    int32_t               film_grain_band_to_process;
+    int32_t               film_grain_bands_done;
+
     PrevFrameMtCheck prev_frame_info;
 
     int32_t sb_cols;
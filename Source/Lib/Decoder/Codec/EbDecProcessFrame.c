@@ -125,49 +125,66 @@ EbErrorType decode_tile_row(DecModCtxt *dec_mod_ctxt, TilesInfo *tile_info,
     mt_frame_data->sb_recon_row_map[(index * tile_info->tile_cols) + tile_col] = 1;
     return status;
 }
-EbErrorType decode_tile(DecModCtxt *dec_mod_ctxt, TilesInfo *tile_info,
-                        DecMtParseReconTileInfo *parse_recon_tile_info_array, int32_t tile_col) {
-    EbErrorType status = EB_ErrorNone;
+/* Picks up the next SB row of the tile for reconstruction, if it is not
+   beyond last_sb_row_in_tile. Returns -1 otherwise */
+static int32_t get_tile_sb_row_to_process(DecMtParseReconTileInfo *parse_recon_tile_info_array,
+                                          int32_t                  last_sb_row_in_tile) {
+    int32_t sb_row_in_tile = -1;
+
+    //lock mutex
+    svt_block_on_mutex(parse_recon_tile_info_array->tile_sbrow_mutex);
+
+    //pick up a row and increment the sb row counter
+    if (parse_recon_tile_info_array->sb_row_to_process <= last_sb_row_in_tile) {
+        sb_row_in_tile = parse_recon_tile_info_array->sb_row_to_process;
+        parse_recon_tile_info_array->sb_row_to_process++;
+    }
 
-    while (1) {
-        int32_t sb_row_in_tile = -1;
+    //unlock mutex
+    svt_release_mutex(parse_recon_tile_info_array->tile_sbrow_mutex);
 
-        int32_t sb_row_tile_start = (parse_recon_tile_info_array->tile_info.mi_row_start
-                                     << MI_SIZE_LOG2) >>
-            dec_mod_ctxt->seq_header->sb_size_log2;
+    return sb_row_in_tile;
+}
 
-        //lock mutex
-        svt_block_on_mutex(parse_recon_tile_info_array->tile_sbrow_mutex);
+/* Reconstructs a picked up SB row of the tile once it is parsed */
+static EbErrorType decode_tile_sb_row(DecModCtxt *dec_mod_ctxt, TilesInfo *tile_info,
+                                      DecMtParseReconTileInfo *parse_recon_tile_info_array,
+                                      int32_t tile_col, int32_t sb_row_in_tile) {
+    int32_t sb_row_tile_start = (parse_recon_tile_info_array->tile_info.mi_row_start
+                                 << MI_SIZE_LOG2) >>
+        dec_mod_ctxt->seq_header->sb_size_log2;
 
-        //pick up a row and increment the sb row counter
-        if (parse_recon_tile_info_array->sb_row_to_process !=
-            parse_recon_tile_info_array->tile_num_sb_rows) {
-            sb_row_in_tile = parse_recon_tile_info_array->sb_row_to_process;
-            parse_recon_tile_info_array->sb_row_to_process++;
-        }
+    //wait for parse
+    volatile int32_t *sb_row_parsed = (volatile int32_t *)&parse_recon_tile_info_array
+                                          ->sb_recon_row_parsed[sb_row_in_tile];
+    while (0 == *sb_row_parsed)
+        ;
 
-        //unlock mutex
-        svt_release_mutex(parse_recon_tile_info_array->tile_sbrow_mutex);
+    int32_t sb_row = sb_row_in_tile + sb_row_tile_start;
 
-        //wait for parse
-        if (-1 != sb_row_in_tile) {
-            volatile int32_t *sb_row_parsed = (volatile int32_t *)&parse_recon_tile_info_array
-                                                  ->sb_recon_row_parsed[sb_row_in_tile];
-            while (0 == *sb_row_parsed)
-                ;
+    int32_t mi_row = (sb_row << dec_mod_ctxt->seq_header->sb_size_log2) >> MI_SIZE_LOG2;
 
-            int32_t sb_row = sb_row_in_tile + sb_row_tile_start;
+    EbColorConfig *color_config = &dec_mod_ctxt->seq_header->color_config;
+    svt_cfl_init(&dec_mod_ctxt->cfl_ctx, color_config);
 
-            int32_t mi_row = (sb_row << dec_mod_ctxt->seq_header->sb_size_log2) >> MI_SIZE_LOG2;
+    //update the row started status
+    parse_recon_tile_info_array->sb_recon_row_started[sb_row_in_tile] = 1;
 
-            EbColorConfig *color_config = &dec_mod_ctxt->seq_header->color_config;
-            svt_cfl_init(&dec_mod_ctxt->cfl_ctx, color_config);
+    return decode_tile_row(
+        dec_mod_ctxt, tile_info, parse_recon_tile_info_array, tile_col, mi_row, sb_row);
+}
 
-            //update the row started status
-            parse_recon_tile_info_array->sb_recon_row_started[sb_row_in_tile] = 1;
+EbErrorType decode_tile(DecModCtxt *dec_mod_ctxt, TilesInfo *tile_info,
+                        DecMtParseReconTileInfo *parse_recon_tile_info_array, int32_t tile_col) {
+    EbErrorType status = EB_ErrorNone;
+
+    while (1) {
+        int32_t sb_row_in_tile = get_tile_sb_row_to_process(
+            parse_recon_tile_info_array, parse_recon_tile_info_array->tile_num_sb_rows - 1);
 
-            status = decode_tile_row(
-                dec_mod_ctxt, tile_info, parse_recon_tile_info_array, tile_col, mi_row, sb_row);
+        if (-1 != sb_row_in_tile) {
+            status = decode_tile_sb_row(
+                dec_mod_ctxt, tile_info, parse_recon_tile_info_array, tile_col, sb_row_in_tile);
         }
 
         /*if all sb rows have been picked up for processing then break the while loop */
@@ -179,6 +196,55 @@ EbErrorType decode_tile(DecModCtxt *dec_mod_ctxt, TilesInfo *tile_info,
     return status;
 }
 
+void dec_wait_coeff_row(EbDecHandle *dec_handle_ptr, DecModCtxt *dec_mod_ctxt, int32_t tile_col,
+                        int32_t sb_row) {
+    MainFrameBuf *  main_frame_buf    = &dec_handle_ptr->main_frame_buf;
+    DecMtFrameData *dec_mt_frame_data = &main_frame_buf->cur_frame_bufs[0].dec_mt_frame_data;
+    TilesInfo *     tiles_info        = &dec_handle_ptr->frame_header.tiles_info;
+    int32_t         sb_size_log2      = dec_handle_ptr->seq_header.sb_size_log2;
+    int32_t         prev_sb_row       = sb_row - main_frame_buf->coeff_sb_rows;
+
+    if (prev_sb_row < 0)
+        return;
+
+    volatile uint32_t *prev_row_done = (volatile uint32_t *)&dec_mt_frame_data
+                                           ->sb_recon_row_map[prev_sb_row * tiles_info->tile_cols +
+                                                              tile_col];
+    if (*prev_row_done)
+        return;
+
+    /* The row may belong to the tile above when tiles are shorter than the ring */
+    int32_t prev_mi_row = (prev_sb_row << sb_size_log2) >> MI_SIZE_LOG2;
+    int32_t tile_row    = 0;
+    while (prev_mi_row >= (int32_t)tiles_info->tile_row_start_mi[tile_row + 1]) tile_row++;
+
+    DecMtParseReconTileInfo *parse_recon_tile_info_array =
+        &dec_mt_frame_data->parse_recon_tile_info_array[tile_row * tiles_info->tile_cols +
+                                                        tile_col];
+    int32_t prev_sb_row_in_tile = prev_sb_row -
+        ((parse_recon_tile_info_array->tile_info.mi_row_start << MI_SIZE_LOG2) >> sb_size_log2);
+    EbBool tile_init_done = EB_FALSE;
+
+    /* Rows up to the one holding the buffer that no thread picked up yet
+       are reconstructed here, so that threads parsing never wait for
+       threads which are parsing as well */
+    while (0 == *prev_row_done) {
+        int32_t sb_row_in_tile = get_tile_sb_row_to_process(parse_recon_tile_info_array,
+                                                             prev_sb_row_in_tile);
+        if (-1 == sb_row_in_tile)
+            continue;
+        if (!tile_init_done) {
+            dec_mod_ctxt->frame_header = &dec_handle_ptr->frame_header;
+            dec_mod_ctxt->seq_header   = &dec_handle_ptr->seq_header;
+            svt_tile_init(
+                &dec_mod_ctxt->cur_tile_info, &dec_handle_ptr->frame_header, tile_row, tile_col);
+            tile_init_done = EB_TRUE;
+        }
+        decode_tile_sb_row(
+            dec_mod_ctxt, tiles_info, parse_recon_tile_info_array, tile_col, sb_row_in_tile);
+    }
+}
+
 EbErrorType start_decode_tile(EbDecHandle *dec_handle_ptr, DecModCtxt *dec_mod_ctxt,
                               TilesInfo *tiles_info, int32_t tile_num) {
     DecMtFrameData *dec_mt_frame_data =
@@ -102,6 +102,13 @@ EbErrorType start_decode_tile(EbDecHandle *dec_handle_ptr, DecModCtxt *dec_mod_c
 EbErrorType decode_tile(DecModCtxt *dec_mod_ctxt, TilesInfo *tile_info,
                         DecMtParseReconTileInfo *parse_recon_tile_info_array, int32_t tile_col);
 
+/* Waits in MT until the coefficient buffer row of SB row sb_row of the tile
+   column is free, that is until the SB row parsed into it before is
+   reconstructed. The rows it waits for are reconstructed with dec_mod_ctxt
+   when no other thread picked them up. */
+void dec_wait_coeff_row(EbDecHandle *dec_handle_ptr, DecModCtxt *dec_mod_ctxt, int32_t tile_col,
+                        int32_t sb_row);
+
 /* TODO: Should be moved out once decode tile is moved out from parse_tile */
 void svt_cfl_init(CflCtx *cfl, EbColorConfig *cc);
 
@@ -24,6 +24,7 @@
 #include "EbSequenceControlSet.h"
 #include "EbUtility.h"
 #include "EbPictureControlSet.h"
+#include "EbArena.h"
 
 void copy_sb8_16(uint16_t *dst, int32_t dstride, const uint8_t *src, int32_t src_voffset,
                  int32_t src_hoffset, int32_t sstride, int32_t vsize, int32_t hsize);
@@ -35,14 +36,20 @@ int32_t svt_sb_all_skip(PictureControlSet *pcs_ptr, const Av1Common *const cm, i
                         int32_t mi_col);
 int32_t svt_sb_compute_cdef_list(PictureControlSet *pcs_ptr, const Av1Common *const cm,
                                  int32_t mi_row, int32_t mi_col, CdefList *dlist, BlockSize bs);
-void    finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
+void    finish_cdef_search(EbArena *arena_ptr, PictureControlSet *pcs_ptr,
                            int32_t selected_strength_cnt[64]);
-void    av1_cdef_frame16bit(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
-                            PictureControlSet *pCs);
-void    svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
-                           PictureControlSet *pCs);
+void    av1_cdef_frame16bit(EbArena *arena_ptr, SequenceControlSet *scs_ptr,
+                            PictureControlSet *pCs, CdefRowDoneFunc row_done,
+                            void *row_done_priv);
+void    svt_av1_cdef_frame(EbArena *arena_ptr, SequenceControlSet *scs_ptr,
+                           PictureControlSet *pCs, CdefRowDoneFunc row_done,
+                           void *row_done_priv);
 void    svt_av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *frame, Av1Common *cm,
                                                      int32_t after_cdef);
+void    svt_av1_loop_restoration_save_cdef_boundary_lines(const Yv12BufferConfig *frame,
+                                                          Av1Common *cm, int32_t frame_top);
+void    svt_av1_rest_segment_row_extent(Av1Common *cm, uint8_t rest_segments_row_count,
+                                        uint32_t y_seg_idx, int32_t *y0, int32_t *y1);
 
 /**************************************
  * Cdef Context
@@ -50,11 +57,14 @@ void    svt_av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *fra
 typedef struct CdefContext {
     EbFifo *cdef_input_fifo_ptr;
     EbFifo *cdef_output_fifo_ptr;
+    // scratch buffers of the frame level search and filtering
+    EbArena *arena_ptr;
 } CdefContext;
 
 static void cdef_context_dctor(EbPtr p) {
     EbThreadContext *thread_context_ptr = (EbThreadContext *)p;
     CdefContext *    obj                = (CdefContext *)thread_context_ptr->priv;
+    EB_DELETE(obj->arena_ptr);
     EB_FREE_ARRAY(obj);
 }
 
@@ -73,6 +83,7 @@ EbErrorType cdef_context_ctor(EbThreadContext *  thread_context_ptr,
         enc_handle_ptr->dlf_results_resource_ptr, index);
     context_ptr->cdef_output_fifo_ptr = svt_system_resource_get_producer_fifo(
         enc_handle_ptr->cdef_results_resource_ptr, index);
+    EB_NEW(context_ptr->arena_ptr, svt_arena_ctor, 0);
 
     return EB_ErrorNone;
 }
@@ -474,121 +485,238 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
 }
 
 /******************************************************
- * CDEF Kernel
+ * CDEF Process
  ******************************************************/
-void *cdef_kernel(void *input_ptr) {
-    // Context & SCS & PCS
-    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
-    CdefContext *       context_ptr        = (CdefContext *)thread_context_ptr->priv;
+/******************************************************
+ * Post Rest Segments
+ *   Hands the restoration segments of the picture of the
+ *   input object to Rest, from first_segment. Returns
+ *   EB_FALSE when the task was parked on an empty
+ *   output fifo.
+ ******************************************************/
+static EbBool post_rest_segments(CdefContext *context_ptr, EbObjectWrapper *dlf_results_wrapper_ptr,
+                                 uint16_t first_segment) {
+    DlfResults *       dlf_results_ptr = (DlfResults *)dlf_results_wrapper_ptr->object_ptr;
+    PictureControlSet *pcs_ptr = (PictureControlSet *)dlf_results_ptr->pcs_wrapper_ptr->object_ptr;
+    EbObjectWrapper *  cdef_results_wrapper_ptr;
+    CdefResults *      cdef_results_ptr;
+
+    for (uint16_t segment_index = first_segment;
+         segment_index < pcs_ptr->rest_segments_total_count;
+         ++segment_index) {
+        // Get Empty Cdef Results to Rest
+        if (!svt_get_output_object(context_ptr->cdef_output_fifo_ptr,
+                                   dlf_results_wrapper_ptr,
+                                   &cdef_results_wrapper_ptr)) {
+            dlf_results_ptr->parked       = EB_TRUE;
+            dlf_results_ptr->posted_count = segment_index;
+            svt_park_full_object(dlf_results_wrapper_ptr);
+            return EB_FALSE;
+        }
+        cdef_results_ptr = (struct CdefResults *)cdef_results_wrapper_ptr->object_ptr;
+        cdef_results_ptr->pcs_wrapper_ptr = dlf_results_ptr->pcs_wrapper_ptr;
+        cdef_results_ptr->segment_index   = segment_index;
+        cdef_results_ptr->parked          = EB_FALSE;
+        // Post Cdef Results
+        svt_post_full_object(cdef_results_wrapper_ptr);
+    }
+    return EB_TRUE;
+}
+
+/******************************************************
+ * Cdef Row Done
+ *   Called by the CDEF application after each 64 pixel
+ *   row. Posts the restoration segment rows whose search
+ *   reads final rows only, the last row waits for the
+ *   bottom boundary lines, saved after the frame. An
+ *   empty output fifo leaves the segments to
+ *   post_rest_segments.
+ ******************************************************/
+typedef struct CdefRowDoneContext {
+    CdefContext *    context_ptr;
+    EbObjectWrapper *dlf_results_wrapper_ptr;
+} CdefRowDoneContext;
+
+static void cdef_row_done(int32_t fbr, void *priv) {
+    CdefRowDoneContext *row_done_ctx    = (CdefRowDoneContext *)priv;
+    DlfResults *        dlf_results_ptr = (DlfResults *)
+                                       row_done_ctx->dlf_results_wrapper_ptr->object_ptr;
+    PictureControlSet *pcs_ptr = (PictureControlSet *)dlf_results_ptr->pcs_wrapper_ptr->object_ptr;
+    Av1Common *        cm      = pcs_ptr->parent_pcs_ptr->av1_cm;
+    const int32_t      rows_done = (fbr + 1) * (MI_SIZE_64X64 << MI_SIZE_LOG2);
+    EbObjectWrapper *  cdef_results_wrapper_ptr;
+    CdefResults *      cdef_results_ptr;
+    int32_t            y0, y1;
+
+    if (fbr == 0)
+        svt_av1_loop_restoration_save_cdef_boundary_lines(cm->frame_to_show, cm, 1);
+    while (pcs_ptr->rest_segments_posted / pcs_ptr->rest_segments_column_count <
+           pcs_ptr->rest_segments_row_count - 1) {
+        svt_av1_rest_segment_row_extent(
+            cm,
+            pcs_ptr->rest_segments_row_count,
+            pcs_ptr->rest_segments_posted / pcs_ptr->rest_segments_column_count,
+            &y0,
+            &y1);
+        if (y1 > rows_done)
+            return;
+        svt_get_empty_object_non_blocking(row_done_ctx->context_ptr->cdef_output_fifo_ptr,
+                                          &cdef_results_wrapper_ptr);
+        if (!cdef_results_wrapper_ptr)
+            return;
+        cdef_results_ptr = (struct CdefResults *)cdef_results_wrapper_ptr->object_ptr;
+        cdef_results_ptr->pcs_wrapper_ptr = dlf_results_ptr->pcs_wrapper_ptr;
+        cdef_results_ptr->segment_index   = pcs_ptr->rest_segments_posted++;
+        cdef_results_ptr->parked          = EB_FALSE;
+        // Post Cdef Results
+        svt_post_full_object(cdef_results_wrapper_ptr);
+    }
+}
+
+static void cdef_process(CdefContext *context_ptr, EbObjectWrapper *dlf_results_wrapper_ptr) {
     PictureControlSet * pcs_ptr;
     SequenceControlSet *scs_ptr;
 
     //// Input
-    EbObjectWrapper *dlf_results_wrapper_ptr;
-    DlfResults *     dlf_results_ptr;
-
-    //// Output
-    EbObjectWrapper *cdef_results_wrapper_ptr;
-    CdefResults *    cdef_results_ptr;
+    DlfResults *dlf_results_ptr;
 
     // SB Loop variables
 
-    for (;;) {
-        FrameHeader *frm_hdr;
-
-        // Get DLF Results
-        EB_GET_FULL_OBJECT(context_ptr->cdef_input_fifo_ptr, &dlf_results_wrapper_ptr);
-
-        dlf_results_ptr = (DlfResults *)dlf_results_wrapper_ptr->object_ptr;
-        pcs_ptr         = (PictureControlSet *)dlf_results_ptr->pcs_wrapper_ptr->object_ptr;
-        scs_ptr         = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    FrameHeader *frm_hdr;
+    EbBool       last_segment;
 
-        EbBool     is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        Av1Common *cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
-        frm_hdr             = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    dlf_results_ptr = (DlfResults *)dlf_results_wrapper_ptr->object_ptr;
+    if (dlf_results_ptr->parked) {
+        // Requeued on an empty output fifo, post the remaining segments
+        if (post_rest_segments(
+                context_ptr, dlf_results_wrapper_ptr, dlf_results_ptr->posted_count))
+            svt_release_object(dlf_results_wrapper_ptr);
+        return;
+    }
+    pcs_ptr         = (PictureControlSet *)dlf_results_ptr->pcs_wrapper_ptr->object_ptr;
+    scs_ptr         = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+
+    EbBool     is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common *cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
+    frm_hdr             = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+
+    if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
+        if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
+            cdef_seg_search16bit(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
+        else
+            cdef_seg_search(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
+    }
 
+    //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
+    svt_block_on_mutex(pcs_ptr->cdef_search_mutex);
+
+    pcs_ptr->tot_seg_searched_cdef++;
+    last_segment = pcs_ptr->tot_seg_searched_cdef == pcs_ptr->cdef_segments_total_count;
+    if (last_segment) {
+        // SVT_LOG("    CDEF all seg here  %i\n", pcs_ptr->picture_number);
+        pcs_ptr->rest_segments_column_count = scs_ptr->rest_segment_column_count;
+        pcs_ptr->rest_segments_row_count    = scs_ptr->rest_segment_row_count;
+        pcs_ptr->rest_segments_total_count  = (uint16_t)(pcs_ptr->rest_segments_column_count *
+                                                        pcs_ptr->rest_segments_row_count);
+        pcs_ptr->tot_seg_searched_rest      = 0;
+        pcs_ptr->rest_segments_posted       = 0;
+        pcs_ptr->rest_streaming             = EB_FALSE;
         if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
-            if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
-                cdef_seg_search16bit(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
-            else
-                cdef_seg_search(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
-        }
-
-        //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
-        svt_block_on_mutex(pcs_ptr->cdef_search_mutex);
-
-        pcs_ptr->tot_seg_searched_cdef++;
-        if (pcs_ptr->tot_seg_searched_cdef == pcs_ptr->cdef_segments_total_count) {
-            // SVT_LOG("    CDEF all seg here  %i\n", pcs_ptr->picture_number);
-            if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
-                int32_t selected_strength_cnt[64] = {0};
-                finish_cdef_search(0, pcs_ptr, selected_strength_cnt);
-
-                if (scs_ptr->seq_header.enable_restoration != 0 ||
-                    pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
-                    scs_ptr->static_config.recon_enabled) {
-                    if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
-                        av1_cdef_frame16bit(0, scs_ptr, pcs_ptr);
-                    else
-                        svt_av1_cdef_frame(0, scs_ptr, pcs_ptr);
-                }
-            } else {
-                frm_hdr->cdef_params.cdef_bits             = 0;
-                frm_hdr->cdef_params.cdef_y_strength[0]    = 0;
-                pcs_ptr->parent_pcs_ptr->nb_cdef_strengths = 1;
-                frm_hdr->cdef_params.cdef_uv_strength[0]   = 0;
+            int32_t selected_strength_cnt[64] = {0};
+            svt_arena_reset(context_ptr->arena_ptr);
+            finish_cdef_search(context_ptr->arena_ptr, pcs_ptr, selected_strength_cnt);
+
+            if (scs_ptr->seq_header.enable_restoration != 0 ||
+                pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
+                scs_ptr->static_config.recon_enabled) {
+                CdefRowDoneContext row_done_ctx = {context_ptr, dlf_results_wrapper_ptr};
+                // The search of a restoration segment row starts once its rows are filtered
+                pcs_ptr->rest_streaming = scs_ptr->seq_header.enable_restoration &&
+                    frm_hdr->allow_intrabc == 0 && av1_superres_unscaled(&cm->frm_size) &&
+                    pcs_ptr->rest_segments_row_count > 1;
+                if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
+                    av1_cdef_frame16bit(context_ptr->arena_ptr,
+                                        scs_ptr,
+                                        pcs_ptr,
+                                        pcs_ptr->rest_streaming ? cdef_row_done : NULL,
+                                        &row_done_ctx);
+                else
+                    svt_av1_cdef_frame(context_ptr->arena_ptr,
+                                       scs_ptr,
+                                       pcs_ptr,
+                                       pcs_ptr->rest_streaming ? cdef_row_done : NULL,
+                                       &row_done_ctx);
             }
+        } else {
+            frm_hdr->cdef_params.cdef_bits             = 0;
+            frm_hdr->cdef_params.cdef_y_strength[0]    = 0;
+            pcs_ptr->parent_pcs_ptr->nb_cdef_strengths = 1;
+            frm_hdr->cdef_params.cdef_uv_strength[0]   = 0;
+        }
 
-            //restoration prep
+        //restoration prep
 
-            if (scs_ptr->seq_header.enable_restoration) {
+        if (scs_ptr->seq_header.enable_restoration) {
+            // The top lines of a streamed picture are saved after its first row
+            if (pcs_ptr->rest_streaming)
+                svt_av1_loop_restoration_save_cdef_boundary_lines(cm->frame_to_show, cm, 0);
+            else
                 svt_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 1);
 
-                //are these still needed here?/!!!
-                svt_extend_frame(cm->frame_to_show->buffers[0],
-                                 cm->frame_to_show->crop_widths[0],
-                                 cm->frame_to_show->crop_heights[0],
-                                 cm->frame_to_show->strides[0],
-                                 RESTORATION_BORDER,
-                                 RESTORATION_BORDER,
-                                 scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-                svt_extend_frame(cm->frame_to_show->buffers[1],
-                                 cm->frame_to_show->crop_widths[1],
-                                 cm->frame_to_show->crop_heights[1],
-                                 cm->frame_to_show->strides[1],
-                                 RESTORATION_BORDER,
-                                 RESTORATION_BORDER,
-                                 scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-                svt_extend_frame(cm->frame_to_show->buffers[2],
-                                 cm->frame_to_show->crop_widths[1],
-                                 cm->frame_to_show->crop_heights[1],
-                                 cm->frame_to_show->strides[1],
-                                 RESTORATION_BORDER,
-                                 RESTORATION_BORDER,
-                                 scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-            }
-
-            pcs_ptr->rest_segments_column_count = scs_ptr->rest_segment_column_count;
-            pcs_ptr->rest_segments_row_count    = scs_ptr->rest_segment_row_count;
-            pcs_ptr->rest_segments_total_count  = (uint16_t)(pcs_ptr->rest_segments_column_count *
-                                                            pcs_ptr->rest_segments_row_count);
-            pcs_ptr->tot_seg_searched_rest      = 0;
-            uint32_t segment_index;
-            for (segment_index = 0; segment_index < pcs_ptr->rest_segments_total_count;
-                 ++segment_index) {
-                // Get Empty Cdef Results to Rest
-                svt_get_empty_object(context_ptr->cdef_output_fifo_ptr, &cdef_results_wrapper_ptr);
-                cdef_results_ptr = (struct CdefResults *)cdef_results_wrapper_ptr->object_ptr;
-                cdef_results_ptr->pcs_wrapper_ptr = dlf_results_ptr->pcs_wrapper_ptr;
-                cdef_results_ptr->segment_index   = segment_index;
-                // Post Cdef Results
-                svt_post_full_object(cdef_results_wrapper_ptr);
-            }
+            //are these still needed here?/!!!
+            svt_extend_frame(cm->frame_to_show->buffers[0],
+                             cm->frame_to_show->crop_widths[0],
+                             cm->frame_to_show->crop_heights[0],
+                             cm->frame_to_show->strides[0],
+                             RESTORATION_BORDER,
+                             RESTORATION_BORDER,
+                             scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+            svt_extend_frame(cm->frame_to_show->buffers[1],
+                             cm->frame_to_show->crop_widths[1],
+                             cm->frame_to_show->crop_heights[1],
+                             cm->frame_to_show->strides[1],
+                             RESTORATION_BORDER,
+                             RESTORATION_BORDER,
+                             scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+            svt_extend_frame(cm->frame_to_show->buffers[2],
+                             cm->frame_to_show->crop_widths[1],
+                             cm->frame_to_show->crop_heights[1],
+                             cm->frame_to_show->strides[1],
+                             RESTORATION_BORDER,
+                             RESTORATION_BORDER,
+                             scs_ptr->static_config.is_16bit_pipeline || is_16bit);
         }
-        svt_release_mutex(pcs_ptr->cdef_search_mutex);
+    }
+    svt_release_mutex(pcs_ptr->cdef_search_mutex);
+
+    if (last_segment &&
+        !post_rest_segments(context_ptr, dlf_results_wrapper_ptr, pcs_ptr->rest_segments_posted))
+        return;
+    // Release Dlf Results
+    svt_release_object(dlf_results_wrapper_ptr);
+}
+
+/******************************************************
+ * CDEF Pool Task
+ *   Runs one DLF Results segment on a thread pool worker
+ ******************************************************/
+void cdef_pool_task(void *thread_context_ptr, void *wrapper_ptr) {
+    cdef_process((CdefContext *)((EbThreadContext *)thread_context_ptr)->priv,
+                 (EbObjectWrapper *)wrapper_ptr);
+}
+
+/******************************************************
+ * CDEF Kernel
+ ******************************************************/
+void *cdef_kernel(void *input_ptr) {
+    EbThreadContext *thread_context_ptr = (EbThreadContext *)input_ptr;
+    CdefContext *    context_ptr        = (CdefContext *)thread_context_ptr->priv;
+    EbObjectWrapper *dlf_results_wrapper_ptr;
 
-        // Release Dlf Results
-        svt_release_object(dlf_results_wrapper_ptr);
+    for (;;) {
+        // Get DLF Results
+        EB_GET_FULL_OBJECT(context_ptr->cdef_input_fifo_ptr, &dlf_results_wrapper_ptr);
+        cdef_process(context_ptr, dlf_results_wrapper_ptr);
     }
 
     return NULL;
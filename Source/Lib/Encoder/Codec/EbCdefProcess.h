@@ -22,5 +22,6 @@ extern EbErrorType cdef_context_ctor(EbThreadContext *  thread_context_ptr,
                                      const EbEncHandle *enc_handle_ptr, int index);
 
 extern void *cdef_kernel(void *input_ptr);
+extern void  cdef_pool_task(void *thread_context_ptr, void *wrapper_ptr);
 
 #endif
@@ -751,6 +751,93 @@ void svt_av1_loop_filter_frame(EbPictureBufferDesc *frame_buffer, PictureControl
         }
     }
 }
+
+// Filters one direction of the edges of the SBs at (mi_row, mi_col) steps,
+// skipping the planes as loop_filter_sb() does
+static void loop_filter_sb_dir(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                               int32_t mi_row, int32_t mi_col, int32_t mi_row_step,
+                               int32_t mi_col_step, uint32_t sb_count, int32_t plane_start,
+                               int32_t plane_end, int32_t dir) {
+    FrameHeader *           frm_hdr = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    const BlockSize         sb_size = pcs_ptr->parent_pcs_ptr->scs_ptr->seq_header.sb_size;
+    struct MacroblockdPlane pd[3];
+
+    pd[0].subsampling_x = 0;
+    pd[0].subsampling_y = 0;
+    pd[0].plane_type    = PLANE_TYPE_Y;
+    pd[1].subsampling_x = 1;
+    pd[1].subsampling_y = 1;
+    pd[1].plane_type    = PLANE_TYPE_UV;
+    pd[2].subsampling_x = 1;
+    pd[2].subsampling_y = 1;
+    pd[2].plane_type    = PLANE_TYPE_UV;
+    pd[0].is_16bit = pd[1].is_16bit = pd[2].is_16bit =
+        (pcs_ptr->parent_pcs_ptr->scs_ptr->static_config.is_16bit_pipeline ||
+         frame_buffer->bit_depth > 8);
+
+    for (int32_t plane = plane_start; plane < plane_end; plane++) {
+        if (plane == 0 && !(frm_hdr->loop_filter_params.filter_level[0]) &&
+            !(frm_hdr->loop_filter_params.filter_level[1]))
+            break;
+        else if (plane == 1 && !(frm_hdr->loop_filter_params.filter_level_u))
+            continue;
+        else if (plane == 2 && !(frm_hdr->loop_filter_params.filter_level_v))
+            continue;
+
+        for (uint32_t sb_index = 0; sb_index < sb_count; sb_index++) {
+            const int32_t sb_mi_row = mi_row + (int32_t)sb_index * mi_row_step;
+            const int32_t sb_mi_col = mi_col + (int32_t)sb_index * mi_col_step;
+            svt_av1_setup_dst_planes(
+                pd, sb_size, frame_buffer, sb_mi_row, sb_mi_col, plane, plane + 1);
+            if (dir == 0)
+                svt_av1_filter_block_plane_vert(
+                    pcs_ptr, NULL, plane, &pd[plane], sb_mi_row, sb_mi_col);
+            else
+                svt_av1_filter_block_plane_horz(
+                    pcs_ptr, NULL, plane, &pd[plane], sb_mi_row, sb_mi_col);
+        }
+    }
+}
+
+void svt_av1_loop_filter_sb_row_vert(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                     uint32_t sb_row, int32_t plane_start, int32_t plane_end) {
+    SequenceControlSet *scs_ptr         = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    const int32_t       sb_mi_size      = scs_ptr->sb_size_pix >> MI_SIZE_LOG2;
+    const uint32_t      pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width +
+                                      scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+
+    loop_filter_sb_dir(frame_buffer,
+                       pcs_ptr,
+                       (int32_t)sb_row * sb_mi_size,
+                       0,
+                       0,
+                       sb_mi_size,
+                       pic_width_in_sb,
+                       plane_start,
+                       plane_end,
+                       0);
+}
+
+void svt_av1_loop_filter_sb_col_horz(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                     uint32_t sb_col, int32_t plane_start, int32_t plane_end) {
+    SequenceControlSet *scs_ptr              = pcs_ptr->parent_pcs_ptr->scs_ptr;
+    const int32_t       sb_mi_size           = scs_ptr->sb_size_pix >> MI_SIZE_LOG2;
+    const uint32_t      picture_height_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_height +
+                                           scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+
+    loop_filter_sb_dir(frame_buffer,
+                       pcs_ptr,
+                       0,
+                       (int32_t)sb_col * sb_mi_size,
+                       sb_mi_size,
+                       0,
+                       picture_height_in_sb,
+                       plane_start,
+                       plane_end,
+                       1);
+}
 extern int16_t svt_av1_ac_quant_q3(int32_t qindex, int32_t delta, AomBitDepth bit_depth);
 
 void svt_copy_buffer(EbPictureBufferDesc *srcBuffer, EbPictureBufferDesc *dstBuffer,
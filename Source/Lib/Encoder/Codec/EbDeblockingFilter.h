@@ -54,6 +54,18 @@ void svt_av1_loop_filter_frame(
         /*MacroBlockD *xd,*/ int32_t plane_start, int32_t plane_end/*,
         int32_t partial_frame*/);
 
+// Split form of svt_av1_loop_filter_frame() for combine_vert_horz_lf, once
+// svt_av1_loop_filter_frame_init() is done: the vertical edges of every SB row,
+// then the horizontal edges of every SB column. Vertical edges only touch the
+// pixel rows of their own SB row and horizontal edges the pixel columns of
+// their own SB column, so the rows and then the columns can be filtered
+// concurrently with the same output as the raster order.
+void svt_av1_loop_filter_sb_row_vert(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                     uint32_t sb_row, int32_t plane_start, int32_t plane_end);
+
+void svt_av1_loop_filter_sb_col_horz(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                     uint32_t sb_col, int32_t plane_start, int32_t plane_end);
+
 void svt_av1_pick_filter_level(DlfContext *         context_ptr,
                                EbPictureBufferDesc *srcBuffer, // source input
                                PictureControlSet *pcs_ptr, LpfPickMethod method);
@@ -20,6 +20,8 @@
 #include "EbSequenceControlSet.h"
 #include "EbPictureControlSet.h"
 #include "aom_dsp_rtcd.h"
+#include "EbUtility.h"
+#include "EbCdef.h"
 
 void svt_av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *frame, Av1Common *cm,
                                                   int32_t after_cdef);
@@ -35,7 +37,7 @@ static void dlf_context_dctor(EbPtr p) {
  * Dlf Context Constructor
  ******************************************************/
 EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHandle *enc_handle_ptr,
-                             int index) {
+                             int index, int feedback_index) {
     const SequenceControlSet *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
     EbBool        is_16bit     = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
     EbColorFormat color_format = scs_ptr->static_config.encoder_color_format;
@@ -50,6 +52,8 @@ EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHan
         enc_handle_ptr->enc_dec_results_resource_ptr, index);
     context_ptr->dlf_output_fifo_ptr = svt_system_resource_get_producer_fifo(
         enc_handle_ptr->dlf_results_resource_ptr, index);
+    context_ptr->dlf_feedback_fifo_ptr = svt_system_resource_get_producer_fifo(
+        enc_handle_ptr->enc_dec_results_resource_ptr, feedback_index);
 
     context_ptr->temp_lf_recon_picture16bit_ptr = (EbPictureBufferDesc *)NULL;
     context_ptr->temp_lf_recon_picture_ptr      = (EbPictureBufferDesc *)NULL;
@@ -83,256 +87,571 @@ EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHan
     return EB_ErrorNone;
 }
 
+static EbPictureBufferDesc *get_dlf_recon_buffer(PictureControlSet *pcs_ptr) {
+    SequenceControlSet *scs_ptr  = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbBool              is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+
+    if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+        EbReferenceObject *ref_obj =
+            (EbReferenceObject *)pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
+        return (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
+            ? ref_obj->reference_picture16bit
+            : ref_obj->reference_picture;
+    }
+    return (scs_ptr->static_config.is_16bit_pipeline || is_16bit) ? pcs_ptr->recon_picture16bit_ptr
+                                                                  : pcs_ptr->recon_picture_ptr;
+}
+
 /******************************************************
- * Dlf Kernel
+ * Post Cdef Segments
+ *   Hands the CDEF segments of the picture of the input
+ *   object to CDEF, from first_segment to end_segment.
+ *   Returns EB_FALSE when the task was parked on an
+ *   empty output fifo.
  ******************************************************/
-void *dlf_kernel(void *input_ptr) {
-    // Context & SCS & PCS
-    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
-    DlfContext *        context_ptr        = (DlfContext *)thread_context_ptr->priv;
+static EbBool post_cdef_segments(DlfContext *context_ptr, EbObjectWrapper *input_wrapper_ptr,
+                                 uint16_t first_segment, uint16_t end_segment) {
+    EncDecResults *    input_ptr = (EncDecResults *)input_wrapper_ptr->object_ptr;
+    EbObjectWrapper *  dlf_results_wrapper_ptr;
+    struct DlfResults *dlf_results_ptr;
+
+    for (uint16_t segment_index = first_segment; segment_index < end_segment; ++segment_index) {
+        // Get Empty DLF Results to Cdef
+        if (!svt_get_output_object(
+                context_ptr->dlf_output_fifo_ptr, input_wrapper_ptr, &dlf_results_wrapper_ptr)) {
+            input_ptr->input_type    = DLF_TASKS_POST_CDEF;
+            input_ptr->posted_count  = segment_index;
+            input_ptr->segment_index = end_segment;
+            svt_park_full_object(input_wrapper_ptr);
+            return EB_FALSE;
+        }
+        dlf_results_ptr = (struct DlfResults *)dlf_results_wrapper_ptr->object_ptr;
+        dlf_results_ptr->pcs_wrapper_ptr = input_ptr->pcs_wrapper_ptr;
+        dlf_results_ptr->segment_index   = segment_index;
+        dlf_results_ptr->parked          = EB_FALSE;
+        // Post DLF Results
+        svt_post_full_object(dlf_results_wrapper_ptr);
+    }
+    return EB_TRUE;
+}
+
+/******************************************************
+ * Dlf Cdef Prep
+ *   Points the CDEF search at the deblocked picture and
+ *   at the source, and sets the CDEF segments up. Runs
+ *   once per picture, with sb_row_mutex held, before the
+ *   first CDEF segment is posted.
+ ******************************************************/
+static void dlf_cdef_prep(PictureControlSet *pcs_ptr) {
+    SequenceControlSet *scs_ptr  = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbBool              is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+
+    if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
+        EbPictureBufferDesc *recon_picture_ptr = get_dlf_recon_buffer(pcs_ptr);
+        if (scs_ptr->static_config.is_16bit_pipeline || is_16bit) {
+            pcs_ptr->src[0] = (uint16_t *)recon_picture_ptr->buffer_y +
+                (recon_picture_ptr->origin_x +
+                 recon_picture_ptr->origin_y * recon_picture_ptr->stride_y);
+            pcs_ptr->src[1] = (uint16_t *)recon_picture_ptr->buffer_cb +
+                (recon_picture_ptr->origin_x / 2 +
+                 recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cb);
+            pcs_ptr->src[2] = (uint16_t *)recon_picture_ptr->buffer_cr +
+                (recon_picture_ptr->origin_x / 2 +
+                 recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cr);
+
+            EbPictureBufferDesc *input_picture_ptr = pcs_ptr->input_frame16bit;
+            pcs_ptr->ref_coeff[0] = (uint16_t *)input_picture_ptr->buffer_y +
+                (input_picture_ptr->origin_x +
+                 input_picture_ptr->origin_y * input_picture_ptr->stride_y);
+            pcs_ptr->ref_coeff[1] = (uint16_t *)input_picture_ptr->buffer_cb +
+                (input_picture_ptr->origin_x / 2 +
+                 input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb);
+            pcs_ptr->ref_coeff[2] = (uint16_t *)input_picture_ptr->buffer_cr +
+                (input_picture_ptr->origin_x / 2 +
+                 input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr);
+        } else {
+            EbByte rec_ptr    = &((
+                recon_picture_ptr
+                    ->buffer_y)[recon_picture_ptr->origin_x +
+                                recon_picture_ptr->origin_y * recon_picture_ptr->stride_y]);
+            EbByte rec_ptr_cb = &(
+                (recon_picture_ptr->buffer_cb)[recon_picture_ptr->origin_x / 2 +
+                                               recon_picture_ptr->origin_y / 2 *
+                                                   recon_picture_ptr->stride_cb]);
+            EbByte rec_ptr_cr = &(
+                (recon_picture_ptr->buffer_cr)[recon_picture_ptr->origin_x / 2 +
+                                               recon_picture_ptr->origin_y / 2 *
+                                                   recon_picture_ptr->stride_cr]);
+
+            EbPictureBufferDesc *input_picture_ptr =
+                (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+            EbByte enh_ptr    = &((
+                input_picture_ptr
+                    ->buffer_y)[input_picture_ptr->origin_x +
+                                input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
+            EbByte enh_ptr_cb = &(
+                (input_picture_ptr->buffer_cb)[input_picture_ptr->origin_x / 2 +
+                                               input_picture_ptr->origin_y / 2 *
+                                                   input_picture_ptr->stride_cb]);
+            EbByte enh_ptr_cr = &(
+                (input_picture_ptr->buffer_cr)[input_picture_ptr->origin_x / 2 +
+                                               input_picture_ptr->origin_y / 2 *
+                                                   input_picture_ptr->stride_cr]);
+
+            pcs_ptr->src[0] = (uint16_t *)rec_ptr;
+            pcs_ptr->src[1] = (uint16_t *)rec_ptr_cb;
+            pcs_ptr->src[2] = (uint16_t *)rec_ptr_cr;
+
+            pcs_ptr->ref_coeff[0] = (uint16_t *)enh_ptr;
+            pcs_ptr->ref_coeff[1] = (uint16_t *)enh_ptr_cb;
+            pcs_ptr->ref_coeff[2] = (uint16_t *)enh_ptr_cr;
+        }
+    }
+
+    pcs_ptr->cdef_segments_column_count = scs_ptr->cdef_segment_column_count;
+    pcs_ptr->cdef_segments_row_count    = scs_ptr->cdef_segment_row_count;
+    pcs_ptr->cdef_segments_total_count  = (uint16_t)(pcs_ptr->cdef_segments_column_count *
+                                                    pcs_ptr->cdef_segments_row_count);
+    pcs_ptr->tot_seg_searched_cdef      = 0;
+    pcs_ptr->cdef_prep_done             = EB_TRUE;
+}
+
+/******************************************************
+ * Cdef Segment Rows Ready
+ *   Counts the leading CDEF segment rows whose input is
+ *   final while EncDec codes the picture. The search of
+ *   a segment row reads the 64x64 block row below it for
+ *   the blocks 128 high, and CDEF_VBORDER rows more. The
+ *   SB filtering of EncDec touches the bottom rows of the
+ *   SB row above, so these rows are final once the SB row
+ *   below them is coded as well. The last segment row is
+ *   left to the completed picture, which saves the
+ *   restoration boundaries before CDEF filters the frame.
+ ******************************************************/
+static uint16_t cdef_segment_rows_ready(PictureControlSet *pcs_ptr) {
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    const uint32_t      picture_height_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_height +
+                                           scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+    const uint32_t picture_height_in_b64 = (pcs_ptr->parent_pcs_ptr->aligned_height + 64 - 1) /
+        64;
+    uint16_t segment_rows = 0;
+
+    while (segment_rows < scs_ptr->cdef_segment_row_count) {
+        const uint32_t b64_end_idx = SEGMENT_END_IDX(
+            segment_rows, picture_height_in_b64, scs_ptr->cdef_segment_row_count);
+        const uint32_t last_sb_row = ((b64_end_idx + 1) * 64 + CDEF_VBORDER - 1) /
+            scs_ptr->sb_size_pix;
+        if (last_sb_row + 2 >= picture_height_in_sb || last_sb_row + 2 > pcs_ptr->sb_rows_coded)
+            break;
+        ++segment_rows;
+    }
+    return segment_rows;
+}
+
+/******************************************************
+ * Claim Cdef Segments
+ *   Takes the CDEF segments of the picture not posted
+ *   yet that are ready, all of them once the picture is
+ *   complete. Returns the end of the segments taken,
+ *   which start at *first_segment.
+ ******************************************************/
+static uint16_t claim_cdef_segments(PictureControlSet *pcs_ptr, EbBool picture_complete,
+                                    uint16_t *first_segment) {
+    uint16_t end_segment;
+
+    svt_block_on_mutex(pcs_ptr->sb_row_mutex);
+    if (!pcs_ptr->cdef_prep_done)
+        dlf_cdef_prep(pcs_ptr);
+    *first_segment = pcs_ptr->cdef_segments_posted;
+    end_segment    = picture_complete
+           ? pcs_ptr->cdef_segments_total_count
+           : (uint16_t)MAX(pcs_ptr->cdef_segments_posted,
+                        cdef_segment_rows_ready(pcs_ptr) * pcs_ptr->cdef_segments_column_count);
+    pcs_ptr->cdef_segments_posted = end_segment;
+    svt_release_mutex(pcs_ptr->sb_row_mutex);
+    return end_segment;
+}
+
+/******************************************************
+ * Dlf Sb Row Init
+ *   Resets the SB row progress of a picture about to be
+ *   coded by EncDec. Its CDEF segments are handed out as
+ *   SB rows complete when the rows coded are not touched
+ *   again: no frame deblocking in DLF (loop filter mode
+ *   0, or 1 with a single tile where EncDec filters each
+ *   SB), no 8 to 16 bit input conversion in DLF, and no
+ *   re-encode of the picture.
+ ******************************************************/
+void svt_dlf_sb_row_init(PictureControlSet *pcs_ptr) {
+    SequenceControlSet *     scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    PictureParentControlSet *ppcs    = pcs_ptr->parent_pcs_ptr;
+    const uint16_t           total_tile_cnt = ppcs->av1_cm->tiles_info.tile_cols *
+        ppcs->av1_cm->tiles_info.tile_rows;
+    const uint32_t picture_height_in_sb = (ppcs->aligned_height + scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+
+    pcs_ptr->sb_row_streaming = scs_ptr->cdef_segment_row_count > 1 &&
+        (ppcs->loop_filter_mode == 0 || (ppcs->loop_filter_mode == 1 && total_tile_cnt == 1)) &&
+        !(scs_ptr->static_config.is_16bit_pipeline &&
+          scs_ptr->static_config.encoder_bit_depth == EB_8BIT) &&
+        !use_output_stat(scs_ptr) &&
+        !((use_input_stat(scs_ptr) || scs_ptr->lap_enabled) &&
+          scs_ptr->static_config.recode_loop != DISALLOW_RECODE);
+    memset(pcs_ptr->sb_row_coded_count,
+           0,
+           sizeof(*pcs_ptr->sb_row_coded_count) * picture_height_in_sb);
+    pcs_ptr->sb_rows_coded        = 0;
+    pcs_ptr->cdef_segments_posted = 0;
+    pcs_ptr->cdef_prep_done       = EB_FALSE;
+}
+
+/******************************************************
+ * Dlf Sb Coded
+ *   Records an SB of sb_row coded by EncDec. Returns
+ *   EB_TRUE when this completes CDEF segment rows, which
+ *   EncDec then hands to DLF.
+ ******************************************************/
+EbBool svt_dlf_sb_coded(PictureControlSet *pcs_ptr, uint32_t sb_row) {
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    const uint32_t      pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width +
+                                      scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+    const uint32_t picture_height_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_height +
+                                           scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+    EbBool rows_ready = EB_FALSE;
+
+    if (!pcs_ptr->sb_row_streaming)
+        return EB_FALSE;
+    svt_block_on_mutex(pcs_ptr->sb_row_mutex);
+    if (++pcs_ptr->sb_row_coded_count[sb_row] == pic_width_in_sb &&
+        sb_row == pcs_ptr->sb_rows_coded) {
+        const uint16_t segment_rows = cdef_segment_rows_ready(pcs_ptr);
+        while (pcs_ptr->sb_rows_coded < picture_height_in_sb &&
+               pcs_ptr->sb_row_coded_count[pcs_ptr->sb_rows_coded] == pic_width_in_sb)
+            ++pcs_ptr->sb_rows_coded;
+        rows_ready = cdef_segment_rows_ready(pcs_ptr) > segment_rows;
+    }
+    svt_release_mutex(pcs_ptr->sb_row_mutex);
+    return rows_ready;
+}
+
+/******************************************************
+ * Dlf Post Results
+ *   Prepares the deblocked picture for restoration and
+ *   posts its CDEF segments not posted yet. Returns
+ *   EB_FALSE when the task was parked on an empty output
+ *   fifo.
+ ******************************************************/
+static EbBool dlf_post_results(DlfContext *context_ptr, EbObjectWrapper *input_wrapper_ptr) {
+    EbObjectWrapper *pcs_wrapper_ptr = ((EncDecResults *)input_wrapper_ptr->object_ptr)
+                                           ->pcs_wrapper_ptr;
+    PictureControlSet * pcs_ptr  = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr  = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbBool              is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common *         cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
+    uint16_t            first_segment;
+
+    link_eb_to_aom_buffer_desc(get_dlf_recon_buffer(pcs_ptr),
+                               cm->frame_to_show,
+                               scs_ptr->max_input_pad_right,
+                               scs_ptr->max_input_pad_bottom,
+                               is_16bit || scs_ptr->static_config.is_16bit_pipeline);
+    if (scs_ptr->seq_header.enable_restoration)
+        svt_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 0);
+
+    const uint16_t end_segment = claim_cdef_segments(pcs_ptr, EB_TRUE, &first_segment);
+    return post_cdef_segments(context_ptr, input_wrapper_ptr, first_segment, end_segment);
+}
+
+/******************************************************
+ * Dlf Sb Row Process
+ *   Posts the CDEF segments of the SB rows EncDec has
+ *   completed so far. The input holds a reference to the
+ *   picture, which may be complete by now, until the
+ *   segments are taken: the picture is not done before
+ *   these are searched.
+ ******************************************************/
+static EbBool dlf_sb_row_process(DlfContext *context_ptr, EbObjectWrapper *input_wrapper_ptr) {
+    EncDecResults *    input_ptr = (EncDecResults *)input_wrapper_ptr->object_ptr;
+    PictureControlSet *pcs_ptr   = (PictureControlSet *)input_ptr->pcs_wrapper_ptr->object_ptr;
+    uint16_t           first_segment;
+
+    const uint16_t end_segment = claim_cdef_segments(pcs_ptr, EB_FALSE, &first_segment);
+    svt_release_object(input_ptr->pcs_wrapper_ptr);
+    return post_cdef_segments(context_ptr, input_wrapper_ptr, first_segment, end_segment);
+}
+
+/******************************************************
+ * Post Dlf Segments
+ *   Feeds the deblocking segments of input_type of the
+ *   picture of the input object back to the DLF
+ *   processes, from first_segment. Returns EB_FALSE
+ *   when the task was parked on an empty output fifo.
+ ******************************************************/
+static EbBool post_dlf_segments(DlfContext *context_ptr, EbObjectWrapper *input_wrapper_ptr,
+                                uint32_t input_type, uint16_t first_segment) {
+    EncDecResults *    input_ptr = (EncDecResults *)input_wrapper_ptr->object_ptr;
+    PictureControlSet *pcs_ptr   = (PictureControlSet *)input_ptr->pcs_wrapper_ptr->object_ptr;
+    const uint16_t     segment_count = input_type == DLF_TASKS_VERT_INPUT
+            ? pcs_ptr->dlf_vert_segments_count
+            : pcs_ptr->dlf_horz_segments_count;
+
+    for (uint16_t segment_index = first_segment; segment_index < segment_count;
+         ++segment_index) {
+        EbObjectWrapper *enc_dec_results_wrapper_ptr;
+        if (!svt_get_output_object(context_ptr->dlf_feedback_fifo_ptr,
+                                   input_wrapper_ptr,
+                                   &enc_dec_results_wrapper_ptr)) {
+            input_ptr->input_type   = input_type == DLF_TASKS_VERT_INPUT ? DLF_TASKS_POST_VERT
+                                                                         : DLF_TASKS_POST_HORZ;
+            input_ptr->posted_count = segment_index;
+            svt_park_full_object(input_wrapper_ptr);
+            return EB_FALSE;
+        }
+        EncDecResults *enc_dec_results_ptr =
+            (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+        enc_dec_results_ptr->pcs_wrapper_ptr = input_ptr->pcs_wrapper_ptr;
+        enc_dec_results_ptr->input_type      = input_type;
+        enc_dec_results_ptr->segment_index   = segment_index;
+        svt_post_full_object(enc_dec_results_wrapper_ptr);
+    }
+    return EB_TRUE;
+}
+
+/******************************************************
+ * Dlf Segment Process
+ *   Filters the vertical edges of a band of SB rows,
+ *   or the horizontal edges of a band of SB columns.
+ *   The last vertical segment of a picture posts its
+ *   horizontal segments, and the last horizontal
+ *   segment hands the picture to CDEF. Returns EB_FALSE
+ *   when the task was parked on an empty output fifo.
+ ******************************************************/
+static EbBool dlf_segment_process(DlfContext *context_ptr, EbObjectWrapper *input_wrapper_ptr) {
+    EncDecResults *    enc_dec_results_ptr = (EncDecResults *)input_wrapper_ptr->object_ptr;
+    PictureControlSet *pcs_ptr =
+        (PictureControlSet *)enc_dec_results_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet * scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbPictureBufferDesc *recon_buffer  = get_dlf_recon_buffer(pcs_ptr);
+    const EbBool         vert          = enc_dec_results_ptr->input_type == DLF_TASKS_VERT_INPUT;
+    const uint16_t       segment_count = vert ? pcs_ptr->dlf_vert_segments_count
+                                              : pcs_ptr->dlf_horz_segments_count;
+    const uint32_t sb_count = ((vert ? pcs_ptr->parent_pcs_ptr->aligned_height
+                                     : pcs_ptr->parent_pcs_ptr->aligned_width) +
+                               scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+    const uint32_t sb_start = enc_dec_results_ptr->segment_index * sb_count / segment_count;
+    const uint32_t sb_end   = (enc_dec_results_ptr->segment_index + 1) * sb_count / segment_count;
+
+    for (uint32_t sb_index = sb_start; sb_index < sb_end; ++sb_index) {
+        if (vert)
+            svt_av1_loop_filter_sb_row_vert(recon_buffer, pcs_ptr, sb_index, 0, 3);
+        else
+            svt_av1_loop_filter_sb_col_horz(recon_buffer, pcs_ptr, sb_index, 0, 3);
+    }
+
+    svt_block_on_mutex(pcs_ptr->dlf_segments_mutex);
+    const EbBool last_segment = ++pcs_ptr->dlf_segments_done_count == segment_count;
+    if (last_segment)
+        pcs_ptr->dlf_segments_done_count = 0;
+    svt_release_mutex(pcs_ptr->dlf_segments_mutex);
+
+    if (!last_segment)
+        return EB_TRUE;
+    if (vert)
+        return post_dlf_segments(context_ptr, input_wrapper_ptr, DLF_TASKS_HORZ_INPUT, 0);
+    return dlf_post_results(context_ptr, input_wrapper_ptr);
+}
+
+/******************************************************
+ * Dlf Process
+ ******************************************************/
+static void dlf_process(DlfContext *context_ptr, EbObjectWrapper *enc_dec_results_wrapper_ptr) {
     PictureControlSet * pcs_ptr;
     SequenceControlSet *scs_ptr;
 
     //// Input
-    EbObjectWrapper *enc_dec_results_wrapper_ptr;
-    EncDecResults *  enc_dec_results_ptr;
-
-    //// Output
-    EbObjectWrapper *  dlf_results_wrapper_ptr;
-    struct DlfResults *dlf_results_ptr;
+    EncDecResults *enc_dec_results_ptr;
 
     // SB Loop variables
-    for (;;) {
-        // Get EncDec Results
-        EB_GET_FULL_OBJECT(context_ptr->dlf_input_fifo_ptr, &enc_dec_results_wrapper_ptr);
-
-        enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
-        pcs_ptr             = (PictureControlSet *)enc_dec_results_ptr->pcs_wrapper_ptr->object_ptr;
-        scs_ptr             = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+    pcs_ptr             = (PictureControlSet *)enc_dec_results_ptr->pcs_wrapper_ptr->object_ptr;
+    scs_ptr             = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+
+    switch (enc_dec_results_ptr->input_type) {
+    case DLF_TASKS_VERT_INPUT:
+    case DLF_TASKS_HORZ_INPUT:
+        if (dlf_segment_process(context_ptr, enc_dec_results_wrapper_ptr))
+            svt_release_object(enc_dec_results_wrapper_ptr);
+        return;
+    case DLF_TASKS_POST_VERT:
+    case DLF_TASKS_POST_HORZ:
+        // Requeued on an empty output fifo, post the remaining segments
+        if (post_dlf_segments(context_ptr,
+                              enc_dec_results_wrapper_ptr,
+                              enc_dec_results_ptr->input_type == DLF_TASKS_POST_VERT
+                                  ? DLF_TASKS_VERT_INPUT
+                                  : DLF_TASKS_HORZ_INPUT,
+                              enc_dec_results_ptr->posted_count))
+            svt_release_object(enc_dec_results_wrapper_ptr);
+        return;
+    case DLF_TASKS_POST_CDEF:
+        if (post_cdef_segments(context_ptr,
+                               enc_dec_results_wrapper_ptr,
+                               enc_dec_results_ptr->posted_count,
+                               enc_dec_results_ptr->segment_index))
+            svt_release_object(enc_dec_results_wrapper_ptr);
+        return;
+    case DLF_TASKS_SB_ROW_INPUT:
+        if (dlf_sb_row_process(context_ptr, enc_dec_results_wrapper_ptr))
+            svt_release_object(enc_dec_results_wrapper_ptr);
+        return;
+    default: break;
+    }
 
-        EbBool is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    if (scs_ptr->static_config.is_16bit_pipeline &&
+        scs_ptr->static_config.encoder_bit_depth == EB_8BIT) {
+        // //copy input from 8bit to 16bit
+        uint8_t *            input_8bit;
+        int32_t              input_stride_8bit;
+        uint16_t *           input_16bit;
+        int32_t              input_stride_16bit;
+        EbPictureBufferDesc *input_buffer_8bit =
+            (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+        EbPictureBufferDesc *input_buffer = (EbPictureBufferDesc *)pcs_ptr->input_frame16bit;
+        // Y
+        input_16bit = (uint16_t *)(input_buffer->buffer_y) + input_buffer->origin_x +
+            input_buffer->origin_y * input_buffer->stride_y;
+        input_stride_16bit = input_buffer->stride_y;
+        input_8bit         = input_buffer_8bit->buffer_y + input_buffer_8bit->origin_x +
+            input_buffer_8bit->origin_y * input_buffer_8bit->stride_y;
+        input_stride_8bit = input_buffer_8bit->stride_y;
+
+        svt_convert_8bit_to_16bit(input_8bit,
+                                  input_stride_8bit,
+                                  input_16bit,
+                                  input_stride_16bit,
+                                  input_buffer->width,
+                                  input_buffer->height);
+
+        // Cb
+        input_16bit = (uint16_t *)(input_buffer->buffer_cb) + input_buffer->origin_x / 2 +
+            input_buffer->origin_y / 2 * input_buffer->stride_cb;
+        input_stride_16bit = input_buffer->stride_cb;
+        input_8bit         = input_buffer_8bit->buffer_cb + input_buffer_8bit->origin_x / 2 +
+            input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cb;
+        input_stride_8bit = input_buffer_8bit->stride_cb;
+
+        svt_convert_8bit_to_16bit(input_8bit,
+                                  input_stride_8bit,
+                                  input_16bit,
+                                  input_stride_16bit,
+                                  input_buffer->width >> 1,
+                                  input_buffer->height >> 1);
+
+        // Cr
+        input_16bit = (uint16_t *)(input_buffer->buffer_cr) + input_buffer->origin_x / 2 +
+            input_buffer->origin_y / 2 * input_buffer->stride_cr;
+        input_stride_16bit = input_buffer->stride_cr;
+        input_8bit         = input_buffer_8bit->buffer_cr + input_buffer_8bit->origin_x / 2 +
+            input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cr;
+        input_stride_8bit = input_buffer_8bit->stride_cr;
+
+        svt_convert_8bit_to_16bit(input_8bit,
+                                  input_stride_8bit,
+                                  input_16bit,
+                                  input_stride_16bit,
+                                  input_buffer->width >> 1,
+                                  input_buffer->height >> 1);
+    }
 
-        if (scs_ptr->static_config.is_16bit_pipeline &&
-            scs_ptr->static_config.encoder_bit_depth == EB_8BIT) {
-            // //copy input from 8bit to 16bit
-            uint8_t *            input_8bit;
-            int32_t              input_stride_8bit;
-            uint16_t *           input_16bit;
-            int32_t              input_stride_16bit;
-            EbPictureBufferDesc *input_buffer_8bit =
-                (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-            EbPictureBufferDesc *input_buffer = (EbPictureBufferDesc *)pcs_ptr->input_frame16bit;
-            // Y
-            input_16bit = (uint16_t *)(input_buffer->buffer_y) + input_buffer->origin_x +
-                input_buffer->origin_y * input_buffer->stride_y;
-            input_stride_16bit = input_buffer->stride_y;
-            input_8bit         = input_buffer_8bit->buffer_y + input_buffer_8bit->origin_x +
-                input_buffer_8bit->origin_y * input_buffer_8bit->stride_y;
-            input_stride_8bit = input_buffer_8bit->stride_y;
-
-            svt_convert_8bit_to_16bit(input_8bit,
-                                      input_stride_8bit,
-                                      input_16bit,
-                                      input_stride_16bit,
-                                      input_buffer->width,
-                                      input_buffer->height);
-
-            // Cb
-            input_16bit = (uint16_t *)(input_buffer->buffer_cb) + input_buffer->origin_x / 2 +
-                input_buffer->origin_y / 2 * input_buffer->stride_cb;
-            input_stride_16bit = input_buffer->stride_cb;
-            input_8bit         = input_buffer_8bit->buffer_cb + input_buffer_8bit->origin_x / 2 +
-                input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cb;
-            input_stride_8bit = input_buffer_8bit->stride_cb;
-
-            svt_convert_8bit_to_16bit(input_8bit,
-                                      input_stride_8bit,
-                                      input_16bit,
-                                      input_stride_16bit,
-                                      input_buffer->width >> 1,
-                                      input_buffer->height >> 1);
-
-            // Cr
-            input_16bit = (uint16_t *)(input_buffer->buffer_cr) + input_buffer->origin_x / 2 +
-                input_buffer->origin_y / 2 * input_buffer->stride_cr;
-            input_stride_16bit = input_buffer->stride_cr;
-            input_8bit         = input_buffer_8bit->buffer_cr + input_buffer_8bit->origin_x / 2 +
-                input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cr;
-            input_stride_8bit = input_buffer_8bit->stride_cr;
-
-            svt_convert_8bit_to_16bit(input_8bit,
-                                      input_stride_8bit,
-                                      input_16bit,
-                                      input_stride_16bit,
-                                      input_buffer->width >> 1,
-                                      input_buffer->height >> 1);
-        }
+    EbBool   dlf_enable_flag = (EbBool)pcs_ptr->parent_pcs_ptr->loop_filter_mode;
+    uint16_t total_tile_cnt  = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_cols *
+        pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_rows;
+    // Jing: Move sb level lf to here if tile_parallel
+    if ((dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode >= 2) ||
+        (dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode == 1 &&
+         total_tile_cnt > 1)) {
+        EbPictureBufferDesc *recon_buffer = get_dlf_recon_buffer(pcs_ptr);
 
-        EbBool   dlf_enable_flag = (EbBool)pcs_ptr->parent_pcs_ptr->loop_filter_mode;
-        uint16_t total_tile_cnt  = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_cols *
-            pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_rows;
-        // Jing: Move sb level lf to here if tile_parallel
-        if ((dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode >= 2) ||
-            (dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode == 1 &&
-             total_tile_cnt > 1)) {
-            EbPictureBufferDesc *recon_buffer;
-
-            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                recon_buffer = (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
-                    ? ((EbReferenceObject *)
-                           pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                          ->reference_picture16bit
-                    : ((EbReferenceObject *)
-                           pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                          ->reference_picture;
-            else
-                recon_buffer = scs_ptr->static_config.is_16bit_pipeline || is_16bit
-                    ? pcs_ptr->recon_picture16bit_ptr
-                    : pcs_ptr->recon_picture_ptr;
-
-            svt_av1_loop_filter_init(pcs_ptr);
-
-            if (pcs_ptr->parent_pcs_ptr->loop_filter_mode == 2) {
-                svt_av1_pick_filter_level(
-                    context_ptr,
-                    (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
-                    pcs_ptr,
-                    LPF_PICK_FROM_Q);
-            }
+        svt_av1_loop_filter_init(pcs_ptr);
 
+        if (pcs_ptr->parent_pcs_ptr->loop_filter_mode == 2) {
             svt_av1_pick_filter_level(
                 context_ptr,
                 (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
                 pcs_ptr,
-                LPF_PICK_FROM_FULL_IMAGE);
+                LPF_PICK_FROM_Q);
+        }
+
+        svt_av1_pick_filter_level(
+            context_ptr,
+            (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+            pcs_ptr,
+            LPF_PICK_FROM_FULL_IMAGE);
 
 #if NO_ENCDEC
-            //NO DLF
-            pcs_ptr->parent_pcs_ptr->lf.filter_level[0] = 0;
-            pcs_ptr->parent_pcs_ptr->lf.filter_level[1] = 0;
-            pcs_ptr->parent_pcs_ptr->lf.filter_level_u  = 0;
-            pcs_ptr->parent_pcs_ptr->lf.filter_level_v  = 0;
+        //NO DLF
+        pcs_ptr->parent_pcs_ptr->lf.filter_level[0] = 0;
+        pcs_ptr->parent_pcs_ptr->lf.filter_level[1] = 0;
+        pcs_ptr->parent_pcs_ptr->lf.filter_level_u  = 0;
+        pcs_ptr->parent_pcs_ptr->lf.filter_level_v  = 0;
 #endif
-            svt_av1_loop_filter_frame(recon_buffer, pcs_ptr, 0, 3);
+        const FrameHeader *frm_hdr         = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+        const uint32_t     pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width +
+                                          scs_ptr->sb_size_pix - 1) /
+            scs_ptr->sb_size_pix;
+        const uint32_t picture_height_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_height +
+                                               scs_ptr->sb_size_pix - 1) /
+            scs_ptr->sb_size_pix;
+        pcs_ptr->dlf_vert_segments_count =
+            (uint16_t)MIN(scs_ptr->dlf_segment_count, picture_height_in_sb);
+        pcs_ptr->dlf_horz_segments_count =
+            (uint16_t)MIN(scs_ptr->dlf_segment_count, pic_width_in_sb);
+        if (frm_hdr->loop_filter_params.combine_vert_horz_lf &&
+            (pcs_ptr->dlf_vert_segments_count > 1 || pcs_ptr->dlf_horz_segments_count > 1)) {
+            // The segments post the CDEF segments once the last one is done
+            svt_av1_loop_filter_frame_init(&pcs_ptr->parent_pcs_ptr->frm_hdr,
+                                           &pcs_ptr->parent_pcs_ptr->lf_info,
+                                           0,
+                                           3);
+            pcs_ptr->dlf_segments_done_count = 0;
+            if (post_dlf_segments(
+                    context_ptr, enc_dec_results_wrapper_ptr, DLF_TASKS_VERT_INPUT, 0))
+                svt_release_object(enc_dec_results_wrapper_ptr);
+            return;
         }
+        svt_av1_loop_filter_frame(recon_buffer, pcs_ptr, 0, 3);
+    }
 
-        //pre-cdef prep
-        {
-            Av1Common *          cm = pcs_ptr->parent_pcs_ptr->av1_cm;
-            EbPictureBufferDesc *recon_picture_ptr;
-            if (is_16bit) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
-                                             ->reference_picture_wrapper_ptr->object_ptr)
-                                            ->reference_picture16bit;
-                else
-                    recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
-            } else {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
-                                             ->reference_picture_wrapper_ptr->object_ptr)
-                                            ->reference_picture;
-                else
-                    recon_picture_ptr = pcs_ptr->recon_picture_ptr;
-            }
-            if (scs_ptr->static_config.is_16bit_pipeline) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
-                    recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
-                                             ->reference_picture_wrapper_ptr->object_ptr)
-                                            ->reference_picture16bit;
-                } else {
-                    recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
-                }
-            }
-            link_eb_to_aom_buffer_desc(recon_picture_ptr,
-                                       cm->frame_to_show,
-                                       scs_ptr->max_input_pad_right,
-                                       scs_ptr->max_input_pad_bottom,
-                                       is_16bit || scs_ptr->static_config.is_16bit_pipeline);
-            if (scs_ptr->seq_header.enable_restoration)
-                svt_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 0);
-            if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
-                if (scs_ptr->static_config.is_16bit_pipeline || is_16bit) {
-                    pcs_ptr->src[0] = (uint16_t *)recon_picture_ptr->buffer_y +
-                        (recon_picture_ptr->origin_x +
-                         recon_picture_ptr->origin_y * recon_picture_ptr->stride_y);
-                    pcs_ptr->src[1] = (uint16_t *)recon_picture_ptr->buffer_cb +
-                        (recon_picture_ptr->origin_x / 2 +
-                         recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cb);
-                    pcs_ptr->src[2] = (uint16_t *)recon_picture_ptr->buffer_cr +
-                        (recon_picture_ptr->origin_x / 2 +
-                         recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cr);
-
-                    EbPictureBufferDesc *input_picture_ptr = pcs_ptr->input_frame16bit;
-                    pcs_ptr->ref_coeff[0] = (uint16_t *)input_picture_ptr->buffer_y +
-                        (input_picture_ptr->origin_x +
-                         input_picture_ptr->origin_y * input_picture_ptr->stride_y);
-                    pcs_ptr->ref_coeff[1] = (uint16_t *)input_picture_ptr->buffer_cb +
-                        (input_picture_ptr->origin_x / 2 +
-                         input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb);
-                    pcs_ptr->ref_coeff[2] = (uint16_t *)input_picture_ptr->buffer_cr +
-                        (input_picture_ptr->origin_x / 2 +
-                         input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr);
-                } else {
-                    EbByte rec_ptr    = &((
-                        recon_picture_ptr
-                            ->buffer_y)[recon_picture_ptr->origin_x +
-                                        recon_picture_ptr->origin_y * recon_picture_ptr->stride_y]);
-                    EbByte rec_ptr_cb = &(
-                        (recon_picture_ptr->buffer_cb)[recon_picture_ptr->origin_x / 2 +
-                                                       recon_picture_ptr->origin_y / 2 *
-                                                           recon_picture_ptr->stride_cb]);
-                    EbByte rec_ptr_cr = &(
-                        (recon_picture_ptr->buffer_cr)[recon_picture_ptr->origin_x / 2 +
-                                                       recon_picture_ptr->origin_y / 2 *
-                                                           recon_picture_ptr->stride_cr]);
-
-                    EbPictureBufferDesc *input_picture_ptr =
-                        (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-                    EbByte enh_ptr    = &((
-                        input_picture_ptr
-                            ->buffer_y)[input_picture_ptr->origin_x +
-                                        input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-                    EbByte enh_ptr_cb = &(
-                        (input_picture_ptr->buffer_cb)[input_picture_ptr->origin_x / 2 +
-                                                       input_picture_ptr->origin_y / 2 *
-                                                           input_picture_ptr->stride_cb]);
-                    EbByte enh_ptr_cr = &(
-                        (input_picture_ptr->buffer_cr)[input_picture_ptr->origin_x / 2 +
-                                                       input_picture_ptr->origin_y / 2 *
-                                                           input_picture_ptr->stride_cr]);
-
-                    pcs_ptr->src[0] = (uint16_t *)rec_ptr;
-                    pcs_ptr->src[1] = (uint16_t *)rec_ptr_cb;
-                    pcs_ptr->src[2] = (uint16_t *)rec_ptr_cr;
-
-                    pcs_ptr->ref_coeff[0] = (uint16_t *)enh_ptr;
-                    pcs_ptr->ref_coeff[1] = (uint16_t *)enh_ptr_cb;
-                    pcs_ptr->ref_coeff[2] = (uint16_t *)enh_ptr_cr;
-                }
-            }
-        }
+    // Release EncDec Results
+    if (dlf_post_results(context_ptr, enc_dec_results_wrapper_ptr))
+        svt_release_object(enc_dec_results_wrapper_ptr);
+}
 
-        pcs_ptr->cdef_segments_column_count = scs_ptr->cdef_segment_column_count;
-        pcs_ptr->cdef_segments_row_count    = scs_ptr->cdef_segment_row_count;
-        pcs_ptr->cdef_segments_total_count  = (uint16_t)(pcs_ptr->cdef_segments_column_count *
-                                                        pcs_ptr->cdef_segments_row_count);
-        pcs_ptr->tot_seg_searched_cdef      = 0;
-        uint32_t segment_index;
-
-        for (segment_index = 0; segment_index < pcs_ptr->cdef_segments_total_count;
-             ++segment_index) {
-            // Get Empty DLF Results to Cdef
-            svt_get_empty_object(context_ptr->dlf_output_fifo_ptr, &dlf_results_wrapper_ptr);
-            dlf_results_ptr = (struct DlfResults *)dlf_results_wrapper_ptr->object_ptr;
-            dlf_results_ptr->pcs_wrapper_ptr = enc_dec_results_ptr->pcs_wrapper_ptr;
-            dlf_results_ptr->segment_index   = segment_index;
-            // Post DLF Results
-            svt_post_full_object(dlf_results_wrapper_ptr);
-        }
+/******************************************************
+ * Dlf Pool Task
+ *   Runs one EncDec Results object on a thread pool worker
+ ******************************************************/
+void dlf_pool_task(void *thread_context_ptr, void *wrapper_ptr) {
+    dlf_process((DlfContext *)((EbThreadContext *)thread_context_ptr)->priv,
+                (EbObjectWrapper *)wrapper_ptr);
+}
 
-        // Release EncDec Results
-        svt_release_object(enc_dec_results_wrapper_ptr);
+/******************************************************
+ * Dlf Kernel
+ ******************************************************/
+void *dlf_kernel(void *input_ptr) {
+    EbThreadContext *thread_context_ptr = (EbThreadContext *)input_ptr;
+    DlfContext *     context_ptr        = (DlfContext *)thread_context_ptr->priv;
+    EbObjectWrapper *enc_dec_results_wrapper_ptr;
+
+    for (;;) {
+        // Get EncDec Results
+        EB_GET_FULL_OBJECT(context_ptr->dlf_input_fifo_ptr, &enc_dec_results_wrapper_ptr);
+        dlf_process(context_ptr, enc_dec_results_wrapper_ptr);
     }
 
     return NULL;
@@ -23,6 +23,7 @@
 typedef struct DlfContext {
     EbFifo *             dlf_input_fifo_ptr;
     EbFifo *             dlf_output_fifo_ptr;
+    EbFifo *             dlf_feedback_fifo_ptr;
     EbPictureBufferDesc *temp_lf_recon_picture_ptr;
     EbPictureBufferDesc *temp_lf_recon_picture16bit_ptr;
 } DlfContext;
@@ -31,8 +32,14 @@ typedef struct DlfContext {
  * Extern Function Declarations
  **************************************/
 extern EbErrorType dlf_context_ctor(EbThreadContext *  thread_context_ptr,
-                                    const EbEncHandle *enc_handle_ptr, int index);
+                                    const EbEncHandle *enc_handle_ptr, int index,
+                                    int feedback_index);
 
 extern void *dlf_kernel(void *input_ptr);
+extern void  dlf_pool_task(void *thread_context_ptr, void *wrapper_ptr);
+
+struct PictureControlSet;
+extern void   svt_dlf_sb_row_init(struct PictureControlSet *pcs_ptr);
+extern EbBool svt_dlf_sb_coded(struct PictureControlSet *pcs_ptr, uint32_t sb_row);
 
 #endif // EbEntropyCodingProcess_h
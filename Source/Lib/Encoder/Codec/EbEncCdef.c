@@ -17,6 +17,7 @@
 #include <stdint.h>
 #include "aom_dsp_rtcd.h"
 #include "EbLog.h"
+#include "EbArena.h"
 
 extern int16_t svt_av1_ac_quant_q3(int32_t qindex, int32_t delta, AomBitDepth bit_depth);
 
@@ -289,10 +290,8 @@ int32_t svt_sb_compute_cdef_list(PictureControlSet *pcs_ptr, const Av1Common *co
     return count;
 }
 
-void svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
-                        PictureControlSet *pCs) {
-    (void)context_ptr;
-
+void svt_av1_cdef_frame(EbArena *arena_ptr, SequenceControlSet *scs_ptr,
+                        PictureControlSet *pCs, CdefRowDoneFunc row_done, void *row_done_priv) {
     struct PictureParentControlSet *ppcs    = pCs->parent_pcs_ptr;
     Av1Common *                     cm      = ppcs->av1_cm;
     FrameHeader *                   frm_hdr = &ppcs->frm_hdr;
@@ -333,7 +332,7 @@ void svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
     const int32_t nvfb  = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
     const int32_t nhfb  = (cm->mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
     //svt_av1_setup_dst_planes(xd->plane, cm->seq_params.sb_size, frame, 0, 0, 0, num_planes);
-    row_cdef = (uint8_t *)svt_aom_malloc(sizeof(*row_cdef) * (nhfb + 2) * 2);
+    row_cdef = (uint8_t *)svt_arena_alloc(arena_ptr, sizeof(*row_cdef) * (nhfb + 2) * 2);
     assert(row_cdef != NULL);
     memset(row_cdef, 1, sizeof(*row_cdef) * (nhfb + 2) * 2);
     prev_row_cdef = row_cdef + 1;
@@ -350,8 +349,10 @@ void svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
 
     const int32_t stride = (cm->mi_cols << MI_SIZE_LOG2) + 2 * CDEF_HBORDER;
     for (int32_t pli = 0; pli < num_planes; pli++) {
-        linebuf[pli] = (uint16_t *)svt_aom_malloc(sizeof(*linebuf) * CDEF_VBORDER * stride);
-        colbuf[pli]  = (uint16_t *)svt_aom_malloc(
+        linebuf[pli] = (uint16_t *)svt_arena_alloc(arena_ptr,
+                                                    sizeof(*linebuf) * CDEF_VBORDER * stride);
+        colbuf[pli]  = (uint16_t *)svt_arena_alloc(
+            arena_ptr,
             sizeof(*colbuf) * ((CDEF_BLOCKSIZE << mi_high_l2[pli]) + 2 * CDEF_VBORDER) *
             CDEF_HBORDER);
     }
@@ -652,17 +653,13 @@ void svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
             prev_row_cdef = curr_row_cdef;
             curr_row_cdef = tmp;
         }
-    }
-    svt_aom_free(row_cdef);
-    for (int32_t pli = 0; pli < num_planes; pli++) {
-        svt_aom_free(linebuf[pli]);
-        svt_aom_free(colbuf[pli]);
+        if (row_done)
+            row_done(fbr, row_done_priv);
     }
 }
 
-void av1_cdef_frame16bit(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
-                         PictureControlSet *pCs) {
-    (void)context_ptr;
+void av1_cdef_frame16bit(EbArena *arena_ptr, SequenceControlSet *scs_ptr,
+                         PictureControlSet *pCs, CdefRowDoneFunc row_done, void *row_done_priv) {
     struct PictureParentControlSet *ppcs    = pCs->parent_pcs_ptr;
     Av1Common *                     cm      = ppcs->av1_cm;
     FrameHeader *                   frm_hdr = &ppcs->frm_hdr;
@@ -702,7 +699,7 @@ void av1_cdef_frame16bit(EncDecContext *context_ptr, SequenceControlSet *scs_ptr
     int32_t coeff_shift = AOMMAX(scs_ptr->static_config.encoder_bit_depth /*cm->bit_depth*/ - 8, 0);
     const int32_t nvfb  = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
     const int32_t nhfb  = (cm->mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
-    row_cdef            = (uint8_t *)svt_aom_malloc(sizeof(*row_cdef) * (nhfb + 2) * 2);
+    row_cdef = (uint8_t *)svt_arena_alloc(arena_ptr, sizeof(*row_cdef) * (nhfb + 2) * 2);
     assert(row_cdef);
     memset(row_cdef, 1, sizeof(*row_cdef) * (nhfb + 2) * 2);
     prev_row_cdef = row_cdef + 1;
@@ -719,8 +716,10 @@ void av1_cdef_frame16bit(EncDecContext *context_ptr, SequenceControlSet *scs_ptr
 
     const int32_t stride = (cm->mi_cols << MI_SIZE_LOG2) + 2 * CDEF_HBORDER;
     for (int32_t pli = 0; pli < num_planes; pli++) {
-        linebuf[pli] = (uint16_t *)svt_aom_malloc(sizeof(*linebuf) * CDEF_VBORDER * stride);
-        colbuf[pli]  = (uint16_t *)svt_aom_malloc(
+        linebuf[pli] = (uint16_t *)svt_arena_alloc(arena_ptr,
+                                                    sizeof(*linebuf) * CDEF_VBORDER * stride);
+        colbuf[pli]  = (uint16_t *)svt_arena_alloc(
+            arena_ptr,
             sizeof(*colbuf) * ((CDEF_BLOCKSIZE << mi_high_l2[pli]) + 2 * CDEF_VBORDER) *
             CDEF_HBORDER);
     }
@@ -1018,11 +1017,8 @@ void av1_cdef_frame16bit(EncDecContext *context_ptr, SequenceControlSet *scs_ptr
             prev_row_cdef = curr_row_cdef;
             curr_row_cdef = tmp;
         }
-    }
-    svt_aom_free(row_cdef);
-    for (int32_t pli = 0; pli < num_planes; pli++) {
-        svt_aom_free(linebuf[pli]);
-        svt_aom_free(colbuf[pli]);
+        if (row_done)
+            row_done(fbr, row_done_priv);
     }
 }
 
@@ -1164,9 +1160,8 @@ static uint64_t joint_strength_search_dual(int32_t *best_lev0, int32_t *best_lev
 #define STORE_CDEF_FILTER_STRENGTH(cdef_strength, pick_method, strength_idx)                \
     get_cdef_filter_strengths((pick_method), &pri_strength, &sec_strength, (strength_idx)); \
     cdef_strength = pri_strength * CDEF_SEC_STRENGTHS + sec_strength;
-void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
+void finish_cdef_search(EbArena *arena_ptr, PictureControlSet *pcs_ptr,
                         int32_t selected_strength_cnt[64]) {
-    (void)context_ptr;
     struct PictureParentControlSet *ppcs    = pcs_ptr->parent_pcs_ptr;
     FrameHeader *                   frm_hdr = &ppcs->frm_hdr;
     Av1Common *                     cm      = ppcs->av1_cm;
@@ -1181,8 +1176,10 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
     int32_t          sb_count;
     int32_t          nvfb              = (mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
     int32_t          nhfb              = (mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
-    int32_t *        sb_index          = (int32_t *)malloc(nvfb * nhfb * sizeof(*sb_index));
-    int32_t *        selected_strength = (int32_t *)malloc(nvfb * nhfb * sizeof(*sb_index));
+    int32_t *sb_index =
+        (int32_t *)svt_arena_alloc(arena_ptr, nvfb * nhfb * sizeof(*sb_index));
+    int32_t *selected_strength =
+        (int32_t *)svt_arena_alloc(arena_ptr, nvfb * nhfb * sizeof(*sb_index));
     int32_t          start_gi;
     int32_t          end_gi;
     CDEF_PICK_METHOD pick_method = pcs_ptr->parent_pcs_ptr->cdef_level == 2 ? CDEF_FAST_SEARCH_LVL1
@@ -1215,8 +1212,8 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
         EB_FALSE);
     lambda = full_lambda;
 
-    mse[0] = (uint64_t(*)[64])malloc(sizeof(**mse) * nvfb * nhfb);
-    mse[1] = (uint64_t(*)[64])malloc(sizeof(**mse) * nvfb * nhfb);
+    mse[0] = (uint64_t(*)[64])svt_arena_alloc(arena_ptr, sizeof(**mse) * nvfb * nhfb);
+    mse[1] = (uint64_t(*)[64])svt_arena_alloc(arena_ptr, sizeof(**mse) * nvfb * nhfb);
 
     sb_count = 0;
     for (fbr = 0; fbr < nvfb; ++fbr) {
@@ -1334,8 +1331,4 @@ void finish_cdef_search(EncDecContext *context_ptr, PictureControlSet *pcs_ptr,
     }
     //cdef_pri_damping & cdef_sec_damping consolidated to cdef_damping
     frm_hdr->cdef_params.cdef_damping = pri_damping;
-    free(mse[0]);
-    free(mse[1]);
-    free(sb_index);
-    free(selected_strength);
 }
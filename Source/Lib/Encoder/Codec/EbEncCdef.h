@@ -23,6 +23,10 @@ typedef void (*CdefFilterBlockFunc)(uint8_t *dst8, uint16_t *dst16, int32_t dstr
                                        int32_t sec_strength, int32_t dir, int32_t pri_damping,
                                        int32_t sec_damping, int32_t bsize, int32_t coeff_shift);
 
+// Called by the CDEF application once the 64x64 filter block row fbr is
+// filtered, its rows of the recon are final then
+typedef void (*CdefRowDoneFunc)(int32_t fbr, void *priv);
+
 void copy_cdef_16bit_to_16bit(uint16_t *dst, int32_t dstride, uint16_t *src, CdefList *dlist,
                               int32_t cdef_count, int32_t bsize);
 
@@ -25,6 +25,7 @@
 #include "EbPictureDecisionProcess.h"
 #include "firstpass.h"
 #include "EbPictureAnalysisProcess.h"
+#include "EbDlfProcess.h"
 
 #define FC_SKIP_TX_SR_TH025 125 // Fast cost skip tx search threshold.
 #define FC_SKIP_TX_SR_TH010 110 // Fast cost skip tx search threshold.
@@ -280,9 +281,21 @@ static void reset_enc_dec(EncDecContext *context_ptr, PictureControlSet *pcs_ptr
  *   should NOT be locked for the entire processing
  *   of the segment-row (b) as this would block other
  *   threads from performing an update (A).
+ *
+ * When every segment is a single SB, the segment-rows
+ *   are scheduled as a wavefront from their progress
+ *   counters (enc_dec_segments_wpp_update) instead of
+ *   the dependency map.
+ *
+ * A pool task does not wait for an empty task to feed
+ *   a segment-row back: it links the row to the list
+ *   at *deferredRowPtr and processes the rows of the
+ *   list once its own segments run out.
  ******************************************************/
 EbBool assign_enc_dec_segments(EncDecSegments *segmentPtr, uint16_t *segmentInOutIndex,
-                               EncDecTasks *taskPtr, EbFifo *srmFifoPtr) {
+                               EbObjectWrapper *taskWrapperPtr, EbFifo *srmFifoPtr,
+                               int16_t *deferredRowPtr) {
+    EncDecTasks *    taskPtr                  = (EncDecTasks *)taskWrapperPtr->object_ptr;
     EbBool           continue_processing_flag = EB_FALSE;
     uint32_t row_segment_index = 0;
     uint32_t segment_index;
@@ -309,6 +322,8 @@ EbBool assign_enc_dec_segments(EncDecSegments *segmentPtr, uint16_t *segmentInOu
             segmentPtr->row_array[row_index].current_seg_index =
                 segmentPtr->row_array[row_index].starting_seg_index;
         }
+        if (segmentPtr->wpp)
+            enc_dec_segments_wpp_reset(segmentPtr);
 
         // Start on Segment 0 immediately
         *segmentInOutIndex  = segmentPtr->row_array[0].current_seg_index;
@@ -341,67 +356,95 @@ EbBool assign_enc_dec_segments(EncDecSegments *segmentPtr, uint16_t *segmentInOu
 
     case ENCDEC_TASKS_CONTINUE:
 
-        // Update the Dependency List for Right and Bottom Neighbors
-        segment_index     = *segmentInOutIndex;
-        row_segment_index = segment_index / segmentPtr->segment_band_count;
-
-        right_segment_index       = segment_index + 1;
-        bottom_left_segment_index = segment_index + segmentPtr->segment_band_count;
-
-        // Right Neighbor
-        if (segment_index < segmentPtr->row_array[row_segment_index].ending_seg_index) {
-            svt_block_on_mutex(segmentPtr->row_array[row_segment_index].assignment_mutex);
-
-            --segmentPtr->dep_map.dependency_map[right_segment_index];
-
-            if (segmentPtr->dep_map.dependency_map[right_segment_index] == 0) {
-                *segmentInOutIndex = segmentPtr->row_array[row_segment_index].current_seg_index;
-                ++segmentPtr->row_array[row_segment_index].current_seg_index;
-                self_assigned            = EB_TRUE;
+        if (segmentPtr->wpp) {
+            // One SB per segment, go on with the row, or with the row below
+            uint16_t ready_row_array[2];
+            uint32_t ready_count = enc_dec_segments_wpp_update(
+                segmentPtr, *segmentInOutIndex, ready_row_array);
+            if (ready_count > 0) {
+                *segmentInOutIndex =
+                    segmentPtr->row_array[ready_row_array[0]].current_seg_index;
+                ++segmentPtr->row_array[ready_row_array[0]].current_seg_index;
                 continue_processing_flag = EB_TRUE;
-
-                //fprintf(trace, "Start  Pic: %u Seg: %u\n",
-                //    (unsigned) ((PictureControlSet*) taskPtr->pcs_wrapper_ptr->object_ptr)->picture_number,
-                //    *segmentInOutIndex);
             }
+            if (ready_count > 1)
+                feedback_row_index = (int16_t)ready_row_array[1];
+        } else {
+            // Update the Dependency List for Right and Bottom Neighbors
+            segment_index     = *segmentInOutIndex;
+            row_segment_index = segment_index / segmentPtr->segment_band_count;
 
-            svt_release_mutex(segmentPtr->row_array[row_segment_index].assignment_mutex);
-        }
+            right_segment_index       = segment_index + 1;
+            bottom_left_segment_index = segment_index + segmentPtr->segment_band_count;
 
-        // Bottom-left Neighbor
-        if (row_segment_index < segmentPtr->segment_row_count - 1 &&
-            bottom_left_segment_index >=
-                segmentPtr->row_array[row_segment_index + 1].starting_seg_index) {
-            svt_block_on_mutex(segmentPtr->row_array[row_segment_index + 1].assignment_mutex);
+            // Right Neighbor
+            if (segment_index < segmentPtr->row_array[row_segment_index].ending_seg_index) {
+                svt_block_on_mutex(segmentPtr->row_array[row_segment_index].assignment_mutex);
 
-            --segmentPtr->dep_map.dependency_map[bottom_left_segment_index];
+                --segmentPtr->dep_map.dependency_map[right_segment_index];
 
-            if (segmentPtr->dep_map.dependency_map[bottom_left_segment_index] == 0) {
-                if (self_assigned == EB_TRUE)
-                    feedback_row_index = (int16_t)row_segment_index + 1;
-                else {
-                    *segmentInOutIndex =
-                        segmentPtr->row_array[row_segment_index + 1].current_seg_index;
-                    ++segmentPtr->row_array[row_segment_index + 1].current_seg_index;
+                if (segmentPtr->dep_map.dependency_map[right_segment_index] == 0) {
+                    *segmentInOutIndex = segmentPtr->row_array[row_segment_index].current_seg_index;
+                    ++segmentPtr->row_array[row_segment_index].current_seg_index;
+                    self_assigned            = EB_TRUE;
                     continue_processing_flag = EB_TRUE;
 
                     //fprintf(trace, "Start  Pic: %u Seg: %u\n",
                     //    (unsigned) ((PictureControlSet*) taskPtr->pcs_wrapper_ptr->object_ptr)->picture_number,
                     //    *segmentInOutIndex);
                 }
+
+                svt_release_mutex(segmentPtr->row_array[row_segment_index].assignment_mutex);
+            }
+
+            // Bottom-left Neighbor
+            if (row_segment_index < segmentPtr->segment_row_count - 1 &&
+                bottom_left_segment_index >=
+                    segmentPtr->row_array[row_segment_index + 1].starting_seg_index) {
+                svt_block_on_mutex(segmentPtr->row_array[row_segment_index + 1].assignment_mutex);
+
+                --segmentPtr->dep_map.dependency_map[bottom_left_segment_index];
+
+                if (segmentPtr->dep_map.dependency_map[bottom_left_segment_index] == 0) {
+                    if (self_assigned == EB_TRUE)
+                        feedback_row_index = (int16_t)row_segment_index + 1;
+                    else {
+                        *segmentInOutIndex =
+                            segmentPtr->row_array[row_segment_index + 1].current_seg_index;
+                        ++segmentPtr->row_array[row_segment_index + 1].current_seg_index;
+                        continue_processing_flag = EB_TRUE;
+
+                        //fprintf(trace, "Start  Pic: %u Seg: %u\n",
+                        //    (unsigned) ((PictureControlSet*) taskPtr->pcs_wrapper_ptr->object_ptr)->picture_number,
+                        //    *segmentInOutIndex);
+                    }
+                }
+                svt_release_mutex(segmentPtr->row_array[row_segment_index + 1].assignment_mutex);
             }
-            svt_release_mutex(segmentPtr->row_array[row_segment_index + 1].assignment_mutex);
         }
 
         if (feedback_row_index > 0) {
             EbObjectWrapper *wrapper_ptr;
-            svt_get_empty_object(srmFifoPtr, &wrapper_ptr);
-            EncDecTasks *    feedback_task_ptr     = (EncDecTasks *)wrapper_ptr->object_ptr;
-            feedback_task_ptr->input_type          = ENCDEC_TASKS_ENCDEC_INPUT;
-            feedback_task_ptr->enc_dec_segment_row = feedback_row_index;
-            feedback_task_ptr->pcs_wrapper_ptr     = taskPtr->pcs_wrapper_ptr;
-            feedback_task_ptr->tile_group_index = taskPtr->tile_group_index;
-            svt_post_full_object(wrapper_ptr);
+            if (svt_get_output_object(srmFifoPtr, taskWrapperPtr, &wrapper_ptr)) {
+                EncDecTasks *feedback_task_ptr         = (EncDecTasks *)wrapper_ptr->object_ptr;
+                feedback_task_ptr->input_type          = ENCDEC_TASKS_ENCDEC_INPUT;
+                feedback_task_ptr->enc_dec_segment_row = feedback_row_index;
+                feedback_task_ptr->pcs_wrapper_ptr     = taskPtr->pcs_wrapper_ptr;
+                feedback_task_ptr->tile_group_index    = taskPtr->tile_group_index;
+                svt_post_full_object(wrapper_ptr);
+            } else {
+                segmentPtr->row_array[feedback_row_index].next_deferred_row = *deferredRowPtr;
+                *deferredRowPtr = feedback_row_index;
+            }
+        }
+
+        // Start on a deferred row once the own segments run out
+        if (continue_processing_flag == EB_FALSE && *deferredRowPtr >= 0) {
+            const int16_t row_index = *deferredRowPtr;
+            *deferredRowPtr         = segmentPtr->row_array[row_index].next_deferred_row;
+            *segmentInOutIndex      = segmentPtr->row_array[row_index].current_seg_index;
+            ++segmentPtr->row_array[row_index].current_seg_index;
+            continue_processing_flag = EB_TRUE;
         }
 
         break;
@@ -411,7 +454,15 @@ EbBool assign_enc_dec_segments(EncDecSegments *segmentPtr, uint16_t *segmentInOu
 
     return continue_processing_flag;
 }
-void recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
+/******************************************************
+ * Recon Output
+ *   Copies the recon of the picture to an output recon
+ *   buffer of the application. Returns EB_FALSE when
+ *   the stage consuming input_wrapper_ptr runs as pool
+ *   tasks and the application holds every buffer.
+ ******************************************************/
+EbBool recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
+                    EbObjectWrapper *input_wrapper_ptr) {
     EncodeContext *     encode_context_ptr = scs_ptr->encode_context_ptr;
     // The totalNumberOfReconFrames counter has to be write/read protected as
     //   it is used to determine the end of the stream.  If it is not protected
@@ -422,8 +473,12 @@ void recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
         EbBool           is_16bit = (scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
         EbObjectWrapper *output_recon_wrapper_ptr;
         // Get Recon Buffer
-        svt_get_empty_object(scs_ptr->encode_context_ptr->recon_output_fifo_ptr,
-                             &output_recon_wrapper_ptr);
+        if (!svt_get_output_object(scs_ptr->encode_context_ptr->recon_output_fifo_ptr,
+                                   input_wrapper_ptr,
+                                   &output_recon_wrapper_ptr)) {
+            svt_release_mutex(encode_context_ptr->total_number_of_recon_frame_mutex);
+            return EB_FALSE;
+        }
         EbBufferHeaderType *output_recon_ptr = (EbBufferHeaderType *)output_recon_wrapper_ptr->object_ptr;
         output_recon_ptr->flags = 0;
 
@@ -572,6 +627,7 @@ void recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
         encode_context_ptr->total_number_of_recon_frames++;
     }
     svt_release_mutex(encode_context_ptr->total_number_of_recon_frame_mutex);
+    return EB_TRUE;
 }
 
 //************************************/
@@ -4311,17 +4367,106 @@ static void init_avail_blk_flag(SequenceControlSet *scs_ptr, ModeDecisionContext
 *  elements to be sent to the entropy coding engine
 *
 ********************************************************************************/
-void *mode_decision_kernel(void *input_ptr) {
-    // Context & SCS & PCS
-    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
-    EncDecContext *     context_ptr        = (EncDecContext *)thread_context_ptr->priv;
-
-    // Input
-    EbObjectWrapper *enc_dec_tasks_wrapper_ptr;
+/******************************************************
+ * Post EncDec Results
+ *   Hands the completed picture of the input task to
+ *   DLF. Returns EB_FALSE when the task was parked on
+ *   an empty output fifo.
+ ******************************************************/
+static EbBool post_enc_dec_results(EncDecContext *  context_ptr,
+                                   EbObjectWrapper *enc_dec_tasks_wrapper_ptr) {
+    EncDecTasks *       enc_dec_tasks_ptr = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
+    PictureControlSet * pcs_ptr = (PictureControlSet *)enc_dec_tasks_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbObjectWrapper *   enc_dec_results_wrapper_ptr;
+    EncDecResults *     enc_dec_results_ptr;
+
+    // Get Empty EncDec Results
+    if (!svt_get_output_object(context_ptr->enc_dec_output_fifo_ptr,
+                               enc_dec_tasks_wrapper_ptr,
+                               &enc_dec_results_wrapper_ptr)) {
+        enc_dec_tasks_ptr->input_type = ENCDEC_TASKS_POST_RESULTS;
+        svt_park_full_object(enc_dec_tasks_wrapper_ptr);
+        return EB_FALSE;
+    }
+    enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+    enc_dec_results_ptr->pcs_wrapper_ptr = enc_dec_tasks_ptr->pcs_wrapper_ptr;
+    enc_dec_results_ptr->input_type      = DLF_TASKS_ENCDEC_INPUT;
+    //CHKN these are not needed for DLF
+    enc_dec_results_ptr->completed_sb_row_index_start = 0;
+    enc_dec_results_ptr->completed_sb_row_count =
+        (pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+    // Post EncDec Results
+    svt_post_full_object(enc_dec_results_wrapper_ptr);
+    return EB_TRUE;
+}
 
-    // Output
+/******************************************************
+ * Post EncDec Sb Rows
+ *   Hands the SB rows of the picture completed so far to
+ *   DLF, which posts their CDEF segments. Nothing is
+ *   posted when no output object is free at once, the
+ *   segments then go with later rows or with the
+ *   completed picture.
+ ******************************************************/
+static void post_enc_dec_sb_rows(EncDecContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr) {
     EbObjectWrapper *enc_dec_results_wrapper_ptr;
     EncDecResults *  enc_dec_results_ptr;
+
+    svt_get_empty_object_non_blocking(context_ptr->enc_dec_output_fifo_ptr,
+                                      &enc_dec_results_wrapper_ptr);
+    if (enc_dec_results_wrapper_ptr == NULL)
+        return;
+    // Released by DLF once it has taken the segments of the rows
+    svt_object_inc_live_count(pcs_wrapper_ptr, 1);
+    enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+    enc_dec_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+    enc_dec_results_ptr->input_type      = DLF_TASKS_SB_ROW_INPUT;
+    svt_post_full_object(enc_dec_results_wrapper_ptr);
+}
+
+/******************************************************
+ * Post Re-Encode Tasks
+ *   Feeds the tile groups of the picture of the input
+ *   task back to EncDec for a re-encode, from
+ *   first_tile_group. Returns EB_FALSE when the task
+ *   was parked on an empty output fifo.
+ ******************************************************/
+static EbBool post_re_encode_tasks(EncDecContext *  context_ptr,
+                                   EbObjectWrapper *enc_dec_tasks_wrapper_ptr,
+                                   uint16_t         first_tile_group) {
+    EncDecTasks *      enc_dec_tasks_ptr = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
+    PictureControlSet *pcs_ptr = (PictureControlSet *)enc_dec_tasks_ptr->pcs_wrapper_ptr->object_ptr;
+    uint16_t           tg_count =
+        pcs_ptr->parent_pcs_ptr->tile_group_cols * pcs_ptr->parent_pcs_ptr->tile_group_rows;
+
+    for (uint16_t tile_group_idx = first_tile_group; tile_group_idx < tg_count;
+         tile_group_idx++) {
+        EbObjectWrapper *enc_dec_re_encode_tasks_wrapper_ptr;
+        if (!svt_get_output_object(context_ptr->enc_dec_feedback_fifo_ptr,
+                                   enc_dec_tasks_wrapper_ptr,
+                                   &enc_dec_re_encode_tasks_wrapper_ptr)) {
+            enc_dec_tasks_ptr->input_type   = ENCDEC_TASKS_POST_RE_ENCODE;
+            enc_dec_tasks_ptr->posted_count = tile_group_idx;
+            svt_park_full_object(enc_dec_tasks_wrapper_ptr);
+            return EB_FALSE;
+        }
+
+        EncDecTasks *enc_dec_re_encode_tasks_ptr =
+            (EncDecTasks *)enc_dec_re_encode_tasks_wrapper_ptr->object_ptr;
+        enc_dec_re_encode_tasks_ptr->pcs_wrapper_ptr  = enc_dec_tasks_ptr->pcs_wrapper_ptr;
+        enc_dec_re_encode_tasks_ptr->input_type       = ENCDEC_TASKS_MDC_INPUT;
+        enc_dec_re_encode_tasks_ptr->tile_group_index = tile_group_idx;
+
+        // Post the Full Results Object
+        svt_post_full_object(enc_dec_re_encode_tasks_wrapper_ptr);
+    }
+    return EB_TRUE;
+}
+
+static void enc_dec_process(EncDecContext *  context_ptr,
+                            EbObjectWrapper *enc_dec_tasks_wrapper_ptr) {
     // SB Loop variables
     SuperBlock *sb_ptr;
     uint16_t    sb_index;
@@ -4345,223 +4490,270 @@ void *mode_decision_kernel(void *input_ptr) {
 
     segment_index = 0;
 
-    for (;;) {
-        // Get Mode Decision Results
-        EB_GET_FULL_OBJECT(context_ptr->mode_decision_input_fifo_ptr, &enc_dec_tasks_wrapper_ptr);
-
-        EncDecTasks *    enc_dec_tasks_ptr    = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
-        PictureControlSet * pcs_ptr           = (PictureControlSet *)enc_dec_tasks_ptr->pcs_wrapper_ptr->object_ptr;
-        SequenceControlSet *scs_ptr           = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-        context_ptr->tile_group_index = enc_dec_tasks_ptr->tile_group_index;
-        context_ptr->coded_sb_count   = 0;
-        segments_ptr = pcs_ptr->enc_dec_segment_ctrl[context_ptr->tile_group_index];
-        // SB Constants
-        uint8_t sb_sz      = (uint8_t)scs_ptr->sb_size_pix;
-        uint8_t sb_size_log2 = (uint8_t)svt_log2f(sb_sz);
-        context_ptr->sb_sz = sb_sz;
-        uint32_t pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width + sb_sz - 1) >>
-            sb_size_log2;
-        uint16_t tile_group_width_in_sb = pcs_ptr->parent_pcs_ptr
-                                              ->tile_group_info[context_ptr->tile_group_index]
-                                              .tile_group_width_in_sb;
-        context_ptr->tot_intra_coded_area       = 0;
-        // Bypass encdec for the first pass
-        if (use_output_stat(scs_ptr)) {
-
-            svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
-            pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
-            // Get Empty EncDec Results
-            svt_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
-            enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
-            enc_dec_results_ptr->pcs_wrapper_ptr = enc_dec_tasks_ptr->pcs_wrapper_ptr;
-            enc_dec_results_ptr->completed_sb_row_index_start = 0;
-            enc_dec_results_ptr->completed_sb_row_count =
-                ((pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) >> sb_size_log2);
-            // Post EncDec Results
-            svt_post_full_object(enc_dec_results_wrapper_ptr);
-        }
-        else{
-        memset(context_ptr->md_context->part_cnt, 0, sizeof(uint32_t) * SSEG_NUM * (NUMBER_OF_SHAPES-1) * FB_NUM);
-        generate_nsq_prob(pcs_ptr, context_ptr->md_context);
-        memset(context_ptr->md_context->pred_depth_count, 0, sizeof(uint32_t) * DEPTH_DELTA_NUM * (NUMBER_OF_SHAPES-1));
-        generate_depth_prob(pcs_ptr, context_ptr->md_context);
-        memset( context_ptr->md_context->txt_cnt, 0, sizeof(uint32_t) * TXT_DEPTH_DELTA_NUM * TX_TYPES);
-        generate_txt_prob(pcs_ptr, context_ptr->md_context);
-
-        if (!pcs_ptr->cdf_ctrl.update_mv)
-            copy_mv_rate(pcs_ptr, &context_ptr->md_context->rate_est_table);
-        if (!pcs_ptr->cdf_ctrl.update_se)
-            av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
-                pcs_ptr->slice_type == I_SLICE ? EB_TRUE : EB_FALSE,
-                &pcs_ptr->md_frame_context);
-        if (!pcs_ptr->cdf_ctrl.update_coef)
-            av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
-                &pcs_ptr->md_frame_context);
-        // Segment-loop
-        while (assign_enc_dec_segments(segments_ptr,
-                                       &segment_index,
-                                       enc_dec_tasks_ptr,
-                                       context_ptr->enc_dec_feedback_fifo_ptr) == EB_TRUE) {
-            x_sb_start_index = segments_ptr->x_start_array[segment_index];
-            y_sb_start_index = segments_ptr->y_start_array[segment_index];
-            sb_start_index = y_sb_start_index * tile_group_width_in_sb + x_sb_start_index;
-            sb_segment_count = segments_ptr->valid_sb_count_array[segment_index];
-
-            segment_row_index = segment_index / segments_ptr->segment_band_count;
-            segment_band_index =
-                segment_index - segment_row_index * segments_ptr->segment_band_count;
-            segment_band_size = (segments_ptr->sb_band_count * (segment_band_index + 1) +
-                                 segments_ptr->segment_band_count - 1) /
-                                segments_ptr->segment_band_count;
-
-            // Reset Coding Loop State
-            reset_mode_decision(scs_ptr,
-                                context_ptr->md_context,
-                                pcs_ptr,
-                                context_ptr->tile_group_index,
-                                segment_index);
-
-            // Reset EncDec Coding State
-            reset_enc_dec( // HT done
-                context_ptr,
-                pcs_ptr,
-                scs_ptr,
-                segment_index);
-
-            if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
-                ((EbReferenceObject *)
-                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                    ->average_intensity = pcs_ptr->parent_pcs_ptr->average_intensity[0];
-            for (y_sb_index = y_sb_start_index, sb_segment_index = sb_start_index;
+    EncDecTasks *    enc_dec_tasks_ptr    = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
+    // Requeued on an empty output fifo, post the remaining outputs
+    if (enc_dec_tasks_ptr->input_type == ENCDEC_TASKS_POST_RESULTS) {
+        if (post_enc_dec_results(context_ptr, enc_dec_tasks_wrapper_ptr))
+            svt_release_object(enc_dec_tasks_wrapper_ptr);
+        return;
+    }
+    if (enc_dec_tasks_ptr->input_type == ENCDEC_TASKS_POST_RE_ENCODE) {
+        if (post_re_encode_tasks(
+                context_ptr, enc_dec_tasks_wrapper_ptr, enc_dec_tasks_ptr->posted_count))
+            svt_release_object(enc_dec_tasks_wrapper_ptr);
+        return;
+    }
+    EbBool posted = EB_TRUE;
+    int16_t deferred_row = -1;
+    PictureControlSet * pcs_ptr           = (PictureControlSet *)enc_dec_tasks_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr           = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    context_ptr->tile_group_index = enc_dec_tasks_ptr->tile_group_index;
+    context_ptr->coded_sb_count   = 0;
+    segments_ptr = pcs_ptr->enc_dec_segment_ctrl[context_ptr->tile_group_index];
+    // SB Constants
+    uint8_t sb_sz      = (uint8_t)scs_ptr->sb_size_pix;
+    uint8_t sb_size_log2 = (uint8_t)svt_log2f(sb_sz);
+    context_ptr->sb_sz = sb_sz;
+    uint32_t pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width + sb_sz - 1) >>
+        sb_size_log2;
+    uint16_t tile_group_width_in_sb = pcs_ptr->parent_pcs_ptr
+                                          ->tile_group_info[context_ptr->tile_group_index]
+                                          .tile_group_width_in_sb;
+    context_ptr->tot_intra_coded_area       = 0;
+    // Bypass encdec for the first pass
+    if (use_output_stat(scs_ptr)) {
+
+        svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
+        pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
+        posted = post_enc_dec_results(context_ptr, enc_dec_tasks_wrapper_ptr);
+    }
+    else{
+    memset(context_ptr->md_context->part_cnt, 0, sizeof(uint32_t) * SSEG_NUM * (NUMBER_OF_SHAPES-1) * FB_NUM);
+    generate_nsq_prob(pcs_ptr, context_ptr->md_context);
+    memset(context_ptr->md_context->pred_depth_count, 0, sizeof(uint32_t) * DEPTH_DELTA_NUM * (NUMBER_OF_SHAPES-1));
+    generate_depth_prob(pcs_ptr, context_ptr->md_context);
+    memset( context_ptr->md_context->txt_cnt, 0, sizeof(uint32_t) * TXT_DEPTH_DELTA_NUM * TX_TYPES);
+    generate_txt_prob(pcs_ptr, context_ptr->md_context);
+
+    if (!pcs_ptr->cdf_ctrl.update_mv)
+        copy_mv_rate(pcs_ptr, &context_ptr->md_context->rate_est_table);
+    if (!pcs_ptr->cdf_ctrl.update_se)
+        av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
+            pcs_ptr->slice_type == I_SLICE ? EB_TRUE : EB_FALSE,
+            &pcs_ptr->md_frame_context);
+    if (!pcs_ptr->cdf_ctrl.update_coef)
+        av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
+            &pcs_ptr->md_frame_context);
+    // Segment-loop
+    while (assign_enc_dec_segments(segments_ptr,
+                                   &segment_index,
+                                   enc_dec_tasks_wrapper_ptr,
+                                   context_ptr->enc_dec_feedback_fifo_ptr,
+                                   &deferred_row) == EB_TRUE) {
+        x_sb_start_index = segments_ptr->x_start_array[segment_index];
+        y_sb_start_index = segments_ptr->y_start_array[segment_index];
+        sb_start_index = y_sb_start_index * tile_group_width_in_sb + x_sb_start_index;
+        sb_segment_count = segments_ptr->valid_sb_count_array[segment_index];
+
+        segment_row_index = segment_index / segments_ptr->segment_band_count;
+        segment_band_index =
+            segment_index - segment_row_index * segments_ptr->segment_band_count;
+        segment_band_size = (segments_ptr->sb_band_count * (segment_band_index + 1) +
+                             segments_ptr->segment_band_count - 1) /
+                            segments_ptr->segment_band_count;
+
+        // Reset Coding Loop State
+        reset_mode_decision(scs_ptr,
+                            context_ptr->md_context,
+                            pcs_ptr,
+                            context_ptr->tile_group_index,
+                            segment_index);
+
+        // Reset EncDec Coding State
+        reset_enc_dec( // HT done
+            context_ptr,
+            pcs_ptr,
+            scs_ptr,
+            segment_index);
+
+        if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
+            ((EbReferenceObject *)
+                 pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                ->average_intensity = pcs_ptr->parent_pcs_ptr->average_intensity[0];
+        for (y_sb_index = y_sb_start_index, sb_segment_index = sb_start_index;
+             sb_segment_index < sb_start_index + sb_segment_count;
+             ++y_sb_index) {
+            for (x_sb_index = x_sb_start_index;
+                 x_sb_index < tile_group_width_in_sb &&
+                 (x_sb_index + y_sb_index < segment_band_size) &&
                  sb_segment_index < sb_start_index + sb_segment_count;
-                 ++y_sb_index) {
-                for (x_sb_index = x_sb_start_index;
-                     x_sb_index < tile_group_width_in_sb &&
-                     (x_sb_index + y_sb_index < segment_band_size) &&
-                     sb_segment_index < sb_start_index + sb_segment_count;
-                     ++x_sb_index, ++sb_segment_index) {
-                    uint16_t tile_group_y_sb_start =
-                        pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
-                            .tile_group_sb_start_y;
-                    uint16_t tile_group_x_sb_start =
-                        pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
-                            .tile_group_sb_start_x;
-                    sb_index = context_ptr->md_context->sb_index =(uint16_t)((y_sb_index + tile_group_y_sb_start) * pic_width_in_sb +
-                        x_sb_index + tile_group_x_sb_start);
-                    sb_ptr = context_ptr->md_context->sb_ptr = pcs_ptr->sb_ptr_array[sb_index];
-                    sb_origin_x = (x_sb_index + tile_group_x_sb_start) << sb_size_log2;
-                    sb_origin_y = (y_sb_index + tile_group_y_sb_start) << sb_size_log2;
-                    //printf("[%ld]:ED sb index %d, (%d, %d), encoded total sb count %d, ctx coded sb count %d\n",
-                    //        pcs_ptr->picture_number,
-                    //        sb_index, sb_origin_x, sb_origin_y,
-                    //        pcs_ptr->enc_dec_coded_sb_count,
-                    //        context_ptr->coded_sb_count);
-                    context_ptr->tile_index             = sb_ptr->tile_info.tile_rs_index;
-                    context_ptr->md_context->tile_index = sb_ptr->tile_info.tile_rs_index;
-                    context_ptr->md_context->sb_origin_x = sb_origin_x;
-                    context_ptr->md_context->sb_origin_y = sb_origin_y;
-                    mdc_ptr = context_ptr->md_context->mdc_sb_array;
-                    context_ptr->sb_index = sb_index;
-                    context_ptr->md_context->sb_class = NONE_CLASS;
-
-                    if (pcs_ptr->cdf_ctrl.enabled) {
-                        if (scs_ptr->seq_header.pic_based_rate_est &&
-                            scs_ptr->enc_dec_segment_row_count_array[pcs_ptr->temporal_layer_index] == 1 &&
-                            scs_ptr->enc_dec_segment_col_count_array[pcs_ptr->temporal_layer_index] == 1) {
-                            if (sb_index == 0)
-                                pcs_ptr->ec_ctx_array[sb_index] =  pcs_ptr->md_frame_context;
-                            else
-                                pcs_ptr->ec_ctx_array[sb_index] = pcs_ptr->ec_ctx_array[sb_index - 1];
-                        }
+                 ++x_sb_index, ++sb_segment_index) {
+                uint16_t tile_group_y_sb_start =
+                    pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
+                        .tile_group_sb_start_y;
+                uint16_t tile_group_x_sb_start =
+                    pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
+                        .tile_group_sb_start_x;
+                sb_index = context_ptr->md_context->sb_index =(uint16_t)((y_sb_index + tile_group_y_sb_start) * pic_width_in_sb +
+                    x_sb_index + tile_group_x_sb_start);
+                sb_ptr = context_ptr->md_context->sb_ptr = pcs_ptr->sb_ptr_array[sb_index];
+                sb_origin_x = (x_sb_index + tile_group_x_sb_start) << sb_size_log2;
+                sb_origin_y = (y_sb_index + tile_group_y_sb_start) << sb_size_log2;
+                //printf("[%ld]:ED sb index %d, (%d, %d), encoded total sb count %d, ctx coded sb count %d\n",
+                //        pcs_ptr->picture_number,
+                //        sb_index, sb_origin_x, sb_origin_y,
+                //        pcs_ptr->enc_dec_coded_sb_count,
+                //        context_ptr->coded_sb_count);
+                context_ptr->tile_index             = sb_ptr->tile_info.tile_rs_index;
+                context_ptr->md_context->tile_index = sb_ptr->tile_info.tile_rs_index;
+                context_ptr->md_context->sb_origin_x = sb_origin_x;
+                context_ptr->md_context->sb_origin_y = sb_origin_y;
+                mdc_ptr = context_ptr->md_context->mdc_sb_array;
+                context_ptr->sb_index = sb_index;
+                context_ptr->md_context->sb_class = NONE_CLASS;
+
+                if (pcs_ptr->cdf_ctrl.enabled) {
+                    if (scs_ptr->seq_header.pic_based_rate_est &&
+                        scs_ptr->enc_dec_segment_row_count_array[pcs_ptr->temporal_layer_index] == 1 &&
+                        scs_ptr->enc_dec_segment_col_count_array[pcs_ptr->temporal_layer_index] == 1) {
+                        if (sb_index == 0)
+                            pcs_ptr->ec_ctx_array[sb_index] =  pcs_ptr->md_frame_context;
+                        else
+                            pcs_ptr->ec_ctx_array[sb_index] = pcs_ptr->ec_ctx_array[sb_index - 1];
+                    }
+                    else {
+                        // Use the latest available CDF for the current SB
+                        // Use the weighted average of left (3x) and top right (1x) if available.
+                        int8_t top_right_available =
+                            ((int32_t)(sb_origin_y >> MI_SIZE_LOG2) >
+                             sb_ptr->tile_info.mi_row_start) &&
+                            ((int32_t)((sb_origin_x + (1 << sb_size_log2)) >> MI_SIZE_LOG2) <
+                             sb_ptr->tile_info.mi_col_end);
+
+                        int8_t left_available = ((int32_t)(sb_origin_x >> MI_SIZE_LOG2) >
+                                                 sb_ptr->tile_info.mi_col_start);
+
+                        if (!left_available && !top_right_available)
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                              pcs_ptr->md_frame_context;
+                        else if (!left_available)
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                                pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1];
+                        else if (!top_right_available)
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                                pcs_ptr->ec_ctx_array[sb_index - 1];
                         else {
-                            // Use the latest available CDF for the current SB
-                            // Use the weighted average of left (3x) and top right (1x) if available.
-                            int8_t top_right_available =
-                                ((int32_t)(sb_origin_y >> MI_SIZE_LOG2) >
-                                 sb_ptr->tile_info.mi_row_start) &&
-                                ((int32_t)((sb_origin_x + (1 << sb_size_log2)) >> MI_SIZE_LOG2) <
-                                 sb_ptr->tile_info.mi_col_end);
-
-                            int8_t left_available = ((int32_t)(sb_origin_x >> MI_SIZE_LOG2) >
-                                                     sb_ptr->tile_info.mi_col_start);
-
-                            if (!left_available && !top_right_available)
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                  pcs_ptr->md_frame_context;
-                            else if (!left_available)
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                    pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1];
-                            else if (!top_right_available)
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                    pcs_ptr->ec_ctx_array[sb_index - 1];
-                            else {
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                    pcs_ptr->ec_ctx_array[sb_index - 1];
-                                avg_cdf_symbols(
-                                    &pcs_ptr->ec_ctx_array[sb_index],
-                                    &pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1],
-                                    AVG_CDF_WEIGHT_LEFT,
-                                    AVG_CDF_WEIGHT_TOP);
-                            }
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                                pcs_ptr->ec_ctx_array[sb_index - 1];
+                            avg_cdf_symbols(
+                                &pcs_ptr->ec_ctx_array[sb_index],
+                                &pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1],
+                                AVG_CDF_WEIGHT_LEFT,
+                                AVG_CDF_WEIGHT_TOP);
                         }
-                        // Initial Rate Estimation of the syntax elements
-                        if (pcs_ptr->cdf_ctrl.update_se)
-                        av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
-                            pcs_ptr->slice_type == I_SLICE,
-                            &pcs_ptr->ec_ctx_array[sb_index]);
-                        // Initial Rate Estimation of the Motion vectors
-                        if (pcs_ptr->cdf_ctrl.update_mv)
-                        av1_estimate_mv_rate(pcs_ptr,
-                            &context_ptr->md_context->rate_est_table,
-                            &pcs_ptr->ec_ctx_array[sb_index]);
-
-                        if (pcs_ptr->cdf_ctrl.update_coef)
-                        av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
-                            &pcs_ptr->ec_ctx_array[sb_index]);
-
-                        //let the candidate point to the new rate table.
-                        uint32_t cand_index;
-                        for (cand_index = 0; cand_index < MODE_DECISION_CANDIDATE_MAX_COUNT;
-                            ++cand_index)
-                            context_ptr->md_context->fast_candidate_ptr_array[cand_index]
-                            ->md_rate_estimation_ptr = &context_ptr->md_context->rate_est_table;
-                        context_ptr->md_context->md_rate_estimation_ptr =
-                            &context_ptr->md_context->rate_est_table;
                     }
-                    // Configure the SB
-                    mode_decision_configure_sb(
-                        context_ptr->md_context, pcs_ptr, (uint8_t)sb_ptr->qindex);
-                    // Multi-Pass PD
-                    if ((pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_0 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4)
-                        ) {
-                        // Save a clean copy of the neighbor arrays
-                        copy_neighbour_arrays(pcs_ptr,
-                                              context_ptr->md_context,
-                                              MD_NEIGHBOR_ARRAY_INDEX,
-                                              MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
-                                              0,
-                                              sb_origin_x,
-                                              sb_origin_y);
+                    // Initial Rate Estimation of the syntax elements
+                    if (pcs_ptr->cdf_ctrl.update_se)
+                    av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
+                        pcs_ptr->slice_type == I_SLICE,
+                        &pcs_ptr->ec_ctx_array[sb_index]);
+                    // Initial Rate Estimation of the Motion vectors
+                    if (pcs_ptr->cdf_ctrl.update_mv)
+                    av1_estimate_mv_rate(pcs_ptr,
+                        &context_ptr->md_context->rate_est_table,
+                        &pcs_ptr->ec_ctx_array[sb_index]);
+
+                    if (pcs_ptr->cdf_ctrl.update_coef)
+                    av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
+                        &pcs_ptr->ec_ctx_array[sb_index]);
+
+                    //let the candidate point to the new rate table.
+                    uint32_t cand_index;
+                    for (cand_index = 0; cand_index < MODE_DECISION_CANDIDATE_MAX_COUNT;
+                        ++cand_index)
+                        context_ptr->md_context->fast_candidate_ptr_array[cand_index]
+                        ->md_rate_estimation_ptr = &context_ptr->md_context->rate_est_table;
+                    context_ptr->md_context->md_rate_estimation_ptr =
+                        &context_ptr->md_context->rate_est_table;
+                }
+                // Configure the SB
+                mode_decision_configure_sb(
+                    context_ptr->md_context, pcs_ptr, (uint8_t)sb_ptr->qindex);
+                // Multi-Pass PD
+                if ((pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_0 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4)
+                    ) {
+                    // Save a clean copy of the neighbor arrays
+                    copy_neighbour_arrays(pcs_ptr,
+                                          context_ptr->md_context,
+                                          MD_NEIGHBOR_ARRAY_INDEX,
+                                          MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
+                                          0,
+                                          sb_origin_x,
+                                          sb_origin_y);
+
+                    // [PD_PASS_0] Signal(s) derivation
+                    context_ptr->md_context->pd_pass = PD_PASS_0;
+                    signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+
+                    // [PD_PASS_0]
+                    // Input : mdc_blk_ptr built @ mdc process (up to 4421)
+                    // Output: md_blk_arr_nsq reduced set of block(s)
 
-                        // [PD_PASS_0] Signal(s) derivation
-                        context_ptr->md_context->pd_pass = PD_PASS_0;
-                        signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+                    // Build the t=0 cand_block_array
+                    build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                    // Initialize avail_blk_flag to false
+                    init_avail_blk_flag(scs_ptr, context_ptr->md_context);
 
-                        // [PD_PASS_0]
-                        // Input : mdc_blk_ptr built @ mdc process (up to 4421)
-                        // Output: md_blk_arr_nsq reduced set of block(s)
+                    // PD0 MD Tool(s) : ME_MV(s) as INTER candidate(s), DC as INTRA candidate, luma only, Frequency domain SSE,
+                    // no fast rate (no MVP table generation), MDS0 then MDS3, reduced NIC(s), 1 ref per list,..
+                    mode_decision_sb(scs_ptr,
+                                     pcs_ptr,
+                                     mdc_ptr,
+                                     sb_ptr,
+                                     sb_origin_x,
+                                     sb_origin_y,
+                                     sb_index,
+                                     context_ptr->md_context);
+                        context_ptr->md_context->sb_class = determine_sb_class(
+                            scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
 
-                        // Build the t=0 cand_block_array
-                        build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                    // Perform Pred_0 depth refinement - add depth(s) to be considered in the next stage(s)
+                    perform_pred_depth_refinement(
+                        scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+
+                    // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
+                    // Reset neighnor information to current SB @ position (0,0)
+                    copy_neighbour_arrays(pcs_ptr,
+                                          context_ptr->md_context,
+                                          MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
+                                          MD_NEIGHBOR_ARRAY_INDEX,
+                                          0,
+                                          sb_origin_x,
+                                          sb_origin_y);
+
+                    if (pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
+                        pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
+                        pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
+                        pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4) {
+                        // [PD_PASS_1] Signal(s) derivation
+                        context_ptr->md_context->pd_pass = PD_PASS_1;
+                        signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+                        // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
+                        build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
                         // Initialize avail_blk_flag to false
                         init_avail_blk_flag(scs_ptr, context_ptr->md_context);
 
-                        // PD0 MD Tool(s) : ME_MV(s) as INTER candidate(s), DC as INTRA candidate, luma only, Frequency domain SSE,
-                        // no fast rate (no MVP table generation), MDS0 then MDS3, reduced NIC(s), 1 ref per list,..
+                        // [PD_PASS_1] Mode Decision - Further reduce the number of
+                        // depth(s) to be considered in later PD stages. This pass uses more accurate
+                        // info than PD0 to give a better PD estimate.
+                        // Input : mdc_blk_ptr built @ PD0 refinement
+                        // Output: md_blk_arr_nsq reduced set of block(s)
+
+                        // PD1 MD Tool(s): PME,..
                         mode_decision_sb(scs_ptr,
                                          pcs_ptr,
                                          mdc_ptr,
@@ -4570,14 +4762,10 @@ void *mode_decision_kernel(void *input_ptr) {
                                          sb_origin_y,
                                          sb_index,
                                          context_ptr->md_context);
-                            context_ptr->md_context->sb_class = determine_sb_class(
-                                scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
 
-                        // Perform Pred_0 depth refinement - add depth(s) to be considered in the next stage(s)
+                        // Perform Pred_1 depth refinement - add depth(s) to be considered in the next stage(s)
                         perform_pred_depth_refinement(
                             scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-
-                        // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
                         // Reset neighnor information to current SB @ position (0,0)
                         copy_neighbour_arrays(pcs_ptr,
                                               context_ptr->md_context,
@@ -4586,211 +4774,174 @@ void *mode_decision_kernel(void *input_ptr) {
                                               0,
                                               sb_origin_x,
                                               sb_origin_y);
-
-                        if (pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
-                            pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
-                            pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
-                            pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4) {
-                            // [PD_PASS_1] Signal(s) derivation
-                            context_ptr->md_context->pd_pass = PD_PASS_1;
-                            signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
-                            // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
-                            build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                            // Initialize avail_blk_flag to false
-                            init_avail_blk_flag(scs_ptr, context_ptr->md_context);
-
-                            // [PD_PASS_1] Mode Decision - Further reduce the number of
-                            // depth(s) to be considered in later PD stages. This pass uses more accurate
-                            // info than PD0 to give a better PD estimate.
-                            // Input : mdc_blk_ptr built @ PD0 refinement
-                            // Output: md_blk_arr_nsq reduced set of block(s)
-
-                            // PD1 MD Tool(s): PME,..
-                            mode_decision_sb(scs_ptr,
-                                             pcs_ptr,
-                                             mdc_ptr,
-                                             sb_ptr,
-                                             sb_origin_x,
-                                             sb_origin_y,
-                                             sb_index,
-                                             context_ptr->md_context);
-
-                            // Perform Pred_1 depth refinement - add depth(s) to be considered in the next stage(s)
-                            perform_pred_depth_refinement(
-                                scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                            // Reset neighnor information to current SB @ position (0,0)
-                            copy_neighbour_arrays(pcs_ptr,
-                                                  context_ptr->md_context,
-                                                  MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
-                                                  MD_NEIGHBOR_ARRAY_INDEX,
-                                                  0,
-                                                  sb_origin_x,
-                                                  sb_origin_y);
-                        }
                     }
-                    // [PD_PASS_2] Signal(s) derivation
-                    context_ptr->md_context->pd_pass = PD_PASS_2;
-                        signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
-                    // Re-build mdc_blk_ptr for the 3rd PD Pass [PD_PASS_2]
-                    if(pcs_ptr->parent_pcs_ptr->multi_pass_pd_level != MULTI_PASS_PD_OFF)
-                    build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    else
-                        // Build the t=0 cand_block_array
-                        build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    // Initialize avail_blk_flag to false
-                    init_avail_blk_flag(scs_ptr, context_ptr->md_context);
-
-                    // [PD_PASS_2] Mode Decision - Obtain the final partitioning decision using more accurate info
-                    // than previous stages.  Reduce the total number of partitions to 1.
-                    // Input : mdc_blk_ptr built @ PD1 refinement
-                    // Output: md_blk_arr_nsq reduced set of block(s)
-
-                    // PD2 MD Tool(s): default MD Tool(s)
-                    mode_decision_sb(scs_ptr,
-                                     pcs_ptr,
-                                     mdc_ptr,
-                                     sb_ptr,
-                                     sb_origin_x,
-                                     sb_origin_y,
-                                     sb_index,
-                                     context_ptr->md_context);
-                    generate_statistics_nsq(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    generate_statistics_depth(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    generate_statistics_txt(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                }
+                // [PD_PASS_2] Signal(s) derivation
+                context_ptr->md_context->pd_pass = PD_PASS_2;
+                    signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+                // Re-build mdc_blk_ptr for the 3rd PD Pass [PD_PASS_2]
+                if(pcs_ptr->parent_pcs_ptr->multi_pass_pd_level != MULTI_PASS_PD_OFF)
+                build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                else
+                    // Build the t=0 cand_block_array
+                    build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                // Initialize avail_blk_flag to false
+                init_avail_blk_flag(scs_ptr, context_ptr->md_context);
+
+                // [PD_PASS_2] Mode Decision - Obtain the final partitioning decision using more accurate info
+                // than previous stages.  Reduce the total number of partitions to 1.
+                // Input : mdc_blk_ptr built @ PD1 refinement
+                // Output: md_blk_arr_nsq reduced set of block(s)
+
+                // PD2 MD Tool(s): default MD Tool(s)
+                mode_decision_sb(scs_ptr,
+                                 pcs_ptr,
+                                 mdc_ptr,
+                                 sb_ptr,
+                                 sb_origin_x,
+                                 sb_origin_y,
+                                 sb_index,
+                                 context_ptr->md_context);
+                generate_statistics_nsq(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                generate_statistics_depth(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                generate_statistics_txt(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
 
 #if NO_ENCDEC
-                    no_enc_dec_pass(scs_ptr,
-                                    pcs_ptr,
-                                    sb_ptr,
-                                    sb_index,
-                                    sb_origin_x,
-                                    sb_origin_y,
-                                    sb_ptr->qp,
-                                    context_ptr);
+                no_enc_dec_pass(scs_ptr,
+                                pcs_ptr,
+                                sb_ptr,
+                                sb_index,
+                                sb_origin_x,
+                                sb_origin_y,
+                                sb_ptr->qp,
+                                context_ptr);
 #else
-                    // Encode Pass
-                    av1_encode_decode(
-                        scs_ptr, pcs_ptr, sb_ptr, sb_index, sb_origin_x, sb_origin_y, context_ptr);
+                // Encode Pass
+                av1_encode_decode(
+                    scs_ptr, pcs_ptr, sb_ptr, sb_index, sb_origin_x, sb_origin_y, context_ptr);
 #endif
 
-                    context_ptr->coded_sb_count++;
-                    if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
-                        ((EbReferenceObject *)
-                             pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                            ->intra_coded_area_sb[sb_index] = (uint8_t)(
-                            (100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
-                }
-                x_sb_start_index = (x_sb_start_index > 0) ? x_sb_start_index - 1 : 0;
+                context_ptr->coded_sb_count++;
+                if (svt_dlf_sb_coded(pcs_ptr, y_sb_index + tile_group_y_sb_start))
+                    post_enc_dec_sb_rows(context_ptr, enc_dec_tasks_ptr->pcs_wrapper_ptr);
+                if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
+                    ((EbReferenceObject *)
+                         pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                        ->intra_coded_area_sb[sb_index] = (uint8_t)(
+                        (100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
             }
+            x_sb_start_index = (x_sb_start_index > 0) ? x_sb_start_index - 1 : 0;
         }
+    }
 
-        svt_block_on_mutex(pcs_ptr->intra_mutex);
-        pcs_ptr->intra_coded_area += (uint32_t)context_ptr->tot_intra_coded_area;
-        // Accumulate block selection
-        for (uint8_t partidx = 0; partidx < NUMBER_OF_SHAPES-1; partidx++)
-            for (uint8_t band = 0; band < FB_NUM; band++)
-                for (uint8_t sse_idx = 0; sse_idx < SSEG_NUM; sse_idx++)
-                    pcs_ptr->part_cnt[partidx][band][sse_idx] += context_ptr->md_context->part_cnt[partidx][band][sse_idx];
-
-        // Accumulate pred depth selection
-        for (uint8_t pred_depth = 0; pred_depth < DEPTH_DELTA_NUM; pred_depth++)
-            for (uint8_t part_idx = 0; part_idx < (NUMBER_OF_SHAPES-1); part_idx++)
-                pcs_ptr->pred_depth_count[pred_depth][part_idx] += context_ptr->md_context->pred_depth_count[pred_depth][part_idx];
-        // Accumulate tx_type selection
-        for (uint8_t depth_delta = 0; depth_delta < TXT_DEPTH_DELTA_NUM; depth_delta++)
-            for (uint8_t txs_idx = 0; txs_idx < TX_TYPES; txs_idx++)
-                pcs_ptr->txt_cnt[depth_delta][txs_idx] += context_ptr->md_context->txt_cnt[depth_delta][txs_idx];
-
-        pcs_ptr->enc_dec_coded_sb_count += (uint32_t)context_ptr->coded_sb_count;
-        EbBool last_sb_flag = (pcs_ptr->sb_total_count_pix == pcs_ptr->enc_dec_coded_sb_count);
-        svt_release_mutex(pcs_ptr->intra_mutex);
-
-        if (last_sb_flag) {
-            EbBool do_recode = EB_FALSE;
-            scs_ptr->encode_context_ptr->recode_loop = scs_ptr->static_config.recode_loop;
-            if ((use_input_stat(scs_ptr) || scs_ptr->lap_enabled) &&
-                scs_ptr->encode_context_ptr->recode_loop != DISALLOW_RECODE) {
-                recode_loop_decision_maker(pcs_ptr, scs_ptr, &do_recode);
-            }
-
-            if (do_recode) {
+    svt_block_on_mutex(pcs_ptr->intra_mutex);
+    pcs_ptr->intra_coded_area += (uint32_t)context_ptr->tot_intra_coded_area;
+    // Accumulate block selection
+    for (uint8_t partidx = 0; partidx < NUMBER_OF_SHAPES-1; partidx++)
+        for (uint8_t band = 0; band < FB_NUM; band++)
+            for (uint8_t sse_idx = 0; sse_idx < SSEG_NUM; sse_idx++)
+                pcs_ptr->part_cnt[partidx][band][sse_idx] += context_ptr->md_context->part_cnt[partidx][band][sse_idx];
+
+    // Accumulate pred depth selection
+    for (uint8_t pred_depth = 0; pred_depth < DEPTH_DELTA_NUM; pred_depth++)
+        for (uint8_t part_idx = 0; part_idx < (NUMBER_OF_SHAPES-1); part_idx++)
+            pcs_ptr->pred_depth_count[pred_depth][part_idx] += context_ptr->md_context->pred_depth_count[pred_depth][part_idx];
+    // Accumulate tx_type selection
+    for (uint8_t depth_delta = 0; depth_delta < TXT_DEPTH_DELTA_NUM; depth_delta++)
+        for (uint8_t txs_idx = 0; txs_idx < TX_TYPES; txs_idx++)
+            pcs_ptr->txt_cnt[depth_delta][txs_idx] += context_ptr->md_context->txt_cnt[depth_delta][txs_idx];
+
+    pcs_ptr->enc_dec_coded_sb_count += (uint32_t)context_ptr->coded_sb_count;
+    EbBool last_sb_flag = (pcs_ptr->sb_total_count_pix == pcs_ptr->enc_dec_coded_sb_count);
+    svt_release_mutex(pcs_ptr->intra_mutex);
+
+    if (last_sb_flag) {
+        EbBool do_recode = EB_FALSE;
+        scs_ptr->encode_context_ptr->recode_loop = scs_ptr->static_config.recode_loop;
+        if ((use_input_stat(scs_ptr) || scs_ptr->lap_enabled) &&
+            scs_ptr->encode_context_ptr->recode_loop != DISALLOW_RECODE) {
+            recode_loop_decision_maker(pcs_ptr, scs_ptr, &do_recode);
+        }
 
-                pcs_ptr->enc_dec_coded_sb_count = 0;
-                last_sb_flag = EB_FALSE;
-                // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
-                if (context_ptr->is_md_rate_estimation_ptr_owner) {
-                    EB_FREE_ARRAY(context_ptr->md_rate_estimation_ptr);
-                    context_ptr->is_md_rate_estimation_ptr_owner = EB_FALSE;
-                }
-                context_ptr->md_rate_estimation_ptr = pcs_ptr->md_rate_estimation_array;
-                // re-init mode decision configuration for qp update for re-encode frame
-                mode_decision_configuration_init_qp_update(pcs_ptr);
-                // init segment for re-encode frame
-                init_enc_dec_segement(pcs_ptr->parent_pcs_ptr);
-                EbObjectWrapper *enc_dec_re_encode_tasks_wrapper_ptr;
-                uint16_t tg_count =
-                    pcs_ptr->parent_pcs_ptr->tile_group_cols * pcs_ptr->parent_pcs_ptr->tile_group_rows;
-                for (uint16_t tile_group_idx = 0; tile_group_idx < tg_count; tile_group_idx++) {
-                    svt_get_empty_object(context_ptr->enc_dec_feedback_fifo_ptr,
-                            &enc_dec_re_encode_tasks_wrapper_ptr);
-
-                    EncDecTasks *enc_dec_re_encode_tasks_ptr = (EncDecTasks *)enc_dec_re_encode_tasks_wrapper_ptr->object_ptr;
-                    enc_dec_re_encode_tasks_ptr->pcs_wrapper_ptr  = enc_dec_tasks_ptr->pcs_wrapper_ptr;
-                    enc_dec_re_encode_tasks_ptr->input_type       = ENCDEC_TASKS_MDC_INPUT;
-                    enc_dec_re_encode_tasks_ptr->tile_group_index = tile_group_idx;
-
-                    // Post the Full Results Object
-                    svt_post_full_object(enc_dec_re_encode_tasks_wrapper_ptr);
-                }
+        if (do_recode) {
 
+            pcs_ptr->enc_dec_coded_sb_count = 0;
+            last_sb_flag = EB_FALSE;
+            // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
+            if (context_ptr->is_md_rate_estimation_ptr_owner) {
+                EB_FREE_ARRAY(context_ptr->md_rate_estimation_ptr);
+                context_ptr->is_md_rate_estimation_ptr_owner = EB_FALSE;
             }
-            else {
-            // Copy film grain data from parent picture set to the reference object for further reference
-            if (scs_ptr->seq_header.film_grain_params_present) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
-                    pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr) {
-                    ((EbReferenceObject *)
-                         pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                        ->film_grain_params = pcs_ptr->parent_pcs_ptr->frm_hdr.film_grain_params;
-                }
-            }
-            if (pcs_ptr->parent_pcs_ptr->frame_end_cdf_update_mode &&
-                pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
-                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr)
-                for (int frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame)
-                    ((EbReferenceObject *)
-                         pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                        ->global_motion[frame] = pcs_ptr->parent_pcs_ptr->global_motion[frame];
-            svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->sgrproj_restore_cost,
-                       context_ptr->md_rate_estimation_ptr->sgrproj_restore_fac_bits,
-                       2 * sizeof(int32_t));
-            svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->switchable_restore_cost,
-                       context_ptr->md_rate_estimation_ptr->switchable_restore_fac_bits,
-                       3 * sizeof(int32_t));
-            svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->wiener_restore_cost,
-                       context_ptr->md_rate_estimation_ptr->wiener_restore_fac_bits,
-                       2 * sizeof(int32_t));
-            pcs_ptr->parent_pcs_ptr->av1x->rdmult =
-                context_ptr->pic_full_lambda[(context_ptr->bit_depth == EB_10BIT) ? EB_10_BIT_MD
-                                                                                  : EB_8_BIT_MD];
-            svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
-            pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
-            // Get Empty EncDec Results
-            svt_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
-            enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
-            enc_dec_results_ptr->pcs_wrapper_ptr = enc_dec_tasks_ptr->pcs_wrapper_ptr;
-            //CHKN these are not needed for DLF
-            enc_dec_results_ptr->completed_sb_row_index_start = 0;
-            enc_dec_results_ptr->completed_sb_row_count =
-                ((pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) >> sb_size_log2);
-            // Post EncDec Results
-            svt_post_full_object(enc_dec_results_wrapper_ptr);
+            context_ptr->md_rate_estimation_ptr = pcs_ptr->md_rate_estimation_array;
+            // re-init mode decision configuration for qp update for re-encode frame
+            mode_decision_configuration_init_qp_update(pcs_ptr);
+            // init segment for re-encode frame
+            init_enc_dec_segement(pcs_ptr->parent_pcs_ptr);
+            posted = post_re_encode_tasks(context_ptr, enc_dec_tasks_wrapper_ptr, 0);
+        }
+        else {
+        // Copy film grain data from parent picture set to the reference object for further reference
+        if (scs_ptr->seq_header.film_grain_params_present) {
+            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
+                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr) {
+                ((EbReferenceObject *)
+                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                    ->film_grain_params = pcs_ptr->parent_pcs_ptr->frm_hdr.film_grain_params;
             }
         }
+        if (pcs_ptr->parent_pcs_ptr->frame_end_cdf_update_mode &&
+            pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
+            pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr)
+            for (int frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame)
+                ((EbReferenceObject *)
+                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                    ->global_motion[frame] = pcs_ptr->parent_pcs_ptr->global_motion[frame];
+        svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->sgrproj_restore_cost,
+                   context_ptr->md_rate_estimation_ptr->sgrproj_restore_fac_bits,
+                   2 * sizeof(int32_t));
+        svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->switchable_restore_cost,
+                   context_ptr->md_rate_estimation_ptr->switchable_restore_fac_bits,
+                   3 * sizeof(int32_t));
+        svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->wiener_restore_cost,
+                   context_ptr->md_rate_estimation_ptr->wiener_restore_fac_bits,
+                   2 * sizeof(int32_t));
+        pcs_ptr->parent_pcs_ptr->av1x->rdmult =
+            context_ptr->pic_full_lambda[(context_ptr->bit_depth == EB_10BIT) ? EB_10_BIT_MD
+                                                                              : EB_8_BIT_MD];
+        svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
+        pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
+        posted = post_enc_dec_results(context_ptr, enc_dec_tasks_wrapper_ptr);
         }
-        // Release Mode Decision Results
+    }
+    }
+    // Release Mode Decision Results
+    if (posted)
         svt_release_object(enc_dec_tasks_wrapper_ptr);
+}
+
+/******************************************************
+ * Mode Decision Pool Task
+ *   Runs one EncDec Tasks object on a thread pool worker
+ ******************************************************/
+void mode_decision_pool_task(void *thread_context_ptr, void *wrapper_ptr) {
+    enc_dec_process((EncDecContext *)((EbThreadContext *)thread_context_ptr)->priv,
+                    (EbObjectWrapper *)wrapper_ptr);
+}
+
+/******************************************************
+ * EncDec Kernel
+ ******************************************************/
+void *mode_decision_kernel(void *input_ptr) {
+    EbThreadContext *thread_context_ptr = (EbThreadContext *)input_ptr;
+    EncDecContext *  context_ptr        = (EncDecContext *)thread_context_ptr->priv;
+    EbObjectWrapper *enc_dec_tasks_wrapper_ptr;
+
+    for (;;) {
+        // Get Mode Decision Results
+        EB_GET_FULL_OBJECT(context_ptr->mode_decision_input_fifo_ptr, &enc_dec_tasks_wrapper_ptr);
+        enc_dec_process(context_ptr, enc_dec_tasks_wrapper_ptr);
     }
+
     return NULL;
 }
 
@@ -18,6 +18,18 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+#define DLF_TASKS_ENCDEC_INPUT 0
+#define DLF_TASKS_VERT_INPUT 1
+#define DLF_TASKS_HORZ_INPUT 2
+// A DLF pool task parked on an empty output fifo, posting the rest of
+// the vertical, horizontal or CDEF segments from posted_count (the CDEF
+// segments up to segment_index)
+#define DLF_TASKS_POST_VERT 3
+#define DLF_TASKS_POST_HORZ 4
+#define DLF_TASKS_POST_CDEF 5
+// SB row progress of a picture still coded by EncDec
+#define DLF_TASKS_SB_ROW_INPUT 6
+
 /**************************************
      * Process Results
      **************************************/
@@ -26,18 +38,32 @@ typedef struct EncDecResults {
     EbObjectWrapper *pcs_wrapper_ptr;
     uint32_t         completed_sb_row_index_start;
     uint32_t         completed_sb_row_count;
+    // DLF_TASKS_ENCDEC_INPUT for a picture completed by EncDec,
+    // DLF_TASKS_SB_ROW_INPUT for SB rows it completed, or a deblocking
+    // segment fed back by the DLF stage
+    uint32_t input_type;
+    uint16_t segment_index;
+    uint16_t posted_count;
 } EncDecResults;
 
 typedef struct DlfResults {
     EbDctor          dctor;
     EbObjectWrapper *pcs_wrapper_ptr;
     uint32_t         segment_index;
+    // Set while a CDEF pool task parked on an empty output fifo, which
+    // posts the rest of the Rest segments from posted_count
+    EbBool   parked;
+    uint16_t posted_count;
 } DlfResults;
 
 typedef struct CdefResults {
     EbDctor          dctor;
     EbObjectWrapper *pcs_wrapper_ptr;
     uint32_t         segment_index;
+    // Set while a Rest pool task parked on an empty output fifo, which
+    // posts the rest of the picture outputs from posted_count
+    EbBool   parked;
+    uint16_t posted_count;
 } CdefResults;
 
 typedef struct RestResults {
@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "EbEncDecSegments.h"
+#include "EbUtility.h"
 
 static void enc_dec_segments_dctor(EbPtr p) {
     EncDecSegments *obj = (EncDecSegments *)p;
@@ -78,11 +79,13 @@ void enc_dec_segments_init(EncDecSegments *segments_ptr, uint32_t segColCount, u
         : segments_ptr->segment_max_row_count;
 
     segments_ptr->sb_row_count       = pic_height_sb;
+    segments_ptr->sb_col_count       = pic_width_sb;
     segments_ptr->sb_band_count      = BAND_TOTAL_COUNT(pic_height_sb, pic_width_sb);
     segments_ptr->segment_row_count  = segRowCount;
     segments_ptr->segment_band_count = BAND_TOTAL_COUNT(segRowCount, segColCount);
     segments_ptr->segment_ttl_count  = segments_ptr->segment_row_count *
         segments_ptr->segment_band_count;
+    segments_ptr->wpp                = segRowCount == pic_height_sb && segColCount == pic_width_sb;
 
     //EB_MEMSET(segments_ptr->inputMap.inputDependencyMap, 0, sizeof(uint16_t) * segments_ptr->segment_ttl_count);
     EB_MEMSET(
@@ -161,3 +164,43 @@ void enc_dec_segments_init(EncDecSegments *segments_ptr, uint32_t segColCount, u
 
     return;
 }
+
+void enc_dec_segments_wpp_reset(EncDecSegments *segments_ptr) {
+    for (unsigned row_index = 0; row_index < segments_ptr->segment_row_count; ++row_index) {
+        segments_ptr->row_array[row_index].completed_sb_count = 0;
+        segments_ptr->row_array[row_index].active             = (row_index == 0);
+    }
+}
+
+uint32_t enc_dec_segments_wpp_update(EncDecSegments *segments_ptr, uint16_t segment_index,
+                                     uint16_t *ready_row_array) {
+    const uint32_t       row_index    = segment_index / segments_ptr->segment_band_count;
+    const uint32_t       sb_col_count = segments_ptr->sb_col_count;
+    EncDecSegSegmentRow *row_ptr      = &segments_ptr->row_array[row_index];
+    uint32_t             ready_count  = 0;
+
+    // The row goes on while the SB above right of its next SB is done, else
+    // it is released and the row above restarts it
+    svt_block_on_mutex(row_ptr->assignment_mutex);
+    const uint32_t completed_sb_count = ++row_ptr->completed_sb_count;
+    if (completed_sb_count < sb_col_count &&
+        (row_index == 0 ||
+         row_ptr[-1].completed_sb_count >= MIN(completed_sb_count + 2, sb_col_count)))
+        ready_row_array[ready_count++] = (uint16_t)row_index;
+    else
+        row_ptr->active = EB_FALSE;
+    svt_release_mutex(row_ptr->assignment_mutex);
+
+    // Restart the row below when it is waiting for this SB
+    if (row_index + 1 < segments_ptr->segment_row_count) {
+        EncDecSegSegmentRow *below_ptr = row_ptr + 1;
+        svt_block_on_mutex(below_ptr->assignment_mutex);
+        if (!below_ptr->active && below_ptr->completed_sb_count < sb_col_count &&
+            completed_sb_count >= MIN(below_ptr->completed_sb_count + 2u, sb_col_count)) {
+            below_ptr->active              = EB_TRUE;
+            ready_row_array[ready_count++] = (uint16_t)(row_index + 1);
+        }
+        svt_release_mutex(below_ptr->assignment_mutex);
+    }
+    return ready_count;
+}
@@ -52,6 +52,12 @@ typedef struct EncDecSegSegmentRow {
     uint16_t ending_seg_index;
     uint16_t current_seg_index;
     EbHandle assignment_mutex;
+    // Wavefront progress, see enc_dec_segments_wpp_update()
+    volatile uint16_t completed_sb_count;
+    EbBool            active;
+    // Next row of the list of rows a pool task could not feed back and
+    // processes itself, see assign_enc_dec_segments()
+    int16_t next_deferred_row;
 } EncDecSegSegmentRow;
 
 /**************************************
@@ -71,6 +77,11 @@ typedef struct EncDecSegments {
     uint32_t segment_ttl_count;
     uint32_t sb_band_count;
     uint32_t sb_row_count;
+    uint32_t sb_col_count;
+
+    // One SB per segment: the rows are scheduled from their progress
+    // counters instead of the dependency map
+    EbBool wpp;
 
     uint32_t segment_max_band_count;
     uint32_t segment_max_row_count;
@@ -86,6 +97,21 @@ extern EbErrorType enc_dec_segments_ctor(EncDecSegments *segments_ptr, uint32_t
 extern void enc_dec_segments_init(EncDecSegments *segments_ptr, uint32_t col_count,
                                   uint32_t row_count, uint32_t pic_width_sb,
                                   uint32_t pic_height_sb);
+
+/* Resets the progress of the rows before the first segment is assigned */
+extern void enc_dec_segments_wpp_reset(EncDecSegments *segments_ptr);
+
+/**************************************
+ * enc_dec_segments_wpp_update
+ *   Marks the SB of segment_index done. A row owned by a thread is
+ *   processed left to right, and its next SB can start once the SB above
+ *   right of it is done. Returns the number of rows (0 to 2) whose next
+ *   SB became ready, in ready_row_array: the row of segment_index first,
+ *   then the row below. The caller owns the returned rows and takes their
+ *   next SB from current_seg_index.
+ **************************************/
+extern uint32_t enc_dec_segments_wpp_update(EncDecSegments *segments_ptr, uint16_t segment_index,
+                                            uint16_t *ready_row_array);
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,11 @@ extern "C" {
 #define ENCDEC_TASKS_MDC_INPUT 0
 #define ENCDEC_TASKS_ENCDEC_INPUT 1
 #define ENCDEC_TASKS_CONTINUE 2
+// An EncDec pool task parked on an empty output fifo, posting the
+// results of its completed picture, or its re-encode tasks from
+// posted_count
+#define ENCDEC_TASKS_POST_RESULTS 3
+#define ENCDEC_TASKS_POST_RE_ENCODE 4
 
 /**************************************
      * Process Results
@@ -31,6 +36,7 @@ typedef struct EncDecTasks {
     uint32_t         input_type;
     int16_t          enc_dec_segment_row;
     uint16_t         tile_group_index;
+    uint16_t         posted_count;
 } EncDecTasks;
 
 typedef struct EncDecTasksInitData {
@@ -57,7 +57,18 @@ static void encode_context_dctor(EbPtr p) {
     EB_DESTROY_MUTEX(obj->sc_buffer_mutex);
     EB_DESTROY_MUTEX(obj->shared_reference_mutex);
     EB_DESTROY_MUTEX(obj->stat_file_mutex);
+    EB_DESTROY_MUTEX(obj->tf_stats_mutex);
+    EB_DESTROY_MUTEX(obj->me_gate_mutex);
+    while (obj->me_gate_head_ptr) {
+        MeGate *gate_ptr      = obj->me_gate_head_ptr;
+        obj->me_gate_head_ptr = gate_ptr->next_ptr;
+        EB_FREE(gate_ptr);
+    }
+    EB_DESTROY_MUTEX(obj->low_latency_eos_mutex);
+    EB_DESTROY_MUTEX(obj->tile_group_mutex);
+    EB_FREE_ARRAY(obj->tile_group_fragments);
     EB_DELETE(obj->prediction_structure_group_ptr);
+    EB_DELETE(obj->output_buffer_pool_ptr);
     EB_DELETE_PTR_ARRAY(obj->picture_decision_reorder_queue,
                         PICTURE_DECISION_REORDER_QUEUE_MAX_DEPTH);
     EB_FREE(obj->pre_assignment_buffer);
@@ -183,6 +194,11 @@ EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_
     encode_context_ptr->rc_cfg.min_cr                 = 0;
     EB_CREATE_MUTEX(encode_context_ptr->shared_reference_mutex);
     EB_CREATE_MUTEX(encode_context_ptr->stat_file_mutex);
+    EB_CREATE_MUTEX(encode_context_ptr->tf_stats_mutex);
+    EB_CREATE_MUTEX(encode_context_ptr->me_gate_mutex);
+    EB_CREATE_MUTEX(encode_context_ptr->low_latency_eos_mutex);
+    EB_CREATE_MUTEX(encode_context_ptr->tile_group_mutex);
+    EB_NEW(encode_context_ptr->output_buffer_pool_ptr, svt_output_buffer_pool_ctor);
     encode_context_ptr->num_lap_buffers = 0; //lap not supported for now
     int *num_lap_buffers                = &encode_context_ptr->num_lap_buffers;
     create_stats_buffer(&encode_context_ptr->frame_stats_buffer,
@@ -20,6 +20,7 @@
 #include "EbPictureDecisionQueue.h"
 #include "EbPictureManagerQueue.h"
 #include "EbPacketizationReorderQueue.h"
+#include "EbOutputBufferPool.h"
 #include "EbInitialRateControlReorderQueue.h"
 #include "EbPictureManagerReorderQueue.h"
 #include "EbCabacContextModel.h"
@@ -48,6 +49,22 @@
 #define RC_GROUP_IN_GOP_MAX_NUMBER 512
 #define PICTURE_IN_RC_GROUP_MAX_NUMBER 64
 
+/*
+  A mini-GOP sent to motion estimation before the temporal filtering of its
+  sources completed. The ME segments of its pictures are held back on the gate
+  and posted again once the filtering the mini-GOP and the earlier ones wait
+  for is done, see EbPictureDecisionProcess.c
+*/
+typedef struct MeGate {
+    struct MeGate *next_ptr;
+    uint32_t       tf_pending_count; // filtered pictures not done yet
+    // ME segments taken before the release, linked by their next_ptr
+    struct EbObjectWrapper *deferred_head_ptr;
+    struct EbObjectWrapper *deferred_tail_ptr;
+    uint32_t                pcs_count;
+    struct PictureParentControlSet *pcs_array[(1 << MAX_TEMPORAL_LAYERS) + 1];
+} MeGate;
+
 typedef struct DpbDependentList {
     int32_t  list[1 << MAX_TEMPORAL_LAYERS];
     uint32_t list_count;
@@ -84,6 +101,8 @@ typedef struct EncodeContext {
     EbFifo *overlay_input_picture_pool_fifo_ptr;
     // Output Buffer Fifos
     EbFifo *stream_output_fifo_ptr;
+    // Application buffers the packets are written to
+    EbOutputBufferPool *output_buffer_pool_ptr;
     EbFifo *recon_output_fifo_ptr;
 
     // Picture Buffer Fifos
@@ -179,6 +198,38 @@ typedef struct EncodeContext {
 
     EbHandle stat_file_mutex;
 
+    // Temporal filtering latency, in microseconds, protected by tf_stats_mutex.
+    // Only updated when enable_pipeline_stats is set
+    EbHandle tf_stats_mutex;
+    uint64_t tf_picture_count;
+    uint64_t tf_latency_total; // from the post of the segments to the last segment done
+    uint64_t tf_latency_max;
+    uint64_t tf_wait_time; // picture decision blocked on the filtering
+
+    // Mini-GOPs waiting for their temporal filtering, oldest first, and the
+    // tf_done, tf_gate_ptr and me_gate_ptr fields of the pictures, protected
+    // by me_gate_mutex
+    EbHandle me_gate_mutex;
+    MeGate * me_gate_head_ptr;
+    MeGate * me_gate_tail_ptr;
+
+    // Low-latency mode end of sequence, protected by low_latency_eos_mutex:
+    // sent once the EOS input is received and every picture is packetized
+    EbHandle low_latency_eos_mutex;
+    uint64_t low_latency_picture_count; // posted by resource coordination
+    uint64_t low_latency_packet_count; // posted by packetization
+    EbBool   low_latency_eos_received;
+
+    // Tile group output, protected by tile_group_mutex: the fragments are coded
+    // as soon as their tile is done and sent in decode order. The fragments of
+    // a picture wait in the row decode_order % PACKETIZATION_REORDER_QUEUE_MAX_DEPTH
+    // of tile_group_fragments, of tile_group_stride entries.
+    EbHandle          tile_group_mutex;
+    uint64_t          tile_group_decode_order; // picture being sent
+    uint16_t          tile_group_tile_index; // next fragment to send
+    uint32_t          tile_group_stride;
+    EbObjectWrapper **tile_group_fragments;
+
     //DPB list management
     DPBInfo              dpb_list[REF_FRAMES];
     uint64_t             display_picture_number;
@@ -3134,10 +3134,14 @@ static void write_tile_info(const PictureParentControlSet *const pcs_ptr,
 
         // Number of bytes in tile size - 1
         uint32_t max_tile_size = 0;
-        for (int tile_idx = 0; tile_idx < tile_cnt - 1; tile_idx++) {
-            max_tile_size = AOMMAX(max_tile_size,
-                                   pcs_ptr->child_pcs->entropy_coding_info[tile_idx]
-                                       ->entropy_coder_ptr->ec_writer.pos);
+        // a tile group output writes the header before the tiles are coded,
+        // its tile groups hold one tile each and have no tile size field
+        if (!pcs_ptr->scs_ptr->static_config.tile_group_output) {
+            for (int tile_idx = 0; tile_idx < tile_cnt - 1; tile_idx++) {
+                max_tile_size = AOMMAX(max_tile_size,
+                                       pcs_ptr->child_pcs->entropy_coding_info[tile_idx]
+                                           ->entropy_coder_ptr->ec_writer.pos);
+            }
         }
         if (max_tile_size >> 24 != 0)
             pcs_ptr->child_pcs->tile_size_bytes_minus_1 = 3;
@@ -4346,6 +4350,60 @@ EbErrorType write_frame_header_av1(Bitstream *bitstream_ptr, SequenceControlSet
     return return_error;
 }
 
+/**************************************************
+* write_frame_header_obu_av1
+**************************************************/
+EbErrorType write_frame_header_obu_av1(Bitstream *bitstream_ptr, SequenceControlSet *scs_ptr,
+                                       PictureControlSet *pcs_ptr) {
+    OutputBitstreamUnit *output_bitstream_ptr = (OutputBitstreamUnit *)
+                                                    bitstream_ptr->output_bitstream_ptr;
+    uint8_t *data = output_bitstream_ptr->buffer_av1;
+
+    const uint32_t obu_header_size  = write_obu_header(OBU_FRAME_HEADER, 0, data);
+    const uint32_t obu_payload_size = write_frame_header_obu(
+        scs_ptr, pcs_ptr->parent_pcs_ptr, data + obu_header_size, 0, 1);
+    const size_t length_field_size = obu_mem_move(obu_header_size, obu_payload_size, data);
+    if (write_uleb_obu_size(obu_header_size, obu_payload_size, data) != AOM_CODEC_OK) {
+        assert(0);
+    }
+    output_bitstream_ptr->buffer_av1 = data + obu_header_size + obu_payload_size +
+        length_field_size;
+    return EB_ErrorNone;
+}
+
+/**************************************************
+* write_tile_group_av1
+**************************************************/
+EbErrorType write_tile_group_av1(Bitstream *bitstream_ptr, PictureControlSet *pcs_ptr,
+                                 uint16_t tile_idx) {
+    OutputBitstreamUnit *output_bitstream_ptr = (OutputBitstreamUnit *)
+                                                    bitstream_ptr->output_bitstream_ptr;
+    Av1Common *const cm   = pcs_ptr->parent_pcs_ptr->av1_cm;
+    uint8_t *        data = output_bitstream_ptr->buffer_av1;
+
+    // the tile group holds the single tile tile_idx, its size is the one of the OBU
+    uint32_t curr_data_size  = write_obu_header(OBU_TILE_GROUP, 0, data);
+    const uint32_t obu_header_size = curr_data_size;
+    curr_data_size += write_tile_group_header(
+        data + curr_data_size, tile_idx, tile_idx, cm->log2_tile_rows + cm->log2_tile_cols, 1);
+
+    const uint32_t tile_size =
+        pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr->ec_writer.pos;
+    OutputBitstreamUnit *ec_output_bitstream_ptr =
+        (OutputBitstreamUnit *)pcs_ptr->entropy_coding_info[tile_idx]
+            ->entropy_coder_ptr->ec_output_bitstream_ptr;
+    svt_memcpy(data + curr_data_size, ec_output_bitstream_ptr->buffer_begin_av1, tile_size);
+    curr_data_size += tile_size;
+
+    const uint32_t obu_payload_size  = curr_data_size - obu_header_size;
+    const size_t   length_field_size = obu_mem_move(obu_header_size, obu_payload_size, data);
+    if (write_uleb_obu_size(obu_header_size, obu_payload_size, data) != AOM_CODEC_OK) {
+        assert(0);
+    }
+    output_bitstream_ptr->buffer_av1 = data + curr_data_size + length_field_size;
+    return EB_ErrorNone;
+}
+
 /**************************************************
 * encode_sps_av1
 **************************************************/
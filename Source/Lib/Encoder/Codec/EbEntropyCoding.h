@@ -207,6 +207,11 @@ extern EbErrorType write_metadata_av1(Bitstream *bitstream_ptr, SvtMetadataArray
                                       const EbAv1MetadataType type);
 extern EbErrorType write_frame_header_av1(Bitstream *bitstream_ptr, SequenceControlSet *scs_ptr,
                                           PictureControlSet *pcs_ptr, uint8_t show_existing);
+/* Tile group output: the frame header OBU, then one tile group OBU per tile */
+extern EbErrorType write_frame_header_obu_av1(Bitstream *bitstream_ptr, SequenceControlSet *scs_ptr,
+                                              PictureControlSet *pcs_ptr);
+extern EbErrorType write_tile_group_av1(Bitstream *bitstream_ptr, PictureControlSet *pcs_ptr,
+                                        uint16_t tile_idx);
 extern EbErrorType encode_td_av1(uint8_t *bitstream_ptr);
 extern EbErrorType encode_sps_av1(Bitstream *bitstream_ptr, SequenceControlSet *scs_ptr);
 
@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include "EbEncHandle.h"
 #include "EbEntropyCodingProcess.h"
+#include "EbPacketizationProcess.h"
 #include "EbEncDecResults.h"
 #include "EbEntropyCodingResults.h"
 #include "EbRateControlTasks.h"
@@ -406,10 +407,11 @@ void *entropy_coding_kernel(void *input_ptr) {
                             context_ptr->tok = pcs_ptr->tile_tok[tile_row][tile_col];
                         }
                         sb_ptr->total_bits = 0;
-                        uint32_t prev_pos  = (x_sb_index == 0 && y_sb_index == 0)
-                             ? 0
-                             : pcs_ptr->entropy_coding_info[tile_idx]
-                                  ->entropy_coder_ptr->ec_writer.ec.offs; //residual_bc.pos
+                        // The range coder flushes several bytes at once, so
+                        // the bits of a superblock are counted with tell
+                        OdEcEnc *ec = &pcs_ptr->entropy_coding_info[tile_idx]
+                                           ->entropy_coder_ptr->ec_writer.ec;
+                        const int32_t prev_bits = svt_od_ec_enc_tell(ec);
 
                         EbPictureBufferDesc *coeff_picture_ptr = sb_ptr->quantized_coeff;
                         write_sb(context_ptr,
@@ -418,10 +420,7 @@ void *entropy_coding_kernel(void *input_ptr) {
                                  tile_idx,
                                  pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr,
                                  coeff_picture_ptr);
-                        sb_ptr->total_bits = (pcs_ptr->entropy_coding_info[tile_idx]
-                                                  ->entropy_coder_ptr->ec_writer.ec.offs -
-                                              prev_pos)
-                            << 3;
+                        sb_ptr->total_bits = (uint32_t)(svt_od_ec_enc_tell(ec) - prev_bits);
 
                         pcs_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->total_bits;
                         row_total_bits += sb_ptr->total_bits;
@@ -463,6 +462,10 @@ void *entropy_coding_kernel(void *input_ptr) {
                         // Current tile ready
                         encode_slice_finish(
                             pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr);
+                        // sent before the tile is marked done, so that the
+                        // picture is not packetized before its fragments
+                        if (scs_ptr->static_config.tile_group_output && tile_idx < tile_cnt - 1)
+                            post_tile_group_fragment(pcs_ptr, tile_idx);
 
                         svt_block_on_mutex(pcs_ptr->entropy_coding_pic_mutex);
                         pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_tile_done = EB_TRUE;
@@ -14,6 +14,7 @@
 
 #include "EbMotionEstimationContext.h"
 #include "EbUtility.h"
+#include "EbTemporalFiltering.h"
 
 void motion_estimation_pred_unit_ctor(MePredUnit *pu) {
     pu->distortion = 0xFFFFFFFFull;
@@ -31,6 +32,7 @@ static void me_context_dctor(EbPtr p) {
     EB_FREE_ARRAY(obj->p_eight_pos_sad16x16);
     EB_FREE_ALIGNED_ARRAY(obj->sixteenth_sb_buffer);
     EB_FREE_ALIGNED_ARRAY(obj->sb_buffer);
+    EB_DELETE(obj->tf_arena_ptr);
 }
 EbErrorType me_context_ctor(MeContext *object_ptr) {
     uint32_t pu_index;
@@ -60,6 +62,7 @@ EbErrorType me_context_ctor(MeContext *object_ptr) {
     }
     EB_MALLOC_ARRAY(object_ptr->p_eight_pos_sad16x16,
                     8 * 16); //16= 16 16x16 blocks in a SB.       8=8search points
+    EB_NEW(object_ptr->tf_arena_ptr, svt_arena_ctor, BLK_PELS * COLOR_CHANNELS * sizeof(uint16_t));
 
     // Initialize Alt-Ref parameters
     object_ptr->me_type                     = ME_CLOSE_LOOP;
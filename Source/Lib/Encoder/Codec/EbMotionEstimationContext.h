@@ -16,6 +16,7 @@
 #include "EbMdRateEstimation.h"
 #include "EbCodingUnit.h"
 #include "EbObject.h"
+#include "EbArena.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -456,6 +457,8 @@ typedef struct MeContext {
     int          tf_block_row;
     int          tf_block_col;
     uint16_t     min_frame_size;
+    // scratch buffers of a temporal filtering segment
+    EbArena *tf_arena_ptr;
     // -------
 } MeContext;
 
@@ -15,6 +15,7 @@
 #include "EbUtility.h"
 #include "EbPictureControlSet.h"
 #include "EbPictureDecisionResults.h"
+#include "EbPictureDecisionProcess.h"
 #include "EbMotionEstimationProcess.h"
 #include "EbMotionEstimationResults.h"
 #include "EbReferenceObject.h"
@@ -745,6 +746,9 @@ void *motion_estimation_kernel(void *input_ptr) {
         PictureParentControlSet *pcs_ptr = (PictureParentControlSet *)
                                                in_results_ptr->pcs_wrapper_ptr->object_ptr;
         SequenceControlSet * scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+        // The mini-GOP is posted again once its temporal filtering is done
+        if (in_results_ptr->task_type == 0 && svt_me_gate_hold(pcs_ptr, in_results_wrapper_ptr))
+            continue;
         context_ptr->me_context_ptr->me_type =
             in_results_ptr->task_type == 1 ? ME_MCTF :
             in_results_ptr->task_type == 0 ? ME_OPEN_LOOP : ME_FIRST_PASS;
@@ -0,0 +1,109 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#include <stdlib.h>
+#include "EbOutputBufferPool.h"
+#include "EbThreads.h"
+
+static void svt_output_buffer_pool_dctor(EbPtr p) {
+    EbOutputBufferPool *obj = (EbOutputBufferPool *)p;
+    // The buffers belong to the application
+    EB_FREE_ARRAY(obj->buffer_array);
+    EB_FREE_ARRAY(obj->size_array);
+    EB_DESTROY_MUTEX(obj->mutex);
+}
+
+EbErrorType svt_output_buffer_pool_ctor(EbOutputBufferPool *pool_ptr) {
+    pool_ptr->dctor = svt_output_buffer_pool_dctor;
+    EB_CREATE_MUTEX(pool_ptr->mutex);
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_output_buffer_pool_add(EbOutputBufferPool *pool_ptr, uint8_t *buffer,
+                                       uint32_t size) {
+    EbErrorType return_error = EB_ErrorNone;
+    uint8_t **  buffer_array;
+    uint32_t *  size_array;
+
+    svt_block_on_mutex(pool_ptr->mutex);
+    EB_NO_THROW_MALLOC(buffer_array, sizeof(*buffer_array) * (pool_ptr->buffer_count + 1));
+    EB_NO_THROW_MALLOC(size_array, sizeof(*size_array) * (pool_ptr->buffer_count + 1));
+    if (buffer_array && size_array) {
+        for (uint32_t i = 0; i < pool_ptr->free_count; i++) {
+            buffer_array[i] = pool_ptr->buffer_array[i];
+            size_array[i]   = pool_ptr->size_array[i];
+        }
+        buffer_array[pool_ptr->free_count] = buffer;
+        size_array[pool_ptr->free_count]   = size;
+        EB_FREE_ARRAY(pool_ptr->buffer_array);
+        EB_FREE_ARRAY(pool_ptr->size_array);
+        pool_ptr->buffer_array = buffer_array;
+        pool_ptr->size_array   = size_array;
+        pool_ptr->free_count++;
+        pool_ptr->buffer_count++;
+        pool_ptr->enabled = EB_TRUE;
+    } else {
+        EB_FREE_ARRAY(buffer_array);
+        EB_FREE_ARRAY(size_array);
+        return_error = EB_ErrorInsufficientResources;
+    }
+    svt_release_mutex(pool_ptr->mutex);
+    return return_error;
+}
+
+uint8_t *svt_output_buffer_pool_take(EbOutputBufferPool *pool_ptr, uint32_t min_size,
+                                     uint32_t *size_ptr) {
+    uint8_t *buffer = NULL;
+    uint32_t best   = 0;
+
+    svt_block_on_mutex(pool_ptr->mutex);
+    for (uint32_t i = 0; i < pool_ptr->free_count; i++) {
+        if (pool_ptr->size_array[i] >= min_size &&
+            (!buffer || pool_ptr->size_array[i] < pool_ptr->size_array[best])) {
+            buffer = pool_ptr->buffer_array[i];
+            best   = i;
+        }
+    }
+    if (buffer) {
+        *size_ptr = pool_ptr->size_array[best];
+        pool_ptr->free_count--;
+        pool_ptr->buffer_array[best] = pool_ptr->buffer_array[pool_ptr->free_count];
+        pool_ptr->size_array[best]   = pool_ptr->size_array[pool_ptr->free_count];
+    }
+    svt_release_mutex(pool_ptr->mutex);
+    return buffer;
+}
+
+void svt_output_buffer_pool_give_back(EbOutputBufferPool *pool_ptr, uint8_t *buffer,
+                                      uint32_t size) {
+    svt_block_on_mutex(pool_ptr->mutex);
+    pool_ptr->buffer_array[pool_ptr->free_count] = buffer;
+    pool_ptr->size_array[pool_ptr->free_count]   = size;
+    pool_ptr->free_count++;
+    svt_release_mutex(pool_ptr->mutex);
+}
+
+void svt_output_stream_buffer_release(EbPtr context_ptr, EbObjectWrapper *wrapper_ptr) {
+    EbOutputBufferPool *  pool_ptr   = (EbOutputBufferPool *)context_ptr;
+    EbOutputStreamBuffer *stream_ptr = (EbOutputStreamBuffer *)wrapper_ptr->object_ptr;
+
+    if (stream_ptr->is_pool_buffer) {
+        svt_output_buffer_pool_give_back(
+            pool_ptr, stream_ptr->header.p_buffer, stream_ptr->header.n_alloc_len);
+        stream_ptr->is_pool_buffer = EB_FALSE;
+    }
+    if (!pool_ptr->enabled) {
+        EB_FREE(stream_ptr->staging_buffer);
+        stream_ptr->staging_size = 0;
+    }
+    stream_ptr->header.p_buffer    = NULL;
+    stream_ptr->header.n_alloc_len = 0;
+}
@@ -0,0 +1,71 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbOutputBufferPool_h
+#define EbOutputBufferPool_h
+
+#include "EbDefinitions.h"
+#include "EbSvtAv1Enc.h"
+#include "EbSystemResourceManager.h"
+#include "EbObject.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+/************************************************
+     * Output Stream Buffer
+     *   Object of the output stream resource. Packetization writes each
+     *   frame to the staging buffer, which the encoder owns; p_buffer of
+     *   the header points either to it or to a buffer of the pool.
+     ************************************************/
+typedef struct EbOutputStreamBuffer {
+    EbBufferHeaderType header; // first member, the packet handed to the application
+    uint8_t *          staging_buffer;
+    uint32_t           staging_size;
+    EbBool             is_pool_buffer; // header.p_buffer was taken from the pool
+} EbOutputStreamBuffer;
+
+/************************************************
+     * Output Buffer Pool
+     *   Application buffers registered through svt_av1_enc_add_output_buffer.
+     *   The arrays hold the free buffers; their capacity is the number of
+     *   registered buffers, so returning a buffer never reallocates.
+     ************************************************/
+typedef struct EbOutputBufferPool {
+    EbDctor   dctor;
+    EbHandle  mutex;
+    uint8_t **buffer_array;
+    uint32_t *size_array;
+    uint32_t  free_count;
+    uint32_t  buffer_count;
+    // Set once the first buffer is registered; staging buffers are then
+    // kept across packets instead of being freed with each packet
+    EbBool enabled;
+} EbOutputBufferPool;
+
+extern EbErrorType svt_output_buffer_pool_ctor(EbOutputBufferPool *pool_ptr);
+
+extern EbErrorType svt_output_buffer_pool_add(EbOutputBufferPool *pool_ptr, uint8_t *buffer,
+                                              uint32_t size);
+
+/* Takes the smallest free buffer of at least min_size bytes, NULL if none */
+extern uint8_t *svt_output_buffer_pool_take(EbOutputBufferPool *pool_ptr, uint32_t min_size,
+                                            uint32_t *size_ptr);
+
+extern void svt_output_buffer_pool_give_back(EbOutputBufferPool *pool_ptr, uint8_t *buffer,
+                                             uint32_t size);
+
+/* Release callback of the output stream resources, context_ptr is the pool */
+extern void svt_output_stream_buffer_release(EbPtr context_ptr, EbObjectWrapper *wrapper_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //EbOutputBufferPool_h
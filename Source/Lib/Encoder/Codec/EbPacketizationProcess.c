@@ -507,11 +507,180 @@ static void collect_frames_info(PacketizationContext* context_ptr, const EncodeC
 
 #define TD_SIZE 2
 
+/* Points the packet at the smallest free application buffer holding size bytes, if any */
+static EbBool use_pool_buffer(EncodeContext *encode_context_ptr,
+                              EbBufferHeaderType *output_stream_ptr, uint32_t size) {
+    EbOutputBufferPool *pool_ptr = encode_context_ptr->output_buffer_pool_ptr;
+    uint32_t            pool_size;
+    uint8_t *           buffer;
+
+    if (!pool_ptr->enabled)
+        return EB_FALSE;
+    buffer = svt_output_buffer_pool_take(pool_ptr, size, &pool_size);
+    if (!buffer)
+        return EB_FALSE;
+    output_stream_ptr->p_buffer    = buffer;
+    output_stream_ptr->n_alloc_len = pool_size;
+    ((EbOutputStreamBuffer *)output_stream_ptr)->is_pool_buffer = EB_TRUE;
+    return EB_TRUE;
+}
+
+/* Low-latency mode: the packet carries the end of sequence when it is the last
+ * one after the EOS input, else resource coordination sends it on its own */
+static void post_low_latency_packet(EncodeContext *  encode_context_ptr,
+                                    EbObjectWrapper *output_stream_wrapper_ptr, uint32_t frames) {
+    EbBufferHeaderType *output_stream_ptr = (EbBufferHeaderType *)output_stream_wrapper_ptr->object_ptr;
+
+    svt_block_on_mutex(encode_context_ptr->low_latency_eos_mutex);
+    encode_context_ptr->low_latency_packet_count += frames;
+    if (encode_context_ptr->low_latency_eos_received &&
+        encode_context_ptr->low_latency_packet_count == encode_context_ptr->low_latency_picture_count)
+        output_stream_ptr->flags |= EB_BUFFERFLAG_EOS;
+    // posted in the lock so that the EOS is the last packet
+    svt_post_full_object(output_stream_wrapper_ptr);
+    svt_release_mutex(encode_context_ptr->low_latency_eos_mutex);
+}
+
+/* Points p_buffer at the staging buffer of the object, grown to n_alloc_len bytes.
+   The staging buffer is kept across packets once the output buffer pool is in use. */
+static inline EbErrorType malloc_p_buffer(EbBufferHeaderType *output_stream_ptr) {
+    EbOutputStreamBuffer *stream_ptr = (EbOutputStreamBuffer *)output_stream_ptr;
+    if (stream_ptr->staging_size < output_stream_ptr->n_alloc_len) {
+        EB_FREE(stream_ptr->staging_buffer);
+        stream_ptr->staging_size = 0;
+        EB_MALLOC(stream_ptr->staging_buffer, output_stream_ptr->n_alloc_len);
+        stream_ptr->staging_size = output_stream_ptr->n_alloc_len;
+    }
+    output_stream_ptr->p_buffer    = stream_ptr->staging_buffer;
+    output_stream_ptr->n_alloc_len = stream_ptr->staging_size;
+    return EB_ErrorNone;
+}
+
+// obu header, obu size and tile group header of a tile group OBU
+#define TILE_GROUP_OBU_OVERHEAD 16
+
+/* Writes the tile group OBU of tile_idx to dst, returns its size */
+static uint32_t write_tile_group_to_buffer(PictureControlSet *pcs_ptr, uint16_t tile_idx,
+                                           uint8_t *dst, uint32_t size) {
+    OutputBitstreamUnit output_bitstream = {NULL, size, dst, dst};
+    Bitstream           bitstream        = {NULL, &output_bitstream};
+    write_tile_group_av1(&bitstream, pcs_ptr, tile_idx);
+    return (uint32_t)bitstream_get_bytes_count(&bitstream);
+}
+
+/* Tile group output: posts in decode order the fragments coded so far. The
+ * last tile group of a picture is its packet, posted by post_tile_group_tail().
+ * Called with tile_group_mutex held. */
+static void post_ready_tile_groups(EncodeContext *encode_context_ptr, uint16_t tile_cnt) {
+    EbObjectWrapper **fragments = encode_context_ptr->tile_group_fragments +
+        encode_context_ptr->tile_group_decode_order % PACKETIZATION_REORDER_QUEUE_MAX_DEPTH *
+            encode_context_ptr->tile_group_stride;
+    while (encode_context_ptr->tile_group_tile_index < tile_cnt - 1 &&
+           fragments[encode_context_ptr->tile_group_tile_index]) {
+        svt_post_full_object(fragments[encode_context_ptr->tile_group_tile_index]);
+        fragments[encode_context_ptr->tile_group_tile_index++] = NULL;
+    }
+}
+
+void post_tile_group_fragment(PictureControlSet *pcs_ptr, uint16_t tile_idx) {
+    SequenceControlSet *     scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EncodeContext *          encode_context_ptr = scs_ptr->encode_context_ptr;
+    PictureParentControlSet *ppcs_ptr           = pcs_ptr->parent_pcs_ptr;
+    Av1Common *const         cm                 = ppcs_ptr->av1_cm;
+    const uint16_t           tile_cnt = cm->tiles_info.tile_rows * cm->tiles_info.tile_cols;
+    Bitstream *              bitstream_ptr = pcs_ptr->bitstream_ptr;
+    uint32_t                 header_size   = 0;
+    EbObjectWrapper *        output_stream_wrapper_ptr;
+
+    // the headers go with the first tile group, the packetization of the
+    // picture only writes the last tile group then
+    if (tile_idx == 0) {
+        bitstream_reset(bitstream_ptr);
+        if (ppcs_ptr->frm_hdr.frame_type == KEY_FRAME) {
+            encode_sps_av1(bitstream_ptr, scs_ptr);
+            write_metadata_av1(
+                bitstream_ptr, ppcs_ptr->input_ptr->metadata, EB_AV1_METADATA_TYPE_HDR_CLL);
+            write_metadata_av1(
+                bitstream_ptr, ppcs_ptr->input_ptr->metadata, EB_AV1_METADATA_TYPE_HDR_MDCV);
+        }
+        write_metadata_av1(
+            bitstream_ptr, ppcs_ptr->input_ptr->metadata, EB_AV1_METADATA_TYPE_ITUT_T35);
+        svt_metadata_array_free(&ppcs_ptr->input_ptr->metadata);
+        write_frame_header_obu_av1(bitstream_ptr, scs_ptr, pcs_ptr);
+        header_size = TD_SIZE + bitstream_get_bytes_count(bitstream_ptr);
+    }
+
+    svt_get_empty_object(encode_context_ptr->stream_output_fifo_ptr, &output_stream_wrapper_ptr);
+    EbBufferHeaderType *output_stream_ptr = (EbBufferHeaderType *)
+                                                output_stream_wrapper_ptr->object_ptr;
+    output_stream_ptr->flags = EB_BUFFERFLAG_FRAGMENT | (tile_idx ? 0 : EB_BUFFERFLAG_HAS_TD);
+    output_stream_ptr->pts   = ppcs_ptr->input_ptr->pts;
+    output_stream_ptr->dts   = output_stream_ptr->pts;
+    output_stream_ptr->pic_type =
+        ppcs_ptr->is_used_as_reference_flag
+            ? ppcs_ptr->idr_flag ? EB_AV1_KEY_PICTURE : pcs_ptr->slice_type
+            : EB_AV1_NON_REF_PICTURE;
+    output_stream_ptr->p_app_private = NULL;
+    output_stream_ptr->qp            = ppcs_ptr->picture_qp;
+    output_stream_ptr->n_tick_count  = 0;
+    output_stream_ptr->luma_sse      = 0;
+    output_stream_ptr->cr_sse        = 0;
+    output_stream_ptr->cb_sse        = 0;
+    output_stream_ptr->luma_ssim     = 0;
+    output_stream_ptr->cr_ssim       = 0;
+    output_stream_ptr->cb_ssim       = 0;
+    output_stream_ptr->n_alloc_len   = header_size +
+        pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr->ec_writer.pos +
+        TILE_GROUP_OBU_OVERHEAD;
+    if (!use_pool_buffer(encode_context_ptr, output_stream_ptr, output_stream_ptr->n_alloc_len))
+        malloc_p_buffer(output_stream_ptr);
+
+    uint8_t *dst = output_stream_ptr->p_buffer;
+    if (tile_idx == 0) {
+        encode_td_av1(dst);
+        bitstream_copy(bitstream_ptr, dst + TD_SIZE, header_size - TD_SIZE);
+        dst += header_size;
+    }
+    output_stream_ptr->n_filled_len = header_size +
+        write_tile_group_to_buffer(
+            pcs_ptr, tile_idx, dst, output_stream_ptr->n_alloc_len - header_size);
+
+    svt_block_on_mutex(encode_context_ptr->tile_group_mutex);
+    encode_context_ptr->tile_group_fragments[ppcs_ptr->decode_order %
+                                             PACKETIZATION_REORDER_QUEUE_MAX_DEPTH *
+                                             encode_context_ptr->tile_group_stride +
+                                             tile_idx] = output_stream_wrapper_ptr;
+    post_ready_tile_groups(encode_context_ptr, tile_cnt);
+    svt_release_mutex(encode_context_ptr->tile_group_mutex);
+}
+
+/* Tile group output: posts the packet of the picture holding its last tile
+ * group once its fragments are out, then the fragments of the next picture.
+ * A picture with a single tile has no fragment, its packet is the whole
+ * frame but it still takes its turn in the decode order of the fragments. */
+static void post_tile_group_tail(EncodeContext *encode_context_ptr,
+                                 EbObjectWrapper *output_stream_wrapper_ptr, uint16_t tile_cnt) {
+    svt_block_on_mutex(encode_context_ptr->tile_group_mutex);
+    // every tile is coded, the fragments of the picture are all ready
+    post_ready_tile_groups(encode_context_ptr, tile_cnt);
+    assert(encode_context_ptr->tile_group_tile_index == tile_cnt - 1);
+    post_low_latency_packet(encode_context_ptr, output_stream_wrapper_ptr, 1);
+    encode_context_ptr->tile_group_decode_order++;
+    encode_context_ptr->tile_group_tile_index = 0;
+    post_ready_tile_groups(encode_context_ptr, tile_cnt);
+    svt_release_mutex(encode_context_ptr->tile_group_mutex);
+}
+
 //a tu start with a td, + 0 more not displable frame, + 1 display frame
 static EbErrorType encode_tu(EncodeContext *encode_context_ptr, int frames, uint32_t total_bytes,
                              EbBufferHeaderType *output_stream_ptr) {
+    EbOutputStreamBuffer *stream_ptr = (EbOutputStreamBuffer *)output_stream_ptr;
+    // a frame alone in its tu is already in an application buffer, td included
+    if (output_stream_ptr->flags & EB_BUFFERFLAG_HAS_TD)
+        return EB_ErrorNone;
     total_bytes += TD_SIZE;
-    if (total_bytes > output_stream_ptr->n_alloc_len) {
+    if (!use_pool_buffer(encode_context_ptr, output_stream_ptr, total_bytes) &&
+        total_bytes > output_stream_ptr->n_alloc_len) {
         uint8_t *pbuff;
         EB_MALLOC(pbuff, total_bytes);
         if (!pbuff) {
@@ -522,19 +691,22 @@ static EbErrorType encode_tu(EncodeContext *encode_context_ptr, int frames, uint
                   output_stream_ptr->p_buffer,
                   output_stream_ptr->n_alloc_len > total_bytes ? total_bytes
                                                                : output_stream_ptr->n_alloc_len);
-        EB_FREE(output_stream_ptr->p_buffer);
+        EB_FREE(stream_ptr->staging_buffer);
+        stream_ptr->staging_buffer     = pbuff;
+        stream_ptr->staging_size       = total_bytes;
         output_stream_ptr->p_buffer    = pbuff;
         output_stream_ptr->n_alloc_len = total_bytes;
     }
     uint8_t *dst                    = output_stream_ptr->p_buffer + total_bytes;
     //we use last frame's output_stream_ptr to hold entire tu, so we need copy backward.
+    //the frames are in the staging buffers, the tu may go to an application buffer.
     for (int i = frames - 1; i >= 0; i--) {
         PacketizationReorderEntry *queue_entry_ptr = get_reorder_queue_entry(encode_context_ptr, i);
         EbObjectWrapper* wrapper = queue_entry_ptr->output_stream_wrapper_ptr;
-        EbBufferHeaderType *       src_stream_ptr = (EbBufferHeaderType *)wrapper->object_ptr;
-        uint32_t size = src_stream_ptr->n_filled_len;
+        EbOutputStreamBuffer *     src_stream_ptr = (EbOutputStreamBuffer *)wrapper->object_ptr;
+        uint32_t size = src_stream_ptr->header.n_filled_len;
         dst -= size;
-        memmove(dst, src_stream_ptr->p_buffer, size);
+        memmove(dst, src_stream_ptr->staging_buffer, size);
         //1. The last frame is a displayable frame, others are undisplayed.
         //2. We do not push alt ref frame since the overlay frame will carry the pts.
         if (i != frames - 1 && !queue_entry_ptr->is_alt_ref)
@@ -568,6 +740,10 @@ static EbErrorType copy_data_from_bitstream(EncodeContext *encode_context_ptr, B
 static void encode_show_existing(EncodeContext *encode_context_ptr,
                                  PacketizationReorderEntry *queue_entry_ptr,
                                  EbBufferHeaderType        *output_stream_ptr) {
+    // copy_data_from_bitstream keeps one byte spare
+    use_pool_buffer(encode_context_ptr,
+                    output_stream_ptr,
+                    TD_SIZE + bitstream_get_bytes_count(queue_entry_ptr->bitstream_ptr) + 1);
     uint8_t* dst = output_stream_ptr->p_buffer;
 
     encode_td_av1(dst);
@@ -599,12 +775,6 @@ inline static void set_eos_flag(EbBufferHeaderType *output_stream_ptr) {
     output_stream_ptr->flags |= EB_BUFFERFLAG_EOS;
 }
 
-/* Wrapper function to capture the return of EB_MALLOC */
-static inline EbErrorType malloc_p_buffer(EbBufferHeaderType *output_stream_ptr) {
-    EB_MALLOC(output_stream_ptr->p_buffer, output_stream_ptr->n_alloc_len);
-    return EB_ErrorNone;
-}
-
 /* Realloc when bitstream pointer size is not enough to write data of size sz */
 static EbErrorType realloc_output_bitstream(Bitstream *bitstream_ptr, uint32_t sz) {
     if (bitstream_ptr && sz > 0) {
@@ -735,52 +905,77 @@ void *packetization_kernel(void *input_ptr) {
             picture_manager_results_ptr->decode_order = pcs_ptr->parent_pcs_ptr->decode_order;
             picture_manager_results_ptr->scs_wrapper_ptr = pcs_ptr->scs_wrapper_ptr;
         }
-        // Reset the Bitstream before writing to it
-        bitstream_reset(pcs_ptr->bitstream_ptr);
-
-        size_t metadata_sz = 0;
-
-        // Code the SPS
-        if (frm_hdr->frame_type == KEY_FRAME) {
-            encode_sps_av1(pcs_ptr->bitstream_ptr, scs_ptr);
-            // Add CLL and MDCV meta when frame is keyframe and SPS is written
-            write_metadata_av1(pcs_ptr->bitstream_ptr,
-                               pcs_ptr->parent_pcs_ptr->input_ptr->metadata,
-                               EB_AV1_METADATA_TYPE_HDR_CLL);
-            write_metadata_av1(pcs_ptr->bitstream_ptr,
-                               pcs_ptr->parent_pcs_ptr->input_ptr->metadata,
-                               EB_AV1_METADATA_TYPE_HDR_MDCV);
-        }
-
-        if (frm_hdr->show_frame) {
-            // Add HDR10+ dynamic metadata when show frame flag is enabled
-            write_metadata_av1(pcs_ptr->bitstream_ptr,
-                               pcs_ptr->parent_pcs_ptr->input_ptr->metadata,
-                               EB_AV1_METADATA_TYPE_ITUT_T35);
-            svt_metadata_array_free(&pcs_ptr->parent_pcs_ptr->input_ptr->metadata);
+        // Tile group output: the headers and the other tile groups are sent in
+        // fragments by the entropy coding, the packet holds the last tile group
+        const EbBool tile_group_tail = scs_ptr->static_config.tile_group_output && tile_cnt > 1;
+        if (tile_group_tail) {
+            output_stream_ptr->n_alloc_len =
+                pcs_ptr->entropy_coding_info[tile_cnt - 1]->entropy_coder_ptr->ec_writer.pos +
+                TILE_GROUP_OBU_OVERHEAD;
+            if (!use_pool_buffer(
+                    encode_context_ptr, output_stream_ptr, output_stream_ptr->n_alloc_len))
+                malloc_p_buffer(output_stream_ptr);
+            output_stream_ptr->n_filled_len = write_tile_group_to_buffer(
+                pcs_ptr, tile_cnt - 1, output_stream_ptr->p_buffer, output_stream_ptr->n_alloc_len);
         } else {
-            // Copy metadata pointer to the queue entry related to current frame number
-            uint64_t                   current_picture_number = pcs_ptr->picture_number;
-            PacketizationReorderEntry *temp_entry =
-                encode_context_ptr
-                    ->packetization_reorder_queue[current_picture_number %
-                                                  PACKETIZATION_REORDER_QUEUE_MAX_DEPTH];
-            temp_entry->metadata = pcs_ptr->parent_pcs_ptr->input_ptr->metadata;
-            pcs_ptr->parent_pcs_ptr->input_ptr->metadata = NULL;
-            metadata_sz = svt_metadata_size(temp_entry->metadata, EB_AV1_METADATA_TYPE_ITUT_T35);
-        }
-
-        write_frame_header_av1(pcs_ptr->bitstream_ptr, scs_ptr, pcs_ptr, 0);
-
-        output_stream_ptr->n_alloc_len = (uint32_t)(
-            bitstream_get_bytes_count(pcs_ptr->bitstream_ptr) + TD_SIZE + metadata_sz);
-        malloc_p_buffer(output_stream_ptr);
+            // Reset the Bitstream before writing to it
+            bitstream_reset(pcs_ptr->bitstream_ptr);
+
+            size_t metadata_sz = 0;
+
+            // Code the SPS
+            if (frm_hdr->frame_type == KEY_FRAME) {
+                encode_sps_av1(pcs_ptr->bitstream_ptr, scs_ptr);
+                // Add CLL and MDCV meta when frame is keyframe and SPS is written
+                write_metadata_av1(pcs_ptr->bitstream_ptr,
+                                   pcs_ptr->parent_pcs_ptr->input_ptr->metadata,
+                                   EB_AV1_METADATA_TYPE_HDR_CLL);
+                write_metadata_av1(pcs_ptr->bitstream_ptr,
+                                   pcs_ptr->parent_pcs_ptr->input_ptr->metadata,
+                                   EB_AV1_METADATA_TYPE_HDR_MDCV);
+            }
 
-        assert(output_stream_ptr->p_buffer != NULL && "bit-stream memory allocation failure");
+            if (frm_hdr->show_frame) {
+                // Add HDR10+ dynamic metadata when show frame flag is enabled
+                write_metadata_av1(pcs_ptr->bitstream_ptr,
+                                   pcs_ptr->parent_pcs_ptr->input_ptr->metadata,
+                                   EB_AV1_METADATA_TYPE_ITUT_T35);
+                svt_metadata_array_free(&pcs_ptr->parent_pcs_ptr->input_ptr->metadata);
+            } else {
+                // Copy metadata pointer to the queue entry related to current frame number
+                uint64_t                   current_picture_number = pcs_ptr->picture_number;
+                PacketizationReorderEntry *temp_entry =
+                    encode_context_ptr
+                        ->packetization_reorder_queue[current_picture_number %
+                                                      PACKETIZATION_REORDER_QUEUE_MAX_DEPTH];
+                temp_entry->metadata = pcs_ptr->parent_pcs_ptr->input_ptr->metadata;
+                pcs_ptr->parent_pcs_ptr->input_ptr->metadata = NULL;
+                metadata_sz = svt_metadata_size(temp_entry->metadata, EB_AV1_METADATA_TYPE_ITUT_T35);
+            }
 
-        copy_data_from_bitstream(encode_context_ptr,
-                    pcs_ptr->bitstream_ptr,
-                    output_stream_ptr);
+            write_frame_header_av1(pcs_ptr->bitstream_ptr, scs_ptr, pcs_ptr, 0);
+
+            output_stream_ptr->n_alloc_len = (uint32_t)(
+                bitstream_get_bytes_count(pcs_ptr->bitstream_ptr) + TD_SIZE + metadata_sz);
+            // A shown frame at the head of the queue is a temporal unit on its
+            // own, it goes with its td straight into an application buffer.
+            // copy_data_from_bitstream keeps one byte spare
+            if (frm_hdr->show_frame &&
+                queue_entry_ptr == get_reorder_queue_entry(encode_context_ptr, 0) &&
+                use_pool_buffer(
+                    encode_context_ptr, output_stream_ptr, output_stream_ptr->n_alloc_len + 1)) {
+                encode_td_av1(output_stream_ptr->p_buffer);
+                output_stream_ptr->n_filled_len = TD_SIZE;
+                output_stream_ptr->flags |= EB_BUFFERFLAG_HAS_TD;
+            } else
+                malloc_p_buffer(output_stream_ptr);
+
+            assert(output_stream_ptr->p_buffer != NULL && "bit-stream memory allocation failure");
+
+            copy_data_from_bitstream(encode_context_ptr,
+                        pcs_ptr->bitstream_ptr,
+                        output_stream_ptr);
+        }
 
         if (pcs_ptr->parent_pcs_ptr->has_show_existing) {
             uint64_t                   next_picture_number = pcs_ptr->picture_number + 1;
@@ -806,7 +1001,10 @@ void *packetization_kernel(void *input_ptr) {
         }
 
         // Send the number of bytes per frame to RC
-        pcs_ptr->parent_pcs_ptr->total_num_bits = output_stream_ptr->n_filled_len << 3;
+        pcs_ptr->parent_pcs_ptr->total_num_bits =
+            (output_stream_ptr->n_filled_len -
+             (output_stream_ptr->flags & EB_BUFFERFLAG_HAS_TD ? TD_SIZE : 0))
+            << 3;
         queue_entry_ptr->total_num_bits         = pcs_ptr->parent_pcs_ptr->total_num_bits;
         if (scs_ptr->static_config.rate_control_mode && !use_input_stat(scs_ptr) && !scs_ptr->lap_enabled)
             // update the rate tables used in RC based on the encoded bits of each sb
@@ -828,6 +1026,7 @@ void *packetization_kernel(void *input_ptr) {
         queue_entry_ptr->show_frame          = frm_hdr->show_frame;
         queue_entry_ptr->has_show_existing   = pcs_ptr->parent_pcs_ptr->has_show_existing;
         queue_entry_ptr->show_existing_frame = frm_hdr->show_existing_frame;
+        queue_entry_ptr->tile_cnt            = tile_cnt;
 
         //Store the output buffer in the Queue
         queue_entry_ptr->output_stream_wrapper_ptr = output_stream_wrapper_ptr;
@@ -889,12 +1088,20 @@ void *packetization_kernel(void *input_ptr) {
             output_stream_ptr         = (EbBufferHeaderType *)output_stream_wrapper_ptr->object_ptr;
             EbBool eos                = output_stream_ptr->flags &  EB_BUFFERFLAG_EOS;
 
-            encode_tu(encode_context_ptr, frames, total_bytes, output_stream_ptr);
+            const EbBool tile_groups = scs_ptr->static_config.tile_group_output;
+            if (!tile_groups || queue_entry_ptr->tile_cnt == 1)
+                encode_tu(encode_context_ptr, frames, total_bytes, output_stream_ptr);
 
             if (eos && queue_entry_ptr->has_show_existing)
                 clear_eos_flag(output_stream_ptr);
 
-            svt_post_full_object(output_stream_wrapper_ptr);
+            if (tile_groups)
+                post_tile_group_tail(
+                    encode_context_ptr, output_stream_wrapper_ptr, queue_entry_ptr->tile_cnt);
+            else if (scs_ptr->static_config.max_frames_in_flight)
+                post_low_latency_packet(encode_context_ptr, output_stream_wrapper_ptr, frames);
+            else
+                svt_post_full_object(output_stream_wrapper_ptr);
             if (queue_entry_ptr->has_show_existing) {
                 EbObjectWrapper *existed = pop_undisplayed_frame(encode_context_ptr);
                 if (existed) {
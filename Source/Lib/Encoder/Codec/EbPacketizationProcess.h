@@ -25,6 +25,11 @@ EbErrorType packetization_context_ctor(EbThreadContext *  thread_context_ptr,
                                        int demux_index);
 
 extern void *packetization_kernel(void *input_ptr);
+
+/* Tile group output: codes the fragment of tile_idx once the tile is entropy
+ * coded, and sends the fragments ready in decode order */
+struct PictureControlSet;
+void post_tile_group_fragment(struct PictureControlSet *pcs_ptr, uint16_t tile_idx);
 #ifdef __cplusplus
 }
 #endif
@@ -50,6 +50,8 @@ typedef struct PacketizationReorderEntry {
     int64_t next_pts;
     uint8_t is_alt_ref;
     struct SvtMetadataArray *metadata;
+    //tiles of the picture, with tile group output the packet holds the last one
+    uint16_t tile_cnt;
 } PacketizationReorderEntry;
 
 extern EbErrorType packetization_reorder_entry_ctor(PacketizationReorderEntry *entry_ptr,
@@ -183,6 +183,9 @@ void picture_control_set_dctor(EbPtr p) {
     EB_DESTROY_MUTEX(obj->entropy_coding_pic_mutex);
     EB_DESTROY_MUTEX(obj->intra_mutex);
     EB_DESTROY_MUTEX(obj->cdef_search_mutex);
+    EB_DESTROY_MUTEX(obj->dlf_segments_mutex);
+    EB_DESTROY_MUTEX(obj->sb_row_mutex);
+    EB_FREE_ARRAY(obj->sb_row_coded_count);
     EB_DESTROY_MUTEX(obj->rest_search_mutex);
 }
 // Token buffer is only used for palette tokens.
@@ -1015,6 +1018,9 @@ EbErrorType picture_control_set_ctor(PictureControlSet *object_ptr, EbPtr object
     EB_CREATE_MUTEX(object_ptr->intra_mutex);
 
     EB_CREATE_MUTEX(object_ptr->cdef_search_mutex);
+    EB_CREATE_MUTEX(object_ptr->dlf_segments_mutex);
+    EB_CREATE_MUTEX(object_ptr->sb_row_mutex);
+    EB_MALLOC_ARRAY(object_ptr->sb_row_coded_count, picture_sb_height);
 
     //object_ptr->mse_seg[0] = (uint64_t(*)[64])svt_aom_malloc(sizeof(**object_ptr->mse_seg) *  picture_sb_width * picture_sb_height);
     // object_ptr->mse_seg[1] = (uint64_t(*)[64])svt_aom_malloc(sizeof(**object_ptr->mse_seg) *  picture_sb_width * picture_sb_height);
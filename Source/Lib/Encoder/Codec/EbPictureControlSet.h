@@ -283,6 +283,22 @@ typedef struct PictureControlSet {
     uint8_t  cdef_segments_column_count;
     uint8_t  cdef_segments_row_count;
 
+    // Frame deblocking segments: bands of SB rows, then bands of SB columns
+    uint16_t dlf_vert_segments_count;
+    uint16_t dlf_horz_segments_count;
+    uint16_t dlf_segments_done_count;
+    EbHandle dlf_segments_mutex;
+
+    // SB row progress of EncDec. With sb_row_streaming, the CDEF segments
+    // of the leading SB rows are handed to DLF while EncDec codes the rows
+    // below, and cdef_segments_posted counts the CDEF segments posted
+    uint16_t *sb_row_coded_count;
+    uint16_t  sb_rows_coded;
+    uint16_t  cdef_segments_posted;
+    EbBool    sb_row_streaming;
+    EbBool    cdef_prep_done;
+    EbHandle  sb_row_mutex;
+
     uint64_t (*mse_seg[2])[TOTAL_STRENGTHS];
 
     uint16_t *src[3]; //dlfed recon in 16bit form
@@ -293,6 +309,11 @@ typedef struct PictureControlSet {
     uint16_t rest_segments_total_count;
     uint8_t  rest_segments_column_count;
     uint8_t  rest_segments_row_count;
+    // With rest_streaming, the restoration segments of the leading rows are
+    // handed to Rest while CDEF filters the rows below, and
+    // rest_segments_posted counts the ones posted
+    uint16_t rest_segments_posted;
+    EbBool   rest_streaming;
 
     // Slice Type
     EB_SLICE slice_type;
@@ -553,6 +574,7 @@ typedef struct PictureParentControlSet {
     EbBool          cra_flag;
     EbBool          scene_change_flag;
     EbBool          end_of_sequence_flag;
+    EbBool          config_change; // first picture after svt_av1_enc_reconfigure
     uint8_t         picture_qp;
     uint64_t        picture_number;
     uint32_t        cur_order_hint;
@@ -827,6 +849,12 @@ typedef struct PictureParentControlSet {
 
     uint8_t  temp_filt_prep_done;
     uint16_t temp_filt_seg_acc;
+    uint64_t tf_post_time; // when picture decision posted the segments, in microseconds
+    // Protected by the me_gate_mutex of the encode context
+    EbBool         tf_done; // the filtering of the picture completed
+    EbBool         tf_waited; // picture decision blocks on temp_filt_done_semaphore
+    struct MeGate *tf_gate_ptr; // mini-GOP released once the filtering is done
+    struct MeGate *me_gate_ptr; // mini-GOP the ME of the picture is held back on
     // TPL ME
     EbHandle     tpl_me_done_semaphore;
     EbHandle     tpl_me_mutex;
@@ -845,7 +873,7 @@ typedef struct PictureParentControlSet {
     uint8_t      num_tpl_processed;
     int16_t      tf_segments_total_count;
     uint8_t      tf_segments_column_count;
-    uint8_t      tf_segments_row_count;
+    uint16_t     tf_segments_row_count;
     uint8_t      past_altref_nframes;
     uint8_t      future_altref_nframes;
     EbBool       temporal_filtering_on;
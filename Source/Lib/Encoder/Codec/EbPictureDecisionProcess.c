@@ -32,6 +32,7 @@
 #include "common_dsp_rtcd.h"
 #include "EbResize.h"
 #include "EbMalloc.h"
+#include "EbPipelineStats.h"
 /************************************************
  * Defines
  ************************************************/
@@ -3738,7 +3739,9 @@ int32_t search_this_pic(PictureParentControlSet**buf, uint32_t buf_size, uint64_
 */
 EbBool is_delayed_intra(PictureParentControlSet *pcs) {
     if (pcs->idr_flag || pcs->cra_flag) {
-        if (pcs->scs_ptr->static_config.intra_period_length == 0 || pcs->end_of_sequence_flag)
+        // the low-latency mode sends the intra without waiting for the next mini-GOP
+        if (pcs->scs_ptr->static_config.intra_period_length == 0 || pcs->end_of_sequence_flag ||
+            pcs->scs_ptr->static_config.max_frames_in_flight)
             return 0;
         else if (pcs->idr_flag || (pcs->cra_flag && pcs->pre_assignment_buffer_count < pcs->pred_struct_ptr->pred_struct_period))
             return 1;
@@ -3786,8 +3789,228 @@ void process_first_pass_frame(
     svt_release_object(pcs_ptr->me_data_wrapper_ptr);
     pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
 }
+/*
+  Returns EB_TRUE when pcs_ptr is one of the pictures filtered by the pending pictures
+*/
+static EbBool tf_pending_uses_picture(
+    PictureDecisionContext  *context_ptr,
+    PictureParentControlSet *pcs_ptr)
+{
+    for (uint32_t pending_idx = 0; pending_idx < context_ptr->tf_pending_count; pending_idx++) {
+        PictureParentControlSet *pending_ptr = context_ptr->tf_pending_array[pending_idx];
+        for (int pic_i = 0; pic_i < pending_ptr->past_altref_nframes + pending_ptr->future_altref_nframes + 1; pic_i++)
+            if (pending_ptr->temp_filt_pcs_list[pic_i] == pcs_ptr)
+                return EB_TRUE;
+    }
+    return EB_FALSE;
+}
+/*
+  Waits for the temporal filtering of the pending pictures
+*/
+static void wait_tf_pending(
+    SequenceControlSet      *scs_ptr,
+    PictureDecisionContext  *context_ptr)
+{
+    if (context_ptr->tf_pending_count == 0)
+        return;
+    EncodeContext *encode_context_ptr = scs_ptr->encode_context_ptr;
+    const EbBool   stats_enabled      = scs_ptr->static_config.enable_pipeline_stats;
+    uint64_t       wait_start_time    = stats_enabled ? svt_pipeline_stats_time() : 0;
+    uint32_t       wait_count         = 0;
+    // The filtering only posts temp_filt_done_semaphore for the waited pictures
+    svt_block_on_mutex(encode_context_ptr->me_gate_mutex);
+    for (uint32_t pending_idx = 0; pending_idx < context_ptr->tf_pending_count; pending_idx++) {
+        PictureParentControlSet *pending_ptr = context_ptr->tf_pending_array[pending_idx];
+        if (!pending_ptr->tf_done) {
+            pending_ptr->tf_waited = EB_TRUE;
+            context_ptr->tf_pending_array[wait_count++] = pending_ptr;
+        }
+    }
+    svt_release_mutex(encode_context_ptr->me_gate_mutex);
+    for (uint32_t pending_idx = 0; pending_idx < wait_count; pending_idx++)
+        svt_block_on_semaphore(context_ptr->tf_pending_array[pending_idx]->temp_filt_done_semaphore);
+    context_ptr->tf_pending_count = 0;
+    if (stats_enabled) {
+        svt_block_on_mutex(encode_context_ptr->tf_stats_mutex);
+        encode_context_ptr->tf_wait_time += svt_pipeline_stats_time() - wait_start_time;
+        svt_release_mutex(encode_context_ptr->tf_stats_mutex);
+    }
+}
+/*
+  Copies the filtered input picture of a reference to its reference object
+  when there is no look ahead to do it
+*/
+static void copy_reference_input(
+    SequenceControlSet      *scs,
+    PictureParentControlSet *pcs)
+{
+    if (scs->static_config.look_ahead_distance != 0 || !pcs->is_used_as_reference_flag)
+        return;
+    EbReferenceObject *reference_object =
+        (EbReferenceObject *)pcs->reference_picture_wrapper_ptr->object_ptr;
+    // Copy original input to reference->input_picture
+    EbPictureBufferDesc *src_ptr = pcs->enhanced_picture_ptr;
+    uint16_t luma_height = (uint16_t)(src_ptr->height - scs->max_input_pad_bottom);
+    uint32_t src_offset = (src_ptr->stride_y*src_ptr->origin_y + src_ptr->origin_x);
+    uint16_t src_stride = src_ptr->stride_y;
+    uint8_t *src = src_ptr->buffer_y + src_offset;
+
+    EbPictureBufferDesc *dst_ptr = reference_object->input_picture;
+    uint32_t dst_offset = (dst_ptr->stride_y*dst_ptr->origin_y + dst_ptr->origin_x);
+    uint16_t dst_stride = dst_ptr->stride_y;
+    uint8_t *dst = dst_ptr->buffer_y + dst_offset;
+    for (int i = 0; i < luma_height; i++) {
+        EB_MEMCPY(dst, src, src_stride);
+        src += src_stride;
+        dst += dst_stride;
+    }
+    pad_input_pictures(scs, dst_ptr);
+
+    if (scs->in_loop_me ) {
+        // Generate 1/4 and 1/16 for reference->quarter_input_picture and reference->sixteenth_input_picture
+        if (scs->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
+            downsample_filtering_input_picture(
+                pcs,
+                reference_object->input_picture,
+                reference_object->quarter_input_picture,
+                reference_object->sixteenth_input_picture);
+        }
+        else {
+            downsample_decimation_input_picture(
+                pcs,
+                reference_object->input_picture,
+                reference_object->quarter_input_picture,
+                reference_object->sixteenth_input_picture);
+        }
+    }
+}
+/*
+  Releases the mini-GOPs at the head of the gate queue whose temporal filtering
+  is done. They go oldest first, as the ME of a mini-GOP also searches the
+  filtered pictures of the earlier ones. Called with me_gate_mutex held, which
+  it releases
+*/
+static void release_me_gates(
+    EncodeContext *encode_context_ptr)
+{
+    MeGate  *released_ptr      = NULL;
+    MeGate **released_tail_ptr = &released_ptr;
+    MeGate  *gate_ptr;
+    while ((gate_ptr = encode_context_ptr->me_gate_head_ptr) && gate_ptr->tf_pending_count == 0) {
+        encode_context_ptr->me_gate_head_ptr = gate_ptr->next_ptr;
+        if (!encode_context_ptr->me_gate_head_ptr)
+            encode_context_ptr->me_gate_tail_ptr = NULL;
+        gate_ptr->next_ptr = NULL;
+        *released_tail_ptr = gate_ptr;
+        released_tail_ptr  = &gate_ptr->next_ptr;
+    }
+    svt_release_mutex(encode_context_ptr->me_gate_mutex);
+
+    while ((gate_ptr = released_ptr)) {
+        released_ptr = gate_ptr->next_ptr;
+        for (uint32_t pic_i = 0; pic_i < gate_ptr->pcs_count; pic_i++)
+            copy_reference_input(gate_ptr->pcs_array[pic_i]->scs_ptr, gate_ptr->pcs_array[pic_i]);
+        // The segments taken by the ME processes until now are on the gate
+        svt_block_on_mutex(encode_context_ptr->me_gate_mutex);
+        for (uint32_t pic_i = 0; pic_i < gate_ptr->pcs_count; pic_i++)
+            gate_ptr->pcs_array[pic_i]->me_gate_ptr = NULL;
+        EbObjectWrapper *wrapper_ptr = gate_ptr->deferred_head_ptr;
+        svt_release_mutex(encode_context_ptr->me_gate_mutex);
+        while (wrapper_ptr) {
+            EbObjectWrapper *next_ptr = wrapper_ptr->next_ptr;
+            svt_post_full_object(wrapper_ptr);
+            wrapper_ptr = next_ptr;
+        }
+        EB_FREE(gate_ptr);
+    }
+}
+/*
+  Queues the gate of a mini-GOP whose pictures are all sent behind the earlier
+  ones, counting the filtering it waits for, and releases it when none is left
+*/
+static void close_me_gate(
+    EncodeContext           *encode_context_ptr,
+    PictureDecisionContext  *context_ptr,
+    MeGate                  *gate_ptr)
+{
+    uint32_t pending_count = 0;
+    svt_block_on_mutex(encode_context_ptr->me_gate_mutex);
+    for (uint32_t pending_idx = 0; pending_idx < context_ptr->tf_pending_count; pending_idx++) {
+        PictureParentControlSet *pending_ptr = context_ptr->tf_pending_array[pending_idx];
+        if (pending_ptr->tf_done)
+            continue;
+        // the filtering of an earlier mini-GOP is counted by its own gate
+        if (!pending_ptr->tf_gate_ptr) {
+            pending_ptr->tf_gate_ptr = gate_ptr;
+            gate_ptr->tf_pending_count++;
+        }
+        context_ptr->tf_pending_array[pending_count++] = pending_ptr;
+    }
+    context_ptr->tf_pending_count = pending_count;
+    if (encode_context_ptr->me_gate_tail_ptr)
+        encode_context_ptr->me_gate_tail_ptr->next_ptr = gate_ptr;
+    else
+        encode_context_ptr->me_gate_head_ptr = gate_ptr;
+    encode_context_ptr->me_gate_tail_ptr = gate_ptr;
+    release_me_gates(encode_context_ptr);
+}
+/*
+  Allocates the gate of the pictures sent next, or waits for the pending
+  filtering when there is no memory for it
+*/
+static MeGate *open_me_gate(
+    SequenceControlSet     *scs_ptr,
+    PictureDecisionContext *context_ptr)
+{
+    MeGate *gate_ptr;
+    EB_NO_THROW_MALLOC(gate_ptr, sizeof(*gate_ptr));
+    if (gate_ptr)
+        memset(gate_ptr, 0, sizeof(*gate_ptr));
+    else
+        wait_tf_pending(scs_ptr, context_ptr);
+    return gate_ptr;
+}
+EbBool svt_me_gate_hold(
+    PictureParentControlSet *pcs_ptr,
+    EbObjectWrapper         *wrapper_ptr)
+{
+    EncodeContext *encode_context_ptr = pcs_ptr->scs_ptr->encode_context_ptr;
+    svt_block_on_mutex(encode_context_ptr->me_gate_mutex);
+    MeGate *gate_ptr = pcs_ptr->me_gate_ptr;
+    if (gate_ptr) {
+        wrapper_ptr->next_ptr = NULL;
+        if (gate_ptr->deferred_tail_ptr)
+            gate_ptr->deferred_tail_ptr->next_ptr = wrapper_ptr;
+        else
+            gate_ptr->deferred_head_ptr = wrapper_ptr;
+        gate_ptr->deferred_tail_ptr = wrapper_ptr;
+    }
+    svt_release_mutex(encode_context_ptr->me_gate_mutex);
+    return gate_ptr != NULL;
+}
+void svt_tf_picture_done(
+    PictureParentControlSet *pcs_ptr)
+{
+    EncodeContext *encode_context_ptr = pcs_ptr->scs_ptr->encode_context_ptr;
+    svt_block_on_mutex(encode_context_ptr->me_gate_mutex);
+    pcs_ptr->tf_done = EB_TRUE;
+    if (pcs_ptr->tf_waited)
+        svt_post_semaphore(pcs_ptr->temp_filt_done_semaphore);
+    MeGate *gate_ptr     = pcs_ptr->tf_gate_ptr;
+    pcs_ptr->tf_gate_ptr = NULL;
+    if (gate_ptr && --gate_ptr->tf_pending_count == 0 &&
+        gate_ptr == encode_context_ptr->me_gate_head_ptr)
+        release_me_gates(encode_context_ptr);
+    else
+        svt_release_mutex(encode_context_ptr->me_gate_mutex);
+}
 /*
   Performs Motion Compensated Temporal Filtering in ME process
+
+  The segments are posted without waiting, so the filtering of the pictures of
+  a mini-GOP overlaps in the ME processes. A picture only waits for the pending
+  ones when its filtering window shares a picture with theirs, the source
+  pictures of a window being padded, packed and replaced by the filtering.
 */
 void mctf_frame(
     SequenceControlSet      *scs_ptr,
@@ -3850,6 +4073,9 @@ void mctf_frame(
         context_ptr->tf_level = 0;
     set_tf_controls(pcs_ptr, context_ptr->tf_level);
     if (pcs_ptr->tf_ctrls.enabled) {
+        // the window derivation reads the central picture
+        if (tf_pending_uses_picture(context_ptr, pcs_ptr))
+            wait_tf_pending(scs_ptr, context_ptr);
         derive_tf_window_params(
             scs_ptr,
             scs_ptr->encode_context_ptr,
@@ -3867,11 +4093,22 @@ void mctf_frame(
             pcs_ptr->tf_segments_row_count = scs_ptr->tf_segment_row_count;
             pcs_ptr->tf_segments_total_count = (uint16_t)(pcs_ptr->tf_segments_column_count  * pcs_ptr->tf_segments_row_count);
             pcs_ptr->temp_filt_seg_acc = 0;
+            for (int pic_i = 0; pic_i < pcs_ptr->past_altref_nframes + pcs_ptr->future_altref_nframes + 1; pic_i++) {
+                if (tf_pending_uses_picture(context_ptr, pcs_ptr->temp_filt_pcs_list[pic_i])) {
+                    wait_tf_pending(scs_ptr, context_ptr);
+                    break;
+                }
+            }
             if (pcs_ptr->temporal_layer_index == 0)
                 pcs_ptr->altref_strength = scs_ptr->static_config.altref_strength;
             else
                 pcs_ptr->altref_strength = 2;
 
+            pcs_ptr->tf_done     = EB_FALSE;
+            pcs_ptr->tf_waited   = EB_FALSE;
+            pcs_ptr->tf_gate_ptr = NULL;
+            if (scs_ptr->static_config.enable_pipeline_stats)
+                pcs_ptr->tf_post_time = svt_pipeline_stats_time();
             for (seg_idx = 0; seg_idx < pcs_ptr->tf_segments_total_count; ++seg_idx) {
 
                 EbObjectWrapper               *out_results_wrapper_ptr;
@@ -3887,7 +4124,10 @@ void mctf_frame(
                 svt_post_full_object(out_results_wrapper_ptr);
             }
 
-            svt_block_on_semaphore(pcs_ptr->temp_filt_done_semaphore);
+            // only full with the filtering of several mini-GOPs pending
+            if (context_ptr->tf_pending_count == (1 << MAX_TEMPORAL_LAYERS) + 1)
+                wait_tf_pending(scs_ptr, context_ptr);
+            context_ptr->tf_pending_array[context_ptr->tf_pending_count++] = pcs_ptr;
         }
 
     }
@@ -3982,8 +4222,10 @@ void store_tpl_pictures(
 void send_picture_out(
     SequenceControlSet      *scs,
     PictureParentControlSet *pcs,
-    PictureDecisionContext  *ctx)
+    PictureDecisionContext  *ctx,
+    MeGate                 **gate_ptr)
 {
+    MeGate                        *gate = *gate_ptr;
     EbObjectWrapper               *me_wrapper;
     EbObjectWrapper               *out_results_wrapper;
 
@@ -4001,46 +4243,13 @@ void send_picture_out(
         }else {
             pcs->reference_picture_wrapper_ptr = NULL;
         }
-        if (pcs->is_used_as_reference_flag) {
-            EbReferenceObject *reference_object =
-        (EbReferenceObject *)pcs->reference_picture_wrapper_ptr->object_ptr;
-            // Copy original input to reference->input_picture
-            EbPictureBufferDesc *src_ptr = pcs->enhanced_picture_ptr;
-            uint16_t luma_height = (uint16_t)(src_ptr->height - scs->max_input_pad_bottom);
-            uint32_t src_offset = (src_ptr->stride_y*src_ptr->origin_y + src_ptr->origin_x);
-            uint16_t src_stride = src_ptr->stride_y;
-            uint8_t *src = src_ptr->buffer_y + src_offset;
-
-            EbPictureBufferDesc *dst_ptr = reference_object->input_picture;
-            uint32_t dst_offset = (dst_ptr->stride_y*dst_ptr->origin_y + dst_ptr->origin_x);
-            uint16_t dst_stride = dst_ptr->stride_y;
-            uint8_t *dst = dst_ptr->buffer_y + dst_offset;
-            for (int i = 0; i < luma_height; i++) {
-                EB_MEMCPY(dst, src, src_stride);
-                src += src_stride;
-                dst += dst_stride;
-            }
-            pad_input_pictures(scs, dst_ptr);
-
-            if (scs->in_loop_me ) {
-                // Generate 1/4 and 1/16 for reference->quarter_input_picture and reference->sixteenth_input_picture
-                if (scs->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
-                    downsample_filtering_input_picture(
-                        pcs,
-                        reference_object->input_picture,
-                        reference_object->quarter_input_picture,
-                        reference_object->sixteenth_input_picture);
-                }
-                else {
-                    downsample_decimation_input_picture(
-                        pcs,
-                        reference_object->input_picture,
-                        reference_object->quarter_input_picture,
-                        reference_object->sixteenth_input_picture);
-                }
-            }
-        }
     }
+    // The filtered input is copied when the gate is released
+    if (gate)
+        gate->pcs_array[gate->pcs_count++] = pcs;
+    else
+        copy_reference_input(scs, pcs);
+    pcs->me_gate_ptr = gate;
     //get a new ME data buffer
     if (pcs->me_data_wrapper_ptr == NULL) {
         svt_get_empty_object(ctx->me_fifo_ptr, &me_wrapper);
@@ -4050,10 +4259,22 @@ void send_picture_out(
     }
 
     for (uint32_t segment_index = 0; segment_index < pcs->me_segments_total_count; ++segment_index) {
-        // Get Empty Results Object
-        svt_get_empty_object(
-            ctx->picture_decision_results_output_fifo_ptr,
-            &out_results_wrapper);
+        // Get Empty Results Object. The segments held on the open gate could
+        // take all of them, the gate is then closed so that its release frees them
+        out_results_wrapper = NULL;
+        if (*gate_ptr)
+            svt_get_empty_object_non_blocking(
+                ctx->picture_decision_results_output_fifo_ptr,
+                &out_results_wrapper);
+        if (!out_results_wrapper) {
+            if (*gate_ptr) {
+                close_me_gate(scs->encode_context_ptr, ctx, *gate_ptr);
+                *gate_ptr = open_me_gate(scs, ctx);
+            }
+            svt_get_empty_object(
+                ctx->picture_decision_results_output_fifo_ptr,
+                &out_results_wrapper);
+        }
 
         PictureDecisionResults* out_results = (PictureDecisionResults*)out_results_wrapper->object_ptr;
         out_results->pcs_wrapper_ptr = pcs->p_pcs_wrapper_ptr;
@@ -4750,7 +4971,11 @@ void* picture_decision_kernel(void *input_ptr)
 
                 pcs_ptr->init_pred_struct_position_flag = EB_FALSE;
 
-                pcs_ptr->target_bit_rate = scs_ptr->static_config.target_bit_rate;
+                // The rate of the picture's own scs, scs_ptr is the one of the last
+                // picture received and may hold the rate of a later reconfigure
+                pcs_ptr->target_bit_rate =
+                    ((SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr)
+                        ->static_config.target_bit_rate;
 
                 pcs_ptr->self_updated_links = 0;
                 pcs_ptr->other_updated_links_cnt = 0;
@@ -5566,11 +5791,14 @@ void* picture_decision_kernel(void *input_ptr)
                                 mctf_frame(scs_ptr, pcs_ptr, context_ptr, out_stride_diff64);
                             }
                         }
+                        // The filtered pictures are the sources of the ME of the mini-GOP,
+                        // which the gate holds back until the filtering is done
+                        MeGate *gate_ptr = open_me_gate(scs_ptr, context_ptr);
 
                         if (context_ptr->prev_delayed_intra) {
                             pcs_ptr = context_ptr->prev_delayed_intra;
                             context_ptr->prev_delayed_intra = NULL;
-                            send_picture_out(scs_ptr, pcs_ptr, context_ptr);
+                            send_picture_out(scs_ptr, pcs_ptr, context_ptr, &gate_ptr);
                         }
 
                         for (uint32_t pic_i = 0; pic_i < mg_size; ++pic_i){
@@ -5579,11 +5807,13 @@ void* picture_decision_kernel(void *input_ptr)
                             if (is_delayed_intra(pcs_ptr)) {
                                 context_ptr->prev_delayed_intra = pcs_ptr;
                             }else{
-                                send_picture_out(scs_ptr, pcs_ptr, context_ptr);
+                                send_picture_out(scs_ptr, pcs_ptr, context_ptr, &gate_ptr);
                             }
 
 
                         }
+                        if (gate_ptr)
+                            close_me_gate(encode_context_ptr, context_ptr, gate_ptr);
                     } // End MINI GOPs loop
                     // Reset the Pre-Assignment Buffer
                     encode_context_ptr->pre_assignment_buffer_count = 0;
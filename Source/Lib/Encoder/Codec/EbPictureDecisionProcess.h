@@ -38,6 +38,12 @@ void picture_pre_processing_operations(PictureParentControlSet *pcs_ptr,
                                        SequenceControlSet *     scs_ptr);
 void pad_picture_to_multiple_of_sb_dimensions(EbPictureBufferDesc *input_padded_picture_ptr);
 
+// Holds back an ME segment of a picture whose mini-GOP waits for its temporal
+// filtering, returns EB_TRUE when the segment is held
+EbBool svt_me_gate_hold(PictureParentControlSet *pcs_ptr, EbObjectWrapper *wrapper_ptr);
+// Called once the temporal filtering of a picture is done
+void svt_tf_picture_done(PictureParentControlSet *pcs_ptr);
+
 void gathering_picture_statistics(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr,
                                   EbPictureBufferDesc *input_picture_ptr,
                                   EbPictureBufferDesc *input_padded_picture_ptr,
@@ -99,6 +105,10 @@ typedef struct PictureDecisionContext {
     PictureParentControlSet *prev_delayed_intra; //Key frame or I of LDP short MG
     uint32_t                 mg_size; //number of active pictures in above array
     PictureParentControlSet *mg_pictures_array_disp_order[1 << MAX_TEMPORAL_LAYERS];
+    // Pictures being temporally filtered in the ME processes, waited for when
+    // the filtering window of a picture shares one of their sources
+    PictureParentControlSet *tf_pending_array[(1 << MAX_TEMPORAL_LAYERS) + 1];
+    uint32_t                 tf_pending_count;
 } PictureDecisionContext;
 
 #endif // EbPictureDecision_h
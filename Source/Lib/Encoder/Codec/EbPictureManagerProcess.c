@@ -25,6 +25,7 @@
 #include "EbSvtAv1ErrorCodes.h"
 #include "EbEntropyCoding.h"
 #include "EbLog.h"
+#include "EbDlfProcess.h"
 
 // Token buffer is only used for palette tokens.
 static INLINE unsigned int get_token_alloc(int mb_rows, int mb_cols, int sb_size_log2,
@@ -867,6 +868,11 @@ void *picture_manager_kernel(void *input_ptr) {
                     if(entry_scs_ptr->enable_pic_mgr_dec_order)
                         if (entry_pcs_ptr->picture_number > 0 && entry_pcs_ptr->decode_order != context_ptr->pmgr_dec_order + 1)
                             availability_flag = EB_FALSE;
+                    // The first picture after svt_av1_enc_reconfigure restarts rate control
+                    // with the new rate, so it starts after the pictures sent before it
+                    if (entry_pcs_ptr->config_change &&
+                        input_queue_index != encode_context_ptr->input_picture_queue_head_index)
+                        availability_flag = EB_FALSE;
                     // Check RefList0 Availability
                     for (uint8_t ref_idx = 0; ref_idx < entry_pcs_ptr->ref_list0_count; ++ref_idx) {
                         //if (entry_pcs_ptr->ref_list0_count)  // NM: to double check.
@@ -994,6 +1000,7 @@ void *picture_manager_kernel(void *input_ptr) {
                                       entry_scs_ptr->sb_size_pix);
 
                         init_enc_dec_segement(entry_pcs_ptr);
+                        svt_dlf_sb_row_init(child_pcs_ptr);
 
                         int      sb_size_log2    = entry_scs_ptr->seq_header.sb_size_log2;
                         struct PictureParentControlSet *ppcs_ptr = child_pcs_ptr->parent_pcs_ptr;
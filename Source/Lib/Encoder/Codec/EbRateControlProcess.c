@@ -1694,6 +1694,19 @@ uint64_t predict_bits(EncodeContext *              encode_context_ptr,
     return total_bits;
 }
 
+// The rate control state is seeded by the first picture, and again by the
+// first picture after svt_av1_enc_reconfigure
+static EbBool rc_seed_picture(const PictureParentControlSet *pcs_ptr) {
+    return pcs_ptr->picture_number == 0 || pcs_ptr->config_change;
+}
+
+// The key frame of a reconfigure restarts the rate interval it falls in
+static EbBool rc_interval_start(const PictureControlSet *              pcs_ptr,
+                                const RateControlIntervalParamContext *rate_control_param_ptr) {
+    return pcs_ptr->picture_number == rate_control_param_ptr->first_poc ||
+        pcs_ptr->parent_pcs_ptr->config_change;
+}
+
 void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                                      EncodeContext *              encode_context_ptr,
                                      RateControlContext *         context_ptr,
@@ -2155,7 +2168,7 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
                                                scs_ptr->static_config.max_qp_allowed,
                                                pcs_ptr->best_pred_qp);
 
-        if (pcs_ptr->picture_number == 0) {
+        if (rc_seed_picture(pcs_ptr)) {
             high_level_rate_control_ptr->prev_intra_selected_ref_qp     = selected_ref_qp;
             high_level_rate_control_ptr->prev_intra_org_selected_ref_qp = selected_ref_qp;
         }
@@ -2250,12 +2263,12 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
                                                             ->intra_frames_qp_bef_scal]));
         }
 
-        if (pcs_ptr->picture_number == 0) {
+        if (rc_seed_picture(pcs_ptr->parent_pcs_ptr)) {
             rate_control_param_ptr->intra_frames_qp          = scs_ptr->static_config.qp;
             rate_control_param_ptr->intra_frames_qp_bef_scal = (uint8_t)scs_ptr->static_config.qp;
         }
 
-        if (pcs_ptr->picture_number == rate_control_param_ptr->first_poc) {
+        if (rc_interval_start(pcs_ptr, rate_control_param_ptr)) {
             uint32_t temporal_layer_idex;
             rate_control_param_ptr->previous_virtual_buffer_level =
                 context_ptr->virtual_buffer_level_initial_value;
@@ -2411,7 +2424,7 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
             pcs_ptr->parent_pcs_ptr->sad_me <<= RC_PRECISION;
         }
 
-        if (pcs_ptr->picture_number == rate_control_param_ptr->first_poc) {
+        if (rc_interval_start(pcs_ptr, rate_control_param_ptr)) {
             uint32_t temporal_layer_idex;
             for (temporal_layer_idex = 0; temporal_layer_idex < EB_MAX_TEMPORAL_LAYERS;
                  temporal_layer_idex++)
@@ -2421,7 +2434,7 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
                     pcs_ptr);
         }
 
-        if (pcs_ptr->picture_number == 0) {
+        if (rc_seed_picture(pcs_ptr->parent_pcs_ptr)) {
             context_ptr->base_layer_frames_avg_qp       = pcs_ptr->picture_qp + 1;
             context_ptr->base_layer_intra_frames_avg_qp = pcs_ptr->picture_qp;
         }
@@ -3681,7 +3694,7 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                                                scs_ptr->static_config.max_qp_allowed,
                                                (uint8_t)((int)pcs_ptr->best_pred_qp + delta_qp));
 
-        if (pcs_ptr->picture_number == 0) {
+        if (rc_seed_picture(pcs_ptr)) {
             high_level_rate_control_ptr->prev_intra_selected_ref_qp     = selected_ref_qp;
             high_level_rate_control_ptr->prev_intra_org_selected_ref_qp = selected_ref_qp;
         }
@@ -3773,12 +3786,12 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
                                                             ->intra_frames_qp_bef_scal]));
         }
 
-        if (pcs_ptr->picture_number == 0) {
+        if (rc_seed_picture(pcs_ptr->parent_pcs_ptr)) {
             rate_control_param_ptr->intra_frames_qp          = scs_ptr->static_config.qp;
             rate_control_param_ptr->intra_frames_qp_bef_scal = (uint8_t)scs_ptr->static_config.qp;
         }
 
-        if (pcs_ptr->picture_number == rate_control_param_ptr->first_poc) {
+        if (rc_interval_start(pcs_ptr, rate_control_param_ptr)) {
             uint32_t temporal_layer_idex;
             rate_control_param_ptr->previous_virtual_buffer_level =
                 context_ptr->virtual_buffer_level_initial_value;
@@ -3835,7 +3848,7 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
             pcs_ptr->parent_pcs_ptr->sad_me <<= RC_PRECISION;
         }
 
-        if (pcs_ptr->picture_number == rate_control_param_ptr->first_poc) {
+        if (rc_interval_start(pcs_ptr, rate_control_param_ptr)) {
             uint32_t temporal_layer_idex;
             for (temporal_layer_idex = 0; temporal_layer_idex < EB_MAX_TEMPORAL_LAYERS;
                  temporal_layer_idex++)
@@ -3845,7 +3858,7 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
                     pcs_ptr);
         }
 
-        if (pcs_ptr->picture_number == 0) {
+        if (rc_seed_picture(pcs_ptr->parent_pcs_ptr)) {
             context_ptr->base_layer_frames_avg_qp       = pcs_ptr->picture_qp + 1;
             context_ptr->base_layer_intra_frames_avg_qp = pcs_ptr->picture_qp;
         }
@@ -4747,6 +4760,7 @@ void init_rc(RateControlContext *context_ptr, PictureControlSet *pcs_ptr,
     int32_t  total_frame_in_interval = scs_ptr->intra_period_length;
     uint32_t gop_period              = (1 << pcs_ptr->parent_pcs_ptr->hierarchical_levels);
     context_ptr->frame_rate          = scs_ptr->frame_rate;
+    memset(context_ptr->frames_in_interval, 0, sizeof(context_ptr->frames_in_interval));
     while (total_frame_in_interval >= 0) {
         if (total_frame_in_interval % (gop_period) == 0)
             context_ptr->frames_in_interval[0]++;
@@ -7244,8 +7258,8 @@ void *rate_control_kernel(void *input_ptr) {
                 pcs_ptr->parent_pcs_ptr->down_scaled_picture_wrapper_ptr = NULL;
             }
 
-            if (pcs_ptr->picture_number == 0) {
-                //init rate control parameters
+            if (rc_seed_picture(pcs_ptr->parent_pcs_ptr)) {
+                //init rate control parameters, with the new rate after a reconfigure
                 init_rc(context_ptr, pcs_ptr, scs_ptr);
             }
             // SB Loop
@@ -7256,7 +7270,7 @@ void *rate_control_kernel(void *input_ptr) {
                         pcs_ptr->parent_pcs_ptr->rc_me_distortion[sb_addr];
                 }
             if (use_input_stat(scs_ptr) || scs_ptr->lap_enabled) {
-                if (pcs_ptr->picture_number == 0) {
+                if (rc_seed_picture(pcs_ptr->parent_pcs_ptr)) {
                     set_rc_buffer_sizes(scs_ptr);
                     av1_rc_init(scs_ptr);
                 }
@@ -7483,7 +7497,7 @@ void *rate_control_kernel(void *input_ptr) {
                                                          pcs_ptr->picture_qp + 2) >>
                     2;
             if (pcs_ptr->slice_type == I_SLICE) {
-                if (pcs_ptr->picture_number == rate_control_param_ptr->first_poc) {
+                if (rc_interval_start(pcs_ptr, rate_control_param_ptr)) {
                     rate_control_param_ptr->first_pic_pred_qp =
                         (uint16_t)pcs_ptr->parent_pcs_ptr->best_pred_qp;
                     rate_control_param_ptr->first_pic_actual_qp = (uint16_t)pcs_ptr->picture_qp;
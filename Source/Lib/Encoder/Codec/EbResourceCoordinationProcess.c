@@ -723,8 +723,54 @@ static void setup_two_pass(SequenceControlSet *scs_ptr) {
         svt_av1_init_single_pass_lap(scs_ptr);
 }
 
+/******************************************************
+ * Low-latency mode end of sequence: the last packet carries it when it is
+ * still to come (see post_low_latency_packet()), else an empty packet does
+ ******************************************************/
+static void post_low_latency_eos(EncodeContext *encode_context_ptr) {
+    svt_block_on_mutex(encode_context_ptr->low_latency_eos_mutex);
+    encode_context_ptr->low_latency_eos_received = EB_TRUE;
+    if (encode_context_ptr->low_latency_packet_count ==
+        encode_context_ptr->low_latency_picture_count) {
+        EbObjectWrapper *output_stream_wrapper_ptr;
+        svt_get_empty_object(encode_context_ptr->stream_output_fifo_ptr,
+                             &output_stream_wrapper_ptr);
+        EbBufferHeaderType *output_stream_ptr = (EbBufferHeaderType *)
+                                                    output_stream_wrapper_ptr->object_ptr;
+        output_stream_ptr->flags         = EB_BUFFERFLAG_EOS;
+        output_stream_ptr->n_filled_len  = 0;
+        output_stream_ptr->pic_type      = EB_AV1_INVALID_PICTURE;
+        output_stream_ptr->n_tick_count  = 0;
+        output_stream_ptr->p_app_private = NULL;
+        svt_post_full_object(output_stream_wrapper_ptr);
+    }
+    svt_release_mutex(encode_context_ptr->low_latency_eos_mutex);
+}
+
+/******************************************************
+ * Applies the rate of the oldest svt_av1_enc_reconfigure to the configuration
+ * of the instance, on the picture sent after it. Called with config_mutex held.
+ ******************************************************/
+static void apply_config_change(EbSequenceControlSetInstance *scs_instance) {
+    EbSvtAv1EncConfiguration *active_config = &scs_instance->scs_ptr->static_config;
+    const EbSvtAv1EncConfiguration *config_ptr =
+        &scs_instance->config_changes[scs_instance->config_change_head];
+    active_config->target_bit_rate = config_ptr->target_bit_rate;
+    active_config->vbv_bufsize     = config_ptr->vbv_bufsize;
+    active_config->qp              = config_ptr->qp;
+    if (active_config->rate_control_mode) {
+        active_config->max_qp_allowed = config_ptr->max_qp_allowed;
+        active_config->min_qp_allowed = config_ptr->min_qp_allowed;
+    }
+    scs_instance->config_change_head =
+        (scs_instance->config_change_head + 1) % scs_instance->config_change_count;
+}
+
 extern EbErrorType first_pass_signal_derivation_pre_analysis_pcs(PictureParentControlSet *pcs_ptr);
 extern EbErrorType first_pass_signal_derivation_pre_analysis_scs(SequenceControlSet *scs_ptr);
+void svt_av1_build_quantizer(AomBitDepth bit_depth, int32_t y_dc_delta_q, int32_t u_dc_delta_q,
+                             int32_t u_ac_delta_q, int32_t v_dc_delta_q, int32_t v_ac_delta_q,
+                             Quants *const quants, Dequants *const deq);
 
 /* Resource Coordination Kernel */
 /*********************************************************************************
@@ -789,11 +835,27 @@ void *resource_coordination_kernel(void *input_ptr) {
 
         eb_input_ptr = (EbBufferHeaderType *)eb_input_wrapper_ptr->object_ptr;
 
+        if ((eb_input_ptr->flags & EB_BUFFERFLAG_EOS) &&
+            context_ptr->scs_instance_array[instance_index]
+                ->scs_ptr->static_config.max_frames_in_flight) {
+            post_low_latency_eos(
+                context_ptr->scs_instance_array[instance_index]->encode_context_ptr);
+            svt_release_object(eb_input_wrapper_ptr);
+            continue;
+        }
+
+        // the first picture after svt_av1_enc_reconfigure
+        const EbBool config_change = (eb_input_ptr->flags & EB_BUFFERFLAG_CONFIG_CHANGE) != 0;
+        eb_input_ptr->flags &= ~EB_BUFFERFLAG_CONFIG_CHANGE;
+
         // If config changes occured since the last picture began encoding, then
         //   prepare a new scs_ptr containing the new changes and update the state
         //   of the previous Active SequenceControlSet
         svt_block_on_mutex(context_ptr->scs_instance_array[instance_index]->config_mutex);
-        if (context_ptr->scs_instance_array[instance_index]->encode_context_ptr->initial_picture) {
+        if (config_change)
+            apply_config_change(context_ptr->scs_instance_array[instance_index]);
+        if (context_ptr->scs_instance_array[instance_index]->encode_context_ptr->initial_picture ||
+            config_change) {
             // Update picture width, picture height, cropping right offset, cropping bottom offset, and conformance windows
             context_ptr->scs_instance_array[instance_index]->scs_ptr->seq_header.max_frame_width =
                 context_ptr->scs_instance_array[instance_index]->scs_ptr->max_input_luma_width;
@@ -838,6 +900,16 @@ void *resource_coordination_kernel(void *input_ptr) {
             else
                 signal_derivation_pre_analysis_oq_scs(scs_tmp);
 
+            // Initial rate control builds the quantizers with the first picture
+            // only, the delta q are 0 like there
+            if (config_change) {
+                svt_av1_build_quantizer(
+                    AOM_BITS_8, 0, 0, 0, 0, 0, &scs_tmp->quants_8bit, &scs_tmp->deq_8bit);
+                if (scs_tmp->static_config.encoder_bit_depth == AOM_BITS_10)
+                    svt_av1_build_quantizer(
+                        AOM_BITS_10, 0, 0, 0, 0, 0, &scs_tmp->quants_bd, &scs_tmp->deq_bd);
+            }
+
             // Disable releaseFlag of new SequenceControlSet
             svt_object_release_disable(
                 context_ptr->sequence_control_set_active_array[instance_index]);
@@ -864,7 +936,8 @@ void *resource_coordination_kernel(void *input_ptr) {
                       ->object_ptr;
 
         // Init SB Params
-        if (context_ptr->scs_instance_array[instance_index]->encode_context_ptr->initial_picture) {
+        if (context_ptr->scs_instance_array[instance_index]->encode_context_ptr->initial_picture ||
+            config_change) {
             derive_input_resolution(&scs_ptr->input_resolution, input_size);
 
             sb_params_init(scs_ptr);
@@ -945,6 +1018,7 @@ void *resource_coordination_kernel(void *input_ptr) {
 
             pcs_ptr->overlay_ppcs_ptr = NULL;
             pcs_ptr->is_alt_ref       = 0;
+            pcs_ptr->config_change    = config_change && loop_index == 0;
             if (loop_index) {
                 pcs_ptr->is_overlay = 1;
                 // set the overlay_ppcs_ptr in the original (ALT_REF) ppcs to the current ppcs
@@ -1134,7 +1208,20 @@ void *resource_coordination_kernel(void *input_ptr) {
             }
 
             // Get Empty Output Results Object
-            if (pcs_ptr->picture_number > 0 && (prev_pcs_wrapper_ptr != NULL)) {
+            if (scs_ptr->static_config.max_frames_in_flight) {
+                // Low-latency mode: no picture is held back for the end of sequence
+                EncodeContext *encode_context_ptr = scs_ptr->encode_context_ptr;
+                svt_block_on_mutex(encode_context_ptr->low_latency_eos_mutex);
+                encode_context_ptr->low_latency_picture_count++;
+                svt_release_mutex(encode_context_ptr->low_latency_eos_mutex);
+
+                reset_pcs_av1(pcs_ptr);
+                svt_get_empty_object(context_ptr->resource_coordination_results_output_fifo_ptr,
+                                     &output_wrapper_ptr);
+                out_results_ptr = (ResourceCoordinationResults *)output_wrapper_ptr->object_ptr;
+                out_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+                svt_post_full_object(output_wrapper_ptr);
+            } else if (pcs_ptr->picture_number > 0 && (prev_pcs_wrapper_ptr != NULL)) {
                 PictureParentControlSet *ppcs_out = (PictureParentControlSet *)
                                                         prev_pcs_wrapper_ptr->object_ptr;
 
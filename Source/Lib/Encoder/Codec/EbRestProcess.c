@@ -19,6 +19,7 @@
 #include "EbPictureDemuxResults.h"
 #include "EbReferenceObject.h"
 #include "EbPictureControlSet.h"
+#include "EbArena.h"
 
 #define DEBUG_UPSCALING 0
 
@@ -42,12 +43,15 @@ typedef struct RestContext {
     // each thread will hence have his own copy of recon to work on.
     // later we can have a search version that does not need the exact right recon
     int32_t *rst_tmpbuf;
+    // scratch buffers of the frame level search
+    EbArena *arena_ptr;
 } RestContext;
 
 void pack_highbd_pic(const EbPictureBufferDesc *pic_ptr, uint16_t *buffer_16bit[3], uint32_t ss_x,
                      uint32_t ss_y, EbBool include_padding);
 void copy_buffer_info(EbPictureBufferDesc *src_ptr, EbPictureBufferDesc *dst_ptr);
-void recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr);
+EbBool recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
+                    EbObjectWrapper *input_wrapper_ptr);
 void svt_av1_loop_restoration_filter_frame(Yv12BufferConfig *frame, Av1Common *cm,
                                            int32_t optimized_lr);
 void copy_statistics_to_ref_obj_ect(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr);
@@ -60,7 +64,10 @@ void generate_padding(EbByte src_pic, uint32_t src_stride, uint32_t original_src
 void restoration_seg_search(int32_t *rst_tmpbuf, Yv12BufferConfig *org_fts,
                             const Yv12BufferConfig *src, Yv12BufferConfig *trial_frame_rst,
                             PictureControlSet *pcs_ptr, uint32_t segment_index);
-void rest_finish_search(PictureParentControlSet *p_pcs_ptr, Macroblock *x, Av1Common *const cm);
+void rest_finish_search(EbArena *arena_ptr, PictureParentControlSet *p_pcs_ptr, Macroblock *x,
+                        Av1Common *const cm);
+void svt_av1_rest_segment_row_extent(Av1Common *cm, uint8_t rest_segments_row_count,
+                                     uint32_t y_seg_idx, int32_t *y0, int32_t *y1);
 
 void svt_av1_upscale_normative_rows(const Av1Common *cm, const uint8_t *src, int src_stride,
                                     uint8_t *dst, int dst_stride, int rows, int sub_x, int bd,
@@ -81,6 +88,7 @@ static void rest_context_dctor(EbPtr p) {
     EB_DELETE(obj->trial_frame_rst);
     EB_DELETE(obj->org_rec_frame);
     EB_FREE_ALIGNED(obj->rst_tmpbuf);
+    EB_DELETE(obj->arena_ptr);
     EB_FREE_ARRAY(obj);
 }
 
@@ -132,6 +140,7 @@ EbErrorType rest_context_ctor(EbThreadContext *  thread_context_ptr,
 
         EB_MALLOC_ALIGNED(context_ptr->rst_tmpbuf, RESTORATION_TMPBUF_SIZE);
     }
+    EB_NEW(context_ptr->arena_ptr, svt_arena_ctor, 0);
 
     EbPictureBufferDescInitData temp_lf_recon_desc_init_data;
     temp_lf_recon_desc_init_data.max_width          = (uint16_t)scs_ptr->max_input_luma_width;
@@ -159,10 +168,17 @@ EbErrorType rest_context_ctor(EbThreadContext *  thread_context_ptr,
 
     return EB_ErrorNone;
 }
+/*
+  Copies the luma rows [first_row, end_row) of the recon, and the chroma rows
+  that go with them, to the recon of the context. Only the frame width is
+  copied, the search extends the copy itself
+*/
 void get_own_recon(SequenceControlSet *scs_ptr, PictureControlSet *pcs_ptr,
-                   RestContext *context_ptr, EbBool is_16bit) {
-    const uint32_t ss_x = scs_ptr->subsampling_x;
-    const uint32_t ss_y = scs_ptr->subsampling_y;
+                   RestContext *context_ptr, EbBool is_16bit, int32_t first_row,
+                   int32_t end_row) {
+    const int32_t ss_x  = scs_ptr->subsampling_x;
+    const int32_t ss_y  = scs_ptr->subsampling_y;
+    const int32_t width = pcs_ptr->parent_pcs_ptr->av1_cm->frm_size.superres_upscaled_width;
 
     EbPictureBufferDesc *recon_picture_ptr;
     if (is_16bit) {
@@ -190,18 +206,18 @@ void get_own_recon(SequenceControlSet *scs_ptr, PictureControlSet *pcs_ptr,
         uint16_t *org_ptr_cr = (uint16_t *)org_rec->buffer_cr + org_rec->origin_x / 2 +
             org_rec->origin_y / 2 * org_rec->stride_cr;
 
-        for (int r = 0; r < recon_picture_ptr->height; ++r)
+        for (int r = first_row; r < end_row; ++r)
             svt_memcpy(org_ptr + r * org_rec->stride_y,
                        rec_ptr + r * recon_picture_ptr->stride_y,
-                       recon_picture_ptr->width << 1);
+                       width << 1);
 
-        for (int r = 0; r < (recon_picture_ptr->height >> ss_y); ++r) {
+        for (int r = first_row >> ss_y; r < (end_row + ss_y) >> ss_y; ++r) {
             svt_memcpy(org_ptr_cb + r * org_rec->stride_cb,
                        rec_ptr_cb + r * recon_picture_ptr->stride_cb,
-                       (recon_picture_ptr->width >> ss_x) << 1);
+                       ((width + ss_x) >> ss_x) << 1);
             svt_memcpy(org_ptr_cr + r * org_rec->stride_cr,
                        rec_ptr_cr + r * recon_picture_ptr->stride_cr,
-                       (recon_picture_ptr->width >> ss_x) << 1);
+                       ((width + ss_x) >> ss_x) << 1);
         }
     } else {
         if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
@@ -229,18 +245,18 @@ void get_own_recon(SequenceControlSet *scs_ptr, PictureControlSet *pcs_ptr,
         uint8_t *org_ptr_cr = &((org_rec->buffer_cr)[org_rec->origin_x / 2 +
                                                      org_rec->origin_y / 2 * org_rec->stride_cr]);
 
-        for (int r = 0; r < recon_picture_ptr->height; ++r)
+        for (int r = first_row; r < end_row; ++r)
             svt_memcpy(org_ptr + r * org_rec->stride_y,
                        rec_ptr + r * recon_picture_ptr->stride_y,
-                       recon_picture_ptr->width);
+                       width);
 
-        for (int r = 0; r < (recon_picture_ptr->height >> ss_y); ++r) {
+        for (int r = first_row >> ss_y; r < (end_row + ss_y) >> ss_y; ++r) {
             svt_memcpy(org_ptr_cb + r * org_rec->stride_cb,
                        rec_ptr_cb + r * recon_picture_ptr->stride_cb,
-                       (recon_picture_ptr->width >> ss_x));
+                       (width + ss_x) >> ss_x);
             svt_memcpy(org_ptr_cr + r * org_rec->stride_cr,
                        rec_ptr_cr + r * recon_picture_ptr->stride_cr,
-                       (recon_picture_ptr->width >> ss_x));
+                       (width + ss_x) >> ss_x);
         }
     }
 }
@@ -452,183 +468,255 @@ void svt_av1_superres_upscale_frame(struct Av1Common *cm, PictureControlSet *pcs
 }
 
 /******************************************************
- * Rest Kernel
+ * Rest Process
  ******************************************************/
-void *rest_kernel(void *input_ptr) {
-    // Context & SCS & PCS
-    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
-    RestContext *       context_ptr        = (RestContext *)thread_context_ptr->priv;
-    PictureControlSet * pcs_ptr;
-    SequenceControlSet *scs_ptr;
+static EbBool rest_park(EbObjectWrapper *cdef_results_wrapper_ptr, uint16_t posted_count) {
+    CdefResults *cdef_results_ptr = (CdefResults *)cdef_results_wrapper_ptr->object_ptr;
 
-    //// Input
-    EbObjectWrapper *cdef_results_wrapper_ptr;
-    CdefResults *    cdef_results_ptr;
+    cdef_results_ptr->parked       = EB_TRUE;
+    cdef_results_ptr->posted_count = posted_count;
+    svt_park_full_object(cdef_results_wrapper_ptr);
+    return EB_FALSE;
+}
 
-    //// Output
-    EbObjectWrapper *    rest_results_wrapper_ptr;
-    RestResults *        rest_results_ptr;
-    EbObjectWrapper *    picture_demux_results_wrapper_ptr;
-    PictureDemuxResults *picture_demux_results_rtr;
-    // SB Loop variables
-    uint8_t tile_cols;
-    uint8_t tile_rows;
+/******************************************************
+ * Rest Post Results
+ *   Posts the outputs of the restored picture of the
+ *   input object from first_output: the recon to the
+ *   application (0), the reference picture to the
+ *   picture manager (1) and the tiles to entropy coding
+ *   (2 and up). Returns EB_FALSE when the task was
+ *   parked on an empty output fifo.
+ ******************************************************/
+static EbBool rest_post_results(RestContext *context_ptr,
+                                EbObjectWrapper *cdef_results_wrapper_ptr, uint16_t first_output) {
+    CdefResults *       cdef_results_ptr = (CdefResults *)cdef_results_wrapper_ptr->object_ptr;
+    PictureControlSet * pcs_ptr = (PictureControlSet *)cdef_results_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    Av1Common *         cm      = pcs_ptr->parent_pcs_ptr->av1_cm;
+    const uint8_t       tile_cols    = cm->tiles_info.tile_cols;
+    const uint8_t       tile_rows    = cm->tiles_info.tile_rows;
+    const int           sb_size_log2 = scs_ptr->seq_header.sb_size_log2;
+    uint16_t            output_index = first_output;
+
+    if (output_index == 0) {
+        if (scs_ptr->static_config.recon_enabled &&
+            !recon_output(pcs_ptr, scs_ptr, cdef_results_wrapper_ptr))
+            return rest_park(cdef_results_wrapper_ptr, output_index);
+        output_index++;
+    }
 
-    for (;;) {
-        // Get Cdef Results
-        EB_GET_FULL_OBJECT(context_ptr->rest_input_fifo_ptr, &cdef_results_wrapper_ptr);
+    if (output_index == 1) {
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
+            EbObjectWrapper *    picture_demux_results_wrapper_ptr;
+            PictureDemuxResults *picture_demux_results_rtr;
+            // Get Empty PicMgr Results
+            if (!svt_get_output_object(context_ptr->picture_demux_fifo_ptr,
+                                       cdef_results_wrapper_ptr,
+                                       &picture_demux_results_wrapper_ptr))
+                return rest_park(cdef_results_wrapper_ptr, output_index);
+
+            picture_demux_results_rtr = (PictureDemuxResults *)
+                                            picture_demux_results_wrapper_ptr->object_ptr;
+            picture_demux_results_rtr->reference_picture_wrapper_ptr =
+                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
+            picture_demux_results_rtr->scs_wrapper_ptr = pcs_ptr->scs_wrapper_ptr;
+            picture_demux_results_rtr->picture_number  = pcs_ptr->picture_number;
+            picture_demux_results_rtr->picture_type    = EB_PIC_REFERENCE;
+
+            // Post Reference Picture
+            svt_post_full_object(picture_demux_results_wrapper_ptr);
+        }
+        output_index++;
+    }
 
-        cdef_results_ptr      = (CdefResults *)cdef_results_wrapper_ptr->object_ptr;
-        pcs_ptr               = (PictureControlSet *)cdef_results_ptr->pcs_wrapper_ptr->object_ptr;
-        scs_ptr               = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-        FrameHeader *frm_hdr  = &pcs_ptr->parent_pcs_ptr->frm_hdr;
-        EbBool       is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        Av1Common *  cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
+    //Jing: TODO
+    //Consider to add parallelism here, sending line by line, not waiting for a full frame
+    for (; output_index < 2 + tile_rows * tile_cols; output_index++) {
+        const int        tile_idx     = output_index - 2;
+        const int        tile_row_idx = tile_idx / tile_cols;
+        uint16_t         tile_height_in_sb = (cm->tiles_info.tile_row_start_mi[tile_row_idx + 1] -
+                                      cm->tiles_info.tile_row_start_mi[tile_row_idx] +
+                                      (1 << sb_size_log2) - 1) >>
+            sb_size_log2;
+        EbObjectWrapper *rest_results_wrapper_ptr;
+        RestResults *    rest_results_ptr;
+        if (!svt_get_output_object(
+                context_ptr->rest_output_fifo_ptr, cdef_results_wrapper_ptr, &rest_results_wrapper_ptr))
+            return rest_park(cdef_results_wrapper_ptr, output_index);
+        rest_results_ptr = (struct RestResults *)rest_results_wrapper_ptr->object_ptr;
+        rest_results_ptr->pcs_wrapper_ptr              = cdef_results_ptr->pcs_wrapper_ptr;
+        rest_results_ptr->completed_sb_row_index_start = 0;
+        // Set to tile rows
+        rest_results_ptr->completed_sb_row_count = tile_height_in_sb;
+        rest_results_ptr->tile_index             = tile_idx;
+        // Post Rest Results
+        svt_post_full_object(rest_results_wrapper_ptr);
+    }
+    return EB_TRUE;
+}
 
-        if (scs_ptr->seq_header.enable_restoration && frm_hdr->allow_intrabc == 0) {
-            // ------- start: Normative upscaling - super-resolution tool
-            if (!av1_superres_unscaled(&cm->frm_size)) {
-                svt_av1_superres_upscale_frame(cm, pcs_ptr, scs_ptr);
+static void rest_process(RestContext *context_ptr, EbObjectWrapper *cdef_results_wrapper_ptr) {
+    PictureControlSet * pcs_ptr;
+    SequenceControlSet *scs_ptr;
 
-                if (scs_ptr->static_config.is_16bit_pipeline || is_16bit) {
-                    set_unscaled_input_16bit(pcs_ptr);
-                }
+    //// Input
+    CdefResults *cdef_results_ptr;
+    EbBool       last_segment;
+
+    cdef_results_ptr      = (CdefResults *)cdef_results_wrapper_ptr->object_ptr;
+    if (cdef_results_ptr->parked) {
+        // Requeued on an empty output fifo, post the remaining outputs
+        if (rest_post_results(
+                context_ptr, cdef_results_wrapper_ptr, cdef_results_ptr->posted_count))
+            svt_release_object(cdef_results_wrapper_ptr);
+        return;
+    }
+    pcs_ptr               = (PictureControlSet *)cdef_results_ptr->pcs_wrapper_ptr->object_ptr;
+    scs_ptr               = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    FrameHeader *frm_hdr  = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    EbBool       is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common *  cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
+
+    if (scs_ptr->seq_header.enable_restoration && frm_hdr->allow_intrabc == 0) {
+        // ------- start: Normative upscaling - super-resolution tool
+        if (!av1_superres_unscaled(&cm->frm_size)) {
+            svt_av1_superres_upscale_frame(cm, pcs_ptr, scs_ptr);
+
+            if (scs_ptr->static_config.is_16bit_pipeline || is_16bit) {
+                set_unscaled_input_16bit(pcs_ptr);
             }
-            // ------- end: Normative upscaling - super-resolution tool
-            get_own_recon(scs_ptr,
-                          pcs_ptr,
-                          context_ptr,
-                          scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-            Yv12BufferConfig cpi_source;
-            pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr->is_16bit_pipeline =
-                scs_ptr->static_config.is_16bit_pipeline;
-            link_eb_to_aom_buffer_desc(scs_ptr->static_config.is_16bit_pipeline || is_16bit
-                                           ? pcs_ptr->input_frame16bit
-                                           : pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr,
-                                       &cpi_source,
-                                       scs_ptr->max_input_pad_right,
-                                       scs_ptr->max_input_pad_bottom,
-                                       scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-
-            Yv12BufferConfig trial_frame_rst;
-            link_eb_to_aom_buffer_desc(context_ptr->trial_frame_rst,
-                                       &trial_frame_rst,
-                                       scs_ptr->max_input_pad_right,
-                                       scs_ptr->max_input_pad_bottom,
-                                       scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-
-            Yv12BufferConfig org_fts;
-            link_eb_to_aom_buffer_desc(context_ptr->org_rec_frame,
-                                       &org_fts,
-                                       scs_ptr->max_input_pad_right,
-                                       scs_ptr->max_input_pad_bottom,
-                                       scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-
-            restoration_seg_search(context_ptr->rst_tmpbuf,
-                                   &org_fts,
+        }
+        // ------- end: Normative upscaling - super-resolution tool
+        // A streamed segment may start while CDEF filters the rows below it,
+        // it only copies the rows its search reads
+        int32_t first_row = 0;
+        int32_t end_row   = cm->frm_size.frame_height;
+        if (pcs_ptr->rest_streaming)
+            svt_av1_rest_segment_row_extent(cm,
+                                            pcs_ptr->rest_segments_row_count,
+                                            cdef_results_ptr->segment_index /
+                                                pcs_ptr->rest_segments_column_count,
+                                            &first_row,
+                                            &end_row);
+        get_own_recon(scs_ptr,
+                      pcs_ptr,
+                      context_ptr,
+                      scs_ptr->static_config.is_16bit_pipeline || is_16bit,
+                      first_row,
+                      end_row);
+        Yv12BufferConfig cpi_source;
+        pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr->is_16bit_pipeline =
+            scs_ptr->static_config.is_16bit_pipeline;
+        link_eb_to_aom_buffer_desc(scs_ptr->static_config.is_16bit_pipeline || is_16bit
+                                       ? pcs_ptr->input_frame16bit
+                                       : pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr,
                                    &cpi_source,
+                                   scs_ptr->max_input_pad_right,
+                                   scs_ptr->max_input_pad_bottom,
+                                   scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+
+        Yv12BufferConfig trial_frame_rst;
+        link_eb_to_aom_buffer_desc(context_ptr->trial_frame_rst,
                                    &trial_frame_rst,
-                                   pcs_ptr,
-                                   cdef_results_ptr->segment_index);
-        }
+                                   scs_ptr->max_input_pad_right,
+                                   scs_ptr->max_input_pad_bottom,
+                                   scs_ptr->static_config.is_16bit_pipeline || is_16bit);
 
-        //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
-        svt_block_on_mutex(pcs_ptr->rest_search_mutex);
-
-        pcs_ptr->tot_seg_searched_rest++;
-        if (pcs_ptr->tot_seg_searched_rest == pcs_ptr->rest_segments_total_count) {
-            if (scs_ptr->seq_header.enable_restoration && frm_hdr->allow_intrabc == 0) {
-                rest_finish_search(pcs_ptr->parent_pcs_ptr,
-                                   pcs_ptr->parent_pcs_ptr->av1x,
-                                   pcs_ptr->parent_pcs_ptr->av1_cm);
-
-                if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-                    cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-                    cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
-                    svt_av1_loop_restoration_filter_frame(cm->frame_to_show, cm, 0);
-                }
-            } else {
-                cm->rst_info[0].frame_restoration_type = RESTORE_NONE;
-                cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
-                cm->rst_info[2].frame_restoration_type = RESTORE_NONE;
-            }
+        Yv12BufferConfig org_fts;
+        link_eb_to_aom_buffer_desc(context_ptr->org_rec_frame,
+                                   &org_fts,
+                                   scs_ptr->max_input_pad_right,
+                                   scs_ptr->max_input_pad_bottom,
+                                   scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+
+        restoration_seg_search(context_ptr->rst_tmpbuf,
+                               &org_fts,
+                               &cpi_source,
+                               &trial_frame_rst,
+                               pcs_ptr,
+                               cdef_results_ptr->segment_index);
+    }
 
-            uint8_t best_ep_cnt = 0;
-            uint8_t best_ep     = 0;
-            for (uint8_t i = 0; i < SGRPROJ_PARAMS; i++) {
-                if (cm->sg_frame_ep_cnt[i] > best_ep_cnt) {
-                    best_ep     = i;
-                    best_ep_cnt = cm->sg_frame_ep_cnt[i];
-                }
-            }
-            cm->sg_frame_ep = best_ep;
+    //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
+    svt_block_on_mutex(pcs_ptr->rest_search_mutex);
 
-            if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
-                // copy stat to ref object (intra_coded_area, Luminance, Scene change detection flags)
-                copy_statistics_to_ref_obj_ect(pcs_ptr, scs_ptr);
+    pcs_ptr->tot_seg_searched_rest++;
+    last_segment = pcs_ptr->tot_seg_searched_rest == pcs_ptr->rest_segments_total_count;
+    if (last_segment) {
+        if (scs_ptr->seq_header.enable_restoration && frm_hdr->allow_intrabc == 0) {
+            svt_arena_reset(context_ptr->arena_ptr);
+            rest_finish_search(context_ptr->arena_ptr,
+                               pcs_ptr->parent_pcs_ptr,
+                               pcs_ptr->parent_pcs_ptr->av1x,
+                               pcs_ptr->parent_pcs_ptr->av1_cm);
+
+            if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+                cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+                cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
+                svt_av1_loop_restoration_filter_frame(cm->frame_to_show, cm, 0);
             }
+        } else {
+            cm->rst_info[0].frame_restoration_type = RESTORE_NONE;
+            cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
+            cm->rst_info[2].frame_restoration_type = RESTORE_NONE;
+        }
 
-            // PSNR and SSIM Calculation.
-            // Note: if temporal_filtering is used, memory needs to be freed in the last of these calls
-            if (scs_ptr->static_config.stat_report) {
-                psnr_calculations(pcs_ptr, scs_ptr, EB_FALSE);
-                ssim_calculations(pcs_ptr, scs_ptr, EB_TRUE /* free memory here */);
+        uint8_t best_ep_cnt = 0;
+        uint8_t best_ep     = 0;
+        for (uint8_t i = 0; i < SGRPROJ_PARAMS; i++) {
+            if (cm->sg_frame_ep_cnt[i] > best_ep_cnt) {
+                best_ep     = i;
+                best_ep_cnt = cm->sg_frame_ep_cnt[i];
             }
+        }
+        cm->sg_frame_ep = best_ep;
 
-            // Pad the reference picture and set ref POC
-            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                pad_ref_and_set_flags(pcs_ptr, scs_ptr);
-            if (scs_ptr->static_config.recon_enabled) {
-                recon_output(pcs_ptr, scs_ptr);
-            }
+        if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
+            // copy stat to ref object (intra_coded_area, Luminance, Scene change detection flags)
+            copy_statistics_to_ref_obj_ect(pcs_ptr, scs_ptr);
+        }
 
-            tile_cols = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_cols;
-            tile_rows = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_rows;
+        // PSNR and SSIM Calculation.
+        // Note: if temporal_filtering is used, memory needs to be freed in the last of these calls
+        if (scs_ptr->static_config.stat_report) {
+            psnr_calculations(pcs_ptr, scs_ptr, EB_FALSE);
+            ssim_calculations(pcs_ptr, scs_ptr, EB_TRUE /* free memory here */);
+        }
 
-            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
-                // Get Empty PicMgr Results
-                svt_get_empty_object(context_ptr->picture_demux_fifo_ptr,
-                                     &picture_demux_results_wrapper_ptr);
+        // Pad the reference picture and set ref POC
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+            pad_ref_and_set_flags(pcs_ptr, scs_ptr);
+    }
+    svt_release_mutex(pcs_ptr->rest_search_mutex);
 
-                picture_demux_results_rtr = (PictureDemuxResults *)
-                                                picture_demux_results_wrapper_ptr->object_ptr;
-                picture_demux_results_rtr->reference_picture_wrapper_ptr =
-                    pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
-                picture_demux_results_rtr->scs_wrapper_ptr = pcs_ptr->scs_wrapper_ptr;
-                picture_demux_results_rtr->picture_number  = pcs_ptr->picture_number;
-                picture_demux_results_rtr->picture_type    = EB_PIC_REFERENCE;
+    if (last_segment && !rest_post_results(context_ptr, cdef_results_wrapper_ptr, 0))
+        return;
+    // Release input Results
+    svt_release_object(cdef_results_wrapper_ptr);
+}
 
-                // Post Reference Picture
-                svt_post_full_object(picture_demux_results_wrapper_ptr);
-            }
+/******************************************************
+ * Rest Pool Task
+ *   Runs one CDEF Results segment on a thread pool worker
+ ******************************************************/
+void rest_pool_task(void *thread_context_ptr, void *wrapper_ptr) {
+    rest_process((RestContext *)((EbThreadContext *)thread_context_ptr)->priv,
+                 (EbObjectWrapper *)wrapper_ptr);
+}
 
-            //Jing: TODO
-            //Consider to add parallelism here, sending line by line, not waiting for a full frame
-            int sb_size_log2 = scs_ptr->seq_header.sb_size_log2;
-            for (int tile_row_idx = 0; tile_row_idx < tile_rows; tile_row_idx++) {
-                uint16_t tile_height_in_sb = (cm->tiles_info.tile_row_start_mi[tile_row_idx + 1] -
-                                              cm->tiles_info.tile_row_start_mi[tile_row_idx] +
-                                              (1 << sb_size_log2) - 1) >>
-                    sb_size_log2;
-                for (int tile_col_idx = 0; tile_col_idx < tile_cols; tile_col_idx++) {
-                    const int tile_idx = tile_row_idx * tile_cols + tile_col_idx;
-                    svt_get_empty_object(context_ptr->rest_output_fifo_ptr,
-                                         &rest_results_wrapper_ptr);
-                    rest_results_ptr = (struct RestResults *)rest_results_wrapper_ptr->object_ptr;
-                    rest_results_ptr->pcs_wrapper_ptr = cdef_results_ptr->pcs_wrapper_ptr;
-                    rest_results_ptr->completed_sb_row_index_start = 0;
-                    // Set to tile rows
-                    rest_results_ptr->completed_sb_row_count = tile_height_in_sb;
-                    rest_results_ptr->tile_index             = tile_idx;
-                    // Post Rest Results
-                    svt_post_full_object(rest_results_wrapper_ptr);
-                }
-            }
-        }
-        svt_release_mutex(pcs_ptr->rest_search_mutex);
+/******************************************************
+ * Rest Kernel
+ ******************************************************/
+void *rest_kernel(void *input_ptr) {
+    EbThreadContext *thread_context_ptr = (EbThreadContext *)input_ptr;
+    RestContext *    context_ptr        = (RestContext *)thread_context_ptr->priv;
+    EbObjectWrapper *cdef_results_wrapper_ptr;
 
-        // Release input Results
-        svt_release_object(cdef_results_wrapper_ptr);
+    for (;;) {
+        // Get Cdef Results
+        EB_GET_FULL_OBJECT(context_ptr->rest_input_fifo_ptr, &cdef_results_wrapper_ptr);
+        rest_process(context_ptr, cdef_results_wrapper_ptr);
     }
 
     return NULL;
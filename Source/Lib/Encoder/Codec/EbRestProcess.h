@@ -21,5 +21,6 @@ extern EbErrorType rest_context_ctor(EbThreadContext *  thread_context_ptr,
                                      const EbEncHandle *enc_handle_ptr, int index, int demux_index);
 
 extern void *rest_kernel(void *input_ptr);
+extern void  rest_pool_task(void *thread_context_ptr, void *wrapper_ptr);
 
 #endif
@@ -19,6 +19,7 @@
 
 #include "EbRestProcess.h"
 #include "EbLog.h"
+#include "EbArena.h"
 
 void av1_foreach_rest_unit_in_frame_seg(Av1Common *cm, int32_t plane, RestTileStartVisitor on_tile,
                                         RestUnitVisitor on_rest_unit, void *priv,
@@ -1568,14 +1569,15 @@ void restoration_seg_search(int32_t *rst_tmpbuf, Yv12BufferConfig *org_fts,
                                            segment_index);
     }
 }
-void rest_finish_search(PictureParentControlSet *p_pcs_ptr, Macroblock *x, Av1Common *const cm) {
+void rest_finish_search(EbArena *arena_ptr, PictureParentControlSet *p_pcs_ptr, Macroblock *x,
+                        Av1Common *const cm) {
     RestorationType force_restore_type_d = (cm->wn_filter_mode) ? RESTORE_TYPES : RESTORE_SGRPROJ;
     int32_t         ntiles[2];
     for (int32_t is_uv = 0; is_uv < 2; ++is_uv) ntiles[is_uv] = rest_tiles_in_plane(cm, is_uv);
 
     assert(ntiles[1] <= ntiles[0]);
-    RestUnitSearchInfo *rusi = (RestUnitSearchInfo *)svt_aom_memalign(16,
-                                                                      sizeof(*rusi) * ntiles[0]);
+    RestUnitSearchInfo *rusi = (RestUnitSearchInfo *)svt_arena_alloc(arena_ptr,
+                                                                     sizeof(*rusi) * ntiles[0]);
 
     // If the restoration unit dimensions are not multiples of
     // rsi->restoration_unit_size then some elements of the rusi array may be
@@ -1627,6 +1629,4 @@ void rest_finish_search(PictureParentControlSet *p_pcs_ptr, Macroblock *x, Av1Co
                 copy_unit_info(best_rtype, &rusi[u], &cm->rst_info[plane].unit_info[u]);
         }
     }
-
-    svt_aom_free(rusi);
 }
@@ -259,6 +259,12 @@ EbErrorType copy_sequence_control_set(SequenceControlSet *dst, SequenceControlSe
     dst->overlay_input_picture_buffer_init_count   = src->overlay_input_picture_buffer_init_count;
     dst->output_stream_buffer_fifo_init_count      = src->output_stream_buffer_fifo_init_count;
     dst->output_recon_buffer_fifo_init_count       = src->output_recon_buffer_fifo_init_count;
+    dst->picture_control_set_pool_min_count        = src->picture_control_set_pool_min_count;
+    dst->me_pool_min_count                         = src->me_pool_min_count;
+    dst->picture_control_set_pool_min_count_child  = src->picture_control_set_pool_min_count_child;
+    dst->pa_reference_picture_buffer_min_count     = src->pa_reference_picture_buffer_min_count;
+    dst->reference_picture_buffer_min_count        = src->reference_picture_buffer_min_count;
+    dst->input_buffer_fifo_min_count               = src->input_buffer_fifo_min_count;
     dst->resource_coordination_fifo_init_count     = src->resource_coordination_fifo_init_count;
     dst->picture_analysis_fifo_init_count          = src->picture_analysis_fifo_init_count;
     dst->picture_decision_fifo_init_count          = src->picture_decision_fifo_init_count;
@@ -304,6 +310,7 @@ EbErrorType copy_sequence_control_set(SequenceControlSet *dst, SequenceControlSe
     dst->down_sampling_method_me_search = src->down_sampling_method_me_search;
     dst->tf_segment_column_count        = src->tf_segment_column_count;
     dst->tf_segment_row_count           = src->tf_segment_row_count;
+    dst->dlf_segment_count              = src->dlf_segment_count;
     dst->over_boundary_block_mode       = src->over_boundary_block_mode;
     dst->mfmv_enabled                   = src->mfmv_enabled;
     dst->scd_delay                      = src->scd_delay;
@@ -341,6 +348,7 @@ static void svt_sequence_control_set_instance_dctor(EbPtr p) {
     EB_DELETE(obj->encode_context_ptr);
     EB_DELETE(obj->scs_ptr);
     EB_DESTROY_MUTEX(obj->config_mutex);
+    EB_FREE_ARRAY(obj->config_changes);
 }
 
 EbErrorType svt_sequence_control_set_instance_ctor(EbSequenceControlSetInstance *object_ptr) {
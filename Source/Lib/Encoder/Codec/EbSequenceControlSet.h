@@ -157,6 +157,7 @@ typedef struct SequenceControlSet {
     uint32_t rest_segment_row_count;
     uint32_t tf_segment_column_count;
     uint32_t tf_segment_row_count;
+    uint32_t dlf_segment_count;
 
     /*!< Picture, reference, recon and input output buffer count */
     uint32_t picture_control_set_pool_init_count;
@@ -168,6 +169,14 @@ typedef struct SequenceControlSet {
     uint32_t overlay_input_picture_buffer_init_count;
     uint32_t output_stream_buffer_fifo_init_count;
     uint32_t output_recon_buffer_fifo_init_count;
+    /*!< Smallest counts the memory budget may construct the pools with, equal
+     * to the init counts when memory_budget is off */
+    uint32_t picture_control_set_pool_min_count;
+    uint32_t me_pool_min_count;
+    uint32_t picture_control_set_pool_min_count_child;
+    uint32_t pa_reference_picture_buffer_min_count;
+    uint32_t reference_picture_buffer_min_count;
+    uint32_t input_buffer_fifo_min_count;
 
     /*!< Inter processes fifos count */
     uint32_t resource_coordination_fifo_init_count;
@@ -217,6 +226,14 @@ typedef struct EbSequenceControlSetInstance {
     EncodeContext *     encode_context_ptr;
     SequenceControlSet *scs_ptr;
     EbHandle            config_mutex;
+    // Configurations of svt_av1_enc_reconfigure, one per picture starting a
+    // new rate, in the order the pictures are sent. The tail is written by
+    // the reconfigure and passed once its picture is sent, the head is
+    // applied to scs_ptr by resource coordination when it gets that picture.
+    EbSvtAv1EncConfiguration *config_changes;
+    uint32_t                  config_change_count;
+    uint32_t                  config_change_head;
+    uint32_t                  config_change_tail;
 } EbSequenceControlSetInstance;
 
 /**************************************
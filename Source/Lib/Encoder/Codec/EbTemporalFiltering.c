@@ -22,6 +22,7 @@
 #include "EbMotionEstimationContext.h"
 #include "EbLambdaRateTables.h"
 #include "EbPictureAnalysisProcess.h"
+#include "EbPictureDecisionProcess.h"
 #include "EbMcp.h"
 #include "av1me.h"
 #ifdef ARCH_X86_64
@@ -31,6 +32,7 @@
 #include "EbEncInterPrediction.h"
 #include "EbComputeVariance_C.h"
 #include "EbLog.h"
+#include "EbPipelineStats.h"
 #include <limits.h>
 #undef _MM_HINT_T2
 #define _MM_HINT_T2 1
@@ -2049,12 +2051,19 @@ static EbErrorType produce_temporally_filtered_pic(
         accumulator, accumulator + BLK_PELS, accumulator + (BLK_PELS << 1)};
     uint16_t *count[COLOR_CHANNELS] = {counter, counter + BLK_PELS, counter + (BLK_PELS << 1)};
 
+    EbArena * arena_ptr       = me_context_ptr->me_context_ptr->tf_arena_ptr;
     EbByte    predictor       = {NULL};
     uint16_t *predictor_16bit = {NULL};
-    if (!is_highbd)
-        EB_MALLOC_ALIGNED_ARRAY(predictor, BLK_PELS * COLOR_CHANNELS);
-    else
-        EB_MALLOC_ALIGNED_ARRAY(predictor_16bit, BLK_PELS * COLOR_CHANNELS);
+    svt_arena_reset(arena_ptr);
+    if (!is_highbd) {
+        predictor = (EbByte)svt_arena_alloc(arena_ptr,
+                                            sizeof(*predictor) * BLK_PELS * COLOR_CHANNELS);
+        EB_CHECK_MEM(predictor);
+    } else {
+        predictor_16bit = (uint16_t *)svt_arena_alloc(
+            arena_ptr, sizeof(*predictor_16bit) * BLK_PELS * COLOR_CHANNELS);
+        EB_CHECK_MEM(predictor_16bit);
+    }
     EbByte    pred[COLOR_CHANNELS] = {predictor, predictor + BLK_PELS, predictor + (BLK_PELS << 1)};
     uint16_t *pred_16bit[COLOR_CHANNELS] = {
         predictor_16bit, predictor_16bit + BLK_PELS, predictor_16bit + (BLK_PELS << 1)};
@@ -2397,10 +2406,6 @@ static EbErrorType produce_temporally_filtered_pic(
         }
     }
 
-    if (!is_highbd)
-        EB_FREE_ALIGNED_ARRAY(predictor);
-    else
-        EB_FREE_ALIGNED_ARRAY(predictor_16bit);
     return EB_ErrorNone;
 }
 
@@ -2817,8 +2822,9 @@ EbErrorType svt_av1_init_temporal_filtering(
         picture_control_set_ptr_central->filtered_sse_uv += filtered_sse_uv >> 4;
     }
 
-    if (picture_control_set_ptr_central->temp_filt_seg_acc ==
-        picture_control_set_ptr_central->tf_segments_total_count) {
+    const EbBool tf_done = picture_control_set_ptr_central->temp_filt_seg_acc ==
+        picture_control_set_ptr_central->tf_segments_total_count;
+    if (tf_done) {
 #if DEBUG_TF
         if (!is_highbd)
             save_YUV_to_file("filtered_picture.yuv",
@@ -2886,11 +2892,23 @@ EbErrorType svt_av1_init_temporal_filtering(
              (central_picture_ptr->width >> ss_x) / (central_picture_ptr->height >> ss_y)) /
             2;
 
-        // signal that temp filt is done
-        svt_post_semaphore(picture_control_set_ptr_central->temp_filt_done_semaphore);
+        if (picture_control_set_ptr_central->scs_ptr->static_config.enable_pipeline_stats) {
+            EncodeContext *encode_context_ptr =
+                picture_control_set_ptr_central->scs_ptr->encode_context_ptr;
+            uint64_t latency =
+                svt_pipeline_stats_time() - picture_control_set_ptr_central->tf_post_time;
+            svt_block_on_mutex(encode_context_ptr->tf_stats_mutex);
+            encode_context_ptr->tf_picture_count++;
+            encode_context_ptr->tf_latency_total += latency;
+            encode_context_ptr->tf_latency_max = MAX(encode_context_ptr->tf_latency_max, latency);
+            svt_release_mutex(encode_context_ptr->tf_stats_mutex);
+        }
     }
 
     svt_release_mutex(picture_control_set_ptr_central->temp_filt_mutex);
+    // signal that temp filt is done
+    if (tf_done)
+        svt_tf_picture_done(picture_control_set_ptr_central);
 
     return EB_ErrorNone;
 }
@@ -287,6 +287,121 @@ void svt_set_thread_management_parameters(EbSvtAv1EncConfiguration *config_ptr)
 #endif
 }
 
+/*********************************************************************
+ * NUMA placement
+ *   The nodes used are the ones holding a logical processor of the
+ *   thread affinity (all online nodes when threads are not pinned). The threads
+ *   of the parallel stages and their contexts are spread round-robin
+ *   over them.
+ *********************************************************************/
+static void init_numa_nodes(EbEncHandle *enc_handle_ptr)
+{
+    const uint32_t node_count = svt_numa_node_count();
+    EbBool         node_used[EB_NUMA_MAX_NODES];
+
+    enc_handle_ptr->numa_node_count = 0;
+    if (node_count <= 1)
+        return;
+    for (uint32_t node = 0; node < node_count; node++)
+        node_used[node] = svt_numa_node_online(node);
+#if defined(__linux__)
+    if (CPU_COUNT(&group_affinity)) {
+        for (uint32_t node = 0; node < node_count; node++)
+            node_used[node] = EB_FALSE;
+        for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &group_affinity))
+                node_used[svt_numa_node_of_cpu(cpu)] = EB_TRUE;
+    }
+#endif
+    for (uint32_t node = 0; node < node_count; node++)
+        if (node_used[node])
+            enc_handle_ptr->numa_node_array[enc_handle_ptr->numa_node_count++] = node;
+}
+
+// Places the pages the calling thread touches next on the node of process_index
+static void prefer_process_node(const EbEncHandle *enc_handle_ptr, uint32_t process_index)
+{
+    if (enc_handle_ptr->numa_node_count)
+        svt_numa_prefer_node(enc_handle_ptr->numa_node_array[process_index % enc_handle_ptr->numa_node_count]);
+}
+
+static void bind_process_thread(const EbEncHandle *enc_handle_ptr, EbHandle thread_handle, uint32_t process_index)
+{
+#if defined(__linux__)
+    const void *affinity_ptr = CPU_COUNT(&group_affinity) ? &group_affinity : NULL;
+#else
+    const void *affinity_ptr = NULL;
+#endif
+    if (enc_handle_ptr->numa_node_count)
+        svt_numa_bind_thread(thread_handle,
+            enc_handle_ptr->numa_node_array[process_index % enc_handle_ptr->numa_node_count], affinity_ptr);
+}
+
+static void bind_process_threads(const EbEncHandle *enc_handle_ptr, EbHandle *thread_array, uint32_t count)
+{
+    // Fibers run on the workers of the pool
+    if (enc_handle_ptr->pool_client)
+        return;
+    for (uint32_t i = 0; i < count; i++)
+        bind_process_thread(enc_handle_ptr, thread_array[i], i);
+}
+
+// With a thread pool, the stages that loop over their input fifos run as
+// fibers of the pool client, so the channel adds no thread of its own
+#define EB_CREATE_STAGE(client_ptr, pointer, kernel, context)           \
+    do {                                                                \
+        if (client_ptr) {                                               \
+            EB_CREATE_POOL_FIBER(pointer, client_ptr, kernel, context); \
+        } else {                                                        \
+            EB_CREATE_THREAD(pointer, kernel, context);                 \
+        }                                                               \
+    } while (0)
+
+#define EB_CREATE_STAGE_ARRAY(client_ptr, pa, count, kernel, contexts)           \
+    do {                                                                         \
+        if (client_ptr) {                                                        \
+            EB_CREATE_POOL_FIBER_ARRAY(pa, count, client_ptr, kernel, contexts); \
+        } else {                                                                 \
+            EB_CREATE_THREAD_ARRAY(pa, count, kernel, contexts);                 \
+        }                                                                        \
+    } while (0)
+
+#define EB_DESTROY_STAGE(client_ptr, pointer) \
+    do {                                      \
+        if (client_ptr) {                     \
+            EB_DESTROY_FIBER(pointer);        \
+        } else {                              \
+            EB_DESTROY_THREAD(pointer);       \
+        }                                     \
+    } while (0)
+
+#define EB_DESTROY_STAGE_ARRAY(client_ptr, pa, count) \
+    do {                                              \
+        if (client_ptr) {                             \
+            EB_DESTROY_FIBER_ARRAY(pa, count);        \
+        } else {                                      \
+            EB_DESTROY_THREAD_ARRAY(pa, count);       \
+        }                                             \
+    } while (0)
+
+// Picture buffers are read by threads on every node in use: interleave them
+// over these nodes, unless the encoder runs on a single target socket
+static void set_picture_pool_numa_policy(const EbEncHandle *enc_handle_ptr, const EbSvtAv1EncConfiguration *config_ptr)
+{
+#if defined(__linux__)
+    if (config_ptr->target_socket != -1 && lp_group[config_ptr->target_socket].num) {
+        svt_numa_prefer_node(svt_numa_node_of_cpu(lp_group[config_ptr->target_socket].group[0]));
+        return;
+    }
+#else
+    UNUSED(config_ptr);
+#endif
+    if (enc_handle_ptr->numa_node_count == 1)
+        svt_numa_prefer_node(enc_handle_ptr->numa_node_array[0]);
+    else
+        svt_numa_interleave(enc_handle_ptr->numa_node_array, enc_handle_ptr->numa_node_count);
+}
+
 void asm_set_convolve_asm_table(void);
 void asm_set_convolve_hbd_asm_table(void);
 void init_intra_dc_predictors_c_internal(void);
@@ -386,6 +501,11 @@ EbErrorType load_default_buffer_configuration_settings(
         scs_ptr->static_config.logical_processors > lp_count / num_groups)
         core_count = lp_count;
 #endif
+    // The channels of a shared pool split its workers, the process and
+    // context counts of every stage of a channel follow its share
+    if (scs_ptr->static_config.thread_pool && scs_ptr->static_config.logical_processors == 0)
+        core_count = MAX(1, ((EbThreadPool *)scs_ptr->static_config.thread_pool)->worker_count /
+            MAX(1, scs_ptr->static_config.active_channel_count));
     int32_t return_ppcs = set_parent_pcs(&scs_ptr->static_config,
         core_count, scs_ptr->input_resolution);
     if (return_ppcs == -1)
@@ -393,14 +513,15 @@ EbErrorType load_default_buffer_configuration_settings(
 
     uint32_t input_pic = (uint32_t)return_ppcs;
     scs_ptr->input_buffer_fifo_init_count = input_pic + SCD_LAD + scs_ptr->static_config.look_ahead_distance;
+    // One EncDec segment per SB, scheduled as a wavefront (see enc_dec_segments_wpp_update())
     uint32_t enc_dec_seg_h = (core_count == SINGLE_CORE_COUNT) ? 1 :
         (scs_ptr->static_config.super_block_size == 128) ?
-        ((scs_ptr->max_input_luma_height + 64) / 128) :
-        ((scs_ptr->max_input_luma_height + 32) / 64);
+        ((scs_ptr->max_input_luma_height + 127) / 128) :
+        ((scs_ptr->max_input_luma_height + 63) / 64);
     uint32_t enc_dec_seg_w = (core_count == SINGLE_CORE_COUNT) ? 1 :
         (scs_ptr->static_config.super_block_size == 128) ?
-        ((scs_ptr->max_input_luma_width + 64) / 128) :
-        ((scs_ptr->max_input_luma_width + 32) / 64);
+        ((scs_ptr->max_input_luma_width + 127) / 128) :
+        ((scs_ptr->max_input_luma_width + 63) / 64);
     uint32_t me_seg_h = (core_count == SINGLE_CORE_COUNT) ? 1 :
         (((scs_ptr->max_input_luma_height + 32) / BLOCK_SIZE_64) < 6) ? 1 : 6;
     uint32_t me_seg_w = (core_count == SINGLE_CORE_COUNT) ? 1 :
@@ -474,8 +595,15 @@ EbErrorType load_default_buffer_configuration_settings(
     scs_ptr->rest_segment_column_count =  MIN(rest_seg_w, 6);
     scs_ptr->rest_segment_row_count =  MIN(rest_seg_h, 4);
 
-    scs_ptr->tf_segment_column_count = me_seg_w;//1;//
-    scs_ptr->tf_segment_row_count =  me_seg_h;//1;//
+    // One temporal filtering segment per row of 64x64 blocks
+    scs_ptr->tf_segment_column_count = 1;
+    scs_ptr->tf_segment_row_count = (core_count == SINGLE_CORE_COUNT) ? 1 :
+        MAX((scs_ptr->max_input_luma_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64, 1);
+
+    // Frame deblocking in the DLF stage: up to one band of SB rows, then of SB
+    // columns, per core. Kept well below enc_dec_fifo_init_count since the
+    // bands are fed back through the EncDec results.
+    scs_ptr->dlf_segment_count = (core_count == SINGLE_CORE_COUNT) ? 1 : MIN(core_count, 16);
     //#====================== Data Structures and Picture Buffers ======================
     scs_ptr->picture_control_set_pool_init_count       = input_pic + SCD_LAD + scs_ptr->static_config.look_ahead_distance;
     if (scs_ptr->static_config.enable_overlays)
@@ -516,8 +644,9 @@ EbErrorType load_default_buffer_configuration_settings(
 
         /*To accomodate FFMPEG EOS, 1 frame delay is needed in Resource coordination.
            note that we have the option to not add 1 frame delay of Resource Coordination. In this case we have wait for first I frame
-           to be released back to be able to start first base(16). Anyway poc16 needs to wait for poc0 to finish.*/
-        uint32_t eos_delay = 1;
+           to be released back to be able to start first base(16). Anyway poc16 needs to wait for poc0 to finish.
+           The low-latency mode signals the EOS once the last packet is out instead.*/
+        uint32_t eos_delay = scs_ptr->static_config.max_frames_in_flight ? 0 : 1;
 
         //Minimum input pictures needed in the pipeline
         return_ppcs = (mg_size + 1) + eos_delay + scs_ptr->scd_delay + needed_lad_pictures;
@@ -599,6 +728,28 @@ EbErrorType load_default_buffer_configuration_settings(
             scs_ptr->me_pool_init_count = MAX(min_me, scs_ptr->picture_control_set_pool_init_count);
         }
     }
+    // Under a memory budget the pools start from the minimum counts and only
+    // grow towards the counts above while the budget allows
+    if (scs_ptr->static_config.memory_budget) {
+        scs_ptr->input_buffer_fifo_min_count = MIN(min_input, scs_ptr->input_buffer_fifo_init_count);
+        scs_ptr->picture_control_set_pool_min_count = MIN(min_parent, scs_ptr->picture_control_set_pool_init_count);
+        scs_ptr->me_pool_min_count = MIN(min_me, scs_ptr->me_pool_init_count);
+        scs_ptr->picture_control_set_pool_min_count_child = MIN(min_child, scs_ptr->picture_control_set_pool_init_count_child);
+        scs_ptr->pa_reference_picture_buffer_min_count = MIN(min_paref, scs_ptr->pa_reference_picture_buffer_init_count);
+        scs_ptr->reference_picture_buffer_min_count = MIN(min_ref, scs_ptr->reference_picture_buffer_init_count);
+    } else {
+        scs_ptr->input_buffer_fifo_min_count = scs_ptr->input_buffer_fifo_init_count;
+        scs_ptr->picture_control_set_pool_min_count = scs_ptr->picture_control_set_pool_init_count;
+        scs_ptr->me_pool_min_count = scs_ptr->me_pool_init_count;
+        scs_ptr->picture_control_set_pool_min_count_child = scs_ptr->picture_control_set_pool_init_count_child;
+        scs_ptr->pa_reference_picture_buffer_min_count = scs_ptr->pa_reference_picture_buffer_init_count;
+        scs_ptr->reference_picture_buffer_min_count = scs_ptr->reference_picture_buffer_init_count;
+    }
+    // The input buffers are released once the picture is packetized, their
+    // count bounds the pictures in flight
+    if (scs_ptr->static_config.max_frames_in_flight)
+        scs_ptr->input_buffer_fifo_init_count = scs_ptr->input_buffer_fifo_min_count =
+            scs_ptr->static_config.max_frames_in_flight;
 
     //#====================== Inter process Fifos ======================
     scs_ptr->resource_coordination_fifo_init_count       = 300;
@@ -741,33 +892,34 @@ void lib_svt_encoder_send_error_exit(
 static void svt_enc_handle_stop_threads(EbEncHandle *enc_handle_ptr)
 {
     SequenceControlSet*  control_set_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
+    EbPoolClient*        client_ptr = enc_handle_ptr->pool_client;
     // Resource Coordination
-    EB_DESTROY_THREAD(enc_handle_ptr->resource_coordination_thread_handle);
-    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->picture_analysis_thread_handle_array,control_set_ptr->picture_analysis_process_init_count);
+    EB_DESTROY_STAGE(client_ptr, enc_handle_ptr->resource_coordination_thread_handle);
+    EB_DESTROY_STAGE_ARRAY(client_ptr, enc_handle_ptr->picture_analysis_thread_handle_array,control_set_ptr->picture_analysis_process_init_count);
 
     // Picture Decision
-    EB_DESTROY_THREAD(enc_handle_ptr->picture_decision_thread_handle);
+    EB_DESTROY_STAGE(client_ptr, enc_handle_ptr->picture_decision_thread_handle);
 
     // Motion Estimation
-    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->motion_estimation_thread_handle_array, control_set_ptr->motion_estimation_process_init_count);
+    EB_DESTROY_STAGE_ARRAY(client_ptr, enc_handle_ptr->motion_estimation_thread_handle_array, control_set_ptr->motion_estimation_process_init_count);
 
     // Initial Rate Control
-    EB_DESTROY_THREAD(enc_handle_ptr->initial_rate_control_thread_handle);
+    EB_DESTROY_STAGE(client_ptr, enc_handle_ptr->initial_rate_control_thread_handle);
 
     // Source Based Oprations
-    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->source_based_operations_thread_handle_array, control_set_ptr->source_based_operations_process_init_count);
+    EB_DESTROY_STAGE_ARRAY(client_ptr, enc_handle_ptr->source_based_operations_thread_handle_array, control_set_ptr->source_based_operations_process_init_count);
 
     // Picture Manager
-    EB_DESTROY_THREAD(enc_handle_ptr->picture_manager_thread_handle);
+    EB_DESTROY_STAGE(client_ptr, enc_handle_ptr->picture_manager_thread_handle);
 
     // Inloop ME
-    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->ime_thread_handle_array, control_set_ptr->inlme_process_init_count);
+    EB_DESTROY_STAGE_ARRAY(client_ptr, enc_handle_ptr->ime_thread_handle_array, control_set_ptr->inlme_process_init_count);
 
     // Rate Control
-    EB_DESTROY_THREAD(enc_handle_ptr->rate_control_thread_handle);
+    EB_DESTROY_STAGE(client_ptr, enc_handle_ptr->rate_control_thread_handle);
 
     // Mode Decision Configuration Process
-    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->mode_decision_configuration_thread_handle_array, control_set_ptr->mode_decision_configuration_process_init_count);
+    EB_DESTROY_STAGE_ARRAY(client_ptr, enc_handle_ptr->mode_decision_configuration_thread_handle_array, control_set_ptr->mode_decision_configuration_process_init_count);
 
     // EncDec Process
     EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->enc_dec_thread_handle_array, control_set_ptr->enc_dec_process_init_count);
@@ -782,10 +934,33 @@ static void svt_enc_handle_stop_threads(EbEncHandle *enc_handle_ptr)
     EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->rest_thread_handle_array, control_set_ptr->rest_process_init_count);
 
     // Entropy Coding Process
-    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count);
+    EB_DESTROY_STAGE_ARRAY(client_ptr, enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count);
 
     // Packetization
-    EB_DESTROY_THREAD(enc_handle_ptr->packetization_thread_handle);
+    EB_DESTROY_STAGE(client_ptr, enc_handle_ptr->packetization_thread_handle);
+
+    // Thread Pool, after every thread and fiber that can submit to it has
+    // exited; the client waits for the tasks still running in a shared pool
+    EB_DELETE(enc_handle_ptr->pool_client);
+    EB_DELETE(enc_handle_ptr->thread_pool);
+}
+/**********************************
+* Hands back the zero copy input buffers the pipeline
+* still held when its threads stopped, e.g. the last
+* pictures when the encoder is deinitialized before
+* their rate control feedback was processed
+**********************************/
+static void svt_enc_handle_release_input_buffers(EbEncHandle *enc_handle_ptr)
+{
+    EbSystemResource *resource_ptr = enc_handle_ptr->input_buffer_resource_ptr;
+
+    if (!resource_ptr || !resource_ptr->release_fn)
+        return;
+    for (uint32_t i = 0; i < resource_ptr->object_total_count; i++) {
+        EbObjectWrapper *wrapper_ptr = resource_ptr->wrapper_ptr_pool[i];
+        if (wrapper_ptr && wrapper_ptr->object_ptr)
+            resource_ptr->release_fn(resource_ptr->release_context_ptr, wrapper_ptr);
+    }
 }
 /**********************************
 * Encoder Library Handle Deonstructor
@@ -795,6 +970,7 @@ static void svt_enc_handle_dctor(EbPtr p)
     EbEncHandle *enc_handle_ptr = (EbEncHandle *)p;
 
     svt_enc_handle_stop_threads(enc_handle_ptr);
+    svt_enc_handle_release_input_buffers(enc_handle_ptr);
     EB_FREE_PTR_ARRAY(enc_handle_ptr->app_callback_ptr_array, enc_handle_ptr->encode_instance_total_count);
     EB_DELETE(enc_handle_ptr->scs_pool_ptr);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->picture_parent_control_set_pool_ptr_array, enc_handle_ptr->encode_instance_total_count);
@@ -821,6 +997,7 @@ static void svt_enc_handle_dctor(EbPtr p)
     EB_DELETE(enc_handle_ptr->cdef_results_resource_ptr);
     EB_DELETE(enc_handle_ptr->rest_results_resource_ptr);
     EB_DELETE(enc_handle_ptr->entropy_coding_results_resource_ptr);
+    EB_DELETE(enc_handle_ptr->pipeline_stats);
 
     EB_DELETE(enc_handle_ptr->resource_coordination_context_ptr);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->picture_analysis_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->picture_analysis_process_init_count);
@@ -875,6 +1052,14 @@ EbErrorType svt_input_buffer_header_creator(
     EbPtr *object_dbl_ptr,
     EbPtr  object_init_data_ptr);
 
+EbErrorType svt_zero_copy_input_buffer_header_creator(
+    EbPtr *object_dbl_ptr,
+    EbPtr  object_init_data_ptr);
+
+void svt_zero_copy_input_buffer_release(
+    EbPtr            context_ptr,
+    EbObjectWrapper *wrapper_ptr);
+
 EbErrorType svt_output_recon_buffer_header_creator(
     EbPtr *object_dbl_ptr,
     EbPtr  object_init_data_ptr);
@@ -957,6 +1142,29 @@ EbErrorType rest_results_creator(
     return EB_ErrorNone;
 }
 
+/**********************************
+* Memory Budget
+**********************************/
+// Pools sized by the memory budget, in creation order: parent PCS, ME,
+// child PCS, reference, PA reference and input
+#define BUDGET_POOL_COUNT 6
+
+/* Byte limit of the next pool sized by the memory budget, an even share of
+ * what is left of the budget between the pools still to construct */
+static size_t get_budget_pool_byte_limit(EbEncHandle *enc_handle_ptr)
+{
+    const uint64_t budget = (uint64_t)enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.memory_budget << 20;
+    const uint64_t used = svt_thread_alloc_bytes() - enc_handle_ptr->init_start_bytes;
+    const uint32_t pools_left = BUDGET_POOL_COUNT - MIN(enc_handle_ptr->budget_pool_index, BUDGET_POOL_COUNT - 1);
+
+    enc_handle_ptr->budget_pool_index++;
+    if (!budget)
+        return SIZE_MAX;
+    if (used >= budget)
+        return 0;
+    return (size_t)MIN((budget - used) / pools_left, (uint64_t)SIZE_MAX);
+}
+
 static int create_down_scaled_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instance_index)
 {
     SequenceControlSet* scs_ptr = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr;
@@ -1060,13 +1268,17 @@ static int create_pa_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instanc
         eb_pa_ref_obj_ect_desc_init_data_structure.sixteenth_picture_desc_init_data = sixteenth_pic_buf_desc_init_data;
         // Reference Picture Buffers
         EB_NEW(enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_budget_ctor,
+            scs_ptr->pa_reference_picture_buffer_min_count,
             scs_ptr->pa_reference_picture_buffer_init_count,
+            get_budget_pool_byte_limit(enc_handle_ptr),
             EB_PictureDecisionProcessInitCount,
             0,
             svt_pa_reference_object_creator,
             &(eb_pa_ref_obj_ect_desc_init_data_structure),
             NULL);
+        scs_ptr->pa_reference_picture_buffer_init_count =
+            enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index]->object_total_count;
         // Set the SequenceControlSet Picture Pool Fifo Ptrs
         enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->pa_reference_picture_pool_fifo_ptr =
             svt_system_resource_get_producer_fifo(enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index], 0);
@@ -1111,29 +1323,132 @@ static int create_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instance_i
     // Reference Picture Buffers
     EB_NEW(
             enc_handle_ptr->reference_picture_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_budget_ctor,
+            scs_ptr->reference_picture_buffer_min_count,
             scs_ptr->reference_picture_buffer_init_count,//enc_handle_ptr->ref_pic_pool_total_count,
+            get_budget_pool_byte_limit(enc_handle_ptr),
             EB_PictureManagerProcessInitCount,
             0,
             svt_reference_object_creator,
             &(eb_ref_obj_ect_desc_init_data_structure),
             NULL);
+    scs_ptr->reference_picture_buffer_init_count =
+        enc_handle_ptr->reference_picture_pool_ptr_array[instance_index]->object_total_count;
 
     enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->reference_picture_pool_fifo_ptr =
         svt_system_resource_get_producer_fifo(enc_handle_ptr->reference_picture_pool_ptr_array[instance_index], 0);
     return 0;
 }
 
+/**********************************
+* Pipeline Stats
+**********************************/
+// Picture number of a stage object through its pcs_wrapper_ptr, the parent
+// control set up to the picture manager and the child one after it
+#define PIPELINE_PICTURE_FN(results_type, pcs_type)                                          \
+    static uint64_t results_type##_picture_number(EbPtr object_ptr) {                        \
+        const results_type *results_ptr = (const results_type *)object_ptr;                  \
+        if (!results_ptr->pcs_wrapper_ptr)                                                   \
+            return EB_STAGE_TRACE_NO_PICTURE;                                                \
+        return ((const pcs_type *)results_ptr->pcs_wrapper_ptr->object_ptr)->picture_number; \
+    }
+
+PIPELINE_PICTURE_FN(ResourceCoordinationResults, PictureParentControlSet)
+PIPELINE_PICTURE_FN(PictureAnalysisResults, PictureParentControlSet)
+PIPELINE_PICTURE_FN(PictureDecisionResults, PictureParentControlSet)
+PIPELINE_PICTURE_FN(MotionEstimationResults, PictureParentControlSet)
+PIPELINE_PICTURE_FN(InitialRateControlResults, PictureParentControlSet)
+PIPELINE_PICTURE_FN(PictureManagerResults, PictureParentControlSet)
+PIPELINE_PICTURE_FN(RateControlResults, PictureControlSet)
+PIPELINE_PICTURE_FN(EncDecTasks, PictureControlSet)
+PIPELINE_PICTURE_FN(EncDecResults, PictureControlSet)
+PIPELINE_PICTURE_FN(DlfResults, PictureControlSet)
+PIPELINE_PICTURE_FN(CdefResults, PictureControlSet)
+PIPELINE_PICTURE_FN(RestResults, PictureControlSet)
+PIPELINE_PICTURE_FN(EntropyCodingResults, PictureControlSet)
+#undef PIPELINE_PICTURE_FN
+
+// Input pictures carry their parent control set, the reference and feedback
+// notifications only the picture number
+static uint64_t PictureDemuxResults_picture_number(EbPtr object_ptr) {
+    const PictureDemuxResults *results_ptr = (const PictureDemuxResults *)object_ptr;
+    if (results_ptr->picture_type == EB_PIC_INPUT)
+        return ((const PictureParentControlSet *)results_ptr->pcs_wrapper_ptr->object_ptr)
+            ->picture_number;
+    return results_ptr->picture_number;
+}
+
+static uint64_t RateControlTasks_picture_number(EbPtr object_ptr) {
+    const RateControlTasks *tasks_ptr = (const RateControlTasks *)object_ptr;
+    switch (tasks_ptr->task_type) {
+    case RC_INPUT:
+        return ((const PictureControlSet *)tasks_ptr->pcs_wrapper_ptr->object_ptr)
+            ->picture_number;
+    case RC_PACKETIZATION_FEEDBACK_RESULT:
+        return ((const PictureParentControlSet *)tasks_ptr->pcs_wrapper_ptr->object_ptr)
+            ->picture_number;
+    default: return tasks_ptr->picture_number;
+    }
+}
+
+static EbErrorType svt_enc_handle_attach_pipeline_stats(EbEncHandle *enc_handle_ptr)
+{
+    // Queues in pipeline order, each named after the stage consuming it. The
+    // input buffers get their picture number in resource coordination.
+    const struct {
+        EbSystemResource *resource_ptr;
+        const char       *stage_name;
+        EbStagePictureFn  picture_fn;
+    } stages[] = {
+        { enc_handle_ptr->input_buffer_resource_ptr, "resource_coordination", NULL },
+        { enc_handle_ptr->resource_coordination_results_resource_ptr, "picture_analysis",
+          ResourceCoordinationResults_picture_number },
+        { enc_handle_ptr->picture_analysis_results_resource_ptr, "picture_decision",
+          PictureAnalysisResults_picture_number },
+        { enc_handle_ptr->picture_decision_results_resource_ptr, "motion_estimation",
+          PictureDecisionResults_picture_number },
+        { enc_handle_ptr->motion_estimation_results_resource_ptr, "initial_rate_control",
+          MotionEstimationResults_picture_number },
+        { enc_handle_ptr->initial_rate_control_results_resource_ptr, "source_based_operations",
+          InitialRateControlResults_picture_number },
+        { enc_handle_ptr->picture_demux_results_resource_ptr, "picture_manager",
+          PictureDemuxResults_picture_number },
+        { enc_handle_ptr->pic_mgr_res_srm, "in_loop_me", PictureManagerResults_picture_number },
+        { enc_handle_ptr->rate_control_tasks_resource_ptr, "rate_control",
+          RateControlTasks_picture_number },
+        { enc_handle_ptr->rate_control_results_resource_ptr, "mode_decision_configuration",
+          RateControlResults_picture_number },
+        { enc_handle_ptr->enc_dec_tasks_resource_ptr, "enc_dec", EncDecTasks_picture_number },
+        { enc_handle_ptr->enc_dec_results_resource_ptr, "deblocking",
+          EncDecResults_picture_number },
+        { enc_handle_ptr->dlf_results_resource_ptr, "cdef", DlfResults_picture_number },
+        { enc_handle_ptr->cdef_results_resource_ptr, "restoration", CdefResults_picture_number },
+        { enc_handle_ptr->rest_results_resource_ptr, "entropy_coding",
+          RestResults_picture_number },
+        { enc_handle_ptr->entropy_coding_results_resource_ptr, "packetization",
+          EntropyCodingResults_picture_number },
+    };
+    const uint32_t stage_count = sizeof(stages) / sizeof(stages[0]);
+
+    EB_NEW(enc_handle_ptr->pipeline_stats, svt_pipeline_stats_ctor, stage_count);
+    for (uint32_t i = 0; i < stage_count; i++) {
+        EbErrorType return_error = svt_system_resource_attach_stats(stages[i].resource_ptr,
+                                                                    enc_handle_ptr->pipeline_stats,
+                                                                    stages[i].stage_name,
+                                                                    stages[i].picture_fn);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
+    return EB_ErrorNone;
+}
+
 void init_fn_ptr(void);
 void svt_av1_init_wedge_masks(void);
 /**********************************
 * Initialize Encoder Library
 **********************************/
-EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
+static EbErrorType svt_enc_handle_init(EbEncHandle *enc_handle_ptr)
 {
-    if(svt_enc_component == NULL)
-        return EB_ErrorBadParameter;
-    EbEncHandle *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
     EbErrorType return_error = EB_ErrorNone;
     uint32_t instance_index;
     uint32_t process_index;
@@ -1159,6 +1474,15 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     svt_av1_init_me_luts();
     init_fn_ptr();
     svt_av1_init_wedge_masks();
+
+    EbSvtAv1EncConfiguration   *config_ptr = &enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config;
+    if (config_ptr->unpin == 0)
+        svt_set_thread_management_parameters(config_ptr);
+    if (config_ptr->enable_numa_alloc) {
+        init_numa_nodes(enc_handle_ptr);
+        svt_numa_get_stats(&enc_handle_ptr->numa_stats);
+        set_picture_pool_numa_policy(enc_handle_ptr, config_ptr);
+    }
     /************************************
     * Sequence Control Set
     ************************************/
@@ -1208,22 +1532,30 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
         input_data.in_loop_ois = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->in_loop_ois;
         EB_NEW(
             enc_handle_ptr->picture_parent_control_set_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_budget_ctor,
+            enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_min_count,
             enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_init_count,//enc_handle_ptr->pcs_pool_total_count,
+            get_budget_pool_byte_limit(enc_handle_ptr),
             1,
             0,
             picture_parent_control_set_creator,
             &input_data,
             NULL);
+        enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_init_count =
+            enc_handle_ptr->picture_parent_control_set_pool_ptr_array[instance_index]->object_total_count;
         EB_NEW(
             enc_handle_ptr->me_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_budget_ctor,
+            enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->me_pool_min_count,
             enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->me_pool_init_count,
+            get_budget_pool_byte_limit(enc_handle_ptr),
             1,
             0,
             me_creator,
             &input_data,
             NULL);
+        enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->me_pool_init_count =
+            enc_handle_ptr->me_pool_ptr_array[instance_index]->object_total_count;
     }
 
     /************************************
@@ -1270,13 +1602,17 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
         input_data.is_16bit_pipeline = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.is_16bit_pipeline;
         EB_NEW(
             enc_handle_ptr->picture_control_set_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_budget_ctor,
+            enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_min_count_child,
             enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_init_count_child, //EB_PictureControlSetPoolInitCountChild,
+            get_budget_pool_byte_limit(enc_handle_ptr),
             1,
             0,
             picture_control_set_creator,
             &input_data,
             NULL);
+        enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_init_count_child =
+            enc_handle_ptr->picture_control_set_pool_ptr_array[instance_index]->object_total_count;
     }
 
     /************************************
@@ -1331,16 +1667,31 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     // EbBufferHeaderType Input
     EB_NEW(
         enc_handle_ptr->input_buffer_resource_ptr,
-        svt_system_resource_ctor,
+        svt_system_resource_budget_ctor,
+        enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_min_count,
         enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_init_count,
+        get_budget_pool_byte_limit(enc_handle_ptr),
         1,
         EB_ResourceCoordinationProcessInitCount,
-        svt_input_buffer_header_creator,
+        config_ptr->zero_copy_input ? svt_zero_copy_input_buffer_header_creator : svt_input_buffer_header_creator,
         enc_handle_ptr->scs_instance_array[0]->scs_ptr,
         svt_input_buffer_header_destroyer);
+    if (config_ptr->zero_copy_input)
+        svt_system_resource_set_release_callback(enc_handle_ptr->input_buffer_resource_ptr,
+            svt_zero_copy_input_buffer_release, enc_handle_ptr->scs_instance_array[0]->scs_ptr);
 
+    enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_init_count =
+        enc_handle_ptr->input_buffer_resource_ptr->object_total_count;
     enc_handle_ptr->input_buffer_producer_fifo_ptr = svt_system_resource_get_producer_fifo(enc_handle_ptr->input_buffer_resource_ptr, 0);
 
+    // A picture starting a new rate holds its input buffer until resource
+    // coordination applies the rate, so one entry per input buffer and the one
+    // of the next picture to send cover every reconfigure in flight
+    enc_handle_ptr->scs_instance_array[0]->config_change_count =
+        enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_init_count + 1;
+    EB_MALLOC_ARRAY(enc_handle_ptr->scs_instance_array[0]->config_changes,
+                    enc_handle_ptr->scs_instance_array[0]->config_change_count);
+
 
     // EbBufferHeaderType Output Stream
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->output_stream_buffer_resource_ptr_array, enc_handle_ptr->encode_instance_total_count);
@@ -1355,6 +1706,18 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
             svt_output_buffer_header_creator,
             &enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config,
             svt_output_buffer_header_destroyer);
+        svt_system_resource_set_release_callback(
+            enc_handle_ptr->output_stream_buffer_resource_ptr_array[instance_index],
+            svt_output_stream_buffer_release,
+            enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->output_buffer_pool_ptr);
+        if (enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.tile_group_output) {
+            // room for the fragments of every picture, one per tile but the last
+            EbSvtAv1EncConfiguration *config = &enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config;
+            EncodeContext *encode_context_ptr = enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr;
+            encode_context_ptr->tile_group_stride = (1 << config->tile_rows) * (1 << config->tile_columns);
+            EB_CALLOC_ARRAY(encode_context_ptr->tile_group_fragments,
+                            PACKETIZATION_REORDER_QUEUE_MAX_DEPTH * encode_context_ptr->tile_group_stride);
+        }
     }
     enc_handle_ptr->output_stream_buffer_consumer_fifo_ptr = svt_system_resource_get_consumer_fifo(enc_handle_ptr->output_stream_buffer_resource_ptr_array[0], 0);
     if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.recon_enabled) {
@@ -1541,7 +1904,8 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
             enc_handle_ptr->enc_dec_results_resource_ptr,
             svt_system_resource_ctor,
             enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_fifo_init_count,
-            enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count +
+                enc_handle_ptr->scs_instance_array[0]->scs_ptr->dlf_process_init_count,
             enc_handle_ptr->scs_instance_array[0]->scs_ptr->dlf_process_init_count,
             enc_dec_results_creator,
             &enc_dec_result_init_data,
@@ -1621,6 +1985,8 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     /************************************
     * Contexts
     ************************************/
+    // A context of a parallel stage is placed on the node of its thread; the
+    // contexts of the single threaded stages follow the stage built before them
 
     // Resource Coordination Context
     EB_NEW(
@@ -1633,6 +1999,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->picture_analysis_process_init_count; ++process_index) {
 
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->picture_analysis_context_ptr_array[process_index],
             picture_analysis_context_ctor,
@@ -1655,6 +2022,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->motion_estimation_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->motion_estimation_process_init_count);
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->motion_estimation_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->motion_estimation_context_ptr_array[process_index],
             motion_estimation_context_ctor,
@@ -1671,6 +2039,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->source_based_operations_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->source_based_operations_process_init_count);
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->source_based_operations_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->source_based_operations_context_ptr_array[process_index],
             source_based_operations_context_ctor,
@@ -1689,6 +2058,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->inlme_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->inlme_process_init_count);
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->inlme_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->inlme_context_ptr_array[process_index],
             ime_context_ctor,
@@ -1708,6 +2078,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
         EB_ALLOC_PTR_ARRAY(enc_handle_ptr->mode_decision_configuration_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->mode_decision_configuration_process_init_count);
 
         for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->mode_decision_configuration_process_init_count; ++process_index) {
+            prefer_process_node(enc_handle_ptr, process_index);
             EB_NEW(
                 enc_handle_ptr->mode_decision_configuration_context_ptr_array[process_index],
                 mode_decision_configuration_context_ctor,
@@ -1726,6 +2097,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     // EncDec Contexts
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->enc_dec_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count);
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->enc_dec_context_ptr_array[process_index],
             enc_dec_context_ctor,
@@ -1739,17 +2111,20 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->dlf_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->dlf_process_init_count);
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->dlf_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->dlf_context_ptr_array[process_index],
             dlf_context_ctor,
             enc_handle_ptr,
-            process_index);
+            process_index,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count + process_index);
     }
 
     //CDEF Contexts
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->cdef_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->cdef_process_init_count);
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->cdef_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->cdef_context_ptr_array[process_index],
             cdef_context_ctor,
@@ -1760,6 +2135,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->rest_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->rest_process_init_count);
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->rest_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->rest_context_ptr_array[process_index],
             rest_context_ctor,
@@ -1772,6 +2148,7 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->entropy_coding_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->entropy_coding_process_init_count);
 
     for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->entropy_coding_process_init_count; ++process_index) {
+        prefer_process_node(enc_handle_ptr, process_index);
         EB_NEW(
             enc_handle_ptr->entropy_coding_context_ptr_array[process_index],
             entropy_coding_context_ctor,
@@ -1792,78 +2169,124 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     /************************************
     * Thread Handles
     ************************************/
-    EbSvtAv1EncConfiguration   *config_ptr = &enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config;
-    if (config_ptr->unpin == 0)
-        svt_set_thread_management_parameters(config_ptr);
-
     control_set_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
 
+    if (config_ptr->enable_thread_pool || config_ptr->thread_pool) {
+        // EncDec, Dlf, Cdef and Rest run as pool tasks on the contexts of this
+        // channel, the other stages as fibers of its client; a private pool
+        // gets one worker per context
+        const uint32_t worker_count = MIN(
+            MIN(control_set_ptr->enc_dec_process_init_count, control_set_ptr->dlf_process_init_count),
+            MIN(control_set_ptr->cdef_process_init_count, control_set_ptr->rest_process_init_count));
+        // Every pending task holds one object of an attached resource
+        const uint32_t task_capacity =
+            control_set_ptr->mode_decision_configuration_fifo_init_count +
+            control_set_ptr->enc_dec_fifo_init_count + control_set_ptr->dlf_fifo_init_count +
+            control_set_ptr->cdef_fifo_init_count;
+        EbThreadPool *pool_ptr = (EbThreadPool *)config_ptr->thread_pool;
+        if (!pool_ptr) {
+            EB_NEW(enc_handle_ptr->thread_pool, svt_thread_pool_ctor, worker_count, 0);
+            for (uint32_t i = 0; i < worker_count; i++)
+                bind_process_thread(enc_handle_ptr, enc_handle_ptr->thread_pool->worker_array[i].thread_handle, i);
+            pool_ptr = enc_handle_ptr->thread_pool;
+        }
+        EB_NEW(enc_handle_ptr->pool_client, svt_pool_client_ctor, pool_ptr,
+            config_ptr->thread_pool_priority, config_ptr->thread_pool_weight, task_capacity);
+        svt_system_resource_attach_pool_client(enc_handle_ptr->enc_dec_tasks_resource_ptr,
+            enc_handle_ptr->pool_client, mode_decision_pool_task, (EbPtr *)enc_handle_ptr->enc_dec_context_ptr_array);
+        svt_system_resource_attach_pool_client(enc_handle_ptr->enc_dec_results_resource_ptr,
+            enc_handle_ptr->pool_client, dlf_pool_task, (EbPtr *)enc_handle_ptr->dlf_context_ptr_array);
+        svt_system_resource_attach_pool_client(enc_handle_ptr->dlf_results_resource_ptr,
+            enc_handle_ptr->pool_client, cdef_pool_task, (EbPtr *)enc_handle_ptr->cdef_context_ptr_array);
+        svt_system_resource_attach_pool_client(enc_handle_ptr->cdef_results_resource_ptr,
+            enc_handle_ptr->pool_client, rest_pool_task, (EbPtr *)enc_handle_ptr->rest_context_ptr_array);
+    }
+
     // Resource Coordination
-    EB_CREATE_THREAD(enc_handle_ptr->resource_coordination_thread_handle, resource_coordination_kernel, enc_handle_ptr->resource_coordination_context_ptr);
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->picture_analysis_thread_handle_array,control_set_ptr->picture_analysis_process_init_count,
+    EB_CREATE_STAGE(enc_handle_ptr->pool_client, enc_handle_ptr->resource_coordination_thread_handle, resource_coordination_kernel, enc_handle_ptr->resource_coordination_context_ptr);
+    EB_CREATE_STAGE_ARRAY(enc_handle_ptr->pool_client, enc_handle_ptr->picture_analysis_thread_handle_array,control_set_ptr->picture_analysis_process_init_count,
         picture_analysis_kernel,
         enc_handle_ptr->picture_analysis_context_ptr_array);
+    bind_process_threads(enc_handle_ptr, enc_handle_ptr->picture_analysis_thread_handle_array, control_set_ptr->picture_analysis_process_init_count);
 
     // Picture Decision
-    EB_CREATE_THREAD(enc_handle_ptr->picture_decision_thread_handle, picture_decision_kernel, enc_handle_ptr->picture_decision_context_ptr);
+    EB_CREATE_STAGE(enc_handle_ptr->pool_client, enc_handle_ptr->picture_decision_thread_handle, picture_decision_kernel, enc_handle_ptr->picture_decision_context_ptr);
 
     // Motion Estimation
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->motion_estimation_thread_handle_array, control_set_ptr->motion_estimation_process_init_count,
+    EB_CREATE_STAGE_ARRAY(enc_handle_ptr->pool_client, enc_handle_ptr->motion_estimation_thread_handle_array, control_set_ptr->motion_estimation_process_init_count,
         motion_estimation_kernel,
         enc_handle_ptr->motion_estimation_context_ptr_array);
+    bind_process_threads(enc_handle_ptr, enc_handle_ptr->motion_estimation_thread_handle_array, control_set_ptr->motion_estimation_process_init_count);
 
     // Initial Rate Control
-    EB_CREATE_THREAD(enc_handle_ptr->initial_rate_control_thread_handle, initial_rate_control_kernel, enc_handle_ptr->initial_rate_control_context_ptr);
+    EB_CREATE_STAGE(enc_handle_ptr->pool_client, enc_handle_ptr->initial_rate_control_thread_handle, initial_rate_control_kernel, enc_handle_ptr->initial_rate_control_context_ptr);
 
     // Source Based Oprations
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->source_based_operations_thread_handle_array, control_set_ptr->source_based_operations_process_init_count,
+    EB_CREATE_STAGE_ARRAY(enc_handle_ptr->pool_client, enc_handle_ptr->source_based_operations_thread_handle_array, control_set_ptr->source_based_operations_process_init_count,
         source_based_operations_kernel,
         enc_handle_ptr->source_based_operations_context_ptr_array);
+    bind_process_threads(enc_handle_ptr, enc_handle_ptr->source_based_operations_thread_handle_array, control_set_ptr->source_based_operations_process_init_count);
 
     // Picture Manager
-    EB_CREATE_THREAD(enc_handle_ptr->picture_manager_thread_handle, picture_manager_kernel, enc_handle_ptr->picture_manager_context_ptr);
+    EB_CREATE_STAGE(enc_handle_ptr->pool_client, enc_handle_ptr->picture_manager_thread_handle, picture_manager_kernel, enc_handle_ptr->picture_manager_context_ptr);
 
     // Close Loop Motion Estimation
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->ime_thread_handle_array, control_set_ptr->inlme_process_init_count,
+    EB_CREATE_STAGE_ARRAY(enc_handle_ptr->pool_client, enc_handle_ptr->ime_thread_handle_array, control_set_ptr->inlme_process_init_count,
             inloop_me_kernel,
             enc_handle_ptr->inlme_context_ptr_array);
+    bind_process_threads(enc_handle_ptr, enc_handle_ptr->ime_thread_handle_array, control_set_ptr->inlme_process_init_count);
 
     // Rate Control
-    EB_CREATE_THREAD(enc_handle_ptr->rate_control_thread_handle, rate_control_kernel, enc_handle_ptr->rate_control_context_ptr);
+    EB_CREATE_STAGE(enc_handle_ptr->pool_client, enc_handle_ptr->rate_control_thread_handle, rate_control_kernel, enc_handle_ptr->rate_control_context_ptr);
 
     // Mode Decision Configuration Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->mode_decision_configuration_thread_handle_array, control_set_ptr->mode_decision_configuration_process_init_count,
+    EB_CREATE_STAGE_ARRAY(enc_handle_ptr->pool_client, enc_handle_ptr->mode_decision_configuration_thread_handle_array, control_set_ptr->mode_decision_configuration_process_init_count,
         mode_decision_configuration_kernel,
         enc_handle_ptr->mode_decision_configuration_context_ptr_array);
+    bind_process_threads(enc_handle_ptr, enc_handle_ptr->mode_decision_configuration_thread_handle_array, control_set_ptr->mode_decision_configuration_process_init_count);
 
 
-    // EncDec Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->enc_dec_thread_handle_array, control_set_ptr->enc_dec_process_init_count,
-        mode_decision_kernel,
-        enc_handle_ptr->enc_dec_context_ptr_array);
+    if (!enc_handle_ptr->pool_client) {
+        // EncDec Process
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->enc_dec_thread_handle_array, control_set_ptr->enc_dec_process_init_count,
+            mode_decision_kernel,
+            enc_handle_ptr->enc_dec_context_ptr_array);
+        bind_process_threads(enc_handle_ptr, enc_handle_ptr->enc_dec_thread_handle_array, control_set_ptr->enc_dec_process_init_count);
 
-    // Dlf Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->dlf_thread_handle_array, control_set_ptr->dlf_process_init_count,
-        dlf_kernel,
-        enc_handle_ptr->dlf_context_ptr_array);
+        // Dlf Process
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->dlf_thread_handle_array, control_set_ptr->dlf_process_init_count,
+            dlf_kernel,
+            enc_handle_ptr->dlf_context_ptr_array);
+        bind_process_threads(enc_handle_ptr, enc_handle_ptr->dlf_thread_handle_array, control_set_ptr->dlf_process_init_count);
 
-    // Cdef Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->cdef_thread_handle_array, control_set_ptr->cdef_process_init_count,
-        cdef_kernel,
-        enc_handle_ptr->cdef_context_ptr_array);
+        // Cdef Process
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->cdef_thread_handle_array, control_set_ptr->cdef_process_init_count,
+            cdef_kernel,
+            enc_handle_ptr->cdef_context_ptr_array);
+        bind_process_threads(enc_handle_ptr, enc_handle_ptr->cdef_thread_handle_array, control_set_ptr->cdef_process_init_count);
 
-    // Rest Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->rest_thread_handle_array, control_set_ptr->rest_process_init_count,
-        rest_kernel,
-        enc_handle_ptr->rest_context_ptr_array);
+        // Rest Process
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->rest_thread_handle_array, control_set_ptr->rest_process_init_count,
+            rest_kernel,
+            enc_handle_ptr->rest_context_ptr_array);
+        bind_process_threads(enc_handle_ptr, enc_handle_ptr->rest_thread_handle_array, control_set_ptr->rest_process_init_count);
+    }
 
     // Entropy Coding Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count,
+    EB_CREATE_STAGE_ARRAY(enc_handle_ptr->pool_client, enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count,
         entropy_coding_kernel,
         enc_handle_ptr->entropy_coding_context_ptr_array);
+    bind_process_threads(enc_handle_ptr, enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count);
 
     // Packetization
-    EB_CREATE_THREAD(enc_handle_ptr->packetization_thread_handle, packetization_kernel, enc_handle_ptr->packetization_context_ptr);
+    EB_CREATE_STAGE(enc_handle_ptr->pool_client, enc_handle_ptr->packetization_thread_handle, packetization_kernel, enc_handle_ptr->packetization_context_ptr);
+
+    // Nothing is posted before the first svt_av1_enc_send_picture
+    if (config_ptr->enable_pipeline_stats) {
+        return_error = svt_enc_handle_attach_pipeline_stats(enc_handle_ptr);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
 
 #if DISPLAY_MEMORY
     EB_MEMORY();
@@ -1873,6 +2296,31 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     return return_error;
 }
 
+EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
+{
+    if(svt_enc_component == NULL)
+        return EB_ErrorBadParameter;
+    EbEncHandle *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
+    enc_handle_ptr->init_start_bytes = svt_thread_alloc_bytes();
+    // The init allocates under NUMA policies of its own, the application
+    // thread gets its policy back however the init ends. The picture planes
+    // are committed as they are allocated, so they land on the node of the
+    // policy instead of the node of the thread first writing them.
+    const EbBool numa_alloc = enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.enable_numa_alloc;
+    EbNumaPolicy app_policy;
+    if (numa_alloc) {
+        svt_numa_save_policy(&app_policy);
+        svt_set_thread_eager_commit(EB_TRUE);
+    }
+    EbErrorType return_error = svt_enc_handle_init(enc_handle_ptr);
+    enc_handle_ptr->init_bytes = svt_thread_alloc_bytes() - enc_handle_ptr->init_start_bytes;
+    if (numa_alloc) {
+        svt_set_thread_eager_commit(EB_FALSE);
+        svt_numa_restore_policy(&app_policy);
+    }
+    return return_error;
+}
+
 /**********************************
 * DeInitialize Encoder Library
 **********************************/
@@ -1898,11 +2346,63 @@ EB_API EbErrorType svt_av1_enc_deinit(EbComponentType *svt_enc_component){
         svt_shutdown_process(handle->dlf_results_resource_ptr);
         svt_shutdown_process(handle->cdef_results_resource_ptr);
         svt_shutdown_process(handle->rest_results_resource_ptr);
+
+        if (handle->numa_node_count) {
+            EbNumaStats numa_stats;
+            svt_numa_get_stats(&numa_stats);
+            SVT_INFO("NUMA page allocations during the encode (system wide): %llu local, %llu remote\n",
+                (unsigned long long)(numa_stats.local_pages - handle->numa_stats.local_pages),
+                (unsigned long long)(numa_stats.remote_pages - handle->numa_stats.remote_pages));
+        }
     }
 
     return EB_ErrorNone;
 }
 
+/**********************************
+* Shared Thread Pool
+**********************************/
+static EbErrorType svt_av1_enc_thread_pool_ctor(EbThreadPool **pool_dbl_ptr, uint32_t worker_count)
+{
+    EbThreadPool *pool_ptr;
+    EB_NEW(pool_ptr, svt_thread_pool_ctor, worker_count ? worker_count : get_num_processors(), 0);
+    *pool_dbl_ptr = pool_ptr;
+    return EB_ErrorNone;
+}
+
+EB_API EbErrorType svt_av1_enc_create_thread_pool(
+    EbSvtAv1ThreadPool **p_pool,
+    uint32_t             worker_count)
+{
+    EbThreadPool *pool_ptr = NULL;
+    if (p_pool == NULL)
+        return EB_ErrorBadParameter;
+    svt_log_init();
+    EbErrorType return_error = svt_av1_enc_thread_pool_ctor(&pool_ptr, worker_count);
+    *p_pool = (EbSvtAv1ThreadPool *)pool_ptr;
+    if (return_error == EB_ErrorNone)
+        svt_increase_component_count();
+    return return_error;
+}
+
+EB_API EbErrorType svt_av1_enc_destroy_thread_pool(
+    EbSvtAv1ThreadPool *pool)
+{
+    EbThreadPool *pool_ptr = (EbThreadPool *)pool;
+    if (pool_ptr == NULL)
+        return EB_ErrorBadParameter;
+    svt_block_on_mutex(pool_ptr->client_mutex);
+    const uint32_t client_count = pool_ptr->client_count;
+    svt_release_mutex(pool_ptr->client_mutex);
+    if (client_count) {
+        SVT_LOG("Error: %u encoder instances still use the thread pool\n", client_count);
+        return EB_ErrorBadParameter;
+    }
+    EB_DELETE(pool_ptr);
+    svt_decrease_component_count();
+    return EB_ErrorNone;
+}
+
 EbErrorType svt_svt_enc_init_parameter(
     EbSvtAv1EncConfiguration * config_ptr);
 
@@ -2398,6 +2898,15 @@ void copy_api_from_app(
     scs_ptr->static_config.logical_processors = ((EbSvtAv1EncConfiguration*)config_struct)->logical_processors;
     scs_ptr->static_config.unpin = ((EbSvtAv1EncConfiguration*)config_struct)->unpin;
     scs_ptr->static_config.target_socket = ((EbSvtAv1EncConfiguration*)config_struct)->target_socket;
+    scs_ptr->static_config.enable_thread_pool = ((EbSvtAv1EncConfiguration*)config_struct)->enable_thread_pool;
+    scs_ptr->static_config.thread_pool = ((EbSvtAv1EncConfiguration*)config_struct)->thread_pool;
+    scs_ptr->static_config.thread_pool_priority = ((EbSvtAv1EncConfiguration*)config_struct)->thread_pool_priority;
+    scs_ptr->static_config.thread_pool_weight = ((EbSvtAv1EncConfiguration*)config_struct)->thread_pool_weight;
+    scs_ptr->static_config.enable_numa_alloc = ((EbSvtAv1EncConfiguration*)config_struct)->enable_numa_alloc;
+    scs_ptr->static_config.memory_budget = ((EbSvtAv1EncConfiguration*)config_struct)->memory_budget;
+    scs_ptr->static_config.zero_copy_input = ((EbSvtAv1EncConfiguration*)config_struct)->zero_copy_input;
+    scs_ptr->static_config.input_release_callback = ((EbSvtAv1EncConfiguration*)config_struct)->input_release_callback;
+    scs_ptr->static_config.enable_pipeline_stats = ((EbSvtAv1EncConfiguration*)config_struct)->enable_pipeline_stats;
     if ((scs_ptr->static_config.unpin == 1) && (scs_ptr->static_config.target_socket != -1)){
         SVT_WARN("unpin 1 and ss %d is not a valid combination: unpin will be set to 0\n", scs_ptr->static_config.target_socket);
         scs_ptr->static_config.unpin = 0;
@@ -2467,6 +2976,20 @@ void copy_api_from_app(
         }
     }
 
+    // Low-latency mode: flat low-delay structure, nothing is held back to look ahead
+    scs_ptr->static_config.max_frames_in_flight = config_struct->max_frames_in_flight;
+    if (scs_ptr->static_config.max_frames_in_flight) {
+        scs_ptr->static_config.pred_structure = EB_PRED_LOW_DELAY_P;
+        scs_ptr->static_config.hierarchical_levels = 0;
+        scs_ptr->max_temporal_layers = 0;
+        scs_ptr->static_config.look_ahead_distance = 0;
+        scs_ptr->static_config.enable_tpl_la = 0;
+        scs_ptr->static_config.scene_change_detection = 0;
+        scs_ptr->static_config.tf_level = 0;
+        scs_ptr->static_config.enable_overlays = 0;
+    }
+    scs_ptr->static_config.tile_group_output = config_struct->tile_group_output;
+
     return;
 }
 
@@ -2531,8 +3054,8 @@ static EbErrorType verify_settings(
         return_error = EB_ErrorBadParameter;
     }
 
-    if (config->pred_structure != 2) {
-        SVT_LOG("Error instance %u: Pred Structure must be [2]\n", channel_number + 1);
+    if (config->pred_structure != (config->max_frames_in_flight ? EB_PRED_LOW_DELAY_P : EB_PRED_RANDOM_ACCESS)) {
+        SVT_LOG("Error instance %u: Pred Structure must be [2], or [0] with MaxFramesInFlight\n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
     }
     if (scs_ptr->max_input_luma_width % 8 && scs_ptr->static_config.compressed_ten_bit_format == 1) {
@@ -2627,6 +3150,31 @@ static EbErrorType verify_settings(
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->max_frames_in_flight && config->rate_control_mode) {
+        SVT_LOG("Error Instance %u: MaxFramesInFlight is only supported with CQP, VBR and CVBR need a look ahead\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->max_frames_in_flight && (config->rc_firstpass_stats_out || config->rc_twopass_stats_in.buf)) {
+        SVT_LOG("Error Instance %u: MaxFramesInFlight is not supported for 2-pass\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->max_frames_in_flight && config->recon_enabled) {
+        SVT_LOG("Error Instance %u: MaxFramesInFlight is not supported with recon output\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->max_frames_in_flight && config->enable_manual_pred_struct) {
+        SVT_LOG("Error Instance %u: MaxFramesInFlight is not supported with a manual prediction structure\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->tile_group_output && !config->max_frames_in_flight) {
+        SVT_LOG("Error Instance %u: TileGroupOutput is only supported with MaxFramesInFlight\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->enable_hme_flag) {
         if ((config->number_hme_search_region_in_width > (uint32_t)EB_HME_SEARCH_AREA_COLUMN_MAX_COUNT) || (config->number_hme_search_region_in_width == 0)) {
             SVT_LOG("Error Instance %u: Invalid number_hme_search_region_in_width. number_hme_search_region_in_width must be [1 - %d]\n", channel_number + 1, EB_HME_SEARCH_AREA_COLUMN_MAX_COUNT);
@@ -2805,6 +3353,26 @@ static EbErrorType verify_settings(
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->thread_pool_priority > POOL_PRIORITY_HIGH) {
+        SVT_LOG("Error instance %u: Invalid thread_pool_priority. thread_pool_priority must be [0 - %d] \n", channel_number + 1, POOL_PRIORITY_HIGH);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->thread_pool_weight < 1 || config->thread_pool_weight > POOL_WEIGHT_MAX) {
+        SVT_LOG("Error instance %u: Invalid thread_pool_weight. thread_pool_weight must be [1 - %d] \n", channel_number + 1, POOL_WEIGHT_MAX);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->zero_copy_input && config->encoder_bit_depth != 8) {
+        SVT_LOG("Error instance %u: Zero copy input requires 8-bit input\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->zero_copy_input && !config->input_release_callback) {
+        SVT_LOG("Error instance %u: Zero copy input requires an input release callback\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     // alt-ref frames related
     if (config->altref_strength > ALTREF_MAX_STRENGTH ) {
         SVT_LOG("Error instance %u: invalid altref-strength, should be in the range [0 - %d] \n", channel_number + 1, ALTREF_MAX_STRENGTH);
@@ -3087,6 +3655,8 @@ EbErrorType svt_svt_enc_init_parameter(
     config_ptr->scene_change_detection = 0;
     config_ptr->rate_control_mode = 0;
     config_ptr->look_ahead_distance = (uint32_t)~0;
+    config_ptr->max_frames_in_flight = 0;
+    config_ptr->tile_group_output = EB_FALSE;
     config_ptr->enable_tpl_la = 1;
     config_ptr->target_bit_rate = 7000000;
     config_ptr->max_qp_allowed = 63;
@@ -3197,6 +3767,15 @@ EbErrorType svt_svt_enc_init_parameter(
     config_ptr->logical_processors = 0;
     config_ptr->unpin = 1;
     config_ptr->target_socket = -1;
+    config_ptr->enable_thread_pool = EB_FALSE;
+    config_ptr->thread_pool = NULL;
+    config_ptr->thread_pool_priority = POOL_PRIORITY_NORMAL;
+    config_ptr->thread_pool_weight = POOL_WEIGHT_DEFAULT;
+    config_ptr->enable_numa_alloc = EB_FALSE;
+    config_ptr->memory_budget = 0;
+    config_ptr->zero_copy_input = EB_FALSE;
+    config_ptr->enable_pipeline_stats = EB_FALSE;
+    config_ptr->input_release_callback = NULL;
     config_ptr->channel_id = 0;
     config_ptr->active_channel_count = 1;
 
@@ -3333,8 +3912,10 @@ EB_API EbErrorType svt_av1_enc_set_parameter(
     EbErrorType return_error = (EbErrorType)verify_settings(
         enc_handle->scs_instance_array[instance_index]->scs_ptr);
 
-    if (return_error == EB_ErrorBadParameter)
+    if (return_error == EB_ErrorBadParameter) {
+        svt_release_mutex(enc_handle->scs_instance_array[instance_index]->config_mutex);
         return EB_ErrorBadParameter;
+    }
     set_param_based_on_input(
         enc_handle->scs_instance_array[instance_index]->scs_ptr);
 
@@ -3643,9 +4224,39 @@ static void copy_input_buffer(
     else
         dst->metadata = NULL;
 
-    // Copy the picture buffer
-    if (src->p_buffer != NULL)
-        copy_frame_buffer(sequenceControlSet, dst->p_buffer, src->p_buffer);
+    // Copy the picture buffer, or reference the application planes in zero copy mode
+    if (src->p_buffer != NULL) {
+        if (sequenceControlSet->static_config.zero_copy_input) {
+            EbPictureBufferDesc *input_picture_ptr = (EbPictureBufferDesc*)dst->p_buffer;
+            EbSvtIOFormat       *input_ptr = (EbSvtIOFormat*)src->p_buffer;
+            input_picture_ptr->buffer_y = input_ptr->luma;
+            input_picture_ptr->buffer_cb = input_ptr->cb;
+            input_picture_ptr->buffer_cr = input_ptr->cr;
+            dst->p_app_private = src->p_app_private;
+        }
+        else
+            copy_frame_buffer(sequenceControlSet, dst->p_buffer, src->p_buffer);
+    }
+}
+
+/***********************************************
+**** Checks that the planes of a zero copy input
+**** buffer follow the layout of the input pool.
+**** The 2-bit planes of high bit depth input are
+**** rejected, only 8-bit input is referenced
+************************************************/
+static EbBool is_valid_zero_copy_input(
+    const EbPictureBufferDesc *input_picture_ptr,
+    const EbSvtIOFormat       *input_ptr)
+{
+    return input_ptr->luma && input_ptr->cb && input_ptr->cr &&
+        !input_ptr->luma_ext && !input_ptr->cb_ext && !input_ptr->cr_ext &&
+        input_ptr->y_stride == input_picture_ptr->stride_y &&
+        input_ptr->cb_stride == input_picture_ptr->stride_cb &&
+        input_ptr->cr_stride == input_picture_ptr->stride_cr &&
+        !((uintptr_t)input_ptr->luma % ALVALUE) &&
+        !((uintptr_t)input_ptr->cb % ALVALUE) &&
+        !((uintptr_t)input_ptr->cr % ALVALUE);
 }
 
 /**********************************
@@ -3658,6 +4269,14 @@ EB_API EbErrorType svt_av1_enc_send_picture(
     EbEncHandle          *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
     EbObjectWrapper      *eb_wrapper_ptr;
 
+    if (p_buffer != NULL && p_buffer->p_buffer != NULL &&
+        enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.zero_copy_input) {
+        EbBufferHeaderType *pool_buffer =
+            (EbBufferHeaderType*)enc_handle_ptr->input_buffer_resource_ptr->wrapper_ptr_pool[0]->object_ptr;
+        if (!is_valid_zero_copy_input((EbPictureBufferDesc*)pool_buffer->p_buffer, (EbSvtIOFormat*)p_buffer->p_buffer))
+            return EB_ErrorBadParameter;
+    }
+
     // Take the buffer and put it into our internal queue structure
     svt_get_empty_object(
         enc_handle_ptr->input_buffer_producer_fifo_ptr,
@@ -3671,12 +4290,78 @@ EB_API EbErrorType svt_av1_enc_send_picture(
             enc_handle_ptr->scs_instance_array[0]->scs_ptr,
             (EbBufferHeaderType*)eb_wrapper_ptr->object_ptr,
             p_buffer);
+        if (enc_handle_ptr->config_changed && p_buffer->p_buffer != NULL) {
+            // the new rate starts on a key frame
+            EbSequenceControlSetInstance *scs_instance = enc_handle_ptr->scs_instance_array[0];
+            EbBufferHeaderType *input_ptr = (EbBufferHeaderType*)eb_wrapper_ptr->object_ptr;
+            input_ptr->flags |= EB_BUFFERFLAG_CONFIG_CHANGE;
+            input_ptr->pic_type = EB_AV1_KEY_PICTURE;
+            svt_block_on_mutex(scs_instance->config_mutex);
+            scs_instance->config_change_tail =
+                (scs_instance->config_change_tail + 1) % scs_instance->config_change_count;
+            svt_release_mutex(scs_instance->config_mutex);
+            enc_handle_ptr->config_changed = EB_FALSE;
+        }
     }
 
     svt_post_full_object(eb_wrapper_ptr);
 
     return EB_ErrorNone;
 }
+/**********************************
+* Reconfigure the rate of the encoder
+**********************************/
+EB_API EbErrorType svt_av1_enc_reconfigure(
+    EbComponentType          *svt_enc_component,
+    EbSvtAv1EncConfiguration *config_ptr)
+{
+    if (svt_enc_component == NULL || config_ptr == NULL)
+        return EB_ErrorBadParameter;
+    EbEncHandle *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
+    EbSequenceControlSetInstance *scs_instance = enc_handle_ptr->scs_instance_array[0];
+    SequenceControlSet *scs_ptr = scs_instance->scs_ptr;
+    EbSvtAv1EncConfiguration *active_config = &scs_ptr->static_config;
+    uint32_t channel_number = active_config->channel_id + 1;
+
+    if (config_ptr->source_width != active_config->source_width ||
+        config_ptr->source_height != active_config->source_height) {
+        SVT_LOG("Error instance %u: The resolution can not be reconfigured\n", channel_number);
+        return EB_ErrorBadParameter;
+    }
+    if (config_ptr->rate_control_mode != active_config->rate_control_mode) {
+        SVT_LOG("Error instance %u: The rate control mode can not be reconfigured\n",
+                channel_number);
+        return EB_ErrorBadParameter;
+    }
+    if (use_input_stat(scs_ptr) || use_output_stat(scs_ptr)) {
+        SVT_LOG("Error instance %u: The rate can not be reconfigured in two pass mode\n",
+                channel_number);
+        return EB_ErrorBadParameter;
+    }
+    if (config_ptr->qp > MAX_QP_VALUE) {
+        SVT_LOG("Error instance %u: QP must be [0 - %d]\n", channel_number, MAX_QP_VALUE);
+        return EB_ErrorBadParameter;
+    }
+    if (active_config->rate_control_mode &&
+        (config_ptr->max_qp_allowed > MAX_QP_VALUE ||
+         config_ptr->min_qp_allowed >= MAX_QP_VALUE ||
+         config_ptr->min_qp_allowed > config_ptr->max_qp_allowed)) {
+        SVT_LOG("Error instance %u: MinQpAllowed must be [0 - %d] and not above MaxQpAllowed "
+                "[0 - %d]\n", channel_number, MAX_QP_VALUE - 1, MAX_QP_VALUE);
+        return EB_ErrorBadParameter;
+    }
+
+    // The pictures sent before may not have reached resource coordination
+    // yet, so the configuration waits in the queue for the next picture, a
+    // later reconfigure before it replaces it
+    svt_block_on_mutex(scs_instance->config_mutex);
+    scs_instance->config_changes[scs_instance->config_change_tail] = *config_ptr;
+    enc_handle_ptr->config_changed = EB_TRUE;
+    svt_release_mutex(scs_instance->config_mutex);
+
+    return EB_ErrorNone;
+}
+
 static void copy_output_recon_buffer(
     EbBufferHeaderType   *dst,
     EbBufferHeaderType   *src
@@ -3729,7 +4414,7 @@ EB_API EbErrorType svt_av1_enc_get_packet(
 
     if (eb_wrapper_ptr) {
         packet = (EbBufferHeaderType*)eb_wrapper_ptr->object_ptr;
-        if ( packet->flags & 0xfffffff0 )
+        if (packet->flags & EB_BUFFERFLAG_ERROR_MASK)
             return_error = EB_ErrorMax;
         // return the output stream buffer
         *p_buffer = packet;
@@ -3747,14 +4432,30 @@ EB_API void svt_av1_enc_release_out_buffer(
 {
     if (p_buffer && (*p_buffer)->wrapper_ptr)
     {
-        if((*p_buffer)->p_buffer)
-           EB_FREE((*p_buffer)->p_buffer);
-        // Release out put buffer back into the pool
+        // Release out put buffer back into the pool, svt_output_stream_buffer_release
+        // frees or recycles p_buffer
         svt_release_object((EbObjectWrapper  *)(*p_buffer)->wrapper_ptr);
      }
     return;
 }
 
+/**********************************
+* svt_av1_enc_add_output_buffer adds an application buffer to the output buffer pool
+**********************************/
+EB_API EbErrorType svt_av1_enc_add_output_buffer(
+    EbComponentType      *svt_enc_component,
+    uint8_t              *buffer,
+    uint32_t              size)
+{
+    if (svt_enc_component == NULL || buffer == NULL || size == 0)
+        return EB_ErrorBadParameter;
+    EbEncHandle *enc_handle = (EbEncHandle*)svt_enc_component->p_component_private;
+    return svt_output_buffer_pool_add(
+        enc_handle->scs_instance_array[0]->encode_context_ptr->output_buffer_pool_ptr,
+        buffer,
+        size);
+}
+
 /**********************************
 * Fill This Buffer
 **********************************/
@@ -3857,7 +4558,8 @@ EbErrorType init_svt_av1_encoder_handle(
 
 static EbErrorType allocate_frame_buffer(
     SequenceControlSet       *scs_ptr,
-    EbBufferHeaderType        *input_buffer)
+    EbBufferHeaderType        *input_buffer,
+    uint32_t                   buffer_enable_mask)
 {
     EbErrorType   return_error = EB_ErrorNone;
     EbPictureBufferDescInitData input_pic_buf_desc_init_data;
@@ -3884,7 +4586,7 @@ static EbErrorType allocate_frame_buffer(
 
     input_pic_buf_desc_init_data.split_mode = is_16bit ? EB_TRUE : EB_FALSE;
 
-    input_pic_buf_desc_init_data.buffer_enable_mask = PICTURE_BUFFER_DESC_FULL_MASK;
+    input_pic_buf_desc_init_data.buffer_enable_mask = buffer_enable_mask;
     input_pic_buf_desc_init_data.is_16bit_pipeline = 0;
 
     if (is_16bit && config->compressed_ten_bit_format == 1)
@@ -3902,13 +4604,13 @@ static EbErrorType allocate_frame_buffer(
 
         if (is_16bit && config->compressed_ten_bit_format == 1) {
             //pack 4 2bit pixels into 1Byte
-            EB_MALLOC_ALIGNED_ARRAY(buf->buffer_bit_inc_y,
+            EB_CALLOC_ALIGNED_LAZY_ARRAY(buf->buffer_bit_inc_y,
                  (input_pic_buf_desc_init_data.max_width / 4)*
                  (input_pic_buf_desc_init_data.max_height));
-            EB_MALLOC_ALIGNED_ARRAY(buf->buffer_bit_inc_cb,
+            EB_CALLOC_ALIGNED_LAZY_ARRAY(buf->buffer_bit_inc_cb,
                  (input_pic_buf_desc_init_data.max_width / 8)*
                  (input_pic_buf_desc_init_data.max_height / 2));
-            EB_MALLOC_ALIGNED_ARRAY(buf->buffer_bit_inc_cr,
+            EB_CALLOC_ALIGNED_LAZY_ARRAY(buf->buffer_bit_inc_cr,
                  (input_pic_buf_desc_init_data.max_width / 8)*
                  (input_pic_buf_desc_init_data.max_height / 2));
         }
@@ -3935,7 +4637,40 @@ EbErrorType svt_input_buffer_header_creator(
 
     return_error = allocate_frame_buffer(
         scs_ptr,
-        input_buffer);
+        input_buffer,
+        PICTURE_BUFFER_DESC_FULL_MASK);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+
+    input_buffer->p_app_private = NULL;
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+* EbBufferHeaderType Constructor
+*   Zero copy input: the planes are the ones
+*   of the application buffers, only the
+*   descriptor is allocated
+**************************************/
+EbErrorType svt_zero_copy_input_buffer_header_creator(
+    EbPtr *object_dbl_ptr,
+    EbPtr  object_init_data_ptr)
+{
+    EbErrorType return_error = EB_ErrorNone;
+    EbBufferHeaderType* input_buffer;
+    SequenceControlSet        *scs_ptr = (SequenceControlSet*)object_init_data_ptr;
+
+    *object_dbl_ptr = NULL;
+    EB_CALLOC(input_buffer, 1, sizeof(EbBufferHeaderType));
+    *object_dbl_ptr = (EbPtr)input_buffer;
+    // Initialize Header
+    input_buffer->size = sizeof(EbBufferHeaderType);
+
+    return_error = allocate_frame_buffer(
+        scs_ptr,
+        input_buffer,
+        0);
     if (return_error != EB_ErrorNone)
         return return_error;
 
@@ -3944,14 +4679,36 @@ EbErrorType svt_input_buffer_header_creator(
     return EB_ErrorNone;
 }
 
+/**************************************
+* Hands the planes of a released zero copy
+* input buffer back to the application
+**************************************/
+void svt_zero_copy_input_buffer_release(
+    EbPtr            context_ptr,
+    EbObjectWrapper *wrapper_ptr)
+{
+    SequenceControlSet  *scs_ptr = (SequenceControlSet*)context_ptr;
+    EbBufferHeaderType  *input_buffer = (EbBufferHeaderType*)wrapper_ptr->object_ptr;
+    EbPictureBufferDesc *input_picture_ptr = (EbPictureBufferDesc*)input_buffer->p_buffer;
+
+    // The end of stream buffer carries no picture
+    if (input_picture_ptr->buffer_y) {
+        input_picture_ptr->buffer_y = NULL;
+        input_picture_ptr->buffer_cb = NULL;
+        input_picture_ptr->buffer_cr = NULL;
+        scs_ptr->static_config.input_release_callback(input_buffer->p_app_private);
+    }
+    input_buffer->p_app_private = NULL;
+}
+
 void svt_input_buffer_header_destroyer(    EbPtr p)
 {
     EbBufferHeaderType *obj = (EbBufferHeaderType*)p;
     EbPictureBufferDesc* buf = (EbPictureBufferDesc*)obj->p_buffer;
     if (buf) {
-        EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_y);
-        EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_cb);
-        EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_cr);
+        EB_FREE_ALIGNED_LAZY_ARRAY(buf->buffer_bit_inc_y);
+        EB_FREE_ALIGNED_LAZY_ARRAY(buf->buffer_bit_inc_cb);
+        EB_FREE_ALIGNED_LAZY_ARRAY(buf->buffer_bit_inc_cr);
     }
 
     EB_DELETE(buf);
@@ -3966,24 +4723,25 @@ EbErrorType svt_output_buffer_header_creator(
     EbPtr object_init_data_ptr)
 {
     (void)object_init_data_ptr;
-    EbBufferHeaderType* out_buf_ptr;
+    EbOutputStreamBuffer* out_buf_ptr;
 
     *object_dbl_ptr = NULL;
-    EB_CALLOC(out_buf_ptr, 1, sizeof(EbBufferHeaderType));
+    EB_CALLOC(out_buf_ptr, 1, sizeof(EbOutputStreamBuffer));
     *object_dbl_ptr = (EbPtr)out_buf_ptr;
 
     // Initialize Header
-    out_buf_ptr->size = sizeof(EbBufferHeaderType);
+    out_buf_ptr->header.size = sizeof(EbBufferHeaderType);
     // p_buffer and n_alloc_len are dynamically set in EbPacketizationProcess
-    // out_buf_ptr->n_alloc_len;
-    out_buf_ptr->p_app_private = NULL;
+    // out_buf_ptr->header.n_alloc_len;
+    out_buf_ptr->header.p_app_private = NULL;
 
     return EB_ErrorNone;
 }
 
 void svt_output_buffer_header_destroyer(    EbPtr p)
 {
-    EbBufferHeaderType* obj = (EbBufferHeaderType*)p;
+    EbOutputStreamBuffer* obj = (EbOutputStreamBuffer*)p;
+    EB_FREE(obj->staging_buffer);
     EB_FREE(obj);
 }
 
@@ -4044,6 +4802,107 @@ EB_API EbErrorType svt_av1_enc_get_stream_info(EbComponentType *    svt_enc_comp
         first_pass_stats->sz = context->stats_out.size * sizeof(FIRSTPASS_STATS);
         return EB_ErrorNone;
     }
+    if (stream_info_id == SVT_AV1_STREAM_INFO_INPUT_LAYOUT) {
+        SvtAv1InputLayout   *layout = (SvtAv1InputLayout*)info;
+        EbBufferHeaderType  *pool_buffer;
+        EbPictureBufferDesc *input_picture_ptr;
+        if (!enc_handle->input_buffer_resource_ptr)
+            return EB_ErrorBadParameter;
+        pool_buffer = (EbBufferHeaderType*)enc_handle->input_buffer_resource_ptr->wrapper_ptr_pool[0]->object_ptr;
+        input_picture_ptr = (EbPictureBufferDesc*)pool_buffer->p_buffer;
+        layout->luma_stride = input_picture_ptr->stride_y;
+        layout->chroma_stride = input_picture_ptr->stride_cb;
+        layout->luma_size = input_picture_ptr->luma_size;
+        layout->chroma_size = input_picture_ptr->chroma_size;
+        layout->origin_x = input_picture_ptr->origin_x;
+        layout->origin_y = input_picture_ptr->origin_y;
+        layout->alignment = ALVALUE;
+        return EB_ErrorNone;
+    }
+    if (stream_info_id == SVT_AV1_STREAM_INFO_PIPELINE_STATS) {
+        SvtAv1PipelineStats *stats = (SvtAv1PipelineStats*)info;
+        EbPipelineStats     *pipeline_stats = enc_handle->pipeline_stats;
+        if (!pipeline_stats)
+            return EB_ErrorBadParameter;
+        memset(stats, 0, sizeof(*stats));
+        stats->elapsed_time = svt_pipeline_stats_time() - pipeline_stats->origin_time;
+        stats->stage_count = MIN(pipeline_stats->stage_count, SVT_AV1_MAX_PIPELINE_STAGES);
+        for (uint32_t i = 0; i < stats->stage_count; i++) {
+            EbStageStats     *stage_ptr = pipeline_stats->stage_array[i];
+            SvtAv1StageStats *stage = &stats->stages[i];
+            const int32_t     depth = svt_atomic_load_i32(&stage_ptr->queue_depth);
+            stage->name = stage_ptr->name;
+            stage->queue_depth = depth > 0 ? (uint32_t)depth : 0;
+            stage->queue_depth_max = (uint32_t)svt_atomic_load_i32(&stage_ptr->queue_depth_max);
+            stage->thread_count = stage_ptr->thread_count;
+            svt_block_on_mutex(stage_ptr->lockout_mutex);
+            stage->object_count = stage_ptr->object_count;
+            stage->queue_time_total = stage_ptr->queue_time_total;
+            stage->queue_time_max = stage_ptr->queue_time_max;
+            for (uint32_t t = 0; t < MIN(stage_ptr->thread_count, SVT_AV1_MAX_STAGE_THREADS); t++)
+                stage->busy_time[t] = stage_ptr->busy_time[t];
+            svt_release_mutex(stage_ptr->lockout_mutex);
+        }
+        EncodeContext *encode_context_ptr = enc_handle->scs_instance_array[0]->encode_context_ptr;
+        svt_block_on_mutex(encode_context_ptr->tf_stats_mutex);
+        stats->tf_picture_count = encode_context_ptr->tf_picture_count;
+        stats->tf_latency_total = encode_context_ptr->tf_latency_total;
+        stats->tf_latency_max = encode_context_ptr->tf_latency_max;
+        stats->tf_wait_time = encode_context_ptr->tf_wait_time;
+        svt_release_mutex(encode_context_ptr->tf_stats_mutex);
+        return EB_ErrorNone;
+    }
+    if (stream_info_id == SVT_AV1_STREAM_INFO_PIPELINE_TRACE) {
+        SvtAv1FixedBuf *trace = (SvtAv1FixedBuf*)info;
+        EbErrorType     return_error;
+        if (!enc_handle->pipeline_stats)
+            return EB_ErrorBadParameter;
+        return_error = svt_pipeline_stats_write_trace(enc_handle->pipeline_stats);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+        trace->buf = enc_handle->pipeline_stats->trace_buffer;
+        trace->sz = enc_handle->pipeline_stats->trace_size;
+        return EB_ErrorNone;
+    }
+    if (stream_info_id == SVT_AV1_STREAM_INFO_MEMORY_USAGE) {
+        SvtAv1MemoryUsage *usage = (SvtAv1MemoryUsage*)info;
+        if (!enc_handle->input_buffer_resource_ptr)
+            return EB_ErrorBadParameter;
+        // Pools in creation order, the optional ones NULL when not constructed
+        const struct {
+            EbSystemResource *resource_ptr;
+            const char       *name;
+        } pools[] = {
+            { enc_handle->picture_parent_control_set_pool_ptr_array[0], "parent_pcs" },
+            { enc_handle->me_pool_ptr_array[0], "me" },
+            { enc_handle->picture_control_set_pool_ptr_array[0], "child_pcs" },
+            { enc_handle->reference_picture_pool_ptr_array[0], "reference" },
+            { enc_handle->down_scaled_picture_pool_ptr_array ?
+                enc_handle->down_scaled_picture_pool_ptr_array[0] : NULL, "down_scaled" },
+            { enc_handle->pa_reference_picture_pool_ptr_array[0], "pa_reference" },
+            { enc_handle->overlay_input_picture_pool_ptr_array[0], "overlay_input" },
+            { enc_handle->input_buffer_resource_ptr, "input" },
+            { enc_handle->output_stream_buffer_resource_ptr_array[0], "output_stream" },
+            { enc_handle->output_recon_buffer_resource_ptr_array ?
+                enc_handle->output_recon_buffer_resource_ptr_array[0] : NULL, "output_recon" },
+        };
+        memset(usage, 0, sizeof(*usage));
+        usage->init_bytes = enc_handle->init_bytes;
+        usage->budget_bytes =
+            (uint64_t)enc_handle->scs_instance_array[0]->scs_ptr->static_config.memory_budget << 20;
+        for (uint32_t i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+            EbSystemResource *resource_ptr = pools[i].resource_ptr;
+            SvtAv1PoolMemory *pool;
+            if (!resource_ptr || usage->pool_count == SVT_AV1_MAX_MEMORY_POOLS)
+                continue;
+            pool = &usage->pools[usage->pool_count++];
+            pool->name = pools[i].name;
+            pool->object_count = resource_ptr->object_total_count;
+            pool->peak_in_use = (uint32_t)svt_atomic_load_i32(&resource_ptr->peak_in_use_count);
+            pool->object_bytes = resource_ptr->object_bytes;
+        }
+        return EB_ErrorNone;
+    }
     return EB_ErrorBadParameter;
 }
 // clang-format on
@@ -18,6 +18,11 @@
 #include "EbSystemResourceManager.h"
 #include "EbSequenceControlSet.h"
 #include "EbObject.h"
+#include "EbNuma.h"
+
+// Input buffer flag of the first picture sent after svt_av1_enc_reconfigure:
+// resource coordination derives a new sequence control set from it on
+#define EB_BUFFERFLAG_CONFIG_CHANGE 0x80000000
 
 struct _EbThreadContext {
     EbDctor dctor;
@@ -79,6 +84,31 @@ struct _EbEncHandle {
 
     EbHandle packetization_thread_handle;
 
+    // Worker pool running the EncDec, Dlf, Cdef and Rest stages when
+    // enable_thread_pool is set; their thread handle arrays stay NULL.
+    // thread_pool is NULL when the stages run on a shared pool of the
+    // configuration; pool_client submits to either of them.
+    EbThreadPool *thread_pool;
+    EbPoolClient *pool_client;
+
+    // Stage counters of the pipeline when enable_pipeline_stats is set
+    EbPipelineStats *pipeline_stats;
+
+    // Bytes allocated on the init thread when svt_av1_enc_init started, and
+    // by the whole init once done. budget_pool_index counts the pools sized
+    // by the memory budget constructed so far.
+    size_t   init_start_bytes;
+    size_t   init_bytes;
+    uint32_t budget_pool_index;
+
+    // Nodes the threads of the parallel stages are spread over when
+    // enable_numa_alloc is set (numa_node_count is 0 otherwise); thread and
+    // context process_index of a stage belong to
+    // numa_node_array[process_index % numa_node_count]
+    uint32_t    numa_node_count;
+    uint32_t    numa_node_array[EB_NUMA_MAX_NODES];
+    EbNumaStats numa_stats;
+
     // Contexts
     EbThreadContext * resource_coordination_context_ptr;
     EbThreadContext **picture_analysis_context_ptr_array;
@@ -124,6 +154,9 @@ struct _EbEncHandle {
     EbFifo *input_buffer_producer_fifo_ptr;
     EbFifo *output_stream_buffer_consumer_fifo_ptr;
     EbFifo *output_recon_buffer_consumer_fifo_ptr;
+
+    // Set by svt_av1_enc_reconfigure, cleared once the next picture is sent
+    EbBool config_changed;
 };
 
 #endif // EbEncHandle_h
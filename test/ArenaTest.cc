@@ -0,0 +1,114 @@
+/*
+* Copyright(c) 2020 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file ArenaTest.cc
+ *
+ * @brief Unit test of the scratch arena:
+ * - svt_arena_ctor
+ * - svt_arena_alloc
+ * - svt_arena_reset
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "gtest/gtest.h"
+#include "EbArena.h"
+
+namespace {
+
+class ArenaTest : public ::testing::Test {
+  protected:
+    void TearDown() override {
+        if (arena_) {
+            arena_->dctor(arena_);
+            free(arena_);
+        }
+    }
+
+    EbErrorType create(size_t size) {
+        arena_ = (EbArena *)calloc(1, sizeof(*arena_));
+        if (!arena_)
+            return EB_ErrorInsufficientResources;
+        return svt_arena_ctor(arena_, size);
+    }
+
+    /** Allocates the sizes of one task, fills every buffer with its index
+     * and checks that none was overwritten by another */
+    void run_task(const size_t *sizes, size_t count) {
+        uint8_t *buffers[16];
+        ASSERT_LE(count, sizeof(buffers) / sizeof(buffers[0]));
+        svt_arena_reset(arena_);
+        for (size_t i = 0; i < count; i++) {
+            buffers[i] = (uint8_t *)svt_arena_alloc(arena_, sizes[i]);
+            ASSERT_NE(nullptr, buffers[i]);
+            EXPECT_EQ(0u, (uintptr_t)buffers[i] % ALVALUE);
+            memset(buffers[i], (int)i, sizes[i]);
+        }
+        for (size_t i = 0; i < count; i++)
+            for (size_t j = 0; j < sizes[i]; j++)
+                ASSERT_EQ((uint8_t)i, buffers[i][j]) << "buffer " << i << " byte " << j;
+    }
+
+    EbArena *arena_ = nullptr;
+};
+
+/** Allocations beyond the block go to the heap and the next reset grows
+ * the block to the high-water mark */
+TEST_F(ArenaTest, GrowsToHighWaterMark) {
+    const size_t sizes[] = {1, 100, 4096, 63, 64, 65, 10000};
+    size_t       total   = 0;
+    for (size_t size : sizes) total += (size + ALVALUE - 1) / ALVALUE * ALVALUE;
+
+    ASSERT_EQ(EB_ErrorNone, create(0));
+    EXPECT_EQ(nullptr, arena_->buffer);
+    run_task(sizes, 7);
+    EXPECT_NE(nullptr, arena_->overflow);
+    EXPECT_EQ(total, arena_->peak);
+
+    run_task(sizes, 7);
+    EXPECT_EQ(nullptr, arena_->overflow);
+    EXPECT_EQ(total, arena_->size);
+    EXPECT_EQ(total, arena_->used);
+
+    // a smaller task keeps the block
+    run_task(sizes, 3);
+    EXPECT_EQ(nullptr, arena_->overflow);
+    EXPECT_EQ(total, arena_->size);
+}
+
+/** A task that fits reuses the same addresses after every reset */
+TEST_F(ArenaTest, SteadyStateReusesBlock) {
+    ASSERT_EQ(EB_ErrorNone, create(1 << 16));
+    void *first[3];
+    for (int task = 0; task < 4; task++) {
+        svt_arena_reset(arena_);
+        for (int i = 0; i < 3; i++) {
+            void *p = svt_arena_alloc(arena_, 1000 * (i + 1));
+            ASSERT_NE(nullptr, p);
+            if (task == 0)
+                first[i] = p;
+            else
+                EXPECT_EQ(first[i], p);
+        }
+        EXPECT_EQ(nullptr, arena_->overflow);
+    }
+}
+
+/** The overflow blocks are released by the destructor without a reset */
+TEST_F(ArenaTest, DestroyWithOverflow) {
+    const size_t sizes[] = {128, 1 << 20, 5};
+    ASSERT_EQ(EB_ErrorNone, create(256));
+    run_task(sizes, 3);
+    EXPECT_NE(nullptr, arena_->overflow);
+}
+
+}  // namespace
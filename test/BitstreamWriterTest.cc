@@ -293,4 +293,53 @@ TEST(Entropy_BitstreamWriter, write_symbol_with_update) {
                   rnd(gen));
     }
 }
+
+/** setup_test_env is implemented in test/TestEnv.c */
+extern "C" void setup_test_env();
+
+/** Uniform CDFs of 2 to 16 symbols, indexed by the symbol count */
+static void init_uniform_cdfs(AomCdfProb cdfs[17][CDF_SIZE(16)]) {
+    memset(cdfs, 0, sizeof(AomCdfProb) * 17 * CDF_SIZE(16));
+    for (int nsyms = 2; nsyms <= 16; nsyms++) {
+        for (int i = 0; i < nsyms; i++)
+            cdfs[nsyms][i] = AOM_ICDF(CDF_PROB_TOP * (i + 1) / nsyms);
+    }
+}
+
+TEST(Entropy_BitstreamWriter, write_symbols_of_every_alphabet) {
+    // the larger alphabets are adapted by the svt_av1_update_cdf kernel
+    setup_test_env();
+
+    const int total_symbols = 6000;
+    const int buffer_size = 16384;
+    uint8_t stream_buffer[buffer_size];
+    uint8_t symbols[total_symbols];
+    AomCdfProb cdfs[17][CDF_SIZE(16)];
+    AomWriter bw;
+    memset(&bw, 0, sizeof(bw));
+
+    // mostly zeros, so the CDFs adapt to extreme probabilities
+    std::mt19937 gen(deterministic_seeds);
+    for (int i = 0; i < total_symbols; ++i) {
+        const int nsyms = 2 + i % 15;
+        symbols[i] = (gen() & 3) ? 0 : gen() % nsyms;
+    }
+
+    init_uniform_cdfs(cdfs);
+    aom_start_encode(&bw, stream_buffer);
+    bw.allow_update_cdf = 1;
+    for (int i = 0; i < total_symbols; ++i)
+        aom_write_symbol(&bw, symbols[i], cdfs[2 + i % 15], 2 + i % 15);
+    aom_stop_encode(&bw);
+    ASSERT_LT(bw.pos, (uint32_t)buffer_size);
+
+    SvtReader br;
+    init_svt_reader(&br, stream_buffer, stream_buffer + buffer_size, bw.pos, 1);
+    init_uniform_cdfs(cdfs);
+    for (int i = 0; i < total_symbols; ++i) {
+        ASSERT_EQ(svt_read_symbol(&br, cdfs[2 + i % 15], 2 + i % 15, nullptr),
+                  symbols[i])
+            << "pos: " << i;
+    }
+}
 }  // namespace
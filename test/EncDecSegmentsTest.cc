@@ -0,0 +1,180 @@
+/*
+* Copyright(c) 2020 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file EncDecSegmentsTest.cc
+ *
+ * @brief Unit test of the wavefront scheduling of the EncDec segments:
+ * - enc_dec_segments_init
+ * - enc_dec_segments_wpp_reset
+ * - enc_dec_segments_wpp_update
+ *
+ * The owner of a row takes its next segment as assign_enc_dec_segments()
+ * does, and every ready row is posted to a queue picked in random order, so
+ * that the rows below catch up with the rows above.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "gtest/gtest.h"
+#include "EbEncDecSegments.h"
+// workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+namespace {
+
+typedef std::tuple<uint32_t, uint32_t> GridParam;  // SB columns, SB rows
+
+class EncDecSegmentsWppTest : public ::testing::TestWithParam<GridParam> {
+  protected:
+    void SetUp() override {
+        cols_ = std::get<0>(GetParam());
+        rows_ = std::get<1>(GetParam());
+        segments_ = (EncDecSegments *)calloc(1, sizeof(*segments_));
+        ASSERT_NE(nullptr, segments_);
+        ASSERT_EQ(EB_ErrorNone, enc_dec_segments_ctor(segments_, cols_, rows_));
+        enc_dec_segments_init(segments_, cols_, rows_, cols_, rows_);
+        ASSERT_TRUE(segments_->wpp);
+        done_.assign(cols_ * rows_, 0);
+    }
+
+    void TearDown() override {
+        if (segments_) {
+            segments_->dctor(segments_);
+            free(segments_);
+        }
+    }
+
+    /** Checks the inputs of the SB of segment_index and marks it done */
+    void process(uint16_t segment_index) {
+        const uint32_t x = segments_->x_start_array[segment_index];
+        const uint32_t y = segments_->y_start_array[segment_index];
+        std::lock_guard<std::mutex> lock(done_mutex_);
+        EXPECT_EQ(1u, segments_->valid_sb_count_array[segment_index]);
+        EXPECT_EQ(0, done_[y * cols_ + x]) << "SB " << x << "," << y << " twice";
+        if (x > 0)
+            EXPECT_EQ(1, done_[y * cols_ + x - 1]) << "left of " << x << "," << y;
+        if (y > 0)
+            EXPECT_EQ(1, done_[(y - 1) * cols_ + std::min(x + 1, cols_ - 1)])
+                << "above right of " << x << "," << y;
+        done_[y * cols_ + x] = 1;
+    }
+
+    /** Runs one SB of a posted row at a time until the picture is done, on
+     * thread_count threads, the rows being picked from the queue with seed */
+    void run(uint32_t thread_count, uint32_t seed) {
+        std::deque<uint16_t> queue;
+        std::mutex queue_mutex;
+        uint32_t processed = 0;
+        uint32_t lcg = seed;
+
+        for (uint32_t y = 0; y < rows_; y++)
+            segments_->row_array[y].current_seg_index = segments_->row_array[y].starting_seg_index;
+        enc_dec_segments_wpp_reset(segments_);
+        queue.push_back(0);
+        auto worker = [&]() {
+            for (;;) {
+                uint16_t row;
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    if (processed == cols_ * rows_)
+                        return;
+                    if (queue.empty()) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    lcg = lcg * 1103515245 + 12345;
+                    const size_t pick = (lcg >> 16) % queue.size();
+                    row = queue[pick];
+                    queue.erase(queue.begin() + pick);
+                }
+                EncDecSegSegmentRow *row_ptr = &segments_->row_array[row];
+                const uint16_t segment_index = row_ptr->current_seg_index++;
+                process(segment_index);
+                uint16_t ready_row_array[2];
+                const uint32_t ready_count =
+                    enc_dec_segments_wpp_update(segments_, segment_index, ready_row_array);
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                processed++;
+                for (uint32_t i = 0; i < ready_count; i++)
+                    queue.push_back(ready_row_array[i]);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < thread_count; i++)
+            threads.emplace_back(worker);
+        for (auto &thread : threads)
+            thread.join();
+
+        EXPECT_TRUE(queue.empty());
+        for (uint32_t i = 0; i < cols_ * rows_; i++)
+            EXPECT_EQ(1, done_[i]) << "SB " << i % cols_ << "," << i / cols_;
+        for (uint32_t y = 0; y < rows_; y++) {
+            EXPECT_EQ(cols_, segments_->row_array[y].completed_sb_count);
+            EXPECT_FALSE(segments_->row_array[y].active);
+        }
+    }
+
+    uint32_t cols_;
+    uint32_t rows_;
+    EncDecSegments *segments_;
+    std::vector<uint8_t> done_;
+    std::mutex done_mutex_;
+};
+
+/** Every SB runs once, after its left and above right neighbours, whatever
+ * the order the posted rows are picked in */
+TEST_P(EncDecSegmentsWppTest, DependenciesSingleThread) {
+    for (uint32_t seed = 1; seed <= 8; seed++) {
+        done_.assign(cols_ * rows_, 0);
+        run(1, seed);
+    }
+}
+
+TEST_P(EncDecSegmentsWppTest, DependenciesMultiThread) {
+    for (uint32_t seed = 1; seed <= 8; seed++) {
+        done_.assign(cols_ * rows_, 0);
+        run(8, seed);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    EncDec, EncDecSegmentsWppTest,
+    ::testing::Values(GridParam(1, 1), GridParam(1, 6), GridParam(6, 1), GridParam(2, 3),
+                      GridParam(20, 12), GridParam(30, 17)));
+
+/** A grid coarser than the SBs keeps the dependency map */
+TEST(EncDecSegmentsTest, WppOnlyForOneSbPerSegment) {
+    EncDecSegments *segments = (EncDecSegments *)calloc(1, sizeof(*segments));
+    ASSERT_NE(nullptr, segments);
+    ASSERT_EQ(EB_ErrorNone, enc_dec_segments_ctor(segments, 20, 12));
+    enc_dec_segments_init(segments, 20, 11, 20, 12);
+    EXPECT_FALSE(segments->wpp);
+    enc_dec_segments_init(segments, 10, 12, 20, 12);
+    EXPECT_FALSE(segments->wpp);
+    enc_dec_segments_init(segments, 20, 12, 20, 12);
+    EXPECT_TRUE(segments->wpp);
+    segments->dctor(segments);
+    free(segments);
+}
+
+}  // namespace
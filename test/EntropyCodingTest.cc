@@ -0,0 +1,116 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file EntropyCodingTest.cc
+ *
+ * @brief Unit test of the CDF kernels of the range decoder:
+ * - svt_od_ec_search_cdf_c/avx2
+ * - svt_av1_update_cdf_c/avx2
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <string.h>
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "EbBitstreamUnit.h"
+#include "common_dsp_rtcd.h"
+#include "random.h"
+
+namespace {
+
+using svt_av1_test_tool::SVTRandom;
+
+static const int kMaxSyms = 16;
+// entries after the CDF and its counter, which the kernels must not touch
+static const int kGuard = 16;
+
+class CdfKernelTest : public ::testing::Test {
+  protected:
+    CdfKernelTest() : prob_rnd_(0, CDF_PROB_TOP), count_rnd_(0, 32) {
+    }
+
+    /** Fills an inverse CDF of nsyms symbols, with the extreme values among
+     * the random ones, and its counter */
+    void init_cdf(uint16_t *icdf, int nsyms) {
+        for (int i = 0; i < nsyms - 1; i++) icdf[i] = (uint16_t)prob_rnd_.random();
+        if (prob_rnd_.random() & 1)
+            icdf[0] = AOM_ICDF(0);
+        std::sort(icdf, icdf + nsyms - 1, std::greater<uint16_t>());
+        icdf[nsyms - 1] = AOM_ICDF(CDF_PROB_TOP);
+        icdf[nsyms]     = (uint16_t)count_rnd_.random();
+        for (int i = nsyms + 1; i < kMaxSyms + 1 + kGuard; i++) icdf[i] = 0xdead;
+    }
+
+    /** The early exit search of od_ec_decode_cdf_q15 */
+    static int search_ref(const uint16_t *icdf, int nsyms, uint32_t c, uint32_t r) {
+        const int N   = nsyms - 1;
+        uint32_t  v   = r;
+        int       ret = -1;
+        do {
+            ret++;
+            v = ((r >> 8) * (uint32_t)(icdf[ret] >> EC_PROB_SHIFT) >> (7 - EC_PROB_SHIFT)) +
+                EC_MIN_PROB * (N - ret);
+        } while (c < v);
+        return ret;
+    }
+
+    SVTRandom prob_rnd_;
+    SVTRandom count_rnd_;
+    uint16_t  ref_[kMaxSyms + 1 + kGuard];
+    uint16_t  tst_[kMaxSyms + 1 + kGuard];
+};
+
+TEST_F(CdfKernelTest, SearchMatchReference) {
+    SVTRandom rng_rnd(32768, 65535);
+    SVTRandom c_rnd(0, 65535);
+    for (int nsyms = 2; nsyms <= kMaxSyms; nsyms++) {
+        for (int iter = 0; iter < 2000; iter++) {
+            init_cdf(ref_, nsyms);
+            const uint32_t r = (uint32_t)rng_rnd.random();
+            const uint32_t c = (uint32_t)c_rnd.random() % r;
+            const int      expected = search_ref(ref_, nsyms, c, r);
+            ASSERT_EQ(expected, svt_od_ec_search_cdf_c(ref_, nsyms, c, r))
+                << "nsyms " << nsyms << " c " << c << " r " << r;
+            ASSERT_EQ(expected, svt_od_ec_search_cdf_avx2(ref_, nsyms, c, r))
+                << "nsyms " << nsyms << " c " << c << " r " << r;
+        }
+    }
+}
+
+TEST_F(CdfKernelTest, UpdateMatchC) {
+    for (int nsyms = 2; nsyms <= kMaxSyms; nsyms++) {
+        SVTRandom val_rnd(0, nsyms - 1);
+        for (int iter = 0; iter < 2000; iter++) {
+            init_cdf(ref_, nsyms);
+            memcpy(tst_, ref_, sizeof(ref_));
+            const int val = val_rnd.random();
+            svt_av1_update_cdf_c(ref_, val, nsyms);
+            svt_av1_update_cdf_avx2(tst_, val, nsyms);
+            for (int i = 0; i < kMaxSyms + 1 + kGuard; i++)
+                ASSERT_EQ(ref_[i], tst_[i])
+                    << "nsyms " << nsyms << " val " << val << " entry " << i;
+        }
+    }
+}
+
+}  // namespace
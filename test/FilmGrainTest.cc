@@ -267,6 +267,139 @@ TEST_F(AddFilmGrainTest, MatchTest) {
     }
 }
 
+/* The stripes of a frame can be added separately and in any order, as done
+   by the decoder worker threads */
+TEST_F(AddFilmGrainTest, BandsMatchFrame) {
+    for (int i = 0; i < 3; ++i) {
+        FilmGrainCtxt ctx;
+        init_data();
+        ASSERT_EQ(svt_av1_film_grain_init(&ctx,
+                                          film_grain_test_vectors + i,
+                                          luma_,
+                                          cb_,
+                                          cr_,
+                                          kHeight,
+                                          kWidth,
+                                          kWidth,     /* luma stride */
+                                          kWidth / 2, /* chroma stride */
+                                          0,
+                                          1,
+                                          1),
+                  EB_ErrorNone);
+        const int32_t stripe_count = svt_av1_film_grain_stripe_count(&ctx);
+        EXPECT_EQ(stripe_count, kHeight / FGN_STRIPE_HEIGHT);
+        for (int32_t stripe = stripe_count - 1; stripe >= 0; --stripe)
+            EXPECT_EQ(svt_av1_film_grain_add_noise(&ctx, stripe, 1), EB_ErrorNone);
+        svt_av1_film_grain_free(&ctx);
+        check_output(i);
+        EXPECT_FALSE(HasFailure());
+    }
+}
+
+/* The AVX2 noise kernels match the C ones, the widths cover the columns
+   left to the C code */
+class AddNoiseTest : public ::testing::TestWithParam<int> {
+  public:
+    static const int kMaxWidth = 72;
+    static const int kHeight = 8;
+    static const int kStride = 2 * kMaxWidth + 8;
+
+    AddNoiseTest() : rnd_(libaom_test::ACMRandom::DeterministicSeed()) {
+    }
+
+  protected:
+    void init_plane(int bit_depth, int subsamp_x, int subsamp_y) {
+        for (int i = 0; i < 256; ++i)
+            scaling_lut_[i] = rnd_.Rand8();
+        plane_.scaling_lut = scaling_lut_;
+        plane_.scaling_shift = 8 + rnd_(4);
+        plane_.bit_depth = bit_depth;
+        if (rnd_(2)) {
+            plane_.min_value = 16 << (bit_depth - 8);
+            plane_.max_value = 240 << (bit_depth - 8);
+        } else {
+            plane_.min_value = 0;
+            plane_.max_value = (256 << (bit_depth - 8)) - 1;
+        }
+        plane_.mult = rnd_(256) - 128;
+        plane_.luma_mult = rnd_(256) - 128;
+        plane_.offset = (rnd_(512) << (bit_depth - 8)) - (1 << bit_depth);
+        plane_.subsamp_x = subsamp_x;
+        plane_.subsamp_y = subsamp_y;
+
+        const int grain_max = (128 << (bit_depth - 8)) - 1;
+        for (int i = 0; i < kHeight * kStride; ++i) {
+            grain_[i] = rnd_(2 * grain_max + 2) - grain_max - 1;
+            luma_[i] = rnd_(256 << (bit_depth - 8));
+            chroma_ref_[i] = chroma_tst_[i] = rnd_(256 << (bit_depth - 8));
+        }
+    }
+
+    void check(int width, int height) {
+        for (int i = 0; i < height; ++i)
+            for (int j = 0; j < kStride; ++j)
+                ASSERT_EQ(chroma_ref_[i * kStride + j], chroma_tst_[i * kStride + j])
+                    << "width " << width << " row " << i << " col " << j;
+    }
+
+    void run_8bit() {
+        uint8_t luma8[kHeight * 2 * kStride];
+        uint8_t ref8[kHeight * kStride], tst8[kHeight * kStride];
+        for (int width = 1; width <= kMaxWidth; ++width) {
+            init_plane(8, width & 1, (width >> 1) & 1);
+            for (int i = 0; i < kHeight * kStride; ++i) {
+                luma8[i] = luma8[i + kHeight * kStride] = (uint8_t)luma_[i];
+                ref8[i] = tst8[i] = (uint8_t)chroma_ref_[i];
+            }
+            svt_av1_add_noise_chroma_c(
+                ref8, kStride, luma8, kStride, grain_, kStride, width, kHeight, &plane_);
+            svt_av1_add_noise_chroma_avx2(
+                tst8, kStride, luma8, kStride, grain_, kStride, width, kHeight, &plane_);
+            svt_av1_add_noise_luma_c(ref8, kStride, grain_, kStride, width, kHeight, &plane_);
+            svt_av1_add_noise_luma_avx2(tst8, kStride, grain_, kStride, width, kHeight, &plane_);
+            for (int i = 0; i < kHeight * kStride; ++i) {
+                chroma_ref_[i] = ref8[i];
+                chroma_tst_[i] = tst8[i];
+            }
+            check(width, kHeight);
+        }
+    }
+
+    void run_hbd(int bit_depth) {
+        uint16_t luma16[kHeight * 2 * kStride];
+        for (int width = 1; width <= kMaxWidth; ++width) {
+            init_plane(bit_depth, width & 1, (width >> 1) & 1);
+            for (int i = 0; i < kHeight * kStride; ++i)
+                luma16[i] = luma16[i + kHeight * kStride] = luma_[i];
+            svt_av1_add_noise_chroma_hbd_c(
+                chroma_ref_, kStride, luma16, kStride, grain_, kStride, width, kHeight, &plane_);
+            svt_av1_add_noise_chroma_hbd_avx2(
+                chroma_tst_, kStride, luma16, kStride, grain_, kStride, width, kHeight, &plane_);
+            svt_av1_add_noise_luma_hbd_c(
+                chroma_ref_, kStride, grain_, kStride, width, kHeight, &plane_);
+            svt_av1_add_noise_luma_hbd_avx2(
+                chroma_tst_, kStride, grain_, kStride, width, kHeight, &plane_);
+            check(width, kHeight);
+        }
+    }
+
+    libaom_test::ACMRandom rnd_;
+    FgnPlaneParams plane_;
+    int32_t scaling_lut_[256];
+    int32_t grain_[kHeight * kStride];
+    uint16_t luma_[kHeight * kStride];
+    uint16_t chroma_ref_[kHeight * kStride];
+    uint16_t chroma_tst_[kHeight * kStride];
+};
+
+TEST_P(AddNoiseTest, MatchC) {
+    if (GetParam() == 8)
+        run_8bit();
+    run_hbd(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(FilmGrain, AddNoiseTest, ::testing::Values(8, 10, 12));
+
 extern "C" {
 #include "EbPictureControlSet.h"
 #include "EbPictureBufferDesc.h"
@@ -0,0 +1,114 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file InvQuantizeTest.cc
+ *
+ * @brief Unit test of the decoder dequantization:
+ * - svt_av1_dequant_scatter_avx2
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "EbCoefficients.h"
+#include "common_dsp_rtcd.h"
+#include "random.h"
+
+namespace {
+
+using svt_av1_test_tool::SVTRandom;
+
+/**
+ * Test strategy:
+ * Dequantize random levels of every transform size and scan with the C and
+ * the avx2 kernels, without and with a quantization matrix, for eobs that
+ * end inside and on the 8 coefficient blocks.
+ *
+ * Expected result:
+ * Both write the same coefficients and leave the others untouched.
+ */
+class DequantScatterTest : public ::testing::TestWithParam<int> {
+  protected:
+    static const int kMaxCoeffs = 64 * 64;
+
+    // levels up to the golomb coded range, a third of them zero
+    DequantScatterTest()
+        : lev_rnd_(-(1 << 15), 1 << 15),
+          zero_rnd_(0, 2),
+          dq_rnd_(4, 1336 << (GetParam() - 8)),
+          qm_rnd_(1, 255) {
+    }
+
+    void run(TxSize tx_size, TxType tx_type, int32_t n_coeffs, bool use_qm) {
+        const int      bit_depth = GetParam();
+        const int16_t *scan      = av1_scan_orders[tx_size][tx_type].scan;
+
+        // the level after the eob must not be read
+        for (int32_t i = 0; i <= n_coeffs; i++)
+            level_[i] = zero_rnd_.random() ? lev_rnd_.random() : 0;
+        level_[n_coeffs] = 0x7fffffff;
+        for (int i = 0; i < kMaxCoeffs; i++) iqmatrix_[i] = (QmVal)qm_rnd_.random();
+        const int16_t dequant[2] = {(int16_t)dq_rnd_.random(), (int16_t)dq_rnd_.random()};
+        const QmVal * iqmatrix   = use_qm ? iqmatrix_ : NULL;
+        const int32_t shift      = av1_get_tx_scale(tx_size);
+
+        for (int i = 0; i < kMaxCoeffs; i++) ref_[i] = tst_[i] = -1;
+        svt_av1_dequant_scatter_c(
+            level_, n_coeffs, scan, dequant, iqmatrix, shift, bit_depth, ref_);
+        svt_av1_dequant_scatter_avx2(
+            level_, n_coeffs, scan, dequant, iqmatrix, shift, bit_depth, tst_);
+        for (int i = 0; i < kMaxCoeffs; i++)
+            ASSERT_EQ(ref_[i], tst_[i]) << "tx_size " << tx_size << " tx_type " << tx_type
+                                        << " eob " << n_coeffs << " pos " << i;
+    }
+
+    SVTRandom lev_rnd_;
+    SVTRandom zero_rnd_;
+    SVTRandom dq_rnd_;
+    SVTRandom qm_rnd_;
+    int32_t   level_[kMaxCoeffs + 1];
+    QmVal     iqmatrix_[kMaxCoeffs];
+    int32_t   ref_[kMaxCoeffs];
+    int32_t   tst_[kMaxCoeffs];
+};
+
+TEST_P(DequantScatterTest, MatchC) {
+    for (int tx_size = TX_4X4; tx_size < TX_SIZES_ALL; tx_size++) {
+        // only the top left 32x32 of the 64 sizes is coded
+        const int32_t area = AOMMIN(tx_size_wide[tx_size], 32) *
+            AOMMIN(tx_size_high[tx_size], 32);
+        const int32_t eobs[] = {1, 7, 8, 9, area / 2 + 3, area};
+        for (int tx_type = DCT_DCT; tx_type < TX_TYPES; tx_type++) {
+            if (av1_scan_orders[tx_size][tx_type].scan == NULL)
+                continue;
+            for (int32_t eob : eobs) {
+                run((TxSize)tx_size, (TxType)tx_type, eob, false);
+                run((TxSize)tx_size, (TxType)tx_type, eob, true);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(InvQuantize, DequantScatterTest, ::testing::Values(8, 10, 12));
+
+}  // namespace
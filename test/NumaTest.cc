@@ -0,0 +1,160 @@
+/*
+* Copyright(c) 2020 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file NumaTest.cc
+ *
+ * @brief Unit test of the NUMA placement helpers:
+ * - svt_numa_node_count / svt_numa_node_online
+ * - svt_numa_node_of_cpu
+ * - svt_numa_prefer_node / svt_numa_interleave
+ * - svt_numa_save_policy / svt_numa_restore_policy
+ * - svt_numa_get_stats
+ * - svt_set_thread_eager_commit
+ *
+ * On single node systems the policy calls are no-ops; the tests then only
+ * check that the topology is reported consistently.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "EbNuma.h"
+extern "C" {
+#include "EbMalloc.h"
+}
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/** Online nodes, in increasing order */
+static std::vector<uint32_t> online_nodes() {
+    std::vector<uint32_t> nodes;
+    for (uint32_t node = 0; node < svt_numa_node_count(); node++)
+        if (svt_numa_node_online(node))
+            nodes.push_back(node);
+    return nodes;
+}
+
+TEST(NumaTest, TopologyIsConsistent) {
+    const uint32_t node_count = svt_numa_node_count();
+
+    ASSERT_GE(node_count, 1u);
+    ASSERT_LE(node_count, (uint32_t)EB_NUMA_MAX_NODES);
+    EXPECT_EQ(node_count, svt_numa_node_count());
+    // The highest node is online, nodes below it may be holes
+    EXPECT_TRUE(svt_numa_node_online(node_count - 1));
+    EXPECT_FALSE(svt_numa_node_online(node_count));
+    for (uint32_t cpu = 0; cpu < 64; cpu++) {
+        const uint32_t node = svt_numa_node_of_cpu(cpu);
+        EXPECT_LT(node, node_count);
+        EXPECT_TRUE(node_count == 1 || svt_numa_node_online(node));
+    }
+}
+
+TEST(NumaTest, PoliciesKeepMemoryUsable) {
+    const size_t                size  = 4 << 20;
+    const std::vector<uint32_t> nodes = online_nodes();
+    const uint32_t              count = (uint32_t)nodes.size();
+    EbNumaPolicy                saved;
+
+    svt_numa_save_policy(&saved);
+    for (uint32_t policy = 0; policy <= count; policy++) {
+        if (policy < count)
+            svt_numa_prefer_node(nodes[policy]);
+        else
+            svt_numa_interleave(nodes.data(), count);
+        uint8_t *buf = (uint8_t *)malloc(size);
+        ASSERT_NE(buf, nullptr);
+        memset(buf, (int)policy + 1, size);
+        svt_numa_restore_policy(&saved);
+        EXPECT_EQ(buf[0], (uint8_t)(policy + 1));
+        EXPECT_EQ(buf[size - 1], (uint8_t)(policy + 1));
+        free(buf);
+    }
+}
+
+TEST(NumaTest, RestoreGivesBackSavedPolicy) {
+    const std::vector<uint32_t> nodes = online_nodes();
+    EbNumaPolicy                saved, restored;
+
+    svt_numa_save_policy(&saved);
+    svt_numa_interleave(nodes.data(), (uint32_t)nodes.size());
+    svt_numa_restore_policy(&saved);
+    svt_numa_save_policy(&restored);
+    EXPECT_EQ(saved.valid, restored.valid);
+    EXPECT_EQ(saved.mode, restored.mode);
+    EXPECT_EQ(0, memcmp(saved.mask, restored.mask, sizeof(saved.mask)));
+}
+
+#ifdef __linux__
+/** Resident pages of the page aligned part of [p, p + size) */
+static size_t resident_pages(const uint8_t *p, size_t size) {
+    const uintptr_t page  = (uintptr_t)sysconf(_SC_PAGESIZE);
+    const uintptr_t first = ((uintptr_t)p + page - 1) & ~(page - 1);
+    const uintptr_t last  = ((uintptr_t)p + size) & ~(page - 1);
+    const size_t    count = (last - first) / page;
+    unsigned char * vec   = (unsigned char *)malloc(count);
+    size_t          resident = 0;
+
+    if (!vec || mincore((void *)first, last - first, vec) != 0) {
+        free(vec);
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) resident += vec[i] & 1;
+    free(vec);
+    return resident;
+}
+
+TEST(NumaTest, EagerCommitTouchesEveryPage) {
+    // Large enough for calloc to map fresh zero pages
+    const size_t   size  = 16 << 20;
+    const size_t   pages = size / (size_t)sysconf(_SC_PAGESIZE) - 1;
+    EbNumaPolicy   saved;
+
+    uint8_t *lazy = (uint8_t *)svt_calloc_aligned_lazy(size);
+    ASSERT_NE(lazy, nullptr);
+    EXPECT_LT(resident_pages(lazy, size), pages);
+    svt_free_aligned_lazy(lazy);
+
+    svt_numa_save_policy(&saved);
+    svt_numa_prefer_node(0);
+    svt_set_thread_eager_commit(EB_TRUE);
+    uint8_t *eager = (uint8_t *)svt_calloc_aligned_lazy(size);
+    svt_set_thread_eager_commit(EB_FALSE);
+    svt_numa_restore_policy(&saved);
+    ASSERT_NE(eager, nullptr);
+    EXPECT_GE(resident_pages(eager, size), pages);
+    EXPECT_EQ(eager[0], 0);
+    EXPECT_EQ(eager[size - 1], 0);
+    svt_free_aligned_lazy(eager);
+}
+#endif
+
+TEST(NumaTest, StatsDoNotDecrease) {
+    EbNumaStats before, after;
+
+    svt_numa_get_stats(&before);
+    uint8_t *buf = (uint8_t *)malloc(1 << 20);
+    ASSERT_NE(buf, nullptr);
+    memset(buf, 0, 1 << 20);
+    free(buf);
+    svt_numa_get_stats(&after);
+    EXPECT_GE(after.local_pages, before.local_pages);
+    EXPECT_GE(after.remote_pages, before.remote_pages);
+}
+
+}  // namespace
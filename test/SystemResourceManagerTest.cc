@@ -0,0 +1,361 @@
+/*
+* Copyright(c) 2020 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SystemResourceManagerTest.cc
+ *
+ * @brief Unit test and micro benchmark of the system resource manager:
+ * - svt_get_empty_object
+ * - svt_post_full_object
+ * - svt_get_full_object
+ * - svt_get_full_object_non_blocking
+ * - svt_release_object
+ * - svt_shutdown_process
+ *
+ * The speed tests report the hand-off latency (ping-pong between two
+ * threads) and the throughput of many producers and consumers sharing
+ * one SystemResource. Build with ENABLE_LOCKFREE_FIFO ON and OFF to
+ * compare the lock-free queues with the mutex + semaphore queues.
+ *
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "EbSystemResourceManager.h"
+#include "EbThreads.h"
+#include "EbTime.h"
+// workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+namespace {
+
+const char *fifo_impl_name() {
+    return EN_LOCKFREE_FIFO ? "lock-free" : "mutex+semaphore";
+}
+
+typedef struct FifoTestObject {
+    EbDctor dctor;
+    uint64_t value;
+} FifoTestObject;
+
+static EbErrorType fifo_test_object_creator(EbPtr *object_dbl_ptr,
+                                            EbPtr object_init_data_ptr) {
+    (void)object_init_data_ptr;
+    FifoTestObject *obj = (FifoTestObject *)calloc(1, sizeof(*obj));
+    if (!obj)
+        return EB_ErrorInsufficientResources;
+    *object_dbl_ptr = obj;
+    return EB_ErrorNone;
+}
+
+static void fifo_test_object_destroyer(EbPtr p) {
+    free(p);
+}
+
+static EbSystemResource *create_resource(uint32_t object_count,
+                                         uint32_t producer_count,
+                                         uint32_t consumer_count) {
+    EbSystemResource *resource =
+        (EbSystemResource *)calloc(1, sizeof(EbSystemResource));
+    if (!resource)
+        return NULL;
+    if (svt_system_resource_ctor(resource,
+                                 object_count,
+                                 producer_count,
+                                 consumer_count,
+                                 fifo_test_object_creator,
+                                 NULL,
+                                 fifo_test_object_destroyer) !=
+        EB_ErrorNone) {
+        resource->dctor(resource);
+        free(resource);
+        return NULL;
+    }
+    return resource;
+}
+
+static void destroy_resource(EbSystemResource *resource) {
+    resource->dctor(resource);
+    free(resource);
+}
+
+/** Producers post objects carrying 1..count, consumers sum them up */
+typedef struct ProducerContext {
+    EbFifo *fifo;
+    uint64_t first;
+    uint64_t count;
+} ProducerContext;
+
+typedef struct ConsumerContext {
+    EbFifo *fifo;
+    uint64_t sum;
+    uint64_t count;
+} ConsumerContext;
+
+static void *producer_kernel(void *input_ptr) {
+    ProducerContext *context = (ProducerContext *)input_ptr;
+    for (uint64_t i = 0; i < context->count; i++) {
+        EbObjectWrapper *wrapper;
+        svt_get_empty_object(context->fifo, &wrapper);
+        ((FifoTestObject *)wrapper->object_ptr)->value = context->first + i;
+        svt_post_full_object(wrapper);
+    }
+    return NULL;
+}
+
+static void *consumer_kernel(void *input_ptr) {
+    ConsumerContext *context = (ConsumerContext *)input_ptr;
+    for (;;) {
+        EbObjectWrapper *wrapper;
+        if (svt_get_full_object(context->fifo, &wrapper) ==
+            EB_NoErrorFifoShutdown)
+            break;
+        context->sum += ((FifoTestObject *)wrapper->object_ptr)->value;
+        context->count++;
+        svt_release_object(wrapper);
+    }
+    return NULL;
+}
+
+/** Waits until every object went back to the empty queue, that is every
+ * posted object was consumed and released */
+static void drain_resource(EbSystemResource *resource, uint32_t object_count) {
+    EbFifo *fifo = svt_system_resource_get_producer_fifo(resource, 0);
+    EbObjectWrapper **wrappers =
+        (EbObjectWrapper **)malloc(object_count * sizeof(*wrappers));
+    ASSERT_NE(wrappers, nullptr);
+    for (uint32_t i = 0; i < object_count; i++)
+        svt_get_empty_object(fifo, &wrappers[i]);
+    for (uint32_t i = 0; i < object_count; i++)
+        svt_release_object(wrappers[i]);
+    free(wrappers);
+}
+
+typedef std::tuple<uint32_t, uint32_t, uint32_t> FifoParam;
+
+class SystemResourceTest : public ::testing::TestWithParam<FifoParam> {
+  protected:
+    void SetUp() override {
+        object_count_ = std::get<0>(GetParam());
+        producer_count_ = std::get<1>(GetParam());
+        consumer_count_ = std::get<2>(GetParam());
+    }
+
+    // Runs producers and consumers over one SystemResource, returns the
+    // elapsed time in ms
+    double run_producers_consumers(uint64_t items_per_producer) {
+        EbSystemResource *resource =
+            create_resource(object_count_, producer_count_, consumer_count_);
+        EXPECT_NE(resource, nullptr);
+        if (!resource)
+            return 0;
+
+        ProducerContext *producers = new ProducerContext[producer_count_];
+        ConsumerContext *consumers = new ConsumerContext[consumer_count_];
+        EbHandle *producer_threads = new EbHandle[producer_count_];
+        EbHandle *consumer_threads = new EbHandle[consumer_count_];
+        uint64_t start_seconds, start_useconds;
+        uint64_t finish_seconds, finish_useconds;
+
+        svt_av1_get_time(&start_seconds, &start_useconds);
+        for (uint32_t i = 0; i < consumer_count_; i++) {
+            consumers[i].fifo =
+                svt_system_resource_get_consumer_fifo(resource, i);
+            consumers[i].sum = 0;
+            consumers[i].count = 0;
+            consumer_threads[i] =
+                svt_create_thread(consumer_kernel, &consumers[i]);
+            EXPECT_NE(consumer_threads[i], nullptr);
+        }
+        for (uint32_t i = 0; i < producer_count_; i++) {
+            producers[i].fifo =
+                svt_system_resource_get_producer_fifo(resource, i);
+            producers[i].first = 1 + i * items_per_producer;
+            producers[i].count = items_per_producer;
+            producer_threads[i] =
+                svt_create_thread(producer_kernel, &producers[i]);
+            EXPECT_NE(producer_threads[i], nullptr);
+        }
+        for (uint32_t i = 0; i < producer_count_; i++)
+            svt_destroy_thread(producer_threads[i]);
+        drain_resource(resource, object_count_);
+        svt_av1_get_time(&finish_seconds, &finish_useconds);
+
+        svt_shutdown_process(resource);
+        for (uint32_t i = 0; i < consumer_count_; i++)
+            svt_destroy_thread(consumer_threads[i]);
+
+        const uint64_t total = items_per_producer * producer_count_;
+        uint64_t sum = 0, count = 0;
+        for (uint32_t i = 0; i < consumer_count_; i++) {
+            sum += consumers[i].sum;
+            count += consumers[i].count;
+        }
+        EXPECT_EQ(count, total);
+        EXPECT_EQ(sum, total * (total + 1) / 2);
+
+        delete[] producers;
+        delete[] consumers;
+        delete[] producer_threads;
+        delete[] consumer_threads;
+        destroy_resource(resource);
+
+        return svt_av1_compute_overall_elapsed_time_ms(
+            start_seconds, start_useconds, finish_seconds, finish_useconds);
+    }
+
+    uint32_t object_count_;
+    uint32_t producer_count_;
+    uint32_t consumer_count_;
+};
+
+TEST_P(SystemResourceTest, ProducersConsumersMatch) {
+    run_producers_consumers(10000);
+}
+
+TEST_P(SystemResourceTest, DISABLED_ThroughputSpeedTest) {
+    const uint64_t items_per_producer = 1000000;
+    const double time =
+        run_producers_consumers(items_per_producer) / 1000;
+    const double items = (double)items_per_producer * producer_count_;
+    printf("%s fifo, %u objects, %u producers, %u consumers: %.2f Mitems/s\n",
+           fifo_impl_name(),
+           object_count_,
+           producer_count_,
+           consumer_count_,
+           items / time / 1000000);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SRM, SystemResourceTest,
+    ::testing::Values(std::make_tuple(1u, 1u, 1u), std::make_tuple(4u, 1u, 1u),
+                      std::make_tuple(8u, 4u, 4u), std::make_tuple(16u, 1u, 8u),
+                      std::make_tuple(16u, 8u, 1u),
+                      std::make_tuple(64u, 16u, 16u)));
+
+TEST(SystemResourceTest, NonBlockingGetFullObject) {
+    EbSystemResource *resource = create_resource(2, 1, 1);
+    ASSERT_NE(resource, nullptr);
+    EbFifo *producer = svt_system_resource_get_producer_fifo(resource, 0);
+    EbFifo *consumer = svt_system_resource_get_consumer_fifo(resource, 0);
+    EbObjectWrapper *wrapper;
+
+    svt_get_full_object_non_blocking(consumer, &wrapper);
+    EXPECT_EQ(wrapper, nullptr);
+
+    svt_get_empty_object(producer, &wrapper);
+    ((FifoTestObject *)wrapper->object_ptr)->value = 42;
+    svt_post_full_object(wrapper);
+
+    svt_get_full_object_non_blocking(consumer, &wrapper);
+    ASSERT_NE(wrapper, nullptr);
+    EXPECT_EQ(((FifoTestObject *)wrapper->object_ptr)->value, 42u);
+    svt_release_object(wrapper);
+
+    svt_get_full_object_non_blocking(consumer, &wrapper);
+    EXPECT_EQ(wrapper, nullptr);
+
+    svt_shutdown_process(resource);
+    destroy_resource(resource);
+}
+
+TEST(SystemResourceTest, LiveCountDelaysRelease) {
+    EbSystemResource *resource = create_resource(1, 1, 1);
+    ASSERT_NE(resource, nullptr);
+    EbFifo *producer = svt_system_resource_get_producer_fifo(resource, 0);
+    EbObjectWrapper *wrapper, *again;
+
+    svt_get_empty_object(producer, &wrapper);
+    svt_object_inc_live_count(wrapper, 2);
+    svt_release_object(wrapper);
+    EXPECT_EQ(wrapper->live_count, 1u);
+    svt_release_object(wrapper);
+    EXPECT_EQ(wrapper->live_count, EB_ObjectWrapperReleasedValue);
+
+    // the only object is back in the empty queue, this must not block
+    svt_get_empty_object(producer, &again);
+    EXPECT_EQ(again, wrapper);
+    svt_release_object(again);
+
+    svt_shutdown_process(resource);
+    destroy_resource(resource);
+}
+
+/** Ping-pong between two threads through two SystemResources */
+typedef struct PingPongContext {
+    EbFifo *empty_fifo;
+    EbFifo *full_fifo;
+    uint64_t round_trips;
+} PingPongContext;
+
+static void *pong_kernel(void *input_ptr) {
+    PingPongContext *context = (PingPongContext *)input_ptr;
+    for (uint64_t i = 0; i < context->round_trips; i++) {
+        EbObjectWrapper *in, *out;
+        svt_get_full_object(context->full_fifo, &in);
+        svt_get_empty_object(context->empty_fifo, &out);
+        ((FifoTestObject *)out->object_ptr)->value =
+            ((FifoTestObject *)in->object_ptr)->value;
+        svt_release_object(in);
+        svt_post_full_object(out);
+    }
+    return NULL;
+}
+
+TEST(SystemResourceTest, DISABLED_HandOffLatencySpeedTest) {
+    const uint64_t round_trips = 200000;
+    EbSystemResource *ping = create_resource(1, 1, 1);
+    EbSystemResource *pong = create_resource(1, 1, 1);
+    ASSERT_NE(ping, nullptr);
+    ASSERT_NE(pong, nullptr);
+    EbFifo *ping_empty = svt_system_resource_get_producer_fifo(ping, 0);
+    EbFifo *pong_full = svt_system_resource_get_consumer_fifo(pong, 0);
+    PingPongContext context = {
+        svt_system_resource_get_producer_fifo(pong, 0),
+        svt_system_resource_get_consumer_fifo(ping, 0),
+        round_trips};
+    uint64_t start_seconds, start_useconds;
+    uint64_t finish_seconds, finish_useconds;
+
+    EbHandle thread = svt_create_thread(pong_kernel, &context);
+    ASSERT_NE(thread, nullptr);
+
+    svt_av1_get_time(&start_seconds, &start_useconds);
+    for (uint64_t i = 0; i < round_trips; i++) {
+        EbObjectWrapper *wrapper;
+        svt_get_empty_object(ping_empty, &wrapper);
+        ((FifoTestObject *)wrapper->object_ptr)->value = i;
+        svt_post_full_object(wrapper);
+        svt_get_full_object(pong_full, &wrapper);
+        EXPECT_EQ(((FifoTestObject *)wrapper->object_ptr)->value, i);
+        svt_release_object(wrapper);
+    }
+    svt_av1_get_time(&finish_seconds, &finish_useconds);
+    svt_destroy_thread(thread);
+
+    const double time = svt_av1_compute_overall_elapsed_time_ms(
+        start_seconds, start_useconds, finish_seconds, finish_useconds);
+    printf("%s fifo hand-off latency: %.1f ns\n",
+           fifo_impl_name(),
+           time * 1000000 / (round_trips * 2));
+
+    svt_shutdown_process(ping);
+    svt_shutdown_process(pong);
+    destroy_resource(ping);
+    destroy_resource(pong);
+}
+
+}  // namespace
@@ -19,11 +19,13 @@
  ******************************************************************************/
 
 #include "aom_dsp_rtcd.h"
+#include "common_dsp_rtcd.h"
 
 /** setup_test_env is a util for unit test setup environment without create a
  * encoder */
 void setup_test_env() {
     CPU_FLAGS cpu_flags = get_cpu_flags_to_use();
 
+    setup_common_rtcd_internal(cpu_flags);
     setup_rtcd_internal(cpu_flags);
 }
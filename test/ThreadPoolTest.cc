@@ -0,0 +1,830 @@
+/*
+* Copyright(c) 2020 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file ThreadPoolTest.cc
+ *
+ * @brief Unit test and micro benchmark of the work-stealing thread pool:
+ * - svt_thread_pool_ctor
+ * - svt_thread_pool_submit
+ * - svt_pool_client_ctor
+ * - svt_pool_client_submit, svt_pool_client_ctor queue reuse
+ * - the priorities and weights of the clients
+ * - svt_system_resource_attach_thread_pool
+ * - svt_get_output_object, svt_park_full_object
+ *
+ * The speed test compares a pooled consumer stage with dedicated consumer
+ * threads blocked on the full fifos of the same SystemResource.
+ *
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "EbThreadPool.h"
+#include "EbSystemResourceManager.h"
+#include "EbThreads.h"
+#include "EbTime.h"
+// workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+namespace {
+
+/** Per worker context, only ever touched by its own worker */
+typedef struct WorkerStats {
+    uint32_t worker_index;
+    uint64_t task_count;
+} WorkerStats;
+
+typedef struct TaskTree {
+    EbThreadPool *pool;
+    EbPtr *contexts;
+    EbHandle done_semaphore;
+    volatile int32_t *run_count;
+} TaskTree;
+
+typedef struct TaskNode {
+    TaskTree *tree;
+    uint32_t depth;
+    volatile int32_t runs;
+} TaskNode;
+
+static EbThreadPool *create_pool(uint32_t worker_count,
+                                 uint32_t task_capacity) {
+    EbThreadPool *pool = (EbThreadPool *)calloc(1, sizeof(EbThreadPool));
+    if (!pool)
+        return NULL;
+    if (svt_thread_pool_ctor(pool, worker_count, task_capacity) !=
+        EB_ErrorNone) {
+        pool->dctor(pool);
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+static void destroy_pool(EbThreadPool *pool) {
+    pool->dctor(pool);
+    free(pool);
+}
+
+static void count_task(void *context_ptr, void *data_ptr) {
+    WorkerStats *stats = (WorkerStats *)context_ptr;
+    TaskNode *node = (TaskNode *)data_ptr;
+    stats->task_count++;
+    svt_atomic_fetch_add_i32(&node->runs, 1);
+    svt_atomic_fetch_add_i32(node->tree->run_count, 1);
+    svt_post_semaphore(node->tree->done_semaphore);
+}
+
+/** Every node of a binary tree submits its two children from inside the
+ * pool before completing */
+static void tree_task(void *context_ptr, void *data_ptr) {
+    TaskNode *node = (TaskNode *)data_ptr;
+    if (node->depth) {
+        for (uint32_t child = 0; child < 2; child++) {
+            TaskNode *child_node = (TaskNode *)calloc(1, sizeof(TaskNode));
+            child_node->tree = node->tree;
+            child_node->depth = node->depth - 1;
+            svt_thread_pool_submit(
+                node->tree->pool, tree_task, node->tree->contexts, child_node);
+        }
+    }
+    ((WorkerStats *)context_ptr)->task_count++;
+    svt_atomic_fetch_add_i32(node->tree->run_count, 1);
+    svt_post_semaphore(node->tree->done_semaphore);
+    free(node);
+}
+
+class ThreadPoolTest : public ::testing::TestWithParam<uint32_t> {
+  protected:
+    void SetUp() override {
+        worker_count_ = GetParam();
+        stats_ = new WorkerStats[worker_count_];
+        contexts_ = new EbPtr[worker_count_];
+        for (uint32_t i = 0; i < worker_count_; i++) {
+            stats_[i].worker_index = i;
+            stats_[i].task_count = 0;
+            contexts_[i] = &stats_[i];
+        }
+        run_count_ = 0;
+        tree_.contexts = contexts_;
+        tree_.done_semaphore = svt_create_semaphore(0, ~0u >> 1);
+        tree_.run_count = &run_count_;
+    }
+
+    void TearDown() override {
+        svt_destroy_semaphore(tree_.done_semaphore);
+        delete[] contexts_;
+        delete[] stats_;
+    }
+
+    uint64_t total_task_count() const {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < worker_count_; i++)
+            total += stats_[i].task_count;
+        return total;
+    }
+
+    uint32_t worker_count_;
+    WorkerStats *stats_;
+    EbPtr *contexts_;
+    volatile int32_t run_count_;
+    TaskTree tree_;
+};
+
+TEST_P(ThreadPoolTest, ExternalSubmissionsRunOnce) {
+    const uint32_t task_count = 1000;
+    EbThreadPool *pool = create_pool(worker_count_, task_count);
+    ASSERT_NE(pool, nullptr);
+    tree_.pool = pool;
+
+    TaskNode *nodes = (TaskNode *)calloc(task_count, sizeof(TaskNode));
+    ASSERT_NE(nodes, nullptr);
+    for (uint32_t i = 0; i < task_count; i++) {
+        nodes[i].tree = &tree_;
+        ASSERT_EQ(svt_thread_pool_submit(pool, count_task, contexts_, &nodes[i]),
+                  EB_ErrorNone);
+    }
+    for (uint32_t i = 0; i < task_count; i++)
+        svt_block_on_semaphore(tree_.done_semaphore);
+    destroy_pool(pool);
+
+    for (uint32_t i = 0; i < task_count; i++)
+        EXPECT_EQ(nodes[i].runs, 1) << "task " << i;
+    EXPECT_EQ(total_task_count(), task_count);
+    free(nodes);
+}
+
+TEST_P(ThreadPoolTest, NestedSubmissionsRunOnce) {
+    const uint32_t depth = 10;
+    const uint32_t task_count = (2u << depth) - 1;
+    // The workers grow their own deques as the tree unfolds
+    EbThreadPool *pool = create_pool(worker_count_, 1);
+    ASSERT_NE(pool, nullptr);
+    tree_.pool = pool;
+
+    TaskNode *root = (TaskNode *)calloc(1, sizeof(TaskNode));
+    ASSERT_NE(root, nullptr);
+    root->tree = &tree_;
+    root->depth = depth;
+    ASSERT_EQ(svt_thread_pool_submit(pool, tree_task, contexts_, root),
+              EB_ErrorNone);
+    for (uint32_t i = 0; i < task_count; i++)
+        svt_block_on_semaphore(tree_.done_semaphore);
+    destroy_pool(pool);
+
+    EXPECT_EQ(run_count_, (int32_t)task_count);
+    EXPECT_EQ(total_task_count(), task_count);
+}
+
+TEST_P(ThreadPoolTest, SubmissionsOutgrowTheDeques) {
+    // One blocked task per worker keeps every deque from draining
+    const uint32_t task_capacity = 2;
+    const uint32_t task_count = 1000;
+    EbThreadPool *pool = create_pool(worker_count_, task_capacity);
+    ASSERT_NE(pool, nullptr);
+    tree_.pool = pool;
+
+    EbHandle gate = svt_create_semaphore(0, ~0u >> 1);
+    auto gate_task = [](void *, void *data_ptr) {
+        svt_block_on_semaphore((EbHandle)data_ptr);
+    };
+    for (uint32_t i = 0; i < worker_count_; i++)
+        ASSERT_EQ(svt_thread_pool_submit(pool, gate_task, contexts_, gate),
+                  EB_ErrorNone);
+    TaskNode *nodes = (TaskNode *)calloc(task_count, sizeof(TaskNode));
+    ASSERT_NE(nodes, nullptr);
+    for (uint32_t i = 0; i < task_count; i++) {
+        nodes[i].tree = &tree_;
+        EXPECT_EQ(svt_thread_pool_submit(pool, count_task, contexts_, &nodes[i]),
+                  EB_ErrorNone);
+    }
+    for (uint32_t i = 0; i < worker_count_; i++)
+        svt_post_semaphore(gate);
+    for (uint32_t i = 0; i < task_count; i++)
+        svt_block_on_semaphore(tree_.done_semaphore);
+    destroy_pool(pool);
+    svt_destroy_semaphore(gate);
+
+    for (uint32_t i = 0; i < task_count; i++)
+        EXPECT_EQ(nodes[i].runs, 1) << "task " << i;
+    free(nodes);
+}
+
+INSTANTIATE_TEST_CASE_P(ThreadPool, ThreadPoolTest,
+                        ::testing::Values(1, 2, 4, 8));
+
+static EbPoolClient *create_client(EbThreadPool *pool, uint32_t priority,
+                                   uint32_t task_capacity,
+                                   uint32_t weight = POOL_WEIGHT_DEFAULT) {
+    EbPoolClient *client = (EbPoolClient *)calloc(1, sizeof(EbPoolClient));
+    if (!client)
+        return NULL;
+    if (svt_pool_client_ctor(client, pool, priority, weight, task_capacity) !=
+        EB_ErrorNone) {
+        client->dctor(client);
+        free(client);
+        return NULL;
+    }
+    return client;
+}
+
+static void destroy_client(EbPoolClient *client) {
+    client->dctor(client);
+    free(client);
+}
+
+/** Tasks of the single worker pool, logging their priority in run order */
+typedef struct PriorityLog {
+    EbHandle gate;
+    EbHandle started;
+    uint32_t count;
+    uint32_t priorities[16];
+} PriorityLog;
+
+typedef struct PriorityTask {
+    PriorityLog *log;
+    uint32_t priority;
+} PriorityTask;
+
+static void hold_task(void *, void *data_ptr) {
+    PriorityLog *log = (PriorityLog *)data_ptr;
+    svt_post_semaphore(log->started);
+    svt_block_on_semaphore(log->gate);
+}
+
+static void priority_task(void *, void *data_ptr) {
+    PriorityTask *task = (PriorityTask *)data_ptr;
+    task->log->priorities[task->log->count++] = task->priority;
+}
+
+static void log_task(void *, void *data_ptr) {
+    ((PriorityLog *)data_ptr)->count++;
+}
+
+TEST(ThreadPoolClientTest, HigherPriorityRunsFirst) {
+    const uint32_t task_count = 12;
+    EbPtr context = NULL;
+    PriorityLog log;
+    PriorityTask tasks[task_count];
+    EbPoolClient *clients[POOL_PRIORITY_COUNT];
+
+    EbThreadPool *pool = create_pool(1, 1);
+    ASSERT_NE(pool, nullptr);
+    for (uint32_t priority = 0; priority < POOL_PRIORITY_COUNT; priority++) {
+        clients[priority] = create_client(pool, priority, task_count);
+        ASSERT_NE(clients[priority], nullptr);
+    }
+    EXPECT_EQ(pool->client_count, (uint32_t)POOL_PRIORITY_COUNT);
+    EXPECT_EQ(nullptr, create_client(pool, POOL_PRIORITY_COUNT, 1));
+
+    memset(&log, 0, sizeof(log));
+    log.gate = svt_create_semaphore(0, 1);
+    log.started = svt_create_semaphore(0, 1);
+    // Queue every task while the only worker waits in the gate task
+    ASSERT_EQ(svt_pool_client_submit(clients[POOL_PRIORITY_LOW], hold_task,
+                                     &context, &log),
+              EB_ErrorNone);
+    svt_block_on_semaphore(log.started);
+    for (uint32_t i = 0; i < task_count; i++) {
+        tasks[i].log = &log;
+        tasks[i].priority = (i * 7) % POOL_PRIORITY_COUNT;
+        ASSERT_EQ(svt_pool_client_submit(clients[tasks[i].priority],
+                                         priority_task, &context, &tasks[i]),
+                  EB_ErrorNone);
+    }
+    svt_post_semaphore(log.gate);
+
+    // The destructors wait for the pending tasks of their client
+    for (uint32_t priority = 0; priority < POOL_PRIORITY_COUNT; priority++)
+        destroy_client(clients[priority]);
+    EXPECT_EQ(pool->client_count, 0u);
+    ASSERT_EQ(log.count, task_count);
+    for (uint32_t i = 1; i < task_count; i++)
+        EXPECT_GE(log.priorities[i - 1], log.priorities[i]) << "task " << i;
+    destroy_pool(pool);
+    svt_destroy_semaphore(log.gate);
+    svt_destroy_semaphore(log.started);
+}
+
+/** Tasks of equal length of the single worker pool, logging the client
+ * they belong to in run order */
+typedef struct WeightLog {
+    uint32_t count;
+    uint32_t clients[400];
+} WeightLog;
+
+typedef struct WeightTask {
+    WeightLog *log;
+    uint32_t client;
+} WeightTask;
+
+static void weight_task(void *, void *data_ptr) {
+    WeightTask *task = (WeightTask *)data_ptr;
+    uint64_t start_seconds, start_useconds, seconds, useconds;
+    svt_av1_get_time(&start_seconds, &start_useconds);
+    do {
+        svt_av1_get_time(&seconds, &useconds);
+    } while ((seconds - start_seconds) * 1000000 + useconds - start_useconds <
+             200);
+    task->log->clients[task->log->count++] = task->client;
+}
+
+TEST(ThreadPoolClientTest, BusyClientsShareByWeight) {
+    const uint32_t task_count = 200;
+    const uint32_t weights[2] = {300, 100};
+    EbPtr context = NULL;
+    PriorityLog hold;
+    WeightLog log;
+    WeightTask tasks[2][task_count];
+    EbPoolClient *clients[2];
+
+    EbThreadPool *pool = create_pool(1, 1);
+    ASSERT_NE(pool, nullptr);
+    for (uint32_t c = 0; c < 2; c++) {
+        clients[c] =
+            create_client(pool, POOL_PRIORITY_NORMAL, task_count, weights[c]);
+        ASSERT_NE(clients[c], nullptr);
+    }
+    EXPECT_EQ(nullptr, create_client(pool, POOL_PRIORITY_NORMAL, 1, 0));
+    EXPECT_EQ(nullptr, create_client(pool, POOL_PRIORITY_NORMAL, 1,
+                                     POOL_WEIGHT_MAX + 1));
+
+    memset(&hold, 0, sizeof(hold));
+    memset(&log, 0, sizeof(log));
+    hold.gate = svt_create_semaphore(0, 1);
+    hold.started = svt_create_semaphore(0, 1);
+    ASSERT_EQ(svt_thread_pool_submit(pool, hold_task, &context, &hold),
+              EB_ErrorNone);
+    svt_block_on_semaphore(hold.started);
+    for (uint32_t i = 0; i < task_count; i++) {
+        for (uint32_t c = 0; c < 2; c++) {
+            tasks[c][i].log = &log;
+            tasks[c][i].client = c;
+            ASSERT_EQ(svt_pool_client_submit(clients[c], weight_task, &context,
+                                             &tasks[c][i]),
+                      EB_ErrorNone);
+        }
+    }
+    svt_post_semaphore(hold.gate);
+    for (uint32_t c = 0; c < 2; c++)
+        destroy_client(clients[c]);
+    ASSERT_EQ(log.count, 2 * task_count);
+
+    // While both are busy, the heavier client runs 3 of every 4 tasks
+    const uint32_t window = 100;
+    uint32_t heavy_count = 0;
+    for (uint32_t i = 0; i < window; i++)
+        heavy_count += log.clients[i] == 0;
+    EXPECT_GE(heavy_count, window * 3 / 4 - window / 10);
+    EXPECT_LE(heavy_count, window * 3 / 4 + window / 10);
+    destroy_pool(pool);
+    svt_destroy_semaphore(hold.gate);
+    svt_destroy_semaphore(hold.started);
+}
+
+/** Detached clients leave their queues to the next clients */
+TEST(ThreadPoolClientTest, ClientsReuseDetachedQueues) {
+    const uint32_t task_capacity = 100;
+    const uint32_t client_count = 4;
+    EbPtr context = NULL;
+    PriorityLog log;
+    EbPoolClient *clients[client_count];
+
+    EbThreadPool *pool = create_pool(1, 1);
+    ASSERT_NE(pool, nullptr);
+    memset(&log, 0, sizeof(log));
+    for (uint32_t i = 0; i < client_count; i++) {
+        clients[i] = create_client(pool, POOL_PRIORITY_NORMAL, task_capacity);
+        ASSERT_NE(clients[i], nullptr);
+    }
+    EXPECT_EQ(pool->queue_count, 1 + client_count);
+
+    // Half of the clients leave and come back at another priority
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < client_count / 2; i++) {
+        destroy_client(clients[i]);
+        clients[i] = create_client(pool, POOL_PRIORITY_HIGH, task_capacity);
+        ASSERT_NE(clients[i], nullptr);
+    }
+    EXPECT_EQ(pool->queue_count, 1 + client_count);
+    EXPECT_EQ(pool->client_count, client_count);
+    for (uint32_t i = 0; i < client_count; i++)
+        for (uint32_t j = 0; j < task_capacity; j++)
+            if (svt_pool_client_submit(clients[i], log_task, &context,
+                                       &log) == EB_ErrorNone)
+                accepted++;
+    EXPECT_EQ(accepted, client_count * task_capacity);
+    for (uint32_t i = 0; i < client_count; i++)
+        destroy_client(clients[i]);
+    EXPECT_EQ(log.count, accepted);
+    EXPECT_EQ(pool->client_count, 0u);
+    destroy_pool(pool);
+}
+
+TEST(ThreadPoolClientTest, AttachUpToMaxQueues) {
+    EbPoolClient *clients[POOL_MAX_QUEUES];
+
+    EbThreadPool *pool = create_pool(1, 1);
+    ASSERT_NE(pool, nullptr);
+    // Queue 0 holds the tasks of svt_thread_pool_submit
+    for (uint32_t i = 1; i < POOL_MAX_QUEUES; i++) {
+        clients[i] = create_client(pool, POOL_PRIORITY_NORMAL, 1);
+        ASSERT_NE(clients[i], nullptr) << "client " << i;
+    }
+    EXPECT_EQ(nullptr, create_client(pool, POOL_PRIORITY_NORMAL, 1));
+    destroy_client(clients[1]);
+    clients[1] = create_client(pool, POOL_PRIORITY_NORMAL, 1);
+    EXPECT_NE(clients[1], nullptr);
+    for (uint32_t i = 1; i < POOL_MAX_QUEUES; i++)
+        if (clients[i])
+            destroy_client(clients[i]);
+    destroy_pool(pool);
+}
+
+/** The destructor of a client blocks until its slow tasks return */
+typedef struct SlowTask {
+    EbHandle gate;
+    volatile int32_t *done_count;
+} SlowTask;
+
+static void slow_task(void *, void *data_ptr) {
+    SlowTask *task = (SlowTask *)data_ptr;
+    svt_block_on_semaphore(task->gate);
+    svt_atomic_fetch_add_i32(task->done_count, 1);
+}
+
+static void *release_gate(void *input_ptr) {
+    SlowTask *task = (SlowTask *)input_ptr;
+    for (uint32_t i = 0; i < 64; i++) {
+        svt_yield_thread();
+        svt_post_semaphore(task->gate);
+    }
+    return NULL;
+}
+
+TEST(ThreadPoolClientTest, DestructorWaitsForPendingTasks) {
+    const uint32_t task_count = 64;
+    volatile int32_t done_count = 0;
+    EbPtr context = NULL;
+    SlowTask task;
+
+    EbThreadPool *pool = create_pool(2, 1);
+    ASSERT_NE(pool, nullptr);
+    EbPoolClient *client = create_client(pool, POOL_PRIORITY_NORMAL, task_count);
+    ASSERT_NE(client, nullptr);
+    task.gate = svt_create_semaphore(0, task_count);
+    task.done_count = &done_count;
+    for (uint32_t i = 0; i < task_count; i++)
+        ASSERT_EQ(svt_pool_client_submit(client, slow_task, &context, &task),
+                  EB_ErrorNone);
+    EbHandle thread = svt_create_thread(release_gate, &task);
+    ASSERT_NE(thread, nullptr);
+    destroy_client(client);
+    EXPECT_EQ(done_count, (int32_t)task_count);
+    svt_destroy_thread(thread);
+    destroy_pool(pool);
+    svt_destroy_semaphore(task.gate);
+}
+
+/** Fibers of a single worker pool passing a token around a ring */
+typedef struct RingFiber {
+    EbHandle wait;
+    EbHandle next;
+    EbHandle mutex;
+    uint32_t *visit_count;
+    uint32_t round_count;
+} RingFiber;
+
+static void *ring_fiber(void *input_ptr) {
+    RingFiber *fiber = (RingFiber *)input_ptr;
+    for (uint32_t i = 0; i < fiber->round_count; i++) {
+        svt_block_on_semaphore(fiber->wait);
+        svt_block_on_mutex(fiber->mutex);
+        (*fiber->visit_count)++;
+        svt_release_mutex(fiber->mutex);
+        svt_post_semaphore(fiber->next);
+    }
+    return NULL;
+}
+
+TEST(ThreadPoolClientTest, FibersBlockWithoutHoldingWorkers) {
+    const uint32_t fiber_count = 8;
+    const uint32_t round_count = 100;
+    uint32_t visit_count = 0;
+    RingFiber fibers[fiber_count];
+    EbHandle semaphores[fiber_count];
+    EbHandle handles[fiber_count];
+
+    // Every fiber blocks but one, a blocked thread would hold the worker
+    EbThreadPool *pool = create_pool(1, 1);
+    ASSERT_NE(pool, nullptr);
+    EbPoolClient *client = create_client(pool, POOL_PRIORITY_NORMAL, fiber_count);
+    ASSERT_NE(client, nullptr);
+    EbHandle mutex = svt_create_mutex();
+    for (uint32_t i = 0; i < fiber_count; i++)
+        semaphores[i] = svt_create_semaphore(0, 1);
+    for (uint32_t i = 0; i < fiber_count; i++) {
+        fibers[i].wait = semaphores[i];
+        fibers[i].next = semaphores[(i + 1) % fiber_count];
+        fibers[i].mutex = mutex;
+        fibers[i].visit_count = &visit_count;
+        fibers[i].round_count = round_count;
+        handles[i] = svt_pool_client_create_fiber(client, ring_fiber, &fibers[i]);
+        ASSERT_NE(handles[i], nullptr);
+    }
+    svt_post_semaphore(semaphores[0]);
+    for (uint32_t i = 0; i < fiber_count; i++)
+        EXPECT_EQ(svt_destroy_fiber(handles[i]), EB_ErrorNone);
+    EXPECT_EQ(visit_count, fiber_count * round_count);
+    destroy_client(client);
+    destroy_pool(pool);
+    for (uint32_t i = 0; i < fiber_count; i++)
+        svt_destroy_semaphore(semaphores[i]);
+    svt_destroy_mutex(mutex);
+}
+
+/** A pooled consumer stage over a SystemResource */
+typedef struct PoolTestObject {
+    EbDctor dctor;
+    uint64_t value;
+} PoolTestObject;
+
+static EbErrorType pool_test_object_creator(EbPtr *object_dbl_ptr,
+                                            EbPtr object_init_data_ptr) {
+    (void)object_init_data_ptr;
+    PoolTestObject *obj = (PoolTestObject *)calloc(1, sizeof(*obj));
+    if (!obj)
+        return EB_ErrorInsufficientResources;
+    *object_dbl_ptr = obj;
+    return EB_ErrorNone;
+}
+
+static void pool_test_object_destroyer(EbPtr p) {
+    free(p);
+}
+
+typedef struct StageContext {
+    uint64_t sum;
+    uint64_t count;
+} StageContext;
+
+static void stage_task(void *context_ptr, void *data_ptr) {
+    StageContext *context = (StageContext *)context_ptr;
+    EbObjectWrapper *wrapper = (EbObjectWrapper *)data_ptr;
+    context->sum += ((PoolTestObject *)wrapper->object_ptr)->value;
+    context->count++;
+    svt_release_object(wrapper);
+}
+
+typedef struct StageThread {
+    EbFifo *fifo;
+    StageContext context;
+} StageThread;
+
+static void *stage_kernel(void *input_ptr) {
+    StageThread *stage = (StageThread *)input_ptr;
+    for (;;) {
+        EbObjectWrapper *wrapper;
+        if (svt_get_full_object(stage->fifo, &wrapper) ==
+            EB_NoErrorFifoShutdown)
+            break;
+        stage_task(&stage->context, wrapper);
+    }
+    return NULL;
+}
+
+/** Posts 1..item_count through a SystemResource whose consumer stage is
+ * either attached to a pool or served by dedicated threads; returns the
+ * elapsed time in ms */
+static double run_stage(uint32_t worker_count, EbBool pooled,
+                        uint64_t item_count, uint64_t *sum,
+                        uint64_t *count) {
+    const uint32_t object_count = 64;
+    EbSystemResource *resource =
+        (EbSystemResource *)calloc(1, sizeof(EbSystemResource));
+    EXPECT_NE(resource, nullptr);
+    if (!resource)
+        return 0;
+    EXPECT_EQ(svt_system_resource_ctor(resource,
+                                       object_count,
+                                       1,
+                                       worker_count,
+                                       pool_test_object_creator,
+                                       NULL,
+                                       pool_test_object_destroyer),
+              EB_ErrorNone);
+
+    StageThread *stages = new StageThread[worker_count]();
+    EbPtr *contexts = new EbPtr[worker_count];
+    EbHandle *threads = new EbHandle[worker_count]();
+    EbThreadPool *pool = NULL;
+    for (uint32_t i = 0; i < worker_count; i++)
+        contexts[i] = &stages[i].context;
+    if (pooled) {
+        pool = create_pool(worker_count, object_count);
+        EXPECT_NE(pool, nullptr);
+        EXPECT_EQ(svt_system_resource_attach_thread_pool(
+                      resource, pool, stage_task, contexts),
+                  EB_ErrorNone);
+    } else {
+        for (uint32_t i = 0; i < worker_count; i++) {
+            stages[i].fifo =
+                svt_system_resource_get_consumer_fifo(resource, i);
+            threads[i] = svt_create_thread(stage_kernel, &stages[i]);
+        }
+    }
+
+    uint64_t start_seconds, start_useconds;
+    uint64_t finish_seconds, finish_useconds;
+    EbFifo *producer_fifo = svt_system_resource_get_producer_fifo(resource, 0);
+    svt_av1_get_time(&start_seconds, &start_useconds);
+    for (uint64_t i = 1; i <= item_count; i++) {
+        EbObjectWrapper *wrapper;
+        svt_get_empty_object(producer_fifo, &wrapper);
+        ((PoolTestObject *)wrapper->object_ptr)->value = i;
+        svt_post_full_object(wrapper);
+    }
+    // Every object back in the empty queue means every item was consumed
+    EbObjectWrapper **wrappers = new EbObjectWrapper *[object_count];
+    for (uint32_t i = 0; i < object_count; i++)
+        svt_get_empty_object(producer_fifo, &wrappers[i]);
+    for (uint32_t i = 0; i < object_count; i++)
+        svt_release_object(wrappers[i]);
+    svt_av1_get_time(&finish_seconds, &finish_useconds);
+
+    svt_shutdown_process(resource);
+    for (uint32_t i = 0; i < worker_count; i++)
+        if (threads[i])
+            svt_destroy_thread(threads[i]);
+    if (pool)
+        destroy_pool(pool);
+    *sum = *count = 0;
+    for (uint32_t i = 0; i < worker_count; i++) {
+        *sum += stages[i].context.sum;
+        *count += stages[i].context.count;
+    }
+    resource->dctor(resource);
+    free(resource);
+    delete[] wrappers;
+    delete[] threads;
+    delete[] contexts;
+    delete[] stages;
+    return svt_av1_compute_overall_elapsed_time_ms(
+        start_seconds, start_useconds, finish_seconds, finish_useconds);
+}
+
+TEST(ThreadPoolResourceTest, PooledStageConsumesEveryObject) {
+    const uint64_t item_count = 10000;
+    for (uint32_t worker_count = 1; worker_count <= 4; worker_count++) {
+        uint64_t sum, count;
+        run_stage(worker_count, EB_TRUE, item_count, &sum, &count);
+        EXPECT_EQ(count, item_count) << "workers " << worker_count;
+        EXPECT_EQ(sum, item_count * (item_count + 1) / 2)
+            << "workers " << worker_count;
+    }
+}
+
+/** A pooled stage forwarding every object to a downstream resource with a
+ * single empty object, so its tasks park until the downstream consumer
+ * releases that object */
+typedef struct ForwardContext {
+    EbFifo *output_fifo;
+    uint64_t park_count;
+} ForwardContext;
+
+static void forward_task(void *context_ptr, void *data_ptr) {
+    ForwardContext *context = (ForwardContext *)context_ptr;
+    EbObjectWrapper *wrapper = (EbObjectWrapper *)data_ptr;
+    EbObjectWrapper *output_wrapper;
+    if (!svt_get_output_object(
+            context->output_fifo, wrapper, &output_wrapper)) {
+        context->park_count++;
+        svt_park_full_object(wrapper);
+        return;
+    }
+    ((PoolTestObject *)output_wrapper->object_ptr)->value =
+        ((PoolTestObject *)wrapper->object_ptr)->value;
+    svt_post_full_object(output_wrapper);
+    svt_release_object(wrapper);
+}
+
+static void post_items(EbFifo *producer_fifo, uint64_t first,
+                       uint64_t last) {
+    for (uint64_t i = first; i <= last; i++) {
+        EbObjectWrapper *wrapper;
+        svt_get_empty_object(producer_fifo, &wrapper);
+        ((PoolTestObject *)wrapper->object_ptr)->value = i;
+        svt_post_full_object(wrapper);
+    }
+}
+
+TEST(ThreadPoolResourceTest, ParkedStageResumesOnRelease) {
+    const uint32_t worker_count = 2;
+    const uint32_t object_count = 16;
+    const uint64_t item_count = 2000;
+    EbSystemResource *input =
+        (EbSystemResource *)calloc(1, sizeof(EbSystemResource));
+    EbSystemResource *output =
+        (EbSystemResource *)calloc(1, sizeof(EbSystemResource));
+    ASSERT_NE(input, nullptr);
+    ASSERT_NE(output, nullptr);
+    ASSERT_EQ(svt_system_resource_ctor(input,
+                                       object_count,
+                                       1,
+                                       worker_count,
+                                       pool_test_object_creator,
+                                       NULL,
+                                       pool_test_object_destroyer),
+              EB_ErrorNone);
+    ASSERT_EQ(svt_system_resource_ctor(output,
+                                       1,
+                                       worker_count,
+                                       1,
+                                       pool_test_object_creator,
+                                       NULL,
+                                       pool_test_object_destroyer),
+              EB_ErrorNone);
+
+    ForwardContext forward[worker_count];
+    EbPtr contexts[worker_count];
+    for (uint32_t i = 0; i < worker_count; i++) {
+        forward[i].output_fifo =
+            svt_system_resource_get_producer_fifo(output, i);
+        forward[i].park_count = 0;
+        contexts[i] = &forward[i];
+    }
+    EbThreadPool *pool = create_pool(worker_count, object_count);
+    ASSERT_NE(pool, nullptr);
+    ASSERT_EQ(svt_system_resource_attach_thread_pool(
+                  input, pool, forward_task, contexts),
+              EB_ErrorNone);
+
+    // Without a downstream consumer yet, every task after the first one
+    // finds no output object and parks
+    EbFifo *producer_fifo = svt_system_resource_get_producer_fifo(input, 0);
+    post_items(producer_fifo, 1, object_count);
+    StageThread consumer;
+    memset(&consumer, 0, sizeof(consumer));
+    consumer.fifo = svt_system_resource_get_consumer_fifo(output, 0);
+    EbHandle thread = svt_create_thread(stage_kernel, &consumer);
+    ASSERT_NE(thread, nullptr);
+    post_items(producer_fifo, object_count + 1, item_count);
+
+    // Every object back in its empty queue means every item was forwarded
+    // and consumed, the parked ones included
+    EbObjectWrapper *wrappers[object_count];
+    for (uint32_t i = 0; i < object_count; i++)
+        svt_get_empty_object(producer_fifo, &wrappers[i]);
+    for (uint32_t i = 0; i < object_count; i++)
+        svt_release_object(wrappers[i]);
+    svt_get_empty_object(forward[0].output_fifo, &wrappers[0]);
+    svt_release_object(wrappers[0]);
+
+    svt_shutdown_process(input);
+    svt_shutdown_process(output);
+    svt_destroy_thread(thread);
+    destroy_pool(pool);
+    EXPECT_EQ(consumer.context.count, item_count);
+    EXPECT_EQ(consumer.context.sum, item_count * (item_count + 1) / 2);
+    EXPECT_GT(forward[0].park_count + forward[1].park_count, 0u);
+    input->dctor(input);
+    output->dctor(output);
+    free(input);
+    free(output);
+}
+
+TEST(ThreadPoolResourceTest, DISABLED_SpeedTest) {
+    const uint64_t item_count = 1000000;
+    for (uint32_t worker_count = 1; worker_count <= 8; worker_count *= 2) {
+        uint64_t sum, count;
+        const double threads_ms =
+            run_stage(worker_count, EB_FALSE, item_count, &sum, &count);
+        EXPECT_EQ(count, item_count);
+        const double pool_ms =
+            run_stage(worker_count, EB_TRUE, item_count, &sum, &count);
+        EXPECT_EQ(count, item_count);
+        printf("workers %u: dedicated threads %8.1f ms (%6.2f Mobj/s), "
+               "thread pool %8.1f ms (%6.2f Mobj/s)\n",
+               worker_count,
+               threads_ms,
+               item_count / threads_ms / 1000.0,
+               pool_ms,
+               item_count / pool_ms / 1000.0);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,73 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1DecMultiThreadTest.cc
+ *
+ * @brief SVT-AV1 decoder api test of multi-threaded decoding:
+ * - parsing runs ahead of the reconstruction within a few SB rows
+ * - the pictures match the ones of a single-threaded decode
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "EbSvtAv1Dec.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 3;
+// more SB rows than the coefficient rows held for 4 threads
+static const uint32_t width = 192;
+static const uint32_t height = 640;
+
+/** Encodes frame_count frames in 1 << tile_rows rows of tiles and returns the temporal units */
+static Stream encode_stream(int32_t tile_rows) {
+    TestEncoder encoder(width, height);
+    encoder.enc_params.tile_rows = tile_rows;
+    EXPECT_TRUE(encoder.init());
+    return encoder.encode_stream(frame_count, 3, 6);
+}
+
+/** @brief parse_ahead_matches_single_thread is a api test case
+ * Test strategy: <br>
+ * Decode a stream taller than the coefficient rows held, in one tile and in
+ * 4 rows of tiles, with 1, 2 and 4 threads kept off the real-time policy.
+ *
+ * Expected result: <br>
+ * Every decoder outputs the same pictures.
+ */
+TEST(DecApiMultiThreadTest, parse_ahead_matches_single_thread) {
+    NormalPriorityThreads normal_priority;
+    for (int32_t tile_rows = 0; tile_rows <= 2; tile_rows += 2) {
+        const Stream stream = encode_stream(tile_rows);
+        ASSERT_FALSE(stream.empty());
+
+        const std::vector<Picture> expected = decode_stream(stream, width, height);
+        ASSERT_EQ(frame_count, expected.size());
+        for (uint32_t threads = 2; threads <= 4; threads *= 2) {
+            const std::vector<Picture> output = decode_stream(stream, width, height, threads);
+            ASSERT_EQ(expected.size(), output.size()) << threads << " threads";
+            for (size_t i = 0; i < output.size(); i++)
+                EXPECT_TRUE(expected[i] == output[i])
+                    << "picture " << i << ", " << threads << " threads, tile rows "
+                    << (1 << tile_rows);
+        }
+    }
+}
+
+}  // namespace
@@ -0,0 +1,86 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1DecResolutionChangeTest.cc
+ *
+ * @brief SVT-AV1 decoder api test of streams changing resolution:
+ * - a new sequence header of another frame size reallocates the decoder
+ * - the pictures of every sequence match the ones of a separate decode, with
+ *   one or several threads
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "EbSvtAv1Dec.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 4;
+static const uint32_t max_width = 320;
+static const uint32_t max_height = 240;
+
+/** Encodes frame_count frames of width x height and returns the temporal units */
+static Stream encode_stream(uint32_t width, uint32_t height) {
+    TestEncoder encoder(width, height);
+    EXPECT_TRUE(encoder.init());
+    return encoder.encode_stream(frame_count, 3, 6);
+}
+
+/** @brief switch_matches_separate_decodes is a api test case
+ * Test strategy: <br>
+ * Concatenate streams of 320x240, 176x144 and 320x240 again, decode them
+ * with one decoder of 1 thread and one of 4 threads, and each of them with
+ * its own decoder. The threads are kept off the real-time policy so those of
+ * the multi-threaded decoder share the cores of any host.
+ *
+ * Expected result: <br>
+ * Every picture has the size of its sequence and matches the picture of the
+ * separate decode.
+ */
+TEST(DecApiResolutionChangeTest, switch_matches_separate_decodes) {
+    NormalPriorityThreads normal_priority;
+    const Stream large = encode_stream(max_width, max_height);
+    const Stream small = encode_stream(176, 144);
+    ASSERT_FALSE(large.empty());
+    ASSERT_FALSE(small.empty());
+
+    Stream stream(large);
+    stream.insert(stream.end(), small.begin(), small.end());
+    stream.insert(stream.end(), large.begin(), large.end());
+
+    const std::vector<Picture> large_output = decode_stream(large, max_width, max_height);
+    const std::vector<Picture> small_output = decode_stream(small, max_width, max_height);
+    ASSERT_EQ(frame_count, large_output.size());
+    ASSERT_EQ(frame_count, small_output.size());
+    EXPECT_EQ(176u, small_output[0].width);
+    EXPECT_EQ(144u, small_output[0].height);
+    std::vector<Picture> expected(large_output);
+    expected.insert(expected.end(), small_output.begin(), small_output.end());
+    expected.insert(expected.end(), large_output.begin(), large_output.end());
+
+    for (uint32_t threads = 1; threads <= 4; threads *= 4) {
+        const std::vector<Picture> output = decode_stream(stream, max_width, max_height, threads);
+        ASSERT_EQ(expected.size(), output.size()) << threads << " threads";
+        for (size_t i = 0; i < output.size(); i++)
+            EXPECT_TRUE(expected[i] == output[i])
+                << "picture " << i << ", " << threads << " threads";
+    }
+}
+
+}  // namespace
@@ -0,0 +1,143 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1DecZeroCopyTest.cc
+ *
+ * @brief SVT-AV1 decoder api test of the zero copy output mode:
+ * - parameter checks of svt_av1_dec_release_picture
+ * - held pictures stay intact while decoding goes on
+ * - the output matches the one of the copying output path
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "EbSvtAv1Dec.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 10;
+static const uint32_t max_held_pictures = 4;
+
+/** Encodes frame_count frames and returns the temporal units */
+static Stream encode_stream() {
+    TestEncoder encoder;
+    EXPECT_TRUE(encoder.init());
+    return encoder.encode_stream(frame_count, 5, 5);
+}
+
+/** Decodes the stream and returns the output pictures. With zero copy the
+ * pictures are held max_held_pictures at a time and only read on release. */
+static std::vector<Picture> decode_stream(const Stream &stream, bool zero_copy) {
+    EbComponentType *handle = nullptr;
+    EbSvtAv1DecConfiguration config;
+    EbAV1StreamInfo stream_info;
+    EbAV1FrameInfo frame_info;
+    std::vector<Picture> output;
+    std::deque<EbBufferHeaderType *> held;
+
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_init_handle(&handle, nullptr, &config));
+    config.max_picture_width = test_width;
+    config.max_picture_height = test_height;
+    config.zero_copy_output = zero_copy ? EB_TRUE : EB_FALSE;
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_set_parameter(handle, &config));
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_init(handle));
+
+    for (size_t i = 0; i < stream.size(); i++) {
+        EXPECT_EQ(EB_ErrorNone,
+                  svt_av1_dec_frame(handle, stream[i].data(), stream[i].size(), 0));
+
+        EbBufferHeaderType *header = new EbBufferHeaderType;
+        EbSvtIOFormat *img = new EbSvtIOFormat;
+        memset(header, 0, sizeof(*header));
+        memset(img, 0, sizeof(*img));
+        header->p_buffer = (uint8_t *)img;
+        if (svt_av1_dec_get_picture(handle, header, &stream_info, &frame_info) == EB_ErrorNone) {
+            if (zero_copy) {
+                EXPECT_NE(nullptr, header->wrapper_ptr);
+                held.push_back(header);
+                header = nullptr;
+            } else
+                output.push_back(read_picture(img));
+        }
+        if (header) {
+            free(img->luma);
+            free(img->cb);
+            free(img->cr);
+            delete img;
+            delete header;
+        }
+
+        // Release the oldest picture once the decoder holds the maximum
+        while (held.size() >= max_held_pictures || (i + 1 == stream.size() && !held.empty())) {
+            EbBufferHeaderType *oldest = held.front();
+            EbSvtIOFormat *oldest_img = (EbSvtIOFormat *)oldest->p_buffer;
+            held.pop_front();
+            output.push_back(read_picture(oldest_img));
+            EXPECT_EQ(EB_ErrorNone, svt_av1_dec_release_picture(handle, oldest));
+            EXPECT_EQ(nullptr, oldest->wrapper_ptr);
+            EXPECT_EQ(nullptr, oldest_img->luma);
+            delete oldest_img;
+            delete oldest;
+        }
+    }
+
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_deinit(handle));
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_deinit_handle(handle));
+    return output;
+}
+
+/** @brief release_picture_check is a api test case
+ * Null handles and headers without a zero copy picture are rejected. */
+TEST(DecApiZeroCopyTest, release_picture_check) {
+    EbComponentType *handle = nullptr;
+    EbSvtAv1DecConfiguration config;
+    EbBufferHeaderType header;
+    memset(&header, 0, sizeof(header));
+
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_dec_release_picture(nullptr, &header));
+    ASSERT_EQ(EB_ErrorNone, svt_av1_dec_init_handle(&handle, nullptr, &config));
+    EXPECT_EQ(EB_FALSE, config.zero_copy_output);
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_dec_release_picture(handle, nullptr));
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_dec_release_picture(handle, &header));
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_deinit_handle(handle));
+}
+
+/** @brief zero_copy_matches_copy is a api test case
+ * Test strategy: <br>
+ * Decode the same stream with copied output and with zero copy output,
+ * holding the zero copy pictures while the following frames are decoded.
+ *
+ * Expected result: <br>
+ * Both decoders output the same pictures.
+ */
+TEST(DecApiZeroCopyTest, zero_copy_matches_copy) {
+    const Stream stream = encode_stream();
+    ASSERT_FALSE(stream.empty());
+
+    const std::vector<Picture> copy_output = decode_stream(stream, false);
+    const std::vector<Picture> zero_copy_output = decode_stream(stream, true);
+
+    EXPECT_EQ(frame_count, copy_output.size());
+    ASSERT_EQ(copy_output.size(), zero_copy_output.size());
+    for (size_t i = 0; i < copy_output.size(); i++)
+        EXPECT_TRUE(copy_output[i] == zero_copy_output[i]) << "picture " << i;
+}
+
+}  // namespace
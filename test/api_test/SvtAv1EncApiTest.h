@@ -17,6 +17,9 @@
  * @author Cidana-Edmond
  *
  ******************************************************************************/
+#ifndef _SVT_AV1_ENC_API_TEST_H_
+#define _SVT_AV1_ENC_API_TEST_H_
+
 #include "EbSvtAv1Enc.h"
 #include "gtest/gtest.h"
 
@@ -36,3 +39,5 @@ typedef struct {
 }  // namespace svt_av1_test
 
 /** @} */  // end of svt_av1_test
+
+#endif  // _SVT_AV1_ENC_API_TEST_H_
@@ -0,0 +1,217 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncApiTestUtil.cc
+ *
+ * @brief Helpers shared by the api tests that encode or decode pictures
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <linux/capability.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+namespace svt_av1_test {
+
+void fill_frame(std::vector<uint8_t> &frame, uint32_t width, uint32_t index, uint32_t step,
+                uint32_t period) {
+    for (uint32_t j = 0; j < frame.size(); j++)
+        frame[j] = (uint8_t)((j % width + step * index) * (j / width % period + 1));
+}
+
+void send_frame(EbComponentType *handle, std::vector<uint8_t> &frame, uint32_t width,
+                uint32_t height, int64_t pts) {
+    EbSvtIOFormat input;
+    EbBufferHeaderType header;
+    memset(&input, 0, sizeof(input));
+    input.luma = frame.data();
+    input.cb = input.luma + width * height;
+    input.cr = input.cb + width * height / 4;
+    input.y_stride = width;
+    input.cb_stride = width / 2;
+    input.cr_stride = width / 2;
+    memset(&header, 0, sizeof(header));
+    header.size = sizeof(header);
+    header.p_buffer = (uint8_t *)&input;
+    header.n_filled_len = (uint32_t)frame.size();
+    header.pts = pts;
+    header.pic_type = EB_AV1_INVALID_PICTURE;
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_send_picture(handle, &header));
+}
+
+void send_eos(EbComponentType *handle) {
+    EbBufferHeaderType eos;
+    memset(&eos, 0, sizeof(eos));
+    eos.flags = EB_BUFFERFLAG_EOS;
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_send_picture(handle, &eos));
+}
+
+bool drain_packets(EbComponentType *handle, uint8_t pic_send_done, const PacketHandler &handler) {
+    for (;;) {
+        EbBufferHeaderType *packet = nullptr;
+        if (svt_av1_enc_get_packet(handle, &packet, pic_send_done) != EB_ErrorNone)
+            return false;
+        const bool last = !!(packet->flags & EB_BUFFERFLAG_EOS);
+        if (handler)
+            handler(packet);
+        svt_av1_enc_release_out_buffer(&packet);
+        if (last)
+            return true;
+    }
+}
+
+Picture read_picture(const EbSvtIOFormat *img) {
+    Picture picture;
+    picture.width = img->width;
+    picture.height = img->height;
+    for (uint32_t y = 0; y < img->height; y++)
+        picture.data.insert(picture.data.end(),
+                            img->luma + y * img->y_stride,
+                            img->luma + y * img->y_stride + img->width);
+    for (uint32_t y = 0; y < (img->height + 1) / 2; y++) {
+        picture.data.insert(picture.data.end(),
+                            img->cb + y * img->cb_stride,
+                            img->cb + y * img->cb_stride + (img->width + 1) / 2);
+        picture.data.insert(picture.data.end(),
+                            img->cr + y * img->cr_stride,
+                            img->cr + y * img->cr_stride + (img->width + 1) / 2);
+    }
+    return picture;
+}
+
+std::vector<Picture> decode_stream(const Stream &stream, uint32_t max_width, uint32_t max_height,
+                                   uint32_t threads) {
+    EbComponentType *handle = nullptr;
+    EbSvtAv1DecConfiguration config;
+    EbAV1StreamInfo stream_info;
+    EbAV1FrameInfo frame_info;
+    std::vector<Picture> output;
+
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_init_handle(&handle, nullptr, &config));
+    config.max_picture_width = max_width;
+    config.max_picture_height = max_height;
+    config.threads = threads;
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_set_parameter(handle, &config));
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_init(handle));
+
+    for (size_t i = 0; i < stream.size(); i++) {
+        EXPECT_EQ(EB_ErrorNone,
+                  svt_av1_dec_frame(handle, stream[i].data(), stream[i].size(), 0));
+
+        EbBufferHeaderType header;
+        EbSvtIOFormat img;
+        memset(&header, 0, sizeof(header));
+        memset(&img, 0, sizeof(img));
+        header.p_buffer = (uint8_t *)&img;
+        if (svt_av1_dec_get_picture(handle, &header, &stream_info, &frame_info) == EB_ErrorNone)
+            output.push_back(read_picture(&img));
+        free(img.luma);
+        free(img.cb);
+        free(img.cr);
+    }
+
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_deinit(handle));
+    EXPECT_EQ(EB_ErrorNone, svt_av1_dec_deinit_handle(handle));
+    return output;
+}
+
+#ifdef __linux__
+/** Sets CAP_SYS_NICE in the effective set of the calling thread, which the
+ * threads it creates inherit, returns whether it was set before */
+static bool set_sys_nice(bool effective) {
+    struct __user_cap_header_struct header;
+    struct __user_cap_data_struct data[_LINUX_CAPABILITY_U32S_3];
+    memset(&header, 0, sizeof(header));
+    memset(data, 0, sizeof(data));
+    header.version = _LINUX_CAPABILITY_VERSION_3;
+    if (syscall(SYS_capget, &header, data))
+        return false;
+    const uint32_t bit = CAP_TO_MASK(CAP_SYS_NICE);
+    const bool was_effective = !!(data[CAP_TO_INDEX(CAP_SYS_NICE)].effective & bit);
+    if (effective)
+        data[CAP_TO_INDEX(CAP_SYS_NICE)].effective |= bit;
+    else
+        data[CAP_TO_INDEX(CAP_SYS_NICE)].effective &= ~bit;
+    if (effective != was_effective) {
+        EXPECT_EQ(0, syscall(SYS_capset, &header, data));
+    }
+    return was_effective;
+}
+
+NormalPriorityThreads::NormalPriorityThreads() : lowered_(set_sys_nice(false)) {}
+
+NormalPriorityThreads::~NormalPriorityThreads() {
+    if (lowered_) {
+        set_sys_nice(true);
+    }
+}
+#else
+NormalPriorityThreads::NormalPriorityThreads() : lowered_(false) {}
+
+NormalPriorityThreads::~NormalPriorityThreads() {}
+#endif
+
+TestEncoder::TestEncoder(uint32_t width, uint32_t height) : initialized_(false) {
+    memset(static_cast<SvtAv1Context *>(this), 0, sizeof(SvtAv1Context));
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_init_handle(&enc_handle, this, &enc_params));
+    enc_params.source_width = width;
+    enc_params.source_height = height;
+    enc_params.enc_mode = 8;
+    enc_params.logical_processors = 1;
+}
+
+TestEncoder::~TestEncoder() {
+    if (initialized_) {
+        EXPECT_EQ(EB_ErrorNone, svt_av1_enc_deinit(enc_handle));
+    }
+    if (enc_handle) {
+        EXPECT_EQ(EB_ErrorNone, svt_av1_enc_deinit_handle(enc_handle));
+    }
+}
+
+EbErrorType TestEncoder::set_parameter() {
+    return svt_av1_enc_set_parameter(enc_handle, &enc_params);
+}
+
+bool TestEncoder::init() {
+    EXPECT_EQ(EB_ErrorNone, set_parameter());
+    initialized_ = svt_av1_enc_init(enc_handle) == EB_ErrorNone;
+    EXPECT_TRUE(initialized_);
+    return initialized_;
+}
+
+void TestEncoder::send_frame(uint32_t index, uint32_t step, uint32_t period) {
+    frame_.resize(enc_params.source_width * enc_params.source_height * 3 / 2);
+    fill_frame(frame_, enc_params.source_width, index, step, period);
+    svt_av1_test::send_frame(
+        enc_handle, frame_, enc_params.source_width, enc_params.source_height, index);
+}
+
+Stream TestEncoder::encode_stream(uint32_t frame_count, uint32_t step, uint32_t period) {
+    Stream stream;
+    for (uint32_t i = 0; i < frame_count; i++)
+        send_frame(i, step, period);
+    send_eos(enc_handle);
+    drain_packets(enc_handle, 1, [&](const EbBufferHeaderType *packet) {
+        if (packet->n_filled_len)
+            stream.push_back(
+                std::vector<uint8_t>(packet->p_buffer, packet->p_buffer + packet->n_filled_len));
+    });
+    return stream;
+}
+
+}  // namespace svt_av1_test
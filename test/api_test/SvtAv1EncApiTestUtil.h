@@ -0,0 +1,130 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncApiTestUtil.h
+ *
+ * @brief Helpers shared by the api tests that encode pictures:
+ * - fill a packed 8-bit 4:2:0 picture with a moving pattern
+ * - send it, or the end of sequence, to an encoder
+ * - read the packets up to the end of sequence
+ * - an encoder set up for small pictures, destroyed with its scope
+ * - encode a stream into temporal units, decode it and copy the pictures
+ * - keep the codec threads off the real-time scheduling policy
+ *
+ ******************************************************************************/
+#ifndef _SVT_AV1_ENC_API_TEST_UTIL_H_
+#define _SVT_AV1_ENC_API_TEST_UTIL_H_
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "EbSvtAv1Dec.h"
+#include "SvtAv1EncApiTest.h"
+
+namespace svt_av1_test {
+
+/** Called on every packet read, before it is released */
+typedef std::function<void(const EbBufferHeaderType *packet)> PacketHandler;
+
+/** Fills frame, a packed picture width samples wide, with a pattern moving
+ * by step samples per index and repeating every period rows */
+void fill_frame(std::vector<uint8_t> &frame, uint32_t width, uint32_t index, uint32_t step,
+                uint32_t period);
+
+/** Sends frame, a packed width x height 8-bit 4:2:0 picture, as picture pts */
+void send_frame(EbComponentType *handle, std::vector<uint8_t> &frame, uint32_t width,
+                uint32_t height, int64_t pts);
+
+/** Sends the end of sequence */
+void send_eos(EbComponentType *handle);
+
+/** Reads and releases the packets up to the end of sequence, or until none is
+ * ready when pic_send_done is 0, passing each one to handler. Returns whether
+ * the end of sequence was read */
+bool drain_packets(EbComponentType *handle, uint8_t pic_send_done,
+                   const PacketHandler &handler = PacketHandler());
+
+/** Temporal units of an encoded stream */
+typedef std::vector<std::vector<uint8_t>> Stream;
+
+/** Visible area of a decoded 8-bit 4:2:0 picture, packed */
+struct Picture {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> data;
+
+    bool operator==(const Picture &other) const {
+        return width == other.width && height == other.height && data == other.data;
+    }
+};
+
+/** Copies the visible area of an 8-bit 4:2:0 output picture */
+Picture read_picture(const EbSvtIOFormat *img);
+
+/** Decodes the stream with a decoder of threads threads for pictures up to
+ * max_width x max_height, returns the output pictures */
+std::vector<Picture> decode_stream(const Stream &stream, uint32_t max_width, uint32_t max_height,
+                                   uint32_t threads = 1);
+
+/** Keeps the threads created in its scope on the default scheduling policy.
+ * svt_create_thread asks for SCHED_FIFO, which a process with CAP_SYS_NICE
+ * gets; the threads spinning on each other then starve on a host with fewer
+ * cores than threads. The capability is lowered for the scope on Linux. */
+class NormalPriorityThreads {
+  public:
+    NormalPriorityThreads();
+    ~NormalPriorityThreads();
+
+  private:
+    NormalPriorityThreads(const NormalPriorityThreads &);
+    NormalPriorityThreads &operator=(const NormalPriorityThreads &);
+
+    bool lowered_;
+};
+
+/** Size of the pictures of most api tests */
+static const uint32_t test_width = 176;
+static const uint32_t test_height = 144;
+
+/** Encoder of an api test. The handle is created with the default parameters
+ * set up for width x height pictures at preset 8 on one logical processor;
+ * the test changes enc_params before set_parameter or init. The encoder is
+ * deinitialized and its handle destroyed with the object. */
+class TestEncoder : public SvtAv1Context {
+  public:
+    TestEncoder(uint32_t width = test_width, uint32_t height = test_height);
+    ~TestEncoder();
+
+    /** Passes enc_params to the encoder */
+    EbErrorType set_parameter();
+    /** Passes enc_params to the encoder and initializes it, returns whether
+     * both succeeded */
+    bool init();
+    /** Sends picture index of the size of enc_params, filled by fill_frame
+     * with step and period */
+    void send_frame(uint32_t index, uint32_t step, uint32_t period);
+    /** Sends frame_count pictures of send_frame and the end of sequence,
+     * returns the temporal units read up to the end of sequence */
+    Stream encode_stream(uint32_t frame_count, uint32_t step, uint32_t period);
+
+  private:
+    TestEncoder(const TestEncoder &);
+    TestEncoder &operator=(const TestEncoder &);
+
+    bool initialized_;
+    std::vector<uint8_t> frame_;
+};
+
+}  // namespace svt_av1_test
+
+#endif  // _SVT_AV1_ENC_API_TEST_UTIL_H_
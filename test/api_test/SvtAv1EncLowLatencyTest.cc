@@ -0,0 +1,121 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncLowLatencyTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of the low-latency mode:
+ * - parameter checks of max_frames_in_flight
+ * - the packet of a picture comes out before the next picture is sent
+ * - the end of sequence follows the last packet
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 10;
+
+/** Creates the encoder of the tests with one picture in flight */
+static void setup_encoder(TestEncoder &encoder) {
+    EXPECT_EQ(0u, encoder.enc_params.max_frames_in_flight);
+    encoder.enc_params.max_frames_in_flight = 1;
+}
+
+/** @brief invalid_settings_check is a api test case
+ * The mode is only available in single pass CQP without recon output nor
+ * manual prediction structure. */
+TEST(EncApiLowLatencyTest, invalid_settings_check) {
+    TestEncoder encoder;
+    setup_encoder(encoder);
+    encoder.enc_params.rate_control_mode = 1;
+    EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+    encoder.enc_params.rate_control_mode = 0;
+    encoder.enc_params.recon_enabled = 1;
+    EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+    encoder.enc_params.recon_enabled = 0;
+    encoder.enc_params.rc_firstpass_stats_out = EB_TRUE;
+    EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+    encoder.enc_params.rc_firstpass_stats_out = EB_FALSE;
+    encoder.enc_params.enable_manual_pred_struct = EB_TRUE;
+    EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+    encoder.enc_params.enable_manual_pred_struct = EB_FALSE;
+    EXPECT_EQ(EB_ErrorNone, encoder.set_parameter());
+}
+
+/** @brief packet_per_picture is a api test case
+ * Test strategy: <br>
+ * Send one picture at a time and wait for its packet before sending the next
+ * one, then send the end of sequence.
+ *
+ * Expected result: <br>
+ * Every picture gets its own packet in display order and the end of sequence
+ * comes with an empty packet.
+ */
+TEST(EncApiLowLatencyTest, packet_per_picture) {
+    TestEncoder encoder;
+    setup_encoder(encoder);
+    ASSERT_TRUE(encoder.init());
+
+    for (uint32_t i = 0; i < frame_count; i++) {
+        encoder.send_frame(i, 5, 3);
+        EbBufferHeaderType *packet = nullptr;
+        ASSERT_EQ(EB_ErrorNone, svt_av1_enc_get_packet(encoder.enc_handle, &packet, 1));
+        EXPECT_EQ((int64_t)i, packet->pts);
+        EXPECT_GT(packet->n_filled_len, 0u);
+        EXPECT_EQ(0u, packet->flags & (EB_BUFFERFLAG_EOS | EB_BUFFERFLAG_IS_ALT_REF));
+        svt_av1_enc_release_out_buffer(&packet);
+    }
+
+    send_eos(encoder.enc_handle);
+    EbBufferHeaderType *packet = nullptr;
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_get_packet(encoder.enc_handle, &packet, 1));
+    EXPECT_EQ((uint32_t)EB_BUFFERFLAG_EOS, packet->flags & EB_BUFFERFLAG_EOS);
+    EXPECT_EQ(0u, packet->n_filled_len);
+    svt_av1_enc_release_out_buffer(&packet);
+}
+
+/** @brief eos_after_last_packet is a api test case
+ * Test strategy: <br>
+ * Send every picture and the end of sequence before reading the packets.
+ *
+ * Expected result: <br>
+ * One packet per picture, the end of sequence being on the last one or on an
+ * empty packet after it.
+ */
+TEST(EncApiLowLatencyTest, eos_after_last_packet) {
+    TestEncoder encoder;
+    setup_encoder(encoder);
+    ASSERT_TRUE(encoder.init());
+
+    for (uint32_t i = 0; i < frame_count; i++)
+        encoder.send_frame(i, 5, 3);
+    send_eos(encoder.enc_handle);
+
+    uint32_t packet_count = 0;
+    EXPECT_TRUE(drain_packets(encoder.enc_handle, 1, [&](const EbBufferHeaderType *packet) {
+        if (packet->n_filled_len) {
+            EXPECT_EQ((int64_t)packet_count, packet->pts);
+            packet_count++;
+        }
+    }));
+    EXPECT_EQ(frame_count, packet_count);
+}
+
+}  // namespace
@@ -0,0 +1,144 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncMemoryBudgetTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of the memory budget:
+ * - the pool memory is reported after svt_av1_enc_init
+ * - a budget never grows a pool beyond its count without budget, and a small
+ *   one keeps some pools at their minimum count
+ * - the peak use of the pools follows the encode, which completes under the
+ *   small budget
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 8;
+// The pools are sized for the workers of the thread pool, more workers than
+// the minimum counts need whatever the cores of the machine
+static const uint32_t worker_count = 8;
+
+/** Sets the encoder of the tests to size its pools for the thread pool */
+static void setup_encoder(TestEncoder &encoder, uint32_t memory_budget, EbSvtAv1ThreadPool *pool) {
+    EXPECT_EQ(0u, encoder.enc_params.memory_budget);
+    encoder.enc_params.logical_processors = 0;
+    encoder.enc_params.memory_budget = memory_budget;
+    encoder.enc_params.thread_pool = pool;
+}
+
+static void get_memory_usage(TestEncoder &encoder, SvtAv1MemoryUsage *usage) {
+    ASSERT_EQ(EB_ErrorNone,
+              svt_av1_enc_get_stream_info(
+                  encoder.enc_handle, SVT_AV1_STREAM_INFO_MEMORY_USAGE, usage));
+    ASSERT_GT(usage->pool_count, 0u);
+    EXPECT_GT(usage->init_bytes, 0u);
+    for (uint32_t i = 0; i < usage->pool_count; i++) {
+        const SvtAv1PoolMemory &pool = usage->pools[i];
+        ASSERT_NE(nullptr, pool.name);
+        EXPECT_GT(pool.object_count, 0u) << pool.name;
+        EXPECT_LE(pool.peak_in_use, pool.object_count) << pool.name;
+        EXPECT_GT(pool.object_bytes, 0u) << pool.name;
+    }
+}
+
+/** @brief pools_within_default_counts is a api test case
+ * Test strategy: <br>
+ * Initialize an encoder without budget and one with a budget of 1 MB, below
+ * what the minimum pools need, both on a pool of worker_count threads.
+ *
+ * Expected result: <br>
+ * The same pools are reported, none of the budgeted ones is larger than
+ * without budget and some are smaller, and the budget is reported in bytes.
+ */
+TEST(EncApiMemoryBudgetTest, pools_within_default_counts) {
+    SvtAv1MemoryUsage unbudgeted, budgeted;
+    EbSvtAv1ThreadPool *pool = nullptr;
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_create_thread_pool(&pool, worker_count));
+
+    {
+        TestEncoder encoder;
+        setup_encoder(encoder, 0, pool);
+        ASSERT_TRUE(encoder.init());
+        get_memory_usage(encoder, &unbudgeted);
+        EXPECT_EQ(0u, unbudgeted.budget_bytes);
+    }
+    {
+        TestEncoder encoder;
+        setup_encoder(encoder, 1, pool);
+        ASSERT_TRUE(encoder.init());
+        get_memory_usage(encoder, &budgeted);
+        EXPECT_EQ(1u << 20, budgeted.budget_bytes);
+    }
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_destroy_thread_pool(pool));
+
+    ASSERT_EQ(unbudgeted.pool_count, budgeted.pool_count);
+    uint32_t smaller_pools = 0;
+    for (uint32_t i = 0; i < budgeted.pool_count; i++) {
+        EXPECT_STREQ(unbudgeted.pools[i].name, budgeted.pools[i].name);
+        EXPECT_LE(budgeted.pools[i].object_count, unbudgeted.pools[i].object_count)
+            << budgeted.pools[i].name;
+        EXPECT_EQ(unbudgeted.pools[i].object_bytes, budgeted.pools[i].object_bytes)
+            << budgeted.pools[i].name;
+        smaller_pools += budgeted.pools[i].object_count < unbudgeted.pools[i].object_count;
+    }
+    EXPECT_GT(smaller_pools, 0u);
+}
+
+/** @brief peak_use_after_encode is a api test case
+ * Test strategy: <br>
+ * Encode a few pictures under the budget of 1 MB that keeps pools at their
+ * minimum count, and read the memory usage once the end of sequence is out.
+ *
+ * Expected result: <br>
+ * Every picture is coded, and pictures were taken from the input and
+ * reference pools.
+ */
+TEST(EncApiMemoryBudgetTest, peak_use_after_encode) {
+    SvtAv1MemoryUsage usage;
+    EbSvtAv1ThreadPool *pool = nullptr;
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_create_thread_pool(&pool, worker_count));
+    {
+        TestEncoder encoder;
+        setup_encoder(encoder, 1, pool);
+        ASSERT_TRUE(encoder.init());
+
+        for (uint32_t i = 0; i < frame_count; i++)
+            encoder.send_frame(i, 7, 3);
+        send_eos(encoder.enc_handle);
+
+        uint32_t coded_count = 0;
+        EXPECT_TRUE(drain_packets(encoder.enc_handle, 1, [&](const EbBufferHeaderType *packet) {
+            coded_count += packet->n_filled_len > 0;
+        }));
+        EXPECT_GE(coded_count, frame_count);
+
+        get_memory_usage(encoder, &usage);
+        for (uint32_t i = 0; i < usage.pool_count; i++) {
+            if (!strcmp(usage.pools[i].name, "input") || !strcmp(usage.pools[i].name, "reference")) {
+                EXPECT_GT(usage.pools[i].peak_in_use, 0u) << usage.pools[i].name;
+            }
+        }
+    }
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_destroy_thread_pool(pool));
+}
+
+}  // namespace
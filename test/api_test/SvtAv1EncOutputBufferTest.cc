@@ -0,0 +1,104 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncOutputBufferTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of svt_av1_enc_add_output_buffer:
+ * - parameter checks
+ * - packets are written to the registered buffers when they fit
+ * - the bitstream matches the one written to encoder memory
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 12;
+
+/** Encodes frame_count frames and returns the concatenated packets. The
+ * packets written to one of the buffer_count buffers of buffer_size bytes are
+ * counted in pool_packets. */
+static std::vector<uint8_t> encode(uint32_t buffer_count, uint32_t buffer_size,
+                                   uint32_t *pool_packets) {
+    TestEncoder encoder;
+    std::vector<uint8_t> bitstream;
+    std::vector<std::vector<uint8_t>> pool(buffer_count, std::vector<uint8_t>(buffer_size));
+
+    EXPECT_TRUE(encoder.init());
+    for (uint32_t i = 0; i < buffer_count; i++)
+        EXPECT_EQ(EB_ErrorNone,
+                  svt_av1_enc_add_output_buffer(encoder.enc_handle, pool[i].data(), buffer_size));
+
+    *pool_packets = 0;
+    const PacketHandler handler = [&](const EbBufferHeaderType *packet) {
+        for (uint32_t j = 0; j < buffer_count; j++)
+            if (packet->p_buffer == pool[j].data())
+                (*pool_packets)++;
+        bitstream.insert(bitstream.end(), packet->p_buffer, packet->p_buffer + packet->n_filled_len);
+    };
+    for (uint32_t i = 0; i <= frame_count; i++) {
+        if (i < frame_count)
+            encoder.send_frame(i, 3, 7);
+        else
+            send_eos(encoder.enc_handle);
+        // Drain what is ready, the pool buffers come back on release
+        drain_packets(encoder.enc_handle, i == frame_count, handler);
+    }
+    return bitstream;
+}
+
+/** @brief add_output_buffer_check is a api test case
+ * Null handles, null buffers and empty buffers are rejected. */
+TEST(EncApiOutputBufferTest, add_output_buffer_check) {
+    uint8_t buffer[16];
+
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_add_output_buffer(nullptr, buffer, 16));
+    TestEncoder encoder;
+    EXPECT_EQ(EB_ErrorBadParameter,
+              svt_av1_enc_add_output_buffer(encoder.enc_handle, nullptr, 16));
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_add_output_buffer(encoder.enc_handle, buffer, 0));
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_add_output_buffer(encoder.enc_handle, buffer, 16));
+}
+
+/** @brief output_buffer_matches_internal is a api test case
+ * Test strategy: <br>
+ * Encode the same frames into encoder memory, into two large application
+ * buffers, and into application buffers too small for most packets.
+ *
+ * Expected result: <br>
+ * All bitstreams are identical; with large buffers every packet is written
+ * to one of them, with small buffers the encoder falls back to its memory.
+ */
+TEST(EncApiOutputBufferTest, output_buffer_matches_internal) {
+    uint32_t pool_packets;
+
+    const std::vector<uint8_t> internal_stream = encode(0, 0, &pool_packets);
+    EXPECT_EQ(0u, pool_packets);
+    ASSERT_FALSE(internal_stream.empty());
+
+    const std::vector<uint8_t> pool_stream = encode(2, 1 << 20, &pool_packets);
+    EXPECT_EQ(internal_stream, pool_stream);
+    EXPECT_GE(pool_packets, frame_count);
+
+    const std::vector<uint8_t> small_pool_stream = encode(2, 8, &pool_packets);
+    EXPECT_EQ(internal_stream, small_pool_stream);
+}
+
+}  // namespace
@@ -0,0 +1,164 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncPipelineStatsTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of the pipeline stats:
+ * - the stream info ids are rejected unless enable_pipeline_stats is set
+ * - every stage sees the encoded pictures
+ * - the temporal filtering latencies add up
+ * - the trace is a Chrome trace event JSON object, the slices of a picture
+ *   bound by a flow keyed on its picture number
+ * - a disabled benchmark of the temporal filtering overlap, run with
+ *   --gtest_also_run_disabled_tests on a multi-core machine
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 8;
+
+/** Encodes frame_count frames and checks the pipeline stats before deinit */
+static void encode_and_check(bool enable_stats) {
+    TestEncoder encoder;
+    EXPECT_EQ(EB_FALSE, encoder.enc_params.enable_pipeline_stats);
+    encoder.enc_params.enable_pipeline_stats = enable_stats ? EB_TRUE : EB_FALSE;
+    ASSERT_TRUE(encoder.init());
+    encoder.encode_stream(frame_count, 7, 3);
+
+    SvtAv1PipelineStats *stats = new SvtAv1PipelineStats;
+    SvtAv1FixedBuf trace;
+    if (!enable_stats) {
+        EXPECT_EQ(EB_ErrorBadParameter,
+                  svt_av1_enc_get_stream_info(
+                      encoder.enc_handle, SVT_AV1_STREAM_INFO_PIPELINE_STATS, stats));
+        EXPECT_EQ(EB_ErrorBadParameter,
+                  svt_av1_enc_get_stream_info(
+                      encoder.enc_handle, SVT_AV1_STREAM_INFO_PIPELINE_TRACE, &trace));
+    } else {
+        ASSERT_EQ(EB_ErrorNone,
+                  svt_av1_enc_get_stream_info(
+                      encoder.enc_handle, SVT_AV1_STREAM_INFO_PIPELINE_STATS, stats));
+        EXPECT_GT(stats->elapsed_time, 0u);
+        ASSERT_GT(stats->stage_count, 0u);
+        EXPECT_STREQ("resource_coordination", stats->stages[0].name);
+        EXPECT_STREQ("packetization", stats->stages[stats->stage_count - 1].name);
+        for (uint32_t i = 0; i < stats->stage_count; i++) {
+            const SvtAv1StageStats *stage = &stats->stages[i];
+            EXPECT_GE(stage->object_count, frame_count) << stage->name;
+            EXPECT_GE(stage->queue_time_total, stage->queue_time_max) << stage->name;
+            EXPECT_GE(stage->queue_depth_max, 1u) << stage->name;
+            EXPECT_GE(stage->thread_count, 1u) << stage->name;
+        }
+        EXPECT_GE(stats->tf_latency_total, stats->tf_latency_max);
+        if (stats->tf_picture_count == 0) {
+            EXPECT_EQ(0u, stats->tf_wait_time);
+        }
+
+        ASSERT_EQ(EB_ErrorNone,
+                  svt_av1_enc_get_stream_info(
+                      encoder.enc_handle, SVT_AV1_STREAM_INFO_PIPELINE_TRACE, &trace));
+        ASSERT_NE(nullptr, trace.buf);
+        const std::string json((const char *)trace.buf, (size_t)trace.sz);
+        EXPECT_EQ(0u, json.find("{\"displayTimeUnit\""));
+        EXPECT_NE(std::string::npos, json.find("\"name\":\"enc_dec\""));
+        // The picture numbers are below 10, the same in decimal and hex
+        const std::string last_picture = std::to_string(frame_count - 1);
+        EXPECT_NE(std::string::npos,
+                  json.find("\"bind_id\":\"0x" + last_picture +
+                            "\",\"flow_in\":true,\"flow_out\":true"));
+        EXPECT_NE(std::string::npos, json.find("\"picture\":" + last_picture + ","));
+        EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+    }
+    delete stats;
+}
+
+/** @brief stats_disabled_check is a api test case
+ * The pipeline stream info ids are rejected by default. */
+TEST(EncApiPipelineStatsTest, stats_disabled_check) {
+    encode_and_check(false);
+}
+
+/** @brief stats_cover_every_stage is a api test case
+ * Test strategy: <br>
+ * Encode a few frames with enable_pipeline_stats and read the stats and the
+ * trace once the last packet is out.
+ *
+ * Expected result: <br>
+ * Every stage dequeued at least one object per frame and the trace is a
+ * complete JSON object.
+ */
+TEST(EncApiPipelineStatsTest, stats_cover_every_stage) {
+    encode_and_check(true);
+}
+
+/** @brief DISABLED_tf_overlap_speed is a benchmark of the temporal filtering
+ * overlap, which releases a mini-GOP to motion estimation when its filtering
+ * is done instead of blocking picture decision.
+ * Test strategy: <br>
+ * Encode the same frames with temporal filtering for 1, 2, 4, ... logical
+ * processors up to the cores of the machine and print the frame rate, the
+ * filtering latency and the time picture decision waited for the filtering.
+ *
+ * Expected result: <br>
+ * The frame rate grows with the processors while the wait stays a small part
+ * of the elapsed time.
+ */
+TEST(EncApiPipelineStatsTest, DISABLED_tf_overlap_speed) {
+    const uint32_t speed_frame_count = 32;
+    const uint32_t core_count = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t processors = 1;; processors = std::min(processors * 2, core_count)) {
+        TestEncoder encoder(352, 288);
+        encoder.enc_params.enc_mode = 4;
+        encoder.enc_params.logical_processors = processors;
+        encoder.enc_params.enable_pipeline_stats = EB_TRUE;
+        ASSERT_TRUE(encoder.init());
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        encoder.encode_stream(speed_frame_count, 7, 3);
+        const double elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        SvtAv1PipelineStats stats;
+        ASSERT_EQ(EB_ErrorNone,
+                  svt_av1_enc_get_stream_info(
+                      encoder.enc_handle, SVT_AV1_STREAM_INFO_PIPELINE_STATS, &stats));
+        EXPECT_GT(stats.tf_picture_count, 0u);
+        printf("processors %2u: %7.2f fps, %3u filtered pictures, latency %8.2f ms "
+               "average, picture decision waited %8.2f ms (%5.1f%% of %.2f s)\n",
+               processors,
+               speed_frame_count / elapsed,
+               (uint32_t)stats.tf_picture_count,
+               stats.tf_picture_count
+                   ? (double)stats.tf_latency_total / stats.tf_picture_count / 1000
+                   : 0.0,
+               (double)stats.tf_wait_time / 1000,
+               stats.tf_wait_time / 1e4 / elapsed,
+               elapsed);
+        if (processors == core_count)
+            break;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,169 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncReconfigureTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of svt_av1_enc_reconfigure:
+ * - the settings that can not change are rejected
+ * - the new rate starts on a key frame
+ * - the frames after the switch follow the new rate
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 48;
+static const uint32_t switch_frame = 16;
+static const uint32_t frame_rate = 30; // the default of the encoder
+static const uint32_t bit_rate = 1000000;
+static const uint32_t switched_bit_rate = 250000;
+
+/** Sets the encoder of the tests to VBR without periodic key frames */
+static void setup_encoder(TestEncoder &encoder) {
+    // the rate bounds of bit_rate_tracks_switch hold with the default count
+    // of processors
+    encoder.enc_params.logical_processors = 0;
+    encoder.enc_params.intra_period_length = -1;
+    encoder.enc_params.look_ahead_distance = 16;
+    encoder.enc_params.rate_control_mode = 1;
+    encoder.enc_params.target_bit_rate = bit_rate;
+}
+
+/** Encodes frame_count pictures, lowering the rate before switch_frame when
+ * reconfigure is set, and returns the pts of the key frames, the stream and
+ * the bytes of every frame */
+static void encode(bool reconfigure, std::vector<int64_t> *key_pts,
+                   std::vector<uint8_t> *stream, std::vector<uint32_t> *frame_bytes) {
+    TestEncoder encoder;
+    std::vector<uint8_t> frame(test_width * test_height * 3 / 2);
+    uint32_t seed = 1;
+    setup_encoder(encoder);
+    ASSERT_TRUE(encoder.init());
+    frame_bytes->assign(frame_count, 0);
+
+    for (uint32_t i = 0; i < frame_count; i++) {
+        if (reconfigure && i == switch_frame) {
+            EbSvtAv1EncConfiguration config = encoder.enc_params;
+            config.target_bit_rate = switched_bit_rate;
+            ASSERT_EQ(EB_ErrorNone, svt_av1_enc_reconfigure(encoder.enc_handle, &config));
+        }
+        // a moving pattern under noise, so the rate and not the content
+        // bounds the frame sizes
+        fill_frame(frame, test_width, i, 3, 5);
+        for (uint32_t j = 0; j < frame.size(); j++) {
+            seed = seed * 1103515245 + 12345;
+            frame[j] += (uint8_t)(seed >> 30);
+        }
+        send_frame(encoder.enc_handle, frame, test_width, test_height, i);
+    }
+    send_eos(encoder.enc_handle);
+
+    EXPECT_TRUE(drain_packets(encoder.enc_handle, 1, [&](const EbBufferHeaderType *packet) {
+        if (packet->pic_type == EB_AV1_KEY_PICTURE)
+            key_pts->push_back(packet->pts);
+        if (packet->n_filled_len && packet->pts >= 0 && packet->pts < (int64_t)frame_count)
+            (*frame_bytes)[packet->pts] += packet->n_filled_len;
+        stream->insert(stream->end(), packet->p_buffer, packet->p_buffer + packet->n_filled_len);
+    }));
+}
+
+/** @brief invalid_settings_check is a api test case
+ * The resolution and the rate control mode can not be reconfigured. */
+TEST(EncApiReconfigureTest, invalid_settings_check) {
+    TestEncoder encoder;
+    setup_encoder(encoder);
+    ASSERT_TRUE(encoder.init());
+    EbSvtAv1EncConfiguration config = encoder.enc_params;
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_reconfigure(encoder.enc_handle, nullptr));
+
+    config.source_width = test_width * 2;
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_reconfigure(encoder.enc_handle, &config));
+    config = encoder.enc_params;
+    config.rate_control_mode = 0;
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_reconfigure(encoder.enc_handle, &config));
+    config = encoder.enc_params;
+    config.min_qp_allowed = 40;
+    config.max_qp_allowed = 30;
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_reconfigure(encoder.enc_handle, &config));
+    config = encoder.enc_params;
+    config.target_bit_rate = 200000;
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_reconfigure(encoder.enc_handle, &config));
+}
+
+/** Average bytes per frame of the frames [first, last) */
+static double average_bytes(const std::vector<uint32_t> &frame_bytes, uint32_t first,
+                            uint32_t last) {
+    uint64_t total = 0;
+    for (uint32_t i = first; i < last; i++)
+        total += frame_bytes[i];
+    return (double)total / (last - first);
+}
+
+/** @brief key_frame_at_switch is a api test case
+ * Test strategy: <br>
+ * Encode the same pictures with and without lowering the rate in the
+ * middle of the sequence.
+ *
+ * Expected result: <br>
+ * Only the first picture is a key frame without the switch, the switch adds
+ * a key frame at the first picture sent after it and changes the stream.
+ */
+TEST(EncApiReconfigureTest, key_frame_at_switch) {
+    std::vector<int64_t> key_pts, switched_key_pts;
+    std::vector<uint8_t> stream, switched_stream;
+    std::vector<uint32_t> frame_bytes, switched_frame_bytes;
+    encode(false, &key_pts, &stream, &frame_bytes);
+    encode(true, &switched_key_pts, &switched_stream, &switched_frame_bytes);
+
+    ASSERT_EQ(1u, key_pts.size());
+    EXPECT_EQ(0, key_pts[0]);
+    ASSERT_EQ(2u, switched_key_pts.size());
+    EXPECT_EQ(0, switched_key_pts[0]);
+    EXPECT_EQ((int64_t)switch_frame, switched_key_pts[1]);
+    EXPECT_FALSE(stream == switched_stream);
+}
+
+/** @brief bit_rate_tracks_switch is a api test case
+ * Test strategy: <br>
+ * Lower the rate fourfold in the middle of a sequence of noisy pictures.
+ *
+ * Expected result: <br>
+ * The bytes per frame after the key frame of the switch are those of the new
+ * rate, within a factor of two, while the frames before it keep the bytes
+ * of the initial rate.
+ */
+TEST(EncApiReconfigureTest, bit_rate_tracks_switch) {
+    std::vector<int64_t> key_pts;
+    std::vector<uint8_t> stream;
+    std::vector<uint32_t> frame_bytes;
+    encode(true, &key_pts, &stream, &frame_bytes);
+
+    const double target_bytes = bit_rate / 8.0 / frame_rate;
+    const double switched_target_bytes = switched_bit_rate / 8.0 / frame_rate;
+    const double before = average_bytes(frame_bytes, 1, switch_frame);
+    const double after = average_bytes(frame_bytes, switch_frame + 1, frame_count);
+    EXPECT_GT(before, target_bytes / 2);
+    EXPECT_LT(before, target_bytes * 2);
+    EXPECT_GT(after, switched_target_bytes / 2);
+    EXPECT_LT(after, switched_target_bytes * 2);
+}
+
+}  // namespace
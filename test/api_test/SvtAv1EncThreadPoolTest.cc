@@ -0,0 +1,165 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncThreadPoolTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of the shared thread pool:
+ * - svt_av1_enc_create_thread_pool
+ * - svt_av1_enc_destroy_thread_pool
+ * - encoder instances of different priorities and weights encoding on one
+ *   pool
+ * - encoder instances on a pool starting no thread of their own
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#ifdef __linux__
+#include <dirent.h>
+#endif
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+#ifdef __linux__
+static uint32_t process_thread_count() {
+    uint32_t count = 0;
+    DIR *dir = opendir("/proc/self/task");
+    if (!dir)
+        return 0;
+    while (struct dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] != '.')
+            count++;
+    }
+    closedir(dir);
+    return count;
+}
+#endif
+
+static const uint32_t frame_count = 6;
+static const uint32_t channel_count = 3;
+
+/** @brief invalid_settings_check is a api test case
+ * The priority is one of the 3 levels, the weight is in [1, 10000] and a
+ * pool is only destroyed once it has no encoder. */
+TEST(EncApiThreadPoolTest, invalid_settings_check) {
+    EbSvtAv1ThreadPool *pool = nullptr;
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_create_thread_pool(nullptr, 1));
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_destroy_thread_pool(nullptr));
+
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_create_thread_pool(&pool, 2));
+    ASSERT_NE(nullptr, pool);
+    {
+        TestEncoder encoder;
+        EXPECT_EQ(nullptr, encoder.enc_params.thread_pool);
+        EXPECT_EQ(1u, encoder.enc_params.thread_pool_priority);
+        EXPECT_EQ(100u, encoder.enc_params.thread_pool_weight);
+        encoder.enc_params.thread_pool_priority = 3;
+        EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+        encoder.enc_params.thread_pool_priority = 2;
+        encoder.enc_params.thread_pool_weight = 0;
+        EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+        encoder.enc_params.thread_pool_weight = 10001;
+        EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+        encoder.enc_params.thread_pool_weight = 300;
+
+        encoder.enc_params.thread_pool = pool;
+        encoder.enc_params.thread_pool_priority = 2;
+        ASSERT_TRUE(encoder.init());
+        EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_destroy_thread_pool(pool));
+    }
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_destroy_thread_pool(pool));
+}
+
+/** @brief channels_share_pool is a api test case
+ * Test strategy: <br>
+ * Attach encoders of every priority and of different weights to one pool,
+ * send them the same pictures, then read all their packets.
+ *
+ * Expected result: <br>
+ * Every encoder outputs the same stream, whatever its priority.
+ */
+TEST(EncApiThreadPoolTest, channels_share_pool) {
+    std::vector<uint8_t> streams[channel_count];
+    EbSvtAv1ThreadPool *pool = nullptr;
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_create_thread_pool(&pool, 0));
+    {
+        TestEncoder encoders[channel_count];
+        for (uint32_t c = 0; c < channel_count; c++) {
+            encoders[c].enc_params.channel_id = c;
+            encoders[c].enc_params.active_channel_count = channel_count;
+            encoders[c].enc_params.thread_pool = pool;
+            encoders[c].enc_params.thread_pool_priority = c;
+            encoders[c].enc_params.thread_pool_weight = 100 * (c + 1);
+            ASSERT_TRUE(encoders[c].init());
+        }
+
+        for (uint32_t i = 0; i < frame_count; i++) {
+            for (uint32_t c = 0; c < channel_count; c++) encoders[c].send_frame(i, 5, 7);
+        }
+        for (uint32_t c = 0; c < channel_count; c++) send_eos(encoders[c].enc_handle);
+
+        for (uint32_t c = 0; c < channel_count; c++) {
+            std::vector<uint8_t> &stream = streams[c];
+            EXPECT_TRUE(drain_packets(encoders[c].enc_handle, 1, [&](const EbBufferHeaderType *packet) {
+                stream.insert(stream.end(), packet->p_buffer, packet->p_buffer + packet->n_filled_len);
+            }));
+        }
+    }
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_destroy_thread_pool(pool));
+
+    EXPECT_FALSE(streams[0].empty());
+    for (uint32_t c = 1; c < channel_count; c++) EXPECT_TRUE(streams[0] == streams[c]);
+}
+
+#ifdef __linux__
+/** @brief channels_add_no_threads is a api test case
+ * Test strategy: <br>
+ * Attach encoders to a pool, count the threads of the process while they
+ * encode.
+ *
+ * Expected result: <br>
+ * Every stage of the encoders runs on the workers of the pool, the process
+ * has as many threads as before the encoders were created.
+ */
+TEST(EncApiThreadPoolTest, channels_add_no_threads) {
+    EbSvtAv1ThreadPool *pool = nullptr;
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_create_thread_pool(&pool, 2));
+    const uint32_t thread_count = process_thread_count();
+    ASSERT_NE(0u, thread_count);
+    {
+        TestEncoder encoders[channel_count];
+        for (uint32_t c = 0; c < channel_count; c++) {
+            encoders[c].enc_params.channel_id = c;
+            encoders[c].enc_params.active_channel_count = channel_count;
+            encoders[c].enc_params.thread_pool = pool;
+            ASSERT_TRUE(encoders[c].init());
+        }
+        for (uint32_t i = 0; i < frame_count; i++) {
+            for (uint32_t c = 0; c < channel_count; c++) encoders[c].send_frame(i, 5, 7);
+        }
+        EXPECT_EQ(thread_count, process_thread_count());
+        for (uint32_t c = 0; c < channel_count; c++) send_eos(encoders[c].enc_handle);
+        for (uint32_t c = 0; c < channel_count; c++) {
+            EXPECT_TRUE(drain_packets(encoders[c].enc_handle, 1, [](const EbBufferHeaderType *) {}));
+        }
+    }
+    EXPECT_EQ(EB_ErrorNone, svt_av1_enc_destroy_thread_pool(pool));
+}
+#endif
+
+}  // namespace
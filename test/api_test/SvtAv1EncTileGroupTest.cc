@@ -0,0 +1,145 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncTileGroupTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of the tile group output:
+ * - parameter checks of tile_group_output
+ * - the fragments of a picture come before its last packet, one per tile
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t width = 352;
+static const uint32_t height = 288;
+static const uint32_t frame_count = 6;
+// 2 tile rows and 2 tile columns
+static const uint32_t tile_count = 4;
+
+/** Sets the encoder of the tests to 2x2 tiles output in tile groups */
+static void setup_encoder(TestEncoder &encoder) {
+    encoder.enc_params.max_frames_in_flight = 1;
+    encoder.enc_params.tile_rows = 1;
+    encoder.enc_params.tile_columns = 1;
+    encoder.enc_params.tile_group_output = EB_TRUE;
+}
+
+/** Reads the packets of picture pts up to the one without the fragment flag,
+ * returns their count */
+static uint32_t receive_picture(TestEncoder &encoder, int64_t pts) {
+    uint32_t packet_count = 0;
+    for (;;) {
+        EbBufferHeaderType *packet = nullptr;
+        EXPECT_EQ(EB_ErrorNone, svt_av1_enc_get_packet(encoder.enc_handle, &packet, 1));
+        if (!packet)
+            return packet_count;
+        const bool fragment = !!(packet->flags & EB_BUFFERFLAG_FRAGMENT);
+        EXPECT_EQ(pts, packet->pts);
+        EXPECT_GT(packet->n_filled_len, 0u);
+        EXPECT_EQ(packet_count == 0, !!(packet->flags & EB_BUFFERFLAG_HAS_TD));
+        EXPECT_EQ(0u, packet->flags & EB_BUFFERFLAG_EOS);
+        packet_count++;
+        svt_av1_enc_release_out_buffer(&packet);
+        if (!fragment)
+            return packet_count;
+    }
+}
+
+static void receive_eos(TestEncoder &encoder) {
+    send_eos(encoder.enc_handle);
+    EbBufferHeaderType *packet = nullptr;
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_get_packet(encoder.enc_handle, &packet, 1));
+    EXPECT_EQ((uint32_t)EB_BUFFERFLAG_EOS, packet->flags & EB_BUFFERFLAG_EOS);
+    EXPECT_EQ(0u, packet->n_filled_len);
+    svt_av1_enc_release_out_buffer(&packet);
+}
+
+/** @brief invalid_settings_check is a api test case
+ * The tile group output is only available in the low-latency mode. */
+TEST(EncApiTileGroupTest, invalid_settings_check) {
+    TestEncoder encoder(width, height);
+    EXPECT_EQ(EB_FALSE, encoder.enc_params.tile_group_output);
+    setup_encoder(encoder);
+    encoder.enc_params.max_frames_in_flight = 0;
+    EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+    encoder.enc_params.max_frames_in_flight = 1;
+    EXPECT_EQ(EB_ErrorNone, encoder.set_parameter());
+}
+
+/** @brief fragment_per_tile is a api test case
+ * Test strategy: <br>
+ * Send one picture at a time and read its packets until the one without the
+ * fragment flag, then send the end of sequence.
+ *
+ * Expected result: <br>
+ * Every picture comes in one fragment per tile but the last one, the first
+ * fragment holding the temporal delimiter, then in a last packet with the
+ * latency of the picture.
+ */
+TEST(EncApiTileGroupTest, fragment_per_tile) {
+    TestEncoder encoder(width, height);
+    setup_encoder(encoder);
+    ASSERT_TRUE(encoder.init());
+
+    for (uint32_t i = 0; i < frame_count; i++) {
+        encoder.send_frame(i, 3, 5);
+        EXPECT_EQ(tile_count, receive_picture(encoder, i));
+    }
+    receive_eos(encoder);
+}
+
+/** @brief single_tile_pictures is a api test case
+ * Test strategy: <br>
+ * Code a 2 superblocks wide sequence with a random super-resolution
+ * denominator per picture, the pictures coded at half the width have 1 tile
+ * and the others 2. Send pictures until one with 2 tiles follows one with 1
+ * tile.
+ *
+ * Expected result: <br>
+ * Every picture comes in order, in one packet or in a fragment holding the
+ * temporal delimiter then a last packet.
+ */
+TEST(EncApiTileGroupTest, single_tile_pictures) {
+    const uint32_t small_width = 128;
+    const uint32_t small_height = 64;
+    const uint32_t max_frame_count = 120;
+    TestEncoder encoder(small_width, small_height);
+    setup_encoder(encoder);
+    encoder.enc_params.tile_rows = 0;
+    encoder.enc_params.enable_restoration_filtering = 1;
+    encoder.enc_params.superres_mode = SUPERRES_RANDOM;
+    ASSERT_TRUE(encoder.init());
+
+    uint32_t prev_packet_count = 0;
+    bool single_then_tiles = false;
+    for (uint32_t i = 0; i < max_frame_count && !single_then_tiles; i++) {
+        encoder.send_frame(i, 3, 5);
+        const uint32_t packet_count = receive_picture(encoder, i);
+        EXPECT_TRUE(packet_count == 1 || packet_count == 2) << "picture " << i;
+        single_then_tiles = prev_packet_count == 1 && packet_count == 2;
+        prev_packet_count = packet_count;
+    }
+    EXPECT_TRUE(single_then_tiles);
+    receive_eos(encoder);
+}
+
+}  // namespace
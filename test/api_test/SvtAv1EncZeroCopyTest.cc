@@ -0,0 +1,219 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncZeroCopyTest.cc
+ *
+ * @brief SVT-AV1 encoder api test of the zero copy input mode:
+ * - parameter checks of zero_copy_input
+ * - buffers with the planes of high bit depth input are rejected
+ * - every buffer sent is handed back once through input_release_callback
+ * - the bitstream matches the one of the copying input path
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+#include "SvtAv1EncApiTestUtil.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+static const uint32_t frame_count = 12;
+
+/** Input buffer owned by the test, with padded planes */
+typedef struct {
+    uint8_t *plane[3];
+    std::atomic<uint32_t> release_count;
+} TestInputBuffer;
+
+static void release_input(void *p_app_private) {
+    ((TestInputBuffer *)p_app_private)->release_count++;
+}
+
+static void setup_params(EbSvtAv1EncConfiguration *params, bool zero_copy) {
+    params->zero_copy_input = zero_copy ? EB_TRUE : EB_FALSE;
+    params->input_release_callback = zero_copy ? release_input : nullptr;
+}
+
+/** Fills the picture area of a frame with a moving pattern and the padding
+ * with garbage the encoder has to overwrite */
+static void fill_frame(TestInputBuffer *buffer, const SvtAv1InputLayout &layout,
+                       uint32_t frame) {
+    for (int p = 0; p < 3; p++) {
+        const uint32_t stride = p ? layout.chroma_stride : layout.luma_stride;
+        const uint32_t size = p ? layout.chroma_size : layout.luma_size;
+        const uint32_t org_x = p ? layout.origin_x >> 1 : layout.origin_x;
+        const uint32_t org_y = p ? layout.origin_y >> 1 : layout.origin_y;
+        const uint32_t w = p ? test_width >> 1 : test_width;
+        const uint32_t h = p ? test_height >> 1 : test_height;
+        for (uint32_t i = 0; i < size; i++)
+            buffer->plane[p][i] = (uint8_t)(i * 37 + 11);
+        for (uint32_t y = 0; y < h; y++)
+            for (uint32_t x = 0; x < w; x++)
+                buffer->plane[p][(org_y + y) * stride + org_x + x] =
+                    (uint8_t)((x + 2 * frame) * (p + 1) + y * 3);
+    }
+}
+
+/** Encodes frame_count frames and returns the concatenated packets */
+static std::vector<uint8_t> encode(bool zero_copy, uint32_t *release_count) {
+    SvtAv1InputLayout layout;
+    std::vector<uint8_t> bitstream;
+    std::vector<TestInputBuffer> buffers(frame_count);
+
+    {
+        // Destroyed before the releases are counted
+        TestEncoder encoder;
+        setup_params(&encoder.enc_params, zero_copy);
+        EXPECT_TRUE(encoder.init());
+        EXPECT_EQ(EB_ErrorNone,
+                  svt_av1_enc_get_stream_info(
+                      encoder.enc_handle, SVT_AV1_STREAM_INFO_INPUT_LAYOUT, &layout));
+
+        for (uint32_t i = 0; i < frame_count; i++) {
+            TestInputBuffer *buffer = &buffers[i];
+            EbSvtIOFormat input;
+            EbBufferHeaderType header;
+            buffer->release_count = 0;
+            buffer->plane[0] = (uint8_t *)aligned_alloc(layout.alignment, layout.luma_size);
+            buffer->plane[1] = (uint8_t *)aligned_alloc(layout.alignment, layout.chroma_size);
+            buffer->plane[2] = (uint8_t *)aligned_alloc(layout.alignment, layout.chroma_size);
+            fill_frame(buffer, layout, i);
+
+            memset(&input, 0, sizeof(input));
+            input.y_stride = layout.luma_stride;
+            input.cb_stride = layout.chroma_stride;
+            input.cr_stride = layout.chroma_stride;
+            if (zero_copy) {
+                input.luma = buffer->plane[0];
+                input.cb = buffer->plane[1];
+                input.cr = buffer->plane[2];
+            } else {
+                const uint32_t chroma_offset =
+                    (layout.origin_y >> 1) * layout.chroma_stride + (layout.origin_x >> 1);
+                input.luma = buffer->plane[0] + layout.origin_y * layout.luma_stride +
+                    layout.origin_x;
+                input.cb = buffer->plane[1] + chroma_offset;
+                input.cr = buffer->plane[2] + chroma_offset;
+            }
+
+            memset(&header, 0, sizeof(header));
+            header.size = sizeof(header);
+            header.p_buffer = (uint8_t *)&input;
+            header.n_filled_len = layout.luma_size + 2 * layout.chroma_size;
+            header.p_app_private = buffer;
+            header.pts = i;
+            header.pic_type = EB_AV1_INVALID_PICTURE;
+            EXPECT_EQ(EB_ErrorNone, svt_av1_enc_send_picture(encoder.enc_handle, &header));
+        }
+
+        send_eos(encoder.enc_handle);
+        drain_packets(encoder.enc_handle, 1, [&](const EbBufferHeaderType *packet) {
+            bitstream.insert(
+                bitstream.end(), packet->p_buffer, packet->p_buffer + packet->n_filled_len);
+        });
+    }
+
+    for (uint32_t i = 0; i < frame_count; i++) {
+        release_count[i] = buffers[i].release_count;
+        for (int p = 0; p < 3; p++)
+            free(buffers[i].plane[p]);
+    }
+    return bitstream;
+}
+
+/** @brief zero_copy_parameter_check is a api test case
+ * Zero copy input is rejected without a release callback and with 10-bit
+ * input. */
+TEST(EncApiZeroCopyTest, zero_copy_parameter_check) {
+    TestEncoder encoder;
+
+    setup_params(&encoder.enc_params, true);
+    encoder.enc_params.input_release_callback = nullptr;
+    EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+    setup_params(&encoder.enc_params, true);
+    encoder.enc_params.encoder_bit_depth = 10;
+    EXPECT_EQ(EB_ErrorBadParameter, encoder.set_parameter());
+}
+
+/** @brief zero_copy_rejects_high_bit_depth_planes is a api test case
+ * A zero copy buffer with the 2-bit planes of high bit depth input is
+ * rejected instead of being encoded from its 8-bit planes only. */
+TEST(EncApiZeroCopyTest, zero_copy_rejects_high_bit_depth_planes) {
+    SvtAv1InputLayout layout;
+    TestEncoder encoder;
+    setup_params(&encoder.enc_params, true);
+    ASSERT_TRUE(encoder.init());
+    ASSERT_EQ(EB_ErrorNone,
+              svt_av1_enc_get_stream_info(
+                  encoder.enc_handle, SVT_AV1_STREAM_INFO_INPUT_LAYOUT, &layout));
+
+    TestInputBuffer buffer;
+    buffer.release_count = 0;
+    for (int p = 0; p < 3; p++)
+        buffer.plane[p] = (uint8_t *)aligned_alloc(
+            layout.alignment, p ? layout.chroma_size : layout.luma_size);
+
+    EbSvtIOFormat input;
+    memset(&input, 0, sizeof(input));
+    input.luma = buffer.plane[0];
+    input.cb = buffer.plane[1];
+    input.cr = buffer.plane[2];
+    input.luma_ext = buffer.plane[0];
+    input.y_stride = layout.luma_stride;
+    input.cb_stride = layout.chroma_stride;
+    input.cr_stride = layout.chroma_stride;
+
+    EbBufferHeaderType header;
+    memset(&header, 0, sizeof(header));
+    header.size = sizeof(header);
+    header.p_buffer = (uint8_t *)&input;
+    header.n_filled_len = layout.luma_size + 2 * layout.chroma_size;
+    header.p_app_private = &buffer;
+    header.pic_type = EB_AV1_INVALID_PICTURE;
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_send_picture(encoder.enc_handle, &header));
+    EXPECT_EQ(0u, buffer.release_count);
+
+    for (int p = 0; p < 3; p++)
+        free(buffer.plane[p]);
+}
+
+/** @brief zero_copy_matches_copy is a api test case
+ * Test strategy: <br>
+ * Encode the same frames with and without zero copy input, with garbage in
+ * the padding of the planes.
+ *
+ * Expected result: <br>
+ * Both bitstreams are identical, every zero copy buffer is released exactly
+ * once and no callback fires in copy mode.
+ */
+TEST(EncApiZeroCopyTest, zero_copy_matches_copy) {
+    uint32_t copy_releases[frame_count];
+    uint32_t zero_copy_releases[frame_count];
+
+    const std::vector<uint8_t> copy_stream = encode(false, copy_releases);
+    const std::vector<uint8_t> zero_copy_stream = encode(true, zero_copy_releases);
+
+    ASSERT_FALSE(copy_stream.empty());
+    EXPECT_EQ(copy_stream, zero_copy_stream);
+    for (uint32_t i = 0; i < frame_count; i++) {
+        EXPECT_EQ(0u, copy_releases[i]) << "frame " << i;
+        EXPECT_EQ(1u, zero_copy_releases[i]) << "frame " << i;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,224 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+
+/******************************************************************************
+ * @file BlendBench.cc
+ *
+ * @brief Kernel benchmark cases of the masked blending of the compound and
+ * OBMC predictions, svt_aom_*blend_a64_*, of the difference weighted masks and
+ * of the wedge search svt_av1_wedge_*.
+ *
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "convolve.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = MAX_SB_SIZE;
+
+/* Random mask of the blending weights, 0 to 64 */
+uint8_t *alloc_mask(size_t count) {
+    uint8_t *mask = svt_av1_bench::bench_alloc_random(count);
+    for (size_t i = 0; i < count; i++) mask[i] %= AOM_BLEND_A64_MAX_ALPHA + 1;
+    return mask;
+}
+
+void add_blend_cases(std::vector<BenchCase> &cases) {
+    const uint8_t *src0 = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    const uint8_t *src1 = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint8_t *dst = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    // The highbd blending takes the 16 bit buffers cast to uint8_t *
+    uint16_t *src0_16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    uint16_t *src1_16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    uint16_t *dst16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    // The compound predictions before rounding, as the jnt convolutions store them
+    const CONV_BUF_TYPE *d16_0 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 14);
+    const CONV_BUF_TYPE *d16_1 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 14);
+    const uint8_t *mask = alloc_mask(stride * MAX_SB_SIZE);
+    uint8_t *mask_out = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    std::shared_ptr<ConvolveParams> conv_params(new ConvolveParams);
+    std::shared_ptr<ConvolveParams> conv_params10(new ConvolveParams);
+    *conv_params = get_conv_params_no_round(0, 0, 0, NULL, 0, 1, 8);
+    *conv_params10 = get_conv_params_no_round(0, 0, 0, NULL, 0, 1, 10);
+
+    for (int w = 4; w <= MAX_SB_SIZE; w *= 2) {
+        for (int h = w / 2 < 4 ? 4 : w / 2; h <= 2 * w && h <= MAX_SB_SIZE; h *= 2) {
+            const std::string dims = std::to_string(w) + "x" + std::to_string(h);
+
+            KERNEL_BENCH_CASE(
+                cases,
+                "svt_aom_blend_a64_mask/" + dims,
+                svt_aom_blend_a64_mask,
+                w * h,
+                svt_aom_blend_a64_mask(
+                    dst, stride, src0, stride, src1, stride, mask, stride, w, h, 0, 0));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_aom_highbd_blend_a64_mask/" + dims + "/10bit",
+                              svt_aom_highbd_blend_a64_mask,
+                              w * h,
+                              svt_aom_highbd_blend_a64_mask((uint8_t *)dst16,
+                                                            stride,
+                                                            (const uint8_t *)src0_16,
+                                                            stride,
+                                                            (const uint8_t *)src1_16,
+                                                            stride,
+                                                            mask,
+                                                            stride,
+                                                            w,
+                                                            h,
+                                                            0,
+                                                            0,
+                                                            10));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_aom_lowbd_blend_a64_d16_mask/" + dims,
+                              svt_aom_lowbd_blend_a64_d16_mask,
+                              w * h,
+                              svt_aom_lowbd_blend_a64_d16_mask(dst,
+                                                               stride,
+                                                               d16_0,
+                                                               stride,
+                                                               d16_1,
+                                                               stride,
+                                                               mask,
+                                                               stride,
+                                                               w,
+                                                               h,
+                                                               0,
+                                                               0,
+                                                               conv_params.get()));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_aom_highbd_blend_a64_d16_mask/" + dims + "/10bit",
+                              svt_aom_highbd_blend_a64_d16_mask,
+                              w * h,
+                              svt_aom_highbd_blend_a64_d16_mask((uint8_t *)dst16,
+                                                                stride,
+                                                                d16_0,
+                                                                stride,
+                                                                d16_1,
+                                                                stride,
+                                                                mask,
+                                                                stride,
+                                                                w,
+                                                                h,
+                                                                0,
+                                                                0,
+                                                                conv_params10.get(),
+                                                                10));
+
+            // OBMC blends with a weight per column or per row
+            KERNEL_BENCH_CASE(
+                cases,
+                "svt_aom_blend_a64_hmask/" + dims,
+                svt_aom_blend_a64_hmask,
+                w * h,
+                svt_aom_blend_a64_hmask(dst, stride, src0, stride, src1, stride, mask, w, h));
+            KERNEL_BENCH_CASE(
+                cases,
+                "svt_aom_blend_a64_vmask/" + dims,
+                svt_aom_blend_a64_vmask,
+                w * h,
+                svt_aom_blend_a64_vmask(dst, stride, src0, stride, src1, stride, mask, w, h));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_aom_highbd_blend_a64_hmask_16bit/" + dims + "/10bit",
+                              svt_aom_highbd_blend_a64_hmask_16bit,
+                              w * h,
+                              svt_aom_highbd_blend_a64_hmask_16bit(
+                                  dst16, stride, src0_16, stride, src1_16, stride, mask, w, h, 10));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_aom_highbd_blend_a64_vmask_16bit/" + dims + "/10bit",
+                              svt_aom_highbd_blend_a64_vmask_16bit,
+                              w * h,
+                              svt_aom_highbd_blend_a64_vmask_16bit(
+                                  dst16, stride, src0_16, stride, src1_16, stride, mask, w, h, 10));
+
+            // The difference weighted compound applies to blocks of 8x8 and up
+            if (w < 8 || h < 8)
+                continue;
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_build_compound_diffwtd_mask/" + dims,
+                              svt_av1_build_compound_diffwtd_mask,
+                              w * h,
+                              svt_av1_build_compound_diffwtd_mask(
+                                  mask_out, DIFFWTD_38, src0, stride, src1, stride, h, w));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_build_compound_diffwtd_mask_highbd/" + dims + "/10bit",
+                              svt_av1_build_compound_diffwtd_mask_highbd,
+                              w * h,
+                              svt_av1_build_compound_diffwtd_mask_highbd(mask_out,
+                                                                         DIFFWTD_38,
+                                                                         (const uint8_t *)src0_16,
+                                                                         stride,
+                                                                         (const uint8_t *)src1_16,
+                                                                         stride,
+                                                                         h,
+                                                                         w,
+                                                                         10));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_build_compound_diffwtd_mask_d16/" + dims,
+                              svt_av1_build_compound_diffwtd_mask_d16,
+                              w * h,
+                              svt_av1_build_compound_diffwtd_mask_d16(mask_out,
+                                                                      DIFFWTD_38,
+                                                                      d16_0,
+                                                                      stride,
+                                                                      d16_1,
+                                                                      stride,
+                                                                      h,
+                                                                      w,
+                                                                      conv_params.get(),
+                                                                      8));
+        }
+    }
+}
+
+void add_wedge_cases(std::vector<BenchCase> &cases) {
+    const int n = MAX_SB_SQUARE;
+    // Residuals of 8 bit samples
+    const int16_t *r0 = (const int16_t *)svt_av1_bench::bench_alloc_random16(n, 8);
+    const int16_t *r1 = (const int16_t *)svt_av1_bench::bench_alloc_random16(n, 8);
+    int16_t *d = (int16_t *)svt_av1_bench::bench_alloc_random16(n, 8);
+    const uint8_t *mask = alloc_mask(n);
+
+    // The wedge masks cover blocks of 8x8 to 32x32, N is a multiple of 64
+    for (int size = 8; size <= 32; size *= 2) {
+        const int count = size * size;
+        const std::string dims = std::to_string(size) + "x" + std::to_string(size);
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_wedge_sse_from_residuals/" + dims,
+                          svt_av1_wedge_sse_from_residuals,
+                          count,
+                          svt_av1_bench::bench_sink +=
+                          svt_av1_wedge_sse_from_residuals(r1, r0, mask, count));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_wedge_sign_from_residuals/" + dims,
+                          svt_av1_wedge_sign_from_residuals,
+                          count,
+                          svt_av1_bench::bench_sink +=
+                          svt_av1_wedge_sign_from_residuals(r0, mask, count, 0));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_wedge_compute_delta_squares/" + dims,
+                          svt_av1_wedge_compute_delta_squares,
+                          count,
+                          svt_av1_wedge_compute_delta_squares(d, r0, r1, count));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_blend_cases);
+KERNEL_BENCH_FAMILY(add_wedge_cases);
+
+}  // namespace
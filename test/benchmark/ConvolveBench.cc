@@ -0,0 +1,266 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+
+/******************************************************************************
+ * @file ConvolveBench.cc
+ *
+ * @brief Kernel benchmark cases of the inter prediction filters: the single
+ * reference svt_av1_convolve_*_sr, the compound svt_av1_jnt_convolve_*, the
+ * scaled convolution, svt_aom_convolve8_* and the warped motion filter, 8 tap
+ * regular filter at half pel.
+ *
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "convolve.h"
+#include "filter.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = MAX_SB_SIZE + 16;
+// Rows and columns read above and left of the block by the 8 tap filter
+const int border = 3;
+
+struct ConvolveSetup {
+    InterpFilterParams filter_x;
+    InterpFilterParams filter_y;
+    ConvolveParams conv_params;
+    // The second prediction of a compound block, averaged with the first one
+    // held in the CONV_BUF_TYPE buffer
+    ConvolveParams jnt_conv_params;
+};
+
+std::shared_ptr<ConvolveSetup> create_setup(int w, int h, int bd, CONV_BUF_TYPE *conv_buf) {
+    std::shared_ptr<ConvolveSetup> setup(new ConvolveSetup);
+    setup->filter_x = av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, w);
+    setup->filter_y = av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, h);
+    setup->conv_params = get_conv_params_no_round(0, 0, 0, NULL, 0, 0, bd);
+    setup->jnt_conv_params = get_conv_params_no_round(0, 1, 0, conv_buf, stride, 1, bd);
+    return setup;
+}
+
+void add_convolve_cases(std::vector<BenchCase> &cases) {
+    const int rows = MAX_SB_SIZE + 2 * border + 2;
+    const uint8_t *src =
+        svt_av1_bench::bench_alloc_random(stride * rows) + border * stride + border;
+    uint8_t *dst = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    const uint16_t *src16 =
+        svt_av1_bench::bench_alloc_random16(stride * rows, 10) + border * stride + border;
+    uint16_t *dst16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    CONV_BUF_TYPE *conv_buf = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 14);
+    const int sub_pel = 8;
+
+#define CONVOLVE_CASE(func, params, subpel_x, subpel_y)                 \
+    KERNEL_BENCH_CASE(cases,                                            \
+                      #func "/" + dims,                                 \
+                      func,                                             \
+                      w * h,                                            \
+                      func(src,                                         \
+                           stride,                                      \
+                           dst,                                         \
+                           stride,                                      \
+                           w,                                           \
+                           h,                                           \
+                           &setup->filter_x,                            \
+                           &setup->filter_y,                            \
+                           subpel_x,                                    \
+                           subpel_y,                                    \
+                           &setup->params))
+#define HIGHBD_CONVOLVE_CASE(func, params, subpel_x, subpel_y)          \
+    KERNEL_BENCH_CASE(cases,                                            \
+                      #func "/" + dims + "/10bit",                      \
+                      func,                                             \
+                      w * h,                                            \
+                      func(src16,                                       \
+                           stride,                                      \
+                           dst16,                                       \
+                           stride,                                      \
+                           w,                                           \
+                           h,                                           \
+                           &setup10->filter_x,                          \
+                           &setup10->filter_y,                          \
+                           subpel_x,                                    \
+                           subpel_y,                                    \
+                           &setup10->params,                            \
+                           10))
+
+    for (int w = 4; w <= MAX_SB_SIZE; w *= 2) {
+        for (int h = w / 2 < 4 ? 4 : w / 2; h <= 2 * w && h <= MAX_SB_SIZE; h *= 2) {
+            const std::string dims = std::to_string(w) + "x" + std::to_string(h);
+            std::shared_ptr<ConvolveSetup> setup = create_setup(w, h, 8, conv_buf);
+            std::shared_ptr<ConvolveSetup> setup10 = create_setup(w, h, 10, conv_buf);
+
+            CONVOLVE_CASE(svt_av1_convolve_2d_sr, conv_params, sub_pel, sub_pel);
+            CONVOLVE_CASE(svt_av1_convolve_x_sr, conv_params, sub_pel, 0);
+            CONVOLVE_CASE(svt_av1_convolve_y_sr, conv_params, 0, sub_pel);
+            CONVOLVE_CASE(svt_av1_convolve_2d_copy_sr, conv_params, 0, 0);
+            CONVOLVE_CASE(svt_av1_jnt_convolve_2d, jnt_conv_params, sub_pel, sub_pel);
+            CONVOLVE_CASE(svt_av1_jnt_convolve_x, jnt_conv_params, sub_pel, 0);
+            CONVOLVE_CASE(svt_av1_jnt_convolve_y, jnt_conv_params, 0, sub_pel);
+            CONVOLVE_CASE(svt_av1_jnt_convolve_2d_copy, jnt_conv_params, 0, 0);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_convolve_2d_sr, conv_params, sub_pel, sub_pel);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_convolve_x_sr, conv_params, sub_pel, 0);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_convolve_y_sr, conv_params, 0, sub_pel);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_convolve_2d_copy_sr, conv_params, 0, 0);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_jnt_convolve_2d, jnt_conv_params, sub_pel, sub_pel);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_jnt_convolve_x, jnt_conv_params, sub_pel, 0);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_jnt_convolve_y, jnt_conv_params, 0, sub_pel);
+            HIGHBD_CONVOLVE_CASE(svt_av1_highbd_jnt_convolve_2d_copy, jnt_conv_params, 0, 0);
+
+            // A reference of twice the resolution, the source then covers
+            // 2 * w + 8 columns and 2 * h + 8 rows
+            if (w <= 64 && h <= 64) {
+                const int x_step_qn = 2 * SCALE_SUBPEL_SHIFTS;
+                const int subpel_qn = SCALE_SUBPEL_SHIFTS / 2;
+                KERNEL_BENCH_CASE(cases,
+                                  "svt_av1_convolve_2d_scale/" + dims,
+                                  svt_av1_convolve_2d_scale,
+                                  w * h,
+                                  svt_av1_convolve_2d_scale(src,
+                                                            stride,
+                                                            dst,
+                                                            stride,
+                                                            w,
+                                                            h,
+                                                            &setup->filter_x,
+                                                            &setup->filter_y,
+                                                            subpel_qn,
+                                                            x_step_qn,
+                                                            subpel_qn,
+                                                            x_step_qn,
+                                                            &setup->conv_params));
+                KERNEL_BENCH_CASE(cases,
+                                  "svt_av1_highbd_convolve_2d_scale/" + dims + "/10bit",
+                                  svt_av1_highbd_convolve_2d_scale,
+                                  w * h,
+                                  svt_av1_highbd_convolve_2d_scale(src16,
+                                                                   stride,
+                                                                   dst16,
+                                                                   stride,
+                                                                   w,
+                                                                   h,
+                                                                   &setup10->filter_x,
+                                                                   &setup10->filter_y,
+                                                                   subpel_qn,
+                                                                   x_step_qn,
+                                                                   subpel_qn,
+                                                                   x_step_qn,
+                                                                   &setup10->conv_params,
+                                                                   10));
+            }
+
+            // The 8 tap filters of the frame scaler, at unit step
+            if (w <= 64 && h <= 64) {
+                const int16_t *filter_x = av1_get_interp_filter_subpel_kernel(setup->filter_x,
+                                                                             sub_pel);
+                const int16_t *filter_y = av1_get_interp_filter_subpel_kernel(setup->filter_y,
+                                                                             sub_pel);
+                KERNEL_BENCH_CASE(cases,
+                                  "svt_aom_convolve8_horiz/" + dims,
+                                  svt_aom_convolve8_horiz,
+                                  w * h,
+                                  svt_aom_convolve8_horiz(
+                                      src, stride, dst, stride, filter_x, 16, filter_y, 16, w, h));
+                KERNEL_BENCH_CASE(cases,
+                                  "svt_aom_convolve8_vert/" + dims,
+                                  svt_aom_convolve8_vert,
+                                  w * h,
+                                  svt_aom_convolve8_vert(
+                                      src, stride, dst, stride, filter_x, 16, filter_y, 16, w, h));
+            }
+        }
+    }
+#undef HIGHBD_CONVOLVE_CASE
+#undef CONVOLVE_CASE
+}
+
+void add_warp_cases(std::vector<BenchCase> &cases) {
+    const int rows = MAX_SB_SIZE + 2 * border + 2;
+    const uint8_t *ref = svt_av1_bench::bench_alloc_random(stride * rows);
+    uint8_t *pred = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    const uint16_t *ref16 = svt_av1_bench::bench_alloc_random16(stride * rows, 10);
+    uint16_t *pred16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    std::shared_ptr<ConvolveParams> conv_params(new ConvolveParams);
+    std::shared_ptr<ConvolveParams> conv_params10(new ConvolveParams);
+    *conv_params = get_conv_params_no_round(0, 0, 0, NULL, 0, 0, 8);
+    *conv_params10 = get_conv_params_no_round(0, 0, 0, NULL, 0, 0, 10);
+
+    // A small zoom and shear with a translation of a few pels
+    const int16_t alpha = 64, beta = -32, gamma = 32, delta = 48;
+    int32_t *mat = svt_av1_bench::bench_alloc_random32(8, 8);
+    mat[0] = 3 << WARPEDMODEL_PREC_BITS;
+    mat[1] = 2 << WARPEDMODEL_PREC_BITS;
+    mat[2] = (1 << WARPEDMODEL_PREC_BITS) + alpha;
+    mat[3] = beta;
+    mat[4] = gamma;
+    mat[5] = (1 << WARPEDMODEL_PREC_BITS) + delta;
+
+    // The warped prediction of a block is made of 8x8 blocks
+    for (int size = 8; size <= 64; size *= 2) {
+        const std::string dims = std::to_string(size) + "x" + std::to_string(size);
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_warp_affine/" + dims,
+                          svt_av1_warp_affine,
+                          size * size,
+                          svt_av1_warp_affine(mat,
+                                              ref,
+                                              MAX_SB_SIZE,
+                                              MAX_SB_SIZE,
+                                              stride,
+                                              pred,
+                                              16,
+                                              16,
+                                              size,
+                                              size,
+                                              stride,
+                                              0,
+                                              0,
+                                              conv_params.get(),
+                                              alpha,
+                                              beta,
+                                              gamma,
+                                              delta));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_highbd_warp_affine/" + dims + "/10bit",
+                          svt_av1_highbd_warp_affine,
+                          size * size,
+                          svt_av1_highbd_warp_affine(mat,
+                                                     ref16,
+                                                     MAX_SB_SIZE,
+                                                     MAX_SB_SIZE,
+                                                     stride,
+                                                     pred16,
+                                                     16,
+                                                     16,
+                                                     size,
+                                                     size,
+                                                     stride,
+                                                     0,
+                                                     0,
+                                                     10,
+                                                     conv_params10.get(),
+                                                     alpha,
+                                                     beta,
+                                                     gamma,
+                                                     delta));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_convolve_cases);
+KERNEL_BENCH_FAMILY(add_warp_cases);
+
+}  // namespace
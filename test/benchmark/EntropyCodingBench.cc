@@ -0,0 +1,95 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file EntropyCodingBench.cc
+ *
+ * @brief Kernel benchmark cases of the range coder, whose pixels are symbols:
+ * svt_av1_update_cdf, svt_od_ec_search_cdf, and aom_write_symbol coding and
+ * adapting a tile worth of symbols of one alphabet size.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include <string>
+#include "common_dsp_rtcd.h"
+#include "EbBitstreamUnit.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int symbol_count = 16384;
+const int cdf_count = 16;  // contexts, the symbol i uses the CDF i % cdf_count
+const int cdf_stride = CDF_SIZE(16);
+
+/** Uniform CDFs of nsyms symbols with a zero counter */
+void init_cdfs(AomCdfProb *cdfs, int nsyms) {
+    memset(cdfs, 0, sizeof(*cdfs) * cdf_count * cdf_stride);
+    for (int c = 0; c < cdf_count; c++) {
+        for (int i = 0; i < nsyms; i++)
+            cdfs[c * cdf_stride + i] = AOM_ICDF(CDF_PROB_TOP * (i + 1) / nsyms);
+    }
+}
+
+void add_entropy_coding_cases(std::vector<BenchCase> &cases) {
+    const uint8_t *random = svt_av1_bench::bench_alloc_random(symbol_count);
+    uint8_t *out = svt_av1_bench::bench_alloc_random(symbol_count * 2);
+
+    for (int nsyms = 2; nsyms <= 16; nsyms *= 2) {
+        const std::string syms = std::to_string(nsyms) + "syms";
+        // half of the symbols are 0, as for the coefficient levels
+        uint8_t *symbols = svt_av1_bench::bench_alloc_random(symbol_count);
+        for (int i = 0; i < symbol_count; i++)
+            symbols[i] = (random[i] & 0x80) ? 0 : random[i] % nsyms;
+        AomCdfProb *init = (AomCdfProb *)svt_av1_bench::bench_alloc_random16(
+            cdf_count * cdf_stride, 16);
+        AomCdfProb *cdfs = (AomCdfProb *)svt_av1_bench::bench_alloc_random16(
+            cdf_count * cdf_stride, 16);
+        init_cdfs(init, nsyms);
+
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_update_cdf/" + syms,
+                          svt_av1_update_cdf,
+                          symbol_count,
+                          memcpy(cdfs, init, sizeof(*cdfs) * cdf_count * cdf_stride);
+                          for (int i = 0; i < symbol_count; i++) svt_av1_update_cdf(
+                              cdfs + i % cdf_count * cdf_stride, symbols[i], nsyms));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_od_ec_search_cdf/" + syms,
+                          svt_od_ec_search_cdf,
+                          symbol_count,
+                          uint32_t sum = 0;
+                          for (int i = 0; i < symbol_count; i++) sum += svt_od_ec_search_cdf(
+                              init + i % cdf_count * cdf_stride,
+                              nsyms,
+                              random[i] << 7,
+                              32768 + (random[i] << 7));
+                          svt_av1_bench::bench_sink += sum);
+        // The pointer of the adaptation of the larger alphabets
+        KERNEL_BENCH_CASE(cases,
+                          "aom_write_symbol/" + syms,
+                          svt_av1_update_cdf,
+                          symbol_count,
+                          AomWriter w;
+                          memcpy(cdfs, init, sizeof(*cdfs) * cdf_count * cdf_stride);
+                          aom_start_encode(&w, out);
+                          w.allow_update_cdf = 1;
+                          for (int i = 0; i < symbol_count; i++) aom_write_symbol(
+                              &w, symbols[i], cdfs + i % cdf_count * cdf_stride, nsyms);
+                          svt_av1_bench::bench_sink += aom_stop_encode(&w));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_entropy_coding_cases);
+
+}  // namespace
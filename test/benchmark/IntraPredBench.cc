@@ -0,0 +1,211 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file IntraPredBench.cc
+ *
+ * @brief Kernel benchmark cases of the intra predictors: the non directional
+ * predictors of every block size, svt_av1_dr_prediction_z1/z2/z3, filter
+ * intra, the edge filters and CfL.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = MAX_SB_SIZE;
+// The predictors read the edges from above[-1] and left[-1] on, up to w + h
+// samples of each
+const int edge_offset = 16;
+const int edge_size = edge_offset + 2 * MAX_SB_SIZE + 16;
+
+void add_intra_pred_cases(std::vector<BenchCase> &cases) {
+    uint8_t *dst = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    const uint8_t *above = svt_av1_bench::bench_alloc_random(edge_size) + edge_offset;
+    const uint8_t *left = svt_av1_bench::bench_alloc_random(edge_size) + edge_offset;
+    uint16_t *dst16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    const uint16_t *above16 = svt_av1_bench::bench_alloc_random16(edge_size, 10) + edge_offset;
+    const uint16_t *left16 = svt_av1_bench::bench_alloc_random16(edge_size, 10) + edge_offset;
+
+#define INTRA_PRED_CASE(mode, w, h)                                                        \
+    KERNEL_BENCH_CASE(cases,                                                               \
+                      "svt_aom_" #mode "_predictor_" #w "x" #h,                            \
+                      svt_aom_##mode##_predictor_##w##x##h,                                \
+                      w * h,                                                               \
+                      svt_aom_##mode##_predictor_##w##x##h(dst, stride, above, left));     \
+    KERNEL_BENCH_CASE(cases,                                                               \
+                      "svt_aom_highbd_" #mode "_predictor_" #w "x" #h "/10bit",            \
+                      svt_aom_highbd_##mode##_predictor_##w##x##h,                         \
+                      w * h,                                                               \
+                      svt_aom_highbd_##mode##_predictor_##w##x##h(                         \
+                          dst16, stride, above16, left16, 10))
+
+#define INTRA_PRED_CASES(bw, bh)       \
+    INTRA_PRED_CASE(dc, bw, bh);       \
+    INTRA_PRED_CASE(dc_left, bw, bh);  \
+    INTRA_PRED_CASE(dc_top, bw, bh);   \
+    INTRA_PRED_CASE(dc_128, bw, bh);   \
+    INTRA_PRED_CASE(v, bw, bh);        \
+    INTRA_PRED_CASE(h, bw, bh);        \
+    INTRA_PRED_CASE(smooth, bw, bh);   \
+    INTRA_PRED_CASE(smooth_v, bw, bh); \
+    INTRA_PRED_CASE(smooth_h, bw, bh); \
+    INTRA_PRED_CASE(paeth, bw, bh)
+
+    INTRA_PRED_CASES(4, 4);
+    INTRA_PRED_CASES(4, 8);
+    INTRA_PRED_CASES(4, 16);
+    INTRA_PRED_CASES(8, 4);
+    INTRA_PRED_CASES(8, 8);
+    INTRA_PRED_CASES(8, 16);
+    INTRA_PRED_CASES(8, 32);
+    INTRA_PRED_CASES(16, 4);
+    INTRA_PRED_CASES(16, 8);
+    INTRA_PRED_CASES(16, 16);
+    INTRA_PRED_CASES(16, 32);
+    INTRA_PRED_CASES(16, 64);
+    INTRA_PRED_CASES(32, 8);
+    INTRA_PRED_CASES(32, 16);
+    INTRA_PRED_CASES(32, 32);
+    INTRA_PRED_CASES(32, 64);
+    INTRA_PRED_CASES(64, 16);
+    INTRA_PRED_CASES(64, 32);
+    INTRA_PRED_CASES(64, 64);
+#undef INTRA_PRED_CASES
+#undef INTRA_PRED_CASE
+
+    // 45, 135 and 225 degrees, one step of dr_intra_derivative[] per row/column
+    const int32_t dx = 64;
+    const int32_t dy = 64;
+    for (int w = 4; w <= 64; w *= 2) {
+        for (int h = w / 2 < 4 ? 4 : w / 2; h <= 2 * w && h <= 64; h *= 2) {
+            const std::string dims = std::to_string(w) + "x" + std::to_string(h);
+
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_dr_prediction_z1/" + dims,
+                              svt_av1_dr_prediction_z1,
+                              w * h,
+                              svt_av1_dr_prediction_z1(dst, stride, w, h, above, left, 0, dx, 0));
+            KERNEL_BENCH_CASE(
+                cases,
+                "svt_av1_dr_prediction_z2/" + dims,
+                svt_av1_dr_prediction_z2,
+                w * h,
+                svt_av1_dr_prediction_z2(dst, stride, w, h, above, left, 0, 0, dx, dy));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_dr_prediction_z3/" + dims,
+                              svt_av1_dr_prediction_z3,
+                              w * h,
+                              svt_av1_dr_prediction_z3(dst, stride, w, h, above, left, 0, 0, dy));
+            KERNEL_BENCH_CASE(
+                cases,
+                "svt_av1_highbd_dr_prediction_z1/" + dims + "/10bit",
+                svt_av1_highbd_dr_prediction_z1,
+                w * h,
+                svt_av1_highbd_dr_prediction_z1(
+                    dst16, stride, w, h, above16, left16, 0, dx, 0, 10));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_highbd_dr_prediction_z2/" + dims + "/10bit",
+                              svt_av1_highbd_dr_prediction_z2,
+                              w * h,
+                              svt_av1_highbd_dr_prediction_z2(
+                                  dst16, stride, w, h, above16, left16, 0, 0, dx, dy, 10));
+            KERNEL_BENCH_CASE(
+                cases,
+                "svt_av1_highbd_dr_prediction_z3/" + dims + "/10bit",
+                svt_av1_highbd_dr_prediction_z3,
+                w * h,
+                svt_av1_highbd_dr_prediction_z3(
+                    dst16, stride, w, h, above16, left16, 0, 0, dy, 10));
+        }
+    }
+
+    // Filter intra is restricted to blocks up to 32x32
+    const TxSize filter_intra_sizes[] = {TX_4X4, TX_8X8, TX_16X16, TX_32X32, TX_16X8, TX_8X32};
+    for (const TxSize tx_size : filter_intra_sizes) {
+        const int w = tx_size_wide[tx_size];
+        const int h = tx_size_high[tx_size];
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_filter_intra_predictor/" + std::to_string(w) + "x" +
+                              std::to_string(h),
+                          svt_av1_filter_intra_predictor,
+                          w * h,
+                          svt_av1_filter_intra_predictor(
+                              dst, stride, tx_size, above, left, FILTER_PAETH_PRED));
+    }
+
+    // The edge filters work in place, a copy of the edge keeps it from
+    // saturating over the iterations
+    uint8_t *edge = svt_av1_bench::bench_alloc_random(edge_size) + edge_offset;
+    for (int sz = 17; sz <= 129; sz = 2 * sz - 1) {
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_filter_intra_edge/" + std::to_string(sz),
+                          svt_av1_filter_intra_edge,
+                          sz,
+                          memcpy(edge - 1, above - 1, sz + 1);
+                          svt_av1_filter_intra_edge(edge, sz, 3));
+    }
+    // Upsampling is limited to the edges of blocks with w + h <= 16
+    for (int sz = 4; sz <= 16; sz *= 2) {
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_upsample_intra_edge/" + std::to_string(sz),
+                          svt_av1_upsample_intra_edge,
+                          sz,
+                          memcpy(edge - 1, above - 1, sz + 1);
+                          svt_av1_upsample_intra_edge(edge, sz));
+    }
+
+    // CfL predicts chroma blocks up to 32x32 from the subsampled luma of the
+    // CFL_BUF_LINE wide buffer
+    const uint8_t *luma = svt_av1_bench::bench_alloc_random(stride * 64);
+    const uint16_t *luma16 = svt_av1_bench::bench_alloc_random16(stride * 64, 10);
+    int16_t *pred_buf_q3 = (int16_t *)svt_av1_bench::bench_alloc_random16(CFL_BUF_LINE * 32, 9);
+    for (int w = 4; w <= 32; w *= 2) {
+        for (int h = w / 2 < 4 ? 4 : w / 2; h <= 2 * w && h <= 32; h *= 2) {
+            const std::string dims = std::to_string(w) + "x" + std::to_string(h);
+
+            KERNEL_BENCH_CASE(cases,
+                              "svt_cfl_luma_subsampling_420_lbd/" + dims,
+                              svt_cfl_luma_subsampling_420_lbd,
+                              4 * w * h,
+                              svt_cfl_luma_subsampling_420_lbd(
+                                  luma, stride, pred_buf_q3, 2 * w, 2 * h));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_cfl_luma_subsampling_420_hbd/" + dims + "/10bit",
+                              svt_cfl_luma_subsampling_420_hbd,
+                              4 * w * h,
+                              svt_cfl_luma_subsampling_420_hbd(
+                                  luma16, stride, pred_buf_q3, 2 * w, 2 * h));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_cfl_predict_lbd/" + dims,
+                              svt_cfl_predict_lbd,
+                              w * h,
+                              svt_cfl_predict_lbd(
+                                  pred_buf_q3, dst, stride, dst, stride, -5, 8, w, h));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_cfl_predict_hbd/" + dims + "/10bit",
+                              svt_cfl_predict_hbd,
+                              w * h,
+                              svt_cfl_predict_hbd(
+                                  pred_buf_q3, dst16, stride, dst16, stride, -5, 10, w, h));
+        }
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_intra_pred_cases);
+
+}  // namespace
@@ -0,0 +1,363 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file KernelBench.cc
+ *
+ * @brief Kernel benchmark of the RTCD dispatched functions.
+ *
+ * For every instruction set level supported by the CPU, the RTCD tables are
+ * set up with the flags of that level and every case whose pointer changed
+ * is timed. The output reports ns per call, cycles per pixel, millions of
+ * pixels per second and the speedup over the c version, and can be written as
+ * JSON with --benchmark_out.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BENCH_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#else
+#define BENCH_HAS_TSC 0
+#endif
+#include "aom_dsp_rtcd.h"
+#include "KernelBench.h"
+
+namespace svt_av1_bench {
+
+volatile uint64_t bench_sink;
+
+static std::vector<BenchFamilyFunc> &bench_families() {
+    static std::vector<BenchFamilyFunc> families;
+    return families;
+}
+
+BenchFamilyRegistrar::BenchFamilyRegistrar(BenchFamilyFunc func) {
+    bench_families().push_back(func);
+}
+
+std::vector<BenchCase> create_bench_cases() {
+    std::vector<BenchCase> cases;
+    for (size_t i = 0; i < bench_families().size(); i++)
+        bench_families()[i](cases);
+    return cases;
+}
+
+static std::vector<std::unique_ptr<uint8_t[]>> bench_buffers;
+static uint32_t bench_seed = 0x1234567;
+
+static uint32_t bench_random() {
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+    return bench_seed;
+}
+
+static void *bench_alloc(size_t size) {
+    const uintptr_t align = 64;
+    bench_buffers.emplace_back(new uint8_t[size + align]);
+    return (void *)(((uintptr_t)bench_buffers.back().get() + align - 1) & ~(align - 1));
+}
+
+uint8_t *bench_alloc_random(size_t count) {
+    uint8_t *buf = (uint8_t *)bench_alloc(count);
+    for (size_t i = 0; i < count; i++)
+        buf[i] = (uint8_t)bench_random();
+    return buf;
+}
+
+uint16_t *bench_alloc_random16(size_t count, uint32_t bits) {
+    uint16_t *buf = (uint16_t *)bench_alloc(count * sizeof(*buf));
+    for (size_t i = 0; i < count; i++)
+        buf[i] = (uint16_t)(bench_random() & ((1u << bits) - 1));
+    return buf;
+}
+
+int32_t *bench_alloc_random32(size_t count, uint32_t bits) {
+    int32_t *buf = (int32_t *)bench_alloc(count * sizeof(*buf));
+    for (size_t i = 0; i < count; i++)
+        buf[i] = (int32_t)(bench_random() & ((1u << bits) - 1)) - (1 << (bits - 1));
+    return buf;
+}
+
+}  // namespace svt_av1_bench
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+#define FLAGS_SSE2 (HAS_MMX | HAS_SSE | HAS_SSE2)
+#define FLAGS_SSSE3 (FLAGS_SSE2 | HAS_SSE3 | HAS_SSSE3)
+#define FLAGS_SSE4_1 (FLAGS_SSSE3 | HAS_SSE4_1)
+#define FLAGS_SSE4_2 (FLAGS_SSE4_1 | HAS_SSE4_2)
+#define FLAGS_AVX2 (FLAGS_SSE4_2 | HAS_AVX | HAS_AVX2)
+#define FLAGS_AVX512 \
+    (FLAGS_AVX2 | HAS_AVX512F | HAS_AVX512CD | HAS_AVX512DQ | HAS_AVX512BW | HAS_AVX512VL)
+
+struct IsaLevel {
+    const char *name;
+    CPU_FLAGS flags;
+};
+
+/** The levels set up in turn, each one a superset of the previous one */
+const IsaLevel isa_levels[] = {{"c", 0},
+                               {"sse2", FLAGS_SSE2},
+                               {"ssse3", FLAGS_SSSE3},
+                               {"sse4_1", FLAGS_SSE4_1},
+                               {"sse4_2", FLAGS_SSE4_2},
+                               {"avx2", FLAGS_AVX2},
+                               {"avx512", FLAGS_AVX512}};
+
+struct BenchResult {
+    size_t case_index;
+    const char *isa;
+    uint64_t iterations;
+    double ns_per_call;
+    double cycles_per_call;  // 0 without a time stamp counter
+    double speedup;          // over the c version
+};
+
+struct BenchOptions {
+    std::string filter;
+    double min_time;
+    std::string out_file;
+    bool list_tests;
+};
+
+uint64_t read_tsc() {
+#if BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/** Runs the case in batches until a batch lasts min_time seconds and takes
+ * the times of that batch */
+void time_case(const BenchCase &bench_case, double min_time, BenchResult *result) {
+    typedef std::chrono::steady_clock Clock;
+    uint64_t iterations = 1;
+
+    for (int i = 0; i < 16; i++)
+        bench_case.run();
+    for (;;) {
+        const Clock::time_point start = Clock::now();
+        const uint64_t start_tsc = read_tsc();
+        for (uint64_t i = 0; i < iterations; i++)
+            bench_case.run();
+        const uint64_t tsc = read_tsc() - start_tsc;
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (elapsed >= min_time || iterations >= (1ull << 32)) {
+            result->iterations = iterations;
+            result->ns_per_call = elapsed * 1e9 / iterations;
+            result->cycles_per_call = (double)tsc / iterations;
+            return;
+        }
+        // Aim 40% over min_time, growing at most 10 times per batch
+        double multiplier = elapsed > 0 ? 1.4 * min_time / elapsed : 10;
+        if (multiplier > 10)
+            multiplier = 10;
+        const uint64_t next = (uint64_t)(iterations * multiplier);
+        iterations = next > iterations ? next : iterations + 1;
+    }
+}
+
+void print_usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --benchmark_filter=<regex>    Run the kernels whose name matches\n"
+            "  --benchmark_min_time=<sec>    Minimum time per kernel and level "
+            "[default 0.05]\n"
+            "  --benchmark_out=<file>        Write the results as JSON\n"
+            "  --benchmark_list_tests        List the kernel names and exit\n",
+            name);
+}
+
+bool parse_options(int argc, char **argv, BenchOptions *options) {
+    options->min_time = 0.05;
+    options->list_tests = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (key == "--benchmark_filter" && eq != std::string::npos)
+            options->filter = value;
+        else if (key == "--benchmark_min_time" && eq != std::string::npos) {
+            options->min_time = atof(value.c_str());
+            if (options->min_time <= 0)
+                return false;
+        } else if (key == "--benchmark_out" && !value.empty())
+            options->out_file = value;
+        else if (arg == "--benchmark_list_tests")
+            options->list_tests = true;
+        else
+            return false;
+    }
+    return true;
+}
+
+bool write_json(const char *file_name, const BenchOptions &options,
+                CPU_FLAGS cpu_flags, const std::vector<BenchCase> &cases,
+                const std::vector<BenchResult> &results) {
+    FILE *f = fopen(file_name, "w");
+    char date[64];
+    const time_t now = time(NULL);
+
+    if (!f)
+        return false;
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    fprintf(f,
+            "{\n  \"context\": {\n    \"date\": \"%s\",\n"
+            "    \"num_cpus\": %u,\n    \"cpu_flags\": \"0x%llx\",\n"
+            "    \"min_time\": %g,\n    \"tsc\": %s\n  },\n  \"benchmarks\": [",
+            date,
+            std::thread::hardware_concurrency(),
+            (unsigned long long)cpu_flags,
+            options.min_time,
+            BENCH_HAS_TSC ? "true" : "false");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &result = results[i];
+        const BenchCase &bench_case = cases[result.case_index];
+        fprintf(f,
+                "%s\n    {\n      \"name\": \"%s/%s\",\n      \"kernel\": \"%s\",\n"
+                "      \"isa\": \"%s\",\n      \"iterations\": %llu,\n"
+                "      \"real_time\": %.3f,\n      \"time_unit\": \"ns\",\n"
+                "      \"pixels\": %llu,\n      \"cycles_per_pixel\": %.4f,\n"
+                "      \"items_per_second\": %.0f,\n      \"speedup\": %.3f\n    }",
+                i ? "," : "",
+                bench_case.name.c_str(),
+                result.isa,
+                bench_case.name.c_str(),
+                result.isa,
+                (unsigned long long)result.iterations,
+                result.ns_per_call,
+                (unsigned long long)bench_case.pixels,
+                result.cycles_per_call / bench_case.pixels,
+                bench_case.pixels * 1e9 / result.ns_per_call,
+                result.speedup);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+
+    if (!parse_options(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<BenchCase> cases;
+    {
+        std::vector<BenchCase> all_cases = svt_av1_bench::create_bench_cases();
+        const std::regex filter(options.filter);
+        for (size_t i = 0; i < all_cases.size(); i++) {
+            if (std::regex_search(all_cases[i].name, filter))
+                cases.push_back(all_cases[i]);
+        }
+    }
+    if (options.list_tests) {
+        for (size_t i = 0; i < cases.size(); i++)
+            printf("%s\n", cases[i].name.c_str());
+        return 0;
+    }
+
+#ifdef ARCH_X86_64
+    const CPU_FLAGS cpu_flags = get_cpu_flags_to_use();
+#else
+    const CPU_FLAGS cpu_flags = 0;
+#endif
+    std::vector<const void *> last_function(cases.size(), nullptr);
+    std::vector<double> c_ns_per_call(cases.size(), 0);
+    std::vector<BenchResult> results;
+
+    for (size_t level = 0; level < sizeof(isa_levels) / sizeof(isa_levels[0]); level++) {
+        const IsaLevel &isa = isa_levels[level];
+        size_t timed = 0;
+
+        if ((isa.flags & cpu_flags) != isa.flags)
+            continue;
+        setup_common_rtcd_internal(isa.flags);
+        setup_rtcd_internal(isa.flags);
+        for (size_t i = 0; i < cases.size(); i++) {
+            // Only the levels with a version of their own
+            const void *function = cases[i].dispatched();
+            if (function == last_function[i])
+                continue;
+            last_function[i] = function;
+
+            BenchResult result;
+            result.case_index = i;
+            result.isa = isa.name;
+            time_case(cases[i], options.min_time, &result);
+            if (!isa.flags)
+                c_ns_per_call[i] = result.ns_per_call;
+            result.speedup = c_ns_per_call[i] / result.ns_per_call;
+            results.push_back(result);
+            timed++;
+        }
+        fprintf(stderr, "%s: %u kernels\n", isa.name, (unsigned)timed);
+    }
+
+    // Group the levels of each kernel
+    std::stable_sort(results.begin(),
+                     results.end(),
+                     [](const BenchResult &a, const BenchResult &b) {
+                         return a.case_index < b.case_index;
+                     });
+    printf("%-48s %-7s %12s %12s %13s %10s %8s\n",
+           "Kernel",
+           "ISA",
+           "Time(ns)",
+           "Iterations",
+           "Cycles/pixel",
+           "Mpixels/s",
+           "Speedup");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &result = results[i];
+        const BenchCase &bench_case = cases[result.case_index];
+        printf("%-48s %-7s %12.1f %12llu %13.4f %10.1f %7.2fx\n",
+               bench_case.name.c_str(),
+               result.isa,
+               result.ns_per_call,
+               (unsigned long long)result.iterations,
+               result.cycles_per_call / bench_case.pixels,
+               bench_case.pixels * 1e3 / result.ns_per_call,
+               result.speedup);
+    }
+
+    if (!options.out_file.empty() &&
+        !write_json(options.out_file.c_str(), options, cpu_flags, cases, results)) {
+        fprintf(stderr, "Error: could not write %s\n", options.out_file.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file KernelBench.h
+ *
+ * @brief Registry of the kernel benchmark cases.
+ *
+ * A case calls one RTCD function pointer on buffers prepared by its family.
+ * The harness runs setup_common_rtcd_internal()/setup_rtcd_internal() once
+ * per instruction set level, so the pointer resolves to the c, sse2, ...,
+ * avx512 version in turn, and times every level that changes the pointer.
+ *
+ ******************************************************************************/
+
+#ifndef KernelBench_h
+#define KernelBench_h
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace svt_av1_bench {
+
+struct BenchCase {
+    /** kernel name, the RTCD pointer followed by the parameters, e.g.
+     * svt_av1_highbd_convolve_2d_sr/16x16/10bit */
+    std::string name;
+    /** pixels (or coefficients, symbols) processed by one call */
+    uint64_t pixels;
+    /** returns the function the RTCD pointer currently resolves to */
+    std::function<const void *()> dispatched;
+    /** calls the RTCD pointer once */
+    std::function<void()> run;
+};
+
+typedef void (*BenchFamilyFunc)(std::vector<BenchCase> &cases);
+
+/** Registers a family of cases, see KERNEL_BENCH_FAMILY */
+struct BenchFamilyRegistrar {
+    explicit BenchFamilyRegistrar(BenchFamilyFunc func);
+};
+
+/** Returns the cases of all the registered families */
+std::vector<BenchCase> create_bench_cases();
+
+/** Keeps the results of the benchmarked calls alive */
+extern volatile uint64_t bench_sink;
+
+/** Random sample buffers, 64 byte aligned and released at exit. The 16 bit
+ * samples are below 1 << bits, the 32 bit ones within +/-(1 << (bits - 1)). */
+uint8_t *bench_alloc_random(size_t count);
+uint16_t *bench_alloc_random16(size_t count, uint32_t bits);
+int32_t *bench_alloc_random32(size_t count, uint32_t bits);
+
+}  // namespace svt_av1_bench
+
+#define KERNEL_BENCH_FAMILY(func)                                   \
+    static const svt_av1_bench::BenchFamilyRegistrar func##_registrar( \
+        func)
+
+/** Case calling the RTCD pointer ptr, the remaining arguments are the
+ * statements of one call, run in a lambda capturing by value */
+#define KERNEL_BENCH_CASE(cases, case_name, ptr, case_pixels, ...) \
+    do {                                                            \
+        svt_av1_bench::BenchCase bench_case;                        \
+        bench_case.name = (case_name);                              \
+        bench_case.pixels = (case_pixels);                          \
+        bench_case.dispatched = []() { return (const void *)ptr; }; \
+        bench_case.run = [=]() { __VA_ARGS__; };                    \
+        (cases).push_back(bench_case);                              \
+    } while (0)
+
+#endif  // KernelBench_h
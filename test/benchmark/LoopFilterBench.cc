@@ -0,0 +1,155 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file LoopFilterBench.cc
+ *
+ * @brief Kernel benchmark cases of the deblocking filters svt_aom_lpf_* and of
+ * CDEF: svt_cdef_find_dir, svt_cdef_filter_block, the 16 bit copy and the
+ * distortion of the CDEF search.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "aom_dsp_rtcd.h"
+#include "EbCdef.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = 64;
+// The 14 tap filter reads and writes 7 samples on each side of the edge
+const int border = 8;
+
+void add_loop_filter_cases(std::vector<BenchCase> &cases) {
+    const int rows = 2 * border + 16;
+    uint8_t *buf = svt_av1_bench::bench_alloc_random(stride * rows) + border * stride + border;
+    uint16_t *buf16 =
+        svt_av1_bench::bench_alloc_random16(stride * rows, 10) + border * stride + border;
+    // The SIMD versions load the thresholds as 16 byte vectors
+    uint8_t *blimit = svt_av1_bench::bench_alloc_random(16);
+    uint8_t *limit = svt_av1_bench::bench_alloc_random(16);
+    uint8_t *thresh = svt_av1_bench::bench_alloc_random(16);
+    memset(blimit, 60, 16);
+    memset(limit, 20, 16);
+    memset(thresh, 8, 16);
+
+    // Each call filters the 4 samples long segment of an edge, the random
+    // samples are rewritten by the filter and stay within the thresholds
+    // for some of the segments only
+#define LPF_CASES(dir, taps)                                                             \
+    KERNEL_BENCH_CASE(cases,                                                             \
+                      "svt_aom_lpf_" #dir "_" #taps,                                     \
+                      svt_aom_lpf_##dir##_##taps,                                        \
+                      4,                                                                 \
+                      svt_aom_lpf_##dir##_##taps(buf, stride, blimit, limit, thresh));   \
+    KERNEL_BENCH_CASE(cases,                                                             \
+                      "svt_aom_highbd_lpf_" #dir "_" #taps "/10bit",                     \
+                      svt_aom_highbd_lpf_##dir##_##taps,                                 \
+                      4,                                                                 \
+                      svt_aom_highbd_lpf_##dir##_##taps(                                 \
+                          buf16, stride, blimit, limit, thresh, 10))
+
+    LPF_CASES(horizontal, 4);
+    LPF_CASES(horizontal, 6);
+    LPF_CASES(horizontal, 8);
+    LPF_CASES(horizontal, 14);
+    LPF_CASES(vertical, 4);
+    LPF_CASES(vertical, 6);
+    LPF_CASES(vertical, 8);
+    LPF_CASES(vertical, 14);
+#undef LPF_CASES
+}
+
+void add_cdef_cases(std::vector<BenchCase> &cases) {
+    // The input of the filter is the 16 bit copy of a 64x64 filter block with
+    // CDEF_VBORDER rows and CDEF_HBORDER columns around it
+    const uint16_t *in = svt_av1_bench::bench_alloc_random16(CDEF_INBUF_SIZE, 8) +
+        CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
+    const uint16_t *in10 = svt_av1_bench::bench_alloc_random16(CDEF_INBUF_SIZE, 10) +
+        CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
+    uint8_t *dst = svt_av1_bench::bench_alloc_random(stride * 64);
+    uint16_t *dst16 = svt_av1_bench::bench_alloc_random16(stride * 64, 10);
+    int32_t *var = svt_av1_bench::bench_alloc_random32(1, 8);
+
+    KERNEL_BENCH_CASE(cases,
+                      "svt_cdef_find_dir",
+                      svt_cdef_find_dir,
+                      64,
+                      svt_av1_bench::bench_sink += svt_cdef_find_dir(in, CDEF_BSTRIDE, var, 0));
+    KERNEL_BENCH_CASE(cases,
+                      "svt_cdef_find_dir/10bit",
+                      svt_cdef_find_dir,
+                      64,
+                      svt_av1_bench::bench_sink += svt_cdef_find_dir(in10, CDEF_BSTRIDE, var, 2));
+
+    const BlockSize cdef_sizes[] = {BLOCK_8X8, BLOCK_4X8, BLOCK_8X4, BLOCK_4X4};
+    for (const BlockSize bsize : cdef_sizes) {
+        const int w = block_size_wide[bsize];
+        const int h = block_size_high[bsize];
+        const std::string dims = std::to_string(w) + "x" + std::to_string(h);
+
+        KERNEL_BENCH_CASE(cases,
+                          "svt_cdef_filter_block/" + dims,
+                          svt_cdef_filter_block,
+                          w * h,
+                          svt_cdef_filter_block(dst, NULL, stride, in, 4, 2, 3, 6, 6, bsize, 0));
+        KERNEL_BENCH_CASE(
+            cases,
+            "svt_cdef_filter_block/" + dims + "/10bit",
+            svt_cdef_filter_block,
+            w * h,
+            svt_cdef_filter_block(NULL, dst16, stride, in10, 16, 8, 3, 8, 8, bsize, 2));
+    }
+
+    uint16_t *copy16 = svt_av1_bench::bench_alloc_random16(CDEF_INBUF_SIZE, 8);
+    KERNEL_BENCH_CASE(cases,
+                      "svt_copy_rect8_8bit_to_16bit/64x64",
+                      svt_copy_rect8_8bit_to_16bit,
+                      64 * 64,
+                      svt_copy_rect8_8bit_to_16bit(copy16, CDEF_BSTRIDE, dst, stride, 64, 64));
+
+    // The distortion of a whole filter block, 64 blocks of 8x8 with the
+    // filtered samples packed in block order
+    std::shared_ptr<std::vector<CdefList>> dlist(new std::vector<CdefList>(64));
+    for (int i = 0; i < 64; i++) {
+        (*dlist)[i].by = i >> 3;
+        (*dlist)[i].bx = i & 7;
+        (*dlist)[i].skip = 0;
+    }
+    const uint8_t *filtered = svt_av1_bench::bench_alloc_random(64 * 64);
+    const uint16_t *filtered16 = svt_av1_bench::bench_alloc_random16(64 * 64, 10);
+    for (int pli = 0; pli < 2; pli++) {
+        const std::string plane = pli ? "/chroma" : "/luma";
+        KERNEL_BENCH_CASE(cases,
+                          "svt_compute_cdef_dist_8bit/64x64" + plane,
+                          svt_compute_cdef_dist_8bit,
+                          64 * 64,
+                          svt_av1_bench::bench_sink += svt_compute_cdef_dist_8bit(
+                              dst, stride, filtered, dlist->data(), 64, BLOCK_8X8, 0, pli));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_compute_cdef_dist_16bit/64x64" + plane + "/10bit",
+                          svt_compute_cdef_dist_16bit,
+                          64 * 64,
+                          svt_av1_bench::bench_sink += svt_compute_cdef_dist_16bit(
+                              dst16, stride, filtered16, dlist->data(), 64, BLOCK_8X8, 2, pli));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_loop_filter_cases);
+KERNEL_BENCH_FAMILY(add_cdef_cases);
+
+}  // namespace
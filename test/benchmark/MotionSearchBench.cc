@@ -0,0 +1,278 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+
+/******************************************************************************
+ * @file MotionSearchBench.cc
+ *
+ * @brief Kernel benchmark cases of the motion search besides svt_aom_sadWxH:
+ * the OBMC distortions, the full pel search loops of motion estimation, the
+ * 16 bit SAD and MSE, and the block statistics of picture analysis.
+ *
+ ******************************************************************************/
+
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = 256;
+
+void add_obmc_cases(std::vector<BenchCase> &cases) {
+    // The sub pel variances read one more row and column than the block
+    const uint8_t *pre = svt_av1_bench::bench_alloc_random(stride * (128 + 1));
+    // The weighted source and the mask of the overlapped prediction, w * h
+    // values with the stride of the block width
+    const int32_t *wsrc = svt_av1_bench::bench_alloc_random32(128 * 128, 20);
+    const int32_t *mask = svt_av1_bench::bench_alloc_random32(128 * 128, 12);
+    unsigned int *sse = (unsigned int *)svt_av1_bench::bench_alloc_random32(1, 8);
+
+#define OBMC_CASES(w, h)                                                                        \
+    KERNEL_BENCH_CASE(cases,                                                                    \
+                      "svt_aom_obmc_sad" #w "x" #h,                                             \
+                      svt_aom_obmc_sad##w##x##h,                                                \
+                      w * h,                                                                    \
+                      svt_av1_bench::bench_sink +=                                              \
+                      svt_aom_obmc_sad##w##x##h(pre, stride, wsrc, mask));                      \
+    KERNEL_BENCH_CASE(cases,                                                                    \
+                      "svt_aom_obmc_variance" #w "x" #h,                                        \
+                      svt_aom_obmc_variance##w##x##h,                                           \
+                      w * h,                                                                    \
+                      svt_av1_bench::bench_sink +=                                              \
+                      svt_aom_obmc_variance##w##x##h(pre, stride, wsrc, mask, sse));            \
+    KERNEL_BENCH_CASE(cases,                                                                    \
+                      "svt_aom_obmc_sub_pixel_variance" #w "x" #h,                              \
+                      svt_aom_obmc_sub_pixel_variance##w##x##h,                                 \
+                      w * h,                                                                    \
+                      svt_av1_bench::bench_sink += svt_aom_obmc_sub_pixel_variance##w##x##h(    \
+                          pre, stride, 4, 4, wsrc, mask, sse))
+
+    OBMC_CASES(4, 4);
+    OBMC_CASES(4, 8);
+    OBMC_CASES(4, 16);
+    OBMC_CASES(8, 4);
+    OBMC_CASES(8, 8);
+    OBMC_CASES(8, 16);
+    OBMC_CASES(8, 32);
+    OBMC_CASES(16, 4);
+    OBMC_CASES(16, 8);
+    OBMC_CASES(16, 16);
+    OBMC_CASES(16, 32);
+    OBMC_CASES(16, 64);
+    OBMC_CASES(32, 8);
+    OBMC_CASES(32, 16);
+    OBMC_CASES(32, 32);
+    OBMC_CASES(32, 64);
+    OBMC_CASES(64, 16);
+    OBMC_CASES(64, 32);
+    OBMC_CASES(64, 64);
+    OBMC_CASES(64, 128);
+    OBMC_CASES(128, 64);
+    OBMC_CASES(128, 128);
+#undef OBMC_CASES
+}
+
+void add_me_sad_cases(std::vector<BenchCase> &cases) {
+    uint8_t *src = svt_av1_bench::bench_alloc_random(stride * 128);
+    uint8_t *ref = svt_av1_bench::bench_alloc_random(stride * (128 + 64));
+    uint16_t *src16 = svt_av1_bench::bench_alloc_random16(stride * 128, 10);
+    uint16_t *ref16 = svt_av1_bench::bench_alloc_random16(stride * 128, 10);
+    uint64_t *best_sad64 = (uint64_t *)svt_av1_bench::bench_alloc_random32(2, 8);
+    int16_t *search_center = (int16_t *)svt_av1_bench::bench_alloc_random16(2, 8);
+
+    // The search areas of the hierarchical motion estimation, the reference
+    // rows are src_stride_raw apart
+    const int16_t search_area_width = 64;
+    const int16_t search_area_height = 16;
+    for (int size = 8; size <= 64; size *= 2) {
+        KERNEL_BENCH_CASE(cases,
+                          "svt_sad_loop_kernel/" + std::to_string(size) + "x" +
+                              std::to_string(size) + "/64x16",
+                          svt_sad_loop_kernel,
+                          size * size * search_area_width * search_area_height,
+                          svt_sad_loop_kernel(src,
+                                              stride,
+                                              ref,
+                                              stride,
+                                              size,
+                                              size,
+                                              best_sad64,
+                                              search_center,
+                                              search_center + 1,
+                                              stride,
+                                              search_area_width,
+                                              search_area_height));
+    }
+
+    for (int w = 4; w <= 128; w *= 2) {
+        for (int h = w / 2 < 4 ? 4 : w / 2; h <= 2 * w && h <= 128; h *= 2) {
+            const std::string dims = std::to_string(w) + "x" + std::to_string(h);
+            KERNEL_BENCH_CASE(cases,
+                              "svt_nxm_sad_kernel/" + dims,
+                              svt_nxm_sad_kernel,
+                              w * h,
+                              svt_av1_bench::bench_sink +=
+                              svt_nxm_sad_kernel(src, stride, ref, stride, h, w));
+            // Every other row, the source and reference strides are doubled
+            // by the caller
+            KERNEL_BENCH_CASE(cases,
+                              "svt_nxm_sad_kernel_sub_sampled/" + dims,
+                              svt_nxm_sad_kernel_sub_sampled,
+                              w * h / 2,
+                              svt_av1_bench::bench_sink += svt_nxm_sad_kernel_sub_sampled(
+                                  src, 2 * stride, ref, 2 * stride, h / 2, w));
+            KERNEL_BENCH_CASE(cases,
+                              "sad_16b_kernel/" + dims + "/10bit",
+                              sad_16b_kernel,
+                              w * h,
+                              svt_av1_bench::bench_sink +=
+                              sad_16b_kernel(src16, stride, ref16, stride, h, w));
+        }
+    }
+
+    // The SADs of the 8x8 to 64x64 blocks of a 64x64 block at one position,
+    // or 8 positions 1 pel apart, with the best SAD and MV of each block
+    uint32_t *best_sad = (uint32_t *)svt_av1_bench::bench_alloc_random32(64 + 16 + 4 + 1, 8);
+    uint32_t *best_mv = (uint32_t *)svt_av1_bench::bench_alloc_random32(64 + 16 + 4 + 1, 8);
+    uint32_t *sad = (uint32_t *)svt_av1_bench::bench_alloc_random32(64 + 16 + 4, 8);
+    uint32_t(*eight_sad8x8)[8] =
+        (uint32_t(*)[8])svt_av1_bench::bench_alloc_random32(64 * 8, 8);
+    uint32_t(*eight_sad16x16)[8] =
+        (uint32_t(*)[8])svt_av1_bench::bench_alloc_random32(16 * 8, 8);
+    uint32_t(*eight_sad32x32)[8] =
+        (uint32_t(*)[8])svt_av1_bench::bench_alloc_random32(4 * 8, 8);
+    const uint32_t mv = 0;
+
+    for (int sub_sad = 0; sub_sad < 2; sub_sad++) {
+        const std::string sub = sub_sad ? "/sub_sad" : "";
+        KERNEL_BENCH_CASE(cases,
+                          "svt_ext_sad_calculation_8x8_16x16" + sub,
+                          svt_ext_sad_calculation_8x8_16x16,
+                          16 * 16,
+                          svt_ext_sad_calculation_8x8_16x16(src,
+                                                            stride,
+                                                            ref,
+                                                            stride,
+                                                            best_sad,
+                                                            best_sad + 64,
+                                                            best_mv,
+                                                            best_mv + 64,
+                                                            mv,
+                                                            sad + 64,
+                                                            sad,
+                                                            (EbBool)sub_sad));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_ext_all_sad_calculation_8x8_16x16" + sub,
+                          svt_ext_all_sad_calculation_8x8_16x16,
+                          8 * 64 * 64,
+                          svt_ext_all_sad_calculation_8x8_16x16(src,
+                                                                stride,
+                                                                ref,
+                                                                stride,
+                                                                mv,
+                                                                best_sad,
+                                                                best_sad + 64,
+                                                                best_mv,
+                                                                best_mv + 64,
+                                                                eight_sad16x16,
+                                                                eight_sad8x8,
+                                                                (EbBool)sub_sad));
+    }
+    KERNEL_BENCH_CASE(cases,
+                      "svt_ext_sad_calculation_32x32_64x64",
+                      svt_ext_sad_calculation_32x32_64x64,
+                      64 * 64,
+                      svt_ext_sad_calculation_32x32_64x64(sad + 64,
+                                                          best_sad + 80,
+                                                          best_sad + 84,
+                                                          best_mv + 80,
+                                                          best_mv + 84,
+                                                          mv,
+                                                          sad + 80));
+    KERNEL_BENCH_CASE(cases,
+                      "svt_ext_eight_sad_calculation_32x32_64x64",
+                      svt_ext_eight_sad_calculation_32x32_64x64,
+                      8 * 64 * 64,
+                      svt_ext_eight_sad_calculation_32x32_64x64(eight_sad16x16,
+                                                                best_sad + 80,
+                                                                best_sad + 84,
+                                                                best_mv + 80,
+                                                                best_mv + 84,
+                                                                mv,
+                                                                eight_sad32x32));
+}
+
+void add_block_stats_cases(std::vector<BenchCase> &cases) {
+    uint8_t *src = svt_av1_bench::bench_alloc_random(stride * 64);
+    const uint8_t *ref = svt_av1_bench::bench_alloc_random(stride * 64);
+    uint16_t *src16 = svt_av1_bench::bench_alloc_random16(stride * 64, 10);
+    uint16_t *ref16 = svt_av1_bench::bench_alloc_random16(stride * 64, 10);
+    // svt_aom_highbd_8_mse16x16 takes CONVERT_TO_BYTEPTR() pointers
+    const uint8_t *src16_byteptr = CONVERT_TO_BYTEPTR(src16);
+    const uint8_t *ref16_byteptr = CONVERT_TO_BYTEPTR(ref16);
+    uint32_t *sse = (uint32_t *)svt_av1_bench::bench_alloc_random32(1, 8);
+    uint64_t *means = (uint64_t *)svt_av1_bench::bench_alloc_random32(2 * 8, 8);
+
+    KERNEL_BENCH_CASE(cases,
+                      "svt_aom_mse16x16",
+                      svt_aom_mse16x16,
+                      16 * 16,
+                      svt_av1_bench::bench_sink +=
+                      svt_aom_mse16x16(src, stride, ref, stride, sse));
+    KERNEL_BENCH_CASE(cases,
+                      "svt_aom_highbd_8_mse16x16",
+                      svt_aom_highbd_8_mse16x16,
+                      16 * 16,
+                      svt_aom_highbd_8_mse16x16(src16_byteptr, stride, ref16_byteptr, stride, sse);
+                      svt_av1_bench::bench_sink += *sse);
+    for (int size = 8; size <= 64; size *= 2) {
+        KERNEL_BENCH_CASE(cases,
+                          "variance_highbd/" + std::to_string(size) + "x" + std::to_string(size) +
+                              "/10bit",
+                          variance_highbd,
+                          size * size,
+                          svt_av1_bench::bench_sink +=
+                          variance_highbd(src16, stride, ref16, stride, size, size, sse));
+    }
+
+    // The 8x8 means and means of squares of the picture analysis
+    KERNEL_BENCH_CASE(cases,
+                      "svt_compute_sub_mean_8x8",
+                      svt_compute_sub_mean_8x8,
+                      8 * 8,
+                      svt_av1_bench::bench_sink += svt_compute_sub_mean_8x8(src, stride));
+    KERNEL_BENCH_CASE(cases,
+                      "svt_compute_mean_square_values_8x8",
+                      svt_compute_mean_square_values_8x8,
+                      8 * 8,
+                      svt_av1_bench::bench_sink +=
+                      svt_compute_mean_square_values_8x8(src, stride, 8, 8));
+    KERNEL_BENCH_CASE(cases,
+                      "svt_compute_interm_var_four8x8",
+                      svt_compute_interm_var_four8x8,
+                      4 * 8 * 8,
+                      svt_compute_interm_var_four8x8(src, stride, means, means + 4));
+    KERNEL_BENCH_CASE(cases,
+                      "svt_av1_haar_ac_sad_8x8_uint8_input",
+                      svt_av1_haar_ac_sad_8x8_uint8_input,
+                      8 * 8,
+                      svt_av1_bench::bench_sink +=
+                      svt_av1_haar_ac_sad_8x8_uint8_input(src, stride, 0));
+}
+
+KERNEL_BENCH_FAMILY(add_obmc_cases);
+KERNEL_BENCH_FAMILY(add_me_sad_cases);
+KERNEL_BENCH_FAMILY(add_block_stats_cases);
+
+}  // namespace
@@ -0,0 +1,208 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+
+/******************************************************************************
+ * @file PictureOpsBench.cc
+ *
+ * @brief Kernel benchmark cases of the block operators of the mode decision
+ * and of the 10 bit picture handling: the residuals, the full distortions,
+ * the averaging of bipredictions, the packing and unpacking of the 16 bit
+ * samples, svt_memcpy and aom_sum_squares_i16.
+ *
+ ******************************************************************************/
+
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = MAX_SB_SIZE;
+
+void add_block_ops_cases(std::vector<BenchCase> &cases) {
+    uint8_t *src = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint8_t *pred = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint8_t *dst = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint16_t *src16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    uint16_t *pred16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    int16_t *residual = (int16_t *)svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 8);
+    int32_t *coeff = svt_av1_bench::bench_alloc_random32(stride * MAX_SB_SIZE, 16);
+    int32_t *recon_coeff = svt_av1_bench::bench_alloc_random32(stride * MAX_SB_SIZE, 16);
+    uint64_t *distortion = (uint64_t *)svt_av1_bench::bench_alloc_random32(2 * DIST_CALC_TOTAL, 8);
+
+    for (int size = 4; size <= MAX_SB_SIZE; size *= 2) {
+        const std::string dims = std::to_string(size) + "x" + std::to_string(size);
+        const int pixels = size * size;
+
+        KERNEL_BENCH_CASE(
+            cases,
+            "svt_residual_kernel8bit/" + dims,
+            svt_residual_kernel8bit,
+            pixels,
+            svt_residual_kernel8bit(src, stride, pred, stride, residual, stride, size, size));
+        KERNEL_BENCH_CASE(
+            cases,
+            "svt_residual_kernel16bit/" + dims + "/10bit",
+            svt_residual_kernel16bit,
+            pixels,
+            svt_residual_kernel16bit(src16, stride, pred16, stride, residual, stride, size, size));
+        KERNEL_BENCH_CASE(
+            cases,
+            "svt_aom_subtract_block/" + dims,
+            svt_aom_subtract_block,
+            pixels,
+            svt_aom_subtract_block(size, size, residual, stride, src, stride, pred, stride));
+        // The highbd subtraction takes the 16 bit buffers cast to uint8_t *
+        KERNEL_BENCH_CASE(cases,
+                          "svt_aom_highbd_subtract_block/" + dims + "/10bit",
+                          svt_aom_highbd_subtract_block,
+                          pixels,
+                          svt_aom_highbd_subtract_block(size,
+                                                        size,
+                                                        residual,
+                                                        stride,
+                                                        (const uint8_t *)src16,
+                                                        stride,
+                                                        (const uint8_t *)pred16,
+                                                        stride,
+                                                        10));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_spatial_full_distortion_kernel/" + dims,
+                          svt_spatial_full_distortion_kernel,
+                          pixels,
+                          svt_av1_bench::bench_sink += svt_spatial_full_distortion_kernel(
+                              src, 0, stride, pred, 0, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_full_distortion_kernel16_bits/" + dims + "/10bit",
+                          svt_full_distortion_kernel16_bits,
+                          pixels,
+                          svt_av1_bench::bench_sink +=
+                          svt_full_distortion_kernel16_bits((uint8_t *)src16,
+                                                            0,
+                                                            stride,
+                                                            (uint8_t *)pred16,
+                                                            0,
+                                                            stride,
+                                                            size,
+                                                            size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_picture_average_kernel/" + dims,
+                          svt_picture_average_kernel,
+                          pixels,
+                          svt_picture_average_kernel(
+                              src, stride, pred, stride, dst, stride, size, size));
+
+        // The distortions of the transform domain, up to 64x64 coefficients
+        if (size > 64)
+            continue;
+        KERNEL_BENCH_CASE(cases,
+                          "svt_full_distortion_kernel32_bits/" + dims,
+                          svt_full_distortion_kernel32_bits,
+                          pixels,
+                          svt_full_distortion_kernel32_bits(
+                              coeff, size, recon_coeff, size, distortion, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_full_distortion_kernel_cbf_zero32_bits/" + dims,
+                          svt_full_distortion_kernel_cbf_zero32_bits,
+                          pixels,
+                          svt_full_distortion_kernel_cbf_zero32_bits(
+                              coeff, size, distortion, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "aom_sum_squares_i16/" + dims,
+                          aom_sum_squares_i16,
+                          pixels,
+                          svt_av1_bench::bench_sink += aom_sum_squares_i16(residual, pixels));
+    }
+
+    KERNEL_BENCH_CASE(cases,
+                      "svt_picture_average_kernel1_line/" + std::to_string(MAX_SB_SIZE),
+                      svt_picture_average_kernel1_line,
+                      MAX_SB_SIZE,
+                      svt_picture_average_kernel1_line(src, pred, dst, MAX_SB_SIZE));
+}
+
+void add_pack_cases(std::vector<BenchCase> &cases) {
+    // The 10 bit pictures are kept as the 8 msb and the 2 lsb of the samples,
+    // one byte per sample or 4 samples per byte (compressed)
+    uint8_t *msb = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint8_t *lsb = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint8_t *lsb_compressed = svt_av1_bench::bench_alloc_random(stride / 4 * MAX_SB_SIZE);
+    uint8_t *local_cache = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint16_t *pic16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    uint16_t *ref16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+
+    for (int size = 8; size <= MAX_SB_SIZE; size *= 2) {
+        const std::string dims = std::to_string(size) + "x" + std::to_string(size);
+        const int pixels = size * size;
+
+        KERNEL_BENCH_CASE(cases,
+                          "svt_pack2d_16_bit_src_mul4/" + dims,
+                          svt_pack2d_16_bit_src_mul4,
+                          pixels,
+                          svt_pack2d_16_bit_src_mul4(
+                              msb, stride, lsb, pic16, stride, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_un_pack2d_16_bit_src_mul4/" + dims,
+                          svt_un_pack2d_16_bit_src_mul4,
+                          pixels,
+                          svt_un_pack2d_16_bit_src_mul4(
+                              ref16, stride, msb, lsb, stride, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_compressed_packmsb/" + dims,
+                          svt_compressed_packmsb,
+                          pixels,
+                          svt_compressed_packmsb(
+                              msb, stride, lsb_compressed, pic16, stride / 4, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_c_pack/" + dims,
+                          svt_c_pack,
+                          pixels,
+                          svt_c_pack(
+                              lsb, stride, lsb_compressed, stride / 4, local_cache, size, size));
+        KERNEL_BENCH_CASE(
+            cases,
+            "svt_unpack_avg/" + dims,
+            svt_unpack_avg,
+            pixels,
+            svt_unpack_avg(pic16, stride, ref16, stride, msb, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_un_pack8_bit_data/" + dims,
+                          svt_un_pack8_bit_data,
+                          pixels,
+                          svt_un_pack8_bit_data(ref16, stride, msb, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_convert_8bit_to_16bit/" + dims,
+                          svt_convert_8bit_to_16bit,
+                          pixels,
+                          svt_convert_8bit_to_16bit(lsb, stride, pic16, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_convert_16bit_to_8bit/" + dims,
+                          svt_convert_16bit_to_8bit,
+                          pixels,
+                          svt_convert_16bit_to_8bit(ref16, stride, msb, stride, size, size));
+    }
+
+    for (size_t size = 64; size <= 16384; size *= 4) {
+        KERNEL_BENCH_CASE(cases,
+                          "svt_memcpy/" + std::to_string(size),
+                          svt_memcpy,
+                          size,
+                          svt_memcpy(local_cache, msb, size));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_block_ops_cases);
+KERNEL_BENCH_FAMILY(add_pack_cases);
+
+}  // namespace
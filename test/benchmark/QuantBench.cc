@@ -0,0 +1,177 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+
+/******************************************************************************
+ * @file QuantBench.cc
+ *
+ * @brief Kernel benchmark cases of the quantizers, the dequantization of the
+ * decoder, the distortion and SATD of the coefficients and the level contexts
+ * of the coefficient coding.
+ *
+ ******************************************************************************/
+
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "EbCoefficients.h"
+#include "EbCommonUtils.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+// Only the top left 32x32 coefficients of the 64 sizes are coded
+const TxSize tx_sizes[] = {TX_4X4, TX_8X8, TX_16X16, TX_32X32, TX_64X64};
+const int max_coeffs = 32 * 32;
+
+// The SIMD quantizers load the DC and the 7 AC entries as one vector
+int16_t *alloc_qparam(int16_t dc, int16_t ac) {
+    int16_t *param = (int16_t *)svt_av1_bench::bench_alloc_random16(8, 1);
+    param[0] = dc;
+    for (int i = 1; i < 8; i++) param[i] = ac;
+    return param;
+}
+
+void add_quant_cases(std::vector<BenchCase> &cases) {
+    const TranLow *coeff = svt_av1_bench::bench_alloc_random32(max_coeffs, 12);
+    const TranLow *coeff10 = svt_av1_bench::bench_alloc_random32(max_coeffs, 14);
+    TranLow *qcoeff = svt_av1_bench::bench_alloc_random32(max_coeffs, 12);
+    TranLow *dqcoeff = svt_av1_bench::bench_alloc_random32(max_coeffs, 12);
+    uint16_t *eob = svt_av1_bench::bench_alloc_random16(1, 1);
+    const int16_t *zbin = alloc_qparam(50, 60);
+    const int16_t *round = alloc_qparam(38, 45);
+    const int16_t *quant = alloc_qparam(655, 546);
+    const int16_t *quant_shift = alloc_qparam(16384, 16384);
+    const int16_t *dequant = alloc_qparam(100, 120);
+
+    for (const TxSize tx_size : tx_sizes) {
+        const int w = tx_size_wide[tx_size];
+        const int n = AOMMIN(w, 32) * AOMMIN(w, 32);
+        const int log_scale = av1_get_tx_scale(tx_size);
+        const int16_t *scan = av1_scan_orders[tx_size][DCT_DCT].scan;
+        const int16_t *iscan = av1_scan_orders[tx_size][DCT_DCT].iscan;
+        const std::string dims = "/" + std::to_string(w) + "x" + std::to_string(w);
+
+        KERNEL_BENCH_CASE(cases,
+                          "svt_aom_quantize_b" + dims,
+                          svt_aom_quantize_b,
+                          n,
+                          svt_aom_quantize_b(coeff, n, zbin, round, quant, quant_shift, qcoeff,
+                                             dqcoeff, dequant, eob, scan, iscan, NULL, NULL,
+                                             log_scale));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_aom_highbd_quantize_b" + dims + "/10bit",
+                          svt_aom_highbd_quantize_b,
+                          n,
+                          svt_aom_highbd_quantize_b(coeff10, n, zbin, round, quant, quant_shift,
+                                                    qcoeff, dqcoeff, dequant, eob, scan, iscan,
+                                                    NULL, NULL, log_scale));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_highbd_quantize_fp" + dims + "/10bit",
+                          svt_av1_highbd_quantize_fp,
+                          n,
+                          svt_av1_highbd_quantize_fp(coeff10, n, zbin, round, quant, quant_shift,
+                                                     qcoeff, dqcoeff, dequant, eob, scan, iscan,
+                                                     log_scale));
+        // The 8 bit fp quantizer has one variant per log_scale
+        if (log_scale == 0) {
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_quantize_fp" + dims,
+                              svt_av1_quantize_fp,
+                              n,
+                              svt_av1_quantize_fp(coeff, n, zbin, round, quant, quant_shift,
+                                                  qcoeff, dqcoeff, dequant, eob, scan, iscan));
+        } else if (log_scale == 1) {
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_quantize_fp_32x32" + dims,
+                              svt_av1_quantize_fp_32x32,
+                              n,
+                              svt_av1_quantize_fp_32x32(coeff, n, zbin, round, quant,
+                                                        quant_shift, qcoeff, dqcoeff, dequant,
+                                                        eob, scan, iscan));
+        } else {
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_quantize_fp_64x64" + dims,
+                              svt_av1_quantize_fp_64x64,
+                              n,
+                              svt_av1_quantize_fp_64x64(coeff, n, zbin, round, quant,
+                                                        quant_shift, qcoeff, dqcoeff, dequant,
+                                                        eob, scan, iscan));
+        }
+    }
+
+    const int32_t *level = svt_av1_bench::bench_alloc_random32(max_coeffs, 8);
+    int32_t *dq = svt_av1_bench::bench_alloc_random32(max_coeffs, 8);
+    for (const TxSize tx_size : tx_sizes) {
+        const int w = tx_size_wide[tx_size];
+        const int n = AOMMIN(w, 32) * AOMMIN(w, 32);
+        const int shift = av1_get_tx_scale(tx_size);
+        const int16_t *scan = av1_scan_orders[tx_size][DCT_DCT].scan;
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_dequant_scatter/" + std::to_string(w) + "x" +
+                              std::to_string(w),
+                          svt_av1_dequant_scatter,
+                          n,
+                          svt_av1_dequant_scatter(level, n, scan, dequant, NULL, shift, 8, dq));
+    }
+}
+
+void add_coeff_cases(std::vector<BenchCase> &cases) {
+    const TranLow *coeff = svt_av1_bench::bench_alloc_random32(max_coeffs, 12);
+    const TranLow *dqcoeff = svt_av1_bench::bench_alloc_random32(max_coeffs, 12);
+    const TranLow *qcoeff = svt_av1_bench::bench_alloc_random32(max_coeffs, 5);
+    int64_t *ssz = (int64_t *)svt_av1_bench::bench_alloc_random32(2, 8);
+    for (int n = 16; n <= max_coeffs; n *= 4) {
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_block_error/" + std::to_string(n),
+                          svt_av1_block_error,
+                          n,
+                          svt_av1_bench::bench_sink +=
+                              svt_av1_block_error(coeff, dqcoeff, n, ssz));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_aom_satd/" + std::to_string(n),
+                          svt_aom_satd,
+                          n,
+                          svt_av1_bench::bench_sink += svt_aom_satd(coeff, n));
+    }
+
+    // The levels are clipped to 127 and read through the padding of TX_PAD_2D,
+    // the contexts only depend on the magnitudes up to 3
+    uint8_t *levels_buf = svt_av1_bench::bench_alloc_random(TX_PAD_2D);
+    for (int i = 0; i < TX_PAD_2D; i++) levels_buf[i] &= 3;
+    int8_t *coeff_contexts = (int8_t *)svt_av1_bench::bench_alloc_random(max_coeffs);
+    for (int i = 0; i < 4; i++) {
+        const TxSize tx_size = tx_sizes[i];
+        const int w = tx_size_wide[tx_size];
+        const int n = w * w;
+        const int16_t *scan = av1_scan_orders[tx_size][DCT_DCT].scan;
+        uint8_t *levels = set_levels(levels_buf, w);
+        const std::string dims = "/" + std::to_string(w) + "x" + std::to_string(w);
+
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_txb_init_levels" + dims,
+                          svt_av1_txb_init_levels,
+                          n,
+                          svt_av1_txb_init_levels(qcoeff, w, w, levels));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_get_nz_map_contexts" + dims,
+                          svt_av1_get_nz_map_contexts,
+                          n,
+                          svt_av1_get_nz_map_contexts(
+                              levels, scan, n, tx_size, TX_CLASS_2D, coeff_contexts));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_quant_cases);
+KERNEL_BENCH_FAMILY(add_coeff_cases);
+
+}  // namespace
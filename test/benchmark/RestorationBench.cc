@@ -0,0 +1,211 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+
+/******************************************************************************
+ * @file RestorationBench.cc
+ *
+ * @brief Kernel benchmark cases of the loop restoration filters, Wiener and
+ * self guided, and of their search: svt_av1_compute_stats and the projection
+ * error of the self guided filter.
+ *
+ ******************************************************************************/
+
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "convolve.h"
+#include "EbRestoration.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = MAX_SB_SIZE + 16;
+// Rows and columns read around the unit by the 7 tap Wiener filter and the
+// self guided filter
+const int border = 3;
+const int rows = MAX_SB_SIZE + 2 * border + 2;
+
+void add_wiener_cases(std::vector<BenchCase> &cases) {
+    const uint8_t *src =
+        svt_av1_bench::bench_alloc_random(stride * rows) + border * stride + border;
+    uint8_t *dst = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    uint16_t *src16 =
+        svt_av1_bench::bench_alloc_random16(stride * rows, 10) + border * stride + border;
+    uint16_t *dst16 = svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10);
+    // The highbd Wiener filter takes CONVERT_TO_BYTEPTR() pointers
+    const uint8_t *src16_byteptr = CONVERT_TO_BYTEPTR(src16);
+    uint8_t *dst16_byteptr = CONVERT_TO_BYTEPTR(dst16);
+    // A 7 tap low pass filter, the taps sum to 1 << FILTER_BITS
+    int16_t *filter = (int16_t *)svt_av1_bench::bench_alloc_random16(SUBPEL_TAPS, 8);
+    const int16_t taps[SUBPEL_TAPS] = {3, -7, 15, 106, 15, -7, 3, 0};
+    for (int i = 0; i < SUBPEL_TAPS; i++) filter[i] = taps[i];
+    const ConvolveParams conv_params = get_conv_params_wiener(8);
+    const ConvolveParams conv_params10 = get_conv_params_wiener(10);
+
+    // The units are filtered in 64 rows high stripes, by blocks of up to
+    // RESTORATION_PROC_UNIT_SIZE columns rounded to 16
+    for (int w = 16; w <= RESTORATION_PROC_UNIT_SIZE; w *= 2) {
+        const std::string dims = std::to_string(w) + "x64";
+        KERNEL_BENCH_CASE(
+            cases,
+            "svt_av1_wiener_convolve_add_src/" + dims,
+            svt_av1_wiener_convolve_add_src,
+            w * 64,
+            svt_av1_wiener_convolve_add_src(
+                src, stride, dst, stride, filter, filter, w, 64, &conv_params));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_highbd_wiener_convolve_add_src/" + dims + "/10bit",
+                          svt_av1_highbd_wiener_convolve_add_src,
+                          w * 64,
+                          svt_av1_highbd_wiener_convolve_add_src(src16_byteptr,
+                                                                 stride,
+                                                                 dst16_byteptr,
+                                                                 stride,
+                                                                 filter,
+                                                                 filter,
+                                                                 w,
+                                                                 64,
+                                                                 &conv_params10,
+                                                                 10));
+    }
+
+    // The statistics of the Wiener search over a restoration unit, the 7x7
+    // window of luma and the 5x5 one of chroma
+    int64_t *m = (int64_t *)svt_av1_bench::bench_alloc_random32(2 * WIENER_WIN2, 8);
+    int64_t *h = (int64_t *)svt_av1_bench::bench_alloc_random32(2 * WIENER_WIN2 * WIENER_WIN2, 8);
+    const uint8_t *org = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    const uint8_t *org16_byteptr =
+        CONVERT_TO_BYTEPTR(svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10));
+    for (int win = WIENER_WIN_CHROMA; win <= WIENER_WIN; win += 2) {
+        for (int size = 32; size <= MAX_SB_SIZE; size *= 2) {
+            const std::string dims =
+                std::to_string(size) + "x" + std::to_string(size) + "/win" + std::to_string(win);
+            KERNEL_BENCH_CASE(
+                cases,
+                "svt_av1_compute_stats/" + dims,
+                svt_av1_compute_stats,
+                size * size,
+                svt_av1_compute_stats(win, src, org, 0, size, 0, size, stride, stride, m, h));
+            KERNEL_BENCH_CASE(cases,
+                              "svt_av1_compute_stats_highbd/" + dims + "/10bit",
+                              svt_av1_compute_stats_highbd,
+                              size * size,
+                              svt_av1_compute_stats_highbd(win,
+                                                           src16_byteptr,
+                                                           org16_byteptr,
+                                                           0,
+                                                           size,
+                                                           0,
+                                                           size,
+                                                           stride,
+                                                           stride,
+                                                           m,
+                                                           h,
+                                                           AOM_BITS_10));
+        }
+    }
+}
+
+void add_selfguided_cases(std::vector<BenchCase> &cases) {
+    const uint8_t *src =
+        svt_av1_bench::bench_alloc_random(stride * rows) + border * stride + border;
+    uint8_t *dst = svt_av1_bench::bench_alloc_random(stride * MAX_SB_SIZE);
+    const uint8_t *src16_byteptr = CONVERT_TO_BYTEPTR(
+        svt_av1_bench::bench_alloc_random16(stride * rows, 10) + border * stride + border);
+    uint8_t *dst16_byteptr =
+        CONVERT_TO_BYTEPTR(svt_av1_bench::bench_alloc_random16(stride * MAX_SB_SIZE, 10));
+    const int unit = RESTORATION_PROC_UNIT_SIZE;
+    int32_t *flt0 = svt_av1_bench::bench_alloc_random32(unit * unit, 12);
+    int32_t *flt1 = svt_av1_bench::bench_alloc_random32(unit * unit, 12);
+    int32_t *tmpbuf =
+        svt_av1_bench::bench_alloc_random32(RESTORATION_TMPBUF_SIZE / sizeof(int32_t), 8);
+    // The projection midway in the range of the coefficients
+    int32_t *xqd = svt_av1_bench::bench_alloc_random32(2, 8);
+    xqd[0] = (SGRPROJ_PRJ_MIN0 + SGRPROJ_PRJ_MAX0) / 2;
+    xqd[1] = (SGRPROJ_PRJ_MIN1 + SGRPROJ_PRJ_MAX1) / 2;
+    int32_t *xq = svt_av1_bench::bench_alloc_random32(2, 8);
+    xq[0] = -16;
+    xq[1] = 48;
+
+    // Parameter sets 0, 10 and 14 run both filters, the second one only and
+    // the first one only
+    const int sgr_params_idx[] = {0, 10, 14};
+    for (const int idx : sgr_params_idx) {
+        const std::string dims = std::to_string(unit) + "x" + std::to_string(unit) + "/set" +
+            std::to_string(idx);
+        const SgrParamsType *params = &eb_sgr_params[idx];
+
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_selfguided_restoration/" + dims,
+                          svt_av1_selfguided_restoration,
+                          unit * unit,
+                          svt_av1_selfguided_restoration(
+                              src, unit, unit, stride, flt0, flt1, unit, idx, 8, 0));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_selfguided_restoration/" + dims + "/10bit",
+                          svt_av1_selfguided_restoration,
+                          unit * unit,
+                          svt_av1_selfguided_restoration(
+                              src16_byteptr, unit, unit, stride, flt0, flt1, unit, idx, 10, 1));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_apply_selfguided_restoration/" + dims,
+                          svt_apply_selfguided_restoration,
+                          unit * unit,
+                          svt_apply_selfguided_restoration(
+                              src, unit, unit, stride, idx, xqd, dst, stride, tmpbuf, 8, 0));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_apply_selfguided_restoration/" + dims + "/10bit",
+                          svt_apply_selfguided_restoration,
+                          unit * unit,
+                          svt_apply_selfguided_restoration(src16_byteptr,
+                                                           unit,
+                                                           unit,
+                                                           stride,
+                                                           idx,
+                                                           xqd,
+                                                           dst16_byteptr,
+                                                           stride,
+                                                           tmpbuf,
+                                                           10,
+                                                           1));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_lowbd_pixel_proj_error/" + dims,
+                          svt_av1_lowbd_pixel_proj_error,
+                          unit * unit,
+                          svt_av1_bench::bench_sink += svt_av1_lowbd_pixel_proj_error(
+                              dst, unit, unit, stride, src, stride, flt0, unit, flt1, unit, xq,
+                              params));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_av1_highbd_pixel_proj_error/" + dims + "/10bit",
+                          svt_av1_highbd_pixel_proj_error,
+                          unit * unit,
+                          svt_av1_bench::bench_sink +=
+                          svt_av1_highbd_pixel_proj_error(dst16_byteptr,
+                                                          unit,
+                                                          unit,
+                                                          stride,
+                                                          src16_byteptr,
+                                                          stride,
+                                                          flt0,
+                                                          unit,
+                                                          flt1,
+                                                          unit,
+                                                          xq,
+                                                          params));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_wiener_cases);
+KERNEL_BENCH_FAMILY(add_selfguided_cases);
+
+}  // namespace
@@ -0,0 +1,76 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SadBench.cc
+ *
+ * @brief Kernel benchmark cases of svt_aom_sadWxH and svt_aom_sadWxHx4d.
+ *
+ ******************************************************************************/
+
+#include "aom_dsp_rtcd.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = 256;
+
+void add_sad_cases(std::vector<BenchCase> &cases) {
+    const uint8_t *src = svt_av1_bench::bench_alloc_random(stride * 128);
+    const uint8_t *ref = svt_av1_bench::bench_alloc_random(stride * (128 + 3));
+    // The 4 references of x4d are one row apart, as in motion search
+    const uint8_t *refs[4] = {ref, ref + stride, ref + 2 * stride, ref + 3 * stride};
+    uint32_t *sad_array = (uint32_t *)svt_av1_bench::bench_alloc_random(4 * sizeof(uint32_t));
+
+#define SAD_CASES(w, h)                                                             \
+    KERNEL_BENCH_CASE(cases,                                                        \
+                      "svt_aom_sad" #w "x" #h,                                      \
+                      svt_aom_sad##w##x##h,                                         \
+                      w * h,                                                        \
+                      svt_av1_bench::bench_sink +=                                  \
+                      svt_aom_sad##w##x##h(src, stride, ref, stride));              \
+    KERNEL_BENCH_CASE(cases,                                                        \
+                      "svt_aom_sad" #w "x" #h "x4d",                                \
+                      svt_aom_sad##w##x##h##x4d,                                    \
+                      4 * w * h,                                                    \
+                      svt_aom_sad##w##x##h##x4d(src, stride, refs, stride, sad_array); \
+                      svt_av1_bench::bench_sink += sad_array[3])
+
+    SAD_CASES(4, 4);
+    SAD_CASES(4, 8);
+    SAD_CASES(4, 16);
+    SAD_CASES(8, 4);
+    SAD_CASES(8, 8);
+    SAD_CASES(8, 16);
+    SAD_CASES(8, 32);
+    SAD_CASES(16, 4);
+    SAD_CASES(16, 8);
+    SAD_CASES(16, 16);
+    SAD_CASES(16, 32);
+    SAD_CASES(16, 64);
+    SAD_CASES(32, 8);
+    SAD_CASES(32, 16);
+    SAD_CASES(32, 32);
+    SAD_CASES(32, 64);
+    SAD_CASES(64, 16);
+    SAD_CASES(64, 32);
+    SAD_CASES(64, 64);
+    SAD_CASES(64, 128);
+    SAD_CASES(128, 64);
+    SAD_CASES(128, 128);
+#undef SAD_CASES
+}
+
+KERNEL_BENCH_FAMILY(add_sad_cases);
+
+}  // namespace
@@ -0,0 +1,130 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file TxfmBench.cc
+ *
+ * @brief Kernel benchmark cases of svt_av1_fwd_txfm2d_WxH and
+ * svt_av1_inv_txfm2d_add_WxH, DCT_DCT at 8 and 10 bit.
+ *
+ ******************************************************************************/
+
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = 64;
+
+void add_txfm_cases(std::vector<BenchCase> &cases) {
+    int16_t *residual[2] = {(int16_t *)svt_av1_bench::bench_alloc_random16(64 * 64, 8),
+                            (int16_t *)svt_av1_bench::bench_alloc_random16(64 * 64, 10)};
+    int32_t *coeff = svt_av1_bench::bench_alloc_random32(64 * 64, 10);
+    int32_t *output = svt_av1_bench::bench_alloc_random32(64 * 64, 10);
+    uint16_t *recon[2] = {svt_av1_bench::bench_alloc_random16(64 * stride, 8),
+                          svt_av1_bench::bench_alloc_random16(64 * stride, 10)};
+
+    for (int i = 0; i < 2; i++) {
+        const int bd = i ? 10 : 8;
+        const std::string suffix = i ? "/10bit" : "/8bit";
+        int16_t *const input = residual[i];
+        uint16_t *const dst = recon[i];
+
+#define FWD_TXFM_CASE(w, h)                                                           \
+    KERNEL_BENCH_CASE(                                                                \
+        cases,                                                                        \
+        "svt_av1_fwd_txfm2d_" #w "x" #h + suffix,                                     \
+        svt_av1_fwd_txfm2d_##w##x##h,                                                 \
+        w * h,                                                                        \
+        svt_av1_fwd_txfm2d_##w##x##h(input, output, w, DCT_DCT, (uint8_t)bd);        \
+        svt_av1_bench::bench_sink += output[0])
+// Square sizes, rectangular ones up to 16 pixels, and the ones taking the eob
+#define INV_TXFM_SQR_CASE(w, h)                                                       \
+    KERNEL_BENCH_CASE(cases,                                                          \
+                      "svt_av1_inv_txfm2d_add_" #w "x" #h + suffix,                   \
+                      svt_av1_inv_txfm2d_add_##w##x##h,                               \
+                      w * h,                                                          \
+                      svt_av1_inv_txfm2d_add_##w##x##h(                               \
+                          coeff, dst, stride, dst, stride, DCT_DCT, bd))
+#define INV_TXFM_RECT_CASE(w, h)                                                      \
+    KERNEL_BENCH_CASE(cases,                                                          \
+                      "svt_av1_inv_txfm2d_add_" #w "x" #h + suffix,                   \
+                      svt_av1_inv_txfm2d_add_##w##x##h,                               \
+                      w * h,                                                          \
+                      svt_av1_inv_txfm2d_add_##w##x##h(                               \
+                          coeff, dst, stride, dst, stride, DCT_DCT, TX_##w##X##h, bd))
+#define INV_TXFM_EOB_CASE(w, h)                                                       \
+    KERNEL_BENCH_CASE(cases,                                                          \
+                      "svt_av1_inv_txfm2d_add_" #w "x" #h + suffix,                   \
+                      svt_av1_inv_txfm2d_add_##w##x##h,                               \
+                      w * h,                                                          \
+                      svt_av1_inv_txfm2d_add_##w##x##h(coeff,                         \
+                                                       dst,                           \
+                                                       stride,                        \
+                                                       dst,                           \
+                                                       stride,                        \
+                                                       DCT_DCT,                       \
+                                                       TX_##w##X##h,                  \
+                                                       (w > 32 ? 32 : w) * (h > 32 ? 32 : h), \
+                                                       bd))
+
+        FWD_TXFM_CASE(4, 4);
+        FWD_TXFM_CASE(4, 8);
+        FWD_TXFM_CASE(4, 16);
+        FWD_TXFM_CASE(8, 4);
+        FWD_TXFM_CASE(8, 8);
+        FWD_TXFM_CASE(8, 16);
+        FWD_TXFM_CASE(8, 32);
+        FWD_TXFM_CASE(16, 4);
+        FWD_TXFM_CASE(16, 8);
+        FWD_TXFM_CASE(16, 16);
+        FWD_TXFM_CASE(16, 32);
+        FWD_TXFM_CASE(16, 64);
+        FWD_TXFM_CASE(32, 8);
+        FWD_TXFM_CASE(32, 16);
+        FWD_TXFM_CASE(32, 32);
+        FWD_TXFM_CASE(32, 64);
+        FWD_TXFM_CASE(64, 16);
+        FWD_TXFM_CASE(64, 32);
+        FWD_TXFM_CASE(64, 64);
+
+        INV_TXFM_SQR_CASE(4, 4);
+        INV_TXFM_RECT_CASE(4, 8);
+        INV_TXFM_RECT_CASE(4, 16);
+        INV_TXFM_RECT_CASE(8, 4);
+        INV_TXFM_SQR_CASE(8, 8);
+        INV_TXFM_EOB_CASE(8, 16);
+        INV_TXFM_EOB_CASE(8, 32);
+        INV_TXFM_RECT_CASE(16, 4);
+        INV_TXFM_EOB_CASE(16, 8);
+        INV_TXFM_SQR_CASE(16, 16);
+        INV_TXFM_EOB_CASE(16, 32);
+        INV_TXFM_EOB_CASE(16, 64);
+        INV_TXFM_EOB_CASE(32, 8);
+        INV_TXFM_EOB_CASE(32, 16);
+        INV_TXFM_SQR_CASE(32, 32);
+        INV_TXFM_EOB_CASE(32, 64);
+        INV_TXFM_EOB_CASE(64, 16);
+        INV_TXFM_EOB_CASE(64, 32);
+        INV_TXFM_SQR_CASE(64, 64);
+#undef FWD_TXFM_CASE
+#undef INV_TXFM_SQR_CASE
+#undef INV_TXFM_RECT_CASE
+#undef INV_TXFM_EOB_CASE
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_txfm_cases);
+
+}  // namespace
@@ -0,0 +1,101 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file VarianceBench.cc
+ *
+ * @brief Kernel benchmark cases of the 8 bit and 10 bit svt_aom_varianceWxH,
+ * svt_aom_sse and svt_aom_highbd_sse.
+ *
+ ******************************************************************************/
+
+#include <string>
+#include "aom_dsp_rtcd.h"
+#include "KernelBench.h"
+
+using svt_av1_bench::BenchCase;
+
+namespace {
+
+const int stride = 256;
+
+void add_variance_cases(std::vector<BenchCase> &cases) {
+    const uint8_t *src = svt_av1_bench::bench_alloc_random(stride * 128);
+    const uint8_t *ref = svt_av1_bench::bench_alloc_random(stride * 128);
+    uint16_t *src16 = svt_av1_bench::bench_alloc_random16(stride * 128, 10);
+    uint16_t *ref16 = svt_av1_bench::bench_alloc_random16(stride * 128, 10);
+    // The highbd variances take CONVERT_TO_BYTEPTR() pointers, svt_aom_highbd_sse casts
+    uint8_t *src16_byteptr = CONVERT_TO_BYTEPTR(src16);
+    uint8_t *ref16_byteptr = CONVERT_TO_BYTEPTR(ref16);
+
+#define VARIANCE_CASES(w, h)                                                              \
+    KERNEL_BENCH_CASE(cases,                                                              \
+                      "svt_aom_variance" #w "x" #h,                                       \
+                      svt_aom_variance##w##x##h,                                          \
+                      w * h,                                                              \
+                      unsigned int sse;                                                   \
+                      svt_av1_bench::bench_sink +=                                        \
+                      svt_aom_variance##w##x##h(src, stride, ref, stride, &sse) + sse);   \
+    KERNEL_BENCH_CASE(cases,                                                              \
+                      "svt_aom_highbd_10_variance" #w "x" #h,                             \
+                      svt_aom_highbd_10_variance##w##x##h,                                \
+                      w * h,                                                              \
+                      unsigned int sse;                                                   \
+                      svt_av1_bench::bench_sink +=                                        \
+                      svt_aom_highbd_10_variance##w##x##h(                                \
+                          src16_byteptr, stride, ref16_byteptr, stride, &sse) + \
+                      sse)
+
+    VARIANCE_CASES(4, 4);
+    VARIANCE_CASES(4, 8);
+    VARIANCE_CASES(4, 16);
+    VARIANCE_CASES(8, 4);
+    VARIANCE_CASES(8, 8);
+    VARIANCE_CASES(8, 16);
+    VARIANCE_CASES(8, 32);
+    VARIANCE_CASES(16, 4);
+    VARIANCE_CASES(16, 8);
+    VARIANCE_CASES(16, 16);
+    VARIANCE_CASES(16, 32);
+    VARIANCE_CASES(16, 64);
+    VARIANCE_CASES(32, 8);
+    VARIANCE_CASES(32, 16);
+    VARIANCE_CASES(32, 32);
+    VARIANCE_CASES(32, 64);
+    VARIANCE_CASES(64, 16);
+    VARIANCE_CASES(64, 32);
+    VARIANCE_CASES(64, 64);
+    VARIANCE_CASES(64, 128);
+    VARIANCE_CASES(128, 64);
+    VARIANCE_CASES(128, 128);
+#undef VARIANCE_CASES
+
+    for (int size = 4; size <= 128; size *= 2) {
+        const std::string dims = std::to_string(size) + "x" + std::to_string(size);
+        KERNEL_BENCH_CASE(cases,
+                          "svt_aom_sse/" + dims,
+                          svt_aom_sse,
+                          size * size,
+                          svt_av1_bench::bench_sink +=
+                          svt_aom_sse(src, stride, ref, stride, size, size));
+        KERNEL_BENCH_CASE(cases,
+                          "svt_aom_highbd_sse/" + dims + "/10bit",
+                          svt_aom_highbd_sse,
+                          size * size,
+                          svt_av1_bench::bench_sink +=
+                          svt_aom_highbd_sse(
+                              (uint8_t *)src16, stride, (uint8_t *)ref16, stride, size, size));
+    }
+}
+
+KERNEL_BENCH_FAMILY(add_variance_cases);
+
+}  // namespace